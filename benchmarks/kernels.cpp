@@ -0,0 +1,424 @@
+/**
+ * This program times the hot kernels in isolation on synthetic meshes:
+ * - the cell assembly of the serial SCnsIM,
+ * - the update and the batch evaluation of the Neo-Hookean material,
+ * - GridInterpolator locating a point, point_value and point_gradient,
+ * - CellLocator::search from a neighboring hint and from a far hint,
+ * - FSI::point_in_solid,
+ * - SPHInterpolator construction with a full scan and a cell-linked list.
+ *
+ * The fluid mesh is the unit square or cube refined Global refinements[0]
+ * times, the solid mesh is [0.25, 0.75]^dim refined Global refinements[1]
+ * times. The query points are random points in the unit box, one per fluid
+ * cell, with a fixed seed. Everything runs on one thread, so that the times
+ * of the assembly are the cost of one cell.
+ *
+ * Every kernel is called once per fluid cell or query point in a sweep, and
+ * the sweep is repeated. One line per kernel is written to the output file:
+ * kernel,dim,cells,calls,min_time,mean_time
+ * where calls is the number of calls in a sweep, and the times are seconds
+ * per call, the minimum over the sweeps and the mean of all of them.
+ *
+ * Usage: kernels <input.prm> <output.csv> [sweeps]
+ */
+#include "fsi.h"
+#include "linear_elasticity.h"
+#include "neo_hookean.h"
+#include "parameters.h"
+#include "scnsim.h"
+#include "utilities.h"
+
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <random>
+
+extern template class Fluid::SCnsIM<2>;
+extern template class Fluid::SCnsIM<3>;
+extern template class Solid::LinearElasticity<2>;
+extern template class Solid::LinearElasticity<3>;
+extern template class FSI<2>;
+extern template class FSI<3>;
+
+using namespace dealii;
+
+template <int dim>
+class KernelBenchmark
+{
+public:
+  KernelBenchmark(const Parameters::AllParameters &, const unsigned int);
+  void run(std::ostream &);
+
+private:
+  /// Time the sweep, which makes the given number of calls, and write the
+  /// times per call.
+  void measure(const std::string &,
+               const unsigned int,
+               const std::function<void()> &,
+               std::ostream &);
+
+  void scnsim_assembly(std::ostream &);
+  void material_update(std::ostream &);
+  void grid_interpolator(std::ostream &);
+  void cell_locator(std::ostream &);
+  void point_in_solid(std::ostream &);
+  void sph_interpolator(std::ostream &);
+
+  Parameters::AllParameters parameters;
+  const unsigned int sweeps;
+  Triangulation<dim> fluid_tria;
+  Triangulation<dim> solid_tria;
+  Fluid::SCnsIM<dim> fluid;
+  Solid::LinearElasticity<dim> solid;
+  std::vector<Point<dim>> points;
+};
+
+template <int dim>
+KernelBenchmark<dim>::KernelBenchmark(const Parameters::AllParameters &p,
+                                      const unsigned int n)
+  : parameters(p),
+    sweeps(n),
+    fluid(fluid_tria, parameters),
+    solid(solid_tria, parameters)
+{
+  GridGenerator::hyper_cube(fluid_tria, 0, 1, true);
+  fluid_tria.refine_global(parameters.global_refinements[0]);
+  GridGenerator::hyper_cube(solid_tria, 0.25, 0.75, true);
+  solid_tria.refine_global(parameters.global_refinements[1]);
+
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<double> distribution(0, 1);
+  points.resize(fluid_tria.n_active_cells());
+  for (auto &point : points)
+    {
+      for (unsigned int d = 0; d < dim; ++d)
+        {
+          point[d] = distribution(generator);
+        }
+    }
+
+  fluid.setup_dofs();
+  fluid.make_constraints();
+  fluid.initialize_system();
+  for (unsigned int i = 0; i < fluid.present_solution.size(); ++i)
+    {
+      fluid.present_solution[i] = std::sin(i);
+    }
+  fluid.evaluation_point = fluid.present_solution;
+}
+
+template <int dim>
+void KernelBenchmark<dim>::measure(const std::string &name,
+                                   const unsigned int calls,
+                                   const std::function<void()> &sweep,
+                                   std::ostream &out)
+{
+  Timer timer;
+  double min_time = std::numeric_limits<double>::max();
+  double total_time = 0;
+  for (unsigned int i = 0; i < sweeps; ++i)
+    {
+      timer.restart();
+      sweep();
+      timer.stop();
+      min_time = std::min(min_time, timer.last_wall_time());
+      total_time += timer.last_wall_time();
+    }
+  out << name << "," << dim << "," << fluid_tria.n_active_cells() << ","
+      << calls << "," << std::scientific << std::setprecision(6)
+      << min_time / calls << "," << total_time / (sweeps * calls)
+      << std::defaultfloat << std::endl;
+}
+
+template <int dim>
+void KernelBenchmark<dim>::scnsim_assembly(std::ostream &out)
+{
+  measure("scnsim_assembly",
+          fluid_tria.n_active_cells(),
+          [&]() { fluid.assemble(true); },
+          out);
+}
+
+template <int dim>
+void KernelBenchmark<dim>::material_update(std::ostream &out)
+{
+  AssertThrow(!parameters.C.empty() && parameters.C[0].size() >= 2,
+              ExcMessage("Hyperelastic parameters are needed!"));
+  Solid::NeoHookean<dim> material(
+    parameters.C[0][0], parameters.C[0][1], parameters.solid_rho);
+
+  // Deformation gradients close to the identity at the quadrature points of
+  // the solid mesh.
+  const unsigned int n_q_points =
+    solid_tria.n_active_cells() *
+    QGauss<dim>(parameters.solid_degree + 1).size();
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<double> distribution(-0.1, 0.1);
+  std::vector<Tensor<2, dim>> F(n_q_points);
+  for (auto &f : F)
+    {
+      for (unsigned int i = 0; i < dim; ++i)
+        {
+          for (unsigned int j = 0; j < dim; ++j)
+            {
+              f[i][j] = (i == j ? 1.0 : 0.0) + distribution(generator);
+            }
+        }
+    }
+  std::vector<SymmetricTensor<2, dim>> tau(n_q_points);
+  std::vector<SymmetricTensor<4, dim>> Jc(n_q_points);
+
+  measure("neo_hookean_update",
+          n_q_points,
+          [&]() {
+            for (unsigned int q = 0; q < n_q_points; ++q)
+              {
+                material.update_data(F[q]);
+                tau[q] = material.get_tau();
+                Jc[q] = material.get_Jc();
+              }
+          },
+          out);
+  measure("neo_hookean_evaluate",
+          n_q_points,
+          [&]() {
+            material.evaluate(make_array_view(F.cbegin(), F.cend()),
+                              make_array_view(tau),
+                              make_array_view(Jc));
+          },
+          out);
+}
+
+template <int dim>
+void KernelBenchmark<dim>::grid_interpolator(std::ostream &out)
+{
+  using Interpolator = Utils::GridInterpolator<dim, BlockVector<double>>;
+  measure("grid_interpolator_locate",
+          points.size(),
+          [&]() {
+            for (const auto &point : points)
+              {
+                Interpolator interpolator(fluid.dof_handler, point);
+              }
+          },
+          out);
+
+  std::vector<std::unique_ptr<Interpolator>> interpolators;
+  for (const auto &point : points)
+    {
+      interpolators.emplace_back(new Interpolator(fluid.dof_handler, point));
+    }
+  Vector<double> value(dim + 1);
+  std::vector<Tensor<1, dim>> gradient(dim + 1);
+  measure("grid_interpolator_point_value",
+          points.size(),
+          [&]() {
+            for (auto &interpolator : interpolators)
+              {
+                interpolator->point_value(fluid.present_solution, value);
+              }
+          },
+          out);
+  measure("grid_interpolator_point_gradient",
+          points.size(),
+          [&]() {
+            for (auto &interpolator : interpolators)
+              {
+                interpolator->point_gradient(fluid.present_solution,
+                                             gradient);
+              }
+          },
+          out);
+}
+
+template <int dim>
+void KernelBenchmark<dim>::cell_locator(std::ostream &out)
+{
+  // Search for the center of every cell, starting from one of its neighbors
+  // or from the first cell, which is beyond the breadth first search for
+  // most of the cells.
+  std::vector<Point<dim>> centers;
+  std::vector<typename DoFHandler<dim>::active_cell_iterator> near_hints;
+  for (auto cell : fluid.dof_handler.active_cell_iterators())
+    {
+      centers.push_back(cell->center());
+      auto hint = cell;
+      for (unsigned int f = 0; f < GeometryInfo<dim>::faces_per_cell; ++f)
+        {
+          if (!cell->at_boundary(f))
+            {
+              hint = cell->neighbor(f);
+              break;
+            }
+        }
+      near_hints.push_back(hint);
+    }
+  const auto far_hint = fluid.dof_handler.begin_active();
+
+  Utils::CellLocator<dim, DoFHandler<dim>> locator(fluid.dof_handler);
+  measure("cell_locator_near",
+          centers.size(),
+          [&]() {
+            for (unsigned int i = 0; i < centers.size(); ++i)
+              {
+                locator.search(centers[i], near_hints[i]);
+              }
+          },
+          out);
+  measure("cell_locator_far",
+          centers.size(),
+          [&]() {
+            for (unsigned int i = 0; i < centers.size(); ++i)
+              {
+                locator.search(centers[i], far_hint);
+              }
+          },
+          out);
+
+  Utils::CellTree<dim, DoFHandler<dim>> tree(fluid.dof_handler);
+  tree.rebuild();
+  locator.set_tree(&tree);
+  measure("cell_locator_far_tree",
+          centers.size(),
+          [&]() {
+            for (unsigned int i = 0; i < centers.size(); ++i)
+              {
+                locator.search(centers[i], far_hint);
+              }
+          },
+          out);
+}
+
+template <int dim>
+void KernelBenchmark<dim>::point_in_solid(std::ostream &out)
+{
+  DoFHandler<dim> solid_dof_handler(solid_tria);
+  FE_Q<dim> solid_fe(1);
+  solid_dof_handler.distribute_dofs(solid_fe);
+
+  // The solid does not move, so its box is set directly instead of moving
+  // the mesh with the displacement in update_solid_box.
+  FSI<dim> fsi(fluid, solid, parameters);
+  for (unsigned int d = 0; d < dim; ++d)
+    {
+      fsi.solid_box(2 * d) = 0.25;
+      fsi.solid_box(2 * d + 1) = 0.75;
+    }
+  unsigned int n_inside = 0;
+  measure("point_in_solid",
+          points.size(),
+          [&]() {
+            for (const auto &point : points)
+              {
+                n_inside += fsi.point_in_solid(solid_dof_handler, point);
+              }
+          },
+          out);
+  AssertThrow(n_inside > 0, ExcMessage("No point is in the solid!"));
+}
+
+template <int dim>
+void KernelBenchmark<dim>::sph_interpolator(std::ostream &out)
+{
+  using Interpolator = Utils::SPHInterpolator<dim, Vector<double>>;
+  measure("sph_interpolator_scan",
+          points.size(),
+          [&]() {
+            for (const auto &point : points)
+              {
+                Interpolator interpolator(fluid.dof_handler, point);
+              }
+          },
+          out);
+
+  Utils::CellLinkedList<dim, DoFHandler<dim>> cell_list(fluid.dof_handler);
+  cell_list.rebuild();
+  measure("sph_interpolator_cell_list",
+          points.size(),
+          [&]() {
+            for (const auto &point : points)
+              {
+                Interpolator interpolator(fluid.dof_handler, point, cell_list);
+              }
+          },
+          out);
+}
+
+template <int dim>
+void KernelBenchmark<dim>::run(std::ostream &out)
+{
+  scnsim_assembly(out);
+  material_update(out);
+  grid_interpolator(out);
+  cell_locator(out);
+  point_in_solid(out);
+  sph_interpolator(out);
+}
+
+int main(int argc, char *argv[])
+{
+  try
+    {
+      std::string infile("parameters.prm");
+      std::string outfile("kernels.csv");
+      unsigned int sweeps = 5;
+      if (argc > 1)
+        {
+          infile = argv[1];
+        }
+      if (argc > 2)
+        {
+          outfile = argv[2];
+        }
+      if (argc > 3)
+        {
+          sweeps = Utilities::string_to_int(argv[3]);
+        }
+      AssertThrow(sweeps > 0, ExcMessage("At least one sweep is needed!"));
+      Parameters::AllParameters params(infile);
+      params.n_threads = 1;
+
+      std::ofstream out(outfile);
+      out << "kernel,dim,cells,calls,min_time,mean_time" << std::endl;
+      if (params.dimension == 2)
+        {
+          KernelBenchmark<2> benchmark(params, sweeps);
+          benchmark.run(out);
+        }
+      else if (params.dimension == 3)
+        {
+          KernelBenchmark<3> benchmark(params, sweeps);
+          benchmark.run(out);
+        }
+      else
+        {
+          AssertThrow(false, ExcNotImplemented());
+        }
+    }
+  catch (std::exception &exc)
+    {
+      std::cerr << std::endl
+                << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      std::cerr << "Exception on processing: " << std::endl
+                << exc.what() << std::endl
+                << "Aborting!" << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      return 1;
+    }
+  catch (...)
+    {
+      std::cerr << std::endl
+                << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      std::cerr << "Unknown exception!" << std::endl
+                << "Aborting!" << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      return 1;
+    }
+  return 0;
+}
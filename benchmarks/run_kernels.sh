@@ -0,0 +1,65 @@
+#!/bin/bash
+# Run the kernel micro-benchmarks.
+#
+# The kernels executable is run once in 2D and once in 3D with
+# benchmarks/kernels.prm, followed by the dimension, the gravity and the fluid
+# and solid refinements of that dimension. The output of every dimension is
+# written to <output-dir>/kernels/kernels_<dim>d.csv, and its lines are
+# appended to <output-dir>/kernels.csv together with the commit being
+# benchmarked, so that the results of different commits can be compared.
+# See benchmarks/kernels.cpp for the kernels and the columns.
+
+set -e
+
+sweeps=5
+refinements_2d="5, 3"
+refinements_3d="3, 2"
+bin_dir=bin
+source_dir=$(cd "$(dirname "$0")/.." && pwd)
+output_dir=results
+
+while [ $# -gt 0 ]; do
+  case "$1" in
+    --sweeps) sweeps=$2; shift ;;
+    --refinements-2d) refinements_2d=$2; shift ;;
+    --refinements-3d) refinements_3d=$2; shift ;;
+    --bin-dir) bin_dir=$2; shift ;;
+    --source-dir) source_dir=$2; shift ;;
+    --output-dir) output_dir=$2; shift ;;
+    *) echo "Unknown option $1"; exit 1 ;;
+  esac
+  shift
+done
+
+commit=$(git -C "$source_dir" rev-parse --short HEAD 2>/dev/null || echo unknown)
+run_dir=$output_dir/kernels
+mkdir -p "$run_dir"
+run_dir=$(cd "$run_dir" && pwd)
+summary=$output_dir/kernels.csv
+if [ ! -f "$summary" ]; then
+  echo "commit,kernel,dim,cells,calls,min_time,mean_time" > "$summary"
+fi
+
+for dim in 2 3; do
+  if [ "$dim" = 2 ]; then
+    refinements=$refinements_2d
+    gravity="0.0, 0.0"
+  else
+    refinements=$refinements_3d
+    gravity="0.0, 0.0, 0.0"
+  fi
+  prm=$run_dir/kernels_${dim}d.prm
+  output=$run_dir/kernels_${dim}d.csv
+  cat "$source_dir/benchmarks/kernels.prm" > "$prm"
+  cat >> "$prm" <<PRM
+
+subsection Simulation
+  set Dimension = $dim
+  set Global refinements = $refinements
+  set Gravity = $gravity
+end
+PRM
+  echo "Running the kernels in ${dim}D with refinements $refinements"
+  (cd "$run_dir" && "$bin_dir/kernels" "$prm" "$output" "$sweeps" > output_${dim}d.txt 2>&1)
+  tail -n +2 "$output" | sed "s/^/$commit,/" >> "$summary"
+done
@@ -0,0 +1,136 @@
+#!/bin/bash
+# Run the scaling benchmarks.
+#
+# Every case runs the executable of the mpi test with the same name, with the
+# test input file followed by benchmarks/<case>.prm which overrides the mesh
+# size, the number of time steps, and turns off output and checkpoints.
+#
+# In strong scaling the mesh is the same at every rank count. In weak scaling
+# the fluid mesh is refined once more every time the number of ranks grows by
+# 2^dim compared to the first rank count, so the rank counts should grow by
+# that factor too.
+#
+# The ordering mode runs the strong scaling mesh once with every DoF ordering
+# and appends the assembly and linear solver times, summed over the timer
+# tables of the fluid and the solid, to <output-dir>/ordering.csv.
+#
+# Results are written to <output-dir>/<mode>/<case>/n<ranks>/, including the
+# performance log of the FSI cases, and one line per run is appended to
+# <output-dir>/summary.csv together with the commit being benchmarked, so that
+# the results of different commits can be compared.
+
+set -e
+
+mode=strong
+cases=""
+ranks="64 128 256 512 1024"
+steps=20
+mpiexec=mpirun
+bin_dir=bin
+source_dir=$(cd "$(dirname "$0")/.." && pwd)
+output_dir=results
+
+while [ $# -gt 0 ]; do
+  case "$1" in
+    --mode) mode=$2; shift ;;
+    --cases) cases=$2; shift ;;
+    --ranks) ranks=$2; shift ;;
+    --steps) steps=$2; shift ;;
+    --mpiexec) mpiexec=$2; shift ;;
+    --bin-dir) bin_dir=$2; shift ;;
+    --source-dir) source_dir=$2; shift ;;
+    --output-dir) output_dir=$2; shift ;;
+    *) echo "Unknown option $1"; exit 1 ;;
+  esac
+  shift
+done
+
+if [ "$mode" != strong ] && [ "$mode" != weak ] && [ "$mode" != ordering ]; then
+  echo "Mode must be strong, weak or ordering"
+  exit 1
+fi
+
+commit=$(git -C "$source_dir" rev-parse --short HEAD 2>/dev/null || echo unknown)
+mkdir -p "$output_dir"
+summary=$output_dir/summary.csv
+if [ ! -f "$summary" ]; then
+  echo "commit,case,mode,ranks,refinements,steps,wall_time" > "$summary"
+fi
+orderings=default
+if [ "$mode" = ordering ]; then
+  orderings="Cuthill_McKee Hierarchical"
+  ordering_summary=$output_dir/ordering.csv
+  if [ ! -f "$ordering_summary" ]; then
+    echo "commit,case,ordering,ranks,refinements,steps,assembly_time,solver_time,wall_time" > "$ordering_summary"
+  fi
+fi
+
+# Read "set <name> = <value>" from a prm file, the last one wins.
+read_entry() {
+  grep "^ *set $2 *=" "$1" | tail -n 1 | sed "s/^ *set $2 *= *//"
+}
+
+# Sum the wall times of a timer section over all the tables in an output.
+read_timer() {
+  awk -F'|' -v name="$2" '{ s = $2; gsub(/^ +| +$/, "", s) }
+    s == name { t = $4; gsub(/[ s]/, "", t); sum += t }
+    END { print sum + 0 }' "$1"
+}
+
+for case in $cases; do
+  input=$source_dir/tests/$case/$case.prm
+  override=$source_dir/benchmarks/$case.prm
+  dim=$(read_entry "$override" Dimension)
+  [ -z "$dim" ] && dim=$(read_entry "$input" Dimension)
+  refinements=$(read_entry "$override" "Global refinements")
+  fluid_level=${refinements%%,*}
+  solid_level=$(echo "${refinements#*,}" | tr -d ' ')
+  dt=$(read_entry "$override" "Time step size")
+  end_time=$(awk "BEGIN {print $steps * $dt}")
+  first_rank=""
+  for n in $ranks; do
+    [ -z "$first_rank" ] && first_rank=$n
+    level=$fluid_level
+    if [ "$mode" = weak ]; then
+      # One more level for every factor of 2^dim in the number of ranks
+      level=$(awk "BEGIN {print $fluid_level + int(log($n / $first_rank) / log(2 ^ $dim) + 1e-6)}")
+    fi
+    for ordering in $orderings; do
+      run_dir=$output_dir/$mode/$case/n$n
+      [ "$mode" = ordering ] && run_dir=$run_dir/$ordering
+      mkdir -p "$run_dir"
+      prm=$run_dir/$case.prm
+      cat "$input" "$override" > "$prm"
+      cat >> "$prm" <<PRM
+
+subsection Simulation
+  set Global refinements = $level, $solid_level
+  set End time = $end_time
+end
+
+subsection FSI solver control
+  set Performance log = performance.csv
+end
+PRM
+      if [ "$mode" = ordering ]; then
+        cat >> "$prm" <<PRM
+
+subsection Simulation
+  set DoF ordering = $ordering
+end
+PRM
+      fi
+      echo "Running $case ($mode scaling) on $n ranks with $level fluid refinements"
+      start=$(date +%s.%N)
+      (cd "$run_dir" && $mpiexec -n "$n" "$bin_dir/$case" "$prm" > output.txt 2>&1)
+      finish=$(date +%s.%N)
+      wall=$(awk "BEGIN {print $finish - $start}")
+      echo "$commit,$case,$mode,$n,$level,$steps,$wall" >> "$summary"
+      if [ "$mode" = ordering ]; then
+        assembly=$(read_timer "$run_dir/output.txt" "Assemble system")
+        solver=$(read_timer "$run_dir/output.txt" "Solve linear system")
+        echo "$commit,$case,$ordering,$n,$level,$steps,$assembly,$solver,$wall" >> "$ordering_summary"
+      fi
+    done
+  done
+done
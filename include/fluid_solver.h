@@ -3,11 +3,13 @@
 
 #include <deal.II/base/function.h>
 #include <deal.II/base/logstream.h>
+#include <deal.II/base/multithread_info.h>
 #include <deal.II/base/quadrature_lib.h>
 #include <deal.II/base/quadrature_point_data.h>
 #include <deal.II/base/tensor.h>
 #include <deal.II/base/timer.h>
 #include <deal.II/base/utilities.h>
+#include <deal.II/base/work_stream.h>
 
 #include <deal.II/lac/affine_constraints.h>
 #include <deal.II/lac/block_sparse_matrix.h>
@@ -94,9 +96,14 @@ namespace Fluid
     //! Set up the dofs based on the finite element and renumber them.
     void setup_dofs();
 
-    //! Set up the nonzero and zero constraints.
+    //! Set up the nonzero and zero constraints, which are also kept as the
+    //! static constraints of the current mesh.
     void make_constraints();
 
+    /// Restore the constraints to the static ones without building them
+    /// again, both of them are homogeneous unless nonzero is true.
+    void reset_constraints(const bool nonzero);
+
     //! Initialize the cell properties, which only matters in FSI applications.
     void setup_cell_property();
 
@@ -125,6 +132,9 @@ namespace Fluid
 
     AffineConstraints<double> zero_constraints;
     AffineConstraints<double> nonzero_constraints;
+    /// The hanging node and Dirichlet constraints of the current mesh.
+    AffineConstraints<double> static_zero_constraints;
+    AffineConstraints<double> static_nonzero_constraints;
 
     BlockSparsityPattern sparsity_pattern;
     BlockSparseMatrix<double> system_matrix;
@@ -1,7 +1,9 @@
 #ifndef FSI_H
 #define FSI_H
 
+#include <deal.II/base/parallel.h>
 #include <deal.II/base/table_indices.h>
+#include <deal.II/base/thread_local_storage.h>
 #include <deal.II/physics/elasticity/standard_tensors.h>
 
 #include "fluid_solver.h"
@@ -18,13 +20,20 @@ extern template class Utils::GridInterpolator<2, Vector<double>>;
 extern template class Utils::GridInterpolator<3, Vector<double>>;
 extern template class Utils::GridInterpolator<2, BlockVector<double>>;
 extern template class Utils::GridInterpolator<3, BlockVector<double>>;
+extern template class Utils::CellPointInterpolator<2, BlockVector<double>>;
+extern template class Utils::CellPointInterpolator<3, BlockVector<double>>;
 extern template class Utils::SPHInterpolator<2, Vector<double>>;
 extern template class Utils::SPHInterpolator<3, Vector<double>>;
 
+template <int>
+class KernelBenchmark;
+
 template <int dim>
 class FSI
 {
 public:
+  friend KernelBenchmark<dim>;
+
   FSI(Fluid::FluidSolver<dim> &,
       Solid::SolidSolver<dim> &,
       const Parameters::AllParameters &,
@@ -37,7 +46,7 @@ private:
   void update_solid_box();
 
   /// Check if a point is inside a mesh.
-  bool point_in_solid(const DoFHandler<dim> &, const Point<dim> &);
+  bool point_in_solid(const DoFHandler<dim> &, const Point<dim> &) const;
 
   /*! \brief Update the indicator field of the fluid solver.
    *
@@ -87,6 +96,11 @@ private:
   /// Mesh adaption.
   void refine_mesh(const unsigned int, const unsigned int);
 
+  /// Collect the fluid cells with the real coordinates of their centers and
+  /// of their velocity support points that find_fluid_bc evaluates. The
+  /// fluid mesh does not move, so this is only done when it changes.
+  void setup_support_points();
+
   Fluid::FluidSolver<dim> &fluid_solver;
   Solid::SolidSolver<dim> &solid_solver;
   Parameters::AllParameters parameters;
@@ -98,6 +112,27 @@ private:
   // (x_min, x_max, y_min, y_max, z_min, z_max)
   Vector<double> solid_box;
   bool use_dirichlet_bc;
+
+  // A velocity support point on the boundary of a fluid cell, given by its
+  // index in the cell, its velocity component and its real coordinates.
+  struct SupportPoint
+  {
+    unsigned int index;
+    unsigned int component;
+    Point<dim> point;
+  };
+
+  // The fluid cells and their centers. The support points of cell c are
+  // support_points[support_point_offsets[c], support_point_offsets[c + 1]),
+  // only collected if use_dirichlet_bc is true.
+  std::vector<typename DoFHandler<dim>::active_cell_iterator> fluid_cells;
+  std::vector<Point<dim>> cell_centers;
+  std::vector<unsigned int> support_point_offsets;
+  std::vector<SupportPoint> support_points;
+
+  /// Number of points or cells that a thread works on at a time in the
+  /// threaded loops of the coupling routines.
+  static const unsigned int coupling_grainsize = 64;
 };
 
 #endif
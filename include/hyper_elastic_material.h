@@ -1,6 +1,7 @@
 #ifndef HYPER_ELASTIC_MATERIAL
 #define HYPER_ELASTIC_MATERIAL
 
+#include <deal.II/base/array_view.h>
 #include <deal.II/base/tensor.h>
 #include <deal.II/physics/elasticity/kinematics.h>
 #include <deal.II/physics/elasticity/standard_tensors.h>
@@ -58,6 +59,19 @@ namespace Solid
       return get_Jc_iso() + get_Jc_vol();
     }
 
+    /**
+     * Compute the Kirchhoff stress and the spatial elasticity tensor
+     * multiplied with J for a batch of deformation gradients with the
+     * parameters of this material. The default implementation updates the
+     * material with every deformation gradient in turn, a material can
+     * override it with a kernel that does not change its state.
+     * The views are usually parts of a larger quadrature point storage.
+     */
+    virtual void
+    evaluate(const dealii::ArrayView<const dealii::Tensor<2, dim>> &F,
+             const dealii::ArrayView<dealii::SymmetricTensor<2, dim>> &tau,
+             const dealii::ArrayView<dealii::SymmetricTensor<4, dim>> &Jc);
+
     /** Return the J. */
     double get_det_F() { return det_F; }
 
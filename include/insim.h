@@ -106,9 +106,11 @@ namespace Fluid
      *
      *  After solving the linear system, the same AffineConstraints<double> as
      * used in assembly must be used again, to set the solution to the right
-     * value at the constrained dofs.
+     * value at the constrained dofs. The residual is reduced by the relative
+     * tolerance.
      */
-    std::pair<unsigned int, double> solve(const bool use_nonzero_constraints);
+    std::pair<unsigned int, double> solve(const bool use_nonzero_constraints,
+                                          const double relative_tolerance);
 
     /*! \brief Run the simulation for one time step.
      *
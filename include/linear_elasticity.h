@@ -21,7 +21,8 @@ namespace Solid
    * We use Newmark-beta method for time-stepping which can be either
    * explicit or implicit, first order accurate or second order accurate.
    * We fix \f$\beta = \frac{1}{2}\gamma\f$, which corresponds to
-   * average acceleration method.
+   * average acceleration method. The explicit scheme uses \f$\beta = 0\f$,
+   * i.e. central difference, with the row-sum lumped mass matrix.
    */
   template <int dim>
   class LinearElasticity : public SolidSolver<dim>
@@ -89,6 +90,13 @@ namespace Solid
      */
     void assemble_rhs();
 
+    /**
+     * The largest stable time step of the explicit scheme,
+     * \f$ \sqrt{2/\gamma}/\omega_{max} \f$, with the Gershgorin bound of the
+     * largest eigenvalue \f$ \omega_{max}^2 \f$ of \f$ M_L^{-1}K \f$.
+     */
+    double stable_time_step() const;
+
     /**
      * Update the strain and stress, used in output_results and FSI.
      */
@@ -100,6 +108,10 @@ namespace Solid
     void run_one_step(bool);
 
     std::vector<LinearElasticMaterial<dim>> material;
+
+    /// The inverse of the row-sum lumped mass matrix, 0 on the constrained
+    /// dofs. Only assembled by the explicit scheme.
+    Vector<double> lumped_mass_inverse;
   };
 } // namespace Solid
 
@@ -0,0 +1,176 @@
+#ifndef MPI_DISTRIBUTED_FSI
+#define MPI_DISTRIBUTED_FSI
+
+#include <deal.II/physics/elasticity/standard_tensors.h>
+
+#include <functional>
+#include <limits>
+
+#include "mpi_fluid_solver.h"
+#include "mpi_solid_solver.h"
+
+using namespace dealii;
+
+extern template class Fluid::MPI::FluidSolver<2>;
+extern template class Fluid::MPI::FluidSolver<3>;
+extern template class Solid::MPI::SolidSolver<2>;
+extern template class Solid::MPI::SolidSolver<3>;
+extern template class Utils::GridInterpolator<2, PETScWrappers::MPI::Vector>;
+extern template class Utils::GridInterpolator<3, PETScWrappers::MPI::Vector>;
+extern template class Utils::GridInterpolator<2,
+                                              PETScWrappers::MPI::BlockVector>;
+extern template class Utils::GridInterpolator<3,
+                                              PETScWrappers::MPI::BlockVector>;
+extern template class Utils::CellTree<2, DoFHandler<2, 2>>;
+extern template class Utils::CellTree<3, DoFHandler<3, 3>>;
+
+namespace MPI
+{
+  /*! \brief FSI coupler of the fluid solver and a distributed solid solver.
+   *
+   * Unlike MPI::FSI, no process holds the entire solid: both the fluid and
+   * the solid triangulations are distributed, and the interface data is only
+   * exchanged between the processes whose partitions overlap. Every exchange
+   * sends the points to the processes whose locally owned cells may contain
+   * them, according to the all-gathered bounding boxes, and the points are
+   * evaluated by the owners of the cells that contain them.
+   *
+   * The fluid mesh is not adapted, and checkpoints are not supported.
+   */
+  template <int dim>
+  class DistributedFSI
+  {
+  public:
+    DistributedFSI(Fluid::MPI::FluidSolver<dim> &,
+                   Solid::MPI::SolidSolver<dim> &,
+                   const Parameters::AllParameters &,
+                   bool use_dirichlet_bc = false);
+    void run();
+
+    //! Destructor
+    ~DistributedFSI();
+
+  private:
+    /// Evaluate the values at a point into the output array, return false
+    /// if the point is not in any locally owned cell.
+    using PointEvaluator = std::function<bool(const Point<dim> &, double *)>;
+
+    /*! \brief Move solid triangulation either forward or backward using
+     *  displacements.
+     *
+     *  Only the vertices of the locally owned and ghost solid cells are
+     *  moved, so that the deformed configuration of the artificial cells is
+     *  never needed. Moving forward saves the reference vertices, and moving
+     *  backward restores them.
+     */
+    void move_solid_mesh(bool);
+
+    /// Update the ghosted solid velocity and acceleration.
+    void update_solid_ghosts();
+
+    /// The box that contains the vertices of the locally owned cells of a
+    /// mesh, in the order of (x_min, x_max, y_min, y_max, z_min, z_max). The
+    /// box of a process without cells is empty.
+    std::vector<double> owned_box(const DoFHandler<dim> &) const;
+
+    /*! \brief Evaluate points on the processes that own them.
+     *
+     *  The points are sent to every process whose answer box contains them,
+     *  and each process answers with the values of the points it finds.
+     *  A point that is found by several processes takes the values of the
+     *  lowest rank. The values are stored point by point, n_values each.
+     *  Collective on the communicator, every process must call it with the
+     *  same tag, even if it has no points.
+     */
+    void exchange_points(const std::vector<Point<dim>> &points,
+                         const unsigned int n_values,
+                         const std::vector<double> &answer_box,
+                         const PointEvaluator &evaluate,
+                         const int tag,
+                         std::vector<double> &values,
+                         std::vector<bool> &found);
+
+    /// Evaluate the solid velocity, acceleration and material id at a point
+    /// in the deformed configuration.
+    bool evaluate_solid(const Point<dim> &, double *);
+
+    /// Evaluate the fluid pressure and velocity gradient at a point.
+    bool evaluate_fluid(const Point<dim> &, double *);
+
+    /*! \brief Update the indicator field of the fluid solver, as well as the
+     *  fsi acceleration and material id of the artificial fluid cells.
+     *
+     *  The centers of the locally owned fluid cells are located in the
+     *  deformed solid. The indicator of a cell is 1 if its center is in the
+     *  solid.
+     */
+    void update_indicator();
+
+    /// Collect the velocity support points on the boundaries of the
+    /// non-artificial fluid cells, each dof for the first cell that has it.
+    /// The fluid mesh does not change, so it is only done once.
+    void collect_support_points();
+
+    /*! \brief Compute the Dirichlet BCs on the artificial fluid using solid
+     *  velocity.
+     *
+     *  Only used if use_dirichlet_bc is true. The velocity support points of
+     *  the non-artificial fluid cells are located in the deformed solid.
+     */
+    void find_fluid_bc();
+
+    /*! \brief Compute the fluid traction on solid boundaries.
+     *
+     *  The quadrature points on the boundary faces of the locally owned solid
+     *  cells are sent to the fluid processes, which evaluate the pressure and
+     *  the velocity gradient there.
+     */
+    void find_solid_bc();
+
+    /// Set the time step of the coupling and both solvers to the proposal
+    /// of the fluid solver.
+    void adapt_time_step();
+
+    Fluid::MPI::FluidSolver<dim> &fluid_solver;
+    Solid::MPI::SolidSolver<dim> &solid_solver;
+    Parameters::AllParameters parameters;
+    MPI_Comm mpi_communicator;
+    ConditionalOStream pcout;
+    Utils::Time time;
+    mutable TimerOutput timer;
+
+    // Whether the solid triangulation is in the deformed configuration, and
+    // the vertices of solid_vertices in the reference configuration if it
+    // is.
+    bool solid_mesh_deformed;
+    std::vector<Point<dim>> reference_vertices;
+
+    // The locally relevant vertices of the solid mesh with their dofs.
+    Utils::VertexDofMap<dim> solid_vertices;
+
+    // Bounding box trees over the locally relevant fluid cells and the
+    // locally relevant solid cells in the deformed configuration.
+    Utils::CellTree<dim, DoFHandler<dim>> fluid_tree;
+    Utils::CellTree<dim, DoFHandler<dim>> solid_tree;
+
+    // The mapping of the fluid cells, and the values at the fluid cell
+    // centers in update_indicator, only built once.
+    MappingQGeneric<dim> fluid_mapping;
+    FEValues<dim> fluid_center_values;
+
+    // The solid velocity and acceleration with the ghost entries of the
+    // locally owned solid cells.
+    PETScWrappers::MPI::Vector ghosted_solid_velocity;
+    PETScWrappers::MPI::Vector ghosted_solid_acceleration;
+
+    // The real coordinates, global dofs and velocity components of the
+    // support points collected in collect_support_points.
+    std::vector<Point<dim>> support_points;
+    std::vector<types::global_dof_index> support_dofs;
+    std::vector<unsigned int> support_components;
+
+    bool use_dirichlet_bc;
+  };
+} // namespace MPI
+
+#endif
@@ -3,12 +3,15 @@
 
 #include <deal.II/base/function.h>
 #include <deal.II/base/logstream.h>
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/multithread_info.h>
 #include <deal.II/base/quadrature_lib.h>
 #include <deal.II/base/quadrature_point_data.h>
 #include <deal.II/base/tensor.h>
 #include <deal.II/base/tensor_function.h>
 #include <deal.II/base/timer.h>
 #include <deal.II/base/utilities.h>
+#include <deal.II/base/work_stream.h>
 
 #include <deal.II/lac/affine_constraints.h>
 #include <deal.II/lac/block_sparse_matrix.h>
@@ -29,6 +32,7 @@
 
 #include <deal.II/physics/elasticity/standard_tensors.h>
 
+#include <deal.II/grid/filtered_iterator.h>
 #include <deal.II/grid/grid_generator.h>
 #include <deal.II/grid/grid_refinement.h>
 #include <deal.II/grid/grid_tools.h>
@@ -55,10 +59,16 @@
 #include <deal.II/distributed/solution_transfer.h>
 #include <deal.II/distributed/tria.h>
 
+#include <boost/functional/hash.hpp>
+
+#include <cstdint>
 #include <experimental/filesystem>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <thread>
 
 #include "parameters.h"
 #include "utilities.h"
@@ -69,6 +79,8 @@ namespace MPI
 {
   template <int dim>
   class FSI;
+  template <int dim>
+  class DistributedFSI;
 }
 
 namespace Fluid
@@ -84,6 +96,7 @@ namespace Fluid
     public:
       //! FSI solver need access to the private members of this solver.
       friend ::MPI::FSI<dim>;
+      friend ::MPI::DistributedFSI<dim>;
 
       //! Constructor.
       FluidSolver(parallel::distributed::Triangulation<dim> &,
@@ -101,9 +114,76 @@ namespace Fluid
       //! Return the solution for testing.
       PETScWrappers::MPI::BlockVector get_current_solution() const;
 
+      /// The fields of an output step, referenced without copies. The
+      /// solution has the ghost entries of the locally relevant dofs, the
+      /// stress only has the locally owned scalar dofs, and the indicator is
+      /// indexed by the active cell index, or empty without an FSI coupler.
+      struct InSituData
+      {
+        unsigned int output_index;
+        double time;
+        const DoFHandler<dim> &dof_handler;
+        const DoFHandler<dim> &scalar_dof_handler;
+        const PETScWrappers::MPI::BlockVector &solution;
+        const std::vector<std::vector<PETScWrappers::MPI::Vector>> &stress;
+        const std::vector<int> &indicator;
+      };
+
+      /// Called on every process at the output steps, before the files are
+      /// written. The files are only written if it returns true, which must
+      /// be the same on all processes.
+      using InSituHook = std::function<bool(const InSituData &)>;
+
+      //! Set the in-situ hook, an empty function removes it.
+      void set_in_situ_hook(const InSituHook &hook) { in_situ_hook = hook; }
+
+      /// Allocate the cell properties from the next initialize_system on,
+      /// called by the FSI couplers. A pure fluid never allocates them.
+      void enable_cell_property() { cell_property_enabled = true; }
+
     protected:
       class BoundaryValues;
-      struct CellProperty;
+
+      /// A data structure that caches the real/artificial fluid indicator,
+      /// FSI stress, and FSI acceleration terms of the cells, that will only
+      /// be used in FSI simulations. Every field is a contiguous array indexed
+      /// by the active cell index, which is rebuilt by setup_cell_property
+      /// whenever the mesh changes. Only the entries of the locally owned
+      /// cells are kept up to date. Without an FSI coupler the fields are
+      /// empty, and the getters return the values of a real fluid cell.
+      struct CellProperty
+      {
+        int get_indicator(const unsigned int cell) const
+        {
+          return indicator.empty() ? 0 : indicator[cell];
+        }
+        Tensor<1, dim> get_fsi_acceleration(const unsigned int cell) const
+        {
+          return fsi_acceleration.empty() ? Tensor<1, dim>()
+                                          : fsi_acceleration[cell];
+        }
+        SymmetricTensor<2, dim> get_fsi_stress(const unsigned int cell) const
+        {
+          return fsi_stress.empty() ? SymmetricTensor<2, dim>()
+                                    : fsi_stress[cell];
+        }
+        bool is_inactive(const unsigned int cell) const
+        {
+          return !inactive.empty() && inactive[cell];
+        }
+
+        /// Domain indicator: 1 for artificial fluid 0 for real fluid.
+        std::vector<int> indicator;
+        /// The acceleration term in FSI force.
+        std::vector<Tensor<1, dim>> fsi_acceleration;
+        /// The stress term in FSI force.
+        std::vector<SymmetricTensor<2, dim>> fsi_stress;
+        /// The material id of the surrounding solid cell.
+        std::vector<int> material_id;
+        /// 1 for the artificial fluid cells deep inside the solid, which are
+        /// not assembled and whose own dofs are constrained.
+        std::vector<int> inactive;
+      };
 
       //! Pure abstract function to run simulation for one step
       virtual void run_one_step(bool apply_nonzero_constraints,
@@ -112,46 +192,161 @@ namespace Fluid
       //! Set up the dofs based on the finite element and renumber them.
       void setup_dofs();
 
-      //! Set up the nonzero and zero constraints.
+      //! Set up the nonzero and zero constraints, which are also kept as
+      //! the static constraints of the current mesh.
       void make_constraints();
 
+      /// Restore the constraints to the static ones without building them
+      /// again, so that the FSI only has to merge the inner constraints of
+      /// the artificial fluid. Both of them are homogeneous unless nonzero
+      /// is true.
+      void reset_constraints(const bool nonzero);
+
       //! Initialize the cell properties, which only matters in FSI
-      //! applications.
+      //! applications. They are left empty unless they are enabled.
       void setup_cell_property();
 
+      /// Whether initialize_system builds the mass matrix and the mass Schur
+      /// complement, which only the solvers with a mass Schur complement
+      /// preconditioner need.
+      virtual bool needs_mass_matrices() const { return false; }
+
+      /// Set up the scalar dofs and allocate the stress if they are not yet
+      /// there. They are only needed for the output, and are dropped
+      /// whenever the dofs change.
+      void setup_stress() const;
+
       /// Specify the sparsity pattern and reinit matrices and vectors based on
       /// the dofs and constraints.
       virtual void initialize_system();
 
+      /// Whether the dofs or the constraints have changed since the last
+      /// call on any process. The matrices are kept otherwise.
+      bool system_layout_changed();
+
+      /// Add the local memory of the mesh, the matrices, the vectors and the
+      /// cell data to the report. The solvers add their own matrices.
+      virtual void add_memory(Utils::MemoryReport &) const;
+
+      /// Print the memory report of this process group if it is requested,
+      /// which the solvers do at the end of initialize_system.
+      void print_memory_report() const;
+
       /// Mesh adaption.
       void refine_mesh(const unsigned int, const unsigned int);
 
+      /// The present solution and the solution history, which are carried
+      /// over when the mesh changes.
+      std::vector<const PETScWrappers::MPI::BlockVector *>
+      solutions_to_transfer() const;
+
+      /// Interpolate the vectors of solutions_to_transfer() to the new dofs.
+      /// The system must have been initialized on the new mesh.
+      void interpolate_solutions(
+        parallel::distributed::SolutionTransfer<dim,
+                                                PETScWrappers::MPI::BlockVector>
+          &);
+
+      /// Extrapolate the change of the solution in the current time step
+      /// from the present solution and the solution history, then append
+      /// the present solution to the history. The change is non-ghosted and
+      /// zero on the constrained dofs. Must be called after time.increment().
+      /// The last two vectors of the workspace are overwritten.
+      void predict_solution_change(PETScWrappers::MPI::BlockVector &);
+
+      /// The cost of a locally owned cell relative to a plain fluid cell.
+      virtual double
+      cell_cost(const typename DoFHandler<dim>::active_cell_iterator &) const;
+
+      /// The sum of the costs of the locally owned cells, i.e. the load of
+      /// this process that the cell weights balance.
+      double local_cost() const;
+
+      /// The fluid acceleration that the FSI couplers compare with the solid
+      /// one, at the first quadrature point of FEValues that are
+      /// reinitialized on a locally owned cell: the velocity increment of
+      /// the last time step over the time step. Like in the serial FSI, the
+      /// convective term is left out.
+      Tensor<1, dim> fsi_fluid_acceleration(const FEValues<dim> &,
+                                            const double delta_t) const;
+
+      /// Sort the locally owned cells into interior_cells and
+      /// ghost_adjacent_cells, after the dofs are distributed.
+      void partition_owned_cells();
+
+      /// Compute the weights of the locally owned cells that the next
+      /// coarsening and refinement or repartition of the mesh uses. They
+      /// are cleared once the mesh has changed.
+      void compute_cell_weights();
+
+      /// The additional weight of a cell when p4est partitions the mesh, on
+      /// top of the default weight of 1000 of every cell.
+      unsigned int cell_weight(
+        const typename parallel::distributed::Triangulation<dim>::cell_iterator
+          &,
+        const typename parallel::distributed::Triangulation<dim>::CellStatus)
+        const;
+
       /// Output in vtu format.
       void output_results(const unsigned int) const;
 
       /// Update stress to output
       virtual void update_stress();
 
+      /// The largest CFL number of all the fluid cells, with the velocity at
+      /// the vertices and the current time step.
+      double cfl_number() const;
+
+      /// Adapt the time step to the CFL number and the Newton iterations of
+      /// the last time step.
+      void adapt_time_step();
+
+      /// March to the steady state with growing pseudo time steps until the
+      /// steady residual has dropped by the tolerance, then write the
+      /// output and a checkpoint. Replaces the time loop of run().
+      void run_pseudo_transient(const bool apply_nonzero_constraints);
+
       /// Save checkpoint for restart.
       void save_checkpoint(const int);
 
       /// Load from checkpoint to restart.
       bool load_checkpoint();
 
+      /// Wait until the solution of the last asynchronous checkpoint is
+      /// written on all processes.
+      void finish_checkpoint();
+
+      /// The name of the file that the solution of this process is written
+      /// to in an asynchronous or compressed checkpoint.
+      std::string checkpoint_data_file(const std::string &,
+                                       const unsigned int) const;
+
+      /// The time step of the checkpoint that a compressed checkpoint is the
+      /// difference to, or -1 if it is complete.
+      int checkpoint_key_of(const std::string &) const;
+
+      /// Read the locally owned solution of every block from the data file
+      /// of this process, and from the key checkpoint if it is a difference.
+      void
+      read_checkpoint_data(const std::string &,
+                           std::vector<std::vector<PetscScalar>> &) const;
+
       std::vector<types::global_dof_index> dofs_per_block;
 
       parallel::distributed::Triangulation<dim> &triangulation;
       FESystem<dim> fe;
       FE_Q<dim> scalar_fe;
       DoFHandler<dim> dof_handler;
-      DoFHandler<dim> scalar_dof_handler;
+      mutable DoFHandler<dim> scalar_dof_handler;
       QGauss<dim> volume_quad_formula;
       QGauss<dim - 1> face_quad_formula;
 
       AffineConstraints<double> zero_constraints;
       AffineConstraints<double> nonzero_constraints;
+      /// The hanging node and Dirichlet constraints of the current mesh.
+      AffineConstraints<double> static_zero_constraints;
+      AffineConstraints<double> static_nonzero_constraints;
 
-      BlockSparsityPattern sparsity_pattern;
       PETScWrappers::MPI::BlockSparseMatrix system_matrix;
       PETScWrappers::MPI::BlockSparseMatrix mass_matrix;
       PETScWrappers::MPI::BlockSparseMatrix mass_schur;
@@ -161,6 +356,31 @@ namespace Fluid
       PETScWrappers::MPI::BlockVector solution_increment;
       PETScWrappers::MPI::BlockVector system_rhs;
 
+      /// Non-ghosted buffers of the Newton loops and the predictor, e.g. to
+      /// update the ghosted evaluation point. They are only reinitialized
+      /// with the system, so that no iteration allocates vectors.
+      std::vector<PETScWrappers::MPI::BlockVector> workspace;
+
+      /// Copies of the ghosted evaluation point and present solution that
+      /// the assembly threads read, because PETSc vectors cannot be read by
+      /// several threads at once. They are reinitialized with the system.
+      LinearAlgebra::distributed::BlockVector<double> assembly_evaluation_point;
+      LinearAlgebra::distributed::BlockVector<double> assembly_present_solution;
+
+      /// The locally owned cells whose dofs are all locally owned, which do
+      /// not read any ghost value, and the other locally owned cells. The
+      /// assembly overlaps the ghost update of the solution with the first
+      /// ones.
+      std::vector<typename DoFHandler<dim>::active_cell_iterator>
+        interior_cells;
+      std::vector<typename DoFHandler<dim>::active_cell_iterator>
+        ghost_adjacent_cells;
+
+      /// The solutions of the previous time steps, the latest first, and
+      /// their times. At most as many as the order of the predictor.
+      std::vector<PETScWrappers::MPI::BlockVector> solution_history;
+      std::vector<double> solution_history_times;
+
       /**
        * Nodal strain and stress obtained by taking the average of surrounding
        * cell-averaged strains and stresses. Their sizes are
@@ -182,9 +402,9 @@ namespace Fluid
       std::vector<IndexSet> relevant_partitioning;
 
       /// The IndexSets of owned and relevant sclalar dofs for stress
-      /// computation.
-      IndexSet locally_owned_scalar_dofs;
-      IndexSet locally_relevant_scalar_dofs;
+      /// computation, set up with the stress.
+      mutable IndexSet locally_owned_scalar_dofs;
+      mutable IndexSet locally_relevant_scalar_dofs;
 
       /// The IndexSet of all relevant dofs. This seems to be redundant but
       /// handy.
@@ -197,27 +417,57 @@ namespace Fluid
       mutable TimerOutput timer;
       mutable TimerOutput timer2;
 
-      CellDataStorage<
-        typename parallel::distributed::Triangulation<dim>::cell_iterator,
-        CellProperty>
-        cell_property;
+      CellProperty cell_property;
+      bool cell_property_enabled;
 
       /// Hard-coded boundary values, only used when told so in the input
       /// parameters.
       std::shared_ptr<Function<dim>> boundary_values;
 
-      /// A data structure that caches the real/artificial fluid indicator,
-      /// FSI stress, and FSI acceleration terms at quadrature points, that
-      /// will only be used in FSI simulations.
-      struct CellProperty
-      {
-        int indicator; //!< Domain indicator: 1 for artificial fluid 0 for real
-                       //! fluid.
-        Tensor<1, dim>
-          fsi_acceleration; //!< The acceleration term in FSI force.
-        SymmetricTensor<2, dim> fsi_stress; //!< The stress term in FSI force.
-        int material_id; //!< The material id of the surrounding solid cell.
-      };
+      /// Accumulated number of linear solver iterations, reset by the caller
+      /// for profiling.
+      unsigned int linear_iterations;
+
+      /// Newton iterations of the last time step, 0 for the IMEX solver.
+      unsigned int newton_iterations;
+
+      /// The nonlinear residual at the first Newton iteration of the last
+      /// time step. Without a predictor it is the residual of the steady
+      /// equations at the solution of the step before.
+      double steady_residual;
+
+      /// Writes the output in groups of processes, if requested.
+      mutable std::unique_ptr<Utils::GroupedVtuWriter<dim>> vtu_writer;
+      /// Writes the output files while the time stepping goes on, if
+      /// requested.
+      mutable std::unique_ptr<Utils::BackgroundWriter> output_writer;
+
+      /// The solution at the probe points, sampled by the solvers after
+      /// every time step.
+      Utils::Probes<dim, PETScWrappers::MPI::BlockVector> probes;
+
+      /// Analyzes the output steps in memory, if set.
+      InSituHook in_situ_hook;
+
+      /// The partition weights of the active cells, empty if all the cells
+      /// have the same weight.
+      std::vector<unsigned int> cell_weights;
+      boost::signals2::connection cell_weight_connection;
+
+      /// Fingerprint of the dofs and constraints that the matrices were
+      /// built with, see system_layout_changed().
+      std::size_t system_layout_hash;
+
+      /// Writes the solution of the last asynchronous checkpoint.
+      std::thread checkpoint_writer;
+
+      /// The locally owned solution of the last complete compressed
+      /// checkpoint, which the following ones are the differences to, and
+      /// its time step. Reset whenever the dofs are distributed.
+      std::shared_ptr<const std::vector<std::vector<PetscScalar>>>
+        checkpoint_key;
+      int checkpoint_key_index;
+      unsigned int checkpoints_since_key;
     };
   } // namespace MPI
 } // namespace Fluid
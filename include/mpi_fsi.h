@@ -1,7 +1,9 @@
 #ifndef MPI_FSI
 #define MPI_FSI
 
+#include <deal.II/base/parallel.h>
 #include <deal.II/base/table_indices.h>
+#include <deal.II/base/thread_local_storage.h>
 #include <deal.II/physics/elasticity/standard_tensors.h>
 
 #include "mpi_fluid_solver.h"
@@ -15,16 +17,26 @@ extern template class Solid::MPI::SharedSolidSolver<2>;
 extern template class Solid::MPI::SharedSolidSolver<3>;
 extern template class Utils::GridInterpolator<2, Vector<double>>;
 extern template class Utils::GridInterpolator<3, Vector<double>>;
+extern template class Utils::GridInterpolator<2, PETScWrappers::MPI::Vector>;
+extern template class Utils::GridInterpolator<3, PETScWrappers::MPI::Vector>;
 extern template class Utils::GridInterpolator<2,
                                               PETScWrappers::MPI::BlockVector>;
 extern template class Utils::GridInterpolator<3,
                                               PETScWrappers::MPI::BlockVector>;
+extern template class Utils::CellPointInterpolator<
+  2,
+  PETScWrappers::MPI::BlockVector>;
+extern template class Utils::CellPointInterpolator<
+  3,
+  PETScWrappers::MPI::BlockVector>;
 extern template class Utils::SPHInterpolator<2, Vector<double>>;
 extern template class Utils::SPHInterpolator<3, Vector<double>>;
 extern template class Utils::SPHInterpolator<2,
                                              PETScWrappers::MPI::BlockVector>;
 extern template class Utils::SPHInterpolator<3,
                                              PETScWrappers::MPI::BlockVector>;
+extern template class Utils::CellTree<2, DoFHandler<2, 2>>;
+extern template class Utils::CellTree<3, DoFHandler<3, 3>>;
 extern template class Utils::CellLocator<2, DoFHandler<2, 2>>;
 extern template class Utils::CellLocator<3, DoFHandler<3, 3>>;
 
@@ -44,20 +56,78 @@ namespace MPI
     ~FSI();
 
   private:
-    /// Collect all the boundary lines in solid triangulation.
+    /// Collect all the boundary faces in solid triangulation.
     void collect_solid_boundaries();
 
-    /// Setup the hints for searching for each fluid cell.
+    /// Copy the coordinates of the solid boundary lines into a contiguous
+    /// array and bin them by their y-ranges. Only used in 2D.
+    void update_boundary_segments();
+
+    /// Split the solid boundary faces into two triangles each with the
+    /// current coordinates, and refit the surface tree. Only used in 3D.
+    void update_boundary_surface();
+
+    /*! \brief Setup the hints for searching for each fluid cell.
+     *
+     *  Also collects the non-artificial fluid cells and, if use_dirichlet_bc
+     *  is true, the velocity support points that find_fluid_bc locates in the
+     *  solid. Must be called after every change of the fluid mesh.
+     */
     void setup_cell_hints();
 
-    /// Define a smallest rectangle (or hex in 3d) that contains the solid.
+    /// Print the memory of the coupling data if it is requested, which
+    /// setup_cell_hints does whenever the fluid mesh changes.
+    void print_memory_report() const;
+
+    /// Define the smallest rectangles (or hexes in 3d) that contain the
+    /// solid and each of its parts.
     void update_solid_box();
 
+    /// The solid part of a solid cell, given by its material id.
+    unsigned int solid_part_of(
+      const typename DoFHandler<dim>::active_cell_iterator &) const;
+
+    /// Find the solid parts whose boxes overlap with the box of the
+    /// non-artificial fluid cells, whenever either of them changes.
+    void select_relevant_solid_parts();
+
+    /// Whether a point is within a margin of the box of a relevant solid
+    /// part. Always true before the part boxes are first computed.
+    bool near_solid_part(const Point<dim> &, const double margin = 0) const;
+
     /// Find the vertices that are onwed by the local process.
     void update_vertices_mask();
 
-    /// Check if a point is inside a mesh.
-    bool point_in_solid(const DoFHandler<dim> &, const Point<dim> &);
+    /*! \brief Update the ghosted solid velocity and acceleration.
+     *
+     *  If distributed solid state is used, the relevant solid dofs are those
+     *  of the solid cells that overlap with the non-artificial fluid cells
+     *  on this process; otherwise all of the solid dofs are relevant. Must
+     *  be called with the solid mesh in its deformed configuration.
+     */
+    void update_solid_ghosts();
+
+    /*! \brief Locate a point in the fluid mesh starting from a hint cell.
+     *
+     *  The hint is checked first, then its active neighbors, and a global
+     *  search over the local vertices is only done if both fail. Returns
+     *  the end iterator if the point cannot be located by this process.
+     *  The hits and misses are counted in the record, so that the function
+     *  can be called by several threads with a record each.
+     */
+    typename DoFHandler<dim>::active_cell_iterator
+    locate_fluid_point(const Point<dim> &,
+                       const typename DoFHandler<dim>::active_cell_iterator &,
+                       Utils::PerformanceCounters::Record &) const;
+
+    /// Check if a point is inside a mesh. Only reads the solid boundary and
+    /// the solid tree, so it is safe to be called by several threads.
+    bool point_in_solid(const DoFHandler<dim> &, const Point<dim> &) const;
+
+    /// Check if the points are inside the solid, 3D queries share the
+    /// traversal buffer of the surface tree.
+    void points_in_solid(const std::vector<Point<dim>> &,
+                         std::vector<int> &) const;
 
     /*! \brief Update the indicator field of the fluid solver.
      *
@@ -69,22 +139,75 @@ namespace MPI
      */
     void update_indicator();
 
-    /// Move solid triangulation either forward or backward using
-    /// displacements,
+    /*! \brief Update the indicator in a band around the solid boundary.
+     *
+     *  The band consists of the given number of layers of fluid cells around
+     *  the interface cells of the previous update, and around the subdomain
+     *  boundary near the solid, where the interface may not be visible. The
+     *  cells outside the band keep their indicator. Returns false if the
+     *  indicator changed on the outermost layer, in which case all the cells
+     *  have to be evaluated again.
+     */
+    bool update_indicator_band(const unsigned int);
+
+    /// Collect the interface and subdomain boundary cells from all the
+    /// locally owned fluid cells, after a full indicator update.
+    void collect_indicator_interface();
+
+    /*! \brief Deactivate the artificial fluid deep inside the solid.
+     *
+     *  Every locally owned artificial fluid cell that is more than the given
+     *  number of layers away from the real fluid, and from the cells of the
+     *  other processes whose indicators are not known here, is marked as
+     *  inactive in the fluid cell properties. The locally relevant dofs that
+     *  only belong to inactive cells are returned, they are constrained to
+     *  keep their values.
+     */
+    void deactivate_artificial_interior(const unsigned int,
+                                        std::vector<types::global_dof_index> &);
+
+    /*! \brief Move solid triangulation either forward or backward using
+     *  displacements.
+     *
+     *  The triangulation stays in the deformed configuration from the
+     *  solid solve of one time step until the solid solve of the next one,
+     *  so that all of the coupling routines share it. Moving forward saves
+     *  the reference vertices, and moving backward restores them. Calls that
+     *  do not change the configuration return immediately.
+     */
     void move_solid_mesh(bool);
 
+    /// move_solid_mesh with the coordinates in node shared memory.
+    void move_solid_mesh_node_shared(const bool);
+
     /*! \brief Compute the fluid traction on solid boundaries.
      *
      *  The implementation is straight-forward: loop over the faces on the
      *  solid Neumann boundary, find the quadrature points and normals,
      *  then interpolate the fluid pressure and symmetric gradient of velocity
      * at those points, based on which the fluid traction is calculated.
+     * All of the quadrature points are collected first, each process evaluates
+     * the ones it owns, and the results are exchanged through one packed
+     * reduction per call rather than one per point.
      */
     void find_solid_bc();
 
+    /*! \brief The first half of find_solid_bc.
+     *
+     *  Evaluate the fluid solution at the solid boundary quadrature points
+     *  owned by this process and post a non-blocking reduction.
+     */
+    void start_solid_bc_exchange();
+
+    /// The second half of find_solid_bc: wait for the reduction to complete
+    /// and compute the tractions.
+    void finish_solid_bc_exchange();
+
     /*! \brief Interpolate the fluid velocity to solid vertices.
      *
-     *  This is IFEM, not mIFEM.
+     *  This is IFEM, not mIFEM. Every vertex is only searched for and
+     *  evaluated by the process that owns the fluid cell containing it, see
+     *  solid_vertex_owners.
      */
     void update_solid_displacement();
 
@@ -104,8 +227,89 @@ namespace MPI
      */
     void find_fluid_bc();
 
-    /// Mesh adaption.
-    void refine_mesh(const unsigned int, const unsigned int);
+    /// Mesh adaption, returns false if no cell was refined or coarsened.
+    bool refine_mesh(const unsigned int, const unsigned int);
+
+    /// Refine (if true) or only repartition the fluid mesh with the cell
+    /// weights of the fluid solver, and transfer the fluid solution.
+    void redistribute_fluid(const bool refine);
+
+    /*! \brief Give every solid cell to the process that owns the fluid cell
+     *  around its center, if the fluid aligned solid partitioner is used.
+     *
+     *  The centers are taken in the current configuration of the solid mesh.
+     *  Every process gets at most the partition imbalance times the average
+     *  number of solid cells, the cells that do not fit or are not in the
+     *  fluid go to the processes with the fewest cells in the order of the
+     *  active cells. The solid is only repartitioned if the partition
+     *  changes. Must be called after every change of the fluid mesh.
+     */
+    void align_solid_partition();
+
+    /// Flag the locally owned fluid cells close to the solid boundary for
+    /// refinement, and the others for coarsening.
+    void flag_cells_near_solid_boundary();
+
+    /// Flag the locally owned fluid cells within the given number of layers
+    /// of the indicator interface for refinement, and the others for
+    /// coarsening.
+    void flag_cells_in_indicator_band(const unsigned int);
+
+    /*! \brief Run the solid solver for one coupling step and record its
+     *  counters.
+     *
+     *  The solid takes the given number of sub-steps, the fluid traction of
+     *  every sub-step is interpolated linearly from that of the previous
+     *  coupling step to the current one.
+     */
+    void run_solid_solver(const bool);
+
+    /*! \brief Post the exchange of the solid state from the solid group to
+     *  the other processes.
+     *
+     *  The solid vectors are sent in the canonical dof numbering: every
+     *  process of the group sends the entries it owns and the others send
+     *  zeros, so that one sum gives every process the whole state. Only used
+     *  if a group of processes solves the solid.
+     */
+    void start_solid_state_exchange();
+
+    /// Wait for the solid state, and copy it into the solid solver of a
+    /// process outside of the solid group.
+    void finish_solid_state_exchange();
+
+    /// Run the fluid solver for one step and record its counters.
+    void run_fluid_solver();
+
+    /*! \brief Set up the fluid BCs and run the fluid solver for all of the
+     *  fluid sub-steps of a coupling step.
+     *
+     *  If interpolate is true, the solid velocity and acceleration of every
+     *  sub-step are interpolated linearly between the start and the end of
+     *  the last solid step, otherwise the current ones are used.
+     */
+    void run_fluid_sub_steps(const bool first_step, const bool interpolate);
+
+    /*! \brief Solve a coupling step with the strongly coupled scheme.
+     *
+     *  Every coupling iteration runs the solid with the fluid traction at
+     *  the interface points, the fluid with the new solid, and evaluates
+     *  the fluid traction again. The unknown of the fixed point iterations
+     *  is the flat interface buffer of the solid, whose next iterate is
+     *  given by the coupling acceleration. Both solvers go back to their
+     *  state at the start of the step before every iteration but the
+     *  first, the iterations stop when the change of the traction is
+     *  within the relative coupling tolerance.
+     */
+    void run_coupling_iterations(const bool first_step);
+
+    /// Set the time step of the coupling and both solvers to the smaller of
+    /// the fluid and the solid proposals.
+    void adapt_time_step();
+
+    /// Set the time step of the coupling, and that of the solvers to their
+    /// share of it.
+    void set_time_step(const double);
 
     // For MPI FSI, the solid solver uses shared trianulation. i.e.,
     // each process has the entire graph, for the ease of looping.
@@ -117,15 +321,61 @@ namespace MPI
     Utils::Time time;
     mutable TimerOutput timer;
 
+    // Per time step counters of the coupling phases, written to the
+    // performance log if requested.
+    Utils::PerformanceCounters counters;
+
+    // The total wall time of the Tpp solves until the last time step.
+    double previous_tpp_time;
+
+    // Whether the solid triangulation is in the deformed configuration, and
+    // the vertices of solid_vertices in the reference configuration if it
+    // is.
+    bool solid_mesh_deformed;
+    std::vector<Point<dim>> reference_vertices;
+
+    // The vertices of the solid mesh with their dofs.
+    Utils::VertexDofMap<dim> solid_vertices;
+
+    // The localized solid displacement, one copy per node, if requested.
+    Utils::NodeSharedVector shared_solid_displacement;
+    // The coordinates of solid_vertices in the reference and the deformed
+    // configuration, one copy per node, which replace reference_vertices
+    // if the solid state is node shared. Every process of a node computes
+    // a share of them and copies the whole array into its triangulation.
+    Utils::NodeSharedVector shared_reference_vertices;
+    Utils::NodeSharedVector shared_deformed_vertices;
+
     // This vector represents the smallest box that contains the solid.
     // The point stored is in the order of:
     // (x_min, x_max, y_min, y_max, z_min, z_max)
     Vector<double> solid_box;
 
-    // This vector collects the solid boundaries for computing thw winding
-    // number.
+    // The boxes of the solid parts in the same order, empty for a part
+    // without cells. Only the relevant parts overlap with the non-artificial
+    // fluid cells of this process, so only they can contain the points that
+    // the process looks for when the parts are spread over the domain.
+    std::vector<Vector<double>> solid_part_boxes;
+    std::vector<bool> relevant_solid_parts;
+
+    // This vector collects the solid boundary faces for the containment
+    // tests.
     std::list<typename Triangulation<dim>::face_iterator> solid_boundaries;
 
+    // The end points of the solid boundary lines in the deformed
+    // configuration, two consecutive points per line.
+    std::vector<Point<dim>> boundary_segments;
+
+    // The boundary lines binned by their y-ranges: the lines in bin b are
+    // boundary_bin_edges[boundary_bin_offsets[b], boundary_bin_offsets[b+1]).
+    std::vector<unsigned int> boundary_bin_offsets;
+    std::vector<unsigned int> boundary_bin_edges;
+    double boundary_bin_size;
+
+    // The solid boundary faces split into triangles in the deformed
+    // configuration, which are crossed by a ray in 3D. Empty in 2D.
+    Utils::SurfaceTree boundary_surface;
+
     // A mask that marks local fluid vertices for solid bc interpolation
     // searching.
     std::vector<bool> vertices_mask;
@@ -136,6 +386,108 @@ namespace MPI
       typename DoFHandler<dim>::active_cell_iterator>
       cell_hints;
 
+    // A velocity support point on the boundary of a non-artificial fluid
+    // cell, each dof is only stored for the first cell that has it. The
+    // fluid mesh does not move, so the real coordinates only change with the
+    // mesh.
+    struct SupportPoint
+    {
+      typename DoFHandler<dim>::active_cell_iterator cell;
+      types::global_dof_index dof;
+      unsigned int component;
+      Point<dim> point;
+      // The hint of the support point in cell_hints.
+      std::shared_ptr<typename DoFHandler<dim>::active_cell_iterator> hint;
+      bool in_solid;
+    };
+
+    // The non-artificial fluid cells and their velocity support points,
+    // rebuilt in setup_cell_hints.
+    std::vector<typename DoFHandler<dim>::active_cell_iterator>
+      relevant_fluid_cells;
+    std::vector<SupportPoint> support_points;
+
+    // Bounding box tree over the solid cells in the deformed configuration.
+    // It is refitted in update_solid_box.
+    Utils::CellTree<dim, DoFHandler<dim>> solid_tree;
+
+    // Locator that searches the solid cells from the hints above. It keeps
+    // its search buffers between queries.
+    Utils::CellLocator<dim, DoFHandler<dim>> solid_locator;
+
+    // The mapping of the fluid cells, and the values at the fluid cell
+    // centers in find_fluid_bc. The fluid element never changes, so they are
+    // only built once.
+    MappingQGeneric<dim> fluid_mapping;
+    FEValues<dim> fluid_center_values;
+
+    /// Number of points or cells that a thread works on at a time in the
+    /// threaded loops of the coupling routines.
+    static const unsigned int coupling_grainsize = 64;
+
+    // The buffers and request of the non-blocking traction exchange, and the
+    // solid normals at every solid boundary quadrature point.
+    Vector<double> solid_bc_send_buffer;
+    Vector<double> solid_bc_recv_buffer;
+    std::vector<Tensor<1, dim>> solid_bc_normals;
+    MPI_Request solid_bc_request;
+
+    // Whether only a group of processes solves the solid, and whether this
+    // process is in it. The others skip the solid solves and receive the
+    // state through a non-blocking reduction on a communicator of its own.
+    bool solid_group;
+    bool owns_solid;
+    MPI_Comm solid_state_communicator;
+    Vector<double> solid_state_buffer;
+    MPI_Request solid_state_request;
+
+    // The box that contains the locally owned fluid cells, in the same order
+    // as solid_box.
+    Vector<double> local_fluid_box;
+
+    // The box that contains all of the non-artificial fluid cells.
+    Vector<double> relevant_fluid_box;
+
+    // The solid dofs needed by the fluid cells on this process, and the
+    // ghosted solid velocity and acceleration on them.
+    IndexSet solid_relevant_dofs;
+    PETScWrappers::MPI::Vector ghosted_solid_velocity;
+    PETScWrappers::MPI::Vector ghosted_solid_acceleration;
+
+    // The solid velocity and acceleration before the last solid step, only
+    // kept if the fluid takes sub-steps.
+    PETScWrappers::MPI::Vector solid_velocity_start;
+    PETScWrappers::MPI::Vector solid_acceleration_start;
+
+    // The fluid traction at every solid interface point in the previous
+    // coupling step, only used if the solid takes sub-steps.
+    std::vector<Tensor<1, dim>> previous_tractions;
+
+    // The fluid cells where the solid boundary quadrature points and the solid
+    // vertices were found last time. They are reset whenever the fluid mesh
+    // is refined.
+    std::vector<typename DoFHandler<dim>::active_cell_iterator> solid_bc_hints;
+    std::vector<typename DoFHandler<dim>::active_cell_iterator>
+      solid_vertex_hints;
+    // The process that evaluates the fluid velocity at each solid vertex,
+    // invalid_unsigned_int if the vertex is not in any fluid cell. The owners
+    // are computed collectively and only updated for the vertices that leave
+    // the cells of their owners.
+    std::vector<unsigned int> solid_vertex_owners;
+
+    // The locally owned fluid cells that have a neighbor with a different
+    // indicator, and the ones that have a neighbor owned by other processes.
+    // They are only valid if indicator_band_valid is true.
+    std::vector<typename DoFHandler<dim>::active_cell_iterator>
+      interface_cells;
+    std::vector<typename DoFHandler<dim>::active_cell_iterator>
+      subdomain_boundary_cells;
+    bool indicator_band_valid;
+
+    // The layer of every active fluid cell in the indicator band, invalid for
+    // the cells not in the band.
+    std::vector<unsigned int> indicator_band_layer;
+
     bool use_dirichlet_bc;
   };
 } // namespace MPI
@@ -121,9 +121,13 @@ namespace Solid
       using SolidSolver<dim>::timer;
       using SolidSolver<dim>::locally_owned_dofs;
       using SolidSolver<dim>::locally_relevant_dofs;
+      using SolidSolver<dim>::cell_property;
+      using SolidSolver<dim>::print_memory_report;
 
       void initialize_system() override;
 
+      void add_memory(Utils::MemoryReport &) const override;
+
       /** Assemble the lhs and rhs at the same time. */
       void assemble_system(bool);
 
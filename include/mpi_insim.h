@@ -2,6 +2,9 @@
 #define MPI_INSIM
 
 #include "mpi_fluid_solver.h"
+#include "mpi_velocity_operator.h"
+#include "solver_pipelined.h"
+#include "solver_policy.h"
 
 namespace Fluid
 {
@@ -45,15 +48,23 @@ namespace Fluid
       ~InsIM(){};
       //! Run the simulation.
       void run();
+      /// The mesh smoothing and the settings to create the triangulation
+      /// with, the matrix-free velocity solver needs the multigrid hierarchy.
+      static typename Triangulation<dim>::MeshSmoothing
+      triangulation_smoothing(const Parameters::AllParameters &);
+      static typename parallel::distributed::Triangulation<dim>::Settings
+      triangulation_settings(const Parameters::AllParameters &);
 
     private:
       class BlockSchurPreconditioner;
 
+      using FluidSolver<dim>::print_memory_report;
       using FluidSolver<dim>::setup_dofs;
       using FluidSolver<dim>::make_constraints;
       using FluidSolver<dim>::setup_cell_property;
       using FluidSolver<dim>::initialize_system;
       using FluidSolver<dim>::refine_mesh;
+      using FluidSolver<dim>::predict_solution_change;
       using FluidSolver<dim>::output_results;
       using FluidSolver<dim>::update_stress;
       using FluidSolver<dim>::save_checkpoint;
@@ -69,13 +80,15 @@ namespace Fluid
       using FluidSolver<dim>::face_quad_formula;
       using FluidSolver<dim>::zero_constraints;
       using FluidSolver<dim>::nonzero_constraints;
-      using FluidSolver<dim>::sparsity_pattern;
       using FluidSolver<dim>::system_matrix;
       using FluidSolver<dim>::mass_matrix;
       using FluidSolver<dim>::mass_schur;
       using FluidSolver<dim>::present_solution;
       using FluidSolver<dim>::solution_increment;
       using FluidSolver<dim>::system_rhs;
+      using FluidSolver<dim>::workspace;
+      using FluidSolver<dim>::assembly_evaluation_point;
+      using FluidSolver<dim>::assembly_present_solution;
       using FluidSolver<dim>::stress;
       using FluidSolver<dim>::parameters;
       using FluidSolver<dim>::mpi_communicator;
@@ -87,15 +100,22 @@ namespace Fluid
       using FluidSolver<dim>::locally_relevant_scalar_dofs;
       using FluidSolver<dim>::times_and_names;
       using FluidSolver<dim>::time;
+      using FluidSolver<dim>::probes;
       using FluidSolver<dim>::timer;
       using FluidSolver<dim>::timer2;
       using FluidSolver<dim>::cell_property;
       using FluidSolver<dim>::boundary_values;
+      using FluidSolver<dim>::linear_iterations;
+      using FluidSolver<dim>::newton_iterations;
+      using FluidSolver<dim>::adapt_time_step;
 
       /// Specify the sparsity pattern and reinit matrices and vectors based on
       /// the dofs and constraints.
       void initialize_system() override;
 
+      /// The mass Schur complement preconditions the pressure block.
+      bool needs_mass_matrices() const override { return true; }
+
       /*! \brief Assemble the system matrix, mass mass matrix, and the RHS.
        *
        *  Since backward Euler method is used, the linear system must be
@@ -114,9 +134,11 @@ namespace Fluid
        *
        *  After solving the linear system, the same AffineConstraints<double> as
        * used in assembly must be used again, to set the solution to the right
-       * value at the constrained dofs.
+       * value at the constrained dofs. The residual is reduced by the
+       * relative tolerance.
        */
-      std::pair<unsigned int, double> solve(const bool use_nonzero_constraints);
+      std::pair<unsigned int, double> solve(const bool use_nonzero_constraints,
+                                            const double relative_tolerance);
 
       /*! \brief Run the simulation for one time step.
        *
@@ -139,9 +161,30 @@ namespace Fluid
        */
       PETScWrappers::MPI::BlockVector evaluation_point;
 
+      /// The ghost update of the evaluation point, which is finished in the
+      /// middle of the next assembly.
+      Utils::GhostUpdate evaluation_point_update;
+
       /// The BlockSchurPreconditioner for the entire system.
       std::shared_ptr<BlockSchurPreconditioner> preconditioner;
 
+      /**
+       * The direct solver of the velocity block, kept between preconditioners
+       * if requested. PETSc only redoes the numeric factorization when the
+       * matrix values change but its sparsity pattern does not, so it must be
+       * reset whenever the system is reinitialized.
+       */
+      SolverControl direct_solver_control;
+      std::shared_ptr<PETScWrappers::SparseDirectMUMPS> direct_solver;
+
+      /// The solver of the velocity block, chosen again after refinement if
+      /// it is Auto.
+      SolverPolicy velocity_solver;
+
+      /// The matrix-free solver of the velocity block, only allocated if it
+      /// is selected in the parameters.
+      std::shared_ptr<MatrixFreeVelocitySolver<dim>> matrix_free_solver;
+
       /** \brief Block preconditioner for the system
        *
        * A right block preconditioner is defined here:
@@ -154,7 +197,9 @@ namespace Fluid
        * \f$\tilde{A}\f$ is unsymmetric thanks to the convection term.
        * We do not have a nice way to deal with other than using a direct
        * solver. (Geometric multigrid is the right way to go if only you are
-       * brave enough to implement it.)
+       * brave enough to implement it.) For large problems, algebraic
+       * multigrid can be used instead, either as a single V-cycle or as the
+       * preconditioner of an inner GMRES solve.
        *
        * \f$\tilde{S}^{-1}\f$ is the inverse of the total Schur complement,
        * which consists of a reaction term, a diffusion term, a Grad-Div term
@@ -190,7 +235,11 @@ namespace Fluid
           const std::vector<IndexSet> &owned_partitioning,
           const PETScWrappers::MPI::BlockSparseMatrix &system,
           const PETScWrappers::MPI::BlockSparseMatrix &mass,
-          PETScWrappers::MPI::BlockSparseMatrix &schur);
+          PETScWrappers::MPI::BlockSparseMatrix &schur,
+          const std::string &A_solver = "MUMPS",
+          PETScWrappers::SparseDirectMUMPS *shared_A_inverse = nullptr,
+          const MatrixFreeVelocitySolver<dim> *matrix_free_A = nullptr,
+          const bool pipelined = false);
 
         /// The matrix-vector multiplication must be defined.
         void vmult(PETScWrappers::MPI::BlockVector &dst,
@@ -202,6 +251,8 @@ namespace Fluid
         const double viscosity;
         const double rho;
         const double dt;
+        /// Use the pipelined CG and GMRES of PETSc for the inner solves.
+        const bool pipelined;
 
         /// dealii smart pointer checks if an object is still being referenced
         /// when it is destructed therefore is safer than plain reference.
@@ -230,6 +281,29 @@ namespace Fluid
          * reset and the matrix does not change.
          */
         mutable PETScWrappers::SparseDirectMUMPS A_inverse;
+
+        /// How \f$\tilde{A}^{-1}\f$ is applied: MUMPS, AMG, AMG-GMRES or
+        /// MatrixFree.
+        const std::string A_solver;
+        /**
+         * BoomerAMG of \f$\tilde{A}\f$, used as an inexact inverse or as
+         * the preconditioner of GMRES when MUMPS is not used. This is fine
+         * because the outer solver is a flexible GMRES.
+         */
+        PETScWrappers::PreconditionBoomerAMG A_amg;
+
+        /// The direct solver actually used, either A_inverse or one that
+        /// is owned by the fluid solver and outlives this preconditioner.
+        PETScWrappers::SparseDirectMUMPS *const A_direct;
+
+        /// Matrix-free multigrid solver of \f$\tilde{A}\f$, owned by the
+        /// fluid solver.
+        const MatrixFreeVelocitySolver<dim> *const A_matrix_free;
+
+        /// Jacobi of \f$M_p\f$ and BoomerAMG of \f$S_m\f$ for the CG
+        /// solves of \f$\tilde{S}^{-1}\f$.
+        PETScWrappers::PreconditionJacobi Mp_preconditioner;
+        PETScWrappers::PreconditionBoomerAMG Sm_preconditioner;
       };
     };
   } // namespace MPI
@@ -45,11 +45,13 @@ namespace Fluid
     private:
       class BlockSchurPreconditioner;
 
+      using FluidSolver<dim>::print_memory_report;
       using FluidSolver<dim>::setup_dofs;
       using FluidSolver<dim>::make_constraints;
       using FluidSolver<dim>::setup_cell_property;
       using FluidSolver<dim>::initialize_system;
       using FluidSolver<dim>::refine_mesh;
+      using FluidSolver<dim>::predict_solution_change;
       using FluidSolver<dim>::output_results;
       using FluidSolver<dim>::update_stress;
       using FluidSolver<dim>::save_checkpoint;
@@ -65,11 +67,11 @@ namespace Fluid
       using FluidSolver<dim>::face_quad_formula;
       using FluidSolver<dim>::zero_constraints;
       using FluidSolver<dim>::nonzero_constraints;
-      using FluidSolver<dim>::sparsity_pattern;
       using FluidSolver<dim>::system_matrix;
       using FluidSolver<dim>::mass_matrix;
       using FluidSolver<dim>::mass_schur;
       using FluidSolver<dim>::present_solution;
+      using FluidSolver<dim>::assembly_present_solution;
       using FluidSolver<dim>::system_rhs;
       using FluidSolver<dim>::parameters;
       using FluidSolver<dim>::mpi_communicator;
@@ -81,15 +83,20 @@ namespace Fluid
       using FluidSolver<dim>::locally_relevant_scalar_dofs;
       using FluidSolver<dim>::times_and_names;
       using FluidSolver<dim>::time;
+      using FluidSolver<dim>::probes;
       using FluidSolver<dim>::timer;
       using FluidSolver<dim>::timer2;
       using FluidSolver<dim>::cell_property;
       using FluidSolver<dim>::boundary_values;
+      using FluidSolver<dim>::linear_iterations;
 
       /// Specify the sparsity pattern and reinit matrices and vectors based on
       /// the dofs and constraints.
       void initialize_system() override;
 
+      /// The mass Schur complement preconditions the pressure block.
+      bool needs_mass_matrices() const override { return true; }
+
       /*! \brief Assemble the system matrix, mass mass matrix, and the RHS.
        *
        * It can be used to assemble the entire system or only the RHS.
@@ -119,6 +126,10 @@ namespace Fluid
       /// The BlockSchurPreconditioner for the entire system.
       std::shared_ptr<BlockSchurPreconditioner> preconditioner;
 
+      /// The time step that the matrices and the preconditioner were built
+      /// with.
+      double assembled_delta_t;
+
       /** \brief Block preconditioner for the system
        *
        * A right block preconditioner is defined here:
@@ -168,6 +179,7 @@ namespace Fluid
           PETScWrappers::MPI::BlockSparseMatrix &schur);
 
         /// The matrix-vector multiplication must be defined.
+        /// The inner CG solvers keep their PETSc KSP objects between calls.
         void vmult(PETScWrappers::MPI::BlockVector &dst,
                    const PETScWrappers::MPI::BlockVector &src) const;
 
@@ -196,6 +208,18 @@ namespace Fluid
          * go with this route.
          */
         const SmartPointer<PETScWrappers::MPI::BlockSparseMatrix> mass_schur;
+
+        /// The inner solvers of \f$M_p\f$, \f$S_m\f$ and \f$\tilde{A}\f$.
+        /// Their tolerances are set at every vmult.
+        mutable SolverControl mp_control;
+        mutable SolverControl sm_control;
+        mutable SolverControl a_control;
+        PETScWrappers::PreconditionJacobi Mp_preconditioner;
+        PETScWrappers::PreconditionBoomerAMG Sm_preconditioner;
+        PETScWrappers::PreconditionNone A_preconditioner;
+        mutable PETScWrappers::SolverCG cg_mp;
+        mutable PETScWrappers::SolverCG cg_sm;
+        mutable PETScWrappers::SolverCG cg_a;
       };
     };
   } // namespace MPI
@@ -73,6 +73,10 @@ namespace Solid
       using SolidSolver<dim>::timer;
       using SolidSolver<dim>::locally_owned_dofs;
       using SolidSolver<dim>::locally_relevant_dofs;
+      using SolidSolver<dim>::cell_property;
+      using SolidSolver<dim>::print_memory_report;
+
+      void initialize_system() override;
 
       /**
        * Assembles lhs and rhs. At time step 0, the lhs is the mass matrix;
@@ -3,6 +3,8 @@
 
 #include "mpi_fluid_solver.h"
 #include "preconditioner_pilut.h"
+#include "solver_pipelined.h"
+#include "solver_policy.h"
 
 namespace Fluid
 {
@@ -54,10 +56,13 @@ namespace Fluid
     private:
       class BlockIncompSchurPreconditioner;
 
+      using FluidSolver<dim>::print_memory_report;
       using FluidSolver<dim>::setup_dofs;
       using FluidSolver<dim>::make_constraints;
       using FluidSolver<dim>::setup_cell_property;
+      using FluidSolver<dim>::system_layout_changed;
       using FluidSolver<dim>::refine_mesh;
+      using FluidSolver<dim>::predict_solution_change;
       using FluidSolver<dim>::output_results;
       using FluidSolver<dim>::save_checkpoint;
       using FluidSolver<dim>::load_checkpoint;
@@ -73,11 +78,13 @@ namespace Fluid
       using FluidSolver<dim>::face_quad_formula;
       using FluidSolver<dim>::zero_constraints;
       using FluidSolver<dim>::nonzero_constraints;
-      using FluidSolver<dim>::sparsity_pattern;
       using FluidSolver<dim>::system_matrix;
       using FluidSolver<dim>::present_solution;
       using FluidSolver<dim>::solution_increment;
       using FluidSolver<dim>::system_rhs;
+      using FluidSolver<dim>::workspace;
+      using FluidSolver<dim>::assembly_evaluation_point;
+      using FluidSolver<dim>::assembly_present_solution;
       using FluidSolver<dim>::stress;
       using FluidSolver<dim>::parameters;
       using FluidSolver<dim>::mpi_communicator;
@@ -89,15 +96,23 @@ namespace Fluid
       using FluidSolver<dim>::locally_relevant_scalar_dofs;
       using FluidSolver<dim>::times_and_names;
       using FluidSolver<dim>::time;
+      using FluidSolver<dim>::probes;
       using FluidSolver<dim>::timer;
       using FluidSolver<dim>::timer2;
       using FluidSolver<dim>::cell_property;
       using FluidSolver<dim>::boundary_values;
+      using FluidSolver<dim>::linear_iterations;
+      using FluidSolver<dim>::newton_iterations;
+      using FluidSolver<dim>::adapt_time_step;
 
       /// Specify the sparsity pattern and reinit matrices and vectors based on
       /// the dofs and constraints.
       virtual void initialize_system() override;
 
+      /// Add the preconditioner matrices, the Newton vectors and the cached
+      /// coefficients to the memory report.
+      void add_memory(Utils::MemoryReport &) const override;
+
       /*! \brief Assemble the system matrix, mass mass matrix, and the RHS.
        *
        *  Since backward Euler method is used, the linear system must be
@@ -108,17 +123,67 @@ namespace Fluid
        * rhs, which is optimal according to the deal.II documentation. The
        * boolean argument is used to determine whether nonzero constraints or
        * zero constraints should be used.
+       *
+       *  The viscous, pressure gradient and mass terms do not depend on the
+       * Newton iterate. They are assembled into constant_matrix at the first
+       * iteration of every time step and added to the system matrix in the
+       * following iterations.
        */
       void assemble(const bool use_nonzero_constraints);
 
       /*! \brief Solve the linear system using FGMRES solver plus block
        * preconditioner.
        *
+       *  The preconditioner is kept between the solves and only rebuilt when
+       * the previous solve needed more iterations than specified in the
+       * parameters, or when the system has been reinitialized.
+       *
        *  After solving the linear system, the same AffineConstraints<double> as
        * used in assembly must be used again, to set the solution to the right
        * value at the constrained dofs.
+       *
+       *  If Krylov recycling is enabled, the system is deflated with the
+       * corrections of the previous solves, see solve_recycled.
+       *
+       *  The residual is reduced by the relative tolerance, which also sets
+       * the tolerance of the inner Tpp solve.
+       */
+      std::pair<unsigned int, double> solve(const bool use_nonzero_constraints,
+                                            const double relative_tolerance);
+
+      /*! \brief Solve the linear system with a recycled space (GCRO).
+       *
+       *  With U the recycled directions and C = A U orthonormal, the initial
+       * guess x0 = U C^T b removes the part of the residual in the range of C,
+       * and FGMRES solves the deflated system (I - C C^T) A e = r0 for the
+       * rest. The solution is x = x0 + e - U C^T A e, whose residual is the one
+       * of the deflated system. The correction x - x0 replaces the oldest
+       * recycled direction afterwards.
        */
-      std::pair<unsigned int, double> solve(const bool use_nonzero_constraints);
+      void solve_recycled(SolverControl &);
+
+      /// Orthonormalize C = A U with the current system matrix by modified
+      /// Gram-Schmidt, and drop the directions that are linearly dependent.
+      void update_recycling_space();
+
+      /// Switch to the next tuning candidate of the B2pp preconditioner, if
+      /// any is left. Called at the start of every time step, except for
+      /// the first one, which warms up the solver and is not timed.
+      void start_tuning_step();
+
+      /// Record the Tpp solve time of the current tuning candidate per
+      /// application of the preconditioner, i.e. per outer iteration of the
+      /// time step, and keep the fastest one once all of them have been
+      /// tried.
+      void finish_tuning_step(const unsigned int);
+
+      /// Set the fill levels (Euclid) or the drop tolerance (Pilut) of a
+      /// tuning candidate.
+      void apply_tuning_candidate(const unsigned int);
+
+      /// The wall time of all the Tpp solves so far, the maximum over the
+      /// processes.
+      double tpp_wall_time() const;
 
       /*! \brief Run the simulation for one time step.
        *
@@ -132,6 +197,10 @@ namespace Fluid
       void run_one_step(bool apply_nonzero_constraints,
                         bool assemble_system = true) override;
 
+      /// The PML damping makes a cell more expensive to assemble.
+      virtual double cell_cost(
+        const typename DoFHandler<dim>::active_cell_iterator &) const override;
+
       /*! \brief Apply the initial condition
        *
        * This is a hard-coded function that is only used for VF cases where an
@@ -140,6 +209,24 @@ namespace Fluid
        */
       void apply_initial_condition();
 
+      /*! \brief Evaluate the PML field and the body force at the quadrature
+       *  points of all the locally owned cells.
+       *
+       *  The PML field does not depend on time and is only evaluated again
+       *  when the mesh changes. The body force is evaluated again in
+       *  assemble() whenever its time has been changed. Both are evaluated
+       *  with a single value_list call over the whole subdomain, which is
+       *  the batched interface for user functions.
+       */
+      void setup_coefficients();
+
+      /// The part of the system matrix that is constant in a time step,
+      /// assembled with zero constraints.
+      PETScWrappers::MPI::BlockSparseMatrix constant_matrix;
+
+      /// The time step that constant_matrix was assembled at.
+      unsigned int constant_matrix_timestep;
+
       PETScWrappers::MPI::SparseMatrix Abs_A_matrix;
       PETScWrappers::MPI::SparseMatrix schur_matrix;
       PETScWrappers::MPI::SparseMatrix B2pp_matrix;
@@ -152,9 +239,73 @@ namespace Fluid
        */
       PETScWrappers::MPI::BlockVector evaluation_point;
 
+      /// The ghost update of the evaluation point, which is finished in the
+      /// middle of the next assembly.
+      Utils::GhostUpdate evaluation_point_update;
+
       /// The BlockIncompSchurPreconditioner for the entire system.
       std::shared_ptr<BlockIncompSchurPreconditioner> preconditioner;
 
+      /// The recycled directions U and their images C = A U, kept between
+      /// the linear solves until the system is reinitialized.
+      std::vector<PETScWrappers::MPI::BlockVector> recycle_U;
+      std::vector<PETScWrappers::MPI::BlockVector> recycle_C;
+
+      /// The memory pool of the linear solver, kept between the solves.
+      GrowingVectorMemory<PETScWrappers::MPI::BlockVector> vector_memory;
+
+      /*! \brief The system matrix projected onto the orthogonal complement
+       *  of the recycled space, (I - C C^T) A.
+       */
+      class DeflatedOperator
+      {
+      public:
+        DeflatedOperator(
+          const PETScWrappers::MPI::BlockSparseMatrix &system,
+          const std::vector<PETScWrappers::MPI::BlockVector> &C)
+          : system_matrix(system), C(C)
+        {
+        }
+
+        void vmult(PETScWrappers::MPI::BlockVector &dst,
+                   const PETScWrappers::MPI::BlockVector &src) const
+        {
+          system_matrix.vmult(dst, src);
+          for (const auto &c : C)
+            {
+              dst.add(-(c * dst), c);
+            }
+        }
+
+      private:
+        const PETScWrappers::MPI::BlockSparseMatrix &system_matrix;
+        const std::vector<PETScWrappers::MPI::BlockVector> &C;
+      };
+
+      /// Whether the preconditioner must be rebuilt before the next solve,
+      /// set when the last solve exceeded the rebuild thresholds.
+      bool rebuild_preconditioner;
+
+      /// Number of preconditioner builds and reuses in the current time step.
+      unsigned int n_preconditioner_builds;
+      unsigned int n_preconditioner_reuses;
+
+      /// The settings of the ILU preconditioners of B2pp.
+      PreconditionEuclid::AdditionalData euclid_data;
+      PreconditionPilut::AdditionalData pilut_data;
+
+      /// The preconditioner of the Tpp solves, chosen again after refinement
+      /// if it is Auto.
+      SolverPolicy pressure_pc;
+
+      /// The number of tuning candidates (0 without tuning), the Tpp solve
+      /// times of the tried ones, the Tpp wall time when the current one
+      /// started, and whether the untimed first step is still running.
+      const unsigned int n_tuning_candidates;
+      std::vector<double> tuning_times;
+      double tuning_start_time;
+      bool tuning_warm_up;
+
       /** \brief sigma_pml_field
        * the sigma_pml_field is predefined outside the class. It specifies
        * the sigma PML field to determine where and how sigma pml is
@@ -166,6 +317,18 @@ namespace Fluid
       /// Hard-coded body force. It will be added onto gravity.
       std::shared_ptr<TensorFunction<1, dim>> body_force;
 
+      /// The quadrature points of the locally owned cells, one cell after
+      /// another, and the offset of each cell by its active cell index.
+      std::vector<Point<dim>> coefficient_points;
+      std::vector<unsigned int> coefficient_offsets;
+
+      /// The PML field and the body force at the coefficient points.
+      std::vector<double> sigma_pml_values;
+      std::vector<Tensor<1, dim>> body_force_values;
+
+      /// The time of the body force when it was last evaluated.
+      double body_force_time;
+
       /** \brief Incomplete Schur Complement Block Preconditioner
        * The format of this preconditioner is as follow:
        *
@@ -177,11 +340,15 @@ namespace Fluid
        * The evaluation for Tpp is in SchurComplementTpp class,
        * and its inverse is solved by performing some GMRES iterations
        * By using B2pp = ILU(0) of (App - Apv*(rowsum|Avv|)^-1*Avp
-       * as preconditioner.
+       * as preconditioner. Alternatively, one BoomerAMG V-cycle of that matrix
+       * can be used instead of ILU(0).
        * This preconditioner is proposed in:
        * T. Washio et al., A robust preconditioner for fluid–structure
        * interaction problems, Comput. Methods Appl. Mech. Engrg.
        * 194 (2005) 4027–4047
+       *
+       * The build and every application work in the (at least three)
+       * non-ghosted buffers of the workspace, which the solver owns.
        */
       class BlockIncompSchurPreconditioner : public Subscriptor
       {
@@ -193,7 +360,15 @@ namespace Fluid
           const PETScWrappers::MPI::BlockSparseMatrix &system,
           PETScWrappers::MPI::SparseMatrix &absA,
           PETScWrappers::MPI::SparseMatrix &schur,
-          PETScWrappers::MPI::SparseMatrix &B2pp);
+          PETScWrappers::MPI::SparseMatrix &B2pp,
+          std::vector<PETScWrappers::MPI::BlockVector> &workspace,
+          const std::string &B2pp_type = "Euclid",
+          const PreconditionEuclid::AdditionalData &euclid_data =
+            PreconditionEuclid::AdditionalData(),
+          const PreconditionPilut::AdditionalData &pilut_data =
+            PreconditionPilut::AdditionalData(),
+          const bool pipelined = false,
+          const std::string &Tpp_type = "Exact");
 
         /// The matrix-vector multiplication must be defined.
         void vmult(PETScWrappers::MPI::BlockVector &dst,
@@ -218,6 +393,11 @@ namespace Fluid
         }
         int get_Tpp_itr_count() const { return Tpp_itr; }
         void Erase_Tpp_count() { Tpp_itr = 0; }
+        /// The relative tolerance of the Tpp solve, 1e-3 by default.
+        void set_Tpp_tolerance(const double tolerance)
+        {
+          Tpp_tolerance = tolerance;
+        }
 
       private:
         class SchurComplementTpp;
@@ -233,12 +413,25 @@ namespace Fluid
         const SmartPointer<PETScWrappers::MPI::SparseMatrix> schur_matrix;
         const SmartPointer<PETScWrappers::MPI::SparseMatrix> B2pp_matrix;
 
+        std::vector<PETScWrappers::MPI::BlockVector> &workspace;
+
         PreconditionEuclid Pvv_inverse;
-        PreconditionEuclid B2pp_inverse;
+        /// PreconditionEuclid, PreconditionPilut or
+        /// PETScWrappers::PreconditionBoomerAMG.
+        std::shared_ptr<PETScWrappers::PreconditionerBase> B2pp_inverse;
 
         std::shared_ptr<SchurComplementTpp> Tpp;
+        /// Tpp as a PETSc matrix for the pipelined GMRES of PETSc, which
+        /// solves Tpp instead of the GMRES of deal.II if it is not null.
+        std::shared_ptr<ShellMatrix<SchurComplementTpp>> Tpp_shell;
+        /// The assembled approximation App - Apv*diag(Avv)^(-1)*Avp, which
+        /// replaces Tpp in the inner solve if it is not null.
+        std::shared_ptr<PETScWrappers::MPI::SparseMatrix> Tpp_matrix;
+        /// Solve Tpp with the pipelined GMRES of PETSc.
+        const bool pipelined;
         // iteration counter for solving Tpp
         mutable int Tpp_itr;
+        double Tpp_tolerance;
         class SchurComplementTpp : public Subscriptor
         {
         public:
@@ -255,7 +448,8 @@ namespace Fluid
           const SmartPointer<const PETScWrappers::MPI::BlockSparseMatrix>
             system_matrix;
           const PETScWrappers::PreconditionerBase *Pvv_inverse;
-          PETScWrappers::MPI::BlockVector dumb_vector;
+          /// The buffers of vmult, Tpp is applied in every inner iteration.
+          mutable PETScWrappers::MPI::BlockVector buffer1, buffer2;
         };
       };
     };
@@ -18,51 +18,84 @@ namespace Internal
 
   /** \brief Data to store at the quadrature points.
    *
-   * We cache the kinematics information at quadrature points
-   * by storing a PointHistory at each cell,
-   * so that they can be conveniently accessed in the assembly
-   * or post processing. We also store a material pointer
-   * in case different material properties are used at
-   * different locations.
+   * We cache the kinematics information at the quadrature points of all the
+   * cells of this subdomain, so that they can be conveniently accessed in
+   * the assembly or post processing. Every state variable is stored in one
+   * contiguous array, indexed by the cell and the quadrature point, which
+   * the assembly runs through in order. The materials only hold the
+   * parameters and are shared by all the cells with the same material id.
    */
   template <int dim>
-  class PointHistory
+  class QuadraturePointHistory
   {
-    using ST = Physics::Elasticity::StandardTensors<dim>;
-
   public:
-    PointHistory()
-      : F_inv(ST::I),
-        tau(SymmetricTensor<2, dim>()),
-        Jc(SymmetricTensor<4, dim>()),
-        dPsi_vol_dJ(0.0),
-        d2Psi_vol_dJ2(0.0)
-    {
-    }
-    virtual ~PointHistory() {}
-    /** Initialize the members with the input parameters */
-    void setup(const Parameters::AllParameters &, const unsigned int &);
+    using cell_iterator = typename Triangulation<dim>::cell_iterator;
+
     /**
-     * Update the state with the displacement gradient
-     * in the reference configuration.
+     * Allocate the quadrature points of the cells in the given subdomain and
+     * set them to the undeformed state.
      */
-    void update(const Parameters::AllParameters &, const Tensor<2, dim> &);
-    double get_det_F() const { return material->get_det_F(); }
-    const Tensor<2, dim> &get_F_inv() const { return F_inv; }
-    const SymmetricTensor<2, dim> &get_tau() const { return tau; }
-    const SymmetricTensor<4, dim> &get_Jc() const { return Jc; }
-    double get_density() const { return material->get_density(); }
-    double get_dPsi_vol_dJ() const { return dPsi_vol_dJ; }
-    double get_d2Psi_vol_dJ2() const { return d2Psi_vol_dJ2; }
+    void setup(const Parameters::AllParameters &,
+               const Triangulation<dim> &,
+               const types::subdomain_id,
+               const unsigned int n_q_points);
+    /**
+     * Update the state of all the quadrature points of a cell with the
+     * displacement gradients in the reference configuration, using the
+     * batched kernel of the material.
+     */
+    void update(const cell_iterator &, const std::vector<Tensor<2, dim>> &);
+    double get_det_F(const cell_iterator &cell, const unsigned int q) const
+    {
+      return det_F[index(cell, q)];
+    }
+    const Tensor<2, dim> &get_F_inv(const cell_iterator &cell,
+                                    const unsigned int q) const
+    {
+      return F_inv[index(cell, q)];
+    }
+    const SymmetricTensor<2, dim> &get_tau(const cell_iterator &cell,
+                                           const unsigned int q) const
+    {
+      return tau[index(cell, q)];
+    }
+    const SymmetricTensor<4, dim> &get_Jc(const cell_iterator &cell,
+                                          const unsigned int q) const
+    {
+      return Jc[index(cell, q)];
+    }
+    double get_density(const cell_iterator &cell) const
+    {
+      return materials[cell_materials[cell->active_cell_index()]]
+        ->get_density();
+    }
+    /// The memory of the state arrays and the offsets in bytes.
+    std::size_t memory_consumption() const;
 
   private:
-    /** The specific hyperelastic material to use. */
-    std::shared_ptr<Solid::HyperElasticMaterial<dim>> material;
-    Tensor<2, dim> F_inv;
-    SymmetricTensor<2, dim> tau;
-    SymmetricTensor<4, dim> Jc;
-    double dPsi_vol_dJ;
-    double d2Psi_vol_dJ2;
+    /// The position of a quadrature point in the arrays.
+    unsigned int index(const cell_iterator &cell, const unsigned int q) const
+    {
+      Assert(offsets[cell->active_cell_index()] !=
+               numbers::invalid_unsigned_int,
+             ExcMessage("The cell is not in this subdomain!"));
+      return offsets[cell->active_cell_index()] + q;
+    }
+
+    unsigned int n_q_points;
+    /// The first quadrature point of every active cell, invalid for the
+    /// cells in other subdomains.
+    std::vector<unsigned int> offsets;
+    /// The material of every active cell.
+    std::vector<unsigned int> cell_materials;
+    /// One material for every material id, holding its parameters.
+    std::vector<std::shared_ptr<Solid::HyperElasticMaterial<dim>>> materials;
+    std::vector<Tensor<2, dim>> F_inv;
+    std::vector<SymmetricTensor<2, dim>> tau;
+    std::vector<SymmetricTensor<4, dim>> Jc;
+    std::vector<double> det_F;
+    /// Deformation gradients of one cell, to feed the material kernel.
+    std::vector<Tensor<2, dim>> F_buffer;
   };
 } // namespace Internal
 
@@ -80,10 +113,9 @@ namespace Solid
 
     /** \brief Parallel solver for hyperelastic materials
      *
-     * The solver sets up a PointHistory object at every quadrature point,
-     * where the material properties, deformation, and even stress state
-     * are cached. Therefore the PointHistory has to be updated whenever
-     * the deformation changes.
+     * The solver sets up a QuadraturePointHistory, where the deformation and
+     * even stress state at every quadrature point are cached. Therefore it
+     * has to be updated whenever the deformation changes.
      *
      * Based on dealii tutorial [step-44]
      * (http://www.dealii.org/8.5.0/doxygen/deal.II/step_44.html)
@@ -93,7 +125,8 @@ namespace Solid
     {
     public:
       SharedHyperElasticity(Triangulation<dim> &,
-                            const Parameters::AllParameters &);
+                            const Parameters::AllParameters &,
+                            MPI_Comm communicator = MPI_COMM_WORLD);
       ~SharedHyperElasticity() {}
 
     private:
@@ -128,14 +161,37 @@ namespace Solid
       using SharedSolidSolver<dim>::locally_relevant_dofs;
       using SharedSolidSolver<dim>::times_and_names;
       using SharedSolidSolver<dim>::cell_property;
+      using SharedSolidSolver<dim>::print_memory_report;
 
       void initialize_system() override;
 
+      void add_memory(Utils::MemoryReport &) const override;
+
+      /**
+       * The quadrature point history is not stored in the checkpoint, it is
+       * computed again from the loaded displacement.
+       */
+      virtual bool load_checkpoint() override;
+
+      /// The quadrature point history of the new subdomain is computed from
+      /// the moved displacement.
+      virtual void
+      repartition(const std::vector<types::subdomain_id> &) override;
+
       virtual void update_strain_and_stress() override;
 
       /** Assemble the lhs and rhs at the same time. */
       void assemble_system(bool);
 
+      /** Assemble the rhs only, the tangent matrix is kept. */
+      void assemble_residual();
+
+      /**
+       * Assemble the mass matrix (initial step) or the tangent matrix if
+       * required, and the rhs.
+       */
+      void assemble(const bool initial_step, const bool assemble_matrix);
+
       /** Set up the quadrature point history. */
       void setup_qph();
 
@@ -151,13 +207,10 @@ namespace Solid
       void run_one_step(bool);
 
       /**
-       * We store a PointHistory structure at every quadrature point,
-       * so that kinematics information like F as well as material properties
-       * can be cached.
+       * The kinematics information like F as well as the stress at every
+       * quadrature point.
        */
-      CellDataStorage<typename Triangulation<dim>::cell_iterator,
-                      Internal::PointHistory<dim>>
-        quad_point_history;
+      Internal::QuadraturePointHistory<dim> quad_point_history;
 
       double error_residual; //!< Norm of the residual at a Newton iteration.
       double initial_error_residual; //!< Norm of the residual at the first
@@ -169,6 +222,23 @@ namespace Solid
                                    //! first iteration.
       double normalized_error_update; //!< error_update / initial_error_update
 
+      /// Whether system_matrix holds a tangent that a modified Newton
+      /// iteration can reuse.
+      bool tangent_valid;
+      /// The time step size the tangent was assembled with.
+      double tangent_dt;
+
+      /// Buffers of the Newton loop, only reinitialized with the system so
+      /// that the iterations do not allocate vectors.
+      PETScWrappers::MPI::Vector predicted_displacement;
+      PETScWrappers::MPI::Vector newton_update;
+      PETScWrappers::MPI::Vector newton_buffer;
+      PETScWrappers::MPI::Vector previous_rhs;
+      mutable PETScWrappers::MPI::Vector error_buffer;
+      /// The ghosted displacement that the quadrature point history is
+      /// updated from.
+      PETScWrappers::MPI::Vector ghosted_displacement;
+
       // Reture the residual in the Newton iteration
       void get_error_residual(double &);
       // Compute the l2 norm of the solution increment
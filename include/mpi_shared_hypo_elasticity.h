@@ -32,7 +32,8 @@ namespace Solid
       SharedHypoElasticity(Triangulation<dim> &,
                            const Parameters::AllParameters &,
                            double dx,
-                           double hdx);
+                           double hdx,
+                           MPI_Comm communicator = MPI_COMM_WORLD);
       ~SharedHypoElasticity() {}
 
     private:
@@ -67,9 +68,13 @@ namespace Solid
       using SharedSolidSolver<dim>::locally_relevant_dofs;
       using SharedSolidSolver<dim>::times_and_names;
       using SharedSolidSolver<dim>::cell_property;
+      using SharedSolidSolver<dim>::print_memory_report;
 
       void initialize_system() override;
 
+      /// The serialized vectors hold every dof on every process.
+      void add_memory(Utils::MemoryReport &) const override;
+
       virtual void update_strain_and_stress() override;
 
       /** Assemble the lhs and rhs at the same time. */
@@ -78,6 +83,9 @@ namespace Solid
       /// Run one time step.
       void run_one_step(bool);
 
+      /// The particles on rank 0 carry the state.
+      bool state_in_vectors() const override { return false; }
+
       virtual void save_checkpoint(const int) override;
 
       virtual bool load_checkpoint() override;
@@ -86,10 +94,49 @@ namespace Solid
 
       std::vector<int> vertex_mapping;
 
+      /// The dofs of the vertex of every vertex particle, the one of
+      /// component n of particle i at i * dim + n.
+      std::vector<types::global_dof_index> particle_dofs;
+
+      /**
+       * The displacement, velocity and acceleration of the vertex particles
+       * in contiguous arrays with the layout of particle_dofs, so that the
+       * copy into the serialized vectors runs over plain arrays instead of
+       * dereferencing a particle per vertex and component.
+       */
+      struct ParticleArrays
+      {
+        std::vector<double> displacement;
+        std::vector<double> velocity;
+        std::vector<double> acceleration;
+      } particle_arrays;
+
       void construct_particles();
 
+      /// Fill particle_dofs from the vertex of every particle, whenever the
+      /// dofs are numbered.
+      void setup_particle_dofs();
+
+      /// The particles stay, only the dofs of their vertices change.
+      void repartition(
+        const std::vector<types::subdomain_id> &subdomains) override;
+
+      /// Gather the state of the vertex particles into particle_arrays, in
+      /// one pass over the particles.
+      void gather_particles();
+
+      /// Copy the particle state into the serialized vectors, and the
+      /// traction into the particles. Rank 0 only.
       void synchronize();
 
+      /**
+       * Send the entries of the serialized vectors that have changed since
+       * the last call to the processes owning them, and store them in the
+       * current solution. Rank 0 holds the changed entries, every other
+       * process only receives its own.
+       */
+      void distribute_solution();
+
       double dx;
 
       double hdx;
@@ -99,6 +146,10 @@ namespace Solid
       Vector<double> serialized_velocity;
 
       Vector<double> serialized_acceleration;
+
+      /// The dofs whose serialized values have changed since the last
+      /// distribute_solution.
+      std::vector<types::global_dof_index> changed_dofs;
     };
   } // namespace MPI
 } // namespace Solid
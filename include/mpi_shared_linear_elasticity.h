@@ -32,6 +32,9 @@ namespace Solid
      * Algorithm-wise, this class is not different from the serial version,
      * Newmark-beta method is used for time-discretization and
      * displacement-based finite element is used for space-discretization.
+     * With explicit time integration, \f$\beta = 0\f$ and the mass matrix is
+     * lumped, so that a time step only scales the residual by the inverse
+     * of the diagonal mass.
      */
     template <int dim>
     class SharedLinearElasticity : public SharedSolidSolver<dim>
@@ -44,7 +47,8 @@ namespace Solid
        * Also we use a parameter handler to specify all the input parameters.
        */
       SharedLinearElasticity(Triangulation<dim> &,
-                             const Parameters::AllParameters &);
+                             const Parameters::AllParameters &,
+                             MPI_Comm communicator = MPI_COMM_WORLD);
       /*! \brief Destructor. */
       ~SharedLinearElasticity() {}
 
@@ -80,13 +84,25 @@ namespace Solid
       using SharedSolidSolver<dim>::locally_relevant_dofs;
       using SharedSolidSolver<dim>::times_and_names;
       using SharedSolidSolver<dim>::cell_property;
+      using SharedSolidSolver<dim>::print_memory_report;
+
+      void initialize_system() override;
 
       /**
        * Assembles lhs and rhs. At time step 0, the lhs is the mass matrix;
        * at all the following steps, it is \f$ M + \beta{\Delta{t}}^2K \f$.
+       * The explicit scheme also assembles the lumped mass and checks the
+       * time step against the stability limit.
        */
       void assemble_system(bool is_initial);
 
+      /**
+       * The largest stable time step of the explicit scheme,
+       * \f$ \sqrt{2/\gamma}/\omega_{max} \f$, with the Gershgorin bound of
+       * the largest eigenvalue \f$ \omega_{max}^2 \f$ of \f$ M_L^{-1}K \f$.
+       */
+      double stable_time_step() const;
+
       /**
        * Update the strain and stress, used in output_results and FSI.
        */
@@ -95,6 +111,13 @@ namespace Solid
       void run_one_step(bool first_step);
 
       std::vector<LinearElasticMaterial<dim>> material;
+
+      /// The time step that the system matrix was assembled with.
+      double assembled_delta_t;
+
+      /// The inverse of the row-sum lumped mass matrix, 0 on the constrained
+      /// dofs. Only assembled by the explicit scheme.
+      PETScWrappers::MPI::Vector lumped_mass_inverse;
     };
   } // namespace MPI
 } // namespace Solid
@@ -4,11 +4,15 @@
 #include <deal.II/base/conditional_ostream.h>
 #include <deal.II/base/function.h>
 #include <deal.II/base/index_set.h>
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/multithread_info.h>
 #include <deal.II/base/quadrature_lib.h>
 #include <deal.II/base/quadrature_point_data.h>
 #include <deal.II/base/tensor.h>
 #include <deal.II/base/timer.h>
 #include <deal.II/base/utilities.h>
+#include <deal.II/base/work_stream.h>
 
 #include <deal.II/dofs/dof_accessor.h>
 #include <deal.II/dofs/dof_handler.h>
@@ -22,10 +26,12 @@
 #include <deal.II/fe/fe_tools.h>
 #include <deal.II/fe/fe_values.h>
 
+#include <deal.II/grid/filtered_iterator.h>
 #include <deal.II/grid/grid_generator.h>
 #include <deal.II/grid/grid_in.h>
 #include <deal.II/grid/grid_out.h>
 #include <deal.II/grid/grid_refinement.h>
+#include <deal.II/grid/grid_tools.h>
 #include <deal.II/grid/tria.h>
 #include <deal.II/grid/tria_accessor.h>
 #include <deal.II/grid/tria_iterator.h>
@@ -55,11 +61,21 @@
 #include <deal.II/distributed/solution_transfer.h>
 #include <deal.II/distributed/tria.h>
 
+#include <algorithm>
+#include <cstdint>
 #include <experimental/filesystem>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <mutex>
 
 #include "parameters.h"
+#include "preconditioner_gmg.h"
+#include "solver_policy.h"
 #include "utilities.h"
 
 namespace fs = std::experimental::filesystem;
@@ -84,14 +100,69 @@ namespace Solid
       //! FSI solver need access to the private members of this solver.
       friend ::MPI::FSI<dim>;
 
+      /// The triangulation is replicated on all the processes of the
+      /// communicator, which partition it among themselves.
       SharedSolidSolver(Triangulation<dim> &,
-                        const Parameters::AllParameters &);
+                        const Parameters::AllParameters &,
+                        MPI_Comm communicator = MPI_COMM_WORLD);
       ~SharedSolidSolver();
       void run();
       PETScWrappers::MPI::Vector get_current_solution() const;
+      /// Accumulated number of linear solver iterations since construction.
+      unsigned int get_linear_iterations() const { return linear_iterations; }
+
+      /// The fields of an output step, referenced without copies. The
+      /// vectors only have the locally owned entries, which are the dofs of
+      /// the cells whose subdomain id is the rank.
+      struct InSituData
+      {
+        unsigned int output_index;
+        double time;
+        const DoFHandler<dim> &dof_handler;
+        const DoFHandler<dim> &scalar_dof_handler;
+        const PETScWrappers::MPI::Vector &displacement;
+        const PETScWrappers::MPI::Vector &velocity;
+        const PETScWrappers::MPI::Vector &acceleration;
+        const std::vector<std::vector<PETScWrappers::MPI::Vector>> &strain;
+        const std::vector<std::vector<PETScWrappers::MPI::Vector>> &stress;
+      };
+
+      /// Called on every process at the output steps, before the files are
+      /// written. The files are only written if it returns true, which must
+      /// be the same on all processes.
+      using InSituHook = std::function<bool(const InSituData &)>;
+
+      //! Set the in-situ hook, an empty function removes it.
+      void set_in_situ_hook(const InSituHook &hook) { in_situ_hook = hook; }
 
     protected:
-      struct CellProperty;
+      /**
+       * The fluid traction in FSI simulation, which should be set by the FSI.
+       * The tractions are stored contiguously in the order of the interface
+       * points, and are located through the offset of every face, which is
+       * rebuilt in setup_interface whenever the mesh changes.
+       */
+      struct CellProperty
+      {
+        /// The fluid traction at every interface point.
+        std::vector<Tensor<1, dim>> fsi_traction;
+        /// The first interface point of every face of the active cells, by
+        /// active_cell_index * faces_per_cell + face. invalid_unsigned_int for
+        /// the inner faces.
+        std::vector<unsigned int> face_offset;
+
+        /// The traction at the q-th quadrature point of a boundary face.
+        const Tensor<1, dim> &traction(const unsigned int cell_index,
+                                       const unsigned int face,
+                                       const unsigned int q) const
+        {
+          return fsi_traction
+            [face_offset[cell_index * GeometryInfo<dim>::faces_per_cell +
+                         face] +
+             q];
+        }
+      };
+
       /**
        * Set up the DofHandler, reorder the grid, sparsity pattern.
        */
@@ -104,6 +175,26 @@ namespace Solid
        */
       virtual void initialize_system();
 
+      /**
+       * Add the local memory of the mesh, the matrices, the vectors and the
+       * cell data to the report. The solvers add their own data.
+       */
+      virtual void add_memory(Utils::MemoryReport &) const;
+
+      /**
+       * Print the memory report if it is requested, which the solvers do at
+       * the end of initialize_system.
+       */
+      void print_memory_report() const;
+
+      /**
+       * Collect the boundary faces into the interface list, so that the
+       * coupling does not have to walk all of the cells and faces, and size
+       * the traction arrays of the cell property accordingly. Called by
+       * initialize_system.
+       */
+      void setup_interface();
+
       /**
        * Assemble both the system matrices and rhs.
        */
@@ -119,20 +210,75 @@ namespace Solid
        */
       virtual void run_one_step(bool) = 0;
 
+      /// Whether restoring the displacement, velocity, acceleration and time
+      /// is enough to repeat a time step, as the coupling iterations do.
+      virtual bool state_in_vectors() const { return true; }
+
       /**
        * Solve the linear system. Returns the number of
        * CG iterations and the final residual.
+       * The preconditioner is selected by the "Preconditioner" entry of the
+       * solid solver control. The preconditioner of every matrix, or the
+       * MUMPS solver with the Direct option, is kept until the matrix is
+       * modified. CG reduces the residual by the relative tolerance.
        */
       std::pair<unsigned int, double>
       solve(const PETScWrappers::MPI::SparseMatrix &,
             PETScWrappers::MPI::Vector &,
-            const PETScWrappers::MPI::Vector &);
+            const PETScWrappers::MPI::Vector &,
+            const double relative_tolerance = 1e-8);
+
+      /// One attempt of solve() with the current preconditioner, which
+      /// solve() repeats with the next one if CG does not converge.
+      std::pair<unsigned int, double>
+      solve_once(const PETScWrappers::MPI::SparseMatrix &,
+                 PETScWrappers::MPI::Vector &,
+                 const PETScWrappers::MPI::Vector &,
+                 const double relative_tolerance);
+
+      /**
+       * Compute the orthonormalized rigid body modes of the current mesh,
+       * which are given to BoomerAMG as the near null space.
+       */
+      void compute_rigid_body_modes();
+
+      /**
+       * Build the interpolation matrices of the GMG preconditioner from the
+       * refinement levels of the mesh.
+       *
+       * The levels of the triangulation below its coarsest active cells
+       * cover the whole domain, they are the coarse levels of the multigrid
+       * and the active mesh is the finest. The level dofs of every process
+       * are those first met on the cells of its subdomain, and every level
+       * is interpolated into the next one with the prolongation matrices of
+       * the finite element. Called in initialize_system, so the matrices
+       * are only built once per mesh.
+       */
+      void setup_multigrid();
 
       /**
        * Output the time-dependent solution in vtu format.
        */
       void output_results(const unsigned int);
 
+      /**
+       * Output with the processes in groups, every process writes the cells
+       * of its own subdomain.
+       */
+      void output_results_in_groups(const unsigned int);
+
+      /**
+       * Run the writing of the staged output files, in the background
+       * writer if the output is asynchronous.
+       */
+      void write_output(std::function<void()> &&);
+
+      /**
+       * Write the displacement at the probe points, called by the solvers
+       * after every time step.
+       */
+      void sample_probes();
+
       /**
        * Refine mesh and transfer solution.
        */
@@ -149,6 +295,68 @@ namespace Solid
        */
       virtual bool load_checkpoint();
 
+      /**
+       * Partition the mesh with the given subdomain of every active cell,
+       * and move the solution to the new partition. The solution is moved in
+       * the numbering before the subdomain-wise renumbering, which does not
+       * depend on the partition.
+       */
+      virtual void
+      repartition(const std::vector<types::subdomain_id> &subdomains);
+
+      /**
+       * Collectively write the vectors to a single file with MPI-IO. The
+       * entries are stored in the numbering before the subdomain-wise
+       * renumbering, so that the file can be read with any number of
+       * processes.
+       */
+      void write_vectors(
+        const std::string &,
+        const std::vector<const PETScWrappers::MPI::Vector *> &) const;
+
+      /**
+       * Collectively read the vectors written by write_vectors.
+       */
+      void read_vectors(const std::string &,
+                        const std::vector<PETScWrappers::MPI::Vector *> &);
+
+      /**
+       * Write the vectors compressed with Utils::encode_values, in the
+       * numbering of write_vectors. The entries are reduced to the first
+       * process, which writes the file, as the difference to the last
+       * complete checkpoint if the key interval allows it.
+       */
+      void write_compressed_vectors(
+        const std::string &,
+        const std::vector<const PETScWrappers::MPI::Vector *> &,
+        const int output_index);
+
+      /**
+       * Read the vectors written by write_compressed_vectors. Every process
+       * reads the whole file, and the one of its key if it is a difference.
+       */
+      void read_compressed_vectors(
+        const std::string &, const std::vector<PETScWrappers::MPI::Vector *> &);
+
+      /// Decode all the values of a compressed checkpoint file.
+      void read_compressed_values(const std::string &,
+                                  std::vector<double> &) const;
+
+      /// Whether a checkpoint holds compressed values, which is told by the
+      /// file rather than the current setting.
+      bool compressed_checkpoint(const std::string &) const;
+
+      /// The time step of the checkpoint that a compressed checkpoint is the
+      /// difference to, or -1 if it is complete.
+      int checkpoint_key_of(const std::string &) const;
+
+      /**
+       * File view of the locally owned entries of a vector in a checkpoint.
+       * order is filled with the local positions of the entries in the
+       * order they appear in the file. The type must be freed by the caller.
+       */
+      MPI_Datatype make_checkpoint_type(std::vector<unsigned int> &order) const;
+
       Triangulation<dim> &triangulation;
       Parameters::AllParameters parameters;
       DoFHandler<dim> dof_handler;
@@ -203,21 +411,68 @@ namespace Solid
       ConditionalOStream pcout;
       Utils::Time time;
       mutable TimerOutput timer;
+      /// Accumulated number of linear solver iterations, reset by the caller
+      /// for profiling.
+      unsigned int linear_iterations;
+
+      /// Newton iterations of the last time step, 0 for the linear solvers.
+      unsigned int newton_iterations;
+
+      /// Translations and rotations, empty until the AMG preconditioner is
+      /// first used on the current mesh.
+      std::vector<PETScWrappers::MPI::Vector> rigid_body_modes;
+      /// The interpolation of the GMG preconditioner into every level, the
+      /// finest of which is the active mesh. Only built if GMG is used.
+      MGLevelObject<PETScWrappers::MPI::SparseMatrix> mg_interpolation;
+      /// Solver control shared by all the direct solvers.
+      SolverControl direct_solver_control;
+      /// The preconditioner of the CG solver or the direct solver, chosen
+      /// again on every mesh if it is Auto.
+      SolverPolicy preconditioner_policy;
+      /// The direct solvers of the matrices solved so far on this mesh.
+      std::map<const PETScWrappers::MPI::SparseMatrix *,
+               std::shared_ptr<PETScWrappers::SparseDirectMUMPS>>
+        direct_solvers;
+      /// The preconditioners of the matrices solved so far on this mesh,
+      /// together with the PETSc state of the matrix they were built from.
+      std::map<const PETScWrappers::MPI::SparseMatrix *,
+               std::pair<PetscObjectState,
+                         std::shared_ptr<PETScWrappers::PreconditionerBase>>>
+        preconditioners;
       IndexSet locally_owned_dofs;
       IndexSet locally_owned_scalar_dofs;
       IndexSet locally_relevant_dofs;
       mutable std::vector<std::pair<double, std::string>> times_and_names;
-
-      CellDataStorage<typename Triangulation<dim>::cell_iterator, CellProperty>
-        cell_property;
-
-      /**
-       * The fluid traction in FSI simulation, which should be set by the FSI.
-       */
-      struct CellProperty
-      {
-        Tensor<1, dim> fsi_traction;
-      };
+      /// The subdomain of every active cell given by repartition, METIS
+      /// partitions the mesh if it is empty.
+      std::vector<types::subdomain_id> cell_subdomains;
+      /// The index of every locally owned dof before the renumbering.
+      std::vector<types::global_dof_index> canonical_dof_indices;
+      /// The vectors of the last complete compressed checkpoint in the
+      /// numbering of the checkpoint files, which the following ones are the
+      /// differences to, and its time step. Only kept on the first process,
+      /// and reset whenever the mesh changes.
+      std::vector<double> checkpoint_key;
+      int checkpoint_key_index;
+      unsigned int checkpoints_since_key;
+      /// Writes the output in groups of processes, if requested.
+      std::unique_ptr<Utils::GroupedVtuWriter<dim>> vtu_writer;
+      /// Writes the output files while the time stepping goes on, if
+      /// requested.
+      std::unique_ptr<Utils::BackgroundWriter> output_writer;
+      /// The displacement at the probe points in the reference configuration.
+      Utils::Probes<dim, PETScWrappers::MPI::Vector> probes;
+      /// Analyzes the output steps in memory, if set.
+      InSituHook in_situ_hook;
+
+      CellProperty cell_property;
+
+      /// The boundary faces as pairs of cell and face number, in the order of
+      /// the active cells. The quadrature points of the k-th face are the
+      /// interface points [k * n_face_q_points, (k + 1) * n_face_q_points).
+      std::vector<
+        std::pair<typename DoFHandler<dim>::active_cell_iterator, unsigned int>>
+        interface_faces;
     };
   } // namespace MPI
 } // namespace Solid
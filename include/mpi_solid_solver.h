@@ -4,6 +4,7 @@
 #include <deal.II/base/conditional_ostream.h>
 #include <deal.II/base/function.h>
 #include <deal.II/base/index_set.h>
+#include <deal.II/base/memory_consumption.h>
 #include <deal.II/base/quadrature_lib.h>
 #include <deal.II/base/quadrature_point_data.h>
 #include <deal.II/base/tensor.h>
@@ -57,10 +58,19 @@
 
 #include <fstream>
 #include <iostream>
+#include <map>
+#include <memory>
 
 #include "parameters.h"
+#include "solver_policy.h"
 #include "utilities.h"
 
+namespace MPI
+{
+  template <int dim>
+  class DistributedFSI;
+}
+
 namespace Solid
 {
   namespace MPI
@@ -72,6 +82,9 @@ namespace Solid
     class SolidSolver
     {
     public:
+      //! FSI solver need access to the private members of this solver.
+      friend ::MPI::DistributedFSI<dim>;
+
       SolidSolver(parallel::distributed::Triangulation<dim> &,
                   const Parameters::AllParameters &);
       ~SolidSolver();
@@ -79,6 +92,8 @@ namespace Solid
       PETScWrappers::MPI::Vector get_current_solution() const;
 
     protected:
+      struct CellProperty;
+
       /**
        * Set up the DofHandler, reorder the grid, sparsity pattern.
        */
@@ -91,6 +106,18 @@ namespace Solid
        */
       virtual void initialize_system();
 
+      /**
+       * Add the local memory of the mesh, the matrices, the vectors and the
+       * cell data to the report. The solvers add their own data.
+       */
+      virtual void add_memory(Utils::MemoryReport &) const;
+
+      /**
+       * Print the memory report if it is requested, which the solvers do at
+       * the end of initialize_system.
+       */
+      void print_memory_report() const;
+
       /**
        * Assemble both the system matrices and rhs.
        */
@@ -104,12 +131,24 @@ namespace Solid
       /**
        * Solve the linear system. Returns the number of
        * CG iterations and the final residual.
+       * With the Direct preconditioner option the matrix is solved by MUMPS
+       * instead, otherwise CG is preconditioned by BlockJacobi. The MUMPS
+       * solver or the preconditioner of every matrix is kept until the
+       * matrix is modified, e.g. when it is assembled again after a
+       * refinement.
        */
       std::pair<unsigned int, double>
       solve(const PETScWrappers::MPI::SparseMatrix &,
             PETScWrappers::MPI::Vector &,
             const PETScWrappers::MPI::Vector &);
 
+      /// One attempt of solve() with the current preconditioner, which
+      /// solve() repeats with the next one if CG does not converge.
+      std::pair<unsigned int, double>
+      solve_once(const PETScWrappers::MPI::SparseMatrix &,
+                 PETScWrappers::MPI::Vector &,
+                 const PETScWrappers::MPI::Vector &);
+
       /**
        * Output the time-dependent solution in vtu format.
        */
@@ -167,6 +206,34 @@ namespace Solid
       mutable TimerOutput timer;
       IndexSet locally_owned_dofs;
       IndexSet locally_relevant_dofs;
+
+      /// Solver control shared by all the direct solvers.
+      SolverControl direct_solver_control;
+      /// Direct or not, chosen again on every mesh if it is Auto.
+      SolverPolicy preconditioner_policy;
+      /// The direct solvers of the matrices solved so far on this mesh.
+      std::map<const PETScWrappers::MPI::SparseMatrix *,
+               std::shared_ptr<PETScWrappers::SparseDirectMUMPS>>
+        direct_solvers;
+      /// The preconditioners of the matrices solved so far on this mesh,
+      /// together with the PETSc state of the matrix they were built from.
+      std::map<const PETScWrappers::MPI::SparseMatrix *,
+               std::pair<PetscObjectState,
+                         std::shared_ptr<PETScWrappers::PreconditionerBase>>>
+        preconditioners;
+
+      /// The FSI traction at the face quadrature points of the locally owned
+      /// cells.
+      CellDataStorage<typename Triangulation<dim>::cell_iterator, CellProperty>
+        cell_property;
+
+      /**
+       * The fluid traction in FSI simulation, which should be set by the FSI.
+       */
+      struct CellProperty
+      {
+        Tensor<1, dim> fsi_traction;
+      };
     };
   } // namespace MPI
 } // namespace Solid
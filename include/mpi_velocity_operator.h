@@ -0,0 +1,205 @@
+#ifndef MPI_VELOCITY_OPERATOR
+#define MPI_VELOCITY_OPERATOR
+
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/table.h>
+#include <deal.II/base/vectorization.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/diagonal_matrix.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/petsc_block_vector.h>
+#include <deal.II/lac/petsc_vector.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/solver_gmres.h>
+
+#include <deal.II/distributed/tria.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+#include <deal.II/fe/mapping_q1.h>
+
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+#include <deal.II/matrix_free/operators.h>
+
+#include <deal.II/multigrid/mg_coarse.h>
+#include <deal.II/multigrid/mg_constrained_dofs.h>
+#include <deal.II/multigrid/mg_matrix.h>
+#include <deal.II/multigrid/mg_smoother.h>
+#include <deal.II/multigrid/mg_tools.h>
+#include <deal.II/multigrid/mg_transfer_matrix_free.h>
+#include <deal.II/multigrid/multigrid.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "parameters.h"
+
+namespace Fluid
+{
+  namespace MPI
+  {
+    using namespace dealii;
+
+    /*! \brief Matrix-free evaluation of the velocity block of the linearized
+     * incompressible Navier-Stokes equations.
+     *
+     * The operator is
+     * \f$ \frac{\rho}{\Delta{t}}(\delta{u}, v) + \mu(\nabla\delta{u},
+     * \nabla{v}) + \gamma\rho(\nabla\cdot\delta{u}, \nabla\cdot{v}) +
+     * \rho(\nabla{w}\delta{u} + \nabla\delta{u}{w}, v) \f$,
+     * where \f$w\f$ is the velocity at the current Newton iteration. It is
+     * evaluated with sum factorization on all the cells of a batch at once.
+     * The convection term is only included after evaluate_convection() is
+     * called, which is only done on the finest level: the multigrid levels
+     * only see the symmetric part, which keeps Chebyshev smoothing valid.
+     */
+    template <int dim, int fe_degree, typename number>
+    class VelocityOperator
+      : public MatrixFreeOperators::
+          Base<dim, LinearAlgebra::distributed::Vector<number>>
+    {
+    public:
+      using VectorType = LinearAlgebra::distributed::Vector<number>;
+
+      VelocityOperator();
+
+      void clear() override;
+
+      /// Set the material and time stepping coefficients.
+      void set_coefficients(const double viscosity,
+                            const double rho,
+                            const double gamma,
+                            const double dt);
+
+      /// Store the convecting velocity and its gradient at the quadrature
+      /// points. The vector must have the ghost entries of this operator.
+      void evaluate_convection(const VectorType &velocity);
+
+      virtual void compute_diagonal() override;
+
+    private:
+      virtual void apply_add(VectorType &dst,
+                             const VectorType &src) const override;
+
+      void local_apply(const MatrixFree<dim, number> &data,
+                       VectorType &dst,
+                       const VectorType &src,
+                       const std::pair<unsigned int, unsigned int> &) const;
+
+      void local_compute_diagonal(
+        const MatrixFree<dim, number> &data,
+        VectorType &dst,
+        const unsigned int &,
+        const std::pair<unsigned int, unsigned int> &) const;
+
+      /// Apply the operator to the dof values of a cell batch in phi.
+      void
+      do_quadrature(FEEvaluation<dim, fe_degree, fe_degree + 1, dim, number> &,
+                    const unsigned int cell) const;
+
+      VectorizedArray<number> mass_coefficient;
+      VectorizedArray<number> viscous_coefficient;
+      VectorizedArray<number> grad_div_coefficient;
+      VectorizedArray<number> convection_coefficient;
+
+      bool with_convection;
+      Table<2, Tensor<1, dim, VectorizedArray<number>>> convection_value;
+      Table<2, Tensor<2, dim, VectorizedArray<number>>> convection_gradient;
+    };
+
+    /*! \brief Inexact solver for the velocity block based on the matrix-free
+     * operator and geometric multigrid.
+     *
+     * The velocity unknowns live on a separate vector-valued DoFHandler on
+     * the fluid triangulation. The locally owned velocity dofs match the
+     * locally owned velocity dofs of the fluid system, and the map between
+     * the two numberings is built in setup(). GMRES is preconditioned by a
+     * multigrid V-cycle with Chebyshev smoothing in single precision, so no
+     * matrix is stored on any level.
+     *
+     * The triangulation must be created with the
+     * construct_multigrid_hierarchy flag, see InsIM::triangulation_settings.
+     */
+    template <int dim>
+    class MatrixFreeVelocitySolver
+    {
+    public:
+      /// The only velocity degree the operator is compiled for.
+      static const int fe_degree = 2;
+
+      using VectorType = LinearAlgebra::distributed::Vector<double>;
+      using LevelVectorType = LinearAlgebra::distributed::Vector<float>;
+      using SystemMatrixType = VelocityOperator<dim, fe_degree, double>;
+      using LevelMatrixType = VelocityOperator<dim, fe_degree, float>;
+
+      MatrixFreeVelocitySolver(parallel::distributed::Triangulation<dim> &,
+                               const Parameters::AllParameters &);
+
+      /// Distribute the velocity dofs, build the operators on all levels
+      /// and the map to the dofs of the fluid system. Must be called again
+      /// whenever the fluid dofs change.
+      void setup(const DoFHandler<dim> &system_dof_handler);
+
+      /// Update the convecting velocity, and the smoothers if the time step
+      /// has changed.
+      void update(const PETScWrappers::MPI::BlockVector &evaluation_point,
+                  const double dt);
+
+      /// Approximately solve the velocity block system, the vectors are the
+      /// velocity blocks of the fluid system. Return the GMRES iterations.
+      unsigned int solve(PETScWrappers::MPI::Vector &dst,
+                         const PETScWrappers::MPI::Vector &src) const;
+
+    private:
+      /// Hanging node and homogeneous Dirichlet constraints.
+      void make_constraints();
+
+      /// Set up the smoothers and the multigrid preconditioner.
+      void setup_multigrid();
+
+      parallel::distributed::Triangulation<dim> &triangulation;
+      const Parameters::AllParameters &parameters;
+
+      FESystem<dim> fe;
+      DoFHandler<dim> dof_handler;
+      AffineConstraints<double> constraints;
+      MGConstrainedDoFs mg_constrained_dofs;
+
+      SystemMatrixType system_matrix;
+      MGLevelObject<LevelMatrixType> mg_matrices;
+      MGLevelObject<MatrixFreeOperators::MGInterfaceOperator<LevelMatrixType>>
+        mg_interface_matrices;
+      MGTransferMatrixFree<dim, float> mg_transfer;
+
+      using SmootherType =
+        PreconditionChebyshev<LevelMatrixType, LevelVectorType>;
+      MGSmootherPrecondition<LevelMatrixType, SmootherType, LevelVectorType>
+        mg_smoother;
+      MGCoarseGridApplySmoother<LevelVectorType> mg_coarse;
+      std::shared_ptr<mg::Matrix<LevelVectorType>> mg_matrix;
+      std::shared_ptr<mg::Matrix<LevelVectorType>> mg_interface;
+      std::shared_ptr<Multigrid<LevelVectorType>> mg;
+      std::shared_ptr<
+        PreconditionMG<dim, LevelVectorType, MGTransferMatrixFree<dim, float>>>
+        preconditioner;
+
+      /// The global fluid dof of every locally owned velocity dof.
+      std::vector<PETScWrappers::MPI::Vector::size_type> system_indices;
+
+      /// The time step that the smoothers were set up with.
+      double current_dt;
+
+      VectorType convection;
+      mutable VectorType src_buffer;
+      mutable VectorType dst_buffer;
+      mutable std::vector<PetscScalar> values_buffer;
+    };
+  } // namespace MPI
+} // namespace Fluid
+
+#endif
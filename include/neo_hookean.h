@@ -1,6 +1,11 @@
 #ifndef NEO_HOOKEAN
 #define NEO_HOOKEAN
 
+#include <deal.II/base/symmetric_tensor.h>
+#include <deal.II/base/vectorization.h>
+
+#include <algorithm>
+
 #include "hyper_elastic_material.h"
 
 namespace Solid
@@ -33,6 +38,110 @@ namespace Solid
       return dealii::SymmetricTensor<4, dim>();
     }
 
+    /**
+     * Evaluate the batch with compute_tau_Jc, as many deformation gradients
+     * at once as there are lanes in VectorizedArray. The state of the
+     * material is not changed.
+     */
+    virtual void
+    evaluate(const dealii::ArrayView<const dealii::Tensor<2, dim>> &F,
+             const dealii::ArrayView<dealii::SymmetricTensor<2, dim>> &tau,
+             const dealii::ArrayView<dealii::SymmetricTensor<4, dim>> &Jc)
+      override
+    {
+      Assert(tau.size() == F.size() && Jc.size() == F.size(),
+             dealii::ExcInternalError());
+      using VA = dealii::VectorizedArray<double>;
+      const unsigned int n_lanes = VA::n_array_elements;
+      dealii::Tensor<2, dim, VA> F_batch;
+      dealii::SymmetricTensor<2, dim, VA> tau_batch;
+      dealii::SymmetricTensor<4, dim, VA> Jc_batch;
+      for (unsigned int begin = 0; begin < F.size(); begin += n_lanes)
+        {
+          const unsigned int n =
+            std::min<unsigned int>(n_lanes, F.size() - begin);
+          // The unused lanes of the last batch get the identity.
+          for (unsigned int v = 0; v < n_lanes; ++v)
+            {
+              for (unsigned int i = 0; i < dim; ++i)
+                {
+                  for (unsigned int j = 0; j < dim; ++j)
+                    {
+                      F_batch[i][j][v] =
+                        (v < n ? F[begin + v][i][j] : (i == j ? 1.0 : 0.0));
+                    }
+                }
+            }
+          compute_tau_Jc(F_batch, tau_batch, Jc_batch);
+          for (unsigned int v = 0; v < n; ++v)
+            {
+              for (unsigned int i = 0; i < dim; ++i)
+                {
+                  for (unsigned int j = i; j < dim; ++j)
+                    {
+                      tau[begin + v][i][j] = tau_batch[i][j][v];
+                      for (unsigned int k = 0; k < dim; ++k)
+                        {
+                          for (unsigned int l = k; l < dim; ++l)
+                            {
+                              Jc[begin + v][i][j][k][l] =
+                                Jc_batch[i][j][k][l][v];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * The closed form of tau and Jc, see HyperElasticMaterial::get_tau and
+     * HyperElasticMaterial::get_Jc. The fictitious elasticity tensor
+     * vanishes, so its projection is skipped. Number is either double or
+     * VectorizedArray<double>.
+     */
+    template <typename Number>
+    void compute_tau_Jc(const dealii::Tensor<2, dim, Number> &F,
+                        dealii::SymmetricTensor<2, dim, Number> &tau,
+                        dealii::SymmetricTensor<4, dim, Number> &Jc) const
+    {
+      const dealii::SymmetricTensor<2, dim, Number> I =
+        dealii::unit_symmetric_tensor<dim, Number>();
+      const dealii::SymmetricTensor<4, dim, Number> S =
+        dealii::identity_tensor<dim, Number>();
+      const dealii::SymmetricTensor<4, dim, Number> IxI =
+        dealii::outer_product(I, I);
+
+      const Number J = dealii::determinant(F);
+      // tau_bar = 2 c1 b_bar, b_bar = J^(-2/dim) F F^T
+      const Number factor = 2.0 * c1 * std::pow(J, -2.0 / dim);
+      dealii::SymmetricTensor<2, dim, Number> tau_bar;
+      for (unsigned int i = 0; i < dim; ++i)
+        {
+          for (unsigned int j = i; j < dim; ++j)
+            {
+              Number b_ij = F[i][0] * F[j][0];
+              for (unsigned int k = 1; k < dim; ++k)
+                {
+                  b_ij += F[i][k] * F[j][k];
+                }
+              tau_bar[i][j] = factor * b_ij;
+            }
+        }
+      const Number trace_tau_bar = dealii::trace(tau_bar);
+      const dealii::SymmetricTensor<2, dim, Number> tau_iso =
+        tau_bar - ((1.0 / dim) * trace_tau_bar) * I;
+
+      const Number p = this->kappa * (J - 1.0);
+      const Number p_tilde = p + J * this->kappa;
+      tau = tau_iso + (J * p) * I;
+
+      Jc = (2.0 / dim * trace_tau_bar) * (S - (1.0 / dim) * IxI) -
+           (2.0 / dim) * (dealii::outer_product(tau_iso, I) +
+                          dealii::outer_product(I, tau_iso)) +
+           J * (p_tilde * IxI - (2.0 * p) * S);
+    }
+
   private:
     double c1;
   };
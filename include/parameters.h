@@ -23,6 +23,56 @@ namespace Parameters
     double refinement_interval;
     double save_interval;
     std::vector<double> gravity;
+    unsigned int n_threads;
+    bool async_checkpoint;
+    /** Compress the solution in the checkpoints of the parallel solvers.
+     * One out of checkpoint_key_interval checkpoints is then complete, and
+     * the others store the difference to it. */
+    bool checkpoint_compression;
+    unsigned int checkpoint_key_interval;
+    unsigned int n_kept_checkpoints; //!< Checkpoints kept on the disk.
+    /** Print the minimum, average and maximum wall time of every timer
+     * section over the processes at the end of the parallel runs. */
+    bool timer_statistics;
+    /** Print the memory of the parallel solvers per subsystem after every
+     * system setup, and the peak resident memory at the end. */
+    bool memory_report;
+    unsigned int n_output_groups;
+    /** Write the output files of the parallel solvers in a background
+     * thread, with at most output_queue_length outputs waiting. */
+    bool async_output;
+    unsigned int output_queue_length;
+    std::string dof_ordering;
+    /** The points where the fluid solution and the solid displacement are
+     * written at every time step. */
+    std::vector<std::vector<double>> fluid_probe_points;
+    std::vector<std::vector<double>> solid_probe_points;
+    /** The box and the plane (a point and the normal) that limit the cells
+     * written by output_results, and the subdivisions of the fluid cells,
+     * 0 means the pressure degree. Empty means no limit. */
+    std::vector<double> fluid_output_box;
+    std::vector<double> fluid_output_plane;
+    unsigned int fluid_output_subdivisions;
+    std::vector<double> solid_output_box;
+    std::vector<double> solid_output_plane;
+    bool adaptive_time_step;
+    double min_time_step;
+    double max_time_step;
+    double target_cfl;
+    unsigned int target_newton_iterations;
+    /** Whether the tolerances of the linear solves in the Newton loops follow
+     * the reduction of the nonlinear residual (Eisenstat-Walker), and the
+     * largest relative tolerance they may take. */
+    bool inexact_newton;
+    double max_forcing_term;
+    /** Pseudo-transient continuation to the steady state instead of the
+     * time loop: the reduction of the steady residual that ends it, the
+     * largest pseudo time step and the maximum number of pseudo time steps.
+     */
+    bool steady_state;
+    double steady_tolerance;
+    double max_pseudo_time_step;
+    unsigned int max_pseudo_time_steps;
     static void declareParameters(ParameterHandler &);
     void parseParameters(ParameterHandler &);
   };
@@ -48,6 +98,61 @@ namespace Parameters
     double grad_div;
     unsigned int fluid_max_iterations;
     double fluid_tolerance;
+    /** Rebuild the fluid preconditioner only when the outer linear solver
+     * needed more iterations than this, 0 means rebuild at every solve. */
+    unsigned int fluid_pc_rebuild_iterations;
+    /** Rebuild the fluid preconditioner when the inner Schur complement solve
+     * needed more iterations than this, 0 disables this criterion. */
+    unsigned int fluid_pc_rebuild_inner_iterations;
+    /** Number of solution directions kept to deflate the next linear solves
+     * of SCnsIM, 0 disables Krylov recycling. */
+    unsigned int fluid_recycle_vectors;
+    /** Whether the inner solves of the serial SCnsIM preconditioner store
+     * their matrices in single precision. */
+    bool fluid_single_precision_pc;
+    /** Preconditioner of the inner Schur complement solve, Euclid (ILU),
+     * Pilut (ILUT), BoomerAMG or Auto (see SolverPolicy). */
+    std::string fluid_pressure_pc;
+    /** Solver for the velocity block in the InsIM preconditioner: MUMPS,
+     * AMG (a single V-cycle), AMG-GMRES, MatrixFree (geometric multigrid) or
+     * Auto (see SolverPolicy). */
+    std::string fluid_velocity_solver;
+    /** Keep the MUMPS solver of the velocity block between time steps, so
+     * that only the numeric factorization is redone. */
+    bool fluid_reuse_direct_analysis;
+    /** Relative cost of an artificial fluid cell and of a cell with PML
+     * damping (SCnsIM only) when the mesh is partitioned, 1 is the cost of
+     * a plain fluid cell. */
+    double artificial_fluid_cell_weight;
+    double pml_cell_weight;
+    /** Number of previous solutions that the initial guess of a time step
+     * is extrapolated from, 0 starts from the last solution. */
+    unsigned int fluid_predictor_order;
+    /** Krylov methods of the inner solves in the preconditioners: Standard or
+     * Pipelined, which overlaps the reductions with the products. */
+    std::string fluid_krylov_variant;
+    /** Operator of the inner Tpp solve of SCnsIM: Exact applies the ILU of
+     * Avv in every product, Diagonal assembles App - Apv diag(Avv)^-1 Avp. */
+    std::string fluid_schur_approximation;
+    static void declareParameters(ParameterHandler &);
+    void parseParameters(ParameterHandler &);
+  };
+
+  struct FluidPressurePreconditioner
+  {
+    /** Fill levels and block Jacobi variant of the Euclid ILU(k). */
+    unsigned int euclid_levels;
+    bool euclid_block_jacobi;
+    /** Iterations, row size and drop tolerance of the Pilut ILUT. */
+    unsigned int pilut_max_iterations;
+    unsigned int pilut_row_size;
+    double pilut_tolerance;
+    /** Try the fill levels (Euclid) or the drop tolerances (Pilut) in the
+     * first time steps, one per step, and keep the one with the shortest
+     * Tpp solves. */
+    bool tune_pressure_pc;
+    std::vector<unsigned int> tuning_levels;
+    std::vector<double> tuning_tolerances;
     static void declareParameters(ParameterHandler &);
     void parseParameters(ParameterHandler &);
   };
@@ -109,6 +214,16 @@ namespace Parameters
                                        //! hyperelastic only.
     double tol_f;                      //!< Force tolerance
     double tol_d; //!< Displacement tolerance, hyperelastic only.
+    std::string solid_preconditioner; //!< Preconditioner of the CG solver,
+                                      //! parallel solvers only, or Auto.
+    unsigned int solid_smoothing_steps; //!< Chebyshev steps on every level
+                                        //! of the GMG preconditioner.
+    std::string solid_newton_method; //!< Full, Modified or BFGS,
+                                     //! parallel hyperelastic only.
+    double tangent_refresh_ratio; //!< Rebuild a frozen tangent when the
+                                  //! residual decreases by less than this.
+    std::string solid_time_integration; //!< Implicit or Explicit, linear
+                                        //! elastic solvers only.
     static void declareParameters(ParameterHandler &);
     void parseParameters(ParameterHandler &);
   };
@@ -151,17 +266,76 @@ namespace Parameters
     void parseParameters(ParameterHandler &);
   };
 
+  struct FSISolver
+  {
+    /** Only fetch the solid velocity and acceleration near the local fluid
+     * subdomain instead of localizing them on every process. */
+    bool distributed_solid_state;
+    /** Keep the localized solid displacement and the reference and
+     * deformed solid vertex coordinates once per node in shared memory
+     * instead of once per process. */
+    bool node_shared_solid_state;
+    /** Solve the fluid with the solid state of the previous step, so that
+     * the traction exchange overlaps with the fluid solve. The solid solve
+     * follows the fluid, unless only a group of processes solves it. */
+    bool overlap_traction_exchange;
+    /** Solve the solid on the first this many processes, the others keep a
+     * serial copy of its state. With the overlapped traction exchange, they
+     * assemble the fluid while the group solves the solid. 0 solves the
+     * solid on all processes. */
+    unsigned int solid_processes;
+    /** Iterate the solid and the fluid of every time step at most this many
+     * times until the fluid traction at the interface converges, 1 is the
+     * explicit scheme. The iterations are accelerated with Aitken
+     * relaxation or IQN-ILS, starting with the given relaxation. */
+    unsigned int coupling_iterations;
+    double coupling_tolerance;
+    std::string coupling_acceleration;
+    double coupling_relaxation;
+    /** The CSV file to write the per time step performance counters to,
+     * nothing is written if empty. */
+    std::string performance_log;
+    /** Only re-evaluate the indicator of the fluid cells within this many
+     * layers of the previous solid boundary, 0 evaluates all cells. */
+    unsigned int indicator_band_layers;
+    /** Only assemble the artificial fluid cells within this many layers of
+     * the real fluid (SCnsIM only), 0 assembles all of them. */
+    unsigned int artificial_fluid_band_layers;
+    /** Refine the fluid cells close to the solid boundary points (Distance)
+     * or within a number of layers of the indicator interface (Band). */
+    std::string refinement_criterion;
+    unsigned int refinement_band_layers;
+    /** Repartition the fluid mesh when the most loaded process has this
+     * many times the average cost of the fluid cells, 0 never repartitions
+     * between refinements, but at most once per number of time steps. */
+    double load_imbalance_tolerance;
+    unsigned int repartition_interval;
+    /** Number of steps that the solid and the fluid take per coupling time
+     * step, each with its share of the coupling time step. */
+    unsigned int solid_sub_steps;
+    unsigned int fluid_sub_steps;
+    /** Partition the shared solid mesh with METIS, or give every solid cell
+     * to the process that owns the fluid cell around its center (Fluid
+     * aligned), with at most the given imbalance of solid cells. */
+    std::string solid_partitioner;
+    double solid_partition_imbalance;
+    static void declareParameters(ParameterHandler &);
+    void parseParameters(ParameterHandler &);
+  };
+
   struct AllParameters : public Simulation,
                          public FluidFESystem,
                          public FluidMaterial,
                          public FluidSolver,
+                         public FluidPressurePreconditioner,
                          public FluidDirichlet,
                          public FluidNeumann,
                          public SolidFESystem,
                          public SolidMaterial,
                          public SolidSolver,
                          public SolidDirichlet,
-                         public SolidNeumann
+                         public SolidNeumann,
+                         public FSISolver
   {
     AllParameters(const std::string &);
     static void declareParameters(ParameterHandler &);
@@ -0,0 +1,81 @@
+#ifndef PRECONDITIONER_GMG
+#define PRECONDITIONER_GMG
+
+#include <deal.II/base/mg_level_object.h>
+#include <deal.II/lac/exceptions.h>
+#include <deal.II/lac/petsc_matrix_base.h>
+#include <deal.II/lac/petsc_precondition.h>
+#include <deal.II/lac/petsc_sparse_matrix.h>
+#include <petscconf.h>
+#include <petscksp.h>
+#include <petscpc.h>
+
+using namespace dealii;
+
+/*! \brief Geometric multigrid V-cycle through PETSc's PCMG.
+ *
+ * The caller provides the interpolation matrices from every level to the
+ * next finer one, the last of which interpolates into the space of the
+ * matrix. The level operators are Galerkin products of the matrix, so they
+ * are computed again whenever the preconditioner is built, whereas the
+ * interpolation matrices only depend on the mesh. Every level but the
+ * coarsest is smoothed by a few Chebyshev iterations preconditioned by
+ * Jacobi, and the coarsest level is solved with a redundant LU.
+ */
+class PreconditionGMG : public PETScWrappers::PreconditionerBase
+{
+public:
+  /**
+   * Standardized data struct to pipe additional flags to the
+   * preconditioner.
+   */
+  struct AdditionalData
+  {
+    /**
+     * Constructor.
+     */
+    AdditionalData(const unsigned int smoothing_steps = 2);
+
+    /**
+     * Chebyshev iterations of the pre- and the post-smoother.
+     */
+    unsigned int smoothing_steps;
+  };
+
+  /**
+   * Empty Constructor. You need to call initialize() before using this
+   * object.
+   */
+  PreconditionGMG() = default;
+
+  /**
+   * Constructor. Take the matrix which is used to form the preconditioner,
+   * the interpolation matrices into the levels 1 to n_levels - 1, and
+   * additional flags if there are any.
+   */
+  PreconditionGMG(
+    const PETScWrappers::MatrixBase &matrix,
+    const MGLevelObject<PETScWrappers::MPI::SparseMatrix> &interpolation,
+    const AdditionalData &additional_data = AdditionalData());
+
+  /**
+   * Initialize the preconditioner object and calculate all data that is
+   * necessary for applying it in a solver. This function is automatically
+   * called when calling the constructor with the same arguments and is only
+   * used if you create the preconditioner without arguments.
+   */
+  void initialize(
+    const PETScWrappers::MatrixBase &matrix,
+    const MGLevelObject<PETScWrappers::MPI::SparseMatrix> &interpolation,
+    const AdditionalData &additional_data = AdditionalData());
+
+  friend PETScWrappers::MatrixBase;
+
+private:
+  /**
+   * Store a copy of the flags for this particular preconditioner.
+   */
+  AdditionalData additional_data;
+};
+
+#endif
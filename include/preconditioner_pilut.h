@@ -77,6 +77,29 @@ private:
 class PreconditionEuclid : public PETScWrappers::PreconditionerBase
 {
 public:
+  /**
+   * Standardized data struct to pipe additional flags to the
+   * preconditioner.
+   */
+  struct AdditionalData
+  {
+    /**
+     * Constructor. One level of fill is the default of Euclid.
+     */
+    AdditionalData(const unsigned int levels = 1,
+                   const bool block_jacobi = false);
+
+    /**
+     * Levels of fill of ILU(k).
+     */
+    unsigned int levels;
+
+    /**
+     * Factorize the locally owned block only instead of the parallel ILU(k).
+     */
+    bool block_jacobi;
+  };
+
   /**
    * Empty Constructor. You need to call initialize() before using this
    * object.
@@ -87,17 +110,28 @@ public:
    * Constructor. Take the matrix which is used to form the preconditioner,
    * and additional flags if there are any.
    */
-  PreconditionEuclid(const PETScWrappers::MatrixBase &matrix);
+  PreconditionEuclid(const PETScWrappers::MatrixBase &matrix,
+                     const AdditionalData &additional_data = AdditionalData());
 
   /**
    * Initialize the preconditioner object and calculate all data that is
    * necessary for applying it in a solver. This function is automatically
    * called when calling the constructor with the same arguments and is only
    * used if you create the preconditioner without arguments.
+   *
+   * The options are always set, since PETSc keeps them in the global
+   * options database for the next Euclid preconditioner.
    */
-  void initialize(const PETScWrappers::MatrixBase &matrix);
+  void initialize(const PETScWrappers::MatrixBase &matrix,
+                  const AdditionalData &additional_data = AdditionalData());
 
   friend PETScWrappers::MatrixBase;
+
+private:
+  /**
+   * Store a copy of the flags for this particular preconditioner.
+   */
+  AdditionalData additional_data;
 };
 
 #endif
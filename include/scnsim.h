@@ -7,6 +7,9 @@
 template <int>
 class FSI;
 
+template <int>
+class KernelBenchmark;
+
 namespace Fluid
 {
   using namespace dealii;
@@ -38,6 +41,7 @@ namespace Fluid
   {
   public:
     friend FSI<dim>;
+    friend KernelBenchmark<dim>;
 
     SCnsIM(Triangulation<dim> &,
            const Parameters::AllParameters &,
@@ -51,6 +55,7 @@ namespace Fluid
     void run() override;
 
   private:
+    template <typename number>
     class BlockIncompSchurPreconditioner;
 
     using FluidSolver<dim>::setup_dofs;
@@ -104,9 +109,11 @@ namespace Fluid
      *
      *  After solving the linear system, the same AffineConstraints<double> as
      * used in assembly must be used again, to set the solution to the right
-     * value at the constrained dofs.
+     * value at the constrained dofs. The residual is reduced by the relative
+     * tolerance.
      */
-    std::pair<unsigned int, double> solve(const bool use_nonzero_constraints);
+    std::pair<unsigned int, double> solve(const bool use_nonzero_constraints,
+                                          const double relative_tolerance);
 
     /*! \brief Run the simulation for one time step.
      *
@@ -134,8 +141,14 @@ namespace Fluid
      */
     BlockVector<double> evaluation_point;
 
-    /// The BlockIncompSchurPreconditioner for the entire system.
-    std::shared_ptr<BlockIncompSchurPreconditioner> preconditioner;
+    /// The BlockIncompSchurPreconditioner for the entire system, with the
+    /// inner solves in double or in single precision.
+    std::shared_ptr<BlockIncompSchurPreconditioner<double>> preconditioner;
+    std::shared_ptr<BlockIncompSchurPreconditioner<float>>
+      single_preconditioner;
+
+    /// The number of inner Tpp iterations in the last solve.
+    int inner_iterations;
 
     /** \brief sigma_pml_field
      * the sigma_pml_field is predefined outside the class. It specifies
@@ -161,7 +174,13 @@ namespace Fluid
      * T. Washio et al., A robust preconditioner for fluid–structure
      * interaction problems, Comput. Methods Appl. Mech. Engrg.
      * 194 (2005) 4027–4047
+     *
+     * The ILU factors and the blocks used by the inner solves are stored with
+     * the number type, the vectors are always in double. Since the inner
+     * solves are only approximate, float halves the memory traffic of the
+     * matrices without changing the convergence of the outer solver much.
      */
+    template <typename number>
     class BlockIncompSchurPreconditioner : public Subscriptor
     {
     public:
@@ -199,38 +218,30 @@ namespace Fluid
       const SmartPointer<const BlockSparseMatrix<double>> system_matrix;
       const SmartPointer<SparseMatrix<double>> schur_matrix;
       const SmartPointer<SparseMatrix<double>> B2pp_matrix;
-      SparseILU<double> Pvv_inverse;
-      SparseILU<double> B2pp_inverse;
+      SparseILU<number> Pvv_inverse;
+      SparseILU<number> B2pp_inverse;
+      /// Copies of Avp, Apv and App, only filled if number is not double.
+      SparseMatrix<number> Avp_copy, Apv_copy, App_copy;
+      /// The blocks in the precision of the inner solves.
+      const SparseMatrix<number> *inner_Avp, *inner_Apv, *inner_App;
       std::shared_ptr<SchurComplementTpp> Tpp;
       mutable int Tpp_itr; // iteration counter for solving Tpp
       class SchurComplementTpp : public Subscriptor
       {
       public:
         SchurComplementTpp(TimerOutput &timer,
-                           const BlockSparseMatrix<double> &system,
-                           const SparseILU<double> &Pvvinv);
+                           const SparseMatrix<number> &Avp,
+                           const SparseMatrix<number> &Apv,
+                           const SparseMatrix<number> &App,
+                           const SparseILU<number> &Pvvinv);
         void vmult(Vector<double> &dst, const Vector<double> &src) const;
-        const SparseMatrix<double> &Avv() const
-        {
-          return system_matrix->block(0, 0);
-        }
-        const SparseMatrix<double> &Avp() const
-        {
-          return system_matrix->block(0, 1);
-        }
-        const SparseMatrix<double> &Apv() const
-        {
-          return system_matrix->block(1, 0);
-        }
-        const SparseMatrix<double> &App() const
-        {
-          return system_matrix->block(1, 1);
-        }
 
       private:
         TimerOutput &timer;
-        const SmartPointer<const BlockSparseMatrix<double>> system_matrix;
-        const SmartPointer<const SparseILU<double>> Pvv_inverse;
+        const SmartPointer<const SparseMatrix<number>> Avp;
+        const SmartPointer<const SparseMatrix<number>> Apv;
+        const SmartPointer<const SparseMatrix<number>> App;
+        const SmartPointer<const SparseILU<number>> Pvv_inverse;
       };
     };
   };
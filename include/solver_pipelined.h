@@ -0,0 +1,148 @@
+#ifndef SOLVER_PIPELINED
+#define SOLVER_PIPELINED
+
+#include <deal.II/base/index_set.h>
+#include <deal.II/lac/exceptions.h>
+#include <deal.II/lac/petsc_matrix_free.h>
+#include <deal.II/lac/petsc_solver.h>
+#include <deal.II/lac/petsc_vector.h>
+#include <petscconf.h>
+#include <petscksp.h>
+
+using namespace dealii;
+
+/*! \brief Pipelined GMRES of PETSc.
+ *
+ * Every iteration posts a single non-blocking reduction for the
+ * orthogonalization and the norm, which is overlapped with the matrix-vector
+ * product and the preconditioner of the next iteration. The iteration is
+ * right preconditioned, so that the residual is that of the unpreconditioned
+ * system. Like SolverPipeCG, it starts from the given initial guess, which
+ * the callers set to zero when the solve is part of a preconditioner.
+ */
+class SolverPGMRES : public PETScWrappers::SolverBase
+{
+public:
+  /**
+   * Standardized data struct to pipe additional data to the solver.
+   */
+  struct AdditionalData
+  {
+    /**
+     * Constructor. By default, set the number of temporary vectors to 30,
+     * i.e. do a restart every 30 iterations.
+     */
+    AdditionalData(const unsigned int restart_parameter = 30);
+
+    /**
+     * Maximum number of tmp vectors.
+     */
+    unsigned int restart_parameter;
+  };
+
+  SolverPGMRES(SolverControl &cn,
+               const MPI_Comm &mpi_communicator,
+               const AdditionalData &data = AdditionalData());
+
+protected:
+  /**
+   * Store a copy of the flags for this particular solver.
+   */
+  const AdditionalData additional_data;
+
+  virtual void set_solver_type(KSP &ksp) const override;
+};
+
+/*! \brief Pipelined CG of PETSc.
+ *
+ * The two reductions of an iteration are combined into one non-blocking
+ * reduction, which is overlapped with the matrix-vector product and the
+ * preconditioner. Like SolverPGMRES, it starts from the given initial guess,
+ * which the callers set to zero when the solve is part of a preconditioner.
+ */
+class SolverPipeCG : public PETScWrappers::SolverBase
+{
+public:
+  /**
+   * Standardized data struct to pipe additional data to the solver.
+   */
+  struct AdditionalData
+  {
+  };
+
+  SolverPipeCG(SolverControl &cn,
+               const MPI_Comm &mpi_communicator,
+               const AdditionalData &data = AdditionalData());
+
+protected:
+  /**
+   * Store a copy of the flags for this particular solver.
+   */
+  const AdditionalData additional_data;
+
+  virtual void set_solver_type(KSP &ksp) const override;
+};
+
+/*! \brief A PETSc shell matrix that applies an operator on PETSc vectors,
+ * so that it can be solved by the PETSc solvers.
+ *
+ * The operator works on PETScWrappers::MPI::Vector, so every product goes
+ * through two buffers with the given layout.
+ */
+template <typename OperatorType>
+class ShellMatrix : public PETScWrappers::MatrixFree
+{
+public:
+  ShellMatrix(const OperatorType &op,
+              const IndexSet &partitioning,
+              const MPI_Comm &mpi_communicator)
+    : PETScWrappers::MatrixFree(mpi_communicator,
+                                partitioning.size(),
+                                partitioning.size(),
+                                partitioning.n_elements(),
+                                partitioning.n_elements()),
+      op(op),
+      src_buffer(partitioning, mpi_communicator),
+      dst_buffer(partitioning, mpi_communicator)
+  {
+  }
+
+  void vmult(PETScWrappers::VectorBase &dst,
+             const PETScWrappers::VectorBase &src) const override
+  {
+    PetscErrorCode ierr = VecCopy(src, src_buffer);
+    AssertThrow(ierr == 0, ExcPETScError(ierr));
+    op.vmult(dst_buffer, src_buffer);
+    ierr = VecCopy(dst_buffer, dst);
+    AssertThrow(ierr == 0, ExcPETScError(ierr));
+  }
+
+  void vmult_add(PETScWrappers::VectorBase &dst,
+                 const PETScWrappers::VectorBase &src) const override
+  {
+    PetscErrorCode ierr = VecCopy(src, src_buffer);
+    AssertThrow(ierr == 0, ExcPETScError(ierr));
+    op.vmult(dst_buffer, src_buffer);
+    ierr = VecAXPY(dst, 1.0, dst_buffer);
+    AssertThrow(ierr == 0, ExcPETScError(ierr));
+  }
+
+  void Tvmult(PETScWrappers::VectorBase &,
+              const PETScWrappers::VectorBase &) const override
+  {
+    AssertThrow(false, ExcNotImplemented());
+  }
+
+  void Tvmult_add(PETScWrappers::VectorBase &,
+                  const PETScWrappers::VectorBase &) const override
+  {
+    AssertThrow(false, ExcNotImplemented());
+  }
+
+private:
+  const OperatorType &op;
+  mutable PETScWrappers::MPI::Vector src_buffer;
+  mutable PETScWrappers::MPI::Vector dst_buffer;
+};
+
+#endif
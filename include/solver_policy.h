@@ -0,0 +1,83 @@
+#ifndef SOLVER_POLICY
+#define SOLVER_POLICY
+
+#include <deal.II/base/types.h>
+
+#include <string>
+#include <vector>
+
+using namespace dealii;
+
+/*! \brief Automatic choice of a linear solver from a list of candidates.
+ *
+ * The candidates are ordered from the cheapest to the most scalable one,
+ * and each of them is used up to a problem size and a number of processes.
+ * select() takes the first candidate the problem fits, it is called
+ * whenever the system is set up again, e.g. after a refinement. record()
+ * takes the next candidate once a solve needs more iterations than the
+ * limit, and fail() once a solve does not converge, which holds until the
+ * next select(). A direct candidate is only left for the size limits, its
+ * iterations say nothing about the successors. A solver other than Auto
+ * that is requested in the parameters is always the choice.
+ */
+class SolverPolicy
+{
+public:
+  struct Candidate
+  {
+    std::string name;
+    /// The largest number of dofs in 2D and in 3D to use the candidate for.
+    types::global_dof_index max_dofs_2d;
+    types::global_dof_index max_dofs_3d;
+    /// The largest number of processes, 0 means no limit.
+    unsigned int max_processes;
+    /// Whether the candidate is a direct solver.
+    bool direct;
+  };
+
+  SolverPolicy(const std::string &requested,
+               const std::vector<Candidate> &candidates,
+               const unsigned int max_iterations);
+
+  /// Choose the candidate for the problem size, return whether the choice
+  /// has changed.
+  bool select(const types::global_dof_index n_dofs,
+              const unsigned int dim,
+              const unsigned int n_processes);
+
+  /// Take the iterations of a solve into account, return whether the
+  /// choice has changed.
+  bool record(const unsigned int iterations);
+
+  /// Take a solve that did not converge into account, return whether the
+  /// choice has changed, i.e. whether the solve is worth repeating.
+  bool fail();
+
+  const std::string &get() const { return choice; }
+
+  bool automatic() const { return requested == "Auto"; }
+
+  /// MUMPS for small problems, otherwise a BoomerAMG V-cycle, or GMRES
+  /// preconditioned by BoomerAMG if that needs too many outer iterations.
+  /// The iterations only move the choice from the V-cycle to GMRES.
+  static SolverPolicy velocity_solver(const std::string &requested);
+
+  /// Euclid for small problems on few processes, BoomerAMG otherwise, or
+  /// once the Tpp solves need too many iterations.
+  static SolverPolicy pressure_preconditioner(const std::string &requested);
+
+  /// Plain CG for tiny solids, MUMPS for small ones and BoomerAMG for the
+  /// rest. The iterations only move the choice from plain CG to MUMPS.
+  static SolverPolicy solid_preconditioner(const std::string &requested);
+
+private:
+  const std::string requested;
+  const std::vector<Candidate> candidates;
+  const unsigned int max_iterations;
+  /// The candidate for the problem size and the current one.
+  unsigned int first;
+  unsigned int current;
+  std::string choice;
+};
+
+#endif
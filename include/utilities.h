@@ -1,6 +1,12 @@
 #ifndef UTILITIES
 #define UTILITIES
 
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/timer.h>
+#include <deal.II/distributed/tria_base.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_tools.h>
 #include <deal.II/fe/fe_values.h>
 #include <deal.II/grid/grid_generator.h>
 #include <deal.II/grid/grid_refinement.h>
@@ -10,11 +16,33 @@
 #include <deal.II/grid/tria_accessor.h>
 #include <deal.II/grid/tria_iterator.h>
 #include <deal.II/lac/block_vector.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/la_parallel_block_vector.h>
+#include <deal.II/lac/petsc_block_sparse_matrix.h>
 #include <deal.II/lac/petsc_block_vector.h>
+#include <deal.II/lac/petsc_matrix_base.h>
+#include <deal.II/lac/petsc_vector.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/numerics/data_out.h>
 #include <deal.II/numerics/vector_tools.h>
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <queue>
-#include <unordered_set>
+#include <sstream>
+#include <thread>
+#include <tuple>
 
 namespace Utils
 {
@@ -31,6 +59,7 @@ namespace Utils
          const double save_interval)
       : timestep(0),
         time_current(0.0),
+        time_previous(0.0),
         delta_t(delta_t),
         time_end(time_end),
         output_interval(output_interval),
@@ -39,6 +68,7 @@ namespace Utils
     {
     }
     double current() const { return time_current; }
+    double previous() const { return time_previous; }
     double end() const { return time_end; }
     double get_delta_t() const { return delta_t; }
     unsigned int get_timestep() const { return timestep; }
@@ -48,9 +78,38 @@ namespace Utils
     void increment();
     void set_delta_t(double delta);
 
+    /**
+     * Write the current time step and time together with the records of
+     * the pvd file, so that a restart does not have to replay all the time
+     * steps to rebuild them.
+     */
+    void save_restart_record(
+      const std::string &file,
+      const std::vector<std::pair<double, std::string>> &times_and_names) const;
+
+    /// Continue from the time step of another solver.
+    void restore(const Time &other)
+    {
+      timestep = other.timestep;
+      time_current = other.time_current;
+      time_previous = other.time_previous;
+      delta_t = other.delta_t;
+    }
+
+    /// Continue from a record written by save_restart_record.
+    void load_restart_record(
+      const std::string &file,
+      std::vector<std::pair<double, std::string>> &times_and_names);
+
   private:
+    /// Whether the last time step has passed a multiple of the interval.
+    /// The events are in simulated time, so they still apply when the time
+    /// step changes.
+    bool passed_multiple_of(const double interval) const;
+
     unsigned int timestep;
     double time_current;
+    double time_previous;
     double delta_t;
     const double time_end;
     const double output_interval;
@@ -58,6 +117,460 @@ namespace Utils
     const double save_interval;
   };
 
+  /*! \brief Choose the time step from the CFL number and the Newton
+   *  iterations of the last time step.
+   *
+   *  Each criterion proposes a time step and the smallest one is taken. A
+   *  criterion whose target is 0 is not used. The time step grows by at most
+   *  a factor of 2 from one step to the next, stays within the bounds, and
+   *  does not step over the end time.
+   */
+  class TimeStepController
+  {
+  public:
+    TimeStepController(const double min_delta_t,
+                       const double max_delta_t,
+                       const double target_cfl,
+                       const unsigned int target_iterations);
+
+    /// The time step to continue with, given the CFL number and the Newton
+    /// iterations of the last time step. 0 means unknown.
+    double propose(const Time &time,
+                   const double cfl,
+                   const unsigned int iterations) const;
+
+  private:
+    const double min_delta_t;
+    const double max_delta_t;
+    const double target_cfl;
+    const unsigned int target_iterations;
+  };
+
+  /*! \brief Relative tolerances of the linear solves in a Newton loop.
+   *
+   *  Without the inexact Newton method every linear solve uses the fixed
+   *  tolerance. Otherwise the first solve of a Newton loop uses the maximum
+   *  tolerance, and the next ones the second choice of Eisenstat and Walker,
+   *  \f$ \eta_k = \gamma (\|F_k\| / \|F_{k-1}\|)^2 \f$ with
+   *  \f$ \gamma = 0.9 \f$. It is not allowed to drop below
+   *  \f$ \gamma \eta_{k-1}^2 \f$ when that is larger than 0.1, and stays
+   *  between the fixed and the maximum tolerance. A new object is used for
+   *  every Newton loop.
+   */
+  class ForcingTerm
+  {
+  public:
+    ForcingTerm(const double fixed_tolerance,
+                const bool adaptive,
+                const double max_tolerance);
+
+    /// The relative tolerance of the next linear solve, given the norm of
+    /// the current nonlinear residual.
+    double next(const double residual);
+
+  private:
+    const double fixed_tolerance;
+    const bool adaptive;
+    const double max_tolerance;
+    double previous_residual;
+    double previous_tolerance;
+  };
+
+  /*! \brief Acceleration of the fixed point iterations of a strongly coupled
+   *  time step.
+   *
+   *  One coupling iteration maps the interface data x to \f$ \tilde{x} =
+   *  F(x) \f$, and \f$ r = \tilde{x} - x \f$ is its residual. Aitken
+   *  relaxation takes \f$ x + \omega_k r_k \f$ with
+   *  \f$ \omega_k = -\omega_{k-1} r_{k-1}^T (r_k - r_{k-1}) /
+   *  \|r_k - r_{k-1}\|^2 \f$. IQN-ILS builds the differences of the
+   *  residuals (V) and of the outputs (W) of the earlier iterations of the
+   *  step, and takes \f$ \tilde{x}_k + W c \f$ with the least squares
+   *  solution of \f$ V c = -r_k \f$. The columns of V that are close to
+   *  linearly dependent on the newer ones are dropped. Every time step needs
+   *  a new accelerator, whose first iteration is relaxed with the initial
+   *  factor. The vectors must be the same on every process, nothing is
+   *  communicated.
+   */
+  class InterfaceAccelerator
+  {
+  public:
+    /// The method is Aitken or IQN-ILS.
+    InterfaceAccelerator(const std::string &method,
+                         const double initial_relaxation);
+
+    /// Replace x by the next iterate, given the output of the iteration
+    /// with x.
+    void next(Vector<double> &x, const Vector<double> &output);
+
+  private:
+    const bool quasi_newton;
+    double relaxation;
+    Vector<double> previous_residual;
+    Vector<double> previous_output;
+    /// The columns of V and W, the latest first.
+    std::vector<Vector<double>> residual_differences;
+    std::vector<Vector<double>> output_differences;
+  };
+
+  /*! \brief Fused Newmark-beta updates of the solid state.
+   *
+   *  With the state \f$(d_n, v_n, a_n)\f$ of the previous time step and the
+   *  predictor \f$ \tilde{d} = d_n + \Delta{t}v_n +
+   *  (\frac{1}{2}-\beta)\Delta{t}^2a_n \f$, the new state satisfies
+   *  \f$ d_{n+1} = \tilde{d} + \beta\Delta{t}^2a_{n+1} \f$ and
+   *  \f$ v_{n+1} = v_n + (1-\gamma)\Delta{t}a_n + \gamma\Delta{t}a_{n+1} \f$.
+   *  Every function makes a single pass over the locally owned entries of
+   *  the vectors, which must have the same layout and no ghost entries.
+   */
+  class Newmark
+  {
+  public:
+    using VectorType = PETScWrappers::MPI::Vector;
+
+    Newmark(const double delta_t, const double gamma, const double beta);
+
+    /// The predictor of the displacement.
+    void predict(const VectorType &previous_displacement,
+                 const VectorType &previous_velocity,
+                 const VectorType &previous_acceleration,
+                 VectorType &predicted_displacement) const;
+
+    /// The acceleration and the velocity of a displacement, e.g. in a
+    /// Newton iteration.
+    void update(const VectorType &predicted_displacement,
+                const VectorType &previous_velocity,
+                const VectorType &previous_acceleration,
+                const VectorType &displacement,
+                VectorType &acceleration,
+                VectorType &velocity) const;
+
+    /// Complete the time step from the solved acceleration: compute the
+    /// velocity and the displacement, and store the new state as the
+    /// previous one.
+    void advance_from_acceleration(const VectorType &predicted_displacement,
+                                   const VectorType &acceleration,
+                                   VectorType &velocity,
+                                   VectorType &displacement,
+                                   VectorType &previous_displacement,
+                                   VectorType &previous_velocity,
+                                   VectorType &previous_acceleration) const;
+
+    /// Complete the time step from the solved displacement: compute the
+    /// acceleration and the velocity, and store the new state as the
+    /// previous one.
+    void advance_from_displacement(const VectorType &predicted_displacement,
+                                   const VectorType &displacement,
+                                   VectorType &acceleration,
+                                   VectorType &velocity,
+                                   VectorType &previous_displacement,
+                                   VectorType &previous_velocity,
+                                   VectorType &previous_acceleration) const;
+
+  private:
+    const double delta_t;
+    const double gamma;
+    const double beta;
+  };
+
+  /*! \brief A TimerOutput::Scope that also marks the section as a
+   *  profiler region.
+   *
+   *  If OpenIFEM is configured with OPENIFEM_WITH_LIKWID, the section is a
+   *  LIKWID marker region of the same name, with the spaces replaced by
+   *  underscores. Running under likwid-perfctr -m then reports the hardware
+   *  counters of every timer section per process, e.g. the flops with the
+   *  FLOPS_DP group and the memory traffic with the MEM group. Otherwise it
+   *  only times the section.
+   */
+  class ProfilingScope
+  {
+  public:
+    ProfilingScope(TimerOutput &timer, const std::string &section);
+    ~ProfilingScope();
+
+  private:
+    TimerOutput::Scope scope;
+    std::string region;
+  };
+
+  /*! \brief Per time step performance counters of the simulation phases.
+   *
+   * Each phase, identified by its name, accumulates the wall time, the time
+   * spent in communication, the number of solver iterations, point location
+   * hits and misses, and the bytes exchanged. write() reduces the counters
+   * over all processes, appends one line per phase to a CSV file, and resets
+   * them. A phase that only some processes run counts as zero on the others.
+   * Nothing is recorded until open() is called.
+   */
+  class PerformanceCounters
+  {
+  public:
+    struct Record
+    {
+      double wall_time = 0;
+      double mpi_time = 0;
+      double iterations = 0;
+      double hits = 0;
+      double misses = 0;
+      double bytes = 0;
+    };
+
+    /// Measure the wall time of a phase during the lifetime of this object.
+    class Scope
+    {
+    public:
+      Scope(PerformanceCounters &, const std::string &);
+      ~Scope();
+
+    private:
+      PerformanceCounters &counters;
+      const std::string phase;
+      const std::chrono::steady_clock::time_point start;
+    };
+
+    PerformanceCounters(const MPI_Comm &);
+    /// Open the output file, only rank 0 writes to it.
+    void open(const std::string &);
+    bool active() const { return is_active; }
+    /// Access the counters of a phase.
+    Record &operator[](const std::string &);
+    /// Write the counters of the current time step and reset them.
+    void write(const unsigned int, const double);
+
+  private:
+    MPI_Comm mpi_communicator;
+    bool is_active;
+    std::map<std::string, Record> records;
+    std::ofstream file;
+  };
+
+  /*! \brief Memory accounting of a solver, broken down by subsystem.
+   *
+   * The solvers add the local bytes of their matrices, vectors and cell data
+   * to named subsystems, and print() reduces every subsystem over the
+   * processes and prints the minimum, average and maximum per process, with
+   * the rank of the maximum. The PETSc matrices are measured with MatGetInfo,
+   * which includes the preallocated entries, everything else with
+   * memory_consumption(). Every process must add the same subsystems in the
+   * same order.
+   */
+  class MemoryReport
+  {
+  public:
+    MemoryReport(const MPI_Comm &);
+    /// Add bytes to a subsystem, which is created at the first call.
+    void add(const std::string &, const double);
+    /// Add the local memory of a PETSc matrix to a subsystem.
+    void add(const std::string &, const PETScWrappers::MatrixBase &);
+    void add(const std::string &,
+             const PETScWrappers::MPI::BlockSparseMatrix &);
+    /// Print the subsystems in MB under the title and clear them. Collective,
+    /// only rank 0 writes to the stream.
+    void print(std::ostream &, const std::string &);
+
+    /// The current resident set size of this process in bytes.
+    static double resident_memory();
+    /// The peak resident set size of this process in bytes.
+    static double peak_resident_memory();
+    /// Print the minimum, average and maximum peak resident set size of the
+    /// processes. Collective, only rank 0 writes to the stream.
+    static void print_peak_memory(std::ostream &,
+                                  const MPI_Comm &,
+                                  const std::string &);
+
+  private:
+    MPI_Comm mpi_communicator;
+    std::vector<std::pair<std::string, double>> subsystems;
+  };
+
+  /// An estimate of the memory of a CellDataStorage, which does not provide
+  /// memory_consumption(), with n_data objects on each of n_cells cells:
+  /// every cell has a map node and a vector of shared pointers, and every
+  /// object is allocated together with its control block.
+  template <typename DataType>
+  double cell_data_memory(const unsigned int n_cells,
+                          const unsigned int n_data)
+  {
+    const double per_cell =
+      4 * sizeof(void *) + sizeof(std::vector<std::shared_ptr<DataType>>);
+    const double per_object = sizeof(DataType) +
+                              sizeof(std::shared_ptr<DataType>) +
+                              2 * sizeof(long);
+    return n_cells * (per_cell + n_data * per_object);
+  }
+
+  /*! \brief Compress the values of a checkpoint losslessly.
+   *
+   * The bytes of the values are shuffled so that the bytes of the same
+   * significance are contiguous, like the shuffle filter of blosc, and then
+   * deflated with the zlib of deal.II, which leaves them uncompressed if it
+   * is configured without zlib. With a reference of the same size, the
+   * bitwise XOR with it is stored instead, whose leading bytes are zero
+   * wherever a value has changed little since the reference.
+   */
+  std::string encode_values(const std::vector<double> &values,
+                            const std::vector<double> *reference = nullptr);
+
+  /// Decode the values written by encode_values with the same reference.
+  void decode_values(const std::string &data,
+                     std::vector<double> &values,
+                     const std::vector<double> *reference = nullptr);
+
+  /*! \brief The checkpoints to remove from a set of saved ones.
+   *
+   * The latest n_kept checkpoints and those they are the differences to
+   * are kept. The checkpoints are given by their time steps, and key_of
+   * gives the time step of the checkpoint that a checkpoint is the
+   * difference to, or -1 if it is complete.
+   */
+  std::vector<int> stale_checkpoints(std::vector<int> steps,
+                                     const unsigned int n_kept,
+                                     const std::function<int(int)> &key_of);
+
+  /*! \brief Replace the zero diagonal entries of a symmetric matrix.
+   *
+   * The rows of the constrained dofs of a Galerkin product such as
+   * \f$BM^{-1}B^T\f$ are zero, which leaves the matrix singular and breaks
+   * ILU and AMG. Their diagonal entries are set to the mean magnitude of the
+   * other diagonal entries, which decouples them without changing the
+   * scaling of the matrix. The diagonal must be in the sparsity pattern.
+   */
+  void fill_zero_diagonal(PETScWrappers::MatrixBase &matrix);
+
+  /*! \brief The velocity dofs of a fluid cell that FSI constrains.
+   *
+   * The indices within the cell of the velocity dofs whose support points
+   * are on one of the faces of the unit cell through the origin, which the
+   * Dirichlet BCs of the artificial fluid are evaluated at. The pressure is
+   * the second base element of the fluid element.
+   */
+  template <int dim>
+  std::vector<unsigned int>
+  fsi_velocity_dofs(const FiniteElement<dim> &fluid_fe);
+
+  /*! \brief Run independent cases in groups of processes.
+   *
+   * The processes of the communicator are split into groups of consecutive
+   * ranks. Case c is run by group c % n_groups() on the communicator of the
+   * group, so the solvers of a case only synchronize within their group.
+   * Pass get_communicator() to the triangulations and the shared solid
+   * solvers of a case. The results of all the cases are collected into one
+   * file by write_results().
+   */
+  class Ensemble
+  {
+  public:
+    /// The number of groups is limited to the number of processes.
+    Ensemble(const MPI_Comm &, const unsigned int n_groups);
+    ~Ensemble();
+    Ensemble(const Ensemble &) = delete;
+    Ensemble &operator=(const Ensemble &) = delete;
+    const MPI_Comm &get_communicator() const { return group_communicator; }
+    unsigned int get_group() const { return group; }
+    unsigned int n_groups() const { return groups; }
+    /// The cases run by this group, in increasing order.
+    std::vector<unsigned int> local_cases(const unsigned int n_cases) const;
+    /// Store the results of a case, only the first process of the group
+    /// keeps them.
+    void add_result(const unsigned int, const std::vector<double> &);
+    /// Collect the results of all the groups and write one line per case to
+    /// a CSV file. Collective on the whole communicator, only rank 0 writes.
+    void write_results(const std::string &filename,
+                       const std::vector<std::string> &columns) const;
+
+  private:
+    MPI_Comm mpi_communicator;
+    MPI_Comm group_communicator;
+    unsigned int groups;
+    unsigned int group;
+    std::map<unsigned int, std::vector<double>> results;
+  };
+
+  /*! \brief The processes that solve the solid of an FSI simulation.
+   *
+   * The first n_solid processes of the communicator form the solid group,
+   * every other process gets a communicator of its own, on which its copy
+   * of the solid is a serial one. Pass get_communicator() to the shared
+   * solid solver, and the same number to FSI as the solid processes. 0 or
+   * at least the number of processes puts all of them into the group.
+   */
+  class SolidGroup
+  {
+  public:
+    SolidGroup(const MPI_Comm &, const unsigned int n_solid);
+    ~SolidGroup();
+    SolidGroup(const SolidGroup &) = delete;
+    SolidGroup &operator=(const SolidGroup &) = delete;
+    const MPI_Comm &get_communicator() const { return solid_communicator; }
+    /// Whether this process is in the solid group.
+    bool owns_solid() const { return in_group; }
+
+  private:
+    MPI_Comm solid_communicator;
+    bool in_group;
+  };
+
+  /*! \brief A localized copy of a distributed vector, stored once per node.
+   *
+   * The copy lives in an MPI-3 shared memory window of the processes on the
+   * same node, allocated by the first of them (the node leader). To
+   * localize a vector, every process writes the entries it owns into the
+   * copy of its node, and the leaders sum up the copies of all the nodes, so
+   * that only one process per node takes part in the collective across the
+   * nodes. The copy is read-only between two calls to localize(). The
+   * window can also hold an array that is the same on all processes
+   * without a distributed vector: after resize() every process of a node
+   * writes its share() of the entries, and synchronize() makes them visible
+   * to the others.
+   */
+  class NodeSharedVector
+  {
+  public:
+    NodeSharedVector(const MPI_Comm &);
+    ~NodeSharedVector();
+    NodeSharedVector(const NodeSharedVector &) = delete;
+    NodeSharedVector &operator=(const NodeSharedVector &) = delete;
+
+    /// Collective on the communicator. The window is allocated again when
+    /// the size of the vector changes.
+    void localize(const PETScWrappers::MPI::Vector &);
+
+    /// Allocate the window for a number of entries if the size changes,
+    /// collective on the communicator.
+    void resize(const std::size_t);
+
+    /// The range of the entries that this process writes, the processes of
+    /// a node split them evenly.
+    std::pair<std::size_t, std::size_t> share() const;
+
+    /// Wait until all processes of the node have written their shares,
+    /// collective on the node.
+    void synchronize();
+
+    double *data() { return values; }
+    const double *data() const { return values; }
+    double operator()(const types::global_dof_index i) const
+    {
+      return values[i];
+    }
+    std::size_t size() const { return n_elements; }
+
+    /// The memory of this process, which is zero except on the leaders.
+    std::size_t memory_consumption() const;
+
+  private:
+    void reinit(const std::size_t);
+    void free_window();
+
+    MPI_Comm node_communicator;
+    /// The node leaders, MPI_COMM_NULL on the other processes.
+    MPI_Comm leader_communicator;
+    MPI_Win window;
+    double *values;
+    std::size_t n_elements;
+  };
+
   /*! \brief A helper class to generate triangulations and specify boundary ids.
    *
    *  dealii::GridGenerator can be used to generate a few standard grids such as
@@ -96,10 +609,30 @@ namespace Utils
                          const double radius,
                          const double length);
 
+    /*! \brief Generate a coarse mesh on the first process only.
+     *
+     *  If the triangulation is a parallel one, the generator is only called
+     *  on the first process of its communicator, with a serial
+     *  triangulation. The vertices and cells of the coarse mesh, and their
+     *  boundary and manifold ids, are broadcast and every process creates
+     *  the triangulation from them directly, so that the cell removals,
+     *  extrusions and merges of the generators are not repeated on every
+     *  process. The manifold objects are not copied, returns true if they
+     *  have to be attached again. A serial triangulation is passed to the
+     *  generator as is.
+     */
+    static bool
+    create_on_root(Triangulation<dim> &,
+                   const std::function<void(Triangulation<dim> &)> &);
+
   private:
     /// A helper function used by flow_around_cylinder.
     static void flow_around_cylinder_2d(Triangulation<2> &,
                                         bool compute_in_2d = true);
+
+    /// Attach the manifolds of the cylindrical hole created by
+    /// flow_around_cylinder_2d.
+    static void set_cylinder_hole_manifolds(Triangulation<2> &);
   };
 
   /*! \brief Interpolate the solution value or gradient at an arbitrary point.
@@ -142,11 +675,174 @@ namespace Utils
       cell_point;
   };
 
+  /*! \brief Interpolate the solution value and gradient at many points in
+   * the same cell at once.
+   *
+   * GridInterpolator creates an FEValues object for every point and every
+   * call. This class evaluates the shape functions of the finite element
+   * directly at the unit points, and the dof values of the cell are only
+   * read once for all of the points. The buffers are kept between calls, so
+   * one object should be reused for all the points of a search. The cell
+   * must be locally owned and all of the points must be inside it.
+   */
+  template <int dim, typename VectorType>
+  class CellPointInterpolator
+  {
+  public:
+    typedef typename VectorType::value_type Number;
+
+    CellPointInterpolator(const DoFHandler<dim> &);
+    /// Evaluate the values and gradients of all the components of the
+    /// function at the points.
+    void evaluate(const typename DoFHandler<dim>::active_cell_iterator &,
+                  const std::vector<Point<dim>> &,
+                  const VectorType &);
+    /// Value of a component at a point of the last evaluation.
+    Number value(const unsigned int point, const unsigned int component) const
+    {
+      return values[point * n_components + component];
+    }
+    /// Gradient of a component at a point of the last evaluation.
+    const Tensor<1, dim, Number> &gradient(const unsigned int point,
+                                          const unsigned int component) const
+    {
+      return gradients[point * n_components + component];
+    }
+
+  private:
+    const DoFHandler<dim> &dof_handler;
+    const unsigned int n_components;
+    MappingQ1<dim> mapping;
+    Vector<Number> local_values;
+    std::vector<Number> values;
+    std::vector<Tensor<1, dim, Number>> gradients;
+  };
+
+  /*! \brief Time series of the solution at a few points.
+   *
+   * The points are located once, and again only after reset() is called
+   * because the mesh has changed. Every sample evaluates all of the
+   * components at the points in the cells of this process, i.e. the cells
+   * whose subdomain id is the rank, and sums them over the processes in a
+   * single reduction. A point on the boundary of several subdomains takes
+   * the average, a point outside of the mesh is 0. Rank 0 appends the time
+   * and the values of every point to a CSV file. Nothing is sampled until
+   * open() is called. The vector must have the ghost entries of the cells of
+   * this process.
+   */
+  template <int dim, typename VectorType>
+  class Probes
+  {
+  public:
+    Probes(const DoFHandler<dim> &, const MPI_Comm &);
+    /// Open the output file with the coordinates of the points, only rank 0
+    /// writes to it. The columns are named after the point and the component.
+    void open(const std::string &,
+              const std::vector<std::vector<double>> &,
+              const std::vector<std::string> &component_names);
+    bool active() const { return !points.empty(); }
+    /// Locate the points again at the next sample.
+    void reset() { located = false; }
+    /// Write the values of the vector at the points, the file is flushed if
+    /// requested, e.g. at the output steps.
+    void sample(const VectorType &, const double time, const bool flush);
+    /// Keep the samples from now on until they are written by commit() or
+    /// dropped by discard(), e.g. in the coupling iterations of a time step.
+    void hold() { holding = true; }
+    void discard() { held_rows.clear(); }
+    void commit();
+
+  private:
+    void locate();
+
+    const DoFHandler<dim> &dof_handler;
+    MPI_Comm mpi_communicator;
+    std::vector<Point<dim>> points;
+    bool located;
+    bool holding;
+    std::string held_rows;
+    /// The cells of this process that contain a point, and the point.
+    std::vector<std::pair<typename DoFHandler<dim>::active_cell_iterator,
+                          unsigned int>>
+      cell_points;
+    CellPointInterpolator<dim, VectorType> interpolator;
+    std::ofstream file;
+  };
+
+  /*! \brief A cell-linked list over the centers of the locally owned active
+   * cells.
+   *
+   * The cell centers are sorted into a uniform grid of bins whose size is at
+   * least the largest kernel support radius, 2 times the cell diameter. All
+   * the cells whose kernel can reach a point are therefore in the 3^dim bins
+   * around it, which makes a query independent of the size of the mesh.
+   * Call rebuild() whenever the mesh has moved, i.e. once per time step.
+   */
+  template <int dim, typename MeshType>
+  class CellLinkedList
+  {
+  public:
+    CellLinkedList(const MeshType &);
+    /// Sort the cells into the bins with the current vertex positions.
+    void rebuild();
+    /// Collect the cells in the bins around the point, a superset of the
+    /// cells whose kernel support contains it.
+    void query(const Point<dim> &,
+               std::vector<typename MeshType::active_cell_iterator> &) const;
+    bool empty() const { return cells.empty(); }
+
+  private:
+    /// The bin of a point in every direction, clamped to the grid.
+    std::array<int, dim> bin_index(const Point<dim> &) const;
+
+    const MeshType &mesh;
+    Point<dim> lower;
+    double bin_size;
+    std::array<int, dim> n_bins;
+    /// The first cell of every bin, -1 if the bin is empty.
+    std::vector<int> head;
+    /// The next cell in the same bin, -1 for the last one.
+    std::vector<int> next;
+    std::vector<typename MeshType::active_cell_iterator> cells;
+  };
+
+  /*! \brief A uniform grid of bins over a set of points.
+   *
+   * Answers whether any of the points is within a distance of a query
+   * point by only looking at the bins that overlap the ball, which is
+   * independent of the number of points if the radius is not much larger
+   * than the bin size.
+   */
+  template <int dim>
+  class PointBins
+  {
+  public:
+    /// The bins are at least min_bin_size wide, and there are not many more
+    /// bins than points.
+    PointBins(const std::vector<Point<dim>> &, const double min_bin_size);
+    bool any_within(const Point<dim> &, const double radius) const;
+
+  private:
+    std::vector<Point<dim>> points;
+    Point<dim> lower;
+    double bin_size;
+    std::array<int, dim> n_bins;
+    /// The first point of every bin, -1 if the bin is empty.
+    std::vector<int> head;
+    /// The next point in the same bin, -1 for the last one.
+    std::vector<int> next;
+  };
+
   template <int dim, typename VectorType>
   class SPHInterpolator
   {
   public:
     SPHInterpolator(const DoFHandler<dim> &, const Point<dim> &);
+    /// Only look at the candidates of the cell-linked list, which must be
+    /// built on the same DoFHandler.
+    SPHInterpolator(const DoFHandler<dim> &,
+                    const Point<dim> &,
+                    const CellLinkedList<dim, DoFHandler<dim>> &);
     void point_value(const VectorType &,
                      Vector<typename VectorType::value_type> &);
     void point_gradient(
@@ -170,23 +866,558 @@ namespace Utils
     double cubic_spline(const Point<dim> &, const Point<dim> &, double);
   };
 
+  /*! \brief A bounding box hierarchy over the active cells of a mesh.
+   *
+   * The axis-aligned bounding boxes of the active cells are organized in a
+   * binary tree, so that the cells that possibly contain a point can be found
+   * with a few box tests instead of looping over the whole mesh. When the
+   * mesh only deforms, refit() updates the boxes without changing the tree
+   * topology, which is much cheaper than rebuild(). Only the locally relevant
+   * cells of a distributed mesh are in the tree.
+   */
+  template <int dim, typename MeshType>
+  class CellTree
+  {
+  public:
+    CellTree(const MeshType &);
+    /// Build the tree from scratch with the current vertex positions.
+    void rebuild();
+    /// Recompute the boxes with the current vertex positions. The tree is
+    /// rebuilt if the number of active cells has changed.
+    void refit();
+    /// Collect the cells whose bounding boxes contain the point.
+    void query(const Point<dim> &,
+               std::vector<typename MeshType::active_cell_iterator> &) const;
+    /// Return the cell which contains the point, or an invalid iterator.
+    typename MeshType::active_cell_iterator
+    find_cell(const Point<dim> &) const;
+    bool empty() const { return nodes.empty(); }
+
+  private:
+    /// A node is either a leaf that holds cells [begin, end) of the sorted
+    /// cell array, or an interior node with two children.
+    struct Node
+    {
+      Point<dim> lower;
+      Point<dim> upper;
+      int children[2];
+      unsigned int begin;
+      unsigned int end;
+    };
+
+    /// Compute the bounding box of a cell.
+    static void cell_box(const typename MeshType::active_cell_iterator &,
+                         Point<dim> &,
+                         Point<dim> &);
+
+    /// Recursively build the subtree of cells [begin, end).
+    int build(const unsigned int, const unsigned int);
+
+    /// Maximum number of cells in a leaf.
+    static const unsigned int leaf_size = 4;
+
+    const MeshType &mesh;
+    std::vector<Node> nodes;
+    std::vector<typename MeshType::active_cell_iterator> cells;
+    /// Number of active cells of the mesh when the tree was built, which
+    /// includes the artificial cells that are not in the tree.
+    unsigned int n_mesh_cells;
+    std::vector<Point<dim>> cell_lower;
+    std::vector<Point<dim>> cell_upper;
+  };
+
+  /*! \brief Containment of points in a closed triangulated surface in 3D.
+   *
+   * The triangles are stored contiguously in the order of the leaves of a
+   * bounding box hierarchy. A point is inside if a ray from it in the +x
+   * direction crosses the surface an odd number of times, so only the
+   * triangles whose boxes the ray goes through are tested. The crossing test
+   * works on the projection onto the yz plane and resolves the points on an
+   * edge or a vertex of the projection by a symbolic perturbation, so that
+   * every crossing of a watertight surface is counted exactly once. A point
+   * on the surface is inside. The count is only exact if neighboring
+   * triangles share their edges. A hanging node of the solid mesh is in
+   * general not on the edge of the coarse face once the mesh is deformed,
+   * so the surface has a small gap or overlap there, and a ray through it
+   * may be counted twice or not at all. There is no 2D version, FSI keeps
+   * the crossing test of the boundary lines in 2D.
+   */
+  class SurfaceTree
+  {
+  public:
+    /// Take the triangles, three consecutive vertices per triangle. The tree
+    /// is rebuilt if the number of triangles has changed, otherwise only
+    /// the boxes are refitted.
+    void reinit(const std::vector<Point<3>> &);
+    /// Whether the point is enclosed by the surface.
+    bool inside(const Point<3> &) const;
+    /// The containment of many points, which shares the traversal buffer.
+    void inside(const std::vector<Point<3>> &, std::vector<int> &) const;
+    bool empty() const { return nodes.empty(); }
+
+  private:
+    /// A leaf holds the triangles [begin, end), an interior node has two
+    /// children.
+    struct Node
+    {
+      Point<3> lower;
+      Point<3> upper;
+      int children[2];
+      unsigned int begin;
+      unsigned int end;
+    };
+
+    /// Recursively build the subtree of the triangles [begin, end) of order.
+    int build(const unsigned int, const unsigned int);
+
+    /// Recompute the triangle and node boxes.
+    void refit();
+
+    /// Whether the point is inside, with a buffer for the node stack.
+    bool contains(const Point<3> &, std::vector<int> &) const;
+
+    /// Maximum number of triangles in a leaf.
+    static const unsigned int leaf_size = 4;
+
+    std::vector<Node> nodes;
+    /// The vertices of the triangles in the order of the leaves.
+    std::vector<Point<3>> vertices;
+    /// The input triangle of every stored triangle.
+    std::vector<unsigned int> order;
+    std::vector<Point<3>> triangle_lower;
+    std::vector<Point<3>> triangle_upper;
+  };
+
+  /*! \brief Locate the cell that contains a point starting from a hint.
+   *
+   * A breadth first search over the active neighbors of the hint is used,
+   * which is cheap when the point is close to the hint. The visited cells are
+   * marked in a buffer indexed by the active cell index and the search
+   * buffers are kept between calls, so a single locator should be reused for
+   * many points. If the point is not found within max_depth layers of
+   * neighbors, a global search is done instead.
+   */
   template <int dim, typename MeshType>
   class CellLocator
   {
   public:
-    CellLocator(DoFHandler<dim> &,
-                const Point<dim> &,
-                const typename MeshType::active_cell_iterator &);
+    CellLocator(DoFHandler<dim> &, const unsigned int max_depth = 8);
+    /// Use a bounding box tree in the global search instead of a full scan.
+    void set_tree(const CellTree<dim, MeshType> *t) { tree = t; }
     // Use breadth first search from the hint to find and return the iterator
     // of the cell where the point is inside.
-    const typename MeshType::active_cell_iterator search();
+    const typename MeshType::active_cell_iterator
+    search(const Point<dim> &, const typename MeshType::active_cell_iterator &);
     bool found_cell() const { return cell_found; };
 
   private:
+    /// Global search used when the hint is not useful.
+    const typename MeshType::active_cell_iterator
+    global_search(const Point<dim> &);
+
     DoFHandler<dim> &dof_handler;
-    const Point<dim> &point;
-    const typename MeshType::active_cell_iterator hint;
+    const unsigned int max_depth;
     bool cell_found;
+    /// The search id when each active cell was last visited.
+    std::vector<unsigned int> visited;
+    /// The id of the current search, so that visited need not be cleared.
+    unsigned int search_id;
+    /// Current and next layer of the breadth first search.
+    std::vector<typename MeshType::active_cell_iterator> current_layer;
+    std::vector<typename MeshType::active_cell_iterator> next_layer;
+    std::vector<typename MeshType::active_cell_iterator> neighbors;
+    /// Optional tree used by the global search.
+    const CellTree<dim, MeshType> *tree;
+  };
+
+  /*! \brief Per-thread scratch data of the WorkStream based assembly.
+   *
+   * Every thread works on its own copy of the FEValues objects and of the
+   * cell-wise temporaries of the solvers, which are sized once for the
+   * element and the quadrature, so that no cell allocates memory. The
+   * vector (u) and scalar (p) shape functions are stored at one quadrature
+   * point, the solution at all of them.
+   */
+  template <int dim>
+  class AssemblyScratch
+  {
+  public:
+    AssemblyScratch(const FiniteElement<dim> &,
+                    const Quadrature<dim> &,
+                    const UpdateFlags,
+                    const Quadrature<dim - 1> &,
+                    const UpdateFlags);
+    /// WorkStream copies the scratch data for every thread.
+    AssemblyScratch(const AssemblyScratch &);
+
+    FEValues<dim> fe_values;
+    FEFaceValues<dim> fe_face_values;
+
+    /// The shape functions, one entry per dof.
+    std::vector<Tensor<1, dim>> phi_u;
+    std::vector<Tensor<2, dim>> grad_phi_u;
+    std::vector<SymmetricTensor<2, dim>> symmetric_grad_phi_u;
+    std::vector<double> div_phi_u;
+    std::vector<double> phi_p;
+    std::vector<Tensor<1, dim>> grad_phi_p;
+    /// Contractions of the shape functions with the solution (SCnsIM), one
+    /// entry per dof.
+    std::vector<Tensor<1, dim>> w_grad_phi_u;
+    std::vector<double> w_grad_phi_p;
+    std::vector<double> phi_u_grad_p;
+    std::vector<Tensor<1, dim>> convection_phi_u;
+    std::vector<Tensor<1, dim>> supg_phi_u;
+    /// The current (Newton iterate) and present solution, one entry per
+    /// quadrature point.
+    std::vector<Tensor<1, dim>> current_velocity_values;
+    std::vector<Tensor<2, dim>> current_velocity_gradients;
+    std::vector<double> current_velocity_divergences;
+    std::vector<double> current_pressure_values;
+    std::vector<Tensor<1, dim>> current_pressure_gradients;
+    std::vector<Tensor<1, dim>> present_velocity_values;
+    std::vector<double> present_pressure_values;
+
+  private:
+    void resize();
+  };
+
+  /*! \brief Local contributions of one cell, copied into the global system
+   * sequentially by the copier of WorkStream.
+   *
+   * The second matrix is used by the solvers that assemble an additional
+   * matrix (mass or stiffness) at the same time as the system matrix, the
+   * second vector by those that assemble a lumped mass.
+   */
+  struct AssemblyCopy
+  {
+    FullMatrix<double> cell_matrix;
+    FullMatrix<double> cell_matrix2;
+    Vector<double> cell_rhs;
+    Vector<double> cell_rhs2;
+    std::vector<types::global_dof_index> local_dof_indices;
+  };
+
+  /*! \brief Assignment to a ghosted PETSc block vector whose ghost values
+   * arrive in the background.
+   *
+   * start() copies the locally owned values and starts the scatter of the
+   * ghost values of every block, finish() waits for them. In between only
+   * the locally owned values of the ghosted vector may be read, e.g. by the
+   * assembly of the cells whose dofs are all locally owned. finish() does
+   * nothing if no update is pending.
+   */
+  class GhostUpdate
+  {
+  public:
+    GhostUpdate() : vector(nullptr) {}
+    void start(PETScWrappers::MPI::BlockVector &ghosted,
+               const PETScWrappers::MPI::BlockVector &owned);
+    void finish();
+
+  private:
+    PETScWrappers::MPI::BlockVector *vector;
+  };
+
+  /*! \brief Copy a ghosted PETSc block vector into a deal.II vector with the
+   * same locally owned and ghost dofs, which unlike the PETSc vector can be
+   * read by several threads at once.
+   *
+   * Only the locally owned or only the ghost values can be copied, e.g. the
+   * ghost values after a GhostUpdate is finished.
+   */
+  void copy_ghosted_vector(const PETScWrappers::MPI::BlockVector &ghosted,
+                           LinearAlgebra::distributed::BlockVector<double> &,
+                           const bool owned_values = true,
+                           const bool ghost_values = true);
+
+  /*! \brief Nodal average of fields given at the quadrature points.
+   *
+   * The values of all the fields on a cell are projected from the
+   * quadrature points to the dofs of a scalar finite element at once, added
+   * to the target vectors, and divided by the number of cells around every
+   * dof at the end. The target vectors must have the layout of the scalar
+   * dofs without ghost entries.
+   */
+  template <int dim>
+  class NodalProjection
+  {
+  public:
+    NodalProjection(const FiniteElement<dim> &scalar_fe,
+                    const Quadrature<dim> &,
+                    const std::vector<PETScWrappers::MPI::Vector *> &targets);
+
+    /// Values of the current cell, the rows are the quadrature points and
+    /// the columns the targets.
+    FullMatrix<double> quad_values;
+
+    /// Project quad_values and add them to the targets.
+    void
+    add_cell(const typename DoFHandler<dim>::active_cell_iterator &scalar_cell);
+
+    /// Sum the contributions of all processes and average them.
+    void finish();
+
+  private:
+    std::vector<PETScWrappers::MPI::Vector *> targets;
+    FullMatrix<double> qpt_to_dof;
+    FullMatrix<double> cell_values;
+    PETScWrappers::MPI::Vector surrounding_cells;
+    std::vector<types::global_dof_index> dof_indices;
+    std::vector<double> column;
+    std::vector<double> ones;
+  };
+
+  /*! \brief The dofs and the coordinates of the vertices of a mesh.
+   *
+   * Every vertex of the active cells that are not artificial is listed
+   * once, in the order in which the cells first touch it, together with the
+   * dofs of its dim components and a pointer to its coordinates in the
+   * triangulation. Loops over the vertices then run over flat arrays
+   * instead of the vertices of every cell. The pointers stay valid until
+   * the triangulation changes: the map listens to the any_change signal of
+   * the triangulation and update() rebuilds it after a refinement, a
+   * repartition or a new mesh, or if the number of dofs has changed. A
+   * renumbering of the dofs on the same mesh, e.g. a new partition of a
+   * shared triangulation, has to be announced with invalidate().
+   */
+  template <int dim>
+  class VertexDofMap
+  {
+  public:
+    VertexDofMap() = default;
+    /// The map is connected to the triangulation and cannot be copied.
+    VertexDofMap(const VertexDofMap &) = delete;
+    VertexDofMap &operator=(const VertexDofMap &) = delete;
+    ~VertexDofMap();
+
+    /// Build the map if it does not match the dof handler.
+    void update(const DoFHandler<dim> &dof_handler);
+
+    /// Rebuild the map at the next update, because the dofs are renumbered.
+    void invalidate() { valid = false; }
+
+    unsigned int size() const { return vertices.size(); }
+
+    /// The global index of vertex k.
+    std::vector<unsigned int> vertex_indices;
+
+    /// The dof of component d of vertex k, at k * dim + d.
+    std::vector<types::global_dof_index> dofs;
+
+    /// The coordinates of vertex k in the triangulation.
+    std::vector<Point<dim> *> vertices;
+
+    /// Copy the coordinates of the vertices into a buffer, and back.
+    void save(std::vector<Point<dim>> &) const;
+    void restore(const std::vector<Point<dim>> &) const;
+
+    /// Add a displacement to the vertices, which is indexed by the dofs and
+    /// must have the entries of all of them, e.g. a localized or a ghosted
+    /// vector.
+    template <typename VectorType>
+    void displace(const VectorType &displacement) const
+    {
+      for (unsigned int k = 0; k < vertices.size(); ++k)
+        {
+          for (unsigned int d = 0; d < dim; ++d)
+            {
+              (*vertices[k])[d] += displacement[dofs[k * dim + d]];
+            }
+        }
+    }
+
+    std::size_t memory_consumption() const;
+
+  private:
+    types::global_dof_index n_dofs = 0;
+    /// Cleared by the triangulation when its cells or vertices change.
+    bool valid = false;
+    const Triangulation<dim> *triangulation = nullptr;
+    boost::signals2::connection tria_connection;
+  };
+
+  /*! \brief Collective output of the processes in groups.
+   *
+   * The processes are split into a number of groups of consecutive ranks,
+   * every group writes a single compressed vtu file with MPI-IO. This keeps
+   * the number of files per output independent of the number of processes.
+   */
+  template <int dim>
+  class GroupedVtuWriter
+  {
+  public:
+    /// The number of groups is limited by the number of processes.
+    GroupedVtuWriter(MPI_Comm, const unsigned int n_groups);
+    ~GroupedVtuWriter();
+
+    /**
+     * Write the patches of this process to the file of its group, which is
+     * named basename followed by the group number. Return the names of the
+     * files of all groups.
+     */
+    std::vector<std::string> write(const DataOutInterface<dim, dim> &,
+                                   const std::string &basename) const;
+
+  private:
+    unsigned int n_groups;
+    unsigned int group;
+    MPI_Comm group_communicator;
+  };
+
+  /*! \brief Writes the output files in a background thread.
+   *
+   * The jobs run one after another in the order they are submitted, so the
+   * pvd records stay in order. At most max_queued jobs wait at a time, and
+   * submit blocks until the writer has caught up, which bounds the memory of
+   * the staged outputs when the file system is slow. An exception thrown by
+   * a job is kept until the next check, which throws it on every process,
+   * so a failed write on one process does not leave the others waiting.
+   */
+  class BackgroundWriter
+  {
+  public:
+    BackgroundWriter(const unsigned int max_queued);
+    /// Finish the waiting jobs.
+    ~BackgroundWriter();
+
+    void submit(std::function<void()> job);
+    /// Wait until all the submitted jobs are done.
+    void wait();
+    /// Throw on every process if a job of any process has failed since the
+    /// last check. Collective.
+    void check(const MPI_Comm &mpi_communicator);
+
+  private:
+    void run();
+
+    const unsigned int max_queued;
+    std::queue<std::function<void()>> jobs;
+    bool busy;
+    bool stopping;
+    std::exception_ptr error;
+    std::mutex mutex;
+    std::condition_variable job_added;
+    std::condition_variable job_done;
+    std::thread thread;
+  };
+
+  /*! \brief The patches of a DataOut, detached from the mesh and the vectors.
+   *
+   * They are written like those of the DataOut, by a background thread while
+   * the mesh moves or is refined and the solution changes.
+   */
+  template <int dim>
+  class StagedPatches : public DataOutInterface<dim, dim>
+  {
+  public:
+    using Ranges = std::vector<
+      std::tuple<unsigned int,
+                 unsigned int,
+                 std::string,
+                 DataComponentInterpretation::DataComponentInterpretation>>;
+
+    StagedPatches(std::vector<DataOutBase::Patch<dim, dim>> &&patches,
+                  const std::vector<std::string> &names,
+                  const Ranges &ranges)
+      : patches(std::move(patches)), names(names), ranges(ranges)
+    {
+    }
+
+  protected:
+    virtual const std::vector<DataOutBase::Patch<dim, dim>> &
+    get_patches() const override
+    {
+      return patches;
+    }
+
+    virtual std::vector<std::string> get_dataset_names() const override
+    {
+      return names;
+    }
+
+    virtual Ranges get_nonscalar_data_ranges() const override
+    {
+      return ranges;
+    }
+
+  private:
+    const std::vector<DataOutBase::Patch<dim, dim>> patches;
+    const std::vector<std::string> names;
+    const Ranges ranges;
+  };
+
+  /*! \brief The part of a mesh that is written to the output.
+   *
+   * A cell is written if it overlaps the box and is cut by the plane, each
+   * of them only if given, so that the output can be limited to the region
+   * around the solid or to a slice through the mesh.
+   */
+  template <int dim>
+  class OutputRegion
+  {
+  public:
+    /// The box is (x_min, x_max, y_min, y_max, z_min, z_max), and the plane
+    /// is a point on it followed by its normal. Empty means no limit.
+    OutputRegion(const std::vector<double> &box,
+                 const std::vector<double> &plane);
+    bool contains(const typename Triangulation<dim>::cell_iterator &) const;
+
+  private:
+    std::vector<double> box;
+    bool has_plane;
+    Point<dim> plane_point;
+    Tensor<1, dim> plane_normal;
+  };
+
+  /*! \brief DataOut restricted to the active cells that satisfy a predicate.
+   *
+   * On top of the cells that DataOut writes by default, i.e. the locally
+   * owned ones, only the cells that the predicate accepts are written. Used
+   * to write a region of the mesh, and the output of the solvers that store
+   * the entire triangulation on every process in parallel.
+   */
+  template <int dim>
+  class FilteredDataOut : public DataOut<dim>
+  {
+  public:
+    using Predicate =
+      std::function<bool(const typename DataOut<dim>::cell_iterator &)>;
+
+    FilteredDataOut(const Predicate &predicate) : predicate(predicate) {}
+
+    virtual typename DataOut<dim>::cell_iterator first_cell() override
+    {
+      return next_accepted(DataOut<dim>::first_cell());
+    }
+
+    virtual typename DataOut<dim>::cell_iterator
+    next_cell(const typename DataOut<dim>::cell_iterator &cell) override
+    {
+      return next_accepted(DataOut<dim>::next_cell(cell));
+    }
+
+    /// Move the patches made by build_patches out, together with the names
+    /// of the data sets, so that they can be written later.
+    std::shared_ptr<const DataOutInterface<dim, dim>> release_patches()
+    {
+      return std::make_shared<StagedPatches<dim>>(
+        std::move(this->patches),
+        this->get_dataset_names(),
+        this->get_nonscalar_data_ranges());
+    }
+
+  private:
+    typename DataOut<dim>::cell_iterator
+    next_accepted(typename DataOut<dim>::cell_iterator cell)
+    {
+      while (cell != this->triangulation->end() && !predicate(cell))
+        {
+          cell = DataOut<dim>::next_cell(cell);
+        }
+      return cell;
+    }
+
+    const Predicate predicate;
   };
 } // namespace Utils
 
@@ -33,6 +33,11 @@ namespace Fluid
       parameters(parameters),
       boundary_values(bc)
   {
+    // The serial solvers only use threads, the assembly uses as many as
+    // requested.
+    MultithreadInfo::set_thread_limit(parameters.n_threads == 0
+                                        ? numbers::invalid_unsigned_int
+                                        : parameters.n_threads);
   }
 
   template <int dim>
@@ -45,7 +50,16 @@ namespace Fluid
     // We renumber the components to have all velocity DoFs come before
     // the pressure DoFs to be able to split the solution vector in two blocks
     // which are separately accessed in the block preconditioner.
-    DoFRenumbering::Cuthill_McKee(dof_handler);
+    // component_wise keeps the order within each component, which is
+    // either Cuthill-McKee or the Morton order of the cells.
+    if (parameters.dof_ordering == "Hierarchical")
+      {
+        DoFRenumbering::hierarchical(dof_handler);
+      }
+    else
+      {
+        DoFRenumbering::Cuthill_McKee(dof_handler);
+      }
     std::vector<unsigned int> block_component(dim + 1, 0);
     block_component[dim] = 1;
     DoFRenumbering::component_wise(dof_handler, block_component);
@@ -158,6 +172,16 @@ namespace Fluid
       }
     nonzero_constraints.close();
     zero_constraints.close();
+    static_nonzero_constraints.copy_from(nonzero_constraints);
+    static_zero_constraints.copy_from(zero_constraints);
+  }
+
+  template <int dim>
+  void FluidSolver<dim>::reset_constraints(const bool nonzero)
+  {
+    nonzero_constraints.copy_from(nonzero ? static_nonzero_constraints
+                                          : static_zero_constraints);
+    zero_constraints.copy_from(static_zero_constraints);
   }
 
   template <int dim>
@@ -215,7 +239,7 @@ namespace Fluid
   void FluidSolver<dim>::refine_mesh(const unsigned int min_grid_level,
                                      const unsigned int max_grid_level)
   {
-    TimerOutput::Scope timer_section(timer, "Refine mesh");
+    Utils::ProfilingScope timer_section(timer, "Refine mesh");
 
     Vector<float> estimated_error_per_cell(triangulation.n_active_cells());
     FEValuesExtractors::Vector velocity(0);
@@ -265,7 +289,7 @@ namespace Fluid
   template <int dim>
   void FluidSolver<dim>::output_results(const unsigned int output_index) const
   {
-    TimerOutput::Scope timer_section(timer, "Output results");
+    Utils::ProfilingScope timer_section(timer, "Output results");
 
     std::cout << "Writing results..." << std::endl;
     std::vector<std::string> solution_names(dim, "velocity");
@@ -30,7 +30,7 @@ FSI<dim>::FSI(Fluid::FluidSolver<dim> &f,
 template <int dim>
 void FSI<dim>::move_solid_mesh(bool move_forward)
 {
-  TimerOutput::Scope timer_section(timer, "Move solid mesh");
+  Utils::ProfilingScope timer_section(timer, "Move solid mesh");
   std::vector<bool> vertex_touched(solid_solver.triangulation.n_vertices(),
                                    false);
   for (auto cell = solid_solver.dof_handler.begin_active();
@@ -90,7 +90,7 @@ void FSI<dim>::update_solid_box()
 
 template <int dim>
 bool FSI<dim>::point_in_solid(const DoFHandler<dim> &df,
-                              const Point<dim> &point)
+                              const Point<dim> &point) const
 {
   // Check whether the point is in the solid box first.
   for (unsigned int i = 0; i < dim; ++i)
@@ -149,16 +149,29 @@ void FSI<dim>::update_solid_displacement()
 template <int dim>
 void FSI<dim>::update_indicator()
 {
-  TimerOutput::Scope timer_section(timer, "Update indicator");
+  Utils::ProfilingScope timer_section(timer, "Update indicator");
   move_solid_mesh(true);
+  std::vector<typename DoFHandler<dim>::active_cell_iterator> fluid_cells;
+  fluid_cells.reserve(fluid_solver.triangulation.n_active_cells());
   for (auto f_cell = fluid_solver.dof_handler.begin_active();
        f_cell != fluid_solver.dof_handler.end();
        ++f_cell)
     {
-      auto p = fluid_solver.cell_property.get_data(f_cell);
-      auto center = f_cell->center();
-      p[0]->indicator = point_in_solid(solid_solver.dof_handler, center);
+      fluid_cells.push_back(f_cell);
     }
+  // Every cell only writes its own indicator.
+  parallel::apply_to_subranges(
+    0u,
+    static_cast<unsigned int>(fluid_cells.size()),
+    [&](const unsigned int begin, const unsigned int end) {
+      for (unsigned int c = begin; c < end; ++c)
+        {
+          auto p = fluid_solver.cell_property.get_data(fluid_cells[c]);
+          p[0]->indicator = point_in_solid(solid_solver.dof_handler,
+                                           fluid_cells[c]->center());
+        }
+    },
+    coupling_grainsize);
   move_solid_mesh(false);
 }
 
@@ -167,7 +180,7 @@ void FSI<dim>::update_indicator()
 template <int dim>
 void FSI<dim>::find_fluid_bc()
 {
-  TimerOutput::Scope timer_section(timer, "Find fluid BC");
+  Utils::ProfilingScope timer_section(timer, "Find fluid BC");
   move_solid_mesh(true);
 
   // The nonzero Dirichlet BCs (to set the velocity) and zero Dirichlet
@@ -176,125 +189,82 @@ void FSI<dim>::find_fluid_bc()
   inner_nonzero.clear();
   inner_zero.clear();
 
-  const FEValuesExtractors::Vector velocities(0);
-  const FEValuesExtractors::Scalar pressure(dim);
-  std::vector<SymmetricTensor<2, dim>> sym_grad_v(1);
-  std::vector<double> p(1);
-  std::vector<Tensor<2, dim>> grad_v(1);
-  std::vector<Tensor<1, dim>> v(1);
-  std::vector<Tensor<1, dim>> dv(1);
-
-  // Cell center in unit coordinate system
-  Point<dim> unit_center;
-  for (unsigned int i = 0; i < dim; ++i)
-    {
-      unit_center[i] = 0.5;
-    }
-  Quadrature<dim> quad(unit_center);
-  MappingQGeneric<dim> mapping(parameters.fluid_velocity_degree);
-  FEValues<dim> fe_values(mapping,
-                          fluid_solver.fe,
-                          quad,
-                          update_quadrature_points | update_values |
-                            update_gradients);
-
-  const std::vector<Point<dim>> &unit_points =
-    fluid_solver.fe.get_unit_support_points();
-  Quadrature<dim> dummy_q(unit_points);
-  FEValues<dim> dummy_fe_values(
-    mapping, fluid_solver.fe, dummy_q, update_quadrature_points);
-  std::vector<types::global_dof_index> dof_indices(
-    fluid_solver.fe.dofs_per_cell);
+  // The constrained lines of every cell and the velocity deltas they are
+  // set to. The cells are evaluated on all threads, the constraints are
+  // added in the order of the cells afterwards.
+  std::vector<std::vector<std::pair<types::global_dof_index, double>>>
+    cell_lines(use_dirichlet_bc ? fluid_cells.size() : 0);
 
-  for (auto f_cell = fluid_solver.dof_handler.begin_active();
-       f_cell != fluid_solver.dof_handler.end();
-       ++f_cell)
-    {
-      auto ptr = fluid_solver.cell_property.get_data(f_cell);
-      ptr[0]->fsi_acceleration = 0;
-      ptr[0]->fsi_stress = 0;
-      if (!use_dirichlet_bc && ptr[0]->indicator == 1)
+  parallel::apply_to_subranges(
+    0u,
+    static_cast<unsigned int>(fluid_cells.size()),
+    [&](const unsigned int begin, const unsigned int end) {
+      std::vector<types::global_dof_index> dof_indices(
+        fluid_solver.fe.dofs_per_cell);
+      for (unsigned int c = begin; c < end; ++c)
         {
-          fe_values.reinit(f_cell);
-          // Fluid velocity increment at cell center
-          fe_values[velocities].get_function_values(
-            fluid_solver.solution_increment, dv);
-          // Fluid velocity gradient at cell center
-          fe_values[velocities].get_function_gradients(
-            fluid_solver.present_solution, grad_v);
-          // Fluid symmetric velocity gradient at cell center
-          fe_values[velocities].get_function_symmetric_gradients(
-            fluid_solver.present_solution, sym_grad_v);
-          // Fluid pressure at cell center
-          fe_values[pressure].get_function_values(fluid_solver.present_solution,
-                                                  p);
-          // Real coordinates of fluid cell center
-          auto point = fe_values.get_quadrature_points()[0];
-          // Solid acceleration at fluid cell center
-          Vector<double> solid_acc(dim);
-          VectorTools::point_value(solid_solver.dof_handler,
-                                   solid_solver.current_acceleration,
-                                   point,
-                                   solid_acc);
-          // Fluid total acceleration at cell center
-          Tensor<1, dim> fluid_acc =
-            dv[0] / time.get_delta_t() + grad_v[0] * v[0];
-          (void)fluid_acc;
-          // FSI acceleration term:
-          for (unsigned int i = 0; i < dim; ++i)
+          const auto &f_cell = fluid_cells[c];
+          auto ptr = fluid_solver.cell_property.get_data(f_cell);
+          ptr[0]->fsi_acceleration = 0;
+          ptr[0]->fsi_stress = 0;
+          if (!use_dirichlet_bc && ptr[0]->indicator == 1)
             {
-              ptr[0]->fsi_acceleration[i] =
-                (parameters.solid_rho - parameters.fluid_rho) *
-                (parameters.gravity[i] - solid_acc[i]);
+              // Real coordinates of fluid cell center
+              const Point<dim> &point = cell_centers[c];
+              // Solid acceleration at fluid cell center
+              Vector<double> solid_acc(dim);
+              VectorTools::point_value(solid_solver.dof_handler,
+                                       solid_solver.current_acceleration,
+                                       point,
+                                       solid_acc);
+              // FSI acceleration term:
+              for (unsigned int i = 0; i < dim; ++i)
+                {
+                  ptr[0]->fsi_acceleration[i] =
+                    (parameters.solid_rho - parameters.fluid_rho) *
+                    (parameters.gravity[i] - solid_acc[i]);
+                }
             }
-        }
-      // Dirichlet BCs
-      if (use_dirichlet_bc)
-        {
-          dummy_fe_values.reinit(f_cell);
-          f_cell->get_dof_indices(dof_indices);
-          auto support_points = dummy_fe_values.get_quadrature_points();
-          // Loop over the support points to set Dirichlet BCs.
-          for (unsigned int i = 0; i < unit_points.size(); ++i)
+          // Dirichlet BCs
+          if (use_dirichlet_bc)
             {
-              auto base_index = fluid_solver.fe.system_to_base_index(i);
-              const unsigned int i_group = base_index.first.first;
-              Assert(
-                i_group < 2,
-                ExcMessage("There should be only 2 groups of finite element!"));
-              if (i_group == 1)
-                continue; // skip the pressure dofs
-              bool inside = true;
-              for (unsigned int d = 0; d < dim; ++d)
-                if (std::abs(unit_points[i][d]) < 1e-5)
-                  {
-                    inside = false;
-                    break;
-                  }
-              if (inside)
-                continue; // skip the in-cell support point
-              // Same as fluid_solver.fe.system_to_base_index(i).first.second;
-              const unsigned int index =
-                fluid_solver.fe.system_to_component_index(i).first;
-              Assert(index < dim,
-                     ExcMessage("Vector component should be less than dim!"));
-              if (!point_in_solid(solid_solver.dof_handler, support_points[i]))
-                continue;
-              Vector<double> fluid_velocity(dim);
-              VectorTools::point_value(solid_solver.dof_handler,
-                                       solid_solver.current_velocity,
-                                       support_points[i],
-                                       fluid_velocity);
-              auto line = dof_indices[i];
-              inner_nonzero.add_line(line);
-              inner_zero.add_line(line);
-              // Note that we are setting the value of the constraint to the
-              // velocity delta!
-              inner_nonzero.set_inhomogeneity(
-                line,
-                fluid_velocity[index] - fluid_solver.present_solution(line));
+              f_cell->get_dof_indices(dof_indices);
+              // Loop over the support points to set Dirichlet BCs.
+              for (unsigned int k = support_point_offsets[c];
+                   k < support_point_offsets[c + 1];
+                   ++k)
+                {
+                  const unsigned int i = support_points[k].index;
+                  const unsigned int index = support_points[k].component;
+                  const Point<dim> &support_point = support_points[k].point;
+                  if (!point_in_solid(solid_solver.dof_handler, support_point))
+                    continue;
+                  Vector<double> fluid_velocity(dim);
+                  VectorTools::point_value(solid_solver.dof_handler,
+                                           solid_solver.current_velocity,
+                                           support_point,
+                                           fluid_velocity);
+                  auto line = dof_indices[i];
+                  // Note that we are setting the value of the constraint to
+                  // the velocity delta!
+                  cell_lines[c].emplace_back(
+                    line,
+                    fluid_velocity[index] -
+                      fluid_solver.present_solution(line));
+                }
             }
         }
+    },
+    coupling_grainsize);
+
+  for (const auto &lines : cell_lines)
+    {
+      for (const auto &line : lines)
+        {
+          inner_nonzero.add_line(line.first);
+          inner_zero.add_line(line.first);
+          inner_nonzero.set_inhomogeneity(line.first, line.second);
+        }
     }
   if (use_dirichlet_bc)
     {
@@ -313,12 +283,9 @@ void FSI<dim>::find_fluid_bc()
 template <int dim>
 void FSI<dim>::find_solid_bc()
 {
-  TimerOutput::Scope timer_section(timer, "Find solid BC");
+  Utils::ProfilingScope timer_section(timer, "Find solid BC");
   // Must use the updated solid coordinates
   move_solid_mesh(true);
-  // Fluid FEValues to do interpolation
-  FEValues<dim> fe_values(
-    fluid_solver.fe, fluid_solver.volume_quad_formula, update_values);
   // Solid FEFaceValues to get the normal
   FEFaceValues<dim> fe_face_values(solid_solver.fe,
                                    solid_solver.face_quad_formula,
@@ -327,6 +294,15 @@ void FSI<dim>::find_solid_bc()
 
   const unsigned int n_face_q_points = solid_solver.face_quad_formula.size();
 
+  // Collect the boundary quadrature points first, the fluid solution is
+  // then interpolated to them on all threads.
+  struct BoundaryPoint
+  {
+    Point<dim> q_point;
+    Tensor<1, dim> normal;
+    std::shared_ptr<typename Solid::SolidSolver<dim>::CellProperty> property;
+  };
+  std::vector<BoundaryPoint> boundary_points;
   for (auto s_cell = solid_solver.dof_handler.begin_active();
        s_cell != solid_solver.dof_handler.end();
        ++s_cell)
@@ -340,35 +316,65 @@ void FSI<dim>::find_solid_bc()
               fe_face_values.reinit(s_cell, f);
               for (unsigned int q = 0; q < n_face_q_points; ++q)
                 {
-                  Point<dim> q_point = fe_face_values.quadrature_point(q);
-                  Tensor<1, dim> normal = fe_face_values.normal_vector(q);
-                  Vector<double> value(dim + 1);
-                  Utils::GridInterpolator<dim, BlockVector<double>>
-                    interpolator(fluid_solver.dof_handler, q_point);
-                  interpolator.point_value(fluid_solver.present_solution,
-                                           value);
-                  std::vector<Tensor<1, dim>> gradient(dim + 1,
-                                                       Tensor<1, dim>());
-                  interpolator.point_gradient(fluid_solver.present_solution,
-                                              gradient);
-                  SymmetricTensor<2, dim> sym_deformation;
-                  for (unsigned int i = 0; i < dim; ++i)
-                    {
-                      for (unsigned int j = 0; j < dim; ++j)
-                        {
-                          sym_deformation[i][j] =
-                            (gradient[i][j] + gradient[j][i]) / 2;
-                        }
-                    }
-                  // \f$ \sigma = -p\bold{I} + \mu\nabla^S v\f$
-                  SymmetricTensor<2, dim> stress =
-                    -value[dim] * Physics::Elasticity::StandardTensors<dim>::I +
-                    2 * parameters.viscosity * sym_deformation;
-                  ptr[f * n_face_q_points + q]->fsi_traction = stress * normal;
+                  boundary_points.push_back(
+                    {fe_face_values.quadrature_point(q),
+                     fe_face_values.normal_vector(q),
+                     ptr[f * n_face_q_points + q]});
                 }
             }
         }
     }
+
+  // Every thread evaluates with its own copy of the interpolator.
+  Threads::ThreadLocalStorage<
+    Utils::CellPointInterpolator<dim, BlockVector<double>>>
+    interpolators(Utils::CellPointInterpolator<dim, BlockVector<double>>(
+      fluid_solver.dof_handler));
+
+  parallel::apply_to_subranges(
+    0u,
+    static_cast<unsigned int>(boundary_points.size()),
+    [&](const unsigned int begin, const unsigned int end) {
+      auto &interpolator = interpolators.get();
+      std::vector<Point<dim>> point;
+      for (unsigned int k = begin; k < end; ++k)
+        {
+          const Point<dim> &q_point = boundary_points[k].q_point;
+          Vector<double> value(dim + 1);
+          std::vector<Tensor<1, dim>> gradient(dim + 1, Tensor<1, dim>());
+          // Locate the point once and evaluate the value and the
+          // gradient together.
+          Utils::GridInterpolator<dim, BlockVector<double>> locator(
+            fluid_solver.dof_handler, q_point);
+          if (locator.found_cell())
+            {
+              point.assign(1, q_point);
+              interpolator.evaluate(
+                locator.get_cell(), point, fluid_solver.present_solution);
+              for (unsigned int i = 0; i < dim + 1; ++i)
+                {
+                  value[i] = interpolator.value(0, i);
+                  gradient[i] = interpolator.gradient(0, i);
+                }
+            }
+          SymmetricTensor<2, dim> sym_deformation;
+          for (unsigned int i = 0; i < dim; ++i)
+            {
+              for (unsigned int j = 0; j < dim; ++j)
+                {
+                  sym_deformation[i][j] =
+                    (gradient[i][j] + gradient[j][i]) / 2;
+                }
+            }
+          // \f$ \sigma = -p\bold{I} + \mu\nabla^S v\f$
+          SymmetricTensor<2, dim> stress =
+            -value[dim] * Physics::Elasticity::StandardTensors<dim>::I +
+            2 * parameters.viscosity * sym_deformation;
+          boundary_points[k].property->fsi_traction =
+            stress * boundary_points[k].normal;
+        }
+    },
+    coupling_grainsize);
   move_solid_mesh(false);
 }
 
@@ -376,7 +382,7 @@ template <int dim>
 void FSI<dim>::refine_mesh(const unsigned int min_grid_level,
                            const unsigned int max_grid_level)
 {
-  TimerOutput::Scope timer_section(timer, "Refine mesh");
+  Utils::ProfilingScope timer_section(timer, "Refine mesh");
   move_solid_mesh(true);
   std::vector<Point<dim>> solid_boundary_points;
   for (auto s_cell : solid_solver.dof_handler.active_cell_iterators())
@@ -444,6 +450,51 @@ void FSI<dim>::refine_mesh(const unsigned int min_grid_level,
 
   solution_transfer.interpolate(buffer, fluid_solver.present_solution);
   fluid_solver.nonzero_constraints.distribute(fluid_solver.present_solution);
+  setup_support_points();
+}
+
+template <int dim>
+void FSI<dim>::setup_support_points()
+{
+  const MappingQGeneric<dim> mapping(parameters.fluid_velocity_degree);
+  // Cell center in unit coordinate system
+  Point<dim> unit_center;
+  for (unsigned int i = 0; i < dim; ++i)
+    {
+      unit_center[i] = 0.5;
+    }
+  const std::vector<Point<dim>> &unit_points =
+    fluid_solver.fe.get_unit_support_points();
+  // The velocity support points on the cell boundaries, the same in every
+  // cell.
+  const std::vector<unsigned int> boundary_points =
+    Utils::fsi_velocity_dofs(fluid_solver.fe);
+
+  fluid_cells.clear();
+  cell_centers.clear();
+  support_points.clear();
+  support_point_offsets.assign(1, 0);
+  fluid_cells.reserve(fluid_solver.triangulation.n_active_cells());
+  cell_centers.reserve(fluid_solver.triangulation.n_active_cells());
+  for (auto f_cell = fluid_solver.dof_handler.begin_active();
+       f_cell != fluid_solver.dof_handler.end();
+       ++f_cell)
+    {
+      fluid_cells.push_back(f_cell);
+      cell_centers.push_back(
+        mapping.transform_unit_to_real_cell(f_cell, unit_center));
+      if (use_dirichlet_bc)
+        {
+          for (const unsigned int i : boundary_points)
+            {
+              support_points.push_back(
+                {i,
+                 fluid_solver.fe.system_to_component_index(i).first,
+                 mapping.transform_unit_to_real_cell(f_cell, unit_points[i])});
+            }
+        }
+      support_point_offsets.push_back(support_points.size());
+    }
 }
 
 template <int dim>
@@ -456,6 +507,7 @@ void FSI<dim>::run()
   fluid_solver.setup_dofs();
   fluid_solver.make_constraints();
   fluid_solver.initialize_system();
+  setup_support_points();
 
   std::cout << "Number of fluid active cells and dofs: ["
             << fluid_solver.triangulation.n_active_cells() << ", "
@@ -476,21 +528,16 @@ void FSI<dim>::run()
     {
       find_solid_bc();
       {
-        TimerOutput::Scope timer_section(timer, "Run solid solver");
+        Utils::ProfilingScope timer_section(timer, "Run solid solver");
         solid_solver.run_one_step(first_step);
       }
       update_solid_box();
       update_indicator();
-      fluid_solver.make_constraints();
-      if (!first_step)
-        {
-          fluid_solver.nonzero_constraints.clear();
-          fluid_solver.nonzero_constraints.copy_from(
-            fluid_solver.zero_constraints);
-        }
+      // Only the inner constraints change from step to step.
+      fluid_solver.reset_constraints(first_step);
       find_fluid_bc();
       {
-        TimerOutput::Scope timer_section(timer, "Run fluid solver");
+        Utils::ProfilingScope timer_section(timer, "Run fluid solver");
         fluid_solver.run_one_step(true);
       }
       first_step = false;
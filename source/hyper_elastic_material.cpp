@@ -14,6 +14,22 @@ namespace Solid
     Assert(det_F > 0, ExcInternalError());
   }
 
+  template <int dim>
+  void HyperElasticMaterial<dim>::evaluate(
+    const dealii::ArrayView<const dealii::Tensor<2, dim>> &F,
+    const dealii::ArrayView<dealii::SymmetricTensor<2, dim>> &tau,
+    const dealii::ArrayView<dealii::SymmetricTensor<4, dim>> &Jc)
+  {
+    Assert(tau.size() == F.size() && Jc.size() == F.size(),
+           ExcInternalError());
+    for (unsigned int q = 0; q < F.size(); ++q)
+      {
+        update_data(F[q]);
+        tau[q] = get_tau();
+        Jc[q] = get_Jc();
+      }
+  }
+
   template <int dim>
   dealii::SymmetricTensor<4, dim> HyperElasticMaterial<dim>::get_Jc_vol() const
   {
@@ -216,7 +216,7 @@ namespace Solid
   template <int dim>
   void HyperElasticity<dim>::update_qph(const Vector<double> &evaluation_point)
   {
-    timer.enter_subsection("Update QPH data");
+    Utils::ProfilingScope timer_section(timer, "Update QPH data");
 
     // displacement gradient at quad points
     const unsigned int n_q_points = volume_quad_formula.size();
@@ -241,7 +241,6 @@ namespace Solid
             lqph[q]->update(parameters, grad_u[q]);
           }
       }
-    timer.leave_subsection();
   }
 
   template <int dim>
@@ -301,7 +300,7 @@ namespace Solid
   template <int dim>
   void HyperElasticity<dim>::assemble_system(bool initial_step)
   {
-    timer.enter_subsection("Assemble tangent matrix");
+    Utils::ProfilingScope timer_section(timer, "Assemble tangent matrix");
 
     const unsigned int n_q_points = volume_quad_formula.size();
     const unsigned int n_f_q_points = face_quad_formula.size();
@@ -509,8 +508,6 @@ namespace Solid
                                                    system_rhs);
           }
       }
-
-    timer.leave_subsection();
   }
 
   template <int dim>
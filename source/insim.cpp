@@ -30,11 +30,11 @@ namespace Fluid
   {
     {
       // Factoring A is also part of the direct solver.
-      TimerOutput::Scope timer_section(timer, "UMFPACK for A_inv");
+      Utils::ProfilingScope timer_section(timer, "UMFPACK for A_inv");
       A_inverse.initialize(system_matrix->block(0, 0));
     }
     {
-      TimerOutput::Scope timer_section(timer, "CG for Sm");
+      Utils::ProfilingScope timer_section(timer, "CG for Sm");
       Vector<double> tmp1(mass_matrix->block(0, 0).m()), tmp2(tmp1);
       tmp1 = 1;
       tmp2 = 0;
@@ -63,7 +63,7 @@ namespace Fluid
     tmp = 0;
     // This block computes \f$u_1 = \tilde{S}^{-1} v_1\f$.
     {
-      TimerOutput::Scope timer_section(timer, "CG for Mp");
+      Utils::ProfilingScope timer_section(timer, "CG for Mp");
 
       // CG solver used for \f$M_p^{-1}\f$ and \f$S_m^{-1}\f$.
       SolverControl solver_control(
@@ -79,7 +79,7 @@ namespace Fluid
     }
 
     {
-      TimerOutput::Scope timer_section(timer, "CG for Sm");
+      Utils::ProfilingScope timer_section(timer, "CG for Sm");
       SolverControl solver_control(
         src.block(1).size(), std::max(1e-6 * src.block(1).l2_norm(), 1e-10));
       // FIXME: There is a mysterious bug here. After refine_mesh is called,
@@ -112,7 +112,7 @@ namespace Fluid
     // Finally, compute the product of \f$\tilde{A}^{-1}\f$ and utmp with
     // the direct solver.
     {
-      TimerOutput::Scope timer_section(timer, "UMFPACK for A_inv");
+      Utils::ProfilingScope timer_section(timer, "UMFPACK for A_inv");
       A_inverse.vmult(dst.block(0), utmp);
     }
   }
@@ -141,7 +141,7 @@ namespace Fluid
   template <int dim>
   void InsIM<dim>::assemble(const bool use_nonzero_constraints)
   {
-    TimerOutput::Scope timer_section(timer, "Assemble system");
+    Utils::ProfilingScope timer_section(timer, "Assemble system");
 
     const double viscosity = parameters.viscosity;
     const double gamma = parameters.grad_div;
@@ -153,15 +153,11 @@ namespace Fluid
     mass_matrix = 0;
     system_rhs = 0;
 
-    FEValues<dim> fe_values(fe,
-                            volume_quad_formula,
-                            update_values | update_quadrature_points |
-                              update_JxW_values | update_gradients);
-    FEFaceValues<dim> fe_face_values(fe,
-                                     face_quad_formula,
-                                     update_values | update_normal_vectors |
-                                       update_quadrature_points |
-                                       update_JxW_values);
+    const UpdateFlags flags = update_values | update_quadrature_points |
+                              update_JxW_values | update_gradients;
+    const UpdateFlags face_flags = update_values | update_normal_vectors |
+                                   update_quadrature_points |
+                                   update_JxW_values;
 
     const unsigned int dofs_per_cell = fe.dofs_per_cell;
     const unsigned int u_dofs = fe.base_element(0).dofs_per_cell;
@@ -175,25 +171,30 @@ namespace Fluid
     const FEValuesExtractors::Vector velocities(0);
     const FEValuesExtractors::Scalar pressure(dim);
 
-    FullMatrix<double> local_matrix(dofs_per_cell, dofs_per_cell);
-    FullMatrix<double> local_mass_matrix(dofs_per_cell, dofs_per_cell);
-    Vector<double> local_rhs(dofs_per_cell);
+    // The local matrices are computed on all threads, the copier adds them
+    // to the global matrices one at a time.
+    auto assemble_cell =
+      [&](const typename DoFHandler<dim>::active_cell_iterator &cell,
+          Utils::AssemblyScratch<dim> &scratch,
+          Utils::AssemblyCopy &copy) {
+        FEValues<dim> &fe_values = scratch.fe_values;
+        FEFaceValues<dim> &fe_face_values = scratch.fe_face_values;
+        FullMatrix<double> &local_matrix = copy.cell_matrix;
+        FullMatrix<double> &local_mass_matrix = copy.cell_matrix2;
+        Vector<double> &local_rhs = copy.cell_rhs;
+        std::vector<types::global_dof_index> &local_dof_indices =
+          copy.local_dof_indices;
+
+        std::vector<Tensor<1, dim>> current_velocity_values(n_q_points);
+        std::vector<Tensor<2, dim>> current_velocity_gradients(n_q_points);
+        std::vector<double> current_pressure_values(n_q_points);
+        std::vector<Tensor<1, dim>> present_velocity_values(n_q_points);
+
+        std::vector<double> div_phi_u(dofs_per_cell);
+        std::vector<Tensor<1, dim>> phi_u(dofs_per_cell);
+        std::vector<Tensor<2, dim>> grad_phi_u(dofs_per_cell);
+        std::vector<double> phi_p(dofs_per_cell);
 
-    std::vector<types::global_dof_index> local_dof_indices(dofs_per_cell);
-
-    std::vector<Tensor<1, dim>> current_velocity_values(n_q_points);
-    std::vector<Tensor<2, dim>> current_velocity_gradients(n_q_points);
-    std::vector<double> current_pressure_values(n_q_points);
-    std::vector<Tensor<1, dim>> present_velocity_values(n_q_points);
-
-    std::vector<double> div_phi_u(dofs_per_cell);
-    std::vector<Tensor<1, dim>> phi_u(dofs_per_cell);
-    std::vector<Tensor<2, dim>> grad_phi_u(dofs_per_cell);
-    std::vector<double> phi_p(dofs_per_cell);
-
-    for (auto cell = dof_handler.begin_active(); cell != dof_handler.end();
-         ++cell)
-      {
         auto p = cell_property.get_data(cell);
         const int ind = p[0]->indicator;
         const double rho = parameters.fluid_rho;
@@ -302,7 +303,7 @@ namespace Fluid
                     fe_face_values.reinit(cell, face_n);
                     unsigned int p_bc_id = cell->face(face_n)->boundary_id();
                     double boundary_values_p =
-                      parameters.fluid_neumann_bcs[p_bc_id];
+                      parameters.fluid_neumann_bcs.at(p_bc_id);
                     for (unsigned int q = 0; q < n_face_q_points; ++q)
                       {
                         for (unsigned int i = 0; i < dofs_per_cell; ++i)
@@ -318,25 +319,45 @@ namespace Fluid
           }
 
         cell->get_dof_indices(local_dof_indices);
+      };
 
-        const AffineConstraints<double> &constraints_used =
-          use_nonzero_constraints ? nonzero_constraints : zero_constraints;
-        constraints_used.distribute_local_to_global(local_matrix,
-                                                    local_rhs,
-                                                    local_dof_indices,
-                                                    system_matrix,
-                                                    system_rhs,
-                                                    true);
-        constraints_used.distribute_local_to_global(
-          local_mass_matrix, local_dof_indices, mass_matrix);
-      }
+    const AffineConstraints<double> &constraints_used =
+      use_nonzero_constraints ? nonzero_constraints : zero_constraints;
+    auto copy_cell = [&](const Utils::AssemblyCopy &copy) {
+      constraints_used.distribute_local_to_global(copy.cell_matrix,
+                                                  copy.cell_rhs,
+                                                  copy.local_dof_indices,
+                                                  system_matrix,
+                                                  system_rhs,
+                                                  true);
+      constraints_used.distribute_local_to_global(
+        copy.cell_matrix2, copy.local_dof_indices, mass_matrix);
+    };
+
+    Utils::AssemblyCopy copy_data;
+    copy_data.cell_matrix.reinit(dofs_per_cell, dofs_per_cell);
+    copy_data.cell_matrix2.reinit(dofs_per_cell, dofs_per_cell);
+    copy_data.cell_rhs.reinit(dofs_per_cell);
+    copy_data.local_dof_indices.resize(dofs_per_cell);
+
+    WorkStream::run(dof_handler.begin_active(),
+                    dof_handler.end(),
+                    assemble_cell,
+                    copy_cell,
+                    Utils::AssemblyScratch<dim>(fe,
+                                                volume_quad_formula,
+                                                flags,
+                                                face_quad_formula,
+                                                face_flags),
+                    copy_data);
   }
 
   template <int dim>
   std::pair<unsigned int, double>
-  InsIM<dim>::solve(const bool use_nonzero_constraints)
+  InsIM<dim>::solve(const bool use_nonzero_constraints,
+                    const double relative_tolerance)
   {
-    TimerOutput::Scope timer_section(timer, "Solve linear system");
+    Utils::ProfilingScope timer_section(timer, "Solve linear system");
 
     preconditioner.reset(new BlockSchurPreconditioner(timer,
                                                       parameters.grad_div,
@@ -351,7 +372,9 @@ namespace Fluid
     // as opposed to SolverGMRES which allows both left and right
     // preconditoners.
     SolverControl solver_control(
-      system_matrix.m(), std::max(1e-8 * system_rhs.l2_norm(), 1e-10), true);
+      system_matrix.m(),
+      std::max(relative_tolerance * system_rhs.l2_norm(), 1e-10),
+      true);
     GrowingVectorMemory<BlockVector<double>> vector_memory;
     SolverFGMRES<BlockVector<double>> gmres(solver_control, vector_memory);
 
@@ -387,6 +410,9 @@ namespace Fluid
     double initial_residual = 1.0;
     double relative_residual = 1.0;
     unsigned int outer_iteration = 0;
+    Utils::ForcingTerm forcing_term(
+      1e-8, parameters.inexact_newton, parameters.max_forcing_term);
+    unsigned int step_linear_iterations = 0;
     evaluation_point = present_solution;
     while (relative_residual > parameters.fluid_tolerance &&
            current_residual > 1e-11)
@@ -404,8 +430,11 @@ namespace Fluid
         // if they are time-independent, nonzero_constraints should be
         // applied only at the first iteration of the first time step.
         assemble(apply_nonzero_constraints && outer_iteration == 0);
-        auto state = solve(apply_nonzero_constraints && outer_iteration == 0);
         current_residual = system_rhs.l2_norm();
+        const double eta = forcing_term.next(current_residual);
+        auto state =
+          solve(apply_nonzero_constraints && outer_iteration == 0, eta);
+        step_linear_iterations += state.first;
 
         // Update evaluation_point. Since newton_update has been set to
         // the correct bc values, there is no need to distribute the
@@ -421,12 +450,14 @@ namespace Fluid
 
         std::cout << std::scientific << std::left << " ITR = " << std::setw(2)
                   << outer_iteration << " ABS_RES = " << current_residual
-                  << " REL_RES = " << relative_residual
+                  << " REL_RES = " << relative_residual << " ETA = " << eta
                   << " GMRES_ITR = " << std::setw(3) << state.first
                   << " GMRES_RES = " << state.second << std::endl;
 
         outer_iteration++;
       }
+    std::cout << " NEWTON_ITR = " << outer_iteration
+              << " TOTAL_GMRES_ITR = " << step_linear_iterations << std::endl;
     // Update solution increment, which is used in FSI application.
     solution_increment = evaluation_point;
     solution_increment -= present_solution;
@@ -21,7 +21,7 @@ namespace Fluid
       mass_matrix(&mass),
       mass_schur(&schur)
   {
-    TimerOutput::Scope timer_section(timer, "CG for Sm");
+    Utils::ProfilingScope timer_section(timer, "CG for Sm");
     Vector<double> tmp1(mass_matrix->block(0, 0).m()), tmp2(tmp1);
     tmp1 = 1;
     tmp2 = 0;
@@ -50,7 +50,7 @@ namespace Fluid
     // This block computes \f$u_1 = \tilde{S}^{-1} v_1\f$,
     // where CG solvers are used for \f$M_p^{-1}\f$ and \f$S_m^{-1}\f$.
     {
-      TimerOutput::Scope timer_section(timer, "CG for Mp");
+      Utils::ProfilingScope timer_section(timer, "CG for Mp");
       // CG solver used for \f$M_p^{-1}\f$ and \f$S_m^{-1}\f$.
       SolverControl mp_control(src.block(1).size(),
                                1e-6 * src.block(1).l2_norm());
@@ -74,7 +74,7 @@ namespace Fluid
     //
     // \f$-\frac{1}{dt}S_m^{-1}v_1\f$
     {
-      TimerOutput::Scope timer_section(timer, "CG for Sm");
+      Utils::ProfilingScope timer_section(timer, "CG for Sm");
       SolverControl sm_control(src.block(1).size(),
                                1e-6 * src.block(1).l2_norm());
       PreconditionIdentity Sm_preconditioner;
@@ -96,7 +96,7 @@ namespace Fluid
     // Finally, compute the product of \f$\tilde{A}^{-1}\f$ and utmp with
     // the direct solver.
     {
-      TimerOutput::Scope timer_section(timer, "CG for A");
+      Utils::ProfilingScope timer_section(timer, "CG for A");
       SolverControl a_control(src.block(0).size(),
                               1e-6 * src.block(0).l2_norm());
       SolverCG<> cg_a(a_control);
@@ -130,7 +130,7 @@ namespace Fluid
   void InsIMEX<dim>::assemble(bool use_nonzero_constraints,
                               bool assemble_system)
   {
-    TimerOutput::Scope timer_section(timer, "Assemble system");
+    Utils::ProfilingScope timer_section(timer, "Assemble system");
 
     const double viscosity = parameters.viscosity;
     const double gamma = parameters.grad_div;
@@ -321,7 +321,7 @@ namespace Fluid
   std::pair<unsigned int, double>
   InsIMEX<dim>::solve(bool use_nonzero_constraints, bool assemble_system)
   {
-    TimerOutput::Scope timer_section(timer, "Solve linear system");
+    Utils::ProfilingScope timer_section(timer, "Solve linear system");
     if (assemble_system)
       {
         preconditioner.reset(new BlockSchurPreconditioner(timer,
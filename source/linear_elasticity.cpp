@@ -21,16 +21,27 @@ namespace Solid
   template <int dim>
   void LinearElasticity<dim>::assemble(bool is_initial, bool assemble_matrix)
   {
-    TimerOutput::Scope timer_section(timer, "Assemble system");
+    Utils::ProfilingScope timer_section(timer, "Assemble system");
 
     double gamma = 0.5 + parameters.damping;
     double beta = gamma / 2;
 
+    // The explicit scheme only needs the lumped mass and the stiffness,
+    // the system matrix is not assembled.
+    const bool lumped =
+      assemble_matrix && parameters.solid_time_integration == "Explicit";
     if (assemble_matrix)
       {
-        system_matrix = 0;
+        if (!lumped)
+          {
+            system_matrix = 0;
+          }
         stiffness_matrix = 0;
       }
+    if (lumped)
+      {
+        lumped_mass_inverse.reinit(dof_handler.n_dofs());
+      }
     system_rhs = 0;
 
     FEValues<dim> fe_values(fe,
@@ -55,6 +66,7 @@ namespace Solid
     FullMatrix<double> local_matrix(dofs_per_cell, dofs_per_cell);
     FullMatrix<double> local_stiffness(dofs_per_cell, dofs_per_cell);
     Vector<double> local_rhs(dofs_per_cell);
+    Vector<double> local_mass(dofs_per_cell);
 
     std::vector<types::global_dof_index> local_dof_indices(dofs_per_cell);
 
@@ -81,6 +93,7 @@ namespace Solid
         local_matrix = 0;
         local_stiffness = 0;
         local_rhs = 0;
+        local_mass = 0;
 
         fe_values.reinit(cell);
 
@@ -101,7 +114,12 @@ namespace Solid
                   {
                     for (unsigned int j = 0; j < dofs_per_cell; ++j)
                       {
-                        if (is_initial)
+                        if (lumped)
+                          {
+                            local_mass[i] +=
+                              rho * phi[i] * phi[j] * fe_values.JxW(q);
+                          }
+                        else if (is_initial)
                           {
                             local_matrix[i][j] +=
                               rho * phi[i] * phi[j] * fe_values.JxW(q);
@@ -113,6 +131,9 @@ namespace Solid
                                symmetric_grad_phi[i] * elasticity *
                                  symmetric_grad_phi[j] * beta * dt * dt) *
                               fe_values.JxW(q);
+                          }
+                        if (!is_initial)
+                          {
                             local_stiffness[i][j] +=
                               symmetric_grad_phi[i] * elasticity *
                               symmetric_grad_phi[j] * fe_values.JxW(q);
@@ -206,7 +227,7 @@ namespace Solid
               }
           }
 
-        if (assemble_matrix)
+        if (assemble_matrix && !lumped)
           {
             // Now distribute local data to the system, and apply the
             // hanging node constraints at the same time.
@@ -215,14 +236,22 @@ namespace Solid
                                                    local_dof_indices,
                                                    system_matrix,
                                                    system_rhs);
-            constraints.distribute_local_to_global(
-              local_stiffness, local_dof_indices, stiffness_matrix);
           }
         else
           {
             constraints.distribute_local_to_global(
               local_rhs, local_dof_indices, system_rhs);
           }
+        if (assemble_matrix)
+          {
+            constraints.distribute_local_to_global(
+              local_stiffness, local_dof_indices, stiffness_matrix);
+          }
+        if (lumped)
+          {
+            constraints.distribute_local_to_global(
+              local_mass, local_dof_indices, lumped_mass_inverse);
+          }
       }
   }
 
@@ -230,6 +259,19 @@ namespace Solid
   void LinearElasticity<dim>::assemble_system(bool is_initial)
   {
     assemble(is_initial, true);
+    if (parameters.solid_time_integration == "Explicit")
+      {
+        for (auto &m : lumped_mass_inverse)
+          {
+            // The constrained dofs have no mass.
+            m = (m > 0 ? 1 / m : 0);
+          }
+        const double stable_delta_t = stable_time_step();
+        AssertThrow(time.get_delta_t() <= stable_delta_t,
+                    ExcMessage("The time step of the explicit solid exceeds "
+                               "the stability limit " +
+                               std::to_string(stable_delta_t) + "!"));
+      }
   }
 
   template <int dim>
@@ -239,21 +281,55 @@ namespace Solid
     assemble(false, false);
   }
 
+  template <int dim>
+  double LinearElasticity<dim>::stable_time_step() const
+  {
+    double omega_squared = 0;
+    for (unsigned int row = 0; row < dof_handler.n_dofs(); ++row)
+      {
+        if (constraints.is_constrained(row))
+          {
+            continue;
+          }
+        double sum = 0;
+        for (auto entry = stiffness_matrix.begin(row);
+             entry != stiffness_matrix.end(row);
+             ++entry)
+          {
+            sum += std::abs(entry->value());
+          }
+        omega_squared = std::max(omega_squared, sum * lumped_mass_inverse[row]);
+      }
+    const double gamma = 0.5 + parameters.damping;
+    return std::sqrt(2 / gamma / omega_squared);
+  }
+
   template <int dim>
   void LinearElasticity<dim>::run_one_step(bool first_step)
   {
     std::cout.precision(6);
     std::cout.width(12);
 
+    const bool explicit_scheme =
+      parameters.solid_time_integration == "Explicit";
     double gamma = 0.5 + parameters.damping;
-    double beta = gamma / 2;
+    double beta = explicit_scheme ? 0 : gamma / 2;
 
     if (first_step)
       {
         // Neet to compute the initial acceleration, \f$ Ma_n = F \f$,
         // at this point set system_matrix to mass_matrix.
         assemble_system(true);
-        this->solve(system_matrix, previous_acceleration, system_rhs);
+        if (explicit_scheme)
+          {
+            previous_acceleration = system_rhs;
+            previous_acceleration.scale(lumped_mass_inverse);
+            constraints.distribute(previous_acceleration);
+          }
+        else
+          {
+            this->solve(system_matrix, previous_acceleration, system_rhs);
+          }
         // Update the system_matrix
         assemble_system(false);
         this->output_results(time.get_timestep());
@@ -281,7 +357,18 @@ namespace Solid
     stiffness_matrix.vmult(tmp3, tmp2);
     tmp1 -= tmp3;
 
-    auto state = this->solve(system_matrix, current_acceleration, tmp1);
+    std::pair<unsigned int, double> state(0, 0.0);
+    if (explicit_scheme)
+      {
+        // \f$ a_{n+1} = M_L^{-1}(F - Ku_{n+1}) \f$
+        current_acceleration = tmp1;
+        current_acceleration.scale(lumped_mass_inverse);
+        constraints.distribute(current_acceleration);
+      }
+    else
+      {
+        state = this->solve(system_matrix, current_acceleration, tmp1);
+      }
 
     // update the current velocity
     // \f$ v_{n+1} = v_n + (1-\gamma)\Delta{t}a_n + \gamma\Delta{t}a_{n+1}
@@ -301,9 +388,12 @@ namespace Solid
     previous_velocity = current_velocity;
     previous_displacement = current_displacement;
 
-    std::cout << std::scientific << std::left
-              << " CG iteration: " << std::setw(3) << state.first
-              << " CG residual: " << state.second << std::endl;
+    if (!explicit_scheme)
+      {
+        std::cout << std::scientific << std::left
+                  << " CG iteration: " << std::setw(3) << state.first
+                  << " CG residual: " << state.second << std::endl;
+      }
 
     update_strain_and_stress();
 
@@ -0,0 +1,695 @@
+#include "mpi_distributed_fsi.h"
+#include <iostream>
+
+namespace MPI
+{
+  template <int dim>
+  DistributedFSI<dim>::~DistributedFSI()
+  {
+    timer.print_summary();
+    if (parameters.timer_statistics)
+      {
+        timer.print_wall_time_statistics(mpi_communicator);
+      }
+  }
+
+  template <int dim>
+  DistributedFSI<dim>::DistributedFSI(Fluid::MPI::FluidSolver<dim> &f,
+                                      Solid::MPI::SolidSolver<dim> &s,
+                                      const Parameters::AllParameters &p,
+                                      bool use_dirichlet_bc)
+    : fluid_solver(f),
+      solid_solver(s),
+      parameters(p),
+      mpi_communicator(f.mpi_communicator),
+      pcout(std::cout, Utilities::MPI::this_mpi_process(mpi_communicator) == 0),
+      time(parameters.end_time,
+           parameters.time_step,
+           parameters.output_interval,
+           parameters.refinement_interval,
+           parameters.save_interval),
+      timer(
+        mpi_communicator, pcout, TimerOutput::never, TimerOutput::wall_times),
+      solid_mesh_deformed(false),
+      fluid_tree(f.dof_handler),
+      solid_tree(s.dof_handler),
+      fluid_mapping(p.fluid_velocity_degree),
+      fluid_center_values(fluid_mapping,
+                          f.fe,
+                          QMidpoint<dim>(),
+                          update_values | update_gradients),
+      use_dirichlet_bc(use_dirichlet_bc)
+  {
+    int comparison;
+    MPI_Comm_compare(f.mpi_communicator, s.mpi_communicator, &comparison);
+    AssertThrow(comparison == MPI_IDENT || comparison == MPI_CONGRUENT,
+                ExcMessage("The fluid and solid solvers must use the same "
+                           "communicator!"));
+    fluid_solver.enable_cell_property();
+  }
+
+  template <int dim>
+  void DistributedFSI<dim>::move_solid_mesh(bool move_forward)
+  {
+    if (move_forward == solid_mesh_deformed)
+      {
+        return;
+      }
+    Utils::ProfilingScope timer_section(timer, "Move solid mesh");
+    solid_mesh_deformed = move_forward;
+    solid_vertices.update(solid_solver.dof_handler);
+    if (!move_forward)
+      {
+        solid_vertices.restore(reference_vertices);
+        return;
+      }
+    solid_vertices.save(reference_vertices);
+    // Only the displacement of the locally relevant dofs is needed.
+    PETScWrappers::MPI::Vector ghosted_displacement(
+      solid_solver.locally_owned_dofs,
+      solid_solver.locally_relevant_dofs,
+      mpi_communicator);
+    ghosted_displacement = solid_solver.current_displacement;
+    solid_vertices.displace(ghosted_displacement);
+    // The solid cells are searched in the deformed configuration only.
+    solid_tree.refit();
+  }
+
+  template <int dim>
+  void DistributedFSI<dim>::update_solid_ghosts()
+  {
+    ghosted_solid_velocity.reinit(solid_solver.locally_owned_dofs,
+                                  solid_solver.locally_relevant_dofs,
+                                  mpi_communicator);
+    ghosted_solid_acceleration.reinit(solid_solver.locally_owned_dofs,
+                                      solid_solver.locally_relevant_dofs,
+                                      mpi_communicator);
+    ghosted_solid_velocity = solid_solver.current_velocity;
+    ghosted_solid_acceleration = solid_solver.current_acceleration;
+  }
+
+  template <int dim>
+  std::vector<double>
+  DistributedFSI<dim>::owned_box(const DoFHandler<dim> &dof_handler) const
+  {
+    std::vector<double> box(2 * dim);
+    for (unsigned int d = 0; d < dim; ++d)
+      {
+        box[2 * d] = std::numeric_limits<double>::max();
+        box[2 * d + 1] = std::numeric_limits<double>::lowest();
+      }
+    for (auto cell = dof_handler.begin_active(); cell != dof_handler.end();
+         ++cell)
+      {
+        if (!cell->is_locally_owned())
+          continue;
+        for (unsigned int v = 0; v < GeometryInfo<dim>::vertices_per_cell; ++v)
+          {
+            for (unsigned int d = 0; d < dim; ++d)
+              {
+                box[2 * d] = std::min(box[2 * d], cell->vertex(v)[d]);
+                box[2 * d + 1] = std::max(box[2 * d + 1], cell->vertex(v)[d]);
+              }
+          }
+      }
+    // Pad the box so that the points on its boundary are not lost to
+    // round-off errors.
+    for (unsigned int d = 0; d < dim; ++d)
+      {
+        if (box[2 * d] <= box[2 * d + 1])
+          {
+            const double tolerance =
+              1e-8 * std::max(1.0, box[2 * d + 1] - box[2 * d]);
+            box[2 * d] -= tolerance;
+            box[2 * d + 1] += tolerance;
+          }
+      }
+    return box;
+  }
+
+  template <int dim>
+  void
+  DistributedFSI<dim>::exchange_points(const std::vector<Point<dim>> &points,
+                                       const unsigned int n_values,
+                                       const std::vector<double> &answer_box,
+                                       const PointEvaluator &evaluate,
+                                       const int tag,
+                                       std::vector<double> &values,
+                                       std::vector<bool> &found)
+  {
+    const unsigned int n_procs =
+      Utilities::MPI::n_mpi_processes(mpi_communicator);
+    const unsigned int this_proc =
+      Utilities::MPI::this_mpi_process(mpi_communicator);
+
+    auto contains = [](const std::vector<double> &box,
+                       const Point<dim> &point) {
+      for (unsigned int d = 0; d < dim; ++d)
+        {
+          if (point[d] < box[2 * d] || point[d] > box[2 * d + 1])
+            return false;
+        }
+      return true;
+    };
+    auto overlap = [](const std::vector<double> &a,
+                      const std::vector<double> &b) {
+      for (unsigned int d = 0; d < dim; ++d)
+        {
+          if (a[2 * d] > b[2 * d + 1] || b[2 * d] > a[2 * d + 1])
+            return false;
+        }
+      return true;
+    };
+
+    // The box of the points to be evaluated. Both sides of an exchange
+    // decide from the gathered boxes whether a message is expected, so
+    // empty messages are sent where the boxes overlap.
+    std::vector<double> query_box(2 * dim);
+    for (unsigned int d = 0; d < dim; ++d)
+      {
+        query_box[2 * d] = std::numeric_limits<double>::max();
+        query_box[2 * d + 1] = std::numeric_limits<double>::lowest();
+      }
+    for (const auto &point : points)
+      {
+        for (unsigned int d = 0; d < dim; ++d)
+          {
+            query_box[2 * d] = std::min(query_box[2 * d], point[d]);
+            query_box[2 * d + 1] = std::max(query_box[2 * d + 1], point[d]);
+          }
+      }
+    const std::vector<std::vector<double>> query_boxes =
+      Utilities::MPI::all_gather(mpi_communicator, query_box);
+    const std::vector<std::vector<double>> answer_boxes =
+      Utilities::MPI::all_gather(mpi_communicator, answer_box);
+
+    int ierr;
+    std::vector<MPI_Request> requests;
+    // Send the points to the processes whose owned cells may contain them.
+    std::map<unsigned int, std::vector<unsigned int>> sent_points;
+    std::map<unsigned int, std::vector<double>> query_buffers;
+    for (unsigned int r = 0; r < n_procs; ++r)
+      {
+        if (r == this_proc || !overlap(query_boxes[this_proc], answer_boxes[r]))
+          continue;
+        std::vector<unsigned int> &indices = sent_points[r];
+        std::vector<double> &buffer = query_buffers[r];
+        for (unsigned int n = 0; n < points.size(); ++n)
+          {
+            if (contains(answer_boxes[r], points[n]))
+              {
+                indices.push_back(n);
+                for (unsigned int d = 0; d < dim; ++d)
+                  {
+                    buffer.push_back(points[n][d]);
+                  }
+              }
+          }
+        requests.emplace_back();
+        ierr = MPI_Isend(buffer.data(),
+                         buffer.size(),
+                         MPI_DOUBLE,
+                         r,
+                         tag,
+                         mpi_communicator,
+                         &requests.back());
+        AssertThrowMPI(ierr);
+      }
+
+    // Answer the points of the other processes. Every point is answered
+    // with a flag whether it is found and its values.
+    std::map<unsigned int, std::vector<double>> answer_buffers;
+    for (unsigned int r = 0; r < n_procs; ++r)
+      {
+        if (r == this_proc || !overlap(query_boxes[r], answer_boxes[this_proc]))
+          continue;
+        MPI_Status status;
+        ierr = MPI_Probe(r, tag, mpi_communicator, &status);
+        AssertThrowMPI(ierr);
+        int count;
+        ierr = MPI_Get_count(&status, MPI_DOUBLE, &count);
+        AssertThrowMPI(ierr);
+        std::vector<double> query(count);
+        ierr = MPI_Recv(query.data(),
+                        count,
+                        MPI_DOUBLE,
+                        r,
+                        tag,
+                        mpi_communicator,
+                        MPI_STATUS_IGNORE);
+        AssertThrowMPI(ierr);
+        const unsigned int n_points = count / dim;
+        std::vector<double> &answer = answer_buffers[r];
+        answer.assign(n_points * (n_values + 1), 0);
+        for (unsigned int k = 0; k < n_points; ++k)
+          {
+            Point<dim> point;
+            for (unsigned int d = 0; d < dim; ++d)
+              {
+                point[d] = query[k * dim + d];
+              }
+            double *entry = &answer[k * (n_values + 1)];
+            if (evaluate(point, entry + 1))
+              {
+                entry[0] = 1;
+              }
+          }
+        requests.emplace_back();
+        ierr = MPI_Isend(answer.data(),
+                         answer.size(),
+                         MPI_DOUBLE,
+                         r,
+                         tag + 1,
+                         mpi_communicator,
+                         &requests.back());
+        AssertThrowMPI(ierr);
+      }
+
+    // Collect the answers in the order of ranks, so that the lowest rank
+    // that finds a point wins no matter in which order the answers arrive.
+    values.assign(points.size() * n_values, 0);
+    found.assign(points.size(), false);
+    std::vector<double> buffer(n_values);
+    for (unsigned int r = 0; r < n_procs; ++r)
+      {
+        if (r == this_proc)
+          {
+            if (!overlap(query_boxes[this_proc], answer_boxes[this_proc]))
+              continue;
+            for (unsigned int n = 0; n < points.size(); ++n)
+              {
+                if (found[n] || !contains(answer_box, points[n]) ||
+                    !evaluate(points[n], buffer.data()))
+                  continue;
+                found[n] = true;
+                std::copy(
+                  buffer.begin(), buffer.end(), values.begin() + n * n_values);
+              }
+            continue;
+          }
+        auto indices = sent_points.find(r);
+        if (indices == sent_points.end())
+          continue;
+        std::vector<double> answer(indices->second.size() * (n_values + 1));
+        ierr = MPI_Recv(answer.data(),
+                        answer.size(),
+                        MPI_DOUBLE,
+                        r,
+                        tag + 1,
+                        mpi_communicator,
+                        MPI_STATUS_IGNORE);
+        AssertThrowMPI(ierr);
+        for (unsigned int k = 0; k < indices->second.size(); ++k)
+          {
+            const unsigned int n = indices->second[k];
+            const double *entry = &answer[k * (n_values + 1)];
+            if (found[n] || entry[0] == 0)
+              continue;
+            found[n] = true;
+            std::copy(entry + 1,
+                      entry + 1 + n_values,
+                      values.begin() + n * n_values);
+          }
+      }
+    ierr = MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+    AssertThrowMPI(ierr);
+  }
+
+  template <int dim>
+  bool DistributedFSI<dim>::evaluate_solid(const Point<dim> &point,
+                                           double *values)
+  {
+    std::vector<typename DoFHandler<dim>::active_cell_iterator> cells;
+    solid_tree.query(point, cells);
+    for (auto &cell : cells)
+      {
+        // The ghost cells are evaluated by their owners.
+        if (!cell->is_locally_owned() || !cell->point_inside(point))
+          continue;
+        Utils::GridInterpolator<dim, PETScWrappers::MPI::Vector> interpolator(
+          solid_solver.dof_handler, point, {}, cell);
+        Vector<double> value(dim);
+        interpolator.point_value(ghosted_solid_velocity, value);
+        std::copy(value.begin(), value.end(), values);
+        interpolator.point_value(ghosted_solid_acceleration, value);
+        std::copy(value.begin(), value.end(), values + dim);
+        values[2 * dim] = cell->material_id();
+        return true;
+      }
+    return false;
+  }
+
+  template <int dim>
+  bool DistributedFSI<dim>::evaluate_fluid(const Point<dim> &point,
+                                           double *values)
+  {
+    std::vector<typename DoFHandler<dim>::active_cell_iterator> cells;
+    fluid_tree.query(point, cells);
+    for (auto &cell : cells)
+      {
+        if (!cell->is_locally_owned() || !cell->point_inside(point))
+          continue;
+        Utils::GridInterpolator<dim, PETScWrappers::MPI::BlockVector>
+          interpolator(fluid_solver.dof_handler, point, {}, cell);
+        Vector<double> value(dim + 1);
+        std::vector<Tensor<1, dim>> gradient(dim + 1, Tensor<1, dim>());
+        interpolator.point_value(fluid_solver.present_solution, value);
+        interpolator.point_gradient(fluid_solver.present_solution, gradient);
+        values[0] = value[dim];
+        for (unsigned int i = 0; i < dim; ++i)
+          {
+            for (unsigned int j = 0; j < dim; ++j)
+              {
+                values[1 + i * dim + j] = gradient[i][j];
+              }
+          }
+        return true;
+      }
+    return false;
+  }
+
+  template <int dim>
+  void DistributedFSI<dim>::update_indicator()
+  {
+    Utils::ProfilingScope timer_section(timer, "Update indicator");
+    move_solid_mesh(true);
+    std::vector<typename DoFHandler<dim>::active_cell_iterator> cells;
+    std::vector<Point<dim>> centers;
+    for (auto f_cell = fluid_solver.dof_handler.begin_active();
+         f_cell != fluid_solver.dof_handler.end();
+         ++f_cell)
+      {
+        if (f_cell->is_locally_owned())
+          {
+            cells.push_back(f_cell);
+            centers.push_back(f_cell->center());
+          }
+      }
+    // Every center gets the solid velocity, acceleration and material id.
+    const unsigned int n_values = 2 * dim + 1;
+    std::vector<double> values;
+    std::vector<bool> found;
+    exchange_points(
+      centers,
+      n_values,
+      owned_box(solid_solver.dof_handler),
+      [this](const Point<dim> &point, double *v) {
+        return evaluate_solid(point, v);
+      },
+      10,
+      values,
+      found);
+
+    FEValues<dim> &fe_values = fluid_center_values;
+    auto &property = fluid_solver.cell_property;
+    for (unsigned int c = 0; c < cells.size(); ++c)
+      {
+        const unsigned int cell_index = cells[c]->active_cell_index();
+        property.indicator[cell_index] = found[c];
+        property.fsi_acceleration[cell_index] = 0;
+        property.fsi_stress[cell_index] = 0;
+        if (!found[c])
+          continue;
+        fe_values.reinit(cells[c]);
+        // Fluid total acceleration at cell center
+        const Tensor<1, dim> fluid_acc =
+          fluid_solver.fsi_fluid_acceleration(fe_values, time.get_delta_t());
+        // FSI acceleration term:
+        for (unsigned int i = 0; i < dim; ++i)
+          {
+            property.fsi_acceleration[cell_index][i] =
+              fluid_acc[i] - values[c * n_values + dim + i];
+          }
+        property.material_id[cell_index] = values[c * n_values + 2 * dim];
+      }
+  }
+
+  template <int dim>
+  void DistributedFSI<dim>::collect_support_points()
+  {
+    support_points.clear();
+    support_dofs.clear();
+    support_components.clear();
+    if (!use_dirichlet_bc)
+      {
+        return;
+      }
+    const MappingQGeneric<dim> &mapping = fluid_mapping;
+    const std::vector<Point<dim>> &unit_points =
+      fluid_solver.fe.get_unit_support_points();
+    std::vector<types::global_dof_index> dof_indices(
+      fluid_solver.fe.dofs_per_cell);
+    const std::vector<unsigned int> velocity_dofs =
+      Utils::fsi_velocity_dofs(fluid_solver.fe);
+    // Only the locally relevant dofs can be touched.
+    std::vector<bool> dof_touched(
+      fluid_solver.locally_relevant_dofs.n_elements(), false);
+
+    // The ghost cells must be taken care of to set correct Dirichlet BCs.
+    for (auto f_cell = fluid_solver.dof_handler.begin_active();
+         f_cell != fluid_solver.dof_handler.end();
+         ++f_cell)
+      {
+        if (f_cell->is_artificial())
+          continue;
+        f_cell->get_dof_indices(dof_indices);
+        for (const unsigned int i : velocity_dofs)
+          {
+            const unsigned int index =
+              fluid_solver.locally_relevant_dofs.index_within_set(
+                dof_indices[i]);
+            if (dof_touched[index])
+              continue;
+            dof_touched[index] = true;
+            support_points.push_back(
+              mapping.transform_unit_to_real_cell(f_cell, unit_points[i]));
+            support_dofs.push_back(dof_indices[i]);
+            support_components.push_back(
+              fluid_solver.fe.system_to_component_index(i).first);
+          }
+      }
+  }
+
+  template <int dim>
+  void DistributedFSI<dim>::find_fluid_bc()
+  {
+    if (!use_dirichlet_bc)
+      {
+        return;
+      }
+    Utils::ProfilingScope timer_section(timer, "Find fluid BC");
+    move_solid_mesh(true);
+
+    // The nonzero Dirichlet BCs (to set the velocity) and zero Dirichlet
+    // BCs (to set the velocity increment) for the artificial fluid domain.
+    AffineConstraints<double> inner_nonzero, inner_zero;
+    inner_nonzero.reinit(fluid_solver.locally_relevant_dofs);
+    inner_zero.reinit(fluid_solver.locally_relevant_dofs);
+
+    const unsigned int n_values = 2 * dim + 1;
+    std::vector<double> values;
+    std::vector<bool> found;
+    exchange_points(
+      support_points,
+      n_values,
+      owned_box(solid_solver.dof_handler),
+      [this](const Point<dim> &point, double *v) {
+        return evaluate_solid(point, v);
+      },
+      20,
+      values,
+      found);
+
+    for (unsigned int k = 0; k < support_points.size(); ++k)
+      {
+        if (!found[k])
+          continue;
+        auto line = support_dofs[k];
+        inner_nonzero.add_line(line);
+        inner_zero.add_line(line);
+        // Note that we are setting the value of the constraint to the
+        // velocity delta!
+        inner_nonzero.set_inhomogeneity(
+          line,
+          values[k * n_values + support_components[k]] -
+            fluid_solver.present_solution(line));
+      }
+    inner_nonzero.close();
+    inner_zero.close();
+    fluid_solver.nonzero_constraints.merge(
+      inner_nonzero,
+      AffineConstraints<double>::MergeConflictBehavior::left_object_wins);
+    fluid_solver.zero_constraints.merge(
+      inner_zero,
+      AffineConstraints<double>::MergeConflictBehavior::left_object_wins);
+  }
+
+  template <int dim>
+  void DistributedFSI<dim>::find_solid_bc()
+  {
+    Utils::ProfilingScope timer_section(timer, "Find solid BC");
+    // Must use the updated solid coordinates
+    move_solid_mesh(true);
+    // Solid FEFaceValues to get the normal
+    FEFaceValues<dim> fe_face_values(solid_solver.fe,
+                                     solid_solver.face_quad_formula,
+                                     update_quadrature_points |
+                                       update_normal_vectors);
+    const unsigned int n_face_q_points = solid_solver.face_quad_formula.size();
+
+    // First pass: collect the quadrature points and normals on the boundary
+    // faces of the locally owned solid cells.
+    std::vector<Point<dim>> q_points;
+    std::vector<Tensor<1, dim>> normals;
+    for (auto s_cell = solid_solver.dof_handler.begin_active();
+         s_cell != solid_solver.dof_handler.end();
+         ++s_cell)
+      {
+        if (!s_cell->is_locally_owned())
+          continue;
+        for (unsigned int f = 0; f < GeometryInfo<dim>::faces_per_cell; ++f)
+          {
+            if (s_cell->face(f)->at_boundary())
+              {
+                fe_face_values.reinit(s_cell, f);
+                for (unsigned int q = 0; q < n_face_q_points; ++q)
+                  {
+                    q_points.push_back(fe_face_values.quadrature_point(q));
+                    normals.push_back(fe_face_values.normal_vector(q));
+                  }
+              }
+          }
+      }
+
+    // Second pass: every point gets the fluid pressure and velocity
+    // gradient from the fluid process that owns it.
+    const unsigned int n_values = 1 + dim * dim;
+    std::vector<double> values;
+    std::vector<bool> found;
+    exchange_points(
+      q_points,
+      n_values,
+      owned_box(fluid_solver.dof_handler),
+      [this](const Point<dim> &point, double *v) {
+        return evaluate_fluid(point, v);
+      },
+      30,
+      values,
+      found);
+
+    // Third pass: compute the traction in the same order as collected. The
+    // points outside of the fluid are traction-free.
+    unsigned int n = 0;
+    for (auto s_cell = solid_solver.dof_handler.begin_active();
+         s_cell != solid_solver.dof_handler.end();
+         ++s_cell)
+      {
+        if (!s_cell->is_locally_owned())
+          continue;
+        auto ptr = solid_solver.cell_property.get_data(s_cell);
+        for (unsigned int f = 0; f < GeometryInfo<dim>::faces_per_cell; ++f)
+          {
+            if (s_cell->face(f)->at_boundary())
+              {
+                for (unsigned int q = 0; q < n_face_q_points; ++q, ++n)
+                  {
+                    ptr[f * n_face_q_points + q]->fsi_traction = 0;
+                    if (!found[n])
+                      continue;
+                    const double *entry = &values[n * n_values];
+                    // Compute stress
+                    SymmetricTensor<2, dim> sym_deformation;
+                    for (unsigned int i = 0; i < dim; ++i)
+                      {
+                        for (unsigned int j = 0; j < dim; ++j)
+                          {
+                            sym_deformation[i][j] = (entry[1 + i * dim + j] +
+                                                     entry[1 + j * dim + i]) /
+                                                    2;
+                          }
+                      }
+                    // \f$ \sigma = -p\bold{I} + \mu\nabla^S v\f$
+                    SymmetricTensor<2, dim> stress =
+                      -entry[0] * Physics::Elasticity::StandardTensors<dim>::I +
+                      2 * parameters.viscosity * sym_deformation;
+                    ptr[f * n_face_q_points + q]->fsi_traction =
+                      stress * normals[n];
+                  }
+              }
+          }
+      }
+  }
+
+  template <int dim>
+  void DistributedFSI<dim>::adapt_time_step()
+  {
+    // The distributed solid solvers do not report their Newton iterations,
+    // so the fluid proposal is used for both.
+    const Utils::TimeStepController controller(
+      parameters.min_time_step,
+      parameters.max_time_step,
+      parameters.target_cfl,
+      parameters.target_newton_iterations);
+    const double delta_t = controller.propose(
+      time, fluid_solver.cfl_number(), fluid_solver.newton_iterations);
+    time.set_delta_t(delta_t);
+    fluid_solver.time.set_delta_t(delta_t);
+    solid_solver.time.set_delta_t(delta_t);
+  }
+
+  template <int dim>
+  void DistributedFSI<dim>::run()
+  {
+    pcout << "Running with PETSc on "
+          << Utilities::MPI::n_mpi_processes(mpi_communicator)
+          << " MPI rank(s)..." << std::endl;
+
+    solid_solver.triangulation.refine_global(parameters.global_refinements[1]);
+    solid_solver.setup_dofs();
+    solid_solver.initialize_system();
+    fluid_solver.triangulation.refine_global(parameters.global_refinements[0]);
+    fluid_solver.setup_dofs();
+    fluid_solver.make_constraints();
+    fluid_solver.initialize_system();
+    // The fluid mesh does not change.
+    fluid_tree.rebuild();
+    collect_support_points();
+
+    pcout << "Number of fluid active cells and dofs: ["
+          << fluid_solver.triangulation.n_global_active_cells() << ", "
+          << fluid_solver.dof_handler.n_dofs() << "]" << std::endl
+          << "Number of solid active cells and dofs: ["
+          << solid_solver.triangulation.n_global_active_cells() << ", "
+          << solid_solver.dof_handler.n_dofs() << "]" << std::endl;
+    bool first_step = true;
+    while (time.end() - time.current() > 1e-12)
+      {
+        if (parameters.adaptive_time_step && !first_step)
+          {
+            adapt_time_step();
+          }
+        find_solid_bc();
+        // The solid solver works in the reference configuration.
+        move_solid_mesh(false);
+        {
+          Utils::ProfilingScope timer_section(timer, "Run solid solver");
+          solid_solver.run_one_step(first_step);
+        }
+        update_solid_ghosts();
+        update_indicator();
+        // Only the inner constraints change from step to step.
+        fluid_solver.reset_constraints(first_step);
+        find_fluid_bc();
+        {
+          Utils::ProfilingScope timer_section(timer, "Run fluid solver");
+          fluid_solver.run_one_step(true);
+        }
+        first_step = false;
+        time.increment();
+      }
+    move_solid_mesh(false);
+  }
+
+  template class DistributedFSI<2>;
+  template class DistributedFSI<3>;
+} // namespace MPI
@@ -7,8 +7,23 @@ namespace Fluid
     template <int dim>
     FluidSolver<dim>::~FluidSolver()
     {
+      cell_weight_connection.disconnect();
+      if (checkpoint_writer.joinable())
+        {
+          checkpoint_writer.join();
+        }
       timer.print_summary();
       timer2.print_summary();
+      if (parameters.timer_statistics)
+        {
+          timer.print_wall_time_statistics(mpi_communicator);
+          timer2.print_wall_time_statistics(mpi_communicator);
+        }
+      if (parameters.memory_report)
+        {
+          Utils::MemoryReport::print_peak_memory(
+            pcout.get_stream(), mpi_communicator, "Peak resident memory");
+        }
     }
 
     template <int dim>
@@ -34,20 +49,128 @@ namespace Fluid
         volume_quad_formula(parameters.fluid_velocity_degree + 1),
         face_quad_formula(parameters.fluid_velocity_degree + 1),
         parameters(parameters),
-        mpi_communicator(MPI_COMM_WORLD),
+        mpi_communicator(tria.get_communicator()),
         pcout(std::cout,
               Utilities::MPI::this_mpi_process(mpi_communicator) == 0),
+        // The pseudo time steps of the steady state mode are not written.
         time(parameters.end_time,
              parameters.time_step,
-             parameters.output_interval,
-             parameters.refinement_interval,
-             parameters.save_interval),
+             parameters.steady_state ? std::numeric_limits<double>::infinity()
+                                     : parameters.output_interval,
+             parameters.steady_state ? std::numeric_limits<double>::infinity()
+                                     : parameters.refinement_interval,
+             parameters.steady_state ? std::numeric_limits<double>::infinity()
+                                     : parameters.save_interval),
         timer(
           mpi_communicator, pcout, TimerOutput::never, TimerOutput::wall_times),
         timer2(
           mpi_communicator, pcout, TimerOutput::never, TimerOutput::wall_times),
-        boundary_values(bc)
+        cell_property_enabled(false),
+        boundary_values(bc),
+        linear_iterations(0),
+        newton_iterations(0),
+        steady_residual(0),
+        probes(dof_handler, mpi_communicator),
+        system_layout_hash(0),
+        checkpoint_key_index(-1),
+        checkpoints_since_key(0)
+    {
+      // The MPI initialization limits every process to one thread, the
+      // assembly uses as many as requested.
+      MultithreadInfo::set_thread_limit(parameters.n_threads == 0
+                                          ? numbers::invalid_unsigned_int
+                                          : parameters.n_threads);
+      using Tria = parallel::distributed::Triangulation<dim>;
+      cell_weight_connection = triangulation.signals.cell_weight.connect(
+        [this](const typename Tria::cell_iterator &cell,
+               const typename Tria::CellStatus status) {
+          return cell_weight(cell, status);
+        });
+      if (!parameters.fluid_probe_points.empty())
+        {
+          std::vector<std::string> names = {"u", "v", "w"};
+          names.resize(dim);
+          names.push_back("p");
+          probes.open("fluid_probes.csv", parameters.fluid_probe_points, names);
+        }
+    }
+
+    template <int dim>
+    double FluidSolver<dim>::cell_cost(
+      const typename DoFHandler<dim>::active_cell_iterator &cell) const
+    {
+      return cell_property.get_indicator(cell->active_cell_index()) == 1
+               ? parameters.artificial_fluid_cell_weight
+               : 1.0;
+    }
+
+    template <int dim>
+    double FluidSolver<dim>::local_cost() const
+    {
+      double cost = 0;
+      for (auto cell = dof_handler.begin_active(); cell != dof_handler.end();
+           ++cell)
+        {
+          if (cell->is_locally_owned())
+            {
+              cost += cell_cost(cell);
+            }
+        }
+      return cost;
+    }
+
+    template <int dim>
+    Tensor<1, dim>
+    FluidSolver<dim>::fsi_fluid_acceleration(const FEValues<dim> &fe_values,
+                                             const double delta_t) const
+    {
+      const FEValuesExtractors::Vector velocities(0);
+      std::vector<Tensor<1, dim>> dv(1);
+      fe_values[velocities].get_function_values(solution_increment, dv);
+      return dv[0] / delta_t;
+    }
+
+    template <int dim>
+    void FluidSolver<dim>::compute_cell_weights()
+    {
+      cell_weights.clear();
+      if (parameters.artificial_fluid_cell_weight == 1.0 &&
+          parameters.pml_cell_weight == 1.0)
+        return;
+      cell_weights.resize(triangulation.n_active_cells(), 0);
+      for (auto cell = dof_handler.begin_active(); cell != dof_handler.end();
+           ++cell)
+        {
+          if (cell->is_locally_owned())
+            {
+              cell_weights[cell->active_cell_index()] =
+                static_cast<unsigned int>(1000 * (cell_cost(cell) - 1.0));
+            }
+        }
+    }
+
+    template <int dim>
+    unsigned int FluidSolver<dim>::cell_weight(
+      const typename parallel::distributed::Triangulation<dim>::cell_iterator
+        &cell,
+      const typename parallel::distributed::Triangulation<dim>::CellStatus
+        status) const
     {
+      if (cell_weights.empty())
+        return 0;
+      // The children of a coarsened cell are still active.
+      if (status ==
+          parallel::distributed::Triangulation<dim>::CellStatus::CELL_COARSEN)
+        {
+          unsigned int weight = 0;
+          for (unsigned int i = 0; i < cell->n_children(); ++i)
+            {
+              weight = std::max(
+                weight, cell_weights[cell->child(i)->active_cell_index()]);
+            }
+          return weight;
+        }
+      return cell_weights[cell->active_cell_index()];
     }
 
     template <int dim>
@@ -55,16 +178,29 @@ namespace Fluid
     {
       // The first step is to associate DoFs with a given mesh.
       dof_handler.distribute_dofs(fe);
-      scalar_dof_handler.distribute_dofs(scalar_fe);
+      // The scalar dofs are set up again with the stress when needed.
+      scalar_dof_handler.clear();
+      stress.clear();
+      probes.reset();
+      // A difference to the last checkpoint needs the same dofs.
+      checkpoint_key.reset();
 
       // We renumber the components to have all velocity DoFs come before
       // the pressure DoFs to be able to split the solution vector in two blocks
       // which are separately accessed in the block preconditioner.
-      DoFRenumbering::Cuthill_McKee(dof_handler);
+      // component_wise keeps the order within each component, which is
+      // either Cuthill-McKee or the Morton order of the cells.
+      if (parameters.dof_ordering == "Hierarchical")
+        {
+          DoFRenumbering::hierarchical(dof_handler);
+        }
+      else
+        {
+          DoFRenumbering::Cuthill_McKee(dof_handler);
+        }
       std::vector<unsigned int> block_component(dim + 1, 0);
       block_component[dim] = 1;
       DoFRenumbering::component_wise(dof_handler, block_component);
-      DoFRenumbering::component_wise(scalar_dof_handler);
 
       dofs_per_block.resize(2);
       DoFTools::count_dofs_per_block(
@@ -89,9 +225,7 @@ namespace Fluid
       relevant_partitioning[1] =
         locally_relevant_dofs.get_view(dof_u, dof_u + dof_p);
 
-      locally_owned_scalar_dofs = scalar_dof_handler.locally_owned_dofs();
-      DoFTools::extract_locally_relevant_dofs(scalar_dof_handler,
-                                              locally_relevant_scalar_dofs);
+      partition_owned_cells();
 
       pcout << "   Number of active fluid cells: "
             << triangulation.n_global_active_cells() << std::endl
@@ -99,6 +233,34 @@ namespace Fluid
             << " (" << dof_u << '+' << dof_p << ')' << std::endl;
     }
 
+    template <int dim>
+    void FluidSolver<dim>::partition_owned_cells()
+    {
+      interior_cells.clear();
+      ghost_adjacent_cells.clear();
+      const IndexSet &owned_dofs = dof_handler.locally_owned_dofs();
+      std::vector<types::global_dof_index> dof_indices(fe.dofs_per_cell);
+      for (auto cell = dof_handler.begin_active(); cell != dof_handler.end();
+           ++cell)
+        {
+          if (!cell->is_locally_owned())
+            {
+              continue;
+            }
+          cell->get_dof_indices(dof_indices);
+          bool interior = true;
+          for (const auto index : dof_indices)
+            {
+              if (!owned_dofs.is_element(index))
+                {
+                  interior = false;
+                  break;
+                }
+            }
+          (interior ? interior_cells : ghost_adjacent_cells).push_back(cell);
+        }
+    }
+
     template <int dim>
     void FluidSolver<dim>::make_constraints()
     {
@@ -210,54 +372,199 @@ namespace Fluid
       }
       nonzero_constraints.close();
       zero_constraints.close();
+      static_nonzero_constraints.copy_from(nonzero_constraints);
+      static_zero_constraints.copy_from(zero_constraints);
+    }
+
+    template <int dim>
+    void FluidSolver<dim>::reset_constraints(const bool nonzero)
+    {
+      nonzero_constraints.copy_from(nonzero ? static_nonzero_constraints
+                                            : static_zero_constraints);
+      zero_constraints.copy_from(static_zero_constraints);
+    }
+
+    template <int dim>
+    void FluidSolver<dim>::setup_stress() const
+    {
+      if (!stress.empty())
+        {
+          return;
+        }
+      scalar_dof_handler.distribute_dofs(scalar_fe);
+      if (parameters.dof_ordering == "Hierarchical")
+        {
+          DoFRenumbering::hierarchical(scalar_dof_handler);
+        }
+      DoFRenumbering::component_wise(scalar_dof_handler);
+      locally_owned_scalar_dofs = scalar_dof_handler.locally_owned_dofs();
+      DoFTools::extract_locally_relevant_dofs(scalar_dof_handler,
+                                              locally_relevant_scalar_dofs);
+      stress = std::vector<std::vector<PETScWrappers::MPI::Vector>>(
+        dim,
+        std::vector<PETScWrappers::MPI::Vector>(
+          dim,
+          PETScWrappers::MPI::Vector(locally_owned_scalar_dofs,
+                                     mpi_communicator)));
     }
 
     template <int dim>
     void FluidSolver<dim>::setup_cell_property()
     {
+      if (!cell_property_enabled)
+        {
+          cell_property = CellProperty();
+          return;
+        }
       pcout << "   Setting up cell property..." << std::endl;
-      for (auto cell = triangulation.begin_active();
-           cell != triangulation.end();
+      const unsigned int n_cells = triangulation.n_active_cells();
+      cell_property.indicator.assign(n_cells, 0);
+      cell_property.fsi_acceleration.assign(n_cells, Tensor<1, dim>());
+      cell_property.fsi_stress.assign(n_cells, SymmetricTensor<2, dim>());
+      cell_property.material_id.assign(n_cells, 1);
+      cell_property.inactive.assign(n_cells, 0);
+    }
+
+    template <int dim>
+    bool FluidSolver<dim>::system_layout_changed()
+    {
+      // The sparsity pattern only depends on the dofs of the locally owned
+      // cells and on which dofs the constraints couple.
+      std::size_t hash = 0;
+      boost::hash_combine(hash, dof_handler.n_dofs());
+      std::vector<types::global_dof_index> dof_indices(fe.dofs_per_cell);
+      for (auto cell = dof_handler.begin_active(); cell != dof_handler.end();
            ++cell)
         {
           if (cell->is_locally_owned())
             {
-              cell_property.initialize(cell, 1);
-              const std::vector<std::shared_ptr<CellProperty>> p =
-                cell_property.get_data(cell);
-              p[0]->indicator = 0;
-              p[0]->fsi_acceleration = 0;
-              p[0]->fsi_stress = 0;
-              p[0]->material_id = 1;
+              cell->get_dof_indices(dof_indices);
+              boost::hash_range(hash, dof_indices.begin(), dof_indices.end());
+            }
+        }
+      for (const auto &line : nonzero_constraints.get_lines())
+        {
+          boost::hash_combine(hash, line.index);
+          for (const auto &entry : line.entries)
+            {
+              boost::hash_combine(hash, entry.first);
+            }
+        }
+      // The matrices are reinitialized collectively, so every process has to
+      // agree.
+      const bool changed =
+        Utilities::MPI::max(hash != system_layout_hash ? 1 : 0,
+                            mpi_communicator) == 1;
+      system_layout_hash = hash;
+      return changed;
+    }
+
+    template <int dim>
+    void FluidSolver<dim>::add_memory(Utils::MemoryReport &report) const
+    {
+      report.add("Fluid mesh and dofs",
+                 triangulation.memory_consumption() +
+                   dof_handler.memory_consumption() +
+                   scalar_dof_handler.memory_consumption());
+      report.add("Fluid constraints",
+                 zero_constraints.memory_consumption() +
+                   nonzero_constraints.memory_consumption() +
+                   static_zero_constraints.memory_consumption() +
+                   static_nonzero_constraints.memory_consumption());
+      report.add("Fluid system_matrix", system_matrix);
+      report.add("Fluid mass_matrix", mass_matrix);
+      report.add("Fluid mass_schur", mass_schur);
+      double vectors = present_solution.memory_consumption() +
+                       solution_increment.memory_consumption() +
+                       system_rhs.memory_consumption();
+      for (const auto &v : workspace)
+        {
+          vectors += v.memory_consumption();
+        }
+      for (const auto &v : solution_history)
+        {
+          vectors += v.memory_consumption();
+        }
+      for (const auto &row : stress)
+        {
+          for (const auto &v : row)
+            {
+              vectors += v.memory_consumption();
             }
         }
+      report.add("Fluid vectors", vectors);
+      report.add(
+        "Fluid cell properties",
+        MemoryConsumption::memory_consumption(cell_property.indicator) +
+          MemoryConsumption::memory_consumption(
+            cell_property.fsi_acceleration) +
+          MemoryConsumption::memory_consumption(cell_property.fsi_stress) +
+          MemoryConsumption::memory_consumption(cell_property.material_id) +
+          MemoryConsumption::memory_consumption(cell_property.inactive));
+    }
+
+    template <int dim>
+    void FluidSolver<dim>::print_memory_report() const
+    {
+      if (!parameters.memory_report)
+        return;
+      Utils::MemoryReport report(mpi_communicator);
+      add_memory(report);
+      report.print(pcout.get_stream(),
+                   "Fluid memory at time step " +
+                     Utilities::int_to_string(time.get_timestep()));
     }
 
     template <int dim>
     void FluidSolver<dim>::initialize_system()
     {
-      system_matrix.clear();
-      mass_matrix.clear();
-      mass_schur.clear();
-
-      BlockDynamicSparsityPattern dsp(dofs_per_block, dofs_per_block);
-      DoFTools::make_sparsity_pattern(dof_handler, dsp, nonzero_constraints);
-      sparsity_pattern.copy_from(dsp);
-      SparsityTools::distribute_sparsity_pattern(
-        dsp,
-        dof_handler.locally_owned_dofs_per_processor(),
-        mpi_communicator,
-        locally_relevant_dofs);
-
-      system_matrix.reinit(owned_partitioning, dsp, mpi_communicator);
-      mass_matrix.reinit(owned_partitioning, dsp, mpi_communicator);
-
-      // Compute the sparsity pattern for mass schur in advance.
-      // The only nonzero block is (1, 1), which is the same as \f$BB^T\f$.
-      BlockDynamicSparsityPattern schur_dsp(dofs_per_block, dofs_per_block);
-      schur_dsp.block(1, 1).compute_mmult_pattern(sparsity_pattern.block(1, 0),
-                                                  sparsity_pattern.block(0, 1));
-      mass_schur.reinit(owned_partitioning, schur_dsp, mpi_communicator);
+      const bool mass_matrices = needs_mass_matrices();
+      if (system_layout_changed())
+        {
+          system_matrix.clear();
+          mass_matrix.clear();
+          mass_schur.clear();
+
+          BlockDynamicSparsityPattern dsp(dofs_per_block, dofs_per_block);
+          DoFTools::make_sparsity_pattern(
+            dof_handler, dsp, nonzero_constraints);
+
+          // Compute the sparsity pattern for mass schur in advance.
+          // The only nonzero block is (1, 1), which is the same as
+          // \f$BB^T\f$.
+          BlockDynamicSparsityPattern schur_dsp(dofs_per_block,
+                                                dofs_per_block);
+          if (mass_matrices)
+            {
+              schur_dsp.block(1, 1).compute_mmult_pattern(dsp.block(1, 0),
+                                                          dsp.block(0, 1));
+            }
+
+          SparsityTools::distribute_sparsity_pattern(
+            dsp,
+            dof_handler.locally_owned_dofs_per_processor(),
+            mpi_communicator,
+            locally_relevant_dofs);
+
+          system_matrix.reinit(owned_partitioning, dsp, mpi_communicator);
+          if (mass_matrices)
+            {
+              mass_matrix.reinit(owned_partitioning, dsp, mpi_communicator);
+              mass_schur.reinit(
+                owned_partitioning, schur_dsp, mpi_communicator);
+            }
+        }
+      else
+        {
+          // Same dofs and constraints, e.g. after a restart or a refinement
+          // that did not change the mesh: keep the matrices.
+          system_matrix = 0;
+          if (mass_matrices)
+            {
+              mass_matrix = 0;
+              mass_schur = 0;
+            }
+        }
 
       // present_solution is ghosted because it is used in the
       // output and mesh refinement functions.
@@ -268,23 +575,25 @@ namespace Fluid
       // system_rhs is non-ghosted because it is only used in the linear
       // solver and residual evaluation.
       system_rhs.reinit(owned_partitioning, mpi_communicator);
+      workspace.resize(3);
+      for (auto &buffer : workspace)
+        {
+          buffer.reinit(owned_partitioning, mpi_communicator);
+        }
+      assembly_evaluation_point.reinit(
+        owned_partitioning, relevant_partitioning, mpi_communicator);
+      assembly_present_solution.reinit(
+        owned_partitioning, relevant_partitioning, mpi_communicator);
 
       // Cell property
       setup_cell_property();
-
-      stress = std::vector<std::vector<PETScWrappers::MPI::Vector>>(
-        dim,
-        std::vector<PETScWrappers::MPI::Vector>(
-          dim,
-          PETScWrappers::MPI::Vector(locally_owned_scalar_dofs,
-                                     mpi_communicator)));
     }
 
     template <int dim>
     void FluidSolver<dim>::refine_mesh(const unsigned int min_grid_level,
                                        const unsigned int max_grid_level)
     {
-      TimerOutput::Scope timer_section(timer, "Refine mesh");
+      Utils::ProfilingScope timer_section(timer, "Refine mesh");
 
       Vector<float> estimated_error_per_cell(triangulation.n_active_cells());
       FEValuesExtractors::Vector velocity(0);
@@ -320,10 +629,12 @@ namespace Fluid
 
       triangulation.prepare_coarsening_and_refinement();
 
-      trans.prepare_for_coarsening_and_refinement(present_solution);
+      trans.prepare_for_coarsening_and_refinement(solutions_to_transfer());
 
-      // Refine the mesh
+      // Refine the mesh, and partition it with the cost of the cells
+      compute_cell_weights();
       triangulation.execute_coarsening_and_refinement();
+      cell_weights.clear();
 
       // Reinitialize the system
       setup_dofs();
@@ -331,19 +642,134 @@ namespace Fluid
       initialize_system();
 
       // Transfer solution
-      // Need a non-ghosted vector for interpolation
-      PETScWrappers::MPI::BlockVector tmp;
-      tmp.reinit(owned_partitioning, mpi_communicator);
-      tmp = 0;
-      trans.interpolate(tmp);
-      nonzero_constraints.distribute(tmp); // Is this line necessary?
-      present_solution = tmp;
+      interpolate_solutions(trans);
+    }
+
+    template <int dim>
+    std::vector<const PETScWrappers::MPI::BlockVector *>
+    FluidSolver<dim>::solutions_to_transfer() const
+    {
+      std::vector<const PETScWrappers::MPI::BlockVector *> solutions{
+        &present_solution};
+      for (const auto &solution : solution_history)
+        {
+          solutions.push_back(&solution);
+        }
+      return solutions;
+    }
+
+    template <int dim>
+    void FluidSolver<dim>::interpolate_solutions(
+      parallel::distributed::SolutionTransfer<dim,
+                                              PETScWrappers::MPI::BlockVector>
+        &trans)
+    {
+      // Need non-ghosted vectors for interpolation
+      std::vector<PETScWrappers::MPI::BlockVector> buffers(
+        1 + solution_history.size());
+      std::vector<PETScWrappers::MPI::BlockVector *> pointers;
+      for (auto &buffer : buffers)
+        {
+          buffer.reinit(owned_partitioning, mpi_communicator);
+          buffer = 0;
+          pointers.push_back(&buffer);
+        }
+      trans.interpolate(pointers);
+      for (auto &buffer : buffers)
+        {
+          nonzero_constraints.distribute(buffer); // Is this line necessary?
+        }
+      present_solution = buffers[0];
+      for (unsigned int i = 0; i < solution_history.size(); ++i)
+        {
+          solution_history[i].reinit(
+            owned_partitioning, relevant_partitioning, mpi_communicator);
+          solution_history[i] = buffers[i + 1];
+        }
+    }
+
+    template <int dim>
+    void FluidSolver<dim>::predict_solution_change(
+      PETScWrappers::MPI::BlockVector &change)
+    {
+      // A non-ghosted vector of the right size, e.g. the workspace, is
+      // reused.
+      if (change.has_ghost_elements() || change.size() != dof_handler.n_dofs())
+        {
+          change.reinit(owned_partitioning, mpi_communicator);
+        }
+      change = 0;
+      // The steady residual is only measured without a predictor.
+      if (parameters.fluid_predictor_order == 0 || parameters.steady_state)
+        {
+          return;
+        }
+      // The Lagrange polynomial through the present solution u_0 and the
+      // history u_j, evaluated at the current time. Since the weights sum
+      // up to 1, the change is the sum of w_j (u_j - u_0) over the history.
+      const double t = time.current();
+      const double t0 = time.previous();
+      PETScWrappers::MPI::BlockVector &present = workspace[1];
+      PETScWrappers::MPI::BlockVector &difference = workspace[2];
+      present = present_solution;
+      for (unsigned int j = 0; j < solution_history.size(); ++j)
+        {
+          const double tj = solution_history_times[j];
+          double weight = (t - t0) / (tj - t0);
+          for (unsigned int k = 0; k < solution_history.size(); ++k)
+            {
+              if (k != j)
+                {
+                  weight *= (t - solution_history_times[k]) /
+                            (tj - solution_history_times[k]);
+                }
+            }
+          difference = solution_history[j];
+          difference -= present;
+          change.add(weight, difference);
+        }
+      // The boundary values and the hanging nodes are given by the
+      // constraints, not by the extrapolation.
+      zero_constraints.distribute(change);
+
+      solution_history.insert(solution_history.begin(), present_solution);
+      solution_history_times.insert(solution_history_times.begin(), t0);
+      if (solution_history.size() > parameters.fluid_predictor_order)
+        {
+          solution_history.resize(parameters.fluid_predictor_order);
+          solution_history_times.resize(parameters.fluid_predictor_order);
+        }
     }
 
     template <int dim>
     void FluidSolver<dim>::output_results(const unsigned int output_index) const
     {
-      TimerOutput::Scope timer_section(timer, "Output results");
+      Utils::ProfilingScope timer_section(timer, "Output results");
+
+      // The stress is zero if it has not been updated since the dofs
+      // changed.
+      setup_stress();
+      if (in_situ_hook && !in_situ_hook({output_index,
+                                         time.current(),
+                                         dof_handler,
+                                         scalar_dof_handler,
+                                         present_solution,
+                                         stress,
+                                         cell_property.indicator}))
+        {
+          return;
+        }
+      if (parameters.async_output)
+        {
+          // Every process reports the failed writes of the previous
+          // outputs.
+          if (!output_writer)
+            {
+              output_writer = std::make_unique<Utils::BackgroundWriter>(
+                parameters.output_queue_length);
+            }
+          output_writer->check(mpi_communicator);
+        }
 
       pcout << "Writing results..." << std::endl;
       std::vector<std::string> solution_names(dim, "velocity");
@@ -364,7 +790,12 @@ namespace Fluid
           dim, DataComponentInterpretation::component_is_part_of_vector);
       data_component_interpretation.push_back(
         DataComponentInterpretation::component_is_scalar);
-      DataOut<dim> data_out;
+      const Utils::OutputRegion<dim> region(parameters.fluid_output_box,
+                                            parameters.fluid_output_plane);
+      Utils::FilteredDataOut<dim> data_out(
+        [&region](const typename DataOut<dim>::cell_iterator &cell) {
+          return region.contains(cell);
+        });
       data_out.attach_dof_handler(dof_handler);
       // vector to be output must be ghosted
       data_out.add_data_vector(present_solution,
@@ -388,8 +819,8 @@ namespace Fluid
         {
           if (cell->is_locally_owned())
             {
-              auto p = cell_property.get_data(cell);
-              ind[cell->active_cell_index()] = p[0]->indicator;
+              ind[cell->active_cell_index()] =
+                cell_property.get_indicator(cell->active_cell_index());
             }
         }
       data_out.add_data_vector(ind, "Indicator");
@@ -403,9 +834,10 @@ namespace Fluid
         {
           if (cell->is_locally_owned())
             {
-              auto p = cell_property.get_data(cell);
-              fsi_acc_x[cell->active_cell_index()] = p[0]->fsi_acceleration[0];
-              fsi_acc_y[cell->active_cell_index()] = p[0]->fsi_acceleration[1];
+              const auto a =
+                cell_property.get_fsi_acceleration(cell->active_cell_index());
+              fsi_acc_x[cell->active_cell_index()] = a[0];
+              fsi_acc_y[cell->active_cell_index()] = a[1];
             }
         }
       data_out.add_data_vector(fsi_acc_x, "fsi_force_x");
@@ -418,9 +850,8 @@ namespace Fluid
             {
               if (cell->is_locally_owned())
                 {
-                  auto p = cell_property.get_data(cell);
-                  fsi_acc_z[cell->active_cell_index()] =
-                    p[0]->fsi_acceleration[2];
+                  const unsigned int i = cell->active_cell_index();
+                  fsi_acc_z[i] = cell_property.get_fsi_acceleration(i)[2];
                 }
             }
           data_out.add_data_vector(fsi_acc_z, "fsi_force_z");
@@ -437,75 +868,324 @@ namespace Fluid
           data_out.add_data_vector(scalar_dof_handler, tmp_stress[2][2], "Szz");
         }
 
-      data_out.build_patches(parameters.fluid_pressure_degree);
+      data_out.build_patches(parameters.fluid_output_subdivisions > 0
+                               ? parameters.fluid_output_subdivisions
+                               : parameters.fluid_pressure_degree);
 
       std::string basename =
         "fluid" + Utilities::int_to_string(output_index, 6) + "-";
 
-      std::string filename =
-        basename +
-        Utilities::int_to_string(triangulation.locally_owned_subdomain(), 4) +
-        ".vtu";
-
-      std::ofstream output(filename);
-      data_out.write_vtu(output);
-
-      if (Utilities::MPI::this_mpi_process(mpi_communicator) == 0)
+      // The files are written from the patches, which no longer need the
+      // mesh and the vectors, in the background if requested.
+      std::function<void()> write;
+      std::vector<std::string> filenames;
+      if (parameters.n_output_groups > 0)
+        {
+          // Written collectively, thus always at the output step.
+          if (!vtu_writer)
+            {
+              vtu_writer = std::make_unique<Utils::GroupedVtuWriter<dim>>(
+                mpi_communicator, parameters.n_output_groups);
+            }
+          filenames = vtu_writer->write(data_out, basename);
+        }
+      else
         {
+          std::string filename =
+            basename +
+            Utilities::int_to_string(triangulation.locally_owned_subdomain(),
+                                     4) +
+            ".vtu";
+
+          write = [patches = data_out.release_patches(), filename]() {
+            std::ofstream output(filename);
+            patches->write_vtu(output);
+          };
           for (unsigned int i = 0;
                i < Utilities::MPI::n_mpi_processes(mpi_communicator);
                ++i)
             {
-              times_and_names.push_back(
-                {time.current(),
-                 basename + Utilities::int_to_string(i, 4) + ".vtu"});
+              filenames.push_back(basename + Utilities::int_to_string(i, 4) +
+                                  ".vtu");
+            }
+        }
+
+      if (Utilities::MPI::this_mpi_process(mpi_communicator) == 0)
+        {
+          for (const auto &filename : filenames)
+            {
+              times_and_names.push_back({time.current(), filename});
             }
-          std::ofstream pvd_output("fluid.pvd");
-          DataOutBase::write_pvd_record(pvd_output, times_and_names);
+          write = [write, records = times_and_names]() {
+            if (write)
+              {
+                write();
+              }
+            std::ofstream pvd_output("fluid.pvd");
+            DataOutBase::write_pvd_record(pvd_output, records);
+          };
+        }
+
+      if (!write)
+        {
+          return;
+        }
+      if (!parameters.async_output)
+        {
+          write();
+          return;
+        }
+      output_writer->submit(std::move(write));
+    }
+
+    template <int dim>
+    std::string
+    FluidSolver<dim>::checkpoint_data_file(const std::string &checkpoint_file,
+                                           const unsigned int process) const
+    {
+      return checkpoint_file + "_" + Utilities::int_to_string(process, 4);
+    }
+
+    template <int dim>
+    void FluidSolver<dim>::finish_checkpoint()
+    {
+      if (checkpoint_writer.joinable())
+        {
+          checkpoint_writer.join();
         }
+      // The files are only complete once every process is done.
+      MPI_Barrier(mpi_communicator);
+    }
+
+    template <int dim>
+    int FluidSolver<dim>::checkpoint_key_of(
+      const std::string &checkpoint_file) const
+    {
+      // All the processes have the same key, look at the first one. The
+      // key is in the header whatever the current setting, so a key that
+      // was written with compression is never removed once it is off.
+      std::ifstream in(checkpoint_data_file(checkpoint_file, 0),
+                       std::ios::binary);
+      unsigned int header[3];
+      int key = -1;
+      in.read(reinterpret_cast<char *>(header), sizeof(header));
+      in.read(reinterpret_cast<char *>(&key), sizeof(key));
+      return in ? key : -1;
     }
 
     template <int dim>
     void FluidSolver<dim>::save_checkpoint(const int output_index)
     {
+      const unsigned int n_processes =
+        Utilities::MPI::n_mpi_processes(mpi_communicator);
+      if (output_writer)
+        {
+          // The outputs up to the checkpoint are complete when it is.
+          output_writer->wait();
+          output_writer->check(mpi_communicator);
+        }
+      if (parameters.async_checkpoint)
+        {
+          finish_checkpoint();
+        }
       if (Utilities::MPI::this_mpi_process(mpi_communicator) == 0)
         {
           // Specify the current working path
           fs::path local_path = fs::current_path();
-          // A set to store all the filenames for checkpoints
-          std::set<fs::path> checkpoints;
-          // Find the checkpoints and remove excess ones
-          // Only keep the latest one
+          // Find the checkpoints and remove excess ones, keeping the latest
+          // ones and the complete checkpoints they are the differences to.
+          std::vector<int> checkpoints;
           for (const auto &p : fs::directory_iterator(local_path))
             {
               if (p.path().extension() == ".fluid_checkpoint")
                 {
-                  checkpoints.insert(p.path());
+                  checkpoints.push_back(
+                    Utilities::string_to_int(p.path().stem()));
                 }
             }
-          while (checkpoints.size() > 1)
+          auto name = [](const int step) {
+            return Utilities::int_to_string(step, 6) + ".fluid_checkpoint";
+          };
+          const std::vector<int> stale = Utils::stale_checkpoints(
+            checkpoints, parameters.n_kept_checkpoints, [&](const int step) {
+              return checkpoint_key_of(name(step));
+            });
+          for (const int step : stale)
             {
-              pcout << "Removing " << *checkpoints.begin() << std::endl;
-              fs::path to_be_removed(*checkpoints.begin());
+              fs::path to_be_removed(local_path);
+              to_be_removed.append(name(step));
+              pcout << "Removing " << to_be_removed << std::endl;
+              fs::remove(to_be_removed);
+              for (unsigned int i = 0; i < n_processes; ++i)
+                {
+                  fs::remove(checkpoint_data_file(to_be_removed.string(), i));
+                }
+              to_be_removed.replace_extension(".fluid_record");
               fs::remove(to_be_removed);
               to_be_removed.replace_extension(".fluid_checkpoint.info");
               fs::remove(to_be_removed);
-              checkpoints.erase(checkpoints.begin());
             }
+          time.save_restart_record(
+            Utilities::int_to_string(output_index, 6) + ".fluid_record",
+            times_and_names);
         }
       // Name the checkpoint file
       std::string checkpoint_file = Utilities::int_to_string(output_index, 6);
       checkpoint_file.append(".fluid_checkpoint");
-      // Save the solution
-      parallel::distributed::SolutionTransfer<dim,
-                                              PETScWrappers::MPI::BlockVector>
-        sol_trans(dof_handler);
-      sol_trans.prepare_serialization(present_solution);
+      if (!parameters.async_checkpoint && !parameters.checkpoint_compression)
+        {
+          // Save the solution
+          parallel::distributed::
+            SolutionTransfer<dim, PETScWrappers::MPI::BlockVector>
+              sol_trans(dof_handler);
+          sol_trans.prepare_serialization(present_solution);
+          triangulation.save(checkpoint_file.c_str());
+          pcout << "Checkpoint file successfully saved at time step "
+                << output_index << "!" << std::endl;
+          return;
+        }
+
+      // Only the mesh is saved collectively. The locally owned solution is
+      // copied and written without MPI calls, by a background thread if the
+      // checkpoint is asynchronous.
       triangulation.save(checkpoint_file.c_str());
+      std::vector<std::vector<PetscScalar>> values(owned_partitioning.size());
+      for (unsigned int b = 0; b < owned_partitioning.size(); ++b)
+        {
+          present_solution.block(b).extract_subvector_to(
+            owned_partitioning[b].get_index_vector(), values[b]);
+        }
+      const bool compress = parameters.checkpoint_compression;
+      // Every process makes the same choice, the dofs are distributed
+      // collectively.
+      int key = -1;
+      std::shared_ptr<const std::vector<std::vector<PetscScalar>>> reference;
+      if (compress)
+        {
+          if (checkpoint_key &&
+              checkpoints_since_key + 1 < parameters.checkpoint_key_interval)
+            {
+              key = checkpoint_key_index;
+              reference = checkpoint_key;
+              ++checkpoints_since_key;
+            }
+          else
+            {
+              checkpoint_key =
+                std::make_shared<const std::vector<std::vector<PetscScalar>>>(
+                  values);
+              checkpoint_key_index = output_index;
+              checkpoints_since_key = 0;
+            }
+        }
+      const std::string data_file = checkpoint_data_file(
+        checkpoint_file,
+        Utilities::MPI::this_mpi_process(mpi_communicator));
+      auto write = [data_file,
+                    n_processes,
+                    compress,
+                    key,
+                    reference,
+                    values = std::move(values)]() {
+        std::ofstream out(data_file + ".tmp", std::ios::binary);
+        // The header holds the number of processes and blocks, whether the
+        // values are compressed, and the key, which is -1 if uncompressed.
+        const unsigned int header[3] = {
+          n_processes, static_cast<unsigned int>(values.size()), compress};
+        const unsigned int n_blocks = header[1];
+        out.write(reinterpret_cast<const char *>(header), sizeof(header));
+        out.write(reinterpret_cast<const char *>(&key), sizeof(key));
+        for (unsigned int b = 0; b < n_blocks; ++b)
+          {
+            const std::uint64_t size = values[b].size();
+            out.write(reinterpret_cast<const char *>(&size), sizeof(size));
+            if (!compress)
+              {
+                out.write(reinterpret_cast<const char *>(values[b].data()),
+                          size * sizeof(PetscScalar));
+                continue;
+              }
+            const std::string data = Utils::encode_values(
+              values[b], reference ? &(*reference)[b] : nullptr);
+            const std::uint64_t n_bytes = data.size();
+            out.write(reinterpret_cast<const char *>(&n_bytes),
+                      sizeof(n_bytes));
+            out.write(data.data(), n_bytes);
+          }
+        out.close();
+        // A checkpoint interrupted while writing is never picked up.
+        std::error_code error;
+        fs::rename(data_file + ".tmp", data_file, error);
+      };
+      if (parameters.async_checkpoint)
+        {
+          checkpoint_writer = std::thread(std::move(write));
+          pcout << "Checkpoint file of time step " << output_index
+                << " is being saved in the background!" << std::endl;
+          return;
+        }
+      write();
+      MPI_Barrier(mpi_communicator);
       pcout << "Checkpoint file successfully saved at time step "
             << output_index << "!" << std::endl;
     }
 
+    template <int dim>
+    void FluidSolver<dim>::read_checkpoint_data(
+      const std::string &checkpoint_file,
+      std::vector<std::vector<PetscScalar>> &values) const
+    {
+      const std::string data_file = checkpoint_data_file(
+        checkpoint_file, Utilities::MPI::this_mpi_process(mpi_communicator));
+      std::ifstream in(data_file, std::ios::binary);
+      AssertThrow(in,
+                  ExcMessage("Missing " + data_file +
+                             ", remove the incomplete checkpoint!"));
+      unsigned int header[3];
+      int key = -1;
+      in.read(reinterpret_cast<char *>(header), sizeof(header));
+      in.read(reinterpret_cast<char *>(&key), sizeof(key));
+      const unsigned int n_blocks = header[1];
+      AssertThrow(
+        header[0] == Utilities::MPI::n_mpi_processes(mpi_communicator) &&
+          n_blocks == owned_partitioning.size(),
+        ExcMessage("The checkpoint was saved with a different number "
+                   "of processes!"));
+      // The file tells if it is compressed, the setting may have changed
+      // since it was written.
+      const bool compressed = header[2];
+      std::vector<std::vector<PetscScalar>> reference;
+      if (key >= 0)
+        {
+          read_checkpoint_data(
+            Utilities::int_to_string(key, 6) + ".fluid_checkpoint", reference);
+        }
+      values.resize(n_blocks);
+      for (unsigned int b = 0; b < n_blocks; ++b)
+        {
+          std::uint64_t size;
+          in.read(reinterpret_cast<char *>(&size), sizeof(size));
+          AssertThrow(size == owned_partitioning[b].n_elements(),
+                      ExcMessage("Inconsistent checkpoint data!"));
+          if (!compressed)
+            {
+              values[b].resize(size);
+              in.read(reinterpret_cast<char *>(values[b].data()),
+                      size * sizeof(PetscScalar));
+              continue;
+            }
+          std::uint64_t n_bytes;
+          in.read(reinterpret_cast<char *>(&n_bytes), sizeof(n_bytes));
+          std::string data(n_bytes, '\0');
+          in.read(&data[0], n_bytes);
+          Utils::decode_values(
+            data, values[b], key >= 0 ? &reference[b] : nullptr);
+          AssertThrow(values[b].size() == size,
+                      ExcMessage("Inconsistent checkpoint data!"));
+        }
+      AssertThrow(in, ExcMessage("Truncated checkpoint data " + data_file));
+    }
+
     template <int dim>
     bool FluidSolver<dim>::load_checkpoint()
     {
@@ -534,82 +1214,168 @@ namespace Fluid
       // set time step load the checkpoint file
       pcout << "Loading checkpoint file " << checkpoint_file.filename().c_str()
             << "!" << std::endl;
-      triangulation.load(checkpoint_file.filename().c_str());
+      // The solution files of the processes hold their locally owned dofs,
+      // so the saved partition is kept instead of a uniform one, which
+      // would differ from a weighted partition.
+      const bool per_process_data =
+        parameters.async_checkpoint || parameters.checkpoint_compression;
+      triangulation.load(checkpoint_file.filename().c_str(),
+                         !per_process_data);
       setup_dofs();
       make_constraints();
       initialize_system();
-      parallel::distributed::SolutionTransfer<dim,
-                                              PETScWrappers::MPI::BlockVector>
-        sol_trans(dof_handler);
       PETScWrappers::MPI::BlockVector tmp;
       tmp.reinit(owned_partitioning, mpi_communicator);
-      sol_trans.deserialize(tmp);
+      if (per_process_data)
+        {
+          std::vector<std::vector<PetscScalar>> values;
+          read_checkpoint_data(checkpoint_file.filename().string(), values);
+          for (unsigned int b = 0; b < values.size(); ++b)
+            {
+              tmp.block(b).set(owned_partitioning[b].get_index_vector(),
+                               values[b]);
+            }
+          tmp.compress(VectorOperation::insert);
+        }
+      else
+        {
+          parallel::distributed::
+            SolutionTransfer<dim, PETScWrappers::MPI::BlockVector>
+              sol_trans(dof_handler);
+          sol_trans.deserialize(tmp);
+        }
       present_solution = tmp;
-      // Update the time and names to set the current time and write
-      // correct .pvd file.
+      // Restore the current time and the names in the .pvd file.
+      fs::path record_file(checkpoint_file);
+      record_file.replace_extension(".fluid_record");
+      time.load_restart_record(record_file.string(), times_and_names);
+      AssertThrow(static_cast<int>(time.get_timestep()) ==
+                    Utilities::string_to_int(checkpoint_file.stem()),
+                  ExcMessage("Inconsistent fluid restart record!"));
+      if (Utilities::MPI::this_mpi_process(mpi_communicator) != 0)
+        {
+          // Only the first process writes the .pvd file.
+          times_and_names.clear();
+        }
+      // Update the time for hard coded boundary conditions
+      if (parameters.use_hard_coded_values)
+        {
+          boundary_values->advance_time(time.current());
+        }
+
+      pcout << "Checkpoint file successfully loaded from time step "
+            << time.get_timestep() << "!" << std::endl;
+      return true;
+    }
 
-      for (int i = 0; i <= Utilities::string_to_int(checkpoint_file.stem());
-           ++i)
+    template <int dim>
+    double FluidSolver<dim>::cfl_number() const
+    {
+      const QTrapez<dim> vertices;
+      FEValues<dim> fe_values(fe, vertices, update_values);
+      const FEValuesExtractors::Vector velocities(0);
+      std::vector<Tensor<1, dim>> velocity(vertices.size());
+      double cfl = 0;
+      for (auto cell = dof_handler.begin_active(); cell != dof_handler.end();
+           ++cell)
         {
-          if ((time.current() == 0 || time.time_to_output()) &&
-              Utilities::MPI::this_mpi_process(mpi_communicator) == 0)
+          if (!cell->is_locally_owned())
             {
-              std::string basename =
-                "fluid" + Utilities::int_to_string(time.get_timestep(), 6) +
-                "-";
-              for (unsigned int j = 0;
-                   j < Utilities::MPI::n_mpi_processes(mpi_communicator);
-                   ++j)
-                {
-                  times_and_names.push_back(
-                    {time.current(),
-                     basename + Utilities::int_to_string(j, 4) + ".vtu"});
-                }
+              continue;
             }
-          if (i == Utilities::string_to_int(checkpoint_file.stem()))
-            break;
-          time.increment();
-          // Update the time for hard coded boundary conditions
-          if (parameters.use_hard_coded_values)
+          fe_values.reinit(cell);
+          fe_values[velocities].get_function_values(present_solution,
+                                                    velocity);
+          double v_max = 0;
+          for (const auto &v : velocity)
             {
-              boundary_values->advance_time(time.get_delta_t());
+              v_max = std::max(v_max, v.norm());
             }
+          cfl = std::max(cfl,
+                         v_max * time.get_delta_t() /
+                           cell->minimum_vertex_distance());
         }
+      return Utilities::MPI::max(cfl, mpi_communicator);
+    }
 
-      pcout << "Checkpoint file successfully loaded from time step "
-            << time.get_timestep() << "!" << std::endl;
-      return true;
+    template <int dim>
+    void FluidSolver<dim>::adapt_time_step()
+    {
+      const Utils::TimeStepController controller(
+        parameters.min_time_step,
+        parameters.max_time_step,
+        parameters.target_cfl,
+        parameters.target_newton_iterations);
+      time.set_delta_t(
+        controller.propose(time, cfl_number(), newton_iterations));
+    }
+
+    template <int dim>
+    void FluidSolver<dim>::run_pseudo_transient(
+      const bool apply_nonzero_constraints)
+    {
+      // The first step imposes the boundary values, so the residual at its
+      // start is not a residual of the steady equations.
+      bool first_step = apply_nonzero_constraints;
+      bool has_reference = false;
+      double reference_residual = 0;
+      double last_residual = 0;
+      for (unsigned int step = 0;; ++step)
+        {
+          AssertThrow(step < parameters.max_pseudo_time_steps,
+                      ExcMessage("The steady state is not reached!"));
+          run_one_step(first_step);
+          if (first_step)
+            {
+              first_step = false;
+              continue;
+            }
+          if (!has_reference)
+            {
+              reference_residual = steady_residual;
+              has_reference = true;
+            }
+          else if (steady_residual > 0)
+            {
+              // Switched evolution relaxation.
+              const double delta_t =
+                time.get_delta_t() * last_residual / steady_residual;
+              time.set_delta_t(
+                std::min(parameters.max_pseudo_time_step,
+                         std::max(parameters.time_step, delta_t)));
+            }
+          last_residual = steady_residual;
+          pcout << " STEADY_RES = " << steady_residual
+                << " PSEUDO_DT = " << time.get_delta_t() << std::endl;
+          if (steady_residual <=
+              parameters.steady_tolerance * reference_residual)
+            {
+              break;
+            }
+        }
+      update_stress();
+      output_results(time.get_timestep());
+      if (parameters.simulation_type == "Fluid")
+        {
+          save_checkpoint(time.get_timestep());
+        }
     }
 
     template <int dim>
     void FluidSolver<dim>::update_stress()
     {
+      setup_stress();
+      // The stress is symmetric, only the upper triangle is computed.
+      std::vector<PETScWrappers::MPI::Vector *> components;
       for (unsigned int i = 0; i < dim; ++i)
         {
-          for (unsigned int j = 0; j < dim; ++j)
+          for (unsigned int j = i; j < dim; ++j)
             {
-              stress[i][j] = 0;
+              components.push_back(&stress[i][j]);
             }
         }
-      PETScWrappers::MPI::Vector surrounding_cells(locally_owned_scalar_dofs,
-                                                   mpi_communicator);
-      surrounding_cells = 0.0;
-      // The stress tensors are stored as 2D vectors of shape dim*dim
-      // at cell and quadrature point level.
-      std::vector<std::vector<Vector<double>>> cell_stress(
-        dim,
-        std::vector<Vector<double>>(dim,
-                                    Vector<double>(scalar_fe.dofs_per_cell)));
-      std::vector<std::vector<Vector<double>>> quad_stress(
-        dim,
-        std::vector<Vector<double>>(
-          dim, Vector<double>(volume_quad_formula.size())));
-
-      // The projection matrix from quadrature points to the dofs.
-      FullMatrix<double> qpt_to_dof(scalar_fe.dofs_per_cell,
-                                    volume_quad_formula.size());
-      FETools::compute_projection_from_quadrature_points_matrix(
-        scalar_fe, volume_quad_formula, volume_quad_formula, qpt_to_dof);
+      Utils::NodalProjection<dim> projection(
+        scalar_fe, volume_quad_formula, components);
 
       FEValues<dim> fe_values(fe,
                               volume_quad_formula,
@@ -623,8 +1389,6 @@ namespace Fluid
 
       auto cell = dof_handler.begin_active();
       auto scalar_cell = scalar_dof_handler.begin_active();
-      Vector<double> local_sorrounding_cells(scalar_fe.dofs_per_cell);
-      local_sorrounding_cells = 1.0;
       for (; cell != dof_handler.end(); ++cell, ++scalar_cell)
         {
           if (!cell->is_locally_owned())
@@ -637,49 +1401,29 @@ namespace Fluid
           // Fluid pressure
           fe_values[pressure].get_function_values(present_solution, p);
 
-          // Loop over all quadrature points to set FSI forces.
-          for (unsigned int q = 0; q < volume_quad_formula.size(); ++q)
+          for (unsigned int q = 0; q < n_q_points; ++q)
             {
               SymmetricTensor<2, dim> sigma =
                 -p[q] * Physics::Elasticity::StandardTensors<dim>::I +
                 2 * parameters.viscosity * sym_grad_v[q];
+              unsigned int c = 0;
               for (unsigned int i = 0; i < dim; ++i)
                 {
-                  for (unsigned int j = 0; j < dim; ++j)
+                  for (unsigned int j = i; j < dim; ++j)
                     {
-                      quad_stress[i][j][q] = sigma[i][j];
+                      projection.quad_values(q, c++) = sigma[i][j];
                     }
                 }
             }
-
-          for (unsigned int i = 0; i < dim; ++i)
-            {
-              for (unsigned int j = 0; j < dim; ++j)
-                {
-                  qpt_to_dof.vmult(cell_stress[i][j], quad_stress[i][j]);
-                  scalar_cell->distribute_local_to_global(cell_stress[i][j],
-                                                          stress[i][j]);
-                }
-            }
-          scalar_cell->distribute_local_to_global(local_sorrounding_cells,
-                                                  surrounding_cells);
+          projection.add_cell(scalar_cell);
         }
-      surrounding_cells.compress(VectorOperation::add);
+      projection.finish();
 
       for (unsigned int i = 0; i < dim; ++i)
         {
-          for (unsigned int j = 0; j < dim; ++j)
+          for (unsigned int j = 0; j < i; ++j)
             {
-              stress[i][j].compress(VectorOperation::add);
-              const unsigned int local_begin =
-                surrounding_cells.local_range().first;
-              const unsigned int local_end =
-                surrounding_cells.local_range().second;
-              for (unsigned int k = local_begin; k < local_end; ++k)
-                {
-                  stress[i][j][k] /= surrounding_cells[k];
-                }
-              stress[i][j].compress(VectorOperation::insert);
+              stress[i][j] = stress[j][i];
             }
         }
     }
@@ -7,6 +7,14 @@ namespace MPI
   FSI<dim>::~FSI()
   {
     timer.print_summary();
+    if (parameters.timer_statistics)
+      {
+        timer.print_wall_time_statistics(mpi_communicator);
+      }
+    if (solid_group)
+      {
+        MPI_Comm_free(&solid_state_communicator);
+      }
   }
 
   template <int dim>
@@ -17,7 +25,7 @@ namespace MPI
     : fluid_solver(f),
       solid_solver(s),
       parameters(p),
-      mpi_communicator(MPI_COMM_WORLD),
+      mpi_communicator(f.mpi_communicator),
       pcout(std::cout, Utilities::MPI::this_mpi_process(mpi_communicator) == 0),
       time(parameters.end_time,
            parameters.time_step,
@@ -26,103 +34,399 @@ namespace MPI
            parameters.save_interval),
       timer(
         mpi_communicator, pcout, TimerOutput::never, TimerOutput::wall_times),
+      counters(mpi_communicator),
+      shared_solid_displacement(mpi_communicator),
+      shared_reference_vertices(mpi_communicator),
+      shared_deformed_vertices(mpi_communicator),
+      solid_tree(s.dof_handler),
+      solid_locator(s.dof_handler),
+      fluid_mapping(p.fluid_velocity_degree),
+      fluid_center_values(fluid_mapping,
+                          f.fe,
+                          QMidpoint<dim>(),
+                          update_quadrature_points | update_values |
+                            update_gradients),
       use_dirichlet_bc(use_dirichlet_bc)
   {
+    const unsigned int n_solid = parameters.solid_processes;
+    solid_group = n_solid > 0 &&
+                  n_solid < Utilities::MPI::n_mpi_processes(mpi_communicator);
+    owns_solid = !solid_group ||
+                 Utilities::MPI::this_mpi_process(mpi_communicator) < n_solid;
+    if (solid_group)
+      {
+        AssertThrow(Utilities::MPI::n_mpi_processes(s.mpi_communicator) ==
+                      (owns_solid ? n_solid : 1),
+                    ExcMessage("The solid solver must use the communicator "
+                               "of a solid group of the same size!"));
+        AssertThrow(!parameters.node_shared_solid_state &&
+                      parameters.solid_partitioner != "Fluid aligned",
+                    ExcMessage("A solid group needs the solid state and "
+                               "partition of its own!"));
+        // The fluid boundary values of the sub-steps would use the new solid
+        // on the group and the old one on the others.
+        AssertThrow(!parameters.overlap_traction_exchange ||
+                      parameters.fluid_sub_steps == 1,
+                    ExcMessage("A solid group cannot overlap fluid "
+                               "sub-steps!"));
+        const int ierr =
+          MPI_Comm_dup(mpi_communicator, &solid_state_communicator);
+        AssertThrowMPI(ierr);
+        // Only the group reports on the solid.
+        if (!owns_solid)
+          {
+            solid_solver.pcout.set_condition(false);
+          }
+      }
+    else
+      {
+        int comparison;
+        MPI_Comm_compare(f.mpi_communicator, s.mpi_communicator, &comparison);
+        AssertThrow(comparison == MPI_IDENT || comparison == MPI_CONGRUENT,
+                    ExcMessage("The fluid and solid solvers must use the same "
+                               "communicator!"));
+      }
+    fluid_solver.enable_cell_property();
+    solid_locator.set_tree(&solid_tree);
+    if (!parameters.performance_log.empty())
+      {
+        counters.open(parameters.performance_log);
+      }
+    previous_tpp_time = 0;
+    solid_mesh_deformed = false;
     solid_box.reinit(2 * dim);
+    local_fluid_box.reinit(2 * dim);
+    relevant_fluid_box.reinit(2 * dim);
+    boundary_bin_size = 0;
+    boundary_bin_offsets.assign(2, 0);
+    indicator_band_valid = false;
   }
 
   template <int dim>
   void FSI<dim>::move_solid_mesh(bool move_forward)
   {
-    TimerOutput::Scope timer_section(timer, "Move solid mesh");
+    // The mesh is kept in the deformed configuration during the coupling
+    // phase of a time step, so moving it twice is a no-op.
+    if (move_forward == solid_mesh_deformed)
+      {
+        return;
+      }
+    Utils::ProfilingScope timer_section(timer, "Move solid mesh");
+    Utils::PerformanceCounters::Scope counter_section(counters,
+                                                      "move_solid_mesh");
+    solid_mesh_deformed = move_forward;
+    solid_vertices.update(solid_solver.dof_handler);
+    if (parameters.node_shared_solid_state)
+      {
+        move_solid_mesh_node_shared(move_forward);
+        return;
+      }
+    if (!move_forward)
+      {
+        solid_vertices.restore(reference_vertices);
+        return;
+      }
+    solid_vertices.save(reference_vertices);
     // All gather the information so each process has the entire solution.
     Vector<double> localized_displacement(solid_solver.current_displacement);
+    counters["move_solid_mesh"].bytes +=
+      sizeof(double) * solid_solver.locally_owned_dofs.n_elements();
     // Exactly the same as the serial version, since we must update the
     // entire graph on every process.
-    std::vector<bool> vertex_touched(solid_solver.triangulation.n_vertices(),
-                                     false);
-    for (auto cell = solid_solver.dof_handler.begin_active();
-         cell != solid_solver.dof_handler.end();
+    solid_vertices.displace(localized_displacement);
+  }
+
+  template <int dim>
+  void FSI<dim>::move_solid_mesh_node_shared(const bool move_forward)
+  {
+    const unsigned int n_vertices = solid_vertices.size();
+    Point<dim> *const *vertices = solid_vertices.vertices.data();
+    // The triangulation holds the coordinates of every process, which are
+    // copied from the node shared ones.
+    auto copy_vertices = [&](const double *coordinates) {
+      for (unsigned int k = 0; k < n_vertices; ++k)
+        {
+          for (unsigned int d = 0; d < dim; ++d)
+            {
+              (*vertices[k])[d] = coordinates[k * dim + d];
+            }
+        }
+    };
+    if (!move_forward)
+      {
+        copy_vertices(shared_reference_vertices.data());
+        return;
+      }
+    // The solid mesh is the same on all processes, so every process can
+    // store its share of the reference coordinates.
+    shared_reference_vertices.resize(dim * n_vertices);
+    shared_deformed_vertices.resize(dim * n_vertices);
+    shared_reference_vertices.synchronize();
+    double *reference = shared_reference_vertices.data();
+    auto share = shared_reference_vertices.share();
+    for (std::size_t i = share.first; i < share.second; ++i)
+      {
+        reference[i] = (*vertices[i / dim])[i % dim];
+      }
+    shared_solid_displacement.localize(solid_solver.current_displacement);
+    counters["move_solid_mesh"].bytes +=
+      sizeof(double) * solid_solver.locally_owned_dofs.n_elements();
+    const double *displacement = shared_solid_displacement.data();
+    const types::global_dof_index *dofs = solid_vertices.dofs.data();
+    double *deformed = shared_deformed_vertices.data();
+    share = shared_deformed_vertices.share();
+    // Nobody may still read the deformed coordinates of the last step.
+    shared_deformed_vertices.synchronize();
+    for (std::size_t i = share.first; i < share.second; ++i)
+      {
+        deformed[i] = reference[i] + displacement[dofs[i]];
+      }
+    shared_deformed_vertices.synchronize();
+    copy_vertices(deformed);
+  }
+
+  template <int dim>
+  void FSI<dim>::collect_solid_boundaries()
+  {
+    for (auto cell = solid_solver.triangulation.begin_active();
+         cell != solid_solver.triangulation.end();
          ++cell)
       {
+        for (unsigned int f = 0; f < GeometryInfo<dim>::faces_per_cell; ++f)
+          {
+            if (cell->face(f)->at_boundary())
+              {
+                solid_boundaries.push_back(cell->face(f));
+              }
+          }
+      }
+  }
+
+  template <int dim>
+  void FSI<dim>::update_solid_box()
+  {
+    move_solid_mesh(true);
+    solid_part_boxes.assign(parameters.n_solid_parts, Vector<double>());
+    for (auto s_cell : solid_solver.dof_handler.active_cell_iterators())
+      {
+        Vector<double> &box = solid_part_boxes[solid_part_of(s_cell)];
         for (unsigned int v = 0; v < GeometryInfo<dim>::vertices_per_cell; ++v)
           {
-            if (!vertex_touched[cell->vertex_index(v)])
+            const Point<dim> &vertex = s_cell->vertex(v);
+            if (box.size() == 0)
               {
-                vertex_touched[cell->vertex_index(v)] = true;
-                Point<dim> vertex_displacement;
-                for (unsigned int d = 0; d < dim; ++d)
-                  {
-                    vertex_displacement[d] =
-                      localized_displacement(cell->vertex_dof_index(v, d));
-                  }
-                if (move_forward)
-                  {
-                    cell->vertex(v) += vertex_displacement;
-                  }
-                else
+                box.reinit(2 * dim);
+                for (unsigned int i = 0; i < dim; ++i)
                   {
-                    cell->vertex(v) -= vertex_displacement;
+                    box(2 * i) = vertex(i);
+                    box(2 * i + 1) = vertex(i);
                   }
               }
+            for (unsigned int i = 0; i < dim; ++i)
+              {
+                box(2 * i) = std::min(box(2 * i), vertex(i));
+                box(2 * i + 1) = std::max(box(2 * i + 1), vertex(i));
+              }
+          }
+      }
+    // The solid box is the union of the part boxes.
+    bool first_part = true;
+    for (const auto &box : solid_part_boxes)
+      {
+        if (box.size() == 0)
+          continue;
+        for (unsigned int i = 0; i < dim; ++i)
+          {
+            if (first_part || box(2 * i) < solid_box(2 * i))
+              solid_box(2 * i) = box(2 * i);
+            if (first_part || box(2 * i + 1) > solid_box(2 * i + 1))
+              solid_box(2 * i + 1) = box(2 * i + 1);
           }
+        first_part = false;
+      }
+    select_relevant_solid_parts();
+    // Refit the cell boxes to the deformed solid
+    solid_tree.refit();
+    update_solid_ghosts();
+    if (dim == 2)
+      {
+        update_boundary_segments();
+      }
+    else
+      {
+        update_boundary_surface();
       }
   }
 
   template <int dim>
-  void FSI<dim>::collect_solid_boundaries()
+  unsigned int FSI<dim>::solid_part_of(
+    const typename DoFHandler<dim>::active_cell_iterator &s_cell) const
   {
-    if (dim == 2)
-      for (auto cell = solid_solver.triangulation.begin_active();
-           cell != solid_solver.triangulation.end();
-           ++cell)
+    // The material ids of the parts start from 1, like in the solid solvers.
+    return parameters.n_solid_parts == 1 ? 0 : s_cell->material_id() - 1;
+  }
+
+  template <int dim>
+  void FSI<dim>::select_relevant_solid_parts()
+  {
+    relevant_solid_parts.assign(solid_part_boxes.size(), false);
+    for (unsigned int p = 0; p < solid_part_boxes.size(); ++p)
+      {
+        const Vector<double> &box = solid_part_boxes[p];
+        if (box.size() == 0)
+          continue;
+        bool overlap = true;
+        for (unsigned int i = 0; i < dim; ++i)
+          {
+            if (box(2 * i + 1) < relevant_fluid_box(2 * i) ||
+                box(2 * i) > relevant_fluid_box(2 * i + 1))
+              overlap = false;
+          }
+        relevant_solid_parts[p] = overlap;
+      }
+  }
+
+  template <int dim>
+  bool FSI<dim>::near_solid_part(const Point<dim> &point,
+                                 const double margin) const
+  {
+    if (solid_part_boxes.empty())
+      {
+        return true;
+      }
+    for (unsigned int p = 0; p < solid_part_boxes.size(); ++p)
+      {
+        if (!relevant_solid_parts[p])
+          continue;
+        const Vector<double> &box = solid_part_boxes[p];
+        bool inside = true;
+        for (unsigned int i = 0; i < dim; ++i)
+          {
+            if (point(i) < box(2 * i) - margin ||
+                point(i) > box(2 * i + 1) + margin)
+              inside = false;
+          }
+        if (inside)
+          return true;
+      }
+    return false;
+  }
+
+  namespace
+  {
+    /// The coordinates of a point in 3D, for the surface tree. Only called
+    /// in 3D, but compiled for every dim.
+    template <int dim>
+    Point<3> point_3d(const Point<dim> &point)
+    {
+      Point<3> result;
+      for (unsigned int d = 0; d < dim && d < 3; ++d)
         {
-          for (unsigned int f = 0; f < GeometryInfo<dim>::faces_per_cell; ++f)
-            {
-              if (cell->face(f)->at_boundary())
-                {
-                  solid_boundaries.push_back(cell->face(f));
-                }
-            }
+          result[d] = point[d];
         }
+      return result;
+    }
+  } // namespace
+
+  template <int dim>
+  void FSI<dim>::update_boundary_surface()
+  {
+    std::vector<Point<3>> triangles;
+    triangles.reserve(6 * solid_boundaries.size());
+    for (auto &face : solid_boundaries)
+      {
+        // Split along the diagonal from vertex 0 to 3, the vertices of a
+        // face are numbered lexicographically.
+        for (const unsigned int v : {0u, 1u, 3u, 0u, 3u, 2u})
+          {
+            triangles.push_back(point_3d(face->vertex(v)));
+          }
+      }
+    boundary_surface.reinit(triangles);
   }
 
   template <int dim>
-  void FSI<dim>::update_solid_box()
+  void FSI<dim>::update_boundary_segments()
   {
-    move_solid_mesh(true);
-    solid_box = 0;
-    for (unsigned int i = 0; i < dim; ++i)
+    const unsigned int n_edges = solid_boundaries.size();
+    boundary_segments.resize(2 * n_edges);
+    unsigned int e = 0;
+    for (auto f = solid_boundaries.begin(); f != solid_boundaries.end();
+         ++f, ++e)
       {
-        solid_box(2 * i) =
-          solid_solver.triangulation.get_vertices().begin()->operator()(i);
-        solid_box(2 * i + 1) =
-          solid_solver.triangulation.get_vertices().begin()->operator()(i);
+        boundary_segments[2 * e] = (*f)->vertex(0);
+        boundary_segments[2 * e + 1] = (*f)->vertex(1);
       }
-    for (auto v = solid_solver.triangulation.get_vertices().begin();
-         v != solid_solver.triangulation.get_vertices().end();
-         ++v)
+    // Bin the edges by their y-ranges, so that an edge is stored in every
+    // bin it overlaps with. The bins are stored in compressed row format.
+    const unsigned int n_bins = std::max(n_edges, 1u);
+    boundary_bin_size = (solid_box(3) - solid_box(2)) / n_bins;
+    auto bin_of = [&](double y) {
+      if (boundary_bin_size <= 0)
+        return 0u;
+      return std::min(
+        static_cast<unsigned int>((y - solid_box(2)) / boundary_bin_size),
+        n_bins - 1);
+    };
+    boundary_bin_offsets.assign(n_bins + 1, 0);
+    for (e = 0; e < n_edges; ++e)
       {
-        for (unsigned int i = 0; i < dim; ++i)
+        auto range = std::minmax(boundary_segments[2 * e](1),
+                                 boundary_segments[2 * e + 1](1));
+        for (unsigned int b = bin_of(range.first); b <= bin_of(range.second);
+             ++b)
           {
-            if ((*v)(i) < solid_box(2 * i))
-              solid_box(2 * i) = (*v)(i);
-            else if ((*v)(i) > solid_box(2 * i + 1))
-              solid_box(2 * i + 1) = (*v)(i);
+            ++boundary_bin_offsets[b + 1];
+          }
+      }
+    for (unsigned int b = 0; b < n_bins; ++b)
+      {
+        boundary_bin_offsets[b + 1] += boundary_bin_offsets[b];
+      }
+    boundary_bin_edges.resize(boundary_bin_offsets[n_bins]);
+    std::vector<unsigned int> position(boundary_bin_offsets.begin(),
+                                       boundary_bin_offsets.end() - 1);
+    for (e = 0; e < n_edges; ++e)
+      {
+        auto range = std::minmax(boundary_segments[2 * e](1),
+                                 boundary_segments[2 * e + 1](1));
+        for (unsigned int b = bin_of(range.first); b <= bin_of(range.second);
+             ++b)
+          {
+            boundary_bin_edges[position[b]++] = e;
           }
       }
-    move_solid_mesh(false);
   }
 
   template <int dim>
   void FSI<dim>::update_vertices_mask()
   {
     // Initilize vertices mask
-    vertices_mask.resize(fluid_solver.triangulation.n_vertices(), false);
+    vertices_mask.assign(fluid_solver.triangulation.n_vertices(), false);
+    bool first_vertex = true;
+    bool first_relevant_vertex = true;
     for (auto cell = fluid_solver.triangulation.begin_active();
          cell != fluid_solver.triangulation.end();
          ++cell)
       {
+        if (cell->is_artificial())
+          {
+            continue;
+          }
+        // Extend the box of the non-artificial fluid cells
+        for (unsigned int v = 0; v < GeometryInfo<dim>::vertices_per_cell; ++v)
+          {
+            for (unsigned int i = 0; i < dim; ++i)
+              {
+                if (first_relevant_vertex ||
+                    cell->vertex(v)(i) < relevant_fluid_box(2 * i))
+                  relevant_fluid_box(2 * i) = cell->vertex(v)(i);
+                if (first_relevant_vertex ||
+                    cell->vertex(v)(i) > relevant_fluid_box(2 * i + 1))
+                  relevant_fluid_box(2 * i + 1) = cell->vertex(v)(i);
+              }
+            first_relevant_vertex = false;
+          }
         if (!cell->is_locally_owned())
           {
             continue;
@@ -130,13 +434,139 @@ namespace MPI
         for (unsigned int v = 0; v < GeometryInfo<dim>::vertices_per_cell; ++v)
           {
             vertices_mask[cell->vertex_index(v)] = true;
+            // Extend the box of the locally owned fluid cells
+            for (unsigned int i = 0; i < dim; ++i)
+              {
+                if (first_vertex || cell->vertex(v)(i) < local_fluid_box(2 * i))
+                  local_fluid_box(2 * i) = cell->vertex(v)(i);
+                if (first_vertex ||
+                    cell->vertex(v)(i) > local_fluid_box(2 * i + 1))
+                  local_fluid_box(2 * i + 1) = cell->vertex(v)(i);
+              }
+            first_vertex = false;
+          }
+      }
+    select_relevant_solid_parts();
+  }
+
+  template <int dim>
+  void FSI<dim>::update_solid_ghosts()
+  {
+    Utils::ProfilingScope timer_section(timer, "Update solid ghosts");
+    Utils::PerformanceCounters::Scope counter_section(counters,
+                                                      "update_solid_ghosts");
+    solid_relevant_dofs = IndexSet(solid_solver.dof_handler.n_dofs());
+    if (!parameters.distributed_solid_state)
+      {
+        solid_relevant_dofs.add_range(0, solid_solver.dof_handler.n_dofs());
+      }
+    else
+      {
+        std::vector<types::global_dof_index> dof_indices(
+          solid_solver.fe.dofs_per_cell);
+        for (auto cell = solid_solver.dof_handler.begin_active();
+             cell != solid_solver.dof_handler.end();
+             ++cell)
+          {
+            // The cells of a part that does not overlap with the relevant
+            // fluid cells do not either.
+            if (!relevant_solid_parts.empty() &&
+                !relevant_solid_parts[solid_part_of(cell)])
+              {
+                continue;
+              }
+            // Check if the bounding box of the solid cell overlaps with the
+            // box of the relevant fluid cells.
+            Point<dim> lower = cell->vertex(0), upper = cell->vertex(0);
+            for (unsigned int v = 1; v < GeometryInfo<dim>::vertices_per_cell;
+                 ++v)
+              {
+                for (unsigned int i = 0; i < dim; ++i)
+                  {
+                    lower[i] = std::min(lower[i], cell->vertex(v)[i]);
+                    upper[i] = std::max(upper[i], cell->vertex(v)[i]);
+                  }
+              }
+            bool overlap = true;
+            for (unsigned int i = 0; i < dim; ++i)
+              {
+                if (upper[i] < relevant_fluid_box(2 * i) ||
+                    lower[i] > relevant_fluid_box(2 * i + 1))
+                  {
+                    overlap = false;
+                    break;
+                  }
+              }
+            if (!overlap)
+              {
+                continue;
+              }
+            cell->get_dof_indices(dof_indices);
+            solid_relevant_dofs.add_indices(dof_indices.begin(),
+                                            dof_indices.end());
+          }
+      }
+    solid_relevant_dofs.compress();
+    // The solid layout, which is serial outside of a solid group.
+    ghosted_solid_velocity.reinit(solid_solver.locally_owned_dofs,
+                                  solid_relevant_dofs,
+                                  solid_solver.mpi_communicator);
+    ghosted_solid_acceleration.reinit(solid_solver.locally_owned_dofs,
+                                      solid_relevant_dofs,
+                                      solid_solver.mpi_communicator);
+    ghosted_solid_velocity = solid_solver.current_velocity;
+    ghosted_solid_acceleration = solid_solver.current_acceleration;
+    // Only the ghost entries are received from the other processes
+    counters["update_solid_ghosts"].bytes +=
+      2 * sizeof(double) *
+      (solid_relevant_dofs.n_elements() -
+       (solid_relevant_dofs & solid_solver.locally_owned_dofs).n_elements());
+  }
+
+  template <int dim>
+  typename DoFHandler<dim>::active_cell_iterator FSI<dim>::locate_fluid_point(
+    const Point<dim> &point,
+    const typename DoFHandler<dim>::active_cell_iterator &hint,
+    Utils::PerformanceCounters::Record &record) const
+  {
+    // Points outside of the locally owned fluid cells can never be evaluated
+    // by the current process.
+    for (unsigned int i = 0; i < dim; ++i)
+      {
+        if (point(i) < local_fluid_box(2 * i) ||
+            point(i) > local_fluid_box(2 * i + 1))
+          return fluid_solver.dof_handler.end();
+      }
+    // The solid moves less than one fluid cell per time step, so the point is
+    // most likely in the cell found last time or one of its neighbors.
+    if (hint != fluid_solver.dof_handler.end())
+      {
+        if (hint->point_inside(point))
+          {
+            record.hits += 1;
+            return hint;
+          }
+        std::vector<typename DoFHandler<dim>::active_cell_iterator> neighbors;
+        GridTools::get_active_neighbors<DoFHandler<dim>>(hint, neighbors);
+        for (auto &cell : neighbors)
+          {
+            if (!cell->is_artificial() && cell->point_inside(point))
+              {
+                record.hits += 1;
+                return cell;
+              }
           }
       }
+    record.misses += 1;
+    // Fall back to the global search restricted to the local vertices.
+    Utils::GridInterpolator<dim, PETScWrappers::MPI::BlockVector> interpolator(
+      fluid_solver.dof_handler, point, vertices_mask);
+    return interpolator.get_cell();
   }
 
   template <int dim>
   bool FSI<dim>::point_in_solid(const DoFHandler<dim> &df,
-                                const Point<dim> &point)
+                                const Point<dim> &point) const
   {
     // Check whether the point is in the solid box first.
     for (unsigned int i = 0; i < dim; ++i)
@@ -144,16 +574,35 @@ namespace MPI
         if (point(i) < solid_box(2 * i) || point(i) > solid_box(2 * i + 1))
           return false;
       }
+    // The solid box of separate parts, e.g. the leaflets of a valve, is
+    // mostly empty.
+    if (!near_solid_part(point))
+      {
+        return false;
+      }
 
     // Compute its angle to each boundary face
     if (dim == 2)
       {
         unsigned int cross_number = 0;
         unsigned int half_cross_number = 0;
-        for (auto f = solid_boundaries.begin(); f != solid_boundaries.end();
-             ++f)
+        // Only the edges whose y-range overlaps with the bin of the point
+        // can be crossed by the horizontal ray.
+        unsigned int bin = 0;
+        if (boundary_bin_size > 0)
           {
-            Point<dim> p1 = (*f)->vertex(0), p2 = (*f)->vertex(1);
+            const unsigned int n_bins = boundary_bin_offsets.size() - 1;
+            bin = std::min(static_cast<unsigned int>(
+                             (point(1) - solid_box(2)) / boundary_bin_size),
+                           n_bins - 1);
+          }
+        for (unsigned int k = boundary_bin_offsets[bin];
+             k < boundary_bin_offsets[bin + 1];
+             ++k)
+          {
+            const unsigned int e = boundary_bin_edges[k];
+            const Point<dim> &p1 = boundary_segments[2 * e];
+            const Point<dim> &p2 = boundary_segments[2 * e + 1];
             double y_diff1 = p1(1) - point(1);
             double y_diff2 = p2(1) - point(1);
             double x_diff1 = p1(0) - point(0);
@@ -208,6 +657,17 @@ namespace MPI
           return false;
         return true;
       }
+    // The deformed solid boundary is crossed by a single ray.
+    if (dim == 3 && &df == &solid_solver.dof_handler &&
+        !boundary_surface.empty())
+      {
+        return boundary_surface.inside(point_3d(point));
+      }
+    // Only the cells whose bounding boxes contain the point are checked.
+    if (&df == &solid_solver.dof_handler && !solid_tree.empty())
+      {
+        return solid_tree.find_cell(point).state() == IteratorState::valid;
+      }
     for (auto cell = df.begin_active(); cell != df.end(); ++cell)
       {
         if (cell->point_inside(point))
@@ -218,17 +678,67 @@ namespace MPI
     return false;
   }
 
+  template <int dim>
+  void FSI<dim>::points_in_solid(const std::vector<Point<dim>> &points,
+                                 std::vector<int> &result) const
+  {
+    if (dim == 3 && !boundary_surface.empty())
+      {
+        // Only the points in the box of a relevant part cast rays.
+        std::vector<Point<3>> candidates;
+        std::vector<unsigned int> indices;
+        for (unsigned int i = 0; i < points.size(); ++i)
+          {
+            if (near_solid_part(points[i]))
+              {
+                candidates.push_back(point_3d(points[i]));
+                indices.push_back(i);
+              }
+          }
+        std::vector<int> inside;
+        boundary_surface.inside(candidates, inside);
+        result.assign(points.size(), 0);
+        for (unsigned int k = 0; k < indices.size(); ++k)
+          {
+            result[indices[k]] = inside[k];
+          }
+        return;
+      }
+    result.resize(points.size());
+    for (unsigned int i = 0; i < points.size(); ++i)
+      {
+        result[i] = point_in_solid(solid_solver.dof_handler, points[i]);
+      }
+  }
+
   template <int dim>
   void FSI<dim>::setup_cell_hints()
   {
-    unsigned int n_unit_points =
-      fluid_solver.fe.get_unit_support_points().size();
-    for (auto cell = fluid_solver.triangulation.begin_active();
-         cell != fluid_solver.triangulation.end();
+    const std::vector<Point<dim>> &unit_points =
+      fluid_solver.fe.get_unit_support_points();
+    unsigned int n_unit_points = unit_points.size();
+    const MappingQGeneric<dim> &mapping = fluid_mapping;
+    std::vector<types::global_dof_index> dof_indices(
+      fluid_solver.fe.dofs_per_cell);
+    const std::vector<unsigned int> velocity_dofs =
+      Utils::fsi_velocity_dofs(fluid_solver.fe);
+    // Only the locally relevant dofs can be touched.
+    std::vector<bool> dof_touched(
+      use_dirichlet_bc ? fluid_solver.locally_relevant_dofs.n_elements() : 0,
+      false);
+    relevant_fluid_cells.clear();
+    support_points.clear();
+    for (auto cell = fluid_solver.dof_handler.begin_active();
+         cell != fluid_solver.dof_handler.end();
          ++cell)
       {
+        // Use is_artificial() instead of !is_locally_owned() because ghost
+        // elements must be taken care of to set correct Dirichlet BCs!
         if (!cell->is_artificial())
           {
+            relevant_fluid_cells.push_back(cell);
+            // Cells that persist through a mesh change keep their data, so
+            // only the hints of new cells have to be set.
             cell_hints.initialize(cell, n_unit_points);
             const std::vector<
               std::shared_ptr<typename DoFHandler<dim>::active_cell_iterator>>
@@ -238,43 +748,216 @@ namespace MPI
             for (unsigned int v = 0; v < n_unit_points; ++v)
               {
                 // Initialize the hints with the begin iterators!
-                *(hints[v]) = solid_solver.dof_handler.begin_active();
+                if (hints[v]->state() != IteratorState::valid)
+                  *(hints[v]) = solid_solver.dof_handler.begin_active();
+              }
+            if (!use_dirichlet_bc)
+              continue;
+            cell->get_dof_indices(dof_indices);
+            for (const unsigned int i : velocity_dofs)
+              {
+                // Skip the dofs of the previous cells.
+                const unsigned int index =
+                  fluid_solver.locally_relevant_dofs.index_within_set(
+                    dof_indices[i]);
+                if (dof_touched[index])
+                  continue;
+                dof_touched[index] = true;
+                const unsigned int component =
+                  fluid_solver.fe.system_to_component_index(i).first;
+                support_points.push_back(
+                  {cell,
+                   dof_indices[i],
+                   component,
+                   mapping.transform_unit_to_real_cell(cell, unit_points[i]),
+                   hints[i],
+                   false});
               }
           }
       }
+    print_memory_report();
+  }
+
+  template <int dim>
+  void FSI<dim>::print_memory_report() const
+  {
+    if (!parameters.memory_report)
+      return;
+    using fluid_cell = typename DoFHandler<dim>::active_cell_iterator;
+    Utils::MemoryReport report(mpi_communicator);
+    report.add("FSI cell hints",
+               Utils::cell_data_memory<fluid_cell>(
+                 relevant_fluid_cells.size(),
+                 fluid_solver.fe.get_unit_support_points().size()) +
+                 relevant_fluid_cells.capacity() * sizeof(fluid_cell));
+    report.add("FSI support points",
+               support_points.capacity() * sizeof(SupportPoint));
+    report.add("FSI solid vectors",
+               ghosted_solid_velocity.memory_consumption() +
+                 ghosted_solid_acceleration.memory_consumption() +
+                 solid_velocity_start.memory_consumption() +
+                 solid_acceleration_start.memory_consumption() +
+                 shared_solid_displacement.memory_consumption());
+    report.add("FSI solid vertices",
+               solid_vertices.memory_consumption() +
+                 reference_vertices.capacity() * sizeof(Point<dim>) +
+                 shared_reference_vertices.memory_consumption() +
+                 shared_deformed_vertices.memory_consumption());
+    report.print(pcout.get_stream(),
+                 "FSI memory at time step " +
+                   Utilities::int_to_string(time.get_timestep()));
   }
 
   template <int dim>
   void FSI<dim>::update_solid_displacement()
   {
+    Utils::PerformanceCounters::Scope counter_section(
+      counters, "update_solid_displacement");
     move_solid_mesh(true);
-    Vector<double> localized_solid_displacement(
-      solid_solver.current_displacement);
-    std::vector<bool> vertex_touched(solid_solver.dof_handler.n_dofs(), false);
-    for (auto cell : solid_solver.dof_handler.active_cell_iterators())
+    // Collect the vertices to be updated together with their dof indices.
+    std::vector<Point<dim>> points;
+    std::vector<types::global_dof_index> vertex_dofs;
+    for (unsigned int k = 0; k < solid_vertices.size(); ++k)
       {
-        for (unsigned int v = 0; v < GeometryInfo<dim>::vertices_per_cell; ++v)
+        if (!solid_solver.constraints.is_constrained(
+              solid_vertices.vertex_indices[k]))
           {
-            if (!vertex_touched[cell->vertex_index(v)] &&
-                !solid_solver.constraints.is_constrained(cell->vertex_index(v)))
+            points.push_back(*solid_vertices.vertices[k]);
+            for (unsigned int d = 0; d < dim; ++d)
               {
-                vertex_touched[cell->vertex_index(v)] = true;
-                Point<dim> point = cell->vertex(v);
-                Vector<double> tmp(dim + 1);
-                VectorTools::point_value(fluid_solver.dof_handler,
-                                         fluid_solver.present_solution,
-                                         point,
-                                         tmp);
-                for (unsigned int d = 0; d < dim; ++d)
-                  {
-                    localized_solid_displacement[cell->vertex_dof_index(
-                      v, d)] += tmp[d] * time.get_delta_t();
-                  }
+                vertex_dofs.push_back(solid_vertices.dofs[k * dim + d]);
+              }
+          }
+      }
+    if (solid_vertex_hints.size() != points.size())
+      {
+        solid_vertex_hints.assign(points.size(),
+                                  fluid_solver.dof_handler.end());
+        solid_vertex_owners.assign(points.size(),
+                                   numbers::invalid_unsigned_int);
+      }
+    const unsigned int this_rank =
+      Utilities::MPI::this_mpi_process(mpi_communicator);
+    const unsigned int n_procs =
+      Utilities::MPI::n_mpi_processes(mpi_communicator);
+    Utils::PerformanceCounters::Record &record =
+      counters["update_solid_displacement"];
+    Utils::PerformanceCounters::Record &locate_record =
+      counters["locate_fluid_point"];
+    // Locate a point in the locally owned fluid cells, return false if it is
+    // not there.
+    auto locate = [&](const unsigned int n) {
+      solid_vertex_hints[n] = locate_fluid_point(
+        points[n], solid_vertex_hints[n], locate_record);
+      return solid_vertex_hints[n] != fluid_solver.dof_handler.end() &&
+             solid_vertex_hints[n]->is_locally_owned();
+    };
+    // Interpolate the fluid velocity at a located point.
+    Vector<double> value(dim + 1);
+    auto evaluate = [&](const unsigned int n, double *velocity) {
+      Utils::GridInterpolator<dim, PETScWrappers::MPI::BlockVector>
+        interpolator(fluid_solver.dof_handler,
+                     points[n],
+                     vertices_mask,
+                     solid_vertex_hints[n]);
+      interpolator.point_value(fluid_solver.present_solution, value);
+      for (unsigned int d = 0; d < dim; ++d)
+        {
+          velocity[d] = value[d];
+        }
+    };
+    // Every point is only evaluated by the process that owned it last time,
+    // and the velocities are summed up with a single collective. The last
+    // entry of a point is 1 if its owner still finds it.
+    Vector<double> local_values(points.size() * (dim + 1));
+    for (unsigned int n = 0; n < points.size(); ++n)
+      {
+        if (solid_vertex_owners[n] != this_rank || !locate(n))
+          {
+            continue;
+          }
+        evaluate(n, &local_values[n * (dim + 1)]);
+        local_values[n * (dim + 1) + dim] = 1;
+      }
+    Vector<double> global_values(local_values.size());
+    double mpi_start = MPI_Wtime();
+    Utilities::MPI::sum(local_values, mpi_communicator, global_values);
+    record.mpi_time += MPI_Wtime() - mpi_start;
+    record.bytes += sizeof(double) * local_values.size();
+    // The points that have moved out of the cells of their owners, or have
+    // never been owned, are the same on all processes. Their new owners are
+    // the lowest ranks that find them, and they are evaluated in a second
+    // exchange. This is rare, because the solid moves less than one fluid
+    // cell per time step. A point that is not in the fluid domain keeps no
+    // owner and a zero velocity.
+    std::vector<unsigned int> lost;
+    for (unsigned int n = 0; n < points.size(); ++n)
+      {
+        if (global_values[n * (dim + 1) + dim] == 0)
+          {
+            lost.push_back(n);
+          }
+      }
+    if (!lost.empty())
+      {
+        std::vector<unsigned int> candidates(lost.size(), n_procs),
+          owners(lost.size());
+        for (unsigned int k = 0; k < lost.size(); ++k)
+          {
+            if (locate(lost[k]))
+              {
+                candidates[k] = this_rank;
+              }
+          }
+        mpi_start = MPI_Wtime();
+        Utilities::MPI::min(candidates, mpi_communicator, owners);
+        Vector<double> local_velocity(lost.size() * dim);
+        for (unsigned int k = 0; k < lost.size(); ++k)
+          {
+            solid_vertex_owners[lost[k]] =
+              owners[k] < n_procs ? owners[k] : numbers::invalid_unsigned_int;
+            if (owners[k] == this_rank)
+              {
+                evaluate(lost[k], &local_velocity[k * dim]);
+              }
+          }
+        Vector<double> global_velocity(local_velocity.size());
+        Utilities::MPI::sum(local_velocity, mpi_communicator, global_velocity);
+        record.mpi_time += MPI_Wtime() - mpi_start;
+        record.bytes += sizeof(unsigned int) * candidates.size() +
+                        sizeof(double) * local_velocity.size();
+        record.misses += lost.size();
+        for (unsigned int k = 0; k < lost.size(); ++k)
+          {
+            for (unsigned int d = 0; d < dim; ++d)
+              {
+                global_values[lost[k] * (dim + 1) + d] =
+                  global_velocity[k * dim + d];
               }
           }
       }
+    record.hits += points.size() - lost.size();
+    // Restore the reference configuration since the displacement changes.
     move_solid_mesh(false);
-    solid_solver.current_displacement = localized_solid_displacement;
+    // Every process only updates the entries it owns, so the displacement
+    // does not have to be localized again.
+    std::vector<types::global_dof_index> owned_dofs;
+    std::vector<double> increments;
+    for (unsigned int n = 0; n < points.size(); ++n)
+      {
+        for (unsigned int d = 0; d < dim; ++d)
+          {
+            const auto dof = vertex_dofs[n * dim + d];
+            if (solid_solver.locally_owned_dofs.is_element(dof))
+              {
+                owned_dofs.push_back(dof);
+                increments.push_back(global_values[n * (dim + 1) + d] *
+                                     time.get_delta_t());
+              }
+          }
+      }
+    solid_solver.current_displacement.add(owned_dofs, increments);
+    solid_solver.current_displacement.compress(VectorOperation::add);
   }
 
   // Dirichlet bcs are applied to artificial fluid cells, so fluid nodes
@@ -286,29 +969,281 @@ namespace MPI
   template <int dim>
   void FSI<dim>::update_indicator()
   {
-    TimerOutput::Scope timer_section(timer, "Update indicator");
+    Utils::ProfilingScope timer_section(timer, "Update indicator");
+    Utils::PerformanceCounters::Scope counter_section(counters,
+                                                      "update_indicator");
     move_solid_mesh(true);
+    if (parameters.indicator_band_layers > 0 && indicator_band_valid &&
+        update_indicator_band(parameters.indicator_band_layers))
+      {
+        return;
+      }
+    std::vector<typename DoFHandler<dim>::active_cell_iterator> owned_cells;
     for (auto f_cell = fluid_solver.dof_handler.begin_active();
          f_cell != fluid_solver.dof_handler.end();
          ++f_cell)
       {
-        if (!f_cell->is_locally_owned())
+        if (f_cell->is_locally_owned())
           {
-            continue;
+            owned_cells.push_back(f_cell);
           }
-        auto p = fluid_solver.cell_property.get_data(f_cell);
-        auto center = f_cell->center();
-        p[0]->indicator = point_in_solid(solid_solver.dof_handler, center);
       }
-    move_solid_mesh(false);
-  }
-
-  // This function interpolates the solid velocity into the fluid solver,
-  // as the Dirichlet boundary conditions for artificial fluid vertices
+    // Every cell only writes its own indicator.
+    parallel::apply_to_subranges(
+      0u,
+      static_cast<unsigned int>(owned_cells.size()),
+      [&](const unsigned int begin, const unsigned int end) {
+        std::vector<Point<dim>> centers(end - begin);
+        for (unsigned int c = begin; c < end; ++c)
+          {
+            centers[c - begin] = owned_cells[c]->center();
+          }
+        std::vector<int> inside;
+        points_in_solid(centers, inside);
+        for (unsigned int c = begin; c < end; ++c)
+          {
+            fluid_solver.cell_property
+              .indicator[owned_cells[c]->active_cell_index()] =
+              inside[c - begin];
+          }
+      },
+      coupling_grainsize);
+    counters["update_indicator"].misses += 1;
+    if (parameters.indicator_band_layers > 0)
+      {
+        collect_indicator_interface();
+      }
+  }
+
+  template <int dim>
+  void FSI<dim>::collect_indicator_interface()
+  {
+    interface_cells.clear();
+    subdomain_boundary_cells.clear();
+    indicator_band_layer.assign(fluid_solver.triangulation.n_active_cells(),
+                                numbers::invalid_unsigned_int);
+    std::vector<typename DoFHandler<dim>::active_cell_iterator> neighbors;
+    for (auto f_cell : fluid_solver.dof_handler.active_cell_iterators())
+      {
+        if (!f_cell->is_locally_owned())
+          {
+            continue;
+          }
+        const std::vector<int> &indicators =
+          fluid_solver.cell_property.indicator;
+        const int indicator = indicators[f_cell->active_cell_index()];
+        bool on_interface = false, on_subdomain_boundary = false;
+        GridTools::get_active_neighbors<DoFHandler<dim>>(f_cell, neighbors);
+        for (auto &neighbor : neighbors)
+          {
+            if (!neighbor->is_locally_owned())
+              on_subdomain_boundary = true;
+            else if (indicators[neighbor->active_cell_index()] != indicator)
+              on_interface = true;
+          }
+        if (on_interface)
+          interface_cells.push_back(f_cell);
+        if (on_subdomain_boundary)
+          subdomain_boundary_cells.push_back(f_cell);
+      }
+    indicator_band_valid = true;
+  }
+
+  template <int dim>
+  bool FSI<dim>::update_indicator_band(const unsigned int n_layers)
+  {
+    // Seed the band with the cells that were on the interface, and the
+    // subdomain boundary cells close enough to a solid part to be reached.
+    std::vector<typename DoFHandler<dim>::active_cell_iterator> band =
+      interface_cells;
+    for (auto &f_cell : subdomain_boundary_cells)
+      {
+        if (near_solid_part(f_cell->center(),
+                            n_layers * f_cell->diameter()))
+          band.push_back(f_cell);
+      }
+    std::vector<typename DoFHandler<dim>::active_cell_iterator> seeds;
+    for (auto &f_cell : band)
+      {
+        if (indicator_band_layer[f_cell->active_cell_index()] ==
+            numbers::invalid_unsigned_int)
+          {
+            indicator_band_layer[f_cell->active_cell_index()] = 0;
+            seeds.push_back(f_cell);
+          }
+      }
+    band.swap(seeds);
+
+    // Grow the band by one layer of locally owned neighbors at a time.
+    std::vector<typename DoFHandler<dim>::active_cell_iterator> neighbors;
+    unsigned int layer_begin = 0;
+    for (unsigned int layer = 1; layer <= n_layers; ++layer)
+      {
+        const unsigned int layer_end = band.size();
+        for (unsigned int c = layer_begin; c < layer_end; ++c)
+          {
+            GridTools::get_active_neighbors<DoFHandler<dim>>(band[c],
+                                                             neighbors);
+            for (auto &neighbor : neighbors)
+              {
+                if (neighbor->is_locally_owned() &&
+                    indicator_band_layer[neighbor->active_cell_index()] ==
+                      numbers::invalid_unsigned_int)
+                  {
+                    indicator_band_layer[neighbor->active_cell_index()] =
+                      layer;
+                    band.push_back(neighbor);
+                  }
+              }
+          }
+        layer_begin = layer_end;
+      }
+
+    // Evaluate the band. If the outermost layer changes, the interface may
+    // have moved out of the band.
+    std::vector<int> band_indicator(band.size());
+    parallel::apply_to_subranges(
+      0u,
+      static_cast<unsigned int>(band.size()),
+      [&](const unsigned int begin, const unsigned int end) {
+        std::vector<Point<dim>> centers(end - begin);
+        for (unsigned int c = begin; c < end; ++c)
+          {
+            centers[c - begin] = band[c]->center();
+          }
+        std::vector<int> inside;
+        points_in_solid(centers, inside);
+        std::copy(inside.begin(), inside.end(), band_indicator.begin() + begin);
+      },
+      coupling_grainsize);
+    bool contained = true;
+    std::vector<int> &indicators = fluid_solver.cell_property.indicator;
+    for (unsigned int c = 0; c < band.size(); ++c)
+      {
+        int &indicator = indicators[band[c]->active_cell_index()];
+        if (band_indicator[c] != indicator &&
+            indicator_band_layer[band[c]->active_cell_index()] == n_layers)
+          {
+            contained = false;
+          }
+        indicator = band_indicator[c];
+      }
+    counters["update_indicator"].hits += 1;
+    counters["update_indicator"].iterations += band.size();
+
+    // The new interface can only be in the band.
+    interface_cells.clear();
+    for (auto &f_cell : band)
+      {
+        const int indicator = indicators[f_cell->active_cell_index()];
+        GridTools::get_active_neighbors<DoFHandler<dim>>(f_cell, neighbors);
+        for (auto &neighbor : neighbors)
+          {
+            if (neighbor->is_locally_owned() &&
+                indicators[neighbor->active_cell_index()] != indicator)
+              {
+                interface_cells.push_back(f_cell);
+                break;
+              }
+          }
+      }
+    for (auto &f_cell : band)
+      {
+        indicator_band_layer[f_cell->active_cell_index()] =
+          numbers::invalid_unsigned_int;
+      }
+    return contained;
+  }
+
+  template <int dim>
+  void FSI<dim>::deactivate_artificial_interior(
+    const unsigned int n_layers,
+    std::vector<types::global_dof_index> &inactive_dofs)
+  {
+    auto &property = fluid_solver.cell_property;
+    const std::vector<int> &indicators = property.indicator;
+    std::vector<unsigned int> layer(fluid_solver.triangulation.n_active_cells(),
+                                    numbers::invalid_unsigned_int);
+    // The first layer touches the real fluid or another subdomain.
+    std::vector<typename DoFHandler<dim>::active_cell_iterator> band,
+      neighbors;
+    for (const auto &f_cell : relevant_fluid_cells)
+      {
+        if (!f_cell->is_locally_owned() ||
+            indicators[f_cell->active_cell_index()] == 0)
+          continue;
+        GridTools::get_active_neighbors<DoFHandler<dim>>(f_cell, neighbors);
+        for (auto &neighbor : neighbors)
+          {
+            if (!neighbor->is_locally_owned() ||
+                indicators[neighbor->active_cell_index()] == 0)
+              {
+                layer[f_cell->active_cell_index()] = 1;
+                band.push_back(f_cell);
+                break;
+              }
+          }
+      }
+    unsigned int layer_begin = 0;
+    for (unsigned int l = 2; l <= n_layers; ++l)
+      {
+        const unsigned int layer_end = band.size();
+        for (unsigned int c = layer_begin; c < layer_end; ++c)
+          {
+            GridTools::get_active_neighbors<DoFHandler<dim>>(band[c],
+                                                             neighbors);
+            for (auto &neighbor : neighbors)
+              {
+                const unsigned int index = neighbor->active_cell_index();
+                if (neighbor->is_locally_owned() && indicators[index] == 1 &&
+                    layer[index] == numbers::invalid_unsigned_int)
+                  {
+                    layer[index] = l;
+                    band.push_back(neighbor);
+                  }
+              }
+          }
+        layer_begin = layer_end;
+      }
+
+    // A dof of an inactive cell stays free if any other relevant cell has
+    // it, e.g. a real fluid cell that only shares a vertex.
+    const IndexSet &relevant_dofs = fluid_solver.locally_relevant_dofs;
+    std::vector<char> needed(relevant_dofs.n_elements(), 0),
+      candidate(relevant_dofs.n_elements(), 0);
+    std::vector<types::global_dof_index> dof_indices(
+      fluid_solver.fe.dofs_per_cell);
+    for (const auto &f_cell : relevant_fluid_cells)
+      {
+        const unsigned int index = f_cell->active_cell_index();
+        const bool inactive = f_cell->is_locally_owned() &&
+                              indicators[index] == 1 &&
+                              layer[index] == numbers::invalid_unsigned_int;
+        if (f_cell->is_locally_owned())
+          property.inactive[index] = inactive;
+        f_cell->get_dof_indices(dof_indices);
+        std::vector<char> &marks = inactive ? candidate : needed;
+        for (const auto dof : dof_indices)
+          {
+            marks[relevant_dofs.index_within_set(dof)] = 1;
+          }
+      }
+    inactive_dofs.clear();
+    for (unsigned int i = 0; i < candidate.size(); ++i)
+      {
+        if (candidate[i] && !needed[i])
+          inactive_dofs.push_back(relevant_dofs.nth_index_in_set(i));
+      }
+  }
+
+  // This function interpolates the solid velocity into the fluid solver,
+  // as the Dirichlet boundary conditions for artificial fluid vertices
   template <int dim>
   void FSI<dim>::find_fluid_bc()
   {
-    TimerOutput::Scope timer_section(timer, "Find fluid BC");
+    Utils::ProfilingScope timer_section(timer, "Find fluid BC");
+    Utils::PerformanceCounters::Scope counter_section(counters,
+                                                      "find_fluid_bc");
     move_solid_mesh(true);
 
     // The nonzero Dirichlet BCs (to set the velocity) and zero Dirichlet
@@ -324,163 +1259,155 @@ namespace MPI
     std::vector<SymmetricTensor<2, dim>> sym_grad_v(1);
     std::vector<double> p(1);
     std::vector<Tensor<2, dim>> grad_v(1);
-    std::vector<Tensor<1, dim>> v(1);
-    std::vector<Tensor<1, dim>> dv(1);
 
-    // Cell center in unit coordinate system
-    Point<dim> unit_center;
-    for (unsigned int i = 0; i < dim; ++i)
-      {
-        unit_center[i] = 0.5;
-      }
-    Quadrature<dim> quad(unit_center);
-    MappingQGeneric<dim> mapping(parameters.fluid_velocity_degree);
-    FEValues<dim> fe_values(mapping,
-                            fluid_solver.fe,
-                            quad,
-                            update_quadrature_points | update_values |
-                              update_gradients);
-    Vector<double> localized_solid_velocity(solid_solver.current_velocity);
-    Vector<double> localized_solid_acceleration(
-      solid_solver.current_acceleration);
-    std::vector<std::vector<Vector<double>>> localized_stress(
-      dim, std::vector<Vector<double>>(dim));
-    for (unsigned int i = 0; i < dim; ++i)
+    // The artificial fluid deep inside the solid needs no solid values.
+    std::vector<types::global_dof_index> inactive_dofs;
+    if (parameters.artificial_fluid_band_layers > 0)
       {
-        for (unsigned int j = 0; j < dim; ++j)
-          {
-            localized_stress[i][j] = solid_solver.stress[i][j];
-          }
+        deactivate_artificial_interior(parameters.artificial_fluid_band_layers,
+                                       inactive_dofs);
       }
 
-    const std::vector<Point<dim>> &unit_points =
-      fluid_solver.fe.get_unit_support_points();
-    Quadrature<dim> dummy_q(unit_points);
-    FEValues<dim> dummy_fe_values(
-      mapping, fluid_solver.fe, dummy_q, update_quadrature_points);
-    std::vector<types::global_dof_index> dof_indices(
-      fluid_solver.fe.dofs_per_cell);
-    std::vector<unsigned int> dof_touched(fluid_solver.dof_handler.n_dofs(), 0);
+    // Cell center in unit coordinate system
+    const Point<dim> &unit_center =
+      fluid_center_values.get_quadrature().point(0);
+    const MappingQGeneric<dim> &mapping = fluid_mapping;
+    FEValues<dim> &fe_values = fluid_center_values;
+    // The solid velocity and acceleration are ghosted in update_solid_box.
 
-    for (auto f_cell = fluid_solver.dof_handler.begin_active();
-         f_cell != fluid_solver.dof_handler.end();
-         ++f_cell)
+    // Locating the points in the solid only reads the meshes, so it is done
+    // by the threads first. The solution vectors are evaluated and the
+    // constraints are set afterwards in the cell order. The cells and the
+    // support points are collected in setup_cell_hints.
+    const auto &cells = relevant_fluid_cells;
+
+    // The solid cells that contain the centers of the locally owned
+    // artificial fluid cells.
+    std::vector<typename DoFHandler<dim>::active_cell_iterator> solid_cells(
+      use_dirichlet_bc ? 0 : cells.size(), solid_solver.dof_handler.end());
+    Threads::ThreadLocalStorage<Utils::CellLocator<dim, DoFHandler<dim>>>
+      locators(solid_locator);
+    if (use_dirichlet_bc)
       {
-        // Use is_artificial() instead of !is_locally_owned() because ghost
-        // elements must be taken care of to set correct Dirichlet BCs!
-        if (f_cell->is_artificial())
-          {
-            continue;
-          }
-        // Now skip the ghost elements because it's not store in cell property.
-        if (!use_dirichlet_bc && f_cell->is_locally_owned())
-          {
-            // Start working on the cell
-            auto ptr = fluid_solver.cell_property.get_data(f_cell);
-            ptr[0]->fsi_acceleration = 0;
-            ptr[0]->fsi_stress = 0;
-            if (ptr[0]->indicator == 0)
-              continue;
-            fe_values.reinit(f_cell);
-            // Fluid velocity increment at cell center
-            fe_values[velocities].get_function_values(
-              fluid_solver.solution_increment, dv);
-            // Fluid velocity gradient at cell center
-            fe_values[velocities].get_function_gradients(
-              fluid_solver.present_solution, grad_v);
-            // Fluid symmetric velocity gradient at cell center
-            fe_values[velocities].get_function_symmetric_gradients(
-              fluid_solver.present_solution, sym_grad_v);
-            // Fluid pressure at cell center
-            fe_values[pressure].get_function_values(
-              fluid_solver.present_solution, p);
-            // Real coordinates of fluid cell center
-            auto point = fe_values.get_quadrature_points()[0];
-            // Solid acceleration at fluid cell center
-            Vector<double> solid_acc(dim);
-            Utils::GridInterpolator<dim, Vector<double>> interpolator(
-              solid_solver.dof_handler, point);
-            interpolator.point_value(localized_solid_acceleration, solid_acc);
-            // Get solid cell material id
-            ptr[0]->material_id = interpolator.get_cell()->material_id();
-            // Fluid total acceleration at cell center
-            Tensor<1, dim> fluid_acc =
-              dv[0] / time.get_delta_t() + grad_v[0] * v[0];
-            (void)fluid_acc;
-            // FSI acceleration term:
-            for (unsigned int i = 0; i < dim; ++i)
+        parallel::apply_to_subranges(
+          0u,
+          static_cast<unsigned int>(support_points.size()),
+          [&](const unsigned int begin, const unsigned int end) {
+            Utils::CellLocator<dim, DoFHandler<dim>> &locator = locators.get();
+            for (unsigned int k = begin; k < end; ++k)
               {
-                ptr[0]->fsi_acceleration[i] = fluid_acc[i] - solid_acc[i];
+                SupportPoint &s = support_points[k];
+                s.in_solid =
+                  point_in_solid(solid_solver.dof_handler, s.point);
+                if (!s.in_solid)
+                  continue;
+                // Every support point has its own hint.
+                *(s.hint) = locator.search(s.point, *(s.hint));
               }
-          }
-        // Dirichlet BCs
-        if (use_dirichlet_bc)
-          {
-            dummy_fe_values.reinit(f_cell);
-            f_cell->get_dof_indices(dof_indices);
-            auto support_points = dummy_fe_values.get_quadrature_points();
-            auto hints = cell_hints.get_data(f_cell);
-            // Declare the fluid velocity for interpolating BC
-            Vector<double> fluid_velocity(dim);
-            // Loop over the support points to set Dirichlet BCs.
-            for (unsigned int i = 0; i < unit_points.size(); ++i)
+          },
+          coupling_grainsize);
+      }
+    else
+      {
+        parallel::apply_to_subranges(
+          0u,
+          static_cast<unsigned int>(cells.size()),
+          [&](const unsigned int begin, const unsigned int end) {
+            for (unsigned int c = begin; c < end; ++c)
               {
-                // Skip the already-set dofs.
-                if (dof_touched[dof_indices[i]] != 0)
-                  continue;
-                auto base_index = fluid_solver.fe.system_to_base_index(i);
-                const unsigned int i_group = base_index.first.first;
-                Assert(i_group < 2,
-                       ExcMessage(
-                         "There should be only 2 groups of finite element!"));
-                if (i_group == 1)
-                  continue; // skip the pressure dofs
-                bool inside = true;
-                for (unsigned int d = 0; d < dim; ++d)
-                  if (std::abs(unit_points[i][d]) < 1e-5)
-                    {
-                      inside = false;
-                      break;
-                    }
-                if (inside)
-                  continue; // skip the in-cell support point
-                // Same as fluid_solver.fe.system_to_base_index(i).first.second;
-                const unsigned int index =
-                  fluid_solver.fe.system_to_component_index(i).first;
-                Assert(index < dim,
-                       ExcMessage("Vector component should be less than dim!"));
-                dof_touched[dof_indices[i]] = 1;
-                if (!point_in_solid(solid_solver.dof_handler,
-                                    support_points[i]))
+                if (!cells[c]->is_locally_owned() ||
+                    fluid_solver.cell_property
+                        .indicator[cells[c]->active_cell_index()] == 0 ||
+                    fluid_solver.cell_property
+                      .inactive[cells[c]->active_cell_index()])
                   continue;
-                Utils::CellLocator<dim, DoFHandler<dim>> locator(
-                  solid_solver.dof_handler, support_points[i], *(hints[i]));
-                *(hints[i]) = locator.search();
-                Utils::GridInterpolator<dim, Vector<double>> interpolator(
-                  solid_solver.dof_handler, support_points[i], {}, *(hints[i]));
-                if (!interpolator.found_cell())
-                  {
-                    std::stringstream message;
-                    message
-                      << "Cannot find point in solid: " << support_points[i]
-                      << std::endl;
-                    AssertThrow(interpolator.found_cell(),
-                                ExcMessage(message.str()));
-                  }
-                interpolator.point_value(localized_solid_velocity,
-                                         fluid_velocity);
-                auto line = dof_indices[i];
-                inner_nonzero.add_line(line);
-                inner_zero.add_line(line);
-                // Note that we are setting the value of the constraint to the
-                // velocity delta!
-                inner_nonzero.set_inhomogeneity(
-                  line,
-                  fluid_velocity[index] - fluid_solver.present_solution(line));
+                solid_cells[c] = solid_tree.find_cell(
+                  mapping.transform_unit_to_real_cell(cells[c], unit_center));
               }
+          },
+          coupling_grainsize);
+      }
+
+    auto &property = fluid_solver.cell_property;
+    for (unsigned int c = 0; c < cells.size() && !use_dirichlet_bc; ++c)
+      {
+        const auto &f_cell = cells[c];
+        // Now skip the ghost elements because it's not store in cell property.
+        if (!f_cell->is_locally_owned())
+          continue;
+        // Start working on the cell
+        const unsigned int cell_index = f_cell->active_cell_index();
+        property.fsi_acceleration[cell_index] = 0;
+        property.fsi_stress[cell_index] = 0;
+        if (property.indicator[cell_index] == 0 ||
+            property.inactive[cell_index])
+          continue;
+        fe_values.reinit(f_cell);
+        // Fluid velocity gradient at cell center
+        fe_values[velocities].get_function_gradients(
+          fluid_solver.present_solution, grad_v);
+        // Fluid symmetric velocity gradient at cell center
+        fe_values[velocities].get_function_symmetric_gradients(
+          fluid_solver.present_solution, sym_grad_v);
+        // Fluid pressure at cell center
+        fe_values[pressure].get_function_values(fluid_solver.present_solution,
+                                                p);
+        // Real coordinates of fluid cell center
+        auto point = fe_values.get_quadrature_points()[0];
+        // Solid acceleration at fluid cell center
+        Vector<double> solid_acc(dim);
+        Utils::GridInterpolator<dim, PETScWrappers::MPI::Vector> interpolator(
+          solid_solver.dof_handler, point, {}, solid_cells[c]);
+        interpolator.point_value(ghosted_solid_acceleration, solid_acc);
+        // Get solid cell material id
+        property.material_id[cell_index] =
+          interpolator.get_cell()->material_id();
+        // Fluid total acceleration at cell center
+        const Tensor<1, dim> fluid_acc =
+          fluid_solver.fsi_fluid_acceleration(fe_values, time.get_delta_t());
+        // FSI acceleration term:
+        for (unsigned int i = 0; i < dim; ++i)
+          {
+            property.fsi_acceleration[cell_index][i] =
+              fluid_acc[i] - solid_acc[i];
           }
       }
-    if (use_dirichlet_bc)
+
+    // Dirichlet BCs
+    // Declare the fluid velocity for interpolating BC
+    Vector<double> fluid_velocity(dim);
+    for (const auto &s : support_points)
+      {
+        if (!s.in_solid)
+          continue;
+        Utils::GridInterpolator<dim, PETScWrappers::MPI::Vector> interpolator(
+          solid_solver.dof_handler, s.point, {}, *(s.hint));
+        if (!interpolator.found_cell())
+          {
+            std::stringstream message;
+            message << "Cannot find point in solid: " << s.point << std::endl;
+            AssertThrow(interpolator.found_cell(), ExcMessage(message.str()));
+          }
+        interpolator.point_value(ghosted_solid_velocity, fluid_velocity);
+        auto line = s.dof;
+        inner_nonzero.add_line(line);
+        inner_zero.add_line(line);
+        // Note that we are setting the value of the constraint to the
+        // velocity delta!
+        inner_nonzero.set_inhomogeneity(
+          line,
+          fluid_velocity[s.component] - fluid_solver.present_solution(line));
+      }
+    // The dofs of the inactive cells keep their values, unless they are in
+    // the solid Dirichlet BCs already.
+    for (const auto dof : inactive_dofs)
+      {
+        if (inner_zero.is_constrained(dof))
+          continue;
+        inner_nonzero.add_line(dof);
+        inner_zero.add_line(dof);
+      }
+    if (use_dirichlet_bc || !inactive_dofs.empty())
       {
         inner_nonzero.close();
         inner_zero.close();
@@ -491,18 +1418,23 @@ namespace MPI
           inner_zero,
           AffineConstraints<double>::MergeConflictBehavior::left_object_wins);
       }
-    move_solid_mesh(false);
   }
 
   template <int dim>
   void FSI<dim>::find_solid_bc()
   {
-    TimerOutput::Scope timer_section(timer, "Find solid BC");
+    start_solid_bc_exchange();
+    finish_solid_bc_exchange();
+  }
+
+  template <int dim>
+  void FSI<dim>::start_solid_bc_exchange()
+  {
+    Utils::ProfilingScope timer_section(timer, "Find solid BC");
+    Utils::PerformanceCounters::Scope counter_section(counters,
+                                                      "find_solid_bc");
     // Must use the updated solid coordinates
     move_solid_mesh(true);
-    // Fluid FEValues to do interpolation
-    FEValues<dim> fe_values(
-      fluid_solver.fe, fluid_solver.volume_quad_formula, update_values);
     // Solid FEFaceValues to get the normal
     FEFaceValues<dim> fe_face_values(solid_solver.fe,
                                      solid_solver.face_quad_formula,
@@ -510,108 +1442,295 @@ namespace MPI
                                        update_normal_vectors);
 
     const unsigned int n_face_q_points = solid_solver.face_quad_formula.size();
+    // Every point carries dim + 1 values and (dim + 1) * dim gradients.
+    const unsigned int n_entries = (dim + 1) * (dim + 1);
 
-    for (auto s_cell = solid_solver.dof_handler.begin_active();
-         s_cell != solid_solver.dof_handler.end();
-         ++s_cell)
+    // First pass: collect the quadrature points and normals on all of the
+    // solid boundary faces, so that the fluid solution can be exchanged with
+    // a single collective instead of one per point. Only the faces in the
+    // interface list of the solid are visited.
+    const unsigned int n_interface_points =
+      solid_solver.cell_property.fsi_traction.size();
+    std::vector<Point<dim>> q_points(n_interface_points);
+    std::vector<Tensor<1, dim>> &normals = solid_bc_normals;
+    normals.resize(n_interface_points);
+    for (unsigned int k = 0; k < solid_solver.interface_faces.size(); ++k)
       {
-        auto ptr = solid_solver.cell_property.get_data(s_cell);
-        for (unsigned int f = 0; f < GeometryInfo<dim>::faces_per_cell; ++f)
+        fe_face_values.reinit(solid_solver.interface_faces[k].first,
+                              solid_solver.interface_faces[k].second);
+        for (unsigned int q = 0; q < n_face_q_points; ++q)
+          {
+            q_points[k * n_face_q_points + q] =
+              fe_face_values.quadrature_point(q);
+            normals[k * n_face_q_points + q] = fe_face_values.normal_vector(q);
+          }
+      }
+
+    // Second pass: evaluate the fluid solution at the points owned by the
+    // current process. The interpolator returns 0 for the points that are
+    // not found or not locally owned, so a sum gives the global values.
+    // The fluid cells found in the previous call are used as the starting
+    // point of the search.
+    if (solid_bc_hints.size() != q_points.size())
+      {
+        solid_bc_hints.assign(q_points.size(), fluid_solver.dof_handler.end());
+      }
+    Vector<double> &local_buffer = solid_bc_send_buffer;
+    local_buffer.reinit(q_points.size() * n_entries);
+    // The points found in locally owned cells, as pairs of the active cell
+    // index and the point index, sorted so that the points in the same cell
+    // are evaluated together.
+    std::mutex counter_mutex;
+    parallel::apply_to_subranges(
+      0u,
+      static_cast<unsigned int>(q_points.size()),
+      [&](const unsigned int begin, const unsigned int end) {
+        Utils::PerformanceCounters::Record record;
+        for (unsigned int n = begin; n < end; ++n)
+          {
+            solid_bc_hints[n] =
+              locate_fluid_point(q_points[n], solid_bc_hints[n], record);
+          }
+        std::lock_guard<std::mutex> lock(counter_mutex);
+        counters["locate_fluid_point"].hits += record.hits;
+        counters["locate_fluid_point"].misses += record.misses;
+      },
+      coupling_grainsize);
+    std::vector<std::pair<unsigned int, unsigned int>> cell_points;
+    for (unsigned int n = 0; n < q_points.size(); ++n)
+      {
+        if (solid_bc_hints[n] != fluid_solver.dof_handler.end() &&
+            solid_bc_hints[n]->is_locally_owned())
           {
-            // Current face is at boundary and without Dirichlet bc.
-            if (s_cell->face(f)->at_boundary())
+            cell_points.emplace_back(solid_bc_hints[n]->active_cell_index(), n);
+          }
+      }
+    std::sort(cell_points.begin(), cell_points.end());
+    Utils::CellPointInterpolator<dim, PETScWrappers::MPI::BlockVector>
+      interpolator(fluid_solver.dof_handler);
+    std::vector<Point<dim>> points_in_cell;
+    for (unsigned int begin = 0, end = 0; begin < cell_points.size();
+         begin = end)
+      {
+        points_in_cell.clear();
+        while (end < cell_points.size() &&
+               cell_points[end].first == cell_points[begin].first)
+          {
+            points_in_cell.push_back(q_points[cell_points[end].second]);
+            ++end;
+          }
+        interpolator.evaluate(solid_bc_hints[cell_points[begin].second],
+                              points_in_cell,
+                              fluid_solver.present_solution);
+        for (unsigned int k = begin; k < end; ++k)
+          {
+            const unsigned int offset = cell_points[k].second * n_entries;
+            for (unsigned int i = 0; i < dim + 1; ++i)
               {
-                fe_face_values.reinit(s_cell, f);
-                for (unsigned int q = 0; q < n_face_q_points; ++q)
+                local_buffer[offset + i] = interpolator.value(k - begin, i);
+                const Tensor<1, dim> &gradient =
+                  interpolator.gradient(k - begin, i);
+                for (unsigned int j = 0; j < dim; ++j)
                   {
-                    Point<dim> q_point = fe_face_values.quadrature_point(q);
-                    Tensor<1, dim> normal = fe_face_values.normal_vector(q);
-                    Vector<double> value(dim + 1);
-                    Utils::GridInterpolator<dim,
-                                            PETScWrappers::MPI::BlockVector>
-                      interpolator(
-                        fluid_solver.dof_handler, q_point, vertices_mask);
-                    interpolator.point_value(fluid_solver.present_solution,
-                                             value);
-                    std::vector<Tensor<1, dim>> gradient(dim + 1,
-                                                         Tensor<1, dim>());
-                    interpolator.point_gradient(fluid_solver.present_solution,
-                                                gradient);
-                    Vector<double> global_value(dim + 1);
-                    std::vector<Tensor<1, dim>> global_gradient(
-                      dim + 1, Tensor<1, dim>());
-                    for (unsigned int i = 0; i < dim + 1; ++i)
-                      {
-                        global_value[i] =
-                          Utilities::MPI::sum(value[i], mpi_communicator);
-                        global_gradient[i] =
-                          Utilities::MPI::sum(gradient[i], mpi_communicator);
-                      }
-                    // Compute stress
-                    SymmetricTensor<2, dim> sym_deformation;
-                    for (unsigned int i = 0; i < dim; ++i)
-                      {
-                        for (unsigned int j = 0; j < dim; ++j)
-                          {
-                            sym_deformation[i][j] =
-                              (global_gradient[i][j] + global_gradient[j][i]) /
-                              2;
-                          }
-                      }
-                    // \f$ \sigma = -p\bold{I} + \mu\nabla^S v\f$
-                    SymmetricTensor<2, dim> stress =
-                      -global_value[dim] *
-                        Physics::Elasticity::StandardTensors<dim>::I +
-                      2 * parameters.viscosity * sym_deformation;
-                    ptr[f * n_face_q_points + q]->fsi_traction =
-                      stress * normal;
+                    local_buffer[offset + dim + 1 + i * dim + j] = gradient[j];
                   }
               }
           }
       }
-    move_solid_mesh(false);
+    // Post the reduction without waiting for it, so that other work can be
+    // done before the tractions are needed.
+    solid_bc_recv_buffer.reinit(local_buffer.size());
+    const int ierr = MPI_Iallreduce(local_buffer.begin(),
+                                    solid_bc_recv_buffer.begin(),
+                                    local_buffer.size(),
+                                    MPI_DOUBLE,
+                                    MPI_SUM,
+                                    mpi_communicator,
+                                    &solid_bc_request);
+    AssertThrowMPI(ierr);
   }
 
   template <int dim>
-  void FSI<dim>::refine_mesh(const unsigned int min_grid_level,
-                             const unsigned int max_grid_level)
+  void FSI<dim>::finish_solid_bc_exchange()
   {
-    TimerOutput::Scope timer_section(timer, "Refine mesh");
-    move_solid_mesh(true);
+    Utils::ProfilingScope timer_section(timer, "Wait for solid BC");
+    Utils::PerformanceCounters::Scope counter_section(counters,
+                                                      "find_solid_bc");
+    const double mpi_start = MPI_Wtime();
+    const int ierr = MPI_Wait(&solid_bc_request, MPI_STATUS_IGNORE);
+    AssertThrowMPI(ierr);
+    counters["find_solid_bc"].mpi_time += MPI_Wtime() - mpi_start;
+    counters["find_solid_bc"].bytes +=
+      sizeof(double) * solid_bc_send_buffer.size();
+    const unsigned int n_entries = (dim + 1) * (dim + 1);
+    const Vector<double> &global_buffer = solid_bc_recv_buffer;
+    const std::vector<Tensor<1, dim>> &normals = solid_bc_normals;
+
+    // Third pass: compute the traction in the same order as collected.
+    for (unsigned int n = 0; n < solid_solver.cell_property.fsi_traction.size();
+         ++n)
+      {
+        const unsigned int offset = n * n_entries;
+        // Compute stress
+        SymmetricTensor<2, dim> sym_deformation;
+        for (unsigned int i = 0; i < dim; ++i)
+          {
+            for (unsigned int j = 0; j < dim; ++j)
+              {
+                sym_deformation[i][j] =
+                  (global_buffer[offset + dim + 1 + i * dim + j] +
+                   global_buffer[offset + dim + 1 + j * dim + i]) /
+                  2;
+              }
+          }
+        // \f$ \sigma = -p\bold{I} + \mu\nabla^S v\f$
+        SymmetricTensor<2, dim> stress =
+          -global_buffer[offset + dim] *
+            Physics::Elasticity::StandardTensors<dim>::I +
+          2 * parameters.viscosity * sym_deformation;
+        solid_solver.cell_property.fsi_traction[n] = stress * normals[n];
+      }
+  }
+
+  template <int dim>
+  void FSI<dim>::flag_cells_near_solid_boundary()
+  {
+    // The largest query radius is the largest cell diameter, bins of that
+    // size only need to look at the neighboring bins.
+    double max_diameter = 0;
+    for (auto f_cell : fluid_solver.dof_handler.active_cell_iterators())
+      {
+        if (f_cell->is_locally_owned())
+          max_diameter = std::max(max_diameter, f_cell->diameter());
+      }
+    // Only the parts within the query radius of the locally owned fluid
+    // cells can flag them.
+    std::vector<bool> near_parts(parameters.n_solid_parts,
+                                 solid_part_boxes.empty());
+    for (unsigned int p = 0; p < solid_part_boxes.size(); ++p)
+      {
+        const Vector<double> &box = solid_part_boxes[p];
+        if (box.size() == 0)
+          continue;
+        near_parts[p] = true;
+        for (unsigned int i = 0; i < dim; ++i)
+          {
+            if (box(2 * i + 1) < local_fluid_box(2 * i) - max_diameter ||
+                box(2 * i) > local_fluid_box(2 * i + 1) + max_diameter)
+              near_parts[p] = false;
+          }
+      }
     std::vector<Point<dim>> solid_boundary_points;
     for (auto s_cell : solid_solver.dof_handler.active_cell_iterators())
       {
-        bool is_boundary = false;
-        Point<dim> point;
+        if (!near_parts[solid_part_of(s_cell)])
+          continue;
         for (unsigned int face = 0; face < GeometryInfo<dim>::faces_per_cell;
              ++face)
           {
             if (s_cell->face(face)->at_boundary())
               {
-                point = s_cell->face(face)->center();
-                is_boundary = true;
+                solid_boundary_points.push_back(s_cell->face(face)->center());
                 break;
               }
           }
-        if (is_boundary)
-          {
-            solid_boundary_points.push_back(point);
-          }
       }
+    const Utils::PointBins<dim> bins(solid_boundary_points, max_diameter);
     for (auto f_cell : fluid_solver.dof_handler.active_cell_iterators())
       {
-        auto center = f_cell->center();
-        double dist = 1000;
-        for (auto point : solid_boundary_points)
+        if (!f_cell->is_locally_owned())
+          continue;
+        if (bins.any_within(f_cell->center(), f_cell->diameter()))
+          f_cell->set_refine_flag();
+        else
+          f_cell->set_coarsen_flag();
+      }
+  }
+
+  template <int dim>
+  void FSI<dim>::flag_cells_in_indicator_band(const unsigned int n_layers)
+  {
+    // The distance of every cell to the interface in layers, the ghost
+    // cells are updated after every layer so that the band continues
+    // across the subdomain boundaries.
+    const unsigned int invalid = numbers::invalid_unsigned_int;
+    std::vector<int> indicator(fluid_solver.cell_property.indicator);
+    std::vector<unsigned int> layer(fluid_solver.triangulation.n_active_cells(),
+                                    invalid);
+    using cell_iterator = typename DoFHandler<dim>::active_cell_iterator;
+    GridTools::exchange_cell_data_to_ghosts<int, DoFHandler<dim>>(
+      fluid_solver.dof_handler,
+      [&](const cell_iterator &cell) {
+        return boost::optional<int>(indicator[cell->active_cell_index()]);
+      },
+      [&](const cell_iterator &cell, const int &value) {
+        indicator[cell->active_cell_index()] = value;
+      });
+
+    std::vector<cell_iterator> neighbors;
+    for (unsigned int l = 0; l <= n_layers; ++l)
+      {
+        for (auto f_cell : fluid_solver.dof_handler.active_cell_iterators())
+          {
+            if (!f_cell->is_locally_owned() ||
+                layer[f_cell->active_cell_index()] != invalid)
+              continue;
+            GridTools::get_active_neighbors<DoFHandler<dim>>(f_cell,
+                                                             neighbors);
+            for (auto &neighbor : neighbors)
+              {
+                const unsigned int index = neighbor->active_cell_index();
+                if ((l == 0 &&
+                     indicator[index] !=
+                       indicator[f_cell->active_cell_index()]) ||
+                    (l > 0 && layer[index] == l - 1))
+                  {
+                    layer[f_cell->active_cell_index()] = l;
+                    break;
+                  }
+              }
+          }
+        if (l < n_layers)
           {
-            dist = std::min(center.distance(point), dist);
+            GridTools::exchange_cell_data_to_ghosts<unsigned int,
+                                                    DoFHandler<dim>>(
+              fluid_solver.dof_handler,
+              [&](const cell_iterator &cell) {
+                return boost::optional<unsigned int>(
+                  layer[cell->active_cell_index()]);
+              },
+              [&](const cell_iterator &cell, const unsigned int &value) {
+                layer[cell->active_cell_index()] = value;
+              });
           }
-        if (dist < f_cell->diameter())
+      }
+
+    for (auto f_cell : fluid_solver.dof_handler.active_cell_iterators())
+      {
+        if (!f_cell->is_locally_owned())
+          continue;
+        if (layer[f_cell->active_cell_index()] != invalid)
           f_cell->set_refine_flag();
         else
           f_cell->set_coarsen_flag();
       }
-    move_solid_mesh(false);
+  }
+
+  template <int dim>
+  bool FSI<dim>::refine_mesh(const unsigned int min_grid_level,
+                             const unsigned int max_grid_level)
+  {
+    Utils::ProfilingScope timer_section(timer, "Refine mesh");
+    Utils::PerformanceCounters::Scope counter_section(counters, "refine_mesh");
+    move_solid_mesh(true);
+    if (parameters.refinement_criterion == "Band")
+      {
+        flag_cells_in_indicator_band(parameters.refinement_band_layers);
+      }
+    else
+      {
+        flag_cells_near_solid_boundary();
+      }
     if (fluid_solver.triangulation.n_levels() > max_grid_level)
       {
         for (auto cell =
@@ -630,28 +1749,470 @@ namespace MPI
         cell->clear_coarsen_flag();
       }
 
+    // Nothing to do if no cell is left flagged after the flags are made
+    // consistent, which happens once the mesh has adapted to the solid.
+    fluid_solver.triangulation.prepare_coarsening_and_refinement();
+    bool changed = false;
+    for (auto cell : fluid_solver.triangulation.active_cell_iterators())
+      {
+        if (cell->is_locally_owned() &&
+            (cell->refine_flag_set() || cell->coarsen_flag_set()))
+          {
+            changed = true;
+            break;
+          }
+      }
+    if (Utilities::MPI::max(static_cast<int>(changed), mpi_communicator) == 0)
+      {
+        pcout << "The fluid mesh is unchanged." << std::endl;
+        return false;
+      }
+    redistribute_fluid(true);
+    return true;
+  }
+
+  template <int dim>
+  void FSI<dim>::redistribute_fluid(const bool refine)
+  {
     parallel::distributed::SolutionTransfer<dim,
                                             PETScWrappers::MPI::BlockVector>
       solution_transfer(fluid_solver.dof_handler);
 
-    fluid_solver.triangulation.prepare_coarsening_and_refinement();
+    if (refine)
+      fluid_solver.triangulation.prepare_coarsening_and_refinement();
     solution_transfer.prepare_for_coarsening_and_refinement(
-      fluid_solver.present_solution);
+      fluid_solver.solutions_to_transfer());
 
-    fluid_solver.triangulation.execute_coarsening_and_refinement();
+    // The indicator of the current step is known, so the cells are
+    // partitioned with their actual cost.
+    fluid_solver.compute_cell_weights();
+    if (refine)
+      fluid_solver.triangulation.execute_coarsening_and_refinement();
+    else
+      fluid_solver.triangulation.repartition();
+    fluid_solver.cell_weights.clear();
 
     fluid_solver.setup_dofs();
     fluid_solver.make_constraints();
     fluid_solver.initialize_system();
 
-    PETScWrappers::MPI::BlockVector buffer;
-    buffer.reinit(fluid_solver.owned_partitioning,
-                  fluid_solver.mpi_communicator);
-    buffer = 0;
-    solution_transfer.interpolate(buffer);
-    fluid_solver.nonzero_constraints.distribute(buffer);
-    fluid_solver.present_solution = buffer;
+    fluid_solver.interpolate_solutions(solution_transfer);
     update_vertices_mask();
+    // The fluid cells have changed, the cached point locations and the
+    // indicator band are invalid.
+    solid_bc_hints.clear();
+    solid_vertex_hints.clear();
+    solid_vertex_owners.clear();
+    indicator_band_valid = false;
+    align_solid_partition();
+  }
+
+  template <int dim>
+  void FSI<dim>::align_solid_partition()
+  {
+    if (parameters.solid_partitioner != "Fluid aligned")
+      {
+        return;
+      }
+    const unsigned int n_procs =
+      Utilities::MPI::n_mpi_processes(mpi_communicator);
+    const unsigned int this_rank =
+      Utilities::MPI::this_mpi_process(mpi_communicator);
+    const unsigned int n_cells = solid_solver.triangulation.n_active_cells();
+
+    // The owner of the fluid cell around the center of every solid cell,
+    // n_procs if the center is not in the fluid.
+    std::vector<unsigned int> fluid_owners(n_cells, n_procs);
+    Utils::PerformanceCounters::Record record;
+    for (auto cell = solid_solver.triangulation.begin_active();
+         cell != solid_solver.triangulation.end();
+         ++cell)
+      {
+        auto fluid_cell = locate_fluid_point(
+          cell->center(), fluid_solver.dof_handler.end(), record);
+        if (fluid_cell != fluid_solver.dof_handler.end() &&
+            fluid_cell->is_locally_owned())
+          {
+            fluid_owners[cell->active_cell_index()] = this_rank;
+          }
+      }
+    Utilities::MPI::min(fluid_owners, mpi_communicator, fluid_owners);
+
+    // Every process computes the same partition from the same owners. The
+    // solid cells all have the same cost.
+    const unsigned int capacity = static_cast<unsigned int>(std::ceil(
+      parameters.solid_partition_imbalance * n_cells / n_procs));
+    const unsigned int average = (n_cells + n_procs - 1) / n_procs;
+    std::vector<unsigned int> n_owned_cells(n_procs, 0);
+    std::vector<types::subdomain_id> subdomains(n_cells);
+    std::vector<unsigned int> remaining_cells;
+    for (unsigned int c = 0; c < n_cells; ++c)
+      {
+        const unsigned int owner = fluid_owners[c];
+        if (owner < n_procs && n_owned_cells[owner] < capacity)
+          {
+            subdomains[c] = owner;
+            ++n_owned_cells[owner];
+          }
+        else
+          {
+            remaining_cells.push_back(c);
+          }
+      }
+    // Fill the processes below the average one after another, so that the
+    // remaining cells of a process are contiguous in the active cell order.
+    unsigned int process = 0;
+    for (auto c : remaining_cells)
+      {
+        while (n_owned_cells[process] >= average)
+          {
+            ++process;
+          }
+        subdomains[c] = process;
+        ++n_owned_cells[process];
+      }
+
+    bool changed = false;
+    for (auto cell = solid_solver.triangulation.begin_active();
+         cell != solid_solver.triangulation.end();
+         ++cell)
+      {
+        if (cell->subdomain_id() != subdomains[cell->active_cell_index()])
+          {
+            changed = true;
+            break;
+          }
+      }
+    if (!changed)
+      {
+        return;
+      }
+    pcout << "Aligning the solid partition with the fluid..." << std::endl;
+    // The solid solver works in the reference configuration.
+    const bool deformed = solid_mesh_deformed;
+    move_solid_mesh(false);
+    solid_solver.repartition(subdomains);
+    // The mesh is the same, but the dofs of its vertices are not.
+    solid_vertices.invalidate();
+    if (deformed)
+      {
+        move_solid_mesh(true);
+        update_solid_ghosts();
+      }
+  }
+
+  template <int dim>
+  void FSI<dim>::run_solid_solver(const bool first_step)
+  {
+    Utils::ProfilingScope timer_section(timer, "Run solid solver");
+    Utils::PerformanceCounters::Scope counter_section(counters, "solid_solve");
+    if (parameters.fluid_sub_steps > 1)
+      {
+        solid_velocity_start = solid_solver.current_velocity;
+        solid_acceleration_start = solid_solver.current_acceleration;
+      }
+    const unsigned int n_sub_steps = parameters.solid_sub_steps;
+    std::vector<Tensor<1, dim>> tractions;
+    if (n_sub_steps > 1)
+      {
+        tractions = solid_solver.cell_property.fsi_traction;
+        // No ramp at the first step or after the solid is refined.
+        if (previous_tractions.size() != tractions.size())
+          {
+            previous_tractions = tractions;
+          }
+      }
+    for (unsigned int s = 1; s <= n_sub_steps; ++s)
+      {
+        if (n_sub_steps > 1)
+          {
+            const double w = static_cast<double>(s) / n_sub_steps;
+            for (unsigned int n = 0; n < tractions.size(); ++n)
+              {
+                solid_solver.cell_property.fsi_traction[n] =
+                  (1 - w) * previous_tractions[n] + w * tractions[n];
+              }
+          }
+        if (!owns_solid)
+          {
+            // The state is received from the solid group.
+            solid_solver.time.increment();
+            continue;
+          }
+        solid_solver.linear_iterations = 0;
+        solid_solver.run_one_step(first_step && s == 1);
+        counters["solid_solve"].iterations += solid_solver.linear_iterations;
+      }
+    previous_tractions.swap(tractions);
+  }
+
+  template <int dim>
+  void FSI<dim>::start_solid_state_exchange()
+  {
+    const std::vector<const PETScWrappers::MPI::Vector *> vectors{
+      &solid_solver.current_displacement,
+      &solid_solver.current_velocity,
+      &solid_solver.current_acceleration,
+      &solid_solver.previous_displacement,
+      &solid_solver.previous_velocity,
+      &solid_solver.previous_acceleration};
+    const types::global_dof_index n_dofs = solid_solver.dof_handler.n_dofs();
+    // The Newton iterations follow the vectors, for the adaptive time step.
+    solid_state_buffer.reinit(vectors.size() * n_dofs + 1);
+    if (owns_solid)
+      {
+        const std::vector<types::global_dof_index> &canonical =
+          solid_solver.canonical_dof_indices;
+        const auto begin = solid_solver.locally_owned_dofs.nth_index_in_set(0);
+        for (unsigned int v = 0; v < vectors.size(); ++v)
+          {
+            for (unsigned int i = 0; i < canonical.size(); ++i)
+              {
+                solid_state_buffer[v * n_dofs + canonical[i]] =
+                  (*vectors[v])(begin + i);
+              }
+          }
+        if (solid_solver.this_mpi_process == 0)
+          {
+            solid_state_buffer[vectors.size() * n_dofs] =
+              solid_solver.newton_iterations;
+          }
+      }
+    const int ierr = MPI_Iallreduce(MPI_IN_PLACE,
+                                    solid_state_buffer.begin(),
+                                    solid_state_buffer.size(),
+                                    MPI_DOUBLE,
+                                    MPI_SUM,
+                                    solid_state_communicator,
+                                    &solid_state_request);
+    AssertThrowMPI(ierr);
+  }
+
+  template <int dim>
+  void FSI<dim>::finish_solid_state_exchange()
+  {
+    Utils::ProfilingScope timer_section(timer, "Exchange solid state");
+    const int ierr = MPI_Wait(&solid_state_request, MPI_STATUS_IGNORE);
+    AssertThrowMPI(ierr);
+    if (owns_solid)
+      {
+        return;
+      }
+    const std::vector<PETScWrappers::MPI::Vector *> vectors{
+      &solid_solver.current_displacement,
+      &solid_solver.current_velocity,
+      &solid_solver.current_acceleration,
+      &solid_solver.previous_displacement,
+      &solid_solver.previous_velocity,
+      &solid_solver.previous_acceleration};
+    const types::global_dof_index n_dofs = solid_solver.dof_handler.n_dofs();
+    const std::vector<types::global_dof_index> &canonical =
+      solid_solver.canonical_dof_indices;
+    const auto begin = solid_solver.locally_owned_dofs.nth_index_in_set(0);
+    std::vector<types::global_dof_index> indices(canonical.size());
+    std::vector<double> values(canonical.size());
+    for (unsigned int i = 0; i < canonical.size(); ++i)
+      {
+        indices[i] = begin + i;
+      }
+    for (unsigned int v = 0; v < vectors.size(); ++v)
+      {
+        for (unsigned int i = 0; i < canonical.size(); ++i)
+          {
+            values[i] = solid_state_buffer[v * n_dofs + canonical[i]];
+          }
+        vectors[v]->set(indices, values);
+        vectors[v]->compress(VectorOperation::insert);
+      }
+    solid_solver.newton_iterations =
+      static_cast<unsigned int>(solid_state_buffer[vectors.size() * n_dofs]);
+  }
+
+  template <int dim>
+  void FSI<dim>::run_fluid_solver()
+  {
+    {
+      Utils::ProfilingScope timer_section(timer, "Run fluid solver");
+      Utils::PerformanceCounters::Scope counter_section(counters,
+                                                        "fluid_solve");
+      fluid_solver.linear_iterations = 0;
+      fluid_solver.run_one_step(true);
+      counters["fluid_solve"].iterations += fluid_solver.linear_iterations;
+    }
+    if (counters.active())
+      {
+        // The inner Tpp solves are timed by the fluid solver itself.
+        auto wall_times =
+          fluid_solver.timer2.get_summary_data(TimerOutput::total_wall_time);
+        if (wall_times.find("Solving Tpp") != wall_times.end())
+          {
+            counters["fluid_tpp"].wall_time +=
+              wall_times["Solving Tpp"] - previous_tpp_time;
+            previous_tpp_time = wall_times["Solving Tpp"];
+          }
+      }
+  }
+
+  template <int dim>
+  void FSI<dim>::run_fluid_sub_steps(const bool first_step,
+                                     const bool interpolate)
+  {
+    const unsigned int n_sub_steps = parameters.fluid_sub_steps;
+    for (unsigned int s = 1; s <= n_sub_steps; ++s)
+      {
+        if (interpolate && n_sub_steps > 1)
+          {
+            // The ghosted vectors take w * current + (1 - w) * start.
+            const double w = static_cast<double>(s) / n_sub_steps;
+            PETScWrappers::MPI::Vector tmp(solid_solver.current_velocity);
+            tmp.sadd(w, 1 - w, solid_velocity_start);
+            ghosted_solid_velocity = tmp;
+            tmp = solid_solver.current_acceleration;
+            tmp.sadd(w, 1 - w, solid_acceleration_start);
+            ghosted_solid_acceleration = tmp;
+          }
+        // Only the inner constraints change from step to step.
+        fluid_solver.reset_constraints(first_step && s == 1);
+        find_fluid_bc();
+        run_fluid_solver();
+      }
+  }
+
+  template <int dim>
+  void FSI<dim>::run_coupling_iterations(const bool first_step)
+  {
+    // The state of both solvers at the start of the step. The outputs and
+    // the pvd records of the rejected iterations are overwritten by the
+    // next ones.
+    std::vector<PETScWrappers::MPI::Vector *> solid_state{
+      &solid_solver.current_displacement,
+      &solid_solver.current_velocity,
+      &solid_solver.current_acceleration,
+      &solid_solver.previous_displacement,
+      &solid_solver.previous_velocity,
+      &solid_solver.previous_acceleration};
+    std::vector<PETScWrappers::MPI::Vector> solid_start;
+    for (auto v : solid_state)
+      {
+        solid_start.push_back(*v);
+      }
+    const Utils::Time solid_time(solid_solver.time);
+    const Utils::Time fluid_time(fluid_solver.time);
+    const PETScWrappers::MPI::BlockVector fluid_solution(
+      fluid_solver.present_solution);
+    const PETScWrappers::MPI::BlockVector fluid_increment(
+      fluid_solver.solution_increment);
+    const std::vector<PETScWrappers::MPI::BlockVector> fluid_history(
+      fluid_solver.solution_history);
+    const std::vector<double> fluid_history_times(
+      fluid_solver.solution_history_times);
+    const unsigned int n_solid_outputs = solid_solver.times_and_names.size();
+    const unsigned int n_fluid_outputs = fluid_solver.times_and_names.size();
+    const std::vector<Tensor<1, dim>> tractions_start(previous_tractions);
+
+    std::vector<Tensor<1, dim>> &tractions =
+      solid_solver.cell_property.fsi_traction;
+    Vector<double> x(tractions.size() * dim), output(x.size());
+    for (unsigned int n = 0; n < tractions.size(); ++n)
+      {
+        for (unsigned int d = 0; d < dim; ++d)
+          {
+            x[n * dim + d] = tractions[n][d];
+          }
+      }
+    Utils::InterfaceAccelerator accelerator(parameters.coupling_acceleration,
+                                            parameters.coupling_relaxation);
+    // Only the samples of the last iteration are written.
+    fluid_solver.probes.hold();
+    solid_solver.probes.hold();
+    for (unsigned int k = 1;; ++k)
+      {
+        if (k > 1)
+          {
+            fluid_solver.probes.discard();
+            solid_solver.probes.discard();
+            for (unsigned int i = 0; i < solid_state.size(); ++i)
+              {
+                *solid_state[i] = solid_start[i];
+              }
+            solid_solver.time.restore(solid_time);
+            fluid_solver.time.restore(fluid_time);
+            fluid_solver.present_solution = fluid_solution;
+            fluid_solver.solution_increment = fluid_increment;
+            fluid_solver.solution_history = fluid_history;
+            fluid_solver.solution_history_times = fluid_history_times;
+            solid_solver.times_and_names.resize(n_solid_outputs);
+            fluid_solver.times_and_names.resize(n_fluid_outputs);
+            previous_tractions = tractions_start;
+            for (unsigned int n = 0; n < tractions.size(); ++n)
+              {
+                for (unsigned int d = 0; d < dim; ++d)
+                  {
+                    tractions[n][d] = x[n * dim + d];
+                  }
+              }
+          }
+        // The solid solver works in the reference configuration.
+        move_solid_mesh(false);
+        run_solid_solver(first_step);
+        if (solid_group)
+          {
+            start_solid_state_exchange();
+            finish_solid_state_exchange();
+          }
+        update_solid_box();
+        update_indicator();
+        run_fluid_sub_steps(first_step, true);
+        find_solid_bc();
+
+        // The tractions are the same on every process.
+        for (unsigned int n = 0; n < tractions.size(); ++n)
+          {
+            for (unsigned int d = 0; d < dim; ++d)
+              {
+                output[n * dim + d] = tractions[n][d];
+              }
+          }
+        Vector<double> residual(output);
+        residual -= x;
+        const double residual_norm = residual.l2_norm();
+        const double output_norm = output.l2_norm();
+        pcout << "Coupling iteration " << k << ", traction residual = "
+              << std::scientific << residual_norm << ", output = "
+              << output_norm << std::endl;
+        if (residual_norm <= parameters.coupling_tolerance * output_norm ||
+            residual_norm < 1e-14 || k == parameters.coupling_iterations)
+          {
+            counters["coupling"].iterations += k;
+            break;
+          }
+        accelerator.next(x, output);
+      }
+    fluid_solver.probes.commit();
+    solid_solver.probes.commit();
+  }
+
+  template <int dim>
+  void FSI<dim>::set_time_step(const double delta_t)
+  {
+    time.set_delta_t(delta_t);
+    fluid_solver.time.set_delta_t(delta_t / parameters.fluid_sub_steps);
+    solid_solver.time.set_delta_t(delta_t / parameters.solid_sub_steps);
+  }
+
+  template <int dim>
+  void FSI<dim>::adapt_time_step()
+  {
+    const Utils::TimeStepController controller(
+      parameters.min_time_step,
+      parameters.max_time_step,
+      parameters.target_cfl,
+      parameters.target_newton_iterations);
+    const double delta_t = std::min(
+      controller.propose(
+        time, fluid_solver.cfl_number(), fluid_solver.newton_iterations),
+      controller.propose(time, 0, solid_solver.newton_iterations));
+    set_time_step(delta_t);
   }
 
   template <int dim>
@@ -660,6 +2221,11 @@ namespace MPI
     pcout << "Running with PETSc on "
           << Utilities::MPI::n_mpi_processes(mpi_communicator)
           << " MPI rank(s)..." << std::endl;
+    // The particles of the hypoelastic solid cannot go back to the start of
+    // the step.
+    AssertThrow(
+      parameters.coupling_iterations <= 1 || solid_solver.state_in_vectors(),
+      ExcMessage("Coupling iterations need an implicit solid solver!"));
 
     solid_solver.triangulation.refine_global(parameters.global_refinements[1]);
     // Try load from previous computation.
@@ -681,15 +2247,17 @@ namespace MPI
       }
     else
       {
-        while (time.get_timestep() < solid_solver.time.get_timestep())
-          {
-            time.increment();
-          }
+        time.restore(solid_solver.time);
       }
+    // The solvers advance in sub-steps of the coupling time step.
+    set_time_step(success_load ? solid_solver.time.get_delta_t() *
+                                   parameters.solid_sub_steps
+                               : time.get_delta_t());
 
     collect_solid_boundaries();
     setup_cell_hints();
     update_vertices_mask();
+    align_solid_partition();
 
     pcout << "Number of fluid active cells and dofs: ["
           << fluid_solver.triangulation.n_active_cells() << ", "
@@ -698,6 +2266,9 @@ namespace MPI
           << solid_solver.triangulation.n_active_cells() << ", "
           << solid_solver.dof_handler.n_dofs() << "]" << std::endl;
     bool first_step = !success_load;
+    // The mass matrix is not part of the checkpoint, it is assembled once
+    // after a restart.
+    bool assemble_mass = success_load;
     if (parameters.refinement_interval < parameters.end_time)
       {
         refine_mesh(parameters.global_refinements[0],
@@ -706,45 +2277,130 @@ namespace MPI
                     parameters.global_refinements[0] + 3);
         setup_cell_hints();
       }
+    // The overlapped exchange needs the solid box and indicator of a
+    // previous step, so the first step is always sequential.
+    bool overlapped = false;
+    // The time steps since the fluid mesh was last partitioned.
+    unsigned int steps_since_partition = 0;
     while (time.end() - time.current() > 1e-12)
       {
-        find_solid_bc();
-        if (success_load)
+        if (parameters.adaptive_time_step && !first_step)
           {
-            solid_solver.assemble_system(true);
+            adapt_time_step();
           }
-        {
-          TimerOutput::Scope timer_section(timer, "Run solid solver");
-          solid_solver.run_one_step(first_step);
-        }
-        update_solid_box();
-        update_indicator();
-        fluid_solver.make_constraints();
-        if (!first_step)
+        if (overlapped && solid_group)
           {
-            fluid_solver.nonzero_constraints.clear();
-            fluid_solver.nonzero_constraints.copy_from(
-              fluid_solver.zero_constraints);
+            // Both solvers use the state of the previous step. The other
+            // processes skip the solid solve and assemble the fluid while
+            // the group solves the solid, the new solid state is in flight
+            // during the fluid solve.
+            start_solid_bc_exchange();
+            update_indicator();
+            fluid_solver.reset_constraints(false);
+            find_fluid_bc();
+            finish_solid_bc_exchange();
+            move_solid_mesh(false);
+            if (assemble_mass)
+              {
+                solid_solver.assemble_system(true);
+                assemble_mass = false;
+              }
+            run_solid_solver(first_step);
+            start_solid_state_exchange();
+            run_fluid_solver();
+            finish_solid_state_exchange();
+            update_solid_box();
+          }
+        else if (overlapped)
+          {
+            // Both solvers use the state of the previous step: the traction
+            // exchange is in flight while the fluid is solved.
+            start_solid_bc_exchange();
+            update_indicator();
+            run_fluid_sub_steps(false, false);
+            finish_solid_bc_exchange();
+            move_solid_mesh(false);
+            if (assemble_mass)
+              {
+                solid_solver.assemble_system(true);
+                assemble_mass = false;
+              }
+            run_solid_solver(first_step);
+            update_solid_box();
+          }
+        else if (parameters.coupling_iterations > 1)
+          {
+            find_solid_bc();
+            if (assemble_mass)
+              {
+                move_solid_mesh(false);
+                solid_solver.assemble_system(true);
+                assemble_mass = false;
+              }
+            run_coupling_iterations(first_step);
+          }
+        else
+          {
+            find_solid_bc();
+            // The solid solver works in the reference configuration.
+            move_solid_mesh(false);
+            if (assemble_mass)
+              {
+                solid_solver.assemble_system(true);
+                assemble_mass = false;
+              }
+            run_solid_solver(first_step);
+            if (solid_group)
+              {
+                start_solid_state_exchange();
+                finish_solid_state_exchange();
+              }
+            update_solid_box();
+            update_indicator();
+            run_fluid_sub_steps(first_step, true);
+            overlapped = parameters.overlap_traction_exchange;
           }
-        find_fluid_bc();
-        {
-          TimerOutput::Scope timer_section(timer, "Run fluid solver");
-          fluid_solver.run_one_step(true);
-        }
         first_step = false;
         time.increment();
+        ++steps_since_partition;
         if (time.time_to_refine())
           {
-            refine_mesh(parameters.global_refinements[0],
-                        parameters.global_refinements[0] + 3);
-            setup_cell_hints();
+            if (refine_mesh(parameters.global_refinements[0],
+                            parameters.global_refinements[0] + 3))
+              {
+                setup_cell_hints();
+                steps_since_partition = 0;
+              }
+          }
+        else if (parameters.load_imbalance_tolerance > 0 &&
+                 steps_since_partition >= parameters.repartition_interval)
+          {
+            // The cost that the cell weights balance, rather than the wall
+            // time of the fluid solve, which every process spends waiting
+            // for the slowest one in the collective operations.
+            const auto cost = Utilities::MPI::min_max_avg(
+              fluid_solver.local_cost(), mpi_communicator);
+            if (cost.max > parameters.load_imbalance_tolerance * cost.avg)
+              {
+                pcout << "Fluid load imbalance " << cost.max / cost.avg
+                      << ", repartitioning..." << std::endl;
+                redistribute_fluid(false);
+                setup_cell_hints();
+                steps_since_partition = 0;
+              }
           }
         if (time.time_to_save())
           {
-            solid_solver.save_checkpoint(time.get_timestep());
+            // The copies of the solid are the same as the state of the group.
+            if (owns_solid)
+              {
+                solid_solver.save_checkpoint(time.get_timestep());
+              }
             fluid_solver.save_checkpoint(time.get_timestep());
           }
+        counters.write(time.get_timestep(), time.current());
       }
+    move_solid_mesh(false);
   }
 
   template class FSI<2>;
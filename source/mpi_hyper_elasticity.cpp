@@ -96,9 +96,11 @@ namespace Solid
 
       // The prediction of the current displacement,
       // which is what we want to solve.
-      predicted_displacement = previous_displacement;
-      predicted_displacement.add(
-        dt, previous_velocity, (0.5 - beta) * dt * dt, previous_acceleration);
+      const Utils::Newmark newmark(dt, gamma, beta);
+      newmark.predict(previous_displacement,
+                      previous_velocity,
+                      previous_acceleration,
+                      predicted_displacement);
 
       pcout << std::string(100, '_') << std::endl;
 
@@ -109,14 +111,12 @@ namespace Solid
                       ExcMessage("Too many Newton iterations!"));
 
           // Compute the displacement, velocity and acceleration
-          current_acceleration = current_displacement;
-          current_acceleration -= predicted_displacement;
-          current_acceleration /= (beta * dt * dt);
-          current_velocity = previous_velocity;
-          current_velocity.add(dt * (1 - gamma),
-                               previous_acceleration,
-                               dt * gamma,
-                               current_acceleration);
+          newmark.update(predicted_displacement,
+                         previous_velocity,
+                         previous_acceleration,
+                         current_displacement,
+                         current_acceleration,
+                         current_velocity);
 
           // Assemble the system, and modify the RHS to account for
           // the time-discretization.
@@ -161,19 +161,15 @@ namespace Solid
           newton_iteration++;
         }
 
-      // Once converged, update current acceleration and velocity again.
-      current_acceleration = current_displacement;
-      current_acceleration -= predicted_displacement;
-      current_acceleration /= (beta * dt * dt);
-      current_velocity = previous_velocity;
-      current_velocity.add(dt * (1 - gamma),
-                           previous_acceleration,
-                           dt * gamma,
-                           current_acceleration);
-      // Update the previous values
-      previous_acceleration = current_acceleration;
-      previous_velocity = current_velocity;
-      previous_displacement = current_displacement;
+      // Once converged, update current acceleration and velocity again,
+      // and the previous values.
+      newmark.advance_from_displacement(predicted_displacement,
+                                        current_displacement,
+                                        current_acceleration,
+                                        current_velocity,
+                                        previous_displacement,
+                                        previous_velocity,
+                                        previous_acceleration);
 
       pcout << std::string(100, '_') << std::endl
             << "Relative errors:" << std::endl
@@ -191,6 +187,17 @@ namespace Solid
     {
       SolidSolver<dim>::initialize_system();
       setup_qph();
+      print_memory_report();
+    }
+
+    template <int dim>
+    void HyperElasticity<dim>::add_memory(Utils::MemoryReport &report) const
+    {
+      SolidSolver<dim>::add_memory(report);
+      report.add("Solid quadrature point history",
+                 Utils::cell_data_memory<Internal::PointHistory<dim>>(
+                   triangulation.n_locally_owned_active_cells(),
+                   volume_quad_formula.size()));
     }
 
     template <int dim>
@@ -221,7 +228,7 @@ namespace Solid
     void HyperElasticity<dim>::update_qph(
       const PETScWrappers::MPI::Vector &evaluation_point)
     {
-      timer.enter_subsection("Update QPH data");
+      Utils::ProfilingScope timer_section(timer, "Update QPH data");
 
       // displacement gradient at quad points
       const unsigned int n_q_points = volume_quad_formula.size();
@@ -251,7 +258,6 @@ namespace Solid
               lqph[q]->update(parameters, grad_u[q]);
             }
         }
-      timer.leave_subsection();
     }
 
     template <int dim>
@@ -296,7 +302,7 @@ namespace Solid
     template <int dim>
     void HyperElasticity<dim>::assemble_system(bool initial_step)
     {
-      timer.enter_subsection("Assemble tangent matrix");
+      Utils::ProfilingScope timer_section(timer, "Assemble tangent matrix");
 
       const unsigned int n_q_points = volume_quad_formula.size();
       const unsigned int n_f_q_points = face_quad_formula.size();
@@ -421,7 +427,7 @@ namespace Solid
           // If this is a stand-alone solid simulation, the Neumann boundary
           // type should be either Traction or Pressure; it this is a FSI
           // simulation, the Neumann boundary type must be FSI.
-
+          auto p = cell_property.get_data(cell);
           for (unsigned int face = 0; face < GeometryInfo<dim>::faces_per_cell;
                ++face)
             {
@@ -472,6 +478,10 @@ namespace Solid
                       traction = fe_face_values.normal_vector(q);
                       traction *= prescribed_value[0];
                     }
+                  else if (parameters.simulation_type == "FSI")
+                    {
+                      traction = p[face * n_f_q_points + q]->fsi_traction;
+                    }
                   for (unsigned int j = 0; j < dofs_per_cell; ++j)
                     {
                       const unsigned int component_j =
@@ -511,7 +521,6 @@ namespace Solid
           system_matrix.compress(VectorOperation::add);
         }
       system_rhs.compress(VectorOperation::add);
-      timer.leave_subsection();
     }
 
     template class HyperElasticity<2>;
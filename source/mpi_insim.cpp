@@ -19,34 +19,68 @@ namespace Fluid
       const std::vector<IndexSet> &owned_partitioning,
       const PETScWrappers::MPI::BlockSparseMatrix &system,
       const PETScWrappers::MPI::BlockSparseMatrix &mass,
-      PETScWrappers::MPI::BlockSparseMatrix &schur)
+      PETScWrappers::MPI::BlockSparseMatrix &schur,
+      const std::string &A_solver,
+      PETScWrappers::SparseDirectMUMPS *shared_A_inverse,
+      const MatrixFreeVelocitySolver<dim> *matrix_free_A,
+      const bool pipelined)
       : timer2(timer2),
         gamma(gamma),
         viscosity(viscosity),
         rho(rho),
         dt(dt),
+        pipelined(pipelined),
         system_matrix(&system),
         mass_matrix(&mass),
         mass_schur(&schur),
-        A_inverse(dummy_sc, system_matrix->get_mpi_communicator())
+        A_inverse(dummy_sc, system_matrix->get_mpi_communicator()),
+        A_solver(A_solver),
+        A_direct(shared_A_inverse ? shared_A_inverse : &A_inverse),
+        A_matrix_free(matrix_free_A)
     {
-      TimerOutput::Scope timer_section(timer2, "CG for Sm");
-      // The sparsity pattern of mass_schur is already set,
-      // we calculate its value in the following.
-      PETScWrappers::MPI::BlockVector tmp1, tmp2;
-      tmp1.reinit(owned_partitioning, mass_matrix->get_mpi_communicator());
-      tmp2.reinit(owned_partitioning, mass_matrix->get_mpi_communicator());
-      tmp1 = 1;
-      tmp2 = 0;
-      // Jacobi preconditioner of matrix A is by definition inverse diag(A),
-      // this is exactly what we want to compute.
-      // Note that the mass matrix and mass schur do not include the density.
-      PETScWrappers::PreconditionJacobi jacobi(mass_matrix->block(0, 0));
-      jacobi.vmult(tmp2.block(0), tmp1.block(0));
-      // The sparsity pattern has already been set correctly, so explicitly
-      // tell mmult not to rebuild the sparsity pattern.
-      system_matrix->block(1, 0).mmult(
-        mass_schur->block(1, 1), system_matrix->block(0, 1), tmp2.block(0));
+      {
+        Utils::ProfilingScope timer_section(timer2, "CG for Sm");
+        // The sparsity pattern of mass_schur is already set,
+        // we calculate its value in the following.
+        PETScWrappers::MPI::BlockVector tmp1, tmp2;
+        tmp1.reinit(owned_partitioning, mass_matrix->get_mpi_communicator());
+        tmp2.reinit(owned_partitioning, mass_matrix->get_mpi_communicator());
+        tmp1 = 1;
+        tmp2 = 0;
+        // Jacobi preconditioner of matrix A is by definition inverse diag(A),
+        // this is exactly what we want to compute.
+        // Note that the mass matrix and mass schur do not include the density.
+        PETScWrappers::PreconditionJacobi jacobi(mass_matrix->block(0, 0));
+        jacobi.vmult(tmp2.block(0), tmp1.block(0));
+        // The sparsity pattern has already been set correctly, so explicitly
+        // tell mmult not to rebuild the sparsity pattern.
+        system_matrix->block(1, 0).mmult(
+          mass_schur->block(1, 1), system_matrix->block(0, 1), tmp2.block(0));
+        // The rows of the constrained pressure dofs, e.g. on the hanging
+        // nodes after refine_mesh, are zero in B and thus in Sm.
+        Utils::fill_zero_diagonal(mass_schur->block(1, 1));
+      }
+
+      {
+        Utils::ProfilingScope timer_section(timer2, "Preconditioners for S");
+        // The pressure mass matrix is spectrally equivalent to its diagonal,
+        // and Sm is a discrete pressure Laplacian, so the iterations of both
+        // inner solves do not grow with the mesh size.
+        Mp_preconditioner.initialize(mass_matrix->block(1, 1));
+        PETScWrappers::PreconditionBoomerAMG::AdditionalData data;
+        data.symmetric_operator = true;
+        Sm_preconditioner.initialize(mass_schur->block(1, 1), data);
+      }
+
+      if (A_solver == "AMG" || A_solver == "AMG-GMRES")
+        {
+          Utils::ProfilingScope timer_section(timer2, "AMG setup for A");
+          // The convection term makes the velocity block unsymmetric.
+          PETScWrappers::PreconditionBoomerAMG::AdditionalData data;
+          data.symmetric_operator = false;
+          data.strong_threshold = (dim == 2 ? 0.25 : 0.5);
+          A_amg.initialize(system_matrix->block(0, 0), data);
+        }
     }
 
     /**
@@ -67,45 +101,54 @@ namespace Fluid
       // is spent on different solvers.
       // The next two blocks computes \f$u_1 = \tilde{S}^{-1} v_1\f$.
       {
-        TimerOutput::Scope timer_section(timer2, "CG for Mp");
+        Utils::ProfilingScope timer_section(timer2, "CG for Mp");
 
         // CG solver used for \f$M_p^{-1}\f$ and \f$S_m^{-1}\f$.
         SolverControl solver_control(
           src.block(1).size(), std::max(1e-10, 1e-6 * src.block(1).l2_norm()));
-        PETScWrappers::SolverCG cg_mp(solver_control,
-                                      mass_schur->get_mpi_communicator());
-
         // \f$-(\mu + \gamma\rho)M_p^{-1}v_1\f$
-        PETScWrappers::PreconditionNone Mp_preconditioner;
-        Mp_preconditioner.initialize(mass_matrix->block(1, 1));
-        cg_mp.solve(
-          mass_matrix->block(1, 1), tmp, src.block(1), Mp_preconditioner);
+        if (pipelined)
+          {
+            SolverPipeCG cg_mp(solver_control,
+                               mass_schur->get_mpi_communicator());
+            cg_mp.solve(
+              mass_matrix->block(1, 1), tmp, src.block(1), Mp_preconditioner);
+          }
+        else
+          {
+            PETScWrappers::SolverCG cg_mp(solver_control,
+                                          mass_schur->get_mpi_communicator());
+            cg_mp.solve(
+              mass_matrix->block(1, 1), tmp, src.block(1), Mp_preconditioner);
+          }
         tmp *= -(viscosity + gamma * rho);
       }
 
       {
-        TimerOutput::Scope timer_section(timer2, "CG for Sm");
+        Utils::ProfilingScope timer_section(timer2, "CG for Sm");
         SolverControl solver_control(
           src.block(1).size(), std::max(1e-10, 1e-3 * src.block(1).l2_norm()));
-        // FIXME: There is a mysterious bug here. After refine_mesh is called,
-        // the initialization of Sm_preconditioner will complain about zero
-        // entries on the diagonal which causes division by 0 since
-        // PreconditionBlockJacobi uses ILU(0) underneath. This is similar to
-        // the serial code where SparseILU is used. However, 1. if we do not use
-        // a preconditioner here, the code runs fine, suggesting that mass_schur
-        // is correct; 2. if we do not call refine_mesh, the code also runs
-        // fine. So the question is, why would refine_mesh generate diagonal
-        // zeros?
-        //
-        // \f$-\frac{1}{dt}S_m^{-1}v_1\f$
-        PETScWrappers::PreconditionNone Sm_preconditioner;
-        Sm_preconditioner.initialize(mass_schur->block(1, 1));
-        PETScWrappers::SolverCG cg_sm(solver_control,
-                                      mass_schur->get_mpi_communicator());
-        cg_sm.solve(mass_schur->block(1, 1),
-                    dst.block(1),
-                    src.block(1),
-                    Sm_preconditioner);
+        // \f$-\frac{1}{dt}S_m^{-1}v_1\f$, from a zero initial guess so that
+        // the preconditioner is the same linear operator in every iteration.
+        dst.block(1) = 0;
+        if (pipelined)
+          {
+            SolverPipeCG cg_sm(solver_control,
+                               mass_schur->get_mpi_communicator());
+            cg_sm.solve(mass_schur->block(1, 1),
+                        dst.block(1),
+                        src.block(1),
+                        Sm_preconditioner);
+          }
+        else
+          {
+            PETScWrappers::SolverCG cg_sm(solver_control,
+                                          mass_schur->get_mpi_communicator());
+            cg_sm.solve(mass_schur->block(1, 1),
+                        dst.block(1),
+                        src.block(1),
+                        Sm_preconditioner);
+          }
         dst.block(1) *= -rho / dt;
         // Adding up these two, we get \f$\tilde{S}^{-1}v_1\f$.
         dst.block(1) += tmp;
@@ -120,18 +163,53 @@ namespace Fluid
       }
 
       // Finally, compute the product of \f$\tilde{A}^{-1}\f$ and utmp with
-      // the direct solver.
-      {
-        TimerOutput::Scope timer_section(timer2, "MUMPS for A_inv");
-        A_inverse.solve(system_matrix->block(0, 0), dst.block(0), utmp);
-      }
+      // the direct solver, or approximately with AMG.
+      if (A_solver == "MUMPS")
+        {
+          Utils::ProfilingScope timer_section(timer2, "MUMPS for A_inv");
+          A_direct->solve(system_matrix->block(0, 0), dst.block(0), utmp);
+        }
+      else if (A_solver == "MatrixFree")
+        {
+          Utils::ProfilingScope timer_section(timer2, "Matrix-free A_inv");
+          Assert(A_matrix_free, ExcInternalError());
+          A_matrix_free->solve(dst.block(0), utmp);
+        }
+      else if (A_solver == "AMG")
+        {
+          Utils::ProfilingScope timer_section(timer2, "AMG for A_inv");
+          A_amg.vmult(dst.block(0), utmp);
+        }
+      else
+        {
+          Utils::ProfilingScope timer_section(timer2, "GMRES for A_inv");
+          SolverControl solver_control(
+            utmp.size(), std::max(1e-10, 1e-2 * utmp.l2_norm()));
+          dst.block(0) = 0;
+          if (pipelined)
+            {
+              SolverPGMRES gmres_a(solver_control,
+                                   system_matrix->get_mpi_communicator());
+              gmres_a.solve(
+                system_matrix->block(0, 0), dst.block(0), utmp, A_amg);
+            }
+          else
+            {
+              PETScWrappers::SolverGMRES gmres_a(
+                solver_control, system_matrix->get_mpi_communicator());
+              gmres_a.solve(
+                system_matrix->block(0, 0), dst.block(0), utmp, A_amg);
+            }
+        }
     }
 
     template <int dim>
     InsIM<dim>::InsIM(parallel::distributed::Triangulation<dim> &tria,
                       const Parameters::AllParameters &parameters,
                       std::shared_ptr<Function<dim>> bc)
-      : FluidSolver<dim>(tria, parameters, bc)
+      : FluidSolver<dim>(tria, parameters, bc),
+        velocity_solver(
+          SolverPolicy::velocity_solver(parameters.fluid_velocity_solver))
     {
       Assert(
         parameters.fluid_velocity_degree - parameters.fluid_pressure_degree ==
@@ -140,11 +218,50 @@ namespace Fluid
           "Velocity finite element should be one order higher than pressure!"));
     }
 
+    template <int dim>
+    typename Triangulation<dim>::MeshSmoothing
+    InsIM<dim>::triangulation_smoothing(
+      const Parameters::AllParameters &parameters)
+    {
+      return parameters.fluid_velocity_solver == "MatrixFree"
+               ? Triangulation<dim>::limit_level_difference_at_vertices
+               : Triangulation<dim>::none;
+    }
+
+    template <int dim>
+    typename parallel::distributed::Triangulation<dim>::Settings
+    InsIM<dim>::triangulation_settings(
+      const Parameters::AllParameters &parameters)
+    {
+      using DistributedTriangulation =
+        parallel::distributed::Triangulation<dim>;
+      return parameters.fluid_velocity_solver == "MatrixFree"
+               ? DistributedTriangulation::construct_multigrid_hierarchy
+               : DistributedTriangulation::default_setting;
+    }
+
     template <int dim>
     void InsIM<dim>::initialize_system()
     {
       FluidSolver<dim>::initialize_system();
       preconditioner.reset();
+      // The factorization refers to the old matrix and sparsity pattern.
+      direct_solver.reset();
+      if (velocity_solver.select(dof_handler.n_dofs(),
+                                 dim,
+                                 Utilities::MPI::n_mpi_processes(
+                                   mpi_communicator)))
+        {
+          pcout << " VELOCITY_SOLVER = " << velocity_solver.get() << std::endl;
+        }
+      if (velocity_solver.get() == "MatrixFree")
+        {
+          if (!matrix_free_solver)
+            matrix_free_solver =
+              std::make_shared<MatrixFreeVelocitySolver<dim>>(triangulation,
+                                                              parameters);
+          matrix_free_solver->setup(dof_handler);
+        }
       newton_update.reinit(owned_partitioning, mpi_communicator);
       evaluation_point.reinit(
         owned_partitioning, relevant_partitioning, mpi_communicator);
@@ -153,7 +270,7 @@ namespace Fluid
     template <int dim>
     void InsIM<dim>::assemble(const bool use_nonzero_constraints)
     {
-      TimerOutput::Scope timer_section(timer, "Assemble system");
+      Utils::ProfilingScope timer_section(timer, "Assemble system");
 
       const double viscosity = parameters.viscosity;
       const double gamma = parameters.grad_div;
@@ -165,15 +282,11 @@ namespace Fluid
       mass_matrix = 0;
       system_rhs = 0;
 
-      FEValues<dim> fe_values(fe,
-                              volume_quad_formula,
-                              update_values | update_quadrature_points |
-                                update_JxW_values | update_gradients);
-      FEFaceValues<dim> fe_face_values(fe,
-                                       face_quad_formula,
-                                       update_values | update_normal_vectors |
-                                         update_quadrature_points |
-                                         update_JxW_values);
+      const UpdateFlags flags = update_values | update_quadrature_points |
+                                update_JxW_values | update_gradients;
+      const UpdateFlags face_flags = update_values | update_normal_vectors |
+                                     update_quadrature_points |
+                                     update_JxW_values;
 
       const unsigned int dofs_per_cell = fe.dofs_per_cell;
       const unsigned int u_dofs = fe.base_element(0).dofs_per_cell;
@@ -187,194 +300,261 @@ namespace Fluid
       const FEValuesExtractors::Vector velocities(0);
       const FEValuesExtractors::Scalar pressure(dim);
 
-      FullMatrix<double> local_matrix(dofs_per_cell, dofs_per_cell);
-      FullMatrix<double> local_mass_matrix(dofs_per_cell, dofs_per_cell);
-      Vector<double> local_rhs(dofs_per_cell);
-
-      std::vector<types::global_dof_index> local_dof_indices(dofs_per_cell);
-
-      std::vector<Tensor<1, dim>> current_velocity_values(n_q_points);
-      std::vector<Tensor<2, dim>> current_velocity_gradients(n_q_points);
-      std::vector<double> current_pressure_values(n_q_points);
-      std::vector<Tensor<1, dim>> present_velocity_values(n_q_points);
-
-      std::vector<double> div_phi_u(dofs_per_cell);
-      std::vector<Tensor<1, dim>> phi_u(dofs_per_cell);
-      std::vector<Tensor<2, dim>> grad_phi_u(dofs_per_cell);
-      std::vector<double> phi_p(dofs_per_cell);
-
-      for (auto cell = dof_handler.begin_active(); cell != dof_handler.end();
-           ++cell)
-        {
-          if (cell->is_locally_owned())
+      // The local matrices are computed on all threads, the copier adds them
+      // to the global matrices one at a time.
+      auto assemble_cell =
+        [&](const typename DoFHandler<dim>::active_cell_iterator &cell,
+            Utils::AssemblyScratch<dim> &scratch,
+            Utils::AssemblyCopy &copy) {
+          FEValues<dim> &fe_values = scratch.fe_values;
+          FEFaceValues<dim> &fe_face_values = scratch.fe_face_values;
+          FullMatrix<double> &local_matrix = copy.cell_matrix;
+          FullMatrix<double> &local_mass_matrix = copy.cell_matrix2;
+          Vector<double> &local_rhs = copy.cell_rhs;
+          std::vector<types::global_dof_index> &local_dof_indices =
+            copy.local_dof_indices;
+
+          std::vector<Tensor<1, dim>> &current_velocity_values =
+            scratch.current_velocity_values;
+          std::vector<Tensor<2, dim>> &current_velocity_gradients =
+            scratch.current_velocity_gradients;
+          std::vector<double> &current_pressure_values =
+            scratch.current_pressure_values;
+          std::vector<Tensor<1, dim>> &present_velocity_values =
+            scratch.present_velocity_values;
+
+          std::vector<double> &div_phi_u = scratch.div_phi_u;
+          std::vector<Tensor<1, dim>> &phi_u = scratch.phi_u;
+          std::vector<Tensor<2, dim>> &grad_phi_u = scratch.grad_phi_u;
+          std::vector<double> &phi_p = scratch.phi_p;
+
+          const unsigned int cell_index = cell->active_cell_index();
+          const SymmetricTensor<2, dim> fsi_stress =
+            cell_property.get_fsi_stress(cell_index);
+          const Tensor<1, dim> fsi_acceleration =
+            cell_property.get_fsi_acceleration(cell_index);
+
+          fe_values.reinit(cell);
+
+          local_matrix = 0;
+          local_mass_matrix = 0;
+          local_rhs = 0;
+
+          fe_values[velocities].get_function_values(
+            assembly_evaluation_point, current_velocity_values);
+
+          fe_values[velocities].get_function_gradients(
+            assembly_evaluation_point, current_velocity_gradients);
+
+          fe_values[pressure].get_function_values(assembly_evaluation_point,
+                                                  current_pressure_values);
+
+          fe_values[velocities].get_function_values(
+            assembly_present_solution, present_velocity_values);
+
+          // Assemble the system matrix and mass matrix simultaneouly.
+          // The mass matrix only uses the (0, 0) and (1, 1) blocks.
+          //
+          for (unsigned int q = 0; q < n_q_points; ++q)
             {
-              auto p = cell_property.get_data(cell);
-
-              fe_values.reinit(cell);
-
-              local_matrix = 0;
-              local_mass_matrix = 0;
-              local_rhs = 0;
-
-              fe_values[velocities].get_function_values(
-                evaluation_point, current_velocity_values);
-
-              fe_values[velocities].get_function_gradients(
-                evaluation_point, current_velocity_gradients);
-
-              fe_values[pressure].get_function_values(evaluation_point,
-                                                      current_pressure_values);
-
-              fe_values[velocities].get_function_values(
-                present_solution, present_velocity_values);
+              const int ind = cell_property.get_indicator(cell_index);
+              const double rho = parameters.fluid_rho;
+              for (unsigned int k = 0; k < dofs_per_cell; ++k)
+                {
+                  div_phi_u[k] = fe_values[velocities].divergence(k, q);
+                  grad_phi_u[k] = fe_values[velocities].gradient(k, q);
+                  phi_u[k] = fe_values[velocities].value(k, q);
+                  phi_p[k] = fe_values[pressure].value(k, q);
+                }
 
-              // Assemble the system matrix and mass matrix simultaneouly.
-              // The mass matrix only uses the (0, 0) and (1, 1) blocks.
-              //
-              for (unsigned int q = 0; q < n_q_points; ++q)
+              for (unsigned int i = 0; i < dofs_per_cell; ++i)
                 {
-                  const int ind = p[0]->indicator;
-                  const double rho = parameters.fluid_rho;
-                  for (unsigned int k = 0; k < dofs_per_cell; ++k)
+                  for (unsigned int j = 0; j < dofs_per_cell; ++j)
                     {
-                      div_phi_u[k] = fe_values[velocities].divergence(k, q);
-                      grad_phi_u[k] = fe_values[velocities].gradient(k, q);
-                      phi_u[k] = fe_values[velocities].value(k, q);
-                      phi_p[k] = fe_values[pressure].value(k, q);
+                      // Let the linearized diffusion, continuity and
+                      // Grad-Div
+                      // term be written as
+                      // the bilinear operator: \f$A = a((\delta{u},
+                      // \delta{p}), (\delta{v}, \delta{q}))\f$,
+                      // the linearized convection term be: \f$C =
+                      // c(u;\delta{u}, \delta{v})\f$,
+                      // and the linearized inertial term be:
+                      // \f$M = m(\delta{u}, \delta{v})$, then LHS is: $(A +
+                      // C) + M/{\Delta{t}}\f$
+                      local_matrix(i, j) +=
+                        (viscosity *
+                           scalar_product(grad_phi_u[j], grad_phi_u[i]) +
+                         current_velocity_gradients[q] * phi_u[j] *
+                           phi_u[i] * rho +
+                         grad_phi_u[j] * current_velocity_values[q] *
+                           phi_u[i] * rho -
+                         div_phi_u[i] * phi_p[j] - phi_p[i] * div_phi_u[j] +
+                         gamma * div_phi_u[j] * div_phi_u[i] * rho +
+                         phi_u[i] * phi_u[j] / time.get_delta_t() * rho) *
+                        fe_values.JxW(q);
+                      local_mass_matrix(i, j) +=
+                        (phi_u[i] * phi_u[j] + phi_p[i] * phi_p[j]) *
+                        fe_values.JxW(q);
                     }
 
-                  for (unsigned int i = 0; i < dofs_per_cell; ++i)
+                  // RHS is \f$-(A_{current} + C_{current}) -
+                  // M_{present-current}/\Delta{t}\f$.
+                  double current_velocity_divergence =
+                    trace(current_velocity_gradients[q]);
+                  local_rhs(i) +=
+                    ((-viscosity *
+                        scalar_product(current_velocity_gradients[q],
+                                       grad_phi_u[i]) -
+                      current_velocity_gradients[q] *
+                        current_velocity_values[q] * phi_u[i] * rho +
+                      current_pressure_values[q] * div_phi_u[i] +
+                      current_velocity_divergence * phi_p[i] -
+                      gamma * current_velocity_divergence * div_phi_u[i] *
+                        rho) -
+                     (current_velocity_values[q] -
+                      present_velocity_values[q]) *
+                       phi_u[i] / time.get_delta_t() * rho +
+                     gravity * phi_u[i] * rho) *
+                    fe_values.JxW(q);
+                  if (ind == 1)
                     {
-                      for (unsigned int j = 0; j < dofs_per_cell; ++j)
-                        {
-                          // Let the linearized diffusion, continuity and
-                          // Grad-Div
-                          // term be written as
-                          // the bilinear operator: \f$A = a((\delta{u},
-                          // \delta{p}), (\delta{v}, \delta{q}))\f$,
-                          // the linearized convection term be: \f$C =
-                          // c(u;\delta{u}, \delta{v})\f$,
-                          // and the linearized inertial term be:
-                          // \f$M = m(\delta{u}, \delta{v})$, then LHS is: $(A +
-                          // C) + M/{\Delta{t}}\f$
-                          local_matrix(i, j) +=
-                            (viscosity *
-                               scalar_product(grad_phi_u[j], grad_phi_u[i]) +
-                             current_velocity_gradients[q] * phi_u[j] *
-                               phi_u[i] * rho +
-                             grad_phi_u[j] * current_velocity_values[q] *
-                               phi_u[i] * rho -
-                             div_phi_u[i] * phi_p[j] - phi_p[i] * div_phi_u[j] +
-                             gamma * div_phi_u[j] * div_phi_u[i] * rho +
-                             phi_u[i] * phi_u[j] / time.get_delta_t() * rho) *
-                            fe_values.JxW(q);
-                          local_mass_matrix(i, j) +=
-                            (phi_u[i] * phi_u[j] + phi_p[i] * phi_p[j]) *
-                            fe_values.JxW(q);
-                        }
-
-                      // RHS is \f$-(A_{current} + C_{current}) -
-                      // M_{present-current}/\Delta{t}\f$.
-                      double current_velocity_divergence =
-                        trace(current_velocity_gradients[q]);
                       local_rhs(i) +=
-                        ((-viscosity *
-                            scalar_product(current_velocity_gradients[q],
-                                           grad_phi_u[i]) -
-                          current_velocity_gradients[q] *
-                            current_velocity_values[q] * phi_u[i] * rho +
-                          current_pressure_values[q] * div_phi_u[i] +
-                          current_velocity_divergence * phi_p[i] -
-                          gamma * current_velocity_divergence * div_phi_u[i] *
-                            rho) -
-                         (current_velocity_values[q] -
-                          present_velocity_values[q]) *
-                           phi_u[i] / time.get_delta_t() * rho +
-                         gravity * phi_u[i] * rho) *
+                        (scalar_product(grad_phi_u[i], fsi_stress) +
+                         (fsi_acceleration * rho * phi_u[i])) *
                         fe_values.JxW(q);
-                      if (ind == 1)
-                        {
-                          local_rhs(i) +=
-                            (scalar_product(grad_phi_u[i], p[0]->fsi_stress) +
-                             (p[0]->fsi_acceleration * rho * phi_u[i])) *
-                            fe_values.JxW(q);
-                        }
                     }
                 }
+            }
 
-              // Impose pressure boundary here if specified, loop over faces on
-              // the
-              // cell
-              // and apply pressure boundary conditions:
-              // \f$\int_{\Gamma_n} -p\bold{n}d\Gamma\f$
-              if (parameters.n_fluid_neumann_bcs != 0)
+          // Impose pressure boundary here if specified, loop over faces on
+          // the
+          // cell
+          // and apply pressure boundary conditions:
+          // \f$\int_{\Gamma_n} -p\bold{n}d\Gamma\f$
+          if (parameters.n_fluid_neumann_bcs != 0)
+            {
+              for (unsigned int face_n = 0;
+                   face_n < GeometryInfo<dim>::faces_per_cell;
+                   ++face_n)
                 {
-                  for (unsigned int face_n = 0;
-                       face_n < GeometryInfo<dim>::faces_per_cell;
-                       ++face_n)
+                  if (cell->at_boundary(face_n) &&
+                      parameters.fluid_neumann_bcs.find(
+                        cell->face(face_n)->boundary_id()) !=
+                        parameters.fluid_neumann_bcs.end())
                     {
-                      if (cell->at_boundary(face_n) &&
-                          parameters.fluid_neumann_bcs.find(
-                            cell->face(face_n)->boundary_id()) !=
-                            parameters.fluid_neumann_bcs.end())
+                      fe_face_values.reinit(cell, face_n);
+                      unsigned int p_bc_id =
+                        cell->face(face_n)->boundary_id();
+                      double boundary_values_p =
+                        parameters.fluid_neumann_bcs.at(p_bc_id);
+                      for (unsigned int q = 0; q < n_face_q_points; ++q)
                         {
-                          fe_face_values.reinit(cell, face_n);
-                          unsigned int p_bc_id =
-                            cell->face(face_n)->boundary_id();
-                          double boundary_values_p =
-                            parameters.fluid_neumann_bcs[p_bc_id];
-                          for (unsigned int q = 0; q < n_face_q_points; ++q)
+                          for (unsigned int i = 0; i < dofs_per_cell; ++i)
                             {
-                              for (unsigned int i = 0; i < dofs_per_cell; ++i)
-                                {
-                                  local_rhs(i) += -(
-                                    fe_face_values[velocities].value(i, q) *
-                                    fe_face_values.normal_vector(q) *
-                                    boundary_values_p * fe_face_values.JxW(q));
-                                }
+                              local_rhs(i) += -(
+                                fe_face_values[velocities].value(i, q) *
+                                fe_face_values.normal_vector(q) *
+                                boundary_values_p * fe_face_values.JxW(q));
                             }
                         }
                     }
                 }
-
-              cell->get_dof_indices(local_dof_indices);
-
-              const AffineConstraints<double> &constraints_used =
-                use_nonzero_constraints ? nonzero_constraints
-                                        : zero_constraints;
-              constraints_used.distribute_local_to_global(local_matrix,
-                                                          local_rhs,
-                                                          local_dof_indices,
-                                                          system_matrix,
-                                                          system_rhs,
-                                                          true);
-              constraints_used.distribute_local_to_global(
-                local_mass_matrix, local_dof_indices, mass_matrix);
             }
-        }
+
+          cell->get_dof_indices(local_dof_indices);
+        };
+
+      const AffineConstraints<double> &constraints_used =
+        use_nonzero_constraints ? nonzero_constraints : zero_constraints;
+      auto copy_cell = [&](const Utils::AssemblyCopy &copy) {
+        constraints_used.distribute_local_to_global(copy.cell_matrix,
+                                                    copy.cell_rhs,
+                                                    copy.local_dof_indices,
+                                                    system_matrix,
+                                                    system_rhs,
+                                                    true);
+        constraints_used.distribute_local_to_global(
+          copy.cell_matrix2, copy.local_dof_indices, mass_matrix);
+      };
+
+      Utils::AssemblyCopy copy_data;
+      copy_data.cell_matrix.reinit(dofs_per_cell, dofs_per_cell);
+      copy_data.cell_matrix2.reinit(dofs_per_cell, dofs_per_cell);
+      copy_data.cell_rhs.reinit(dofs_per_cell);
+      copy_data.local_dof_indices.resize(dofs_per_cell);
+
+      // The interior cells only read the locally owned values of the
+      // evaluation point, so they are assembled while its ghost values are
+      // still on the way.
+      using CellIterator = typename std::vector<
+        typename DoFHandler<dim>::active_cell_iterator>::const_iterator;
+      auto assemble_listed_cell = [&](const CellIterator &cell,
+                                      Utils::AssemblyScratch<dim> &scratch,
+                                      Utils::AssemblyCopy &copy) {
+        assemble_cell(*cell, scratch, copy);
+      };
+      const Utils::AssemblyScratch<dim> scratch(
+        fe, volume_quad_formula, flags, face_quad_formula, face_flags);
+      Utils::copy_ghosted_vector(
+        evaluation_point, assembly_evaluation_point, true, false);
+      Utils::copy_ghosted_vector(present_solution, assembly_present_solution);
+      WorkStream::run(interior_cells.cbegin(),
+                      interior_cells.cend(),
+                      assemble_listed_cell,
+                      copy_cell,
+                      scratch,
+                      copy_data);
+      evaluation_point_update.finish();
+      Utils::copy_ghosted_vector(
+        evaluation_point, assembly_evaluation_point, false, true);
+      WorkStream::run(ghost_adjacent_cells.cbegin(),
+                      ghost_adjacent_cells.cend(),
+                      assemble_listed_cell,
+                      copy_cell,
+                      scratch,
+                      copy_data);
 
       system_matrix.compress(VectorOperation::add);
       mass_matrix.compress(VectorOperation::add);
       system_rhs.compress(VectorOperation::add);
+      print_memory_report();
     }
 
     template <int dim>
     std::pair<unsigned int, double>
-    InsIM<dim>::solve(const bool use_nonzero_constraints)
+    InsIM<dim>::solve(const bool use_nonzero_constraints,
+                      const double relative_tolerance)
     {
-      TimerOutput::Scope timer_section(timer, "Solve linear system");
-      preconditioner.reset(new BlockSchurPreconditioner(timer2,
-                                                        parameters.grad_div,
-                                                        parameters.viscosity,
-                                                        parameters.fluid_rho,
-                                                        time.get_delta_t(),
-                                                        owned_partitioning,
-                                                        system_matrix,
-                                                        mass_matrix,
-                                                        mass_schur));
+      Utils::ProfilingScope timer_section(timer, "Solve linear system");
+      if (parameters.fluid_reuse_direct_analysis && !direct_solver)
+        {
+          direct_solver = std::make_shared<PETScWrappers::SparseDirectMUMPS>(
+            direct_solver_control, mpi_communicator);
+        }
+      if (matrix_free_solver)
+        {
+          matrix_free_solver->update(evaluation_point, time.get_delta_t());
+        }
+      preconditioner.reset(
+        new BlockSchurPreconditioner(timer2,
+                                     parameters.grad_div,
+                                     parameters.viscosity,
+                                     parameters.fluid_rho,
+                                     time.get_delta_t(),
+                                     owned_partitioning,
+                                     system_matrix,
+                                     mass_matrix,
+                                     mass_schur,
+                                     velocity_solver.get(),
+                                     direct_solver.get(),
+                                     matrix_free_solver.get(),
+                                     parameters.fluid_krylov_variant ==
+                                       "Pipelined"));
 
       SolverControl solver_control(
-        system_matrix.m(), std::max(1e-12, 1e-4 * system_rhs.l2_norm()), true);
+        system_matrix.m(),
+        std::max(1e-12, relative_tolerance * system_rhs.l2_norm()),
+        true);
       // Because PETScWrappers::SolverGMRES requires preconditioner derived
       // from PETScWrappers::PreconditionBase, we use dealii SolverFGMRES.
       GrowingVectorMemory<PETScWrappers::MPI::BlockVector> vector_memory;
@@ -388,6 +568,12 @@ namespace Fluid
         use_nonzero_constraints ? nonzero_constraints : zero_constraints;
       constraints_used.distribute(newton_update);
 
+      if (velocity_solver.record(solver_control.last_step()))
+        {
+          pcout << " VELOCITY_SOLVER = " << velocity_solver.get() << std::endl;
+        }
+
+      linear_iterations += solver_control.last_step();
       return {solver_control.last_step(), solver_control.last_value()};
     }
 
@@ -414,7 +600,18 @@ namespace Fluid
       double initial_residual = 1.0;
       double relative_residual = 1.0;
       unsigned int outer_iteration = 0;
-      evaluation_point = present_solution;
+      Utils::ForcingTerm forcing_term(
+        1e-4, parameters.inexact_newton, parameters.max_forcing_term);
+      unsigned int step_linear_iterations = 0;
+      // Start the Newton iterations from the extrapolated solution.
+      {
+        PETScWrappers::MPI::BlockVector &change = workspace[0];
+        PETScWrappers::MPI::BlockVector &tmp = workspace[1];
+        predict_solution_change(change);
+        tmp = present_solution;
+        tmp += change;
+        evaluation_point_update.start(evaluation_point, tmp);
+      }
       while (relative_residual > parameters.fluid_tolerance &&
              current_residual > 1e-11)
         {
@@ -431,18 +628,24 @@ namespace Fluid
           // if they are time-independent, nonzero_constraints should be
           // applied only at the first iteration of the first time step.
           assemble(apply_nonzero_constraints && outer_iteration == 0);
-          auto state = solve(apply_nonzero_constraints && outer_iteration == 0);
           current_residual = system_rhs.l2_norm();
+          if (outer_iteration == 0)
+            {
+              steady_residual = current_residual;
+            }
+          const double eta = forcing_term.next(current_residual);
+          auto state =
+            solve(apply_nonzero_constraints && outer_iteration == 0, eta);
+          step_linear_iterations += state.first;
 
           // Update evaluation_point. Since newton_update has been set to
           // the correct bc values, there is no need to distribute the
           // evaluation_point again. Note we have to use a non-ghosted
           // vector as a buffer in order to do addition.
-          PETScWrappers::MPI::BlockVector tmp;
-          tmp.reinit(owned_partitioning, mpi_communicator);
+          PETScWrappers::MPI::BlockVector &tmp = workspace[0];
           tmp = evaluation_point;
           tmp += newton_update;
-          evaluation_point = tmp;
+          evaluation_point_update.start(evaluation_point, tmp);
 
           if (outer_iteration == 0)
             {
@@ -452,33 +655,37 @@ namespace Fluid
 
           pcout << std::scientific << std::left << " ITR = " << std::setw(2)
                 << outer_iteration << " ABS_RES = " << current_residual
-                << " REL_RES = " << relative_residual
+                << " REL_RES = " << relative_residual << " ETA = " << eta
                 << " GMRES_ITR = " << std::setw(3) << state.first
                 << " GMRES_RES = " << state.second << std::endl;
 
           outer_iteration++;
         }
+      newton_iterations = outer_iteration;
+      pcout << " NEWTON_ITR = " << outer_iteration
+            << " TOTAL_GMRES_ITR = " << step_linear_iterations << std::endl;
+      evaluation_point_update.finish();
       // Update solution increment, which is used in FSI application.
-      PETScWrappers::MPI::BlockVector tmp1, tmp2;
-      tmp1.reinit(owned_partitioning, mpi_communicator);
-      tmp2.reinit(owned_partitioning, mpi_communicator);
+      PETScWrappers::MPI::BlockVector &tmp1 = workspace[0];
+      PETScWrappers::MPI::BlockVector &tmp2 = workspace[1];
       tmp1 = evaluation_point;
       tmp2 = present_solution;
       tmp2 -= tmp1;
       solution_increment = tmp2;
       // Newton iteration converges, update time and solution
       present_solution = evaluation_point;
-      // Update stress for output
-      update_stress();
-      // Output
-      if (parameters.simulation_type == "Fluid" && time.time_to_save())
-        {
-          save_checkpoint(time.get_timestep());
-        }
+      probes.sample(present_solution, time.current(), time.time_to_output());
+      // Output before saving, so that the restart record includes it.
       if (time.time_to_output())
         {
+          // The stress is only needed for output.
+          update_stress();
           output_results(time.get_timestep());
         }
+      if (parameters.simulation_type == "Fluid" && time.time_to_save())
+        {
+          save_checkpoint(time.get_timestep());
+        }
       if (parameters.simulation_type == "Fluid" && time.time_to_refine())
         {
           refine_mesh(1, 3);
@@ -507,9 +714,18 @@ namespace Fluid
       // which means nonzero_constraints will be applied at the first iteration
       // in the first time step only, and never be used again.
       // This corresponds to time-independent Dirichlet BCs.
+      if (parameters.steady_state)
+        {
+          run_pseudo_transient(true);
+          return;
+        }
       run_one_step(true);
       while (time.end() - time.current() > 1e-12)
         {
+          if (parameters.adaptive_time_step)
+            {
+              adapt_time_step();
+            }
           run_one_step(false);
         }
     }
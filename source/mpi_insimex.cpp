@@ -22,9 +22,15 @@ namespace Fluid
         dt(dt),
         system_matrix(&system),
         mass_matrix(&mass),
-        mass_schur(&schur)
+        mass_schur(&schur),
+        mp_control(mass.block(1, 1).m(), 1e-10),
+        sm_control(mass.block(1, 1).m(), 1e-10),
+        a_control(system.block(0, 0).m(), 1e-12),
+        cg_mp(mp_control, mass.get_mpi_communicator()),
+        cg_sm(sm_control, mass.get_mpi_communicator()),
+        cg_a(a_control, mass.get_mpi_communicator())
     {
-      TimerOutput::Scope timer_section(timer2, "CG for Sm");
+      Utils::ProfilingScope timer_section(timer2, "CG for Sm");
       // The sparsity pattern of mass_schur is already set,
       // we calculate its value in the following.
       PETScWrappers::MPI::BlockVector tmp1, tmp2;
@@ -41,6 +47,20 @@ namespace Fluid
       // tell mmult not to rebuild the sparsity pattern.
       system_matrix->block(1, 0).mmult(
         mass_schur->block(1, 1), system_matrix->block(0, 1), tmp2.block(0));
+      // The rows of the constrained pressure dofs, e.g. on the hanging nodes
+      // after refine_mesh, are zero in B and thus in Sm.
+      Utils::fill_zero_diagonal(mass_schur->block(1, 1));
+
+      // The inner solvers create their KSP objects at the first solve and
+      // keep them, together with these preconditioners, afterwards. The
+      // pressure mass matrix is spectrally equivalent to its diagonal, and
+      // Sm is a discrete pressure Laplacian, so the iterations of both do
+      // not grow with the mesh size.
+      Mp_preconditioner.initialize(mass_matrix->block(1, 1));
+      PETScWrappers::PreconditionBoomerAMG::AdditionalData data;
+      data.symmetric_operator = true;
+      Sm_preconditioner.initialize(mass_schur->block(1, 1), data);
+      A_preconditioner.initialize(system_matrix->block(0, 0));
     }
 
     /**
@@ -64,37 +84,20 @@ namespace Fluid
       // This block computes \f$u_1 = \tilde{S}^{-1} v_1\f$,
       // where CG solvers are used for \f$M_p^{-1}\f$ and \f$S_m^{-1}\f$.
       {
-        TimerOutput::Scope timer_section(timer2, "CG for Mp");
-        SolverControl mp_control(
-          src.block(1).size(), std::max(1e-10, 1e-6 * src.block(1).l2_norm()));
-        PETScWrappers::SolverCG cg_mp(mp_control,
-                                      mass_schur->get_mpi_communicator());
+        Utils::ProfilingScope timer_section(timer2, "CG for Mp");
+        mp_control.set_tolerance(
+          std::max(1e-10, 1e-6 * src.block(1).l2_norm()));
         // \f$-(\mu + \gamma\rho)M_p^{-1}v_1\f$
-        PETScWrappers::PreconditionNone Mp_preconditioner;
-        Mp_preconditioner.initialize(mass_matrix->block(1, 1));
         cg_mp.solve(
           mass_matrix->block(1, 1), tmp, src.block(1), Mp_preconditioner);
         tmp *= -(viscosity + gamma * rho);
       }
 
-      // FIXME: There is a mysterious bug here. After refine_mesh is called,
-      // the initialization of Sm_preconditioner will complain about zero
-      // entries on the diagonal which causes division by 0 since
-      // PreconditionBlockJacobi uses ILU(0) underneath. This is similar to the
-      // serial code where SparseILU is used. However, 1. if we do not use a
-      // preconditioner here, the code runs fine, suggesting that mass_schur is
-      // correct; 2. if we do not call refine_mesh, the code also runs fine. So
-      // the question is, why would refine_mesh generate diagonal zeros?
-      //
       // \f$-\frac{1}{dt}S_m^{-1}v_1\f$
       {
-        TimerOutput::Scope timer_section(timer2, "CG for Sm");
-        SolverControl sm_control(
-          src.block(1).size(), std::max(1e-10, 1e-3 * src.block(1).l2_norm()));
-        PETScWrappers::SolverCG cg_sm(sm_control,
-                                      mass_schur->get_mpi_communicator());
-        PETScWrappers::PreconditionNone Sm_preconditioner;
-        Sm_preconditioner.initialize(mass_schur->block(1, 1));
+        Utils::ProfilingScope timer_section(timer2, "CG for Sm");
+        sm_control.set_tolerance(
+          std::max(1e-10, 1e-3 * src.block(1).l2_norm()));
         cg_sm.solve(mass_schur->block(1, 1),
                     dst.block(1),
                     src.block(1),
@@ -112,13 +115,9 @@ namespace Fluid
       // Finally, compute the product of \f$\tilde{A}^{-1}\f$ and utmp
       // using another CG solver.
       {
-        TimerOutput::Scope timer_section(timer2, "CG for A");
-        SolverControl a_control(src.block(0).size(),
-                                std::max(1e-12, 1e-4 * src.block(0).l2_norm()));
-        PETScWrappers::SolverCG cg_a(a_control,
-                                     mass_schur->get_mpi_communicator());
-        PETScWrappers::PreconditionNone A_preconditioner;
-        A_preconditioner.initialize(system_matrix->block(0, 0));
+        Utils::ProfilingScope timer_section(timer2, "CG for A");
+        a_control.set_tolerance(
+          std::max(1e-12, 1e-4 * src.block(0).l2_norm()));
         cg_a.solve(
           system_matrix->block(0, 0), dst.block(0), utmp, A_preconditioner);
       }
@@ -128,7 +127,7 @@ namespace Fluid
     InsIMEX<dim>::InsIMEX(parallel::distributed::Triangulation<dim> &tria,
                           const Parameters::AllParameters &parameters,
                           std::shared_ptr<Function<dim>> bc)
-      : FluidSolver<dim>(tria, parameters, bc)
+      : FluidSolver<dim>(tria, parameters, bc), assembled_delta_t(0)
     {
       Assert(
         parameters.fluid_velocity_degree - parameters.fluid_pressure_degree ==
@@ -145,13 +144,14 @@ namespace Fluid
       // newton_update is non-ghosted because the linear solver needs
       // a completely distributed vector.
       solution_increment.reinit(owned_partitioning, mpi_communicator);
+      print_memory_report();
     }
 
     template <int dim>
     void InsIMEX<dim>::assemble(bool use_nonzero_constraints,
                                 bool assemble_system)
     {
-      TimerOutput::Scope timer_section(timer, "Assemble system");
+      Utils::ProfilingScope timer_section(timer, "Assemble system");
 
       const double viscosity = parameters.viscosity;
       const double gamma = parameters.grad_div;
@@ -166,15 +166,11 @@ namespace Fluid
         }
       system_rhs = 0;
 
-      FEValues<dim> fe_values(fe,
-                              volume_quad_formula,
-                              update_values | update_quadrature_points |
-                                update_JxW_values | update_gradients);
-      FEFaceValues<dim> fe_face_values(fe,
-                                       face_quad_formula,
-                                       update_values | update_normal_vectors |
-                                         update_quadrature_points |
-                                         update_JxW_values);
+      const UpdateFlags flags = update_values | update_quadrature_points |
+                                update_JxW_values | update_gradients;
+      const UpdateFlags face_flags = update_values | update_normal_vectors |
+                                     update_quadrature_points |
+                                     update_JxW_values;
 
       const unsigned int dofs_per_cell = fe.dofs_per_cell;
       const unsigned int n_q_points = volume_quad_formula.size();
@@ -183,165 +179,197 @@ namespace Fluid
       const FEValuesExtractors::Vector velocities(0);
       const FEValuesExtractors::Scalar pressure(dim);
 
-      FullMatrix<double> local_matrix(dofs_per_cell, dofs_per_cell);
-      FullMatrix<double> local_mass_matrix(dofs_per_cell, dofs_per_cell);
-      Vector<double> local_rhs(dofs_per_cell);
-
-      std::vector<types::global_dof_index> local_dof_indices(dofs_per_cell);
+      auto assemble_cell =
+        [&](const typename DoFHandler<dim>::active_cell_iterator &cell,
+            Utils::AssemblyScratch<dim> &scratch,
+            Utils::AssemblyCopy &copy) {
+          FEValues<dim> &fe_values = scratch.fe_values;
+          FEFaceValues<dim> &fe_face_values = scratch.fe_face_values;
+          FullMatrix<double> &local_matrix = copy.cell_matrix;
+          FullMatrix<double> &local_mass_matrix = copy.cell_matrix2;
+          Vector<double> &local_rhs = copy.cell_rhs;
+          std::vector<types::global_dof_index> &local_dof_indices =
+            copy.local_dof_indices;
+
+          std::vector<Tensor<1, dim>> &current_velocity_values =
+            scratch.current_velocity_values;
+          std::vector<Tensor<2, dim>> &current_velocity_gradients =
+            scratch.current_velocity_gradients;
+          std::vector<double> &current_velocity_divergences =
+            scratch.current_velocity_divergences;
+          std::vector<double> &current_pressure_values =
+            scratch.current_pressure_values;
+
+          std::vector<double> &div_phi_u = scratch.div_phi_u;
+          std::vector<Tensor<1, dim>> &phi_u = scratch.phi_u;
+          std::vector<Tensor<2, dim>> &grad_phi_u = scratch.grad_phi_u;
+          std::vector<double> &phi_p = scratch.phi_p;
+
+          const unsigned int cell_index = cell->active_cell_index();
+          const SymmetricTensor<2, dim> fsi_stress =
+            cell_property.get_fsi_stress(cell_index);
+          const Tensor<1, dim> fsi_acceleration =
+            cell_property.get_fsi_acceleration(cell_index);
+          const int ind = cell_property.get_indicator(cell_index);
+          const double rho = parameters.fluid_rho;
+
+          fe_values.reinit(cell);
+
+          if (assemble_system)
+            {
+              local_matrix = 0;
+              local_mass_matrix = 0;
+            }
+          local_rhs = 0;
 
-      std::vector<Tensor<1, dim>> current_velocity_values(n_q_points);
-      std::vector<Tensor<2, dim>> current_velocity_gradients(n_q_points);
-      std::vector<double> current_velocity_divergences(n_q_points);
-      std::vector<double> current_pressure_values(n_q_points);
+          fe_values[velocities].get_function_values(
+            assembly_present_solution, current_velocity_values);
 
-      std::vector<double> div_phi_u(dofs_per_cell);
-      std::vector<Tensor<1, dim>> phi_u(dofs_per_cell);
-      std::vector<Tensor<2, dim>> grad_phi_u(dofs_per_cell);
-      std::vector<double> phi_p(dofs_per_cell);
+          fe_values[velocities].get_function_gradients(
+            assembly_present_solution, current_velocity_gradients);
 
-      for (auto cell = dof_handler.begin_active(); cell != dof_handler.end();
-           ++cell)
-        {
-          if (cell->is_locally_owned())
-            {
-              auto p = cell_property.get_data(cell);
-              const int ind = p[0]->indicator;
-              const double rho = parameters.fluid_rho;
+          fe_values[velocities].get_function_divergences(
+            assembly_present_solution, current_velocity_divergences);
 
-              fe_values.reinit(cell);
+          fe_values[pressure].get_function_values(assembly_present_solution,
+                                                  current_pressure_values);
 
-              if (assemble_system)
+          // Assemble the system matrix and mass matrix simultaneouly.
+          // The mass matrix only uses the (0, 0) and (1, 1) blocks.
+          //
+          for (unsigned int q = 0; q < n_q_points; ++q)
+            {
+              for (unsigned int k = 0; k < dofs_per_cell; ++k)
                 {
-                  local_matrix = 0;
-                  local_mass_matrix = 0;
+                  div_phi_u[k] = fe_values[velocities].divergence(k, q);
+                  grad_phi_u[k] = fe_values[velocities].gradient(k, q);
+                  phi_u[k] = fe_values[velocities].value(k, q);
+                  phi_p[k] = fe_values[pressure].value(k, q);
                 }
-              local_rhs = 0;
 
-              fe_values[velocities].get_function_values(
-                present_solution, current_velocity_values);
-
-              fe_values[velocities].get_function_gradients(
-                present_solution, current_velocity_gradients);
-
-              fe_values[velocities].get_function_divergences(
-                present_solution, current_velocity_divergences);
-
-              fe_values[pressure].get_function_values(present_solution,
-                                                      current_pressure_values);
-
-              // Assemble the system matrix and mass matrix simultaneouly.
-              // The mass matrix only uses the (0, 0) and (1, 1) blocks.
-              //
-              for (unsigned int q = 0; q < n_q_points; ++q)
+              for (unsigned int i = 0; i < dofs_per_cell; ++i)
                 {
-                  for (unsigned int k = 0; k < dofs_per_cell; ++k)
+                  if (assemble_system)
                     {
-                      div_phi_u[k] = fe_values[velocities].divergence(k, q);
-                      grad_phi_u[k] = fe_values[velocities].gradient(k, q);
-                      phi_u[k] = fe_values[velocities].value(k, q);
-                      phi_p[k] = fe_values[pressure].value(k, q);
-                    }
-
-                  for (unsigned int i = 0; i < dofs_per_cell; ++i)
-                    {
-                      if (assemble_system)
-                        {
-                          for (unsigned int j = 0; j < dofs_per_cell; ++j)
-                            {
-                              local_matrix(i, j) +=
-                                (viscosity * scalar_product(grad_phi_u[j],
-                                                            grad_phi_u[i]) -
-                                 div_phi_u[i] * phi_p[j] -
-                                 phi_p[i] * div_phi_u[j] +
-                                 gamma * div_phi_u[j] * div_phi_u[i] * rho +
-                                 phi_u[i] * phi_u[j] / time.get_delta_t() *
-                                   rho) *
-                                fe_values.JxW(q);
-                              local_mass_matrix(i, j) +=
-                                (phi_u[i] * phi_u[j] + phi_p[i] * phi_p[j]) *
-                                fe_values.JxW(q);
-                            }
-                        }
-                      local_rhs(i) -=
-                        (viscosity *
-                           scalar_product(current_velocity_gradients[q],
-                                          grad_phi_u[i]) -
-                         current_velocity_divergences[q] * phi_p[i] -
-                         current_pressure_values[q] * div_phi_u[i] +
-                         gamma * current_velocity_divergences[q] *
-                           div_phi_u[i] * rho +
-                         current_velocity_gradients[q] *
-                           current_velocity_values[q] * phi_u[i] * rho -
-                         gravity * phi_u[i] * rho) *
-                        fe_values.JxW(q);
-                      if (ind == 1)
+                      for (unsigned int j = 0; j < dofs_per_cell; ++j)
                         {
-                          local_rhs(i) +=
-                            (scalar_product(grad_phi_u[i], p[0]->fsi_stress) +
-                             (p[0]->fsi_acceleration * rho * phi_u[i])) *
+                          local_matrix(i, j) +=
+                            (viscosity * scalar_product(grad_phi_u[j],
+                                                        grad_phi_u[i]) -
+                             div_phi_u[i] * phi_p[j] -
+                             phi_p[i] * div_phi_u[j] +
+                             gamma * div_phi_u[j] * div_phi_u[i] * rho +
+                             phi_u[i] * phi_u[j] / time.get_delta_t() *
+                               rho) *
+                            fe_values.JxW(q);
+                          local_mass_matrix(i, j) +=
+                            (phi_u[i] * phi_u[j] + phi_p[i] * phi_p[j]) *
                             fe_values.JxW(q);
                         }
                     }
+                  local_rhs(i) -=
+                    (viscosity *
+                       scalar_product(current_velocity_gradients[q],
+                                      grad_phi_u[i]) -
+                     current_velocity_divergences[q] * phi_p[i] -
+                     current_pressure_values[q] * div_phi_u[i] +
+                     gamma * current_velocity_divergences[q] *
+                       div_phi_u[i] * rho +
+                     current_velocity_gradients[q] *
+                       current_velocity_values[q] * phi_u[i] * rho -
+                     gravity * phi_u[i] * rho) *
+                    fe_values.JxW(q);
+                  if (ind == 1)
+                    {
+                      local_rhs(i) +=
+                        (scalar_product(grad_phi_u[i], fsi_stress) +
+                         (fsi_acceleration * rho * phi_u[i])) *
+                        fe_values.JxW(q);
+                    }
                 }
+            }
 
-              // Impose pressure boundary here if specified, loop over faces on
-              // the
-              // cell
-              // and apply pressure boundary conditions:
-              // \f$\int_{\Gamma_n} -p\bold{n}d\Gamma\f$
-              if (parameters.n_fluid_neumann_bcs != 0)
+          // Impose pressure boundary here if specified, loop over faces on
+          // the
+          // cell
+          // and apply pressure boundary conditions:
+          // \f$\int_{\Gamma_n} -p\bold{n}d\Gamma\f$
+          if (parameters.n_fluid_neumann_bcs != 0)
+            {
+              for (unsigned int face_n = 0;
+                   face_n < GeometryInfo<dim>::faces_per_cell;
+                   ++face_n)
                 {
-                  for (unsigned int face_n = 0;
-                       face_n < GeometryInfo<dim>::faces_per_cell;
-                       ++face_n)
+                  if (cell->at_boundary(face_n) &&
+                      parameters.fluid_neumann_bcs.find(
+                        cell->face(face_n)->boundary_id()) !=
+                        parameters.fluid_neumann_bcs.end())
                     {
-                      if (cell->at_boundary(face_n) &&
-                          parameters.fluid_neumann_bcs.find(
-                            cell->face(face_n)->boundary_id()) !=
-                            parameters.fluid_neumann_bcs.end())
+                      fe_face_values.reinit(cell, face_n);
+                      unsigned int p_bc_id =
+                        cell->face(face_n)->boundary_id();
+                      double boundary_values_p =
+                        parameters.fluid_neumann_bcs.at(p_bc_id);
+                      for (unsigned int q = 0; q < n_face_q_points; ++q)
                         {
-                          fe_face_values.reinit(cell, face_n);
-                          unsigned int p_bc_id =
-                            cell->face(face_n)->boundary_id();
-                          double boundary_values_p =
-                            parameters.fluid_neumann_bcs[p_bc_id];
-                          for (unsigned int q = 0; q < n_face_q_points; ++q)
+                          for (unsigned int i = 0; i < dofs_per_cell; ++i)
                             {
-                              for (unsigned int i = 0; i < dofs_per_cell; ++i)
-                                {
-                                  local_rhs(i) += -(
-                                    fe_face_values[velocities].value(i, q) *
-                                    fe_face_values.normal_vector(q) *
-                                    boundary_values_p * fe_face_values.JxW(q));
-                                }
+                              local_rhs(i) += -(
+                                fe_face_values[velocities].value(i, q) *
+                                fe_face_values.normal_vector(q) *
+                                boundary_values_p * fe_face_values.JxW(q));
                             }
                         }
                     }
                 }
+            }
 
-              cell->get_dof_indices(local_dof_indices);
+          cell->get_dof_indices(local_dof_indices);
+        };
 
-              const AffineConstraints<double> &constraints_used =
-                use_nonzero_constraints ? nonzero_constraints
-                                        : zero_constraints;
-              if (assemble_system)
-                {
-                  constraints_used.distribute_local_to_global(local_matrix,
-                                                              local_rhs,
-                                                              local_dof_indices,
-                                                              system_matrix,
-                                                              system_rhs,
-                                                              true);
-                  constraints_used.distribute_local_to_global(
-                    local_mass_matrix, local_dof_indices, mass_matrix);
-                }
-              else
-                {
-                  constraints_used.distribute_local_to_global(
-                    local_rhs, local_dof_indices, system_rhs);
-                }
-            }
-        }
+      const AffineConstraints<double> &constraints_used =
+        use_nonzero_constraints ? nonzero_constraints : zero_constraints;
+      auto copy_cell = [&](const Utils::AssemblyCopy &copy) {
+        if (assemble_system)
+          {
+            constraints_used.distribute_local_to_global(copy.cell_matrix,
+                                                        copy.cell_rhs,
+                                                        copy.local_dof_indices,
+                                                        system_matrix,
+                                                        system_rhs,
+                                                        true);
+            constraints_used.distribute_local_to_global(
+              copy.cell_matrix2, copy.local_dof_indices, mass_matrix);
+          }
+        else
+          {
+            constraints_used.distribute_local_to_global(
+              copy.cell_rhs, copy.local_dof_indices, system_rhs);
+          }
+      };
+
+      Utils::AssemblyCopy copy_data;
+      copy_data.cell_matrix.reinit(dofs_per_cell, dofs_per_cell);
+      copy_data.cell_matrix2.reinit(dofs_per_cell, dofs_per_cell);
+      copy_data.cell_rhs.reinit(dofs_per_cell);
+      copy_data.local_dof_indices.resize(dofs_per_cell);
+
+      Utils::copy_ghosted_vector(present_solution, assembly_present_solution);
+
+      using CellFilter =
+        FilteredIterator<typename DoFHandler<dim>::active_cell_iterator>;
+      WorkStream::run(CellFilter(IteratorFilters::LocallyOwnedCell(),
+                                 dof_handler.begin_active()),
+                      CellFilter(IteratorFilters::LocallyOwnedCell(),
+                                 dof_handler.end()),
+                      assemble_cell,
+                      copy_cell,
+                      Utils::AssemblyScratch<dim>(fe,
+                                                  volume_quad_formula,
+                                                  flags,
+                                                  face_quad_formula,
+                                                  face_flags),
+                      copy_data);
 
       if (assemble_system)
         {
@@ -355,7 +383,7 @@ namespace Fluid
     std::pair<unsigned int, double>
     InsIMEX<dim>::solve(bool use_nonzero_constraints, bool assemble_system)
     {
-      TimerOutput::Scope timer_section(timer, "Solve linear system");
+      Utils::ProfilingScope timer_section(timer, "Solve linear system");
       if (assemble_system)
         {
           preconditioner.reset(
@@ -368,6 +396,7 @@ namespace Fluid
                                          system_matrix,
                                          mass_matrix,
                                          mass_schur));
+          assembled_delta_t = time.get_delta_t();
         }
 
       SolverControl solver_control(
@@ -386,6 +415,7 @@ namespace Fluid
         use_nonzero_constraints ? nonzero_constraints : zero_constraints;
       constraints_used.distribute(solution_increment);
 
+      linear_iterations += solver_control.last_step();
       return {solver_control.last_step(), solver_control.last_value()};
     }
 
@@ -406,11 +436,13 @@ namespace Fluid
             << "Time step = " << time.get_timestep()
             << ", at t = " << std::scientific << time.current() << std::endl;
 
-      // Resetting
-      solution_increment = 0;
-      assemble(apply_nonzero_constraints,
-               assemble_system || (parameters.simulation_type == "Fluid" &&
-                                   time.time_to_refine()));
+      // The linear solver starts from the extrapolated increment.
+      predict_solution_change(solution_increment);
+      // The matrices and the preconditioner only depend on the mesh, the
+      // time step and the constraints. A new mesh has no preconditioner.
+      assemble_system = assemble_system || !preconditioner ||
+                        assembled_delta_t != time.get_delta_t();
+      assemble(apply_nonzero_constraints, assemble_system);
       auto state = solve(apply_nonzero_constraints, assemble_system);
 
       // Note we have to use a non-ghosted vector in order to do addition.
@@ -422,19 +454,19 @@ namespace Fluid
 
       pcout << std::scientific << std::left << " GMRES_ITR = " << std::setw(3)
             << state.first << " GMRES_RES = " << state.second << std::endl;
+      probes.sample(present_solution, time.current(), time.time_to_output());
 
-      // Update stress for output
-      update_stress();
-
-      // Output
-      if (parameters.simulation_type == "Fluid" && time.time_to_save())
-        {
-          save_checkpoint(time.get_timestep());
-        }
+      // Output before saving, so that the restart record includes it.
       if (time.time_to_output())
         {
+          // The stress is only needed for output.
+          update_stress();
           output_results(time.get_timestep());
         }
+      if (parameters.simulation_type == "Fluid" && time.time_to_save())
+        {
+          save_checkpoint(time.get_timestep());
+        }
       if (parameters.simulation_type == "Fluid" && time.time_to_refine())
         {
           refine_mesh(1, 3);
@@ -21,10 +21,17 @@ namespace Solid
         }
     }
 
+    template <int dim>
+    void LinearElasticity<dim>::initialize_system()
+    {
+      SolidSolver<dim>::initialize_system();
+      print_memory_report();
+    }
+
     template <int dim>
     void LinearElasticity<dim>::assemble_system(const bool is_initial)
     {
-      TimerOutput::Scope timer_section(timer, "Assemble system");
+      Utils::ProfilingScope timer_section(timer, "Assemble system");
 
       double gamma = 0.5 + parameters.damping;
       double beta = gamma / 2;
@@ -124,7 +131,9 @@ namespace Solid
 
               cell->get_dof_indices(local_dof_indices);
 
-              // Traction or Pressure
+              // Traction or Pressure. In FSI simulation every boundary
+              // face takes the traction set by the FSI solver.
+              auto p = cell_property.get_data(cell);
               for (unsigned int face = 0;
                    face < GeometryInfo<dim>::faces_per_cell;
                    ++face)
@@ -132,13 +141,18 @@ namespace Solid
                   if (cell->face(face)->at_boundary())
                     {
                       unsigned int id = cell->face(face)->boundary_id();
-                      if (parameters.solid_neumann_bcs.find(id) !=
-                          parameters.solid_neumann_bcs.end())
+                      if (parameters.simulation_type == "FSI" ||
+                          parameters.solid_neumann_bcs.find(id) !=
+                            parameters.solid_neumann_bcs.end())
                         {
-                          std::vector<double> value =
-                            parameters.solid_neumann_bcs[id];
+                          std::vector<double> value;
+                          if (parameters.simulation_type != "FSI")
+                            {
+                              value = parameters.solid_neumann_bcs.at(id);
+                            }
                           Tensor<1, dim> traction;
-                          if (parameters.solid_neumann_bc_type == "Traction")
+                          if (parameters.simulation_type != "FSI" &&
+                              parameters.solid_neumann_bc_type == "Traction")
                             {
                               for (unsigned int i = 0; i < dim; ++i)
                                 {
@@ -149,14 +163,20 @@ namespace Solid
                           fe_face_values.reinit(cell, face);
                           for (unsigned int q = 0; q < n_f_q_points; ++q)
                             {
-                              if (parameters.solid_neumann_bc_type ==
-                                  "Pressure")
+                              if (parameters.simulation_type != "FSI" &&
+                                  parameters.solid_neumann_bc_type ==
+                                    "Pressure")
                                 {
                                   // The normal is w.r.t. reference
                                   // configuration!
                                   traction = fe_face_values.normal_vector(q);
                                   traction *= value[0];
                                 }
+                              else if (parameters.simulation_type == "FSI")
+                                {
+                                  traction =
+                                    p[face * n_f_q_points + q]->fsi_traction;
+                                }
                               for (unsigned int j = 0; j < dofs_per_cell; ++j)
                                 {
                                   const unsigned int component_j =
@@ -221,37 +241,25 @@ namespace Solid
             << "Time step = " << time.get_timestep()
             << ", at t = " << std::scientific << time.current() << std::endl;
 
-      // Modify the RHS
+      // Modify the RHS with the predicted displacement
+      const Utils::Newmark newmark(dt, gamma, beta);
       tmp1 = system_rhs;
-      tmp2 = previous_displacement;
-      tmp2.add(
-        dt, previous_velocity, (0.5 - beta) * dt * dt, previous_acceleration);
+      newmark.predict(
+        previous_displacement, previous_velocity, previous_acceleration, tmp2);
       stiffness_matrix.vmult(tmp3, tmp2);
       tmp1 -= tmp3;
 
       auto state = this->solve(system_matrix, current_acceleration, tmp1);
 
-      // update the current velocity
-      // \f$ v_{n+1} = v_n + (1-\gamma)\Delta{t}a_n + \gamma\Delta{t}a_{n+1}
-      // \f$
-      current_velocity = previous_velocity;
-      current_velocity.add(dt * (1 - gamma),
-                           previous_acceleration,
-                           dt * gamma,
-                           current_acceleration);
-
-      // update the current displacement
-      current_displacement = previous_displacement;
-      current_displacement.add(dt, previous_velocity);
-      current_displacement.add(dt * dt * (0.5 - beta),
-                               previous_acceleration,
-                               dt * dt * beta,
-                               current_acceleration);
-
-      // update the previous values
-      previous_acceleration = current_acceleration;
-      previous_velocity = current_velocity;
-      previous_displacement = current_displacement;
+      // update the current velocity and displacement, and the previous
+      // values, in one pass
+      newmark.advance_from_acceleration(tmp2,
+                                        current_acceleration,
+                                        current_velocity,
+                                        current_displacement,
+                                        previous_displacement,
+                                        previous_velocity,
+                                        previous_acceleration);
 
       pcout << std::scientific << std::left << " CG iteration: " << std::setw(3)
             << state.first << " CG residual: " << state.second << std::endl;
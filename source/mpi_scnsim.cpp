@@ -12,8 +12,8 @@ namespace Fluid
                          const PETScWrappers::PreconditionerBase &Pvvinv)
       : timer2(timer2), system_matrix(&system), Pvv_inverse(&Pvvinv)
     {
-      dumb_vector.reinit(owned_partitioning,
-                         system_matrix->get_mpi_communicator());
+      buffer1.reinit(owned_partitioning, system_matrix->get_mpi_communicator());
+      buffer2.reinit(owned_partitioning, system_matrix->get_mpi_communicator());
     }
 
     template <int dim>
@@ -22,8 +22,9 @@ namespace Fluid
       const PETScWrappers::MPI::Vector &src) const
     {
       // this is the exact representation of Tpp = App - Apv * Pvv * Avp.
-      PETScWrappers::MPI::Vector tmp1(dumb_vector.block(0)),
-        tmp2(dumb_vector.block(0)), tmp3(src);
+      PETScWrappers::MPI::Vector &tmp1 = buffer1.block(0);
+      PETScWrappers::MPI::Vector &tmp2 = buffer2.block(0);
+      PETScWrappers::MPI::Vector &tmp3 = buffer1.block(1);
       system_matrix->block(0, 1).vmult(tmp1, src);
       Pvv_inverse->vmult(tmp2, tmp1);
       system_matrix->block(1, 0).vmult(tmp3, tmp2);
@@ -38,29 +39,57 @@ namespace Fluid
       const PETScWrappers::MPI::BlockSparseMatrix &system,
       PETScWrappers::MPI::SparseMatrix &absA,
       PETScWrappers::MPI::SparseMatrix &schur,
-      PETScWrappers::MPI::SparseMatrix &B2pp)
+      PETScWrappers::MPI::SparseMatrix &B2pp,
+      std::vector<PETScWrappers::MPI::BlockVector> &workspace,
+      const std::string &B2pp_type,
+      const PreconditionEuclid::AdditionalData &euclid_data,
+      const PreconditionPilut::AdditionalData &pilut_data,
+      const bool pipelined,
+      const std::string &Tpp_type)
       : timer2(timer2),
         system_matrix(&system),
         Abs_A_matrix(&absA),
         schur_matrix(&schur),
         B2pp_matrix(&B2pp),
-        Tpp_itr(0)
+        workspace(workspace),
+        pipelined(pipelined),
+        Tpp_itr(0),
+        Tpp_tolerance(1e-3)
     {
       // Initialize the Pvv inverse (the ILU(0) factorization of Avv)
       Pvv_inverse.initialize(system_matrix->block(0, 0));
       // Initialize Tpp
       Tpp.reset(new SchurComplementTpp(
         timer2, owned_partitioning, *system_matrix, Pvv_inverse));
+      if (Tpp_type == "Diagonal")
+        {
+          // Assemble Tpp once with diag(Avv)^(-1) in place of Pvv^(-1), so
+          // that the inner iterations do not apply the ILU of Avv.
+          PETScWrappers::MPI::Vector &ones = workspace[0].block(0);
+          PETScWrappers::MPI::Vector &inverse_diagonal = workspace[1].block(0);
+          ones = 1;
+          PETScWrappers::PreconditionJacobi jacobi(system_matrix->block(0, 0));
+          jacobi.vmult(inverse_diagonal, ones);
+          Tpp_matrix = std::make_shared<PETScWrappers::MPI::SparseMatrix>();
+          system_matrix->block(1, 0).mmult(
+            *Tpp_matrix, system_matrix->block(0, 1), inverse_diagonal);
+          *Tpp_matrix *= -1.0;
+          Tpp_matrix->add(1, system_matrix->block(1, 1));
+        }
+      else if (pipelined)
+        {
+          Tpp_shell.reset(new ShellMatrix<SchurComplementTpp>(
+            *Tpp,
+            owned_partitioning[1],
+            system_matrix->block(1, 1).get_mpi_communicator()));
+        }
 
       // Compute B2pp matrix App - Apv*rowsum(|Avv|)^(-1)*Avp
       // as the preconditioner to solve Tpp^-1
-      PETScWrappers::MPI::BlockVector IdentityVector, RowSumAvv, ReverseRowSum;
-      IdentityVector.reinit(owned_partitioning,
-                            system_matrix->get_mpi_communicator());
-      RowSumAvv.reinit(owned_partitioning,
-                       system_matrix->get_mpi_communicator());
-      ReverseRowSum.reinit(owned_partitioning,
-                           system_matrix->get_mpi_communicator());
+      PETScWrappers::MPI::BlockVector &IdentityVector = workspace[0];
+      PETScWrappers::MPI::BlockVector &RowSumAvv = workspace[1];
+      PETScWrappers::MPI::BlockVector &ReverseRowSum = workspace[2];
+      ReverseRowSum = 0;
       // Want to set ReverseRowSum to 1 to calculate the Rowsum first
       IdentityVector.block(0) = 1;
       // iterate the Avv matrix to set everything to positive.
@@ -127,7 +156,36 @@ namespace Fluid
       B2pp_matrix->add(-1, *schur_matrix);
       B2pp_matrix->add(1, system_matrix->block(1, 1));
       B2pp_matrix->compress(VectorOperation::add);
-      B2pp_inverse.initialize(*B2pp_matrix);
+      if (B2pp_type == "BoomerAMG")
+        {
+          PETScWrappers::PreconditionBoomerAMG::AdditionalData data;
+          data.symmetric_operator = false;
+          data.strong_threshold = (dim == 2 ? 0.25 : 0.5);
+          auto amg = std::make_shared<PETScWrappers::PreconditionBoomerAMG>();
+          amg->initialize(*B2pp_matrix, data);
+          B2pp_inverse = amg;
+        }
+      else if (B2pp_type == "Pilut")
+        {
+          auto ilut = std::make_shared<PreconditionPilut>();
+          ilut->initialize(*B2pp_matrix, pilut_data);
+          B2pp_inverse = ilut;
+        }
+      else
+        {
+          auto ilu = std::make_shared<PreconditionEuclid>();
+          ilu->initialize(*B2pp_matrix, euclid_data);
+          B2pp_inverse = ilu;
+        }
+
+      // PETSc sets up a preconditioner again in every application once its
+      // matrix has changed, which would defeat reusing this preconditioner
+      // for the following Newton iterations.
+      PetscErrorCode ierr =
+        PCSetReusePreconditioner(Pvv_inverse.get_pc(), PETSC_TRUE);
+      AssertThrow(ierr == 0, ExcPETScError(ierr));
+      ierr = PCSetReusePreconditioner(B2pp_inverse->get_pc(), PETSC_TRUE);
+      AssertThrow(ierr == 0, ExcPETScError(ierr));
     }
 
     /**
@@ -143,7 +201,8 @@ namespace Fluid
       //      |I           0|*|src(0)| = |src(0)|
       //      |-ApvPvv^-1  I| |src(1)|   |ptmp  |
       /////////////////////////////////////////
-      PETScWrappers::MPI::Vector ptmp1(src.block(0)), ptmp(src.block(1));
+      PETScWrappers::MPI::Vector &ptmp1 = workspace[0].block(0);
+      PETScWrappers::MPI::Vector &ptmp = workspace[0].block(1);
       Pvv_inverse.vmult(ptmp1, src.block(0));
       this->Apv().vmult(ptmp, ptmp1);
       ptmp *= -1.0;
@@ -158,30 +217,63 @@ namespace Fluid
       // Compute Tpp^-1 * ptmp first, which is equal to the problem Tpp*x = ptmp
       // Set up initial guess first
       {
-        PETScWrappers::MPI::Vector c(ptmp), Sc(ptmp);
-        Tpp->vmult(Sc, c);
+        PETScWrappers::MPI::Vector &c = workspace[1].block(1);
+        PETScWrappers::MPI::Vector &Sc = workspace[2].block(1);
+        c = ptmp;
+        if (Tpp_matrix)
+          {
+            Tpp_matrix->vmult(Sc, c);
+          }
+        else
+          {
+            Tpp->vmult(Sc, c);
+          }
         double alpha = (ptmp * c) / (Sc * c);
         c *= alpha;
         dst.block(1) = c;
       }
       // Compute the multiplication
-      timer2.enter_subsection("Solving Tpp");
-      SolverControl solver_control(
-        ptmp.size(), 1e-3 * ptmp.l2_norm(), true, true);
-      GrowingVectorMemory<PETScWrappers::MPI::Vector> vector_memory;
-      SolverGMRES<PETScWrappers::MPI::Vector> gmres(
-        solver_control,
-        vector_memory,
-        SolverGMRES<PETScWrappers::MPI::Vector>::AdditionalData(200));
-      gmres.solve(*Tpp, dst.block(1), ptmp, B2pp_inverse);
-      // B2pp_inverse.vmult(dst.block(1), ptmp);
-      // Count iterations for this solver solving Tpp inverse
-      Tpp_itr += solver_control.last_step();
-
-      timer2.leave_subsection("Solving Tpp");
+      {
+        Utils::ProfilingScope timer_section(timer2, "Solving Tpp");
+        SolverControl solver_control(
+          ptmp.size(), Tpp_tolerance * ptmp.l2_norm(), true, true);
+        if (pipelined)
+          {
+            // One reduction per iteration, overlapped with the next Tpp
+            // product, instead of the one per Arnoldi vector of deal.II.
+            const PETScWrappers::MatrixBase &T =
+              Tpp_matrix ? static_cast<const PETScWrappers::MatrixBase &>(
+                             *Tpp_matrix)
+                         : *Tpp_shell;
+            SolverPGMRES gmres(solver_control,
+                               ptmp.get_mpi_communicator(),
+                               SolverPGMRES::AdditionalData(200));
+            gmres.solve(T, dst.block(1), ptmp, *B2pp_inverse);
+          }
+        else
+          {
+            GrowingVectorMemory<PETScWrappers::MPI::Vector> vector_memory;
+            SolverGMRES<PETScWrappers::MPI::Vector> gmres(
+              solver_control,
+              vector_memory,
+              SolverGMRES<PETScWrappers::MPI::Vector>::AdditionalData(200));
+            if (Tpp_matrix)
+              {
+                gmres.solve(*Tpp_matrix, dst.block(1), ptmp, *B2pp_inverse);
+              }
+            else
+              {
+                gmres.solve(*Tpp, dst.block(1), ptmp, *B2pp_inverse);
+              }
+          }
+        // B2pp_inverse.vmult(dst.block(1), ptmp);
+        // Count iterations for this solver solving Tpp inverse
+        Tpp_itr += solver_control.last_step();
+      }
 
       // Compute Pvv^-1*src(0) - Pvv^-1*Avp*dst(1)
-      PETScWrappers::MPI::Vector utmp1(src.block(0)), utmp2(src.block(0));
+      PETScWrappers::MPI::Vector &utmp1 = workspace[1].block(0);
+      PETScWrappers::MPI::Vector &utmp2 = workspace[2].block(0);
       this->Avp().vmult(utmp1, dst.block(1));
       Pvv_inverse.vmult(utmp2, utmp1);
       Pvv_inverse.vmult(dst.block(0), src.block(0));
@@ -195,60 +287,193 @@ namespace Fluid
                         std::shared_ptr<Function<dim>> pml,
                         std::shared_ptr<TensorFunction<1, dim>> bf)
       : FluidSolver<dim>(tria, parameters, bc),
+        constant_matrix_timestep(numbers::invalid_unsigned_int),
+        rebuild_preconditioner(true),
+        n_preconditioner_builds(0),
+        n_preconditioner_reuses(0),
+        euclid_data(parameters.euclid_levels, parameters.euclid_block_jacobi),
+        pilut_data(parameters.pilut_max_iterations,
+                   parameters.pilut_row_size,
+                   parameters.pilut_tolerance),
+        pressure_pc(
+          SolverPolicy::pressure_preconditioner(parameters.fluid_pressure_pc)),
+        n_tuning_candidates(
+          !parameters.tune_pressure_pc
+            ? 0
+            : parameters.fluid_pressure_pc == "Euclid"
+                ? parameters.tuning_levels.size()
+                : parameters.fluid_pressure_pc == "Pilut"
+                    ? parameters.tuning_tolerances.size()
+                    : 0),
+        tuning_start_time(0),
+        tuning_warm_up(true),
         sigma_pml_field(pml),
-        body_force(bf)
+        body_force(bf),
+        body_force_time(0)
     {
       AssertThrow(parameters.fluid_velocity_degree ==
                     parameters.fluid_pressure_degree,
                   ExcMessage("Velocity degree must the same as pressure!"));
     }
 
+    template <int dim>
+    void SCnsIM<dim>::start_tuning_step()
+    {
+      // The first step includes the setup of the solvers and starts from a
+      // poor initial guess, which is not representative.
+      if (tuning_warm_up || tuning_times.size() >= n_tuning_candidates)
+        {
+          return;
+        }
+      apply_tuning_candidate(tuning_times.size());
+      rebuild_preconditioner = true;
+      tuning_start_time = tpp_wall_time();
+    }
+
+    template <int dim>
+    void SCnsIM<dim>::finish_tuning_step(const unsigned int applications)
+    {
+      if (tuning_warm_up)
+        {
+          tuning_warm_up = false;
+          return;
+        }
+      if (tuning_times.size() >= n_tuning_candidates)
+        {
+          return;
+        }
+      // The steps need different numbers of outer iterations, the time
+      // per application of the preconditioner is comparable.
+      tuning_times.push_back((tpp_wall_time() - tuning_start_time) /
+                             std::max(1u, applications));
+      pcout << " TUNING_CANDIDATE = " << tuning_times.size() - 1
+            << " TPP_TIME_PER_ITR = " << tuning_times.back() << std::endl;
+      if (tuning_times.size() == n_tuning_candidates)
+        {
+          const unsigned int best =
+            std::min_element(tuning_times.begin(), tuning_times.end()) -
+            tuning_times.begin();
+          apply_tuning_candidate(best);
+          rebuild_preconditioner = true;
+          pcout << " TUNED_CANDIDATE = " << best << " FILL_LEVELS = "
+                << euclid_data.levels
+                << " DROP_TOLERANCE = " << pilut_data.tolerance << std::endl;
+        }
+    }
+
+    template <int dim>
+    void SCnsIM<dim>::apply_tuning_candidate(const unsigned int candidate)
+    {
+      if (parameters.fluid_pressure_pc == "Euclid")
+        {
+          euclid_data.levels = parameters.tuning_levels[candidate];
+        }
+      else
+        {
+          pilut_data.tolerance = parameters.tuning_tolerances[candidate];
+        }
+    }
+
+    template <int dim>
+    double SCnsIM<dim>::tpp_wall_time() const
+    {
+      // The inner Tpp solves are timed by the preconditioner.
+      auto wall_times = timer2.get_summary_data(TimerOutput::total_wall_time);
+      auto entry = wall_times.find("Solving Tpp");
+      const double local = entry == wall_times.end() ? 0 : entry->second;
+      return Utilities::MPI::max(local, mpi_communicator);
+    }
+
+    template <int dim>
+    double SCnsIM<dim>::cell_cost(
+      const typename DoFHandler<dim>::active_cell_iterator &cell) const
+    {
+      double cost = FluidSolver<dim>::cell_cost(cell);
+      if (sigma_pml_field->value(cell->center(), 0) > 0)
+        {
+          cost *= parameters.pml_cell_weight;
+        }
+      return cost;
+    }
+
     template <int dim>
     void SCnsIM<dim>::initialize_system()
     {
       preconditioner.reset();
-      system_matrix.clear();
-      Abs_A_matrix.clear();
-      schur_matrix.clear();
-      B2pp_matrix.clear();
-
-      BlockDynamicSparsityPattern dsp(dofs_per_block, dofs_per_block);
-      DoFTools::make_sparsity_pattern(dof_handler, dsp, nonzero_constraints);
-      sparsity_pattern.copy_from(dsp);
-      SparsityTools::distribute_sparsity_pattern(
-        dsp,
-        dof_handler.locally_owned_dofs_per_processor(),
-        mpi_communicator,
-        locally_relevant_dofs);
-
-      system_matrix.reinit(owned_partitioning, dsp, mpi_communicator);
-      Abs_A_matrix.reinit(owned_partitioning[0],
-                          owned_partitioning[0],
-                          dsp.block(0, 0),
-                          mpi_communicator);
-
-      // Compute the sparsity pattern for mass schur in advance.
-      // The only nonzero block is (1, 1), which is the same as \f$BB^T\f$.
-      DynamicSparsityPattern schur_dsp(dofs_per_block[1], dofs_per_block[1]);
-      schur_dsp.compute_mmult_pattern(sparsity_pattern.block(1, 0),
-                                      sparsity_pattern.block(0, 1));
-
-      // Compute the pattern for B2pp perconditioner
-      for (auto itr = sparsity_pattern.block(1, 1).begin();
-           itr != sparsity_pattern.block(1, 1).end();
-           ++itr)
-        {
-          schur_dsp.add(itr->row(), itr->column());
-        }
-
-      B2pp_matrix.reinit(owned_partitioning[1],
-                         owned_partitioning[1],
-                         schur_dsp,
-                         mpi_communicator);
-      schur_matrix.reinit(owned_partitioning[1],
-                          owned_partitioning[1],
-                          schur_dsp,
-                          mpi_communicator);
+      rebuild_preconditioner = true;
+      constant_matrix_timestep = numbers::invalid_unsigned_int;
+      if (pressure_pc.select(dof_handler.n_dofs(),
+                             dim,
+                             Utilities::MPI::n_mpi_processes(mpi_communicator)))
+        {
+          pcout << " PRESSURE_PC = " << pressure_pc.get() << std::endl;
+        }
+      recycle_U.clear();
+      recycle_C.clear();
+
+      if (system_layout_changed())
+        {
+          system_matrix.clear();
+          constant_matrix.clear();
+          Abs_A_matrix.clear();
+          schur_matrix.clear();
+          B2pp_matrix.clear();
+
+          BlockDynamicSparsityPattern dsp(dofs_per_block, dofs_per_block);
+          DoFTools::make_sparsity_pattern(
+            dof_handler, dsp, nonzero_constraints);
+
+          // Compute the sparsity pattern for mass schur in advance.
+          // The only nonzero block is (1, 1), which is the same as
+          // \f$BB^T\f$.
+          DynamicSparsityPattern schur_dsp(dofs_per_block[1],
+                                           dofs_per_block[1]);
+          schur_dsp.compute_mmult_pattern(dsp.block(1, 0), dsp.block(0, 1));
+
+          // Compute the pattern for B2pp perconditioner, only the relevant
+          // rows have entries.
+          const DynamicSparsityPattern &pp_dsp = dsp.block(1, 1);
+          std::vector<types::global_dof_index> columns;
+          for (const auto row : relevant_partitioning[1])
+            {
+              columns.resize(pp_dsp.row_length(row));
+              for (unsigned int i = 0; i < columns.size(); ++i)
+                {
+                  columns[i] = pp_dsp.column_number(row, i);
+                }
+              schur_dsp.add_entries(row, columns.begin(), columns.end(), true);
+            }
+
+          SparsityTools::distribute_sparsity_pattern(
+            dsp,
+            dof_handler.locally_owned_dofs_per_processor(),
+            mpi_communicator,
+            locally_relevant_dofs);
+
+          system_matrix.reinit(owned_partitioning, dsp, mpi_communicator);
+          constant_matrix.reinit(owned_partitioning, dsp, mpi_communicator);
+          Abs_A_matrix.reinit(owned_partitioning[0],
+                              owned_partitioning[0],
+                              dsp.block(0, 0),
+                              mpi_communicator);
+          B2pp_matrix.reinit(owned_partitioning[1],
+                             owned_partitioning[1],
+                             schur_dsp,
+                             mpi_communicator);
+          schur_matrix.reinit(owned_partitioning[1],
+                              owned_partitioning[1],
+                              schur_dsp,
+                              mpi_communicator);
+        }
+      else
+        {
+          // Same dofs and constraints, keep the matrices.
+          system_matrix = 0;
+          constant_matrix = 0;
+          Abs_A_matrix = 0;
+          schur_matrix = 0;
+          B2pp_matrix = 0;
+        }
 
       // present_solution is ghosted because it is used in the
       // output and mesh refinement functions.
@@ -265,46 +490,118 @@ namespace Fluid
       // system_rhs is non-ghosted because it is only used in the linear
       // solver and residual evaluation.
       system_rhs.reinit(owned_partitioning, mpi_communicator);
+      workspace.resize(3);
+      for (auto &buffer : workspace)
+        {
+          buffer.reinit(owned_partitioning, mpi_communicator);
+        }
 
       // Cell property
       setup_cell_property();
-
-      stress = std::vector<std::vector<PETScWrappers::MPI::Vector>>(
-        dim,
-        std::vector<PETScWrappers::MPI::Vector>(
-          dim,
-          PETScWrappers::MPI::Vector(locally_owned_scalar_dofs,
-                                     mpi_communicator)));
+      setup_coefficients();
 
       // Hard-coded initial condition, only for VF cases!
       apply_initial_condition();
+      print_memory_report();
+    }
+
+    template <int dim>
+    void SCnsIM<dim>::add_memory(Utils::MemoryReport &report) const
+    {
+      FluidSolver<dim>::add_memory(report);
+      report.add("Fluid constant_matrix", constant_matrix);
+      report.add("Fluid Abs_A_matrix", Abs_A_matrix);
+      report.add("Fluid schur_matrix", schur_matrix);
+      report.add("Fluid B2pp_matrix", B2pp_matrix);
+      double vectors = newton_update.memory_consumption() +
+                       evaluation_point.memory_consumption();
+      for (const auto &v : recycle_U)
+        {
+          vectors += v.memory_consumption();
+        }
+      for (const auto &v : recycle_C)
+        {
+          vectors += v.memory_consumption();
+        }
+      report.add("Fluid vectors", vectors);
+      report.add(
+        "Fluid cell coefficients",
+        MemoryConsumption::memory_consumption(coefficient_points) +
+          MemoryConsumption::memory_consumption(coefficient_offsets) +
+          MemoryConsumption::memory_consumption(sigma_pml_values) +
+          MemoryConsumption::memory_consumption(body_force_values));
+    }
+
+    template <int dim>
+    void SCnsIM<dim>::setup_coefficients()
+    {
+      const unsigned int n_q_points = volume_quad_formula.size();
+      FEValues<dim> fe_values(
+        fe, volume_quad_formula, update_quadrature_points);
+      coefficient_points.clear();
+      coefficient_offsets.assign(triangulation.n_active_cells(),
+                                 numbers::invalid_unsigned_int);
+      for (auto cell = dof_handler.begin_active(); cell != dof_handler.end();
+           ++cell)
+        {
+          if (cell->is_locally_owned())
+            {
+              coefficient_offsets[cell->active_cell_index()] =
+                coefficient_points.size();
+              fe_values.reinit(cell);
+              coefficient_points.insert(
+                coefficient_points.end(),
+                fe_values.get_quadrature_points().begin(),
+                fe_values.get_quadrature_points().end());
+            }
+        }
+      Assert(coefficient_points.size() ==
+               n_q_points * triangulation.n_locally_owned_active_cells(),
+             ExcInternalError());
+      (void)n_q_points;
+      sigma_pml_values.resize(coefficient_points.size());
+      sigma_pml_field->value_list(coefficient_points, sigma_pml_values, 0);
+      body_force_values.resize(coefficient_points.size());
+      body_force->value_list(coefficient_points, body_force_values);
+      body_force_time = body_force->get_time();
     }
 
     template <int dim>
     void SCnsIM<dim>::assemble(const bool use_nonzero_constraints)
     {
-      TimerOutput::Scope timer_section(timer, "Assemble system");
+      Utils::ProfilingScope timer_section(timer, "Assemble system");
 
       Tensor<1, dim> gravity;
       for (unsigned int i = 0; i < dim; ++i)
         gravity[i] = parameters.gravity[i];
 
-      system_matrix = 0;
-      Abs_A_matrix = 0;
-      schur_matrix = 0;
-      B2pp_matrix = 0;
+      // The constant part of the matrix is assembled once per time step.
+      // With nonzero constraints the full cell matrices are needed to apply
+      // the inhomogeneities, so it is added to the cell matrices instead.
+      const bool update_constant_matrix =
+        constant_matrix_timestep != time.get_timestep();
+      const bool assemble_constant_part =
+        update_constant_matrix || use_nonzero_constraints;
 
+      system_matrix = 0;
+      if (update_constant_matrix)
+        {
+          constant_matrix = 0;
+        }
       system_rhs = 0;
 
-      FEValues<dim> fe_values(fe,
-                              volume_quad_formula,
-                              update_values | update_quadrature_points |
-                                update_JxW_values | update_gradients);
-      FEFaceValues<dim> fe_face_values(fe,
-                                       face_quad_formula,
-                                       update_values | update_normal_vectors |
-                                         update_quadrature_points |
-                                         update_JxW_values);
+      // Only a time-dependent body force has to be evaluated again.
+      if (body_force->get_time() != body_force_time)
+        {
+          body_force->value_list(coefficient_points, body_force_values);
+          body_force_time = body_force->get_time();
+        }
+
+      const UpdateFlags flags = update_values | update_quadrature_points |
+                                update_JxW_values | update_gradients;
+      const UpdateFlags face_flags = update_values | update_normal_vectors |
+                                     update_quadrature_points |
+                                     update_JxW_values;
 
       const unsigned int dofs_per_cell = fe.dofs_per_cell;
       const unsigned int u_dofs = fe.base_element(0).dofs_per_cell;
@@ -318,31 +615,18 @@ namespace Fluid
       const FEValuesExtractors::Vector velocities(0);
       const FEValuesExtractors::Scalar pressure(dim);
 
-      FullMatrix<double> local_matrix(dofs_per_cell, dofs_per_cell);
-      Vector<double> local_rhs(dofs_per_cell);
-
-      std::vector<types::global_dof_index> local_dof_indices(dofs_per_cell);
-
-      // For the linearized system, we create temporary storage for current
-      // velocity
-      // and gradient, current pressure, and present velocity. In practice, they
-      // are
-      // all obtained through their shape functions at quadrature points.
-
-      std::vector<Tensor<1, dim>> current_velocity_values(n_q_points);
-      std::vector<Tensor<2, dim>> current_velocity_gradients(n_q_points);
-      std::vector<double> current_pressure_values(n_q_points);
-      std::vector<Tensor<1, dim>> current_pressure_gradients(n_q_points);
-      std::vector<Tensor<1, dim>> present_velocity_values(n_q_points);
-      std::vector<double> present_pressure_values(n_q_points);
-      std::vector<double> sigma_pml(n_q_points);
-      std::vector<Tensor<1, dim>> artificial_bf(n_q_points);
-
-      std::vector<double> div_phi_u(dofs_per_cell);
-      std::vector<Tensor<1, dim>> phi_u(dofs_per_cell);
-      std::vector<Tensor<2, dim>> grad_phi_u(dofs_per_cell);
-      std::vector<double> phi_p(dofs_per_cell);
-      std::vector<Tensor<1, dim>> grad_phi_p(dofs_per_cell);
+      // The component of every shape function, and the local velocity and
+      // pressure dofs.
+      std::vector<unsigned int> component(dofs_per_cell);
+      std::vector<unsigned int> velocity_dofs, pressure_dofs;
+      for (unsigned int k = 0; k < dofs_per_cell; ++k)
+        {
+          component[k] = fe.system_to_component_index(k).first;
+          if (component[k] < dim)
+            velocity_dofs.push_back(k);
+          else
+            pressure_dofs.push_back(k);
+        }
 
       // The parameters that is used in isentropic continuity equation:
       // heat capacity ratio and atmospheric pressure.
@@ -350,391 +634,675 @@ namespace Fluid
       const double atm = 1013250;
       const double kappa_s = 1e4;
 
-      for (auto cell = dof_handler.begin_active(); cell != dof_handler.end();
-           ++cell)
-        {
-          if (cell->is_locally_owned())
+      auto assemble_cell =
+        [&](const typename DoFHandler<dim>::active_cell_iterator &cell,
+            Utils::AssemblyScratch<dim> &scratch,
+            Utils::AssemblyCopy &copy) {
+          FEValues<dim> &fe_values = scratch.fe_values;
+          FEFaceValues<dim> &fe_face_values = scratch.fe_face_values;
+          FullMatrix<double> &local_matrix = copy.cell_matrix;
+          FullMatrix<double> &local_constant_matrix = copy.cell_matrix2;
+          Vector<double> &local_rhs = copy.cell_rhs;
+          std::vector<types::global_dof_index> &local_dof_indices =
+            copy.local_dof_indices;
+
+          // For the linearized system, we create temporary storage for
+          // current velocity and gradient, current pressure, and present
+          // velocity. In practice, they are all obtained through their shape
+          // functions at quadrature points.
+          std::vector<Tensor<1, dim>> &current_velocity_values =
+            scratch.current_velocity_values;
+          std::vector<Tensor<2, dim>> &current_velocity_gradients =
+            scratch.current_velocity_gradients;
+          std::vector<double> &current_pressure_values =
+            scratch.current_pressure_values;
+          std::vector<Tensor<1, dim>> &current_pressure_gradients =
+            scratch.current_pressure_gradients;
+          std::vector<Tensor<1, dim>> &present_velocity_values =
+            scratch.present_velocity_values;
+          std::vector<double> &present_pressure_values =
+            scratch.present_pressure_values;
+
+          std::vector<double> &div_phi_u = scratch.div_phi_u;
+          std::vector<Tensor<1, dim>> &phi_u = scratch.phi_u;
+          std::vector<Tensor<2, dim>> &grad_phi_u = scratch.grad_phi_u;
+          std::vector<double> &phi_p = scratch.phi_p;
+          std::vector<Tensor<1, dim>> &grad_phi_p = scratch.grad_phi_p;
+
+          // Contractions of the shape functions with the current solution.
+          std::vector<Tensor<1, dim>> &w_grad_phi_u = scratch.w_grad_phi_u;
+          std::vector<double> &w_grad_phi_p = scratch.w_grad_phi_p;
+          std::vector<double> &phi_u_grad_p = scratch.phi_u_grad_p;
+          std::vector<Tensor<1, dim>> &convection_phi_u =
+            scratch.convection_phi_u;
+          std::vector<Tensor<1, dim>> &supg_phi_u = scratch.supg_phi_u;
+
+          const unsigned int cell_index = cell->active_cell_index();
+          const SymmetricTensor<2, dim> fsi_stress =
+            cell_property.get_fsi_stress(cell_index);
+          const Tensor<1, dim> fsi_acceleration =
+            cell_property.get_fsi_acceleration(cell_index);
+          const int ind = cell_property.get_indicator(cell_index);
+
+          local_matrix = 0;
+          local_constant_matrix = 0;
+          local_rhs = 0;
+
+          // An inactive cell only contributes the diagonal entries of its
+          // constrained dofs, scaled like the velocity mass of the solid.
+          if (cell_property.is_inactive(cell_index))
             {
-              auto p = cell_property.get_data(cell);
-              const int ind = p[0]->indicator;
-
-              fe_values.reinit(cell);
+              cell->get_dof_indices(local_dof_indices);
+              const double diagonal =
+                parameters.solid_rho * cell->measure() / time.get_delta_t();
+              for (unsigned int i = 0; i < dofs_per_cell; ++i)
+                {
+                  if (zero_constraints.is_constrained(local_dof_indices[i]))
+                    {
+                      local_matrix(i, i) = diagonal;
+                      local_constant_matrix(i, i) = diagonal;
+                    }
+                }
+              return;
+            }
 
-              local_matrix = 0;
-              local_rhs = 0;
+          fe_values.reinit(cell);
 
-              fe_values[velocities].get_function_values(
-                evaluation_point, current_velocity_values);
+          fe_values[velocities].get_function_values(
+            assembly_evaluation_point, current_velocity_values);
 
-              fe_values[velocities].get_function_gradients(
-                evaluation_point, current_velocity_gradients);
+          fe_values[velocities].get_function_gradients(
+            assembly_evaluation_point, current_velocity_gradients);
 
-              fe_values[pressure].get_function_values(evaluation_point,
-                                                      current_pressure_values);
+          fe_values[pressure].get_function_values(assembly_evaluation_point,
+                                                  current_pressure_values);
 
-              fe_values[pressure].get_function_gradients(
-                evaluation_point, current_pressure_gradients);
+          fe_values[pressure].get_function_gradients(
+            assembly_evaluation_point, current_pressure_gradients);
 
-              fe_values[velocities].get_function_values(
-                present_solution, present_velocity_values);
+          fe_values[velocities].get_function_values(
+            assembly_present_solution, present_velocity_values);
 
-              fe_values[pressure].get_function_values(present_solution,
-                                                      present_pressure_values);
+          fe_values[pressure].get_function_values(assembly_present_solution,
+                                                  present_pressure_values);
 
-              sigma_pml_field->value_list(
-                fe_values.get_quadrature_points(), sigma_pml, 0);
-              body_force->value_list(fe_values.get_quadrature_points(),
-                                     artificial_bf);
+          // The coefficients were evaluated for the whole subdomain.
+          const unsigned int offset =
+            coefficient_offsets[cell->active_cell_index()];
+          const double *sigma_pml = &sigma_pml_values[offset];
+          const Tensor<1, dim> *artificial_bf = &body_force_values[offset];
 
-              for (unsigned int q = 0; q < n_q_points; ++q)
+          for (unsigned int q = 0; q < n_q_points; ++q)
+            {
+              const double rho = parameters.fluid_rho *
+                                   (1 + present_pressure_values[q] / atm) *
+                                   (1 - ind) +
+                                 ind * parameters.solid_rho;
+              const double viscosity =
+                (ind == 1 ? 1 : parameters.viscosity);
+
+              // The finite element is primitive, so every shape function
+              // is nonzero in only one component. This avoids the
+              // overhead of the extractors.
+              for (unsigned int k = 0; k < dofs_per_cell; ++k)
                 {
-                  const double rho = parameters.fluid_rho *
-                                       (1 + present_pressure_values[q] / atm) *
-                                       (1 - ind) +
-                                     ind * parameters.solid_rho;
-                  const double viscosity =
-                    (ind == 1 ? 1 : parameters.viscosity);
-
-                  for (unsigned int k = 0; k < dofs_per_cell; ++k)
+                  const unsigned int c = component[k];
+                  phi_u[k] = 0;
+                  grad_phi_u[k] = 0;
+                  div_phi_u[k] = 0;
+                  phi_p[k] = 0;
+                  grad_phi_p[k] = 0;
+                  if (c < dim)
                     {
-                      div_phi_u[k] = fe_values[velocities].divergence(k, q);
-                      grad_phi_u[k] = fe_values[velocities].gradient(k, q);
-                      phi_u[k] = fe_values[velocities].value(k, q);
-                      phi_p[k] = fe_values[pressure].value(k, q);
-                      grad_phi_p[k] = fe_values[pressure].gradient(k, q);
+                      phi_u[k][c] = fe_values.shape_value(k, q);
+                      grad_phi_u[k][c] = fe_values.shape_grad(k, q);
+                      div_phi_u[k] = grad_phi_u[k][c][c];
                     }
-
-                  // Define the UGN based SUPG parameters (Tezduyar):
-                  // tau_SUPG and tau_PSPG. They are
-                  // evaluated based on the results from the last Newton
-                  // iteration.
-                  double tau_SUPG, tau_PSPG, tau_LSIC;
-                  // the length scale h is the length of the element in the
-                  // direction
-                  // of convection
-                  double h = 0;
-                  for (unsigned int a = 0;
-                       a < dofs_per_cell / fe.dofs_per_vertex;
-                       ++a)
+                  else
                     {
-                      h += abs(present_velocity_values[q] *
-                               fe_values.shape_grad(a, q));
+                      phi_p[k] = fe_values.shape_value(k, q);
+                      grad_phi_p[k] = fe_values.shape_grad(k, q);
                     }
-                  if (h)
-                    h = 2 * present_velocity_values[q].norm() / h;
-                  else
-                    h = 0;
-                  double nu = viscosity / rho;
-                  double v_norm = present_velocity_values[q].norm();
-                  if (h)
-                    tau_SUPG = 1 / sqrt((pow(2 / time.get_delta_t(), 2) +
-                                         pow(2 * v_norm / h, 2) +
-                                         pow(4 * nu / pow(h, 2), 2)));
-                  else
-                    tau_SUPG = time.get_delta_t() / 2;
-                  tau_PSPG = tau_SUPG / rho;
-                  double localRe = v_norm * h / (2 * nu);
-                  double z = localRe <= 3 ? (localRe / 3) : 1;
-                  tau_LSIC = h / 2 * v_norm * z;
+                }
 
-                  for (unsigned int i = 0; i < dofs_per_cell; ++i)
+              // Define the UGN based SUPG parameters (Tezduyar):
+              // tau_SUPG and tau_PSPG. They are
+              // evaluated based on the results from the last Newton
+              // iteration.
+              double tau_SUPG, tau_PSPG, tau_LSIC;
+              // the length scale h is the length of the element in the
+              // direction
+              // of convection
+              double h = 0;
+              for (unsigned int a = 0;
+                   a < dofs_per_cell / fe.dofs_per_vertex;
+                   ++a)
+                {
+                  h += abs(present_velocity_values[q] *
+                           fe_values.shape_grad(a, q));
+                }
+              if (h)
+                h = 2 * present_velocity_values[q].norm() / h;
+              else
+                h = 0;
+              double nu = viscosity / rho;
+              double v_norm = present_velocity_values[q].norm();
+              if (h)
+                tau_SUPG = 1 / sqrt((pow(2 / time.get_delta_t(), 2) +
+                                     pow(2 * v_norm / h, 2) +
+                                     pow(4 * nu / pow(h, 2), 2)));
+              else
+                tau_SUPG = time.get_delta_t() / 2;
+              tau_PSPG = tau_SUPG / rho;
+              double localRe = v_norm * h / (2 * nu);
+              double z = localRe <= 3 ? (localRe / 3) : 1;
+              tau_LSIC = h / 2 * v_norm * z;
+
+              // The LHS consists of the linearized diffusion, continuity
+              // terms: the bilinear operator \f$A = a((\delta{u},
+              // \delta{p}), (\delta{v}, \delta{q}))\f$, the linearized
+              // convection term \f$C = c(u;\delta{u}, \delta{v})\f$, the
+              // linearized inertial term \f$M = m(\delta{u},
+              // \delta{v})\f$, the PML attenuation, and the SUPG, PSPG and
+              // LSIC stabilization. The continuity equation is written
+              // from the strong form
+              // \f$p_{,t} + \frac{C_p}{C_v} * (p_0 + p) * (\nabla
+              // \times u) + u (\nabla p) = 0\f$.
+              //
+              // The terms are grouped by the velocity and pressure blocks,
+              // and the contractions that only depend on one of the test
+              // and trial functions are computed once per quadrature
+              // point instead of once per pair of shape functions.
+              const double dt = time.get_delta_t();
+              const double JxW = fe_values.JxW(q);
+              const double current_velocity_divergence =
+                trace(current_velocity_gradients[q]);
+              // The strong momentum residual seen by the SUPG test
+              // function, apart from the body force.
+              const Tensor<1, dim> supg_residual =
+                rho * (current_velocity_values[q] *
+                       current_velocity_gradients[q]) +
+                rho *
+                  (current_velocity_values[q] -
+                   present_velocity_values[q]) /
+                  dt +
+                current_pressure_gradients[q] +
+                rho * sigma_pml[q] * current_velocity_values[q];
+              for (unsigned int k = 0; k < dofs_per_cell; ++k)
+                {
+                  w_grad_phi_u[k] =
+                    current_velocity_values[q] * grad_phi_u[k];
+                  w_grad_phi_p[k] =
+                    current_velocity_values[q] * grad_phi_p[k];
+                  phi_u_grad_p[k] =
+                    phi_u[k] * current_pressure_gradients[q];
+                  convection_phi_u[k] =
+                    grad_phi_u[k] * current_velocity_values[q] +
+                    current_velocity_gradients[q] * phi_u[k];
+                  supg_phi_u[k] =
+                    phi_u[k] * current_velocity_gradients[q] +
+                    w_grad_phi_u[k] + (1 / dt + sigma_pml[q]) * phi_u[k];
+                }
+
+              const double velocity_mass = rho * (1 / dt + sigma_pml[q]);
+              const double lsic_divergence =
+                tau_LSIC * rho * cp_to_cv *
+                (1 + current_pressure_values[q] * (1 - ind) / atm);
+              const double lsic_gradient = tau_LSIC * rho * (1 - ind) / atm;
+              const double lsic_pressure =
+                tau_LSIC * rho *
+                ((1 - ind) / (atm * dt) + ind / (kappa_s * dt) +
+                 cp_to_cv * (1 - ind) * current_velocity_divergence / atm);
+              const double continuity_divergence =
+                cp_to_cv * (atm + current_pressure_values[q] * (1 - ind)) /
+                atm;
+              const double continuity = (1 - ind) / atm;
+              const double pressure_mass = sigma_pml[q] / atm +
+                                           continuity / dt +
+                                           ind / (kappa_s * dt);
+              const double pressure_divergence =
+                continuity * current_velocity_divergence;
+
+              // The viscous, pressure gradient and mass terms only depend on
+              // the present solution, they go into the constant part.
+              if (assemble_constant_part)
+                {
+                  for (const unsigned int i : velocity_dofs)
+                    {
+                      for (const unsigned int j : velocity_dofs)
+                        {
+                          local_constant_matrix(i, j) +=
+                            (viscosity *
+                               scalar_product(grad_phi_u[j], grad_phi_u[i]) +
+                             velocity_mass * (phi_u[i] * phi_u[j])) *
+                            JxW;
+                        }
+                      for (const unsigned int j : pressure_dofs)
+                        {
+                          local_constant_matrix(i, j) -=
+                            div_phi_u[i] * phi_p[j] * JxW;
+                        }
+                    }
+                  for (const unsigned int i : pressure_dofs)
                     {
-                      double current_velocity_divergence =
-                        trace(current_velocity_gradients[q]);
-                      for (unsigned int j = 0; j < dofs_per_cell; ++j)
+                      for (const unsigned int j : pressure_dofs)
                         {
-                          // Let the linearized diffusion, continuity
-                          // terms be written as
-                          // the bilinear operator: \f$A = a((\delta{u},
-                          // \delta{p}), (\delta{v}, \delta{q}))\f$,
-                          // the linearized convection term be: \f$C =
-                          // c(u;\delta{u}, \delta{v})\f$,
-                          // and the linearized inertial term be:
-                          // \f$M = m(\delta{u}, \delta{v})$, then LHS is: $(A
-                          // +
-                          // C) + M/{\Delta{t}}\f$
-                          local_matrix(i, j) +=
-                            ((viscosity *
-                                scalar_product(grad_phi_u[j], grad_phi_u[i]) +
-                              rho * current_velocity_gradients[q] * phi_u[j] *
-                                phi_u[i] +
-                              rho * grad_phi_u[j] * current_velocity_values[q] *
-                                phi_u[i] -
-                              div_phi_u[i] * phi_p[j]) +
-                             rho * phi_u[i] * phi_u[j] / time.get_delta_t()) *
-                            fe_values.JxW(q);
-                          // PML attenuation
-                          local_matrix(i, j) +=
-                            (rho * sigma_pml[q] * phi_u[j] * phi_u[i] +
-                             sigma_pml[q] * phi_p[j] * phi_p[i] / atm) *
-                            fe_values.JxW(q);
-                          // Add SUPG and PSPG stabilization
-                          local_matrix(i, j) +=
-                            // SUPG Convection
-                            (tau_SUPG * rho *
-                               (current_velocity_values[q] * grad_phi_u[i]) *
-                               (phi_u[j] * current_velocity_gradients[q]) +
-                             tau_SUPG * rho *
-                               (current_velocity_values[q] * grad_phi_u[i]) *
-                               (current_velocity_values[q] * grad_phi_u[j]) +
-                             tau_SUPG * rho * (phi_u[j] * grad_phi_u[i]) *
-                               (current_velocity_values[q] *
-                                current_velocity_gradients[q]) +
-                             // SUPG Acceleration
-                             tau_SUPG * rho * current_velocity_values[q] *
-                               grad_phi_u[i] * phi_u[j] / time.get_delta_t() +
-                             tau_SUPG * rho * phi_u[j] * grad_phi_u[i] *
-                               (current_velocity_values[q] -
-                                present_velocity_values[q]) /
-                               time.get_delta_t() +
-                             // SUPG Pressure
-                             tau_SUPG * current_velocity_values[q] *
-                               grad_phi_u[i] * grad_phi_p[j] +
-                             tau_SUPG * phi_u[j] * grad_phi_u[i] *
-                               current_pressure_gradients[q] +
-                             // SUPG PML
-                             tau_SUPG * rho * current_velocity_values[q] *
-                               grad_phi_u[i] * sigma_pml[q] * phi_u[j] +
-                             tau_SUPG * rho * phi_u[j] * grad_phi_u[i] *
-                               sigma_pml[q] * current_velocity_values[q] +
-                             // PSPG Convection
-                             tau_PSPG * rho * grad_phi_p[i] *
-                               (phi_u[j] * current_velocity_gradients[q]) +
-                             tau_PSPG * rho * grad_phi_p[i] *
-                               (current_velocity_values[q] * grad_phi_u[j]) +
-                             // PSPG Acceleration
-                             tau_PSPG * rho * grad_phi_p[i] * phi_u[j] /
-                               time.get_delta_t() +
-                             // PSPG Pressure
-                             tau_PSPG * grad_phi_p[i] * grad_phi_p[j] +
-                             // PSPG PML
-                             tau_PSPG * rho * grad_phi_p[i] * sigma_pml[q] *
-                               phi_u[j] +
-                             // LSIC acceleration
-                             tau_LSIC * rho * div_phi_u[i] * phi_p[j] /
-                               time.get_delta_t() * (1 - ind) / atm +
-                             // LSIC bulk acceleration in artificial fluid
-                             tau_LSIC * rho * 1 / kappa_s * div_phi_u[i] *
-                               phi_p[j] / time.get_delta_t() * ind +
-                             // LSIC velocity divergence
-                             tau_LSIC * rho * cp_to_cv * div_phi_u[i] *
-                               div_phi_u[j] +
-                             tau_LSIC * rho * cp_to_cv * div_phi_u[i] *
-                               current_pressure_values[q] * (1 - ind) *
-                               div_phi_u[j] / atm +
-                             tau_LSIC * rho * cp_to_cv * div_phi_u[i] *
-                               phi_p[j] * (1 - ind) *
-                               current_velocity_divergence / atm +
-                             // LSIC pressure gradients
-                             tau_LSIC * rho * div_phi_u[i] *
-                               current_velocity_values[q] * grad_phi_p[j] /
-                               atm * (1 - ind) +
-                             tau_LSIC * rho * div_phi_u[i] * phi_u[j] *
-                               current_pressure_gradients[q] / atm *
-                               (1 - ind)) *
-                            fe_values.JxW(q);
-                          // For more clear demonstration, write continuity
-                          // equation
-                          // separately.
-                          // The original strong form is:
-                          // \f$p_{,t} + \frac{C_p}{C_v} * (p_0 + p) * (\nabla
-                          // \times u) + u (\nabla p) = 0\f$
-                          local_matrix(i, j) +=
-                            (cp_to_cv *
-                               (atm + current_pressure_values[q] * (1 - ind)) *
-                               div_phi_u[j] * phi_p[i] +
-                             phi_p[j] * current_velocity_divergence * phi_p[i] *
-                               (1 - ind) +
-                             current_velocity_values[q] * grad_phi_p[j] *
-                               phi_p[i] * (1 - ind) +
-                             phi_u[j] * current_pressure_gradients[q] *
-                               phi_p[i] * (1 - ind) +
-                             phi_p[i] * phi_p[j] / time.get_delta_t() *
-                               (1 - ind)) /
-                              atm * fe_values.JxW(q) +
-                            1 / kappa_s * phi_p[i] * phi_p[j] * ind /
-                              time.get_delta_t() * fe_values.JxW(q);
+                          local_constant_matrix(i, j) +=
+                            pressure_mass * phi_p[i] * phi_p[j] * JxW;
                         }
+                    }
+                }
 
-                      // RHS is \f$-(A_{current} + C_{current}) -
-                      // M_{present-current}/\Delta{t}\f$.
-                      local_rhs(i) +=
-                        ((-viscosity *
-                            scalar_product(current_velocity_gradients[q],
-                                           grad_phi_u[i]) -
-                          rho * current_velocity_gradients[q] *
-                            current_velocity_values[q] * phi_u[i] +
-                          current_pressure_values[q] * div_phi_u[i]) -
-                         rho *
-                           (current_velocity_values[q] -
-                            present_velocity_values[q]) *
-                           phi_u[i] / time.get_delta_t() +
-                         (gravity + artificial_bf[q]) * phi_u[i] * rho) *
-                        fe_values.JxW(q);
-                      local_rhs(i) +=
-                        -(rho * sigma_pml[q] * current_velocity_values[q] *
-                            phi_u[i] +
-                          sigma_pml[q] * current_pressure_values[q] * phi_p[i] /
-                            atm) *
-                        fe_values.JxW(q);
-                      local_rhs(i) +=
-                        -(cp_to_cv *
-                            (atm + current_pressure_values[q] * (1 - ind)) *
-                            current_velocity_divergence * phi_p[i] +
-                          current_velocity_values[q] *
-                            current_pressure_gradients[q] * phi_p[i] *
-                            (1 - ind) +
-                          (current_pressure_values[q] -
-                           present_pressure_values[q]) *
-                            phi_p[i] / time.get_delta_t() * (1 - ind)) /
-                          atm * fe_values.JxW(q) -
-                        1 / kappa_s *
-                          (current_pressure_values[q] -
-                           present_pressure_values[q]) *
-                          phi_p[i] * ind / time.get_delta_t() *
-                          fe_values.JxW(q);
-                      // Add SUPG and PSPS rhs terms.
-                      local_rhs(i) +=
-                        -((tau_SUPG * current_velocity_values[q] *
-                           grad_phi_u[i]) *
-                            (rho * ((current_velocity_values[q] -
-                                     present_velocity_values[q]) /
-                                      time.get_delta_t() +
-                                    current_velocity_values[q] *
-                                      current_velocity_gradients[q]) +
-                             current_pressure_gradients[q] -
-                             rho * (gravity + artificial_bf[q]) +
-                             rho * sigma_pml[q] * current_velocity_values[q]) +
-                          (tau_PSPG * grad_phi_p[i]) *
-                            (rho * ((current_velocity_values[q] -
-                                     present_velocity_values[q]) /
-                                      time.get_delta_t() +
-                                    current_velocity_values[q] *
-                                      current_velocity_gradients[q]) +
-                             current_pressure_gradients[q] -
-                             rho * (gravity + artificial_bf[q]) +
-                             rho * sigma_pml[q] * current_velocity_values[q])) *
-                        fe_values.JxW(q);
-                      // Add LSIC rhs terms.
+              for (const unsigned int i : velocity_dofs)
+                {
+                  const Tensor<1, dim> grad_phi_u_residual =
+                    grad_phi_u[i] * supg_residual;
+                  for (const unsigned int j : velocity_dofs)
+                    {
+                      local_matrix(i, j) +=
+                        (rho * (phi_u[i] * convection_phi_u[j]) +
+                         tau_SUPG * rho *
+                           (w_grad_phi_u[i] * supg_phi_u[j]) +
+                         tau_SUPG * (phi_u[j] * grad_phi_u_residual) +
+                         lsic_divergence * div_phi_u[i] * div_phi_u[j] +
+                         lsic_gradient * div_phi_u[i] * phi_u_grad_p[j]) *
+                        JxW;
+                    }
+                  for (const unsigned int j : pressure_dofs)
+                    {
+                      local_matrix(i, j) +=
+                        (tau_SUPG * (w_grad_phi_u[i] * grad_phi_p[j]) +
+                         lsic_pressure * div_phi_u[i] * phi_p[j] +
+                         lsic_gradient * div_phi_u[i] * w_grad_phi_p[j]) *
+                        JxW;
+                    }
+                }
+              for (const unsigned int i : pressure_dofs)
+                {
+                  for (const unsigned int j : velocity_dofs)
+                    {
+                      local_matrix(i, j) +=
+                        (tau_PSPG * rho * (grad_phi_p[i] * supg_phi_u[j]) +
+                         continuity_divergence * div_phi_u[j] * phi_p[i] +
+                         continuity * phi_u_grad_p[j] * phi_p[i]) *
+                        JxW;
+                    }
+                  for (const unsigned int j : pressure_dofs)
+                    {
+                      local_matrix(i, j) +=
+                        (tau_PSPG * (grad_phi_p[i] * grad_phi_p[j]) +
+                         pressure_divergence * phi_p[i] * phi_p[j] +
+                         continuity * w_grad_phi_p[j] * phi_p[i]) *
+                        JxW;
+                    }
+                }
+
+              for (unsigned int i = 0; i < dofs_per_cell; ++i)
+                {
+                  // RHS is \f$-(A_{current} + C_{current}) -
+                  // M_{present-current}/\Delta{t}\f$.
+                  local_rhs(i) +=
+                    ((-viscosity *
+                        scalar_product(current_velocity_gradients[q],
+                                       grad_phi_u[i]) -
+                      rho * current_velocity_gradients[q] *
+                        current_velocity_values[q] * phi_u[i] +
+                      current_pressure_values[q] * div_phi_u[i]) -
+                     rho *
+                       (current_velocity_values[q] -
+                        present_velocity_values[q]) *
+                       phi_u[i] / time.get_delta_t() +
+                     (gravity + artificial_bf[q]) * phi_u[i] * rho) *
+                    fe_values.JxW(q);
+                  local_rhs(i) +=
+                    -(rho * sigma_pml[q] * current_velocity_values[q] *
+                        phi_u[i] +
+                      sigma_pml[q] * current_pressure_values[q] * phi_p[i] /
+                        atm) *
+                    fe_values.JxW(q);
+                  local_rhs(i) +=
+                    -(cp_to_cv *
+                        (atm + current_pressure_values[q] * (1 - ind)) *
+                        current_velocity_divergence * phi_p[i] +
+                      current_velocity_values[q] *
+                        current_pressure_gradients[q] * phi_p[i] *
+                        (1 - ind) +
+                      (current_pressure_values[q] -
+                       present_pressure_values[q]) *
+                        phi_p[i] / time.get_delta_t() * (1 - ind)) /
+                      atm * fe_values.JxW(q) -
+                    1 / kappa_s *
+                      (current_pressure_values[q] -
+                       present_pressure_values[q]) *
+                      phi_p[i] * ind / time.get_delta_t() *
+                      fe_values.JxW(q);
+                  // Add SUPG and PSPS rhs terms.
+                  local_rhs(i) +=
+                    -((tau_SUPG * current_velocity_values[q] *
+                       grad_phi_u[i]) *
+                        (rho * ((current_velocity_values[q] -
+                                 present_velocity_values[q]) /
+                                  time.get_delta_t() +
+                                current_velocity_values[q] *
+                                  current_velocity_gradients[q]) +
+                         current_pressure_gradients[q] -
+                         rho * (gravity + artificial_bf[q]) +
+                         rho * sigma_pml[q] * current_velocity_values[q]) +
+                      (tau_PSPG * grad_phi_p[i]) *
+                        (rho * ((current_velocity_values[q] -
+                                 present_velocity_values[q]) /
+                                  time.get_delta_t() +
+                                current_velocity_values[q] *
+                                  current_velocity_gradients[q]) +
+                         current_pressure_gradients[q] -
+                         rho * (gravity + artificial_bf[q]) +
+                         rho * sigma_pml[q] * current_velocity_values[q])) *
+                    fe_values.JxW(q);
+                  // Add LSIC rhs terms.
+                  local_rhs(i) +=
+                    -((tau_LSIC * rho * div_phi_u[i]) *
+                        ((current_pressure_values[q] -
+                          present_pressure_values[q]) /
+                           time.get_delta_t() * (1 - ind) +
+                         cp_to_cv * atm * current_velocity_divergence +
+                         cp_to_cv * current_pressure_values[q] *
+                           current_velocity_divergence * (1 - ind) +
+                         current_velocity_values[q] *
+                           current_pressure_gradients[q] * (1 - ind)) /
+                        atm +
+                      (tau_LSIC * rho * div_phi_u[i]) *
+                        (1 / kappa_s *
+                         (current_pressure_values[q] -
+                          present_pressure_values[q]) /
+                         time.get_delta_t()) *
+                        ind) *
+                    fe_values.JxW(q);
+                  if (ind == 1)
+                    {
                       local_rhs(i) +=
-                        -((tau_LSIC * rho * div_phi_u[i]) *
-                            ((current_pressure_values[q] -
-                              present_pressure_values[q]) /
-                               time.get_delta_t() * (1 - ind) +
-                             cp_to_cv * atm * current_velocity_divergence +
-                             cp_to_cv * current_pressure_values[q] *
-                               current_velocity_divergence * (1 - ind) +
-                             current_velocity_values[q] *
-                               current_pressure_gradients[q] * (1 - ind)) /
-                            atm +
-                          (tau_LSIC * rho * div_phi_u[i]) *
-                            (1 / kappa_s *
-                             (current_pressure_values[q] -
-                              present_pressure_values[q]) /
-                             time.get_delta_t()) *
-                            ind) *
+                        (scalar_product(grad_phi_u[i], fsi_stress) +
+                         (fsi_acceleration * rho) *
+                           (phi_u[i] + tau_PSPG * grad_phi_p[i] +
+                            tau_SUPG * current_velocity_values[q] *
+                              grad_phi_u[i])) *
                         fe_values.JxW(q);
-                      if (ind == 1)
-                        {
-                          local_rhs(i) +=
-                            (scalar_product(grad_phi_u[i], p[0]->fsi_stress) +
-                             (p[0]->fsi_acceleration * rho) *
-                               (phi_u[i] + tau_PSPG * grad_phi_p[i] +
-                                tau_SUPG * current_velocity_values[q] *
-                                  grad_phi_u[i])) *
-                            fe_values.JxW(q);
-                        }
                     }
                 }
+            }
 
-              // Impose pressure boundary here if specified, loop over faces on
-              // the
-              // cell
-              // and apply pressure boundary conditions:
-              // \f$\int_{\Gamma_n} -p\bold{n}d\Gamma\f$
-              if (parameters.n_fluid_neumann_bcs != 0)
+          // Impose pressure boundary here if specified, loop over faces on
+          // the
+          // cell
+          // and apply pressure boundary conditions:
+          // \f$\int_{\Gamma_n} -p\bold{n}d\Gamma\f$
+          if (parameters.n_fluid_neumann_bcs != 0)
+            {
+              for (unsigned int face_n = 0;
+                   face_n < GeometryInfo<dim>::faces_per_cell;
+                   ++face_n)
                 {
-                  for (unsigned int face_n = 0;
-                       face_n < GeometryInfo<dim>::faces_per_cell;
-                       ++face_n)
+                  if (cell->at_boundary(face_n) &&
+                      parameters.fluid_neumann_bcs.find(
+                        cell->face(face_n)->boundary_id()) !=
+                        parameters.fluid_neumann_bcs.end())
                     {
-                      if (cell->at_boundary(face_n) &&
-                          parameters.fluid_neumann_bcs.find(
-                            cell->face(face_n)->boundary_id()) !=
-                            parameters.fluid_neumann_bcs.end())
+                      fe_face_values.reinit(cell, face_n);
+                      unsigned int p_bc_id =
+                        cell->face(face_n)->boundary_id();
+                      double boundary_values_p =
+                        parameters.fluid_neumann_bcs.at(p_bc_id);
+                      for (unsigned int q = 0; q < n_face_q_points; ++q)
                         {
-                          fe_face_values.reinit(cell, face_n);
-                          unsigned int p_bc_id =
-                            cell->face(face_n)->boundary_id();
-                          double boundary_values_p =
-                            parameters.fluid_neumann_bcs[p_bc_id];
-                          for (unsigned int q = 0; q < n_face_q_points; ++q)
+                          for (unsigned int i = 0; i < dofs_per_cell; ++i)
                             {
-                              for (unsigned int i = 0; i < dofs_per_cell; ++i)
-                                {
-                                  local_rhs(i) += -(
-                                    fe_face_values[velocities].value(i, q) *
-                                    fe_face_values.normal_vector(q) *
-                                    boundary_values_p * fe_face_values.JxW(q));
-                                }
+                              local_rhs(i) += -(
+                                fe_face_values[velocities].value(i, q) *
+                                fe_face_values.normal_vector(q) *
+                                boundary_values_p * fe_face_values.JxW(q));
                             }
                         }
                     }
                 }
+            }
 
-              cell->get_dof_indices(local_dof_indices);
+          if (use_nonzero_constraints)
+            {
+              local_matrix.add(1.0, local_constant_matrix);
+            }
 
-              const AffineConstraints<double> &constraints_used =
-                use_nonzero_constraints ? nonzero_constraints
-                                        : zero_constraints;
+          cell->get_dof_indices(local_dof_indices);
+        };
 
-              constraints_used.distribute_local_to_global(local_matrix,
-                                                          local_rhs,
-                                                          local_dof_indices,
-                                                          system_matrix,
-                                                          system_rhs,
-                                                          true);
-            }
-        }
+      const AffineConstraints<double> &constraints_used =
+        use_nonzero_constraints ? nonzero_constraints : zero_constraints;
+      auto copy_cell = [&](const Utils::AssemblyCopy &copy) {
+        constraints_used.distribute_local_to_global(copy.cell_matrix,
+                                                    copy.cell_rhs,
+                                                    copy.local_dof_indices,
+                                                    system_matrix,
+                                                    system_rhs,
+                                                    true);
+        if (update_constant_matrix)
+          {
+            zero_constraints.distribute_local_to_global(
+              copy.cell_matrix2, copy.local_dof_indices, constant_matrix);
+          }
+      };
+
+      Utils::AssemblyCopy copy_data;
+      copy_data.cell_matrix.reinit(dofs_per_cell, dofs_per_cell);
+      copy_data.cell_matrix2.reinit(dofs_per_cell, dofs_per_cell);
+      copy_data.cell_rhs.reinit(dofs_per_cell);
+      copy_data.local_dof_indices.resize(dofs_per_cell);
+
+      // The interior cells only read the locally owned values of the
+      // evaluation point, so they are assembled while its ghost values are
+      // still on the way.
+      using CellIterator = typename std::vector<
+        typename DoFHandler<dim>::active_cell_iterator>::const_iterator;
+      auto assemble_listed_cell = [&](const CellIterator &cell,
+                                      Utils::AssemblyScratch<dim> &scratch,
+                                      Utils::AssemblyCopy &copy) {
+        assemble_cell(*cell, scratch, copy);
+      };
+      const Utils::AssemblyScratch<dim> scratch(
+        fe, volume_quad_formula, flags, face_quad_formula, face_flags);
+      Utils::copy_ghosted_vector(
+        evaluation_point, assembly_evaluation_point, true, false);
+      Utils::copy_ghosted_vector(present_solution, assembly_present_solution);
+      WorkStream::run(interior_cells.cbegin(),
+                      interior_cells.cend(),
+                      assemble_listed_cell,
+                      copy_cell,
+                      scratch,
+                      copy_data);
+      evaluation_point_update.finish();
+      Utils::copy_ghosted_vector(
+        evaluation_point, assembly_evaluation_point, false, true);
+      WorkStream::run(ghost_adjacent_cells.cbegin(),
+                      ghost_adjacent_cells.cend(),
+                      assemble_listed_cell,
+                      copy_cell,
+                      scratch,
+                      copy_data);
 
       system_matrix.compress(VectorOperation::add);
       system_rhs.compress(VectorOperation::add);
+      if (update_constant_matrix)
+        {
+          constant_matrix.compress(VectorOperation::add);
+          constant_matrix_timestep = time.get_timestep();
+        }
+      if (!use_nonzero_constraints)
+        {
+          system_matrix.add(1.0, constant_matrix);
+        }
     }
 
     template <int dim>
     std::pair<unsigned int, double>
-    SCnsIM<dim>::solve(const bool use_nonzero_constraints)
+    SCnsIM<dim>::solve(const bool use_nonzero_constraints,
+                       const double relative_tolerance)
     {
       // This section includes the work done in the preconditioner
       // and GMRES solver.
-      TimerOutput::Scope timer_section(timer, "Solve linear system");
-      preconditioner.reset(
-        new BlockIncompSchurPreconditioner(timer2,
-                                           owned_partitioning,
-                                           system_matrix,
-                                           Abs_A_matrix,
-                                           schur_matrix,
-                                           B2pp_matrix));
+      Utils::ProfilingScope timer_section(timer, "Solve linear system");
+      if (!preconditioner || rebuild_preconditioner)
+        {
+          // The preconditioner accumulates into these matrices.
+          Abs_A_matrix = 0;
+          schur_matrix = 0;
+          B2pp_matrix = 0;
+          const bool pipelined =
+            parameters.fluid_krylov_variant == "Pipelined";
+          preconditioner.reset(new BlockIncompSchurPreconditioner(
+            timer2,
+            owned_partitioning,
+            system_matrix,
+            Abs_A_matrix,
+            schur_matrix,
+            B2pp_matrix,
+            workspace,
+            pressure_pc.get(),
+            euclid_data,
+            pilut_data,
+            pipelined,
+            parameters.fluid_schur_approximation));
+          n_preconditioner_builds++;
+        }
+      else
+        {
+          // Lagged preconditioner: the factorizations of the old system are
+          // reused with the new system matrix.
+          preconditioner->Erase_Tpp_count();
+          n_preconditioner_reuses++;
+        }
+      // A loose outer solve does not need an accurate Schur complement.
+      preconditioner->set_Tpp_tolerance(
+        std::min(0.1, std::max(1e-3, relative_tolerance)));
 
       SolverControl solver_control(
-        system_matrix.m(), 1e-6 * system_rhs.l2_norm(), true);
-
-      // Because PETScWrappers::SolverGMRES requires preconditioner derived
-      // from PETScWrappers::PreconditionBase, we use dealii SolverFGMRES.
-      GrowingVectorMemory<PETScWrappers::MPI::BlockVector> vector_memory;
-      SolverFGMRES<PETScWrappers::MPI::BlockVector> gmres(solver_control,
-                                                          vector_memory);
+        system_matrix.m(), relative_tolerance * system_rhs.l2_norm(), true);
 
-      // The solution vector must be non-ghosted
-      gmres.solve(system_matrix, newton_update, system_rhs, *preconditioner);
+      if (parameters.fluid_recycle_vectors > 0)
+        {
+          solve_recycled(solver_control);
+        }
+      else
+        {
+          // Because PETScWrappers::SolverGMRES requires preconditioner derived
+          // from PETScWrappers::PreconditionBase, we use dealii SolverFGMRES.
+          SolverFGMRES<PETScWrappers::MPI::BlockVector> gmres(solver_control,
+                                                              vector_memory);
+
+          // The solution vector must be non-ghosted
+          gmres.solve(
+            system_matrix, newton_update, system_rhs, *preconditioner);
+        }
 
       const AffineConstraints<double> &constraints_used =
         use_nonzero_constraints ? nonzero_constraints : zero_constraints;
       constraints_used.distribute(newton_update);
 
+      // Decide whether the preconditioner can be used for the next solve.
+      const unsigned int outer_limit = parameters.fluid_pc_rebuild_iterations;
+      const unsigned int inner_limit =
+        parameters.fluid_pc_rebuild_inner_iterations;
+      rebuild_preconditioner =
+        outer_limit == 0 || solver_control.last_step() > outer_limit ||
+        (inner_limit > 0 &&
+         static_cast<unsigned int>(preconditioner->get_Tpp_itr_count()) >
+           inner_limit);
+      // The policy sees the Tpp iterations per outer iteration.
+      if (pressure_pc.record(preconditioner->get_Tpp_itr_count() /
+                             std::max(1u, solver_control.last_step())))
+        {
+          pcout << " PRESSURE_PC = " << pressure_pc.get() << std::endl;
+          rebuild_preconditioner = true;
+        }
+
+      linear_iterations += solver_control.last_step();
       return {solver_control.last_step(), solver_control.last_value()};
     }
 
+    template <int dim>
+    void SCnsIM<dim>::solve_recycled(SolverControl &solver_control)
+    {
+      update_recycling_space();
+      // The initial guess and residual in the recycled space.
+      typename VectorMemory<PETScWrappers::MPI::BlockVector>::Pointer residual(
+        vector_memory);
+      residual->reinit(system_rhs);
+      *residual = system_rhs;
+      newton_update = 0;
+      for (unsigned int i = 0; i < recycle_C.size(); ++i)
+        {
+          const double h = recycle_C[i] * (*residual);
+          residual->add(-h, recycle_C[i]);
+          newton_update.add(h, recycle_U[i]);
+        }
+
+      typename VectorMemory<PETScWrappers::MPI::BlockVector>::Pointer
+        correction(vector_memory);
+      correction->reinit(system_rhs);
+      DeflatedOperator deflated_matrix(system_matrix, recycle_C);
+      SolverFGMRES<PETScWrappers::MPI::BlockVector> gmres(solver_control,
+                                                          vector_memory);
+      gmres.solve(deflated_matrix, *correction, *residual, *preconditioner);
+
+      // Remove the part of the correction that is already in the recycled
+      // space, the residual is reused to hold A e.
+      system_matrix.vmult(*residual, *correction);
+      for (unsigned int i = 0; i < recycle_C.size(); ++i)
+        {
+          correction->add(-(recycle_C[i] * (*residual)), recycle_U[i]);
+        }
+      newton_update += *correction;
+
+      if (correction->l2_norm() > 0)
+        {
+          if (recycle_U.size() == parameters.fluid_recycle_vectors)
+            {
+              recycle_U.erase(recycle_U.begin());
+            }
+          recycle_U.push_back(*correction);
+        }
+    }
+
+    template <int dim>
+    void SCnsIM<dim>::update_recycling_space()
+    {
+      Utils::ProfilingScope timer_section(timer2, "Update recycling space");
+      std::vector<PETScWrappers::MPI::BlockVector> U, C;
+      U.reserve(recycle_U.size());
+      C.reserve(recycle_U.size());
+      for (auto &u : recycle_U)
+        {
+          PETScWrappers::MPI::BlockVector c(u);
+          system_matrix.vmult(c, u);
+          const double initial_norm = c.l2_norm();
+          for (unsigned int j = 0; j < C.size(); ++j)
+            {
+              const double h = C[j] * c;
+              c.add(-h, C[j]);
+              u.add(-h, U[j]);
+            }
+          const double norm = c.l2_norm();
+          // Drop the directions whose images are (almost) in the span of the
+          // previous ones.
+          if (norm <= 1e-10 * initial_norm)
+            {
+              continue;
+            }
+          c /= norm;
+          u /= norm;
+          U.push_back(u);
+          C.push_back(c);
+        }
+      recycle_U.swap(U);
+      recycle_C.swap(C);
+    }
+
     template <int dim>
     void SCnsIM<dim>::run_one_step(bool apply_nonzero_constraints,
                                    bool assemble_system)
@@ -752,13 +1320,28 @@ namespace Fluid
       pcout << std::string(96, '*') << std::endl
             << "Time step = " << time.get_timestep()
             << ", at t = " << std::scientific << time.current() << std::endl;
+      start_tuning_step();
 
       // Resetting
       double current_residual = 1.0;
       double initial_residual = 1.0;
       double relative_residual = 1.0;
       unsigned int outer_iteration = 0;
-      evaluation_point = present_solution;
+      n_preconditioner_builds = 0;
+      n_preconditioner_reuses = 0;
+      Utils::ForcingTerm forcing_term(
+        1e-6, parameters.inexact_newton, parameters.max_forcing_term);
+      unsigned int step_linear_iterations = 0;
+      unsigned int step_inner_iterations = 0;
+      // Start the Newton iterations from the extrapolated solution.
+      {
+        PETScWrappers::MPI::BlockVector &change = workspace[0];
+        PETScWrappers::MPI::BlockVector &tmp = workspace[1];
+        predict_solution_change(change);
+        tmp = present_solution;
+        tmp += change;
+        evaluation_point_update.start(evaluation_point, tmp);
+      }
       while (relative_residual > parameters.fluid_tolerance &&
              current_residual > 1e-14)
         {
@@ -775,18 +1358,25 @@ namespace Fluid
           // if they are time-independent, nonzero_constraints should be
           // applied only at the first iteration of the first time step.
           assemble(apply_nonzero_constraints && outer_iteration == 0);
-          auto state = solve(apply_nonzero_constraints && outer_iteration == 0);
           current_residual = system_rhs.l2_norm();
+          if (outer_iteration == 0)
+            {
+              steady_residual = current_residual;
+            }
+          const double eta = forcing_term.next(current_residual);
+          auto state =
+            solve(apply_nonzero_constraints && outer_iteration == 0, eta);
+          step_linear_iterations += state.first;
+          step_inner_iterations += preconditioner->get_Tpp_itr_count();
 
           // Update evaluation_point. Since newton_update has been set to
           // the correct bc values, there is no need to distribute the
           // evaluation_point again. Note we have to use a non-ghosted
           // vector as a buffer in order to do addition.
-          PETScWrappers::MPI::BlockVector tmp;
-          tmp.reinit(owned_partitioning, mpi_communicator);
+          PETScWrappers::MPI::BlockVector &tmp = workspace[0];
           tmp = evaluation_point;
           tmp += newton_update;
-          evaluation_point = tmp;
+          evaluation_point_update.start(evaluation_point, tmp);
 
           if (outer_iteration == 0)
             {
@@ -797,27 +1387,37 @@ namespace Fluid
           pcout << std::scientific << std::left << " ITR = " << std::setw(2)
                 << outer_iteration << " ABS_RES = " << current_residual
                 << " REL_RES = " << relative_residual
-                << " GMRES_ITR = " << std::setw(3) << state.first
-                << " GMRES_RES = " << state.second
+                << " ETA = " << eta << " GMRES_ITR = " << std::setw(3)
+                << state.first << " GMRES_RES = " << state.second
                 << " INNER_GMRES_ITR = " << std::setw(3)
                 << preconditioner->get_Tpp_itr_count() << std::endl;
           outer_iteration++;
         }
+      newton_iterations = outer_iteration;
+      pcout << " PRECONDITIONER_BUILDS = " << n_preconditioner_builds
+            << " PRECONDITIONER_REUSES = " << n_preconditioner_reuses
+            << std::endl
+            << " NEWTON_ITR = " << outer_iteration
+            << " TOTAL_GMRES_ITR = " << step_linear_iterations
+            << " TOTAL_INNER_GMRES_ITR = " << step_inner_iterations
+            << std::endl;
+      finish_tuning_step(step_linear_iterations);
+      evaluation_point_update.finish();
       // Update solution increment, which is used in FSI application.
-      PETScWrappers::MPI::BlockVector tmp1, tmp2;
-      tmp1.reinit(owned_partitioning, mpi_communicator);
-      tmp2.reinit(owned_partitioning, mpi_communicator);
+      PETScWrappers::MPI::BlockVector &tmp1 = workspace[0];
+      PETScWrappers::MPI::BlockVector &tmp2 = workspace[1];
       tmp1 = evaluation_point;
       tmp2 = present_solution;
       tmp2 -= tmp1;
       solution_increment = tmp2;
       // Newton iteration converges, update time and solution
       present_solution = evaluation_point;
-      // Update stress for output
-      update_stress();
+      probes.sample(present_solution, time.current(), time.time_to_output());
       // Output
       if (time.time_to_output())
         {
+          // The stress is only needed for output.
+          update_stress();
           output_results(time.get_timestep());
         }
       // Save checkpoint
@@ -900,10 +1500,19 @@ namespace Fluid
       // which means nonzero_constraints will be applied at the first iteration
       // in the first time step only, and never be used again.
       // This corresponds to time-independent Dirichlet BCs.
+      if (parameters.steady_state)
+        {
+          run_pseudo_transient(!success_load);
+          return;
+        }
       if (!success_load)
         run_one_step(true);
       while (time.end() - time.current() > 1e-12)
         {
+          if (parameters.adaptive_time_step)
+            {
+              adapt_time_step();
+            }
           if (parameters.use_hard_coded_values)
             {
               // Only for time dependent BCs!
@@ -5,44 +5,96 @@ namespace Internal
   using namespace dealii;
 
   template <int dim>
-  void PointHistory<dim>::setup(const Parameters::AllParameters &parameters,
-                                const unsigned int &mat_id)
+  void QuadraturePointHistory<dim>::setup(
+    const Parameters::AllParameters &parameters,
+    const Triangulation<dim> &triangulation,
+    const types::subdomain_id subdomain,
+    const unsigned int n_q)
   {
+    n_q_points = n_q;
+    materials.clear();
     if (parameters.solid_type == "NeoHookean")
       {
-        Assert(parameters.C[mat_id - 1].size() >= 2, ExcInternalError());
-        material.reset(new Solid::NeoHookean<dim>(parameters.C[mat_id - 1][0],
-                                                  parameters.C[mat_id - 1][1],
-                                                  parameters.solid_rho));
-        update(parameters, Tensor<2, dim>());
+        for (const auto &C : parameters.C)
+          {
+            Assert(C.size() >= 2, ExcInternalError());
+            materials.push_back(std::make_shared<Solid::NeoHookean<dim>>(
+              C[0], C[1], parameters.solid_rho));
+          }
       }
     else
       {
         Assert(false, ExcNotImplemented());
       }
+
+    offsets.assign(triangulation.n_active_cells(),
+                   numbers::invalid_unsigned_int);
+    cell_materials.assign(triangulation.n_active_cells(), 0);
+    unsigned int n_points = 0;
+    for (auto cell = triangulation.begin_active(); cell != triangulation.end();
+         ++cell)
+      {
+        if (cell->subdomain_id() != subdomain)
+          continue;
+        unsigned int mat_id = cell->material_id();
+        if (parameters.n_solid_parts == 1)
+          mat_id = 1;
+        Assert(mat_id >= 1 && mat_id <= materials.size(), ExcInternalError());
+        offsets[cell->active_cell_index()] = n_points;
+        cell_materials[cell->active_cell_index()] = mat_id - 1;
+        n_points += n_q_points;
+      }
+
+    // The undeformed state
+    F_inv.assign(n_points, Physics::Elasticity::StandardTensors<dim>::I);
+    tau.assign(n_points, SymmetricTensor<2, dim>());
+    Jc.assign(n_points, SymmetricTensor<4, dim>());
+    det_F.assign(n_points, 1.0);
+    std::vector<Tensor<2, dim>> zero(n_q_points);
+    for (auto cell = triangulation.begin_active(); cell != triangulation.end();
+         ++cell)
+      {
+        if (cell->subdomain_id() == subdomain)
+          {
+            update(cell, zero);
+          }
+      }
   }
 
   template <int dim>
-  void PointHistory<dim>::update(const Parameters::AllParameters &parameters,
-                                 const Tensor<2, dim> &Grad_u)
+  void QuadraturePointHistory<dim>::update(
+    const cell_iterator &cell, const std::vector<Tensor<2, dim>> &Grad_u)
   {
-    const Tensor<2, dim> F = Physics::Elasticity::Kinematics::F(Grad_u);
-    material->update_data(F);
-    F_inv = invert(F);
-    if (parameters.solid_type == "NeoHookean")
-      {
-        auto nh = std::dynamic_pointer_cast<Solid::NeoHookean<dim>>(material);
-        Assert(nh, ExcInternalError());
-        tau = nh->get_tau();
-        Jc = nh->get_Jc();
-      }
-    else
+    Assert(Grad_u.size() == n_q_points, ExcInternalError());
+    const unsigned int begin = index(cell, 0);
+    F_buffer.resize(n_q_points);
+    for (unsigned int q = 0; q < n_q_points; ++q)
       {
-        Assert(false, ExcNotImplemented());
+        F_buffer[q] = Physics::Elasticity::Kinematics::F(Grad_u[q]);
+        det_F[begin + q] = determinant(F_buffer[q]);
+        Assert(det_F[begin + q] > 0, ExcInternalError());
+        F_inv[begin + q] = invert(F_buffer[q]);
       }
-    dPsi_vol_dJ = material->get_dPsi_vol_dJ();
-    d2Psi_vol_dJ2 = material->get_d2Psi_vol_dJ2();
+    materials[cell_materials[cell->active_cell_index()]]->evaluate(
+      make_array_view(F_buffer.cbegin(), F_buffer.cend()),
+      make_array_view(tau, begin, n_q_points),
+      make_array_view(Jc, begin, n_q_points));
+  }
+
+  template <int dim>
+  std::size_t QuadraturePointHistory<dim>::memory_consumption() const
+  {
+    return MemoryConsumption::memory_consumption(offsets) +
+           MemoryConsumption::memory_consumption(cell_materials) +
+           MemoryConsumption::memory_consumption(F_inv) +
+           MemoryConsumption::memory_consumption(tau) +
+           MemoryConsumption::memory_consumption(Jc) +
+           MemoryConsumption::memory_consumption(det_F) +
+           MemoryConsumption::memory_consumption(F_buffer);
   }
+
+  template class QuadraturePointHistory<2>;
+  template class QuadraturePointHistory<3>;
 } // namespace Internal
 
 namespace Solid
@@ -53,8 +105,12 @@ namespace Solid
 
     template <int dim>
     SharedHyperElasticity<dim>::SharedHyperElasticity(
-      Triangulation<dim> &tria, const Parameters::AllParameters &params)
-      : SharedSolidSolver<dim>(tria, params)
+      Triangulation<dim> &tria,
+      const Parameters::AllParameters &params,
+      MPI_Comm communicator)
+      : SharedSolidSolver<dim>(tria, params, communicator),
+        tangent_valid(false),
+        tangent_dt(0)
     {
     }
 
@@ -72,9 +128,21 @@ namespace Solid
           this->output_results(time.get_timestep());
         }
 
-      PETScWrappers::MPI::Vector predicted_displacement(current_displacement);
-      PETScWrappers::MPI::Vector newton_update(current_displacement);
-      PETScWrappers::MPI::Vector tmp(current_displacement);
+      PETScWrappers::MPI::Vector &tmp = newton_buffer;
+
+      // With the modified Newton method the tangent is only assembled again
+      // when the convergence slows down. The BFGS method in addition updates
+      // the inverse of the frozen tangent with the last increments
+      // (s) and the changes of the residual (y).
+      const bool full_newton = parameters.solid_newton_method == "Full";
+      const bool bfgs = parameters.solid_newton_method == "BFGS";
+      std::vector<PETScWrappers::MPI::Vector> bfgs_s, bfgs_y;
+      std::vector<double> bfgs_rho;
+      bool refresh_tangent = false;
+      double previous_error_residual = 0;
+      Utils::ForcingTerm forcing_term(
+        1e-8, parameters.inexact_newton, parameters.max_forcing_term);
+      unsigned int step_linear_iterations = 0;
 
       time.increment();
 
@@ -95,9 +163,11 @@ namespace Solid
 
       // The prediction of the current displacement,
       // which is what we want to solve.
-      predicted_displacement = previous_displacement;
-      predicted_displacement.add(
-        dt, previous_velocity, (0.5 - beta) * dt * dt, previous_acceleration);
+      const Utils::Newmark newmark(dt, gamma, beta);
+      newmark.predict(previous_displacement,
+                      previous_velocity,
+                      previous_acceleration,
+                      predicted_displacement);
 
       pcout << std::string(100, '_') << std::endl;
 
@@ -109,36 +179,103 @@ namespace Solid
                       ExcMessage("Too many Newton iterations!"));
 
           // Compute the displacement, velocity and acceleration
-          current_acceleration = current_displacement;
-          current_acceleration -= predicted_displacement;
-          current_acceleration /= (beta * dt * dt);
-          current_velocity = previous_velocity;
-          current_velocity.add(dt * (1 - gamma),
-                               previous_acceleration,
-                               dt * gamma,
-                               current_acceleration);
+          newmark.update(predicted_displacement,
+                         previous_velocity,
+                         previous_acceleration,
+                         current_displacement,
+                         current_acceleration,
+                         current_velocity);
 
           // Assemble the system, and modify the RHS to account for
           // the time-discretization.
-          assemble_system(false);
+          const bool reuse_tangent = !full_newton && tangent_valid &&
+                                     !refresh_tangent && tangent_dt == dt;
+          if (!reuse_tangent)
+            {
+              assemble_system(false);
+              tangent_valid = true;
+              tangent_dt = dt;
+              refresh_tangent = false;
+              bfgs_s.clear();
+              bfgs_y.clear();
+              bfgs_rho.clear();
+            }
+          else
+            {
+              assemble_residual();
+            }
           mass_matrix.vmult(tmp, current_acceleration);
           system_rhs -= tmp;
 
-          // Solve linear system
-          const std::pair<unsigned int, double> lin_solver_output =
-            this->solve(system_matrix, newton_update, system_rhs);
+          if (bfgs && reuse_tangent && newton_iteration > 0)
+            {
+              // The rhs is the negative gradient, and the last increment is
+              // still in newton_update.
+              tmp = previous_rhs;
+              tmp -= system_rhs;
+              const double ys = tmp * newton_update;
+              if (ys > 0)
+                {
+                  bfgs_s.push_back(newton_update);
+                  bfgs_y.push_back(tmp);
+                  bfgs_rho.push_back(1.0 / ys);
+                }
+            }
+          previous_rhs = system_rhs;
+
+          // We should rule out the constrained components before evaluating
+          // the norms of system_rhs and newton_update.
+          error_residual = get_error(system_rhs);
+          const double eta = forcing_term.next(error_residual);
+
+          // Solve linear system, with the two-loop recursion if the inverse
+          // of the tangent has BFGS updates.
+          std::pair<unsigned int, double> lin_solver_output;
+          if (bfgs_s.empty())
+            {
+              lin_solver_output =
+                this->solve(system_matrix, newton_update, system_rhs, eta);
+            }
+          else
+            {
+              const unsigned int n = bfgs_s.size();
+              std::vector<double> alpha(n);
+              tmp = system_rhs;
+              for (unsigned int i = n; i-- > 0;)
+                {
+                  alpha[i] = bfgs_rho[i] * (bfgs_s[i] * tmp);
+                  tmp.add(-alpha[i], bfgs_y[i]);
+                }
+              lin_solver_output =
+                this->solve(system_matrix, newton_update, tmp, eta);
+              for (unsigned int i = 0; i < n; ++i)
+                {
+                  const double bfgs_beta =
+                    bfgs_rho[i] * (bfgs_y[i] * newton_update);
+                  newton_update.add(alpha[i] - bfgs_beta, bfgs_s[i]);
+                }
+            }
+
+          step_linear_iterations += lin_solver_output.first;
 
           // Error evaluation
           {
-            // We should rule out the constrained components before evaluating
-            // the norms of system_rhs and newton_update.
-            error_residual = get_error(system_rhs);
             if (newton_iteration == 0)
               {
                 initial_error_residual = error_residual;
               }
             normalized_error_residual = error_residual / initial_error_residual;
 
+            // A reused tangent is assembled again at the next iteration if
+            // it does not reduce the residual fast enough.
+            if (!full_newton && newton_iteration > 0 &&
+                error_residual >
+                  parameters.tangent_refresh_ratio * previous_error_residual)
+              {
+                refresh_tangent = true;
+              }
+            previous_error_residual = error_residual;
+
             error_update = get_error(newton_update);
             if (newton_iteration == 0)
               {
@@ -155,36 +292,36 @@ namespace Solid
                 << ", CG itr = " << lin_solver_output.first << std::fixed
                 << std::setprecision(3) << std::setw(7) << std::scientific
                 << ", CG res = " << lin_solver_output.second
+                << ", eta = " << eta
                 << ", res_F = " << error_residual
                 << ", res_U = " << error_update << std::endl;
 
           newton_iteration++;
         }
-
-      // Once converged, update current acceleration and velocity again.
-      current_acceleration = current_displacement;
-      current_acceleration -= predicted_displacement;
-      current_acceleration /= (beta * dt * dt);
-      current_velocity = previous_velocity;
-      current_velocity.add(dt * (1 - gamma),
-                           previous_acceleration,
-                           dt * gamma,
-                           current_acceleration);
-      // Update the previous values
-      previous_acceleration = current_acceleration;
-      previous_velocity = current_velocity;
-      previous_displacement = current_displacement;
+      this->newton_iterations = newton_iteration;
+
+      // Once converged, update current acceleration and velocity again,
+      // and the previous values.
+      newmark.advance_from_displacement(predicted_displacement,
+                                        current_displacement,
+                                        current_acceleration,
+                                        current_velocity,
+                                        previous_displacement,
+                                        previous_velocity,
+                                        previous_acceleration);
 
       pcout << std::string(100, '_') << std::endl
             << "Relative errors:" << std::endl
             << "Displacement:\t" << normalized_error_update << std::endl
-            << "Force: \t\t" << normalized_error_residual << std::endl;
-
-      // strain and stress
-      update_strain_and_stress();
+            << "Force: \t\t" << normalized_error_residual << std::endl
+            << "Newton iterations: " << newton_iteration
+            << ", CG iterations: " << step_linear_iterations << std::endl;
+      this->sample_probes();
 
       if (time.time_to_output())
         {
+          // The strain and stress are only needed for output.
+          update_strain_and_stress();
           this->output_results(time.get_timestep());
         }
       if (parameters.simulation_type == "Solid" && time.time_to_save())
@@ -198,65 +335,95 @@ namespace Solid
     {
       SharedSolidSolver<dim>::initialize_system();
       setup_qph();
+      tangent_valid = false;
+
+      for (auto vector : {&predicted_displacement,
+                          &newton_update,
+                          &newton_buffer,
+                          &previous_rhs,
+                          &error_buffer})
+        {
+          vector->reinit(locally_owned_dofs, mpi_communicator);
+        }
+      ghosted_displacement.reinit(
+        locally_owned_dofs, locally_relevant_dofs, mpi_communicator);
+      print_memory_report();
     }
 
     template <int dim>
-    void SharedHyperElasticity<dim>::setup_qph()
+    void
+    SharedHyperElasticity<dim>::add_memory(Utils::MemoryReport &report) const
     {
-      const unsigned int n_q_points = volume_quad_formula.size();
-      for (auto cell = triangulation.begin_active();
-           cell != triangulation.end();
-           ++cell)
+      SharedSolidSolver<dim>::add_memory(report);
+      report.add("Solid quadrature point history",
+                 quad_point_history.memory_consumption());
+      double buffers = 0;
+      for (auto vector : {&predicted_displacement,
+                          &newton_update,
+                          &newton_buffer,
+                          &previous_rhs,
+                          &error_buffer,
+                          &ghosted_displacement})
         {
-          if (cell->subdomain_id() != this_mpi_process)
-            continue;
-          unsigned int mat_id = cell->material_id();
-          if (parameters.n_solid_parts == 1)
-            mat_id = 1;
-          quad_point_history.initialize(cell, n_q_points);
-          const std::vector<std::shared_ptr<Internal::PointHistory<dim>>> lqph =
-            quad_point_history.get_data(cell);
-          Assert(lqph.size() == n_q_points, ExcInternalError());
-          for (unsigned int q = 0; q < n_q_points; ++q)
-            {
-              lqph[q]->setup(parameters, mat_id);
-            }
+          buffers += vector->memory_consumption();
         }
+      report.add("Solid Newton buffers", buffers);
+    }
+
+    template <int dim>
+    bool SharedHyperElasticity<dim>::load_checkpoint()
+    {
+      if (!SharedSolidSolver<dim>::load_checkpoint())
+        {
+          return false;
+        }
+      update_qph(current_displacement);
+      return true;
+    }
+
+    template <int dim>
+    void SharedHyperElasticity<dim>::repartition(
+      const std::vector<types::subdomain_id> &subdomains)
+    {
+      SharedSolidSolver<dim>::repartition(subdomains);
+      update_qph(current_displacement);
+    }
+
+    template <int dim>
+    void SharedHyperElasticity<dim>::setup_qph()
+    {
+      quad_point_history.setup(parameters,
+                               triangulation,
+                               this_mpi_process,
+                               volume_quad_formula.size());
     }
 
     template <int dim>
     void SharedHyperElasticity<dim>::update_qph(
       const PETScWrappers::MPI::Vector &evaluation_point)
     {
-      timer.enter_subsection("Update QPH data");
+      Utils::ProfilingScope timer_section(timer, "Update QPH data");
 
       // displacement gradient at quad points
-      const unsigned int n_q_points = volume_quad_formula.size();
       FEValuesExtractors::Vector displacement(0);
       std::vector<Tensor<2, dim>> grad_u(volume_quad_formula.size());
       FEValues<dim> fe_values(
         fe, volume_quad_formula, update_values | update_gradients);
 
-      Vector<double> tmp(evaluation_point);
+      PETScWrappers::MPI::Vector &tmp = ghosted_displacement;
+      tmp = evaluation_point;
 
       for (auto cell = dof_handler.begin_active(); cell != dof_handler.end();
            ++cell)
         {
           if (cell->subdomain_id() != this_mpi_process)
             continue;
-          const std::vector<std::shared_ptr<Internal::PointHistory<dim>>> lqph =
-            quad_point_history.get_data(cell);
-          Assert(lqph.size() == n_q_points, ExcInternalError());
 
           fe_values.reinit(cell);
           fe_values[displacement].get_function_gradients(tmp, grad_u);
 
-          for (unsigned int q = 0; q < n_q_points; ++q)
-            {
-              lqph[q]->update(parameters, grad_u[q]);
-            }
+          quad_point_history.update(cell, grad_u);
         }
-      timer.leave_subsection();
     }
 
     template <int dim>
@@ -272,12 +439,9 @@ namespace Solid
           if (cell->subdomain_id() != this_mpi_process)
             continue;
           fe_values.reinit(cell);
-          const std::vector<std::shared_ptr<const Internal::PointHistory<dim>>>
-            lqph = quad_point_history.get_data(cell);
-          Assert(lqph.size() == n_q_points, ExcInternalError());
           for (unsigned int q = 0; q < n_q_points; ++q)
             {
-              const double det = lqph[q]->get_det_F();
+              const double det = quad_point_history.get_det_F(cell, q);
               const double JxW = fe_values.JxW(q);
               volume += det * JxW;
             }
@@ -292,15 +456,32 @@ namespace Solid
     double SharedHyperElasticity<dim>::get_error(
       const PETScWrappers::MPI::Vector &v) const
     {
-      Vector<double> tmp(v);
-      constraints.distribute(tmp);
-      return tmp.l2_norm();
+      error_buffer = v;
+      constraints.distribute(error_buffer);
+      return error_buffer.l2_norm();
     }
 
     template <int dim>
     void SharedHyperElasticity<dim>::assemble_system(bool initial_step)
     {
-      timer.enter_subsection("Assemble tangent matrix");
+      assemble(initial_step, true);
+    }
+
+    template <int dim>
+    void SharedHyperElasticity<dim>::assemble_residual()
+    {
+      assemble(false, false);
+    }
+
+    template <int dim>
+    void SharedHyperElasticity<dim>::assemble(const bool initial_step,
+                                              const bool assemble_matrix)
+    {
+      const bool assemble_tangent = assemble_matrix && !initial_step;
+      Utils::ProfilingScope timer_section(timer,
+                                          assemble_matrix
+                                            ? "Assemble tangent matrix"
+                                            : "Assemble residual");
 
       const unsigned int n_q_points = volume_quad_formula.size();
       const unsigned int n_f_q_points = face_quad_formula.size();
@@ -313,29 +494,16 @@ namespace Solid
         {
           mass_matrix = 0.0;
         }
-      system_matrix = 0.0;
+      if (assemble_tangent)
+        {
+          system_matrix = 0.0;
+        }
       system_rhs = 0.0;
 
-      FEValues<dim> fe_values(fe,
-                              volume_quad_formula,
-                              update_values | update_gradients |
-                                update_JxW_values);
-      FEFaceValues<dim> fe_face_values(fe,
-                                       face_quad_formula,
-                                       update_values | update_normal_vectors |
-                                         update_JxW_values);
-
-      std::vector<std::vector<Tensor<1, dim>>> phi(
-        n_q_points, std::vector<Tensor<1, dim>>(dofs_per_cell));
-      std::vector<std::vector<Tensor<2, dim>>> grad_phi(
-        n_q_points, std::vector<Tensor<2, dim>>(dofs_per_cell));
-      std::vector<std::vector<SymmetricTensor<2, dim>>> sym_grad_phi(
-        n_q_points, std::vector<SymmetricTensor<2, dim>>(dofs_per_cell));
-
-      FullMatrix<double> local_matrix(dofs_per_cell, dofs_per_cell);
-      FullMatrix<double> local_mass(dofs_per_cell, dofs_per_cell);
-      Vector<double> local_rhs(dofs_per_cell);
-      std::vector<types::global_dof_index> local_dof_indices(dofs_per_cell);
+      const UpdateFlags flags =
+        update_values | update_gradients | update_JxW_values;
+      const UpdateFlags face_flags =
+        update_values | update_normal_vectors | update_JxW_values;
 
       Tensor<1, dim> gravity;
       for (unsigned int i = 0; i < dim; ++i)
@@ -343,15 +511,26 @@ namespace Solid
           gravity[i] = parameters.gravity[i];
         }
 
-      for (auto cell = dof_handler.begin_active(); cell != dof_handler.end();
-           ++cell)
-        {
-          if (cell->subdomain_id() != this_mpi_process)
-            continue;
-
-          auto p = cell_property.get_data(cell);
-          Assert(p.size() == n_f_q_points * GeometryInfo<dim>::faces_per_cell,
-                 ExcMessage("Wrong number of cell data!"));
+      auto assemble_cell =
+        [&](const typename DoFHandler<dim>::active_cell_iterator &cell,
+            Utils::AssemblyScratch<dim> &scratch,
+            Utils::AssemblyCopy &copy) {
+          FEValues<dim> &fe_values = scratch.fe_values;
+          FEFaceValues<dim> &fe_face_values = scratch.fe_face_values;
+          FullMatrix<double> &local_matrix = copy.cell_matrix;
+          FullMatrix<double> &local_mass = copy.cell_matrix2;
+          Vector<double> &local_rhs = copy.cell_rhs;
+          std::vector<types::global_dof_index> &local_dof_indices =
+            copy.local_dof_indices;
+
+          std::vector<std::vector<Tensor<1, dim>>> phi(
+            n_q_points, std::vector<Tensor<1, dim>>(dofs_per_cell));
+          std::vector<std::vector<Tensor<2, dim>>> grad_phi(
+            n_q_points, std::vector<Tensor<2, dim>>(dofs_per_cell));
+          std::vector<std::vector<SymmetricTensor<2, dim>>> sym_grad_phi(
+            n_q_points, std::vector<SymmetricTensor<2, dim>>(dofs_per_cell));
+
+          const unsigned int cell_index = cell->active_cell_index();
           fe_values.reinit(cell);
           cell->get_dof_indices(local_dof_indices);
 
@@ -359,13 +538,11 @@ namespace Solid
           local_matrix = 0;
           local_rhs = 0;
 
-          const std::vector<std::shared_ptr<Internal::PointHistory<dim>>> lqph =
-            quad_point_history.get_data(cell);
-          Assert(lqph.size() == n_q_points, ExcInternalError());
-
+          const double rho = quad_point_history.get_density(cell);
           for (unsigned int q = 0; q < n_q_points; ++q)
             {
-              const Tensor<2, dim> F_inv = lqph[q]->get_F_inv();
+              const Tensor<2, dim> &F_inv =
+                quad_point_history.get_F_inv(cell, q);
               for (unsigned int k = 0; k < dofs_per_cell; ++k)
                 {
                   phi[q][k] = fe_values[displacement].value(k, q);
@@ -374,9 +551,10 @@ namespace Solid
                   sym_grad_phi[q][k] = symmetrize(grad_phi[q][k]);
                 }
 
-              const SymmetricTensor<2, dim> tau = lqph[q]->get_tau();
-              const SymmetricTensor<4, dim> Jc = lqph[q]->get_Jc();
-              const double rho = lqph[q]->get_density();
+              const SymmetricTensor<2, dim> &tau =
+                quad_point_history.get_tau(cell, q);
+              const SymmetricTensor<4, dim> &Jc =
+                quad_point_history.get_Jc(cell, q);
               const double dt = time.get_delta_t();
               const double JxW = fe_values.JxW(q);
 
@@ -384,7 +562,7 @@ namespace Solid
                 {
                   const unsigned int component_i =
                     fe.system_to_component_index(i).first;
-                  for (unsigned int j = 0; j <= i; ++j)
+                  for (unsigned int j = 0; j <= i && assemble_matrix; ++j)
                     {
                       if (initial_step)
                         {
@@ -413,7 +591,7 @@ namespace Solid
                 }
             }
 
-          for (unsigned int i = 0; i < dofs_per_cell; ++i)
+          for (unsigned int i = 0; i < dofs_per_cell && assemble_matrix; ++i)
             {
               for (unsigned int j = i + 1; j < dofs_per_cell; ++j)
                 {
@@ -457,7 +635,7 @@ namespace Solid
                 {
                   // In stand-alone simulation, the boundary value is prescribed
                   // by the user.
-                  prescribed_value = parameters.solid_neumann_bcs[id];
+                  prescribed_value = parameters.solid_neumann_bcs.at(id);
                 }
 
               if (parameters.simulation_type != "FSI" &&
@@ -480,7 +658,7 @@ namespace Solid
                     }
                   else if (parameters.simulation_type == "FSI")
                     {
-                      traction = p[face * n_f_q_points + q]->fsi_traction;
+                      traction = cell_property.traction(cell_index, face, q);
                     }
 
                   for (unsigned int j = 0; j < dofs_per_cell; ++j)
@@ -494,151 +672,125 @@ namespace Solid
                     }
                 }
             }
+        };
 
-          if (initial_step)
-            {
-              constraints.distribute_local_to_global(local_mass,
-                                                     local_rhs,
-                                                     local_dof_indices,
-                                                     mass_matrix,
-                                                     system_rhs);
-            }
-          else
-            {
-              constraints.distribute_local_to_global(local_matrix,
-                                                     local_rhs,
-                                                     local_dof_indices,
-                                                     system_matrix,
-                                                     system_rhs);
-            }
-        }
+      auto copy_cell = [&](const Utils::AssemblyCopy &copy) {
+        if (!assemble_matrix)
+          {
+            constraints.distribute_local_to_global(
+              copy.cell_rhs, copy.local_dof_indices, system_rhs);
+          }
+        else if (initial_step)
+          {
+            constraints.distribute_local_to_global(copy.cell_matrix2,
+                                                   copy.cell_rhs,
+                                                   copy.local_dof_indices,
+                                                   mass_matrix,
+                                                   system_rhs);
+          }
+        else
+          {
+            constraints.distribute_local_to_global(copy.cell_matrix,
+                                                   copy.cell_rhs,
+                                                   copy.local_dof_indices,
+                                                   system_matrix,
+                                                   system_rhs);
+          }
+      };
+
+      Utils::AssemblyCopy copy_data;
+      copy_data.cell_matrix.reinit(dofs_per_cell, dofs_per_cell);
+      copy_data.cell_matrix2.reinit(dofs_per_cell, dofs_per_cell);
+      copy_data.cell_rhs.reinit(dofs_per_cell);
+      copy_data.local_dof_indices.resize(dofs_per_cell);
+
+      const IteratorFilters::SubdomainEqualTo owned_cells(this_mpi_process);
+      using CellFilter =
+        FilteredIterator<typename DoFHandler<dim>::active_cell_iterator>;
+      WorkStream::run(CellFilter(owned_cells, dof_handler.begin_active()),
+                      CellFilter(owned_cells, dof_handler.end()),
+                      assemble_cell,
+                      copy_cell,
+                      Utils::AssemblyScratch<dim>(fe,
+                                                  volume_quad_formula,
+                                                  flags,
+                                                  face_quad_formula,
+                                                  face_flags),
+                      copy_data);
 
       if (initial_step)
         {
           mass_matrix.compress(VectorOperation::add);
         }
-      else
+      else if (assemble_tangent)
         {
           system_matrix.compress(VectorOperation::add);
         }
       system_rhs.compress(VectorOperation::add);
-      timer.leave_subsection();
     }
 
     template <int dim>
     void SharedHyperElasticity<dim>::update_strain_and_stress()
     {
+      // The strain is the deformation gradient, which is not symmetric.
+      // Only the upper triangle of the stress is computed.
+      std::vector<PETScWrappers::MPI::Vector *> components;
       for (unsigned int i = 0; i < dim; ++i)
         {
           for (unsigned int j = 0; j < dim; ++j)
             {
-              strain[i][j] = 0.0;
-              stress[i][j] = 0.0;
+              components.push_back(&strain[i][j]);
             }
         }
-      PETScWrappers::MPI::Vector surrounding_cells(locally_owned_scalar_dofs,
-                                                   mpi_communicator);
-      surrounding_cells = 0.0;
-      // The strain and stress tensors are stored as 2D vectors of shape dim*dim
-      // at cell and quadrature point level.
-      std::vector<std::vector<Vector<double>>> cell_strain(
-        dim,
-        std::vector<Vector<double>>(dim,
-                                    Vector<double>(scalar_fe.dofs_per_cell)));
-      std::vector<std::vector<Vector<double>>> cell_stress(
-        dim,
-        std::vector<Vector<double>>(dim,
-                                    Vector<double>(scalar_fe.dofs_per_cell)));
-      std::vector<std::vector<Vector<double>>> quad_strain(
-        dim,
-        std::vector<Vector<double>>(
-          dim, Vector<double>(volume_quad_formula.size())));
-      std::vector<std::vector<Vector<double>>> quad_stress(
-        dim,
-        std::vector<Vector<double>>(
-          dim, Vector<double>(volume_quad_formula.size())));
-
-      // Displacement gradients at quadrature points.
-      std::vector<Tensor<2, dim>> current_displacement_gradients(
-        volume_quad_formula.size());
-
-      // The projection matrix from quadrature points to the dofs.
-      FullMatrix<double> qpt_to_dof(scalar_fe.dofs_per_cell,
-                                    volume_quad_formula.size());
-      FETools::compute_projection_from_quadrature_points_matrix(
-        scalar_fe, volume_quad_formula, volume_quad_formula, qpt_to_dof);
-
-      const FEValuesExtractors::Vector displacements(0);
-
-      FEValues<dim> fe_values(fe,
-                              volume_quad_formula,
-                              update_values | update_gradients |
-                                update_quadrature_points | update_JxW_values);
+      for (unsigned int i = 0; i < dim; ++i)
+        {
+          for (unsigned int j = i; j < dim; ++j)
+            {
+              components.push_back(&stress[i][j]);
+            }
+        }
+      Utils::NodalProjection<dim> projection(
+        scalar_fe, volume_quad_formula, components);
+
       auto cell = dof_handler.begin_active();
       auto scalar_cell = scalar_dof_handler.begin_active();
-      Vector<double> local_sorrounding_cells(scalar_fe.dofs_per_cell);
-      local_sorrounding_cells = 1.0;
-
-      Vector<double> localized_current_displacement(current_displacement);
-
       for (; cell != dof_handler.end(); ++cell, ++scalar_cell)
         {
           if (cell->subdomain_id() == this_mpi_process)
             {
-              fe_values.reinit(cell);
-              const std::vector<std::shared_ptr<Internal::PointHistory<dim>>>
-                lqph = quad_point_history.get_data(cell);
-
               for (unsigned int q = 0; q < volume_quad_formula.size(); ++q)
                 {
-                  const SymmetricTensor<2, dim> tau = lqph[q]->get_tau();
-                  const Tensor<2, dim> F = invert(lqph[q]->get_F_inv());
-                  const double J = lqph[q]->get_det_F();
+                  const SymmetricTensor<2, dim> &tau =
+                    quad_point_history.get_tau(cell, q);
+                  const Tensor<2, dim> F =
+                    invert(quad_point_history.get_F_inv(cell, q));
+                  const double J = quad_point_history.get_det_F(cell, q);
+                  unsigned int c = 0;
                   for (unsigned int i = 0; i < dim; ++i)
                     {
                       for (unsigned int j = 0; j < dim; ++j)
                         {
-                          quad_strain[i][j][q] = F[i][j];
-                          quad_stress[i][j][q] = tau[i][j] / J;
+                          projection.quad_values(q, c++) = F[i][j];
                         }
                     }
-                }
-
-              for (unsigned int i = 0; i < dim; ++i)
-                {
-                  for (unsigned int j = 0; j < dim; ++j)
+                  for (unsigned int i = 0; i < dim; ++i)
                     {
-                      qpt_to_dof.vmult(cell_strain[i][j], quad_strain[i][j]);
-                      qpt_to_dof.vmult(cell_stress[i][j], quad_stress[i][j]);
-                      scalar_cell->distribute_local_to_global(cell_strain[i][j],
-                                                              strain[i][j]);
-                      scalar_cell->distribute_local_to_global(cell_stress[i][j],
-                                                              stress[i][j]);
+                      for (unsigned int j = i; j < dim; ++j)
+                        {
+                          projection.quad_values(q, c++) = tau[i][j] / J;
+                        }
                     }
                 }
-              scalar_cell->distribute_local_to_global(local_sorrounding_cells,
-                                                      surrounding_cells);
+              projection.add_cell(scalar_cell);
             }
         }
-      surrounding_cells.compress(VectorOperation::add);
+      projection.finish();
 
       for (unsigned int i = 0; i < dim; ++i)
         {
-          for (unsigned int j = 0; j < dim; ++j)
+          for (unsigned int j = 0; j < i; ++j)
             {
-              strain[i][j].compress(VectorOperation::add);
-              stress[i][j].compress(VectorOperation::add);
-              const unsigned int local_begin =
-                surrounding_cells.local_range().first;
-              const unsigned int local_end =
-                surrounding_cells.local_range().second;
-              for (unsigned int k = local_begin; k < local_end; ++k)
-                {
-                  strain[i][j][k] /= surrounding_cells[k];
-                  stress[i][j][k] /= surrounding_cells[k];
-                }
-              strain[i][j].compress(VectorOperation::insert);
-              stress[i][j].compress(VectorOperation::insert);
+              stress[i][j] = stress[j][i];
             }
         }
     }
@@ -42,15 +42,17 @@ namespace Solid
       Triangulation<dim> &tria,
       const Parameters::AllParameters &params,
       double dx,
-      double hdx)
-      : SharedSolidSolver<dim>(tria, params), dx(dx), hdx(hdx)
+      double hdx,
+      MPI_Comm communicator)
+      : SharedSolidSolver<dim>(tria, params, communicator), dx(dx), hdx(hdx)
     {
     }
 
     template <int dim>
     void SharedHypoElasticity<dim>::run_one_step(bool first_step)
     {
-      // Not parallelized yet, only rank 0 does work!
+      // The RKPM body lives on rank 0, the other processes only receive the
+      // part of the solution they own.
       if (first_step)
         {
           if (this_mpi_process == 0)
@@ -71,18 +73,8 @@ namespace Solid
           m_body->step();
           synchronize();
         }
-      // distribute
-      Vector<double> displacement(dof_handler.n_dofs());
-      Vector<double> velocity(dof_handler.n_dofs());
-      Vector<double> acceleration(dof_handler.n_dofs());
-      Utilities::MPI::sum(
-        serialized_displacement, mpi_communicator, displacement);
-      Utilities::MPI::sum(serialized_velocity, mpi_communicator, velocity);
-      Utilities::MPI::sum(
-        serialized_acceleration, mpi_communicator, acceleration);
-      current_displacement = displacement;
-      current_velocity = velocity;
-      current_acceleration = acceleration;
+      distribute_solution();
+      this->sample_probes();
       if (time.time_to_output())
         {
           this->output_results(time.get_timestep());
@@ -106,6 +98,28 @@ namespace Solid
       serialized_displacement = Vector<double>(dof_handler.n_dofs());
       serialized_velocity = Vector<double>(dof_handler.n_dofs());
       serialized_acceleration = Vector<double>(dof_handler.n_dofs());
+      changed_dofs.clear();
+      print_memory_report();
+    }
+
+    template <int dim>
+    void
+    SharedHypoElasticity<dim>::add_memory(Utils::MemoryReport &report) const
+    {
+      SharedSolidSolver<dim>::add_memory(report);
+      report.add("Solid serialized vectors",
+                 serialized_displacement.memory_consumption() +
+                   serialized_velocity.memory_consumption() +
+                   serialized_acceleration.memory_consumption() +
+                   MemoryConsumption::memory_consumption(changed_dofs));
+      report.add("Solid particle arrays",
+                 MemoryConsumption::memory_consumption(particle_dofs) +
+                   MemoryConsumption::memory_consumption(
+                     particle_arrays.displacement) +
+                   MemoryConsumption::memory_consumption(
+                     particle_arrays.velocity) +
+                   MemoryConsumption::memory_consumption(
+                     particle_arrays.acceleration));
     }
 
     template <int dim>
@@ -121,58 +135,121 @@ namespace Solid
       // do nothing
     }
 
+    template <int dim>
+    void SharedHypoElasticity<dim>::gather_particles()
+    {
+      const unsigned int n_particles = m_body->get_num_part();
+      particle_arrays.displacement.resize(n_particles * dim);
+      particle_arrays.velocity.resize(n_particles * dim);
+      particle_arrays.acceleration.resize(n_particles * dim);
+      double *displacement = particle_arrays.displacement.data();
+      double *velocity = particle_arrays.velocity.data();
+      double *acceleration = particle_arrays.acceleration.data();
+      particle<dim> **particles = m_body->get_particles();
+      for (unsigned int i = 0; i < n_particles; ++i)
+        {
+          const particle<dim> &p = *particles[i];
+          for (unsigned int n = 0; n < dim; ++n)
+            {
+              displacement[i * dim + n] = p.x[n] - p.X[n];
+              velocity[i * dim + n] = p.v[n];
+              acceleration[i * dim + n] = p.a[n];
+            }
+        }
+    }
+
     template <int dim>
     void SharedHypoElasticity<dim>::synchronize()
     {
-      std::vector<bool> vertex_touched(triangulation.n_vertices(), false);
-      unsigned int n_face_q_points = face_quad_formula.size();
-      unsigned int face_quad_point_id = 0;
+      gather_particles();
+      const double *displacement = particle_arrays.displacement.data();
+      const double *velocity = particle_arrays.velocity.data();
+      const double *acceleration = particle_arrays.acceleration.data();
+      for (unsigned int k = 0; k < particle_dofs.size(); ++k)
+        {
+          const auto dof = particle_dofs[k];
+          if (serialized_displacement(dof) != displacement[k] ||
+              serialized_velocity(dof) != velocity[k] ||
+              serialized_acceleration(dof) != acceleration[k])
+            {
+              changed_dofs.push_back(dof);
+            }
+          serialized_displacement(dof) = displacement[k];
+          serialized_velocity(dof) = velocity[k];
+          serialized_acceleration(dof) = acceleration[k];
+        }
+      // The face quadrature points of the body are in the same order as the
+      // interface points.
+      for (unsigned int k = 0; k < cell_property.fsi_traction.size(); ++k)
+        {
+          const auto &traction = cell_property.fsi_traction[k];
+          for (unsigned int n = 0; n < dim; ++n)
+            {
+              m_body->get_face_quad_points()[k]->t[n] = traction[n];
+            }
+        }
+    }
+
+    template <int dim>
+    void SharedHypoElasticity<dim>::distribute_solution()
+    {
+      // PETSc sends every entry set here to its owner only, which is all
+      // the communication there is.
+      std::vector<PetscScalar> values(changed_dofs.size());
+      auto set_changed = [&](PETScWrappers::MPI::Vector &vector,
+                             const Vector<double> &serialized) {
+        for (unsigned int i = 0; i < changed_dofs.size(); ++i)
+          {
+            values[i] = serialized(changed_dofs[i]);
+          }
+        if (!changed_dofs.empty())
+          {
+            vector.set(changed_dofs, values);
+          }
+        vector.compress(VectorOperation::insert);
+      };
+      set_changed(current_displacement, serialized_displacement);
+      set_changed(current_velocity, serialized_velocity);
+      set_changed(current_acceleration, serialized_acceleration);
+      changed_dofs.clear();
+    }
+
+    template <int dim>
+    void SharedHypoElasticity<dim>::setup_particle_dofs()
+    {
+      particle_dofs.resize(triangulation.n_vertices() * dim);
       for (auto cell = dof_handler.begin_active(); cell != dof_handler.end();
            ++cell)
         {
           for (unsigned int v = 0; v < GeometryInfo<dim>::vertices_per_cell;
                ++v)
             {
-              if (!vertex_touched[cell->vertex_index(v)])
-                {
-                  vertex_touched[cell->vertex_index(v)] = true;
-                  int id = vertex_mapping[cell->vertex_index(v)];
-                  auto disp = m_body->get_particles()[id]->x -
-                              m_body->get_particles()[id]->X;
-                  auto vel = m_body->get_particles()[id]->v;
-                  auto acc = m_body->get_particles()[id]->a;
-                  for (unsigned int n = 0; n < dim; ++n)
-                    {
-                      serialized_displacement(cell->vertex_dof_index(v, n)) =
-                        disp[n];
-                      serialized_velocity(cell->vertex_dof_index(v, n)) =
-                        vel[n];
-                      serialized_acceleration(cell->vertex_dof_index(v, n)) =
-                        acc[n];
-                    }
-                }
-            }
-          auto ptr = cell_property.get_data(cell);
-          for (unsigned int f = 0; f < GeometryInfo<dim>::faces_per_cell; ++f)
-            {
-              if (cell->face(f)->at_boundary())
+              const int particle_id = vertex_mapping[cell->vertex_index(v)];
+              for (unsigned int n = 0; n < dim; ++n)
                 {
-                  for (unsigned int q = 0; q < n_face_q_points; ++q)
-                    {
-                      auto traction =
-                        ptr[f * n_face_q_points + q]->fsi_traction;
-                      for (unsigned int n = 0; n < dim; ++n)
-                        {
-                          m_body->get_face_quad_points()[face_quad_point_id]
-                            ->t[n] = traction[n];
-                        }
-                      face_quad_point_id++;
-                    }
+                  particle_dofs[particle_id * dim + n] =
+                    cell->vertex_dof_index(v, n);
                 }
             }
         }
     }
 
+    template <int dim>
+    void SharedHypoElasticity<dim>::repartition(
+      const std::vector<types::subdomain_id> &subdomains)
+    {
+      SharedSolidSolver<dim>::repartition(subdomains);
+      // The changes are tracked relative to the moved solution, in the new
+      // numbering.
+      serialized_displacement = Vector<double>(current_displacement);
+      serialized_velocity = Vector<double>(current_velocity);
+      serialized_acceleration = Vector<double>(current_acceleration);
+      if (this_mpi_process == 0 && m_body)
+        {
+          setup_particle_dofs();
+        }
+    }
+
     template <int dim>
     void SharedHypoElasticity<dim>::construct_particles()
     {
@@ -247,6 +324,7 @@ namespace Solid
         }
       AssertThrow(triangulation.n_vertices() == particle_id,
                   ExcMessage("Vertices do not match!"));
+      setup_particle_dofs();
       AssertThrow(n_vol_quad == vol_quad_point_id,
                   ExcMessage("Volume quadrature points do not match!"));
       particle<dim> **face_quad_points = new particle<dim> *[n_face_quad];
@@ -361,38 +439,28 @@ namespace Solid
           return false;
         }
       construct_particles();
-      std::vector<bool> vertex_touched(triangulation.n_vertices(), false);
       Vector<double> localized_displacement(current_displacement);
       Vector<double> localized_velocity(current_velocity);
       Vector<double> localized_acceleration(current_acceleration);
-      for (auto cell = dof_handler.begin_active(); cell != dof_handler.end();
-           ++cell)
+      for (unsigned int id = 0; id < m_body->get_num_part(); ++id)
         {
-          for (unsigned int v = 0; v < GeometryInfo<dim>::vertices_per_cell;
-               ++v)
+          particle<dim> &current = *m_body->get_cur_particles()[id];
+          particle<dim> &p = *m_body->get_particles()[id];
+          for (unsigned int n = 0; n < dim; ++n)
             {
-              if (!vertex_touched[cell->vertex_index(v)])
-                {
-                  vertex_touched[cell->vertex_index(v)] = true;
-                  int id = vertex_mapping[cell->vertex_index(v)];
-                  for (unsigned int n = 0; n < dim; ++n)
-                    {
-                      m_body->get_cur_particles()[id]->x[n] +=
-                        localized_displacement(cell->vertex_dof_index(v, n));
-                      m_body->get_cur_particles()[id]->v[n] +=
-                        localized_velocity(cell->vertex_dof_index(v, n));
-                      m_body->get_cur_particles()[id]->a[n] +=
-                        localized_acceleration(cell->vertex_dof_index(v, n));
-                      m_body->get_particles()[id]->x[n] =
-                        m_body->get_cur_particles()[id]->x[n];
-                      m_body->get_particles()[id]->v[n] =
-                        m_body->get_cur_particles()[id]->v[n];
-                      m_body->get_particles()[id]->a[n] =
-                        m_body->get_cur_particles()[id]->a[n];
-                    }
-                }
+              const auto dof = particle_dofs[id * dim + n];
+              current.x[n] += localized_displacement(dof);
+              current.v[n] += localized_velocity(dof);
+              current.a[n] += localized_acceleration(dof);
+              p.x[n] = current.x[n];
+              p.v[n] = current.v[n];
+              p.a[n] = current.a[n];
             }
         }
+      // The changes are tracked relative to the loaded solution.
+      serialized_displacement = localized_displacement;
+      serialized_velocity = localized_velocity;
+      serialized_acceleration = localized_acceleration;
       fs::path local_path = fs::current_path();
       fs::path checkpoint_file(local_path);
       for (const auto &p : fs::directory_iterator(local_path))
@@ -8,7 +8,9 @@ namespace Solid
 
     template <int dim>
     SharedSolidSolver<dim>::SharedSolidSolver(
-      Triangulation<dim> &tria, const Parameters::AllParameters &parameters)
+      Triangulation<dim> &tria,
+      const Parameters::AllParameters &parameters,
+      MPI_Comm communicator)
       : triangulation(tria),
         parameters(parameters),
         dof_handler(triangulation),
@@ -17,7 +19,7 @@ namespace Solid
         scalar_fe(parameters.solid_degree),
         volume_quad_formula(parameters.solid_degree + 1),
         face_quad_formula(parameters.solid_degree + 1),
-        mpi_communicator(MPI_COMM_WORLD),
+        mpi_communicator(communicator),
         n_mpi_processes(Utilities::MPI::n_mpi_processes(mpi_communicator)),
         this_mpi_process(Utilities::MPI::this_mpi_process(mpi_communicator)),
         pcout(std::cout, (this_mpi_process == 0)),
@@ -27,8 +29,26 @@ namespace Solid
              parameters.refinement_interval,
              parameters.save_interval),
         timer(
-          mpi_communicator, pcout, TimerOutput::never, TimerOutput::wall_times)
+          mpi_communicator, pcout, TimerOutput::never, TimerOutput::wall_times),
+        linear_iterations(0),
+        newton_iterations(0),
+        preconditioner_policy(
+          SolverPolicy::solid_preconditioner(parameters.solid_preconditioner)),
+        checkpoint_key_index(-1),
+        checkpoints_since_key(0),
+        probes(dof_handler, mpi_communicator)
     {
+      // The MPI initialization limits every process to one thread, the
+      // assembly uses as many as requested.
+      MultithreadInfo::set_thread_limit(parameters.n_threads == 0
+                                          ? numbers::invalid_unsigned_int
+                                          : parameters.n_threads);
+      if (!parameters.solid_probe_points.empty())
+        {
+          std::vector<std::string> names = {"ux", "uy", "uz"};
+          names.resize(dim);
+          probes.open("solid_probes.csv", parameters.solid_probe_points, names);
+        }
     }
 
     template <int dim>
@@ -37,32 +57,94 @@ namespace Solid
       scalar_dof_handler.clear();
       dof_handler.clear();
       timer.print_summary();
+      if (parameters.timer_statistics)
+        {
+          timer.print_wall_time_statistics(mpi_communicator);
+        }
+      if (parameters.memory_report)
+        {
+          Utils::MemoryReport::print_peak_memory(
+            pcout.get_stream(), mpi_communicator, "Peak resident memory");
+        }
     }
 
     template <int dim>
     void SharedSolidSolver<dim>::setup_dofs()
     {
-      TimerOutput::Scope timer_section(timer, "Setup system");
+      Utils::ProfilingScope timer_section(timer, "Setup system");
 
       // Because in mpi solid solver we take serial triangulation,
-      // here we partition it.
-      GridTools::partition_triangulation(n_mpi_processes, triangulation);
+      // here we partition it, unless the partition is given.
+      if (cell_subdomains.empty())
+        {
+          GridTools::partition_triangulation(n_mpi_processes, triangulation);
+        }
+      else
+        {
+          AssertThrow(cell_subdomains.size() == triangulation.n_active_cells(),
+                      ExcMessage("The partition does not match the mesh!"));
+          for (auto cell = triangulation.begin_active();
+               cell != triangulation.end();
+               ++cell)
+            {
+              cell->set_subdomain_id(
+                cell_subdomains[cell->active_cell_index()]);
+            }
+        }
 
       dof_handler.distribute_dofs(fe);
-      DoFRenumbering::subdomain_wise(dof_handler);
       scalar_dof_handler.distribute_dofs(scalar_fe);
+      probes.reset();
+      // The subdomain wise renumbering keeps the order within every
+      // subdomain, so the hierarchical numbering is kept locally.
+      if (parameters.dof_ordering == "Hierarchical")
+        {
+          DoFRenumbering::hierarchical(dof_handler);
+          DoFRenumbering::hierarchical(scalar_dof_handler);
+        }
+      // Keep the numbering before the renumbering, which does not depend on
+      // the number of processes, to address the checkpoint file.
+      std::vector<types::global_dof_index> new_numbers(dof_handler.n_dofs());
+      DoFRenumbering::compute_subdomain_wise(new_numbers, dof_handler);
+      dof_handler.renumber_dofs(new_numbers);
       DoFRenumbering::subdomain_wise(scalar_dof_handler);
 
       // Extract the locally owned and relevant dofs
       const std::vector<IndexSet> locally_owned_dofs_per_proc =
         DoFTools::locally_owned_dofs_per_subdomain(dof_handler);
       locally_owned_dofs = locally_owned_dofs_per_proc[this_mpi_process];
+      canonical_dof_indices.resize(locally_owned_dofs.n_elements());
+      for (types::global_dof_index i = 0; i < new_numbers.size(); ++i)
+        {
+          if (locally_owned_dofs.is_element(new_numbers[i]))
+            {
+              canonical_dof_indices[locally_owned_dofs.index_within_set(
+                new_numbers[i])] = i;
+            }
+        }
 
       const std::vector<IndexSet> locally_owned_scalar_dofs_per_proc =
         DoFTools::locally_owned_dofs_per_subdomain(scalar_dof_handler);
       locally_owned_scalar_dofs =
         locally_owned_scalar_dofs_per_proc[this_mpi_process];
 
+      // The relevant dofs are those on the cells of this subdomain, which is
+      // all that is needed to evaluate the solution on these cells.
+      locally_relevant_dofs = locally_owned_dofs;
+      {
+        std::vector<types::global_dof_index> dof_indices(fe.dofs_per_cell);
+        for (auto cell = dof_handler.begin_active(); cell != dof_handler.end();
+             ++cell)
+          {
+            if (cell->subdomain_id() == this_mpi_process)
+              {
+                cell->get_dof_indices(dof_indices);
+                locally_relevant_dofs.add_indices(dof_indices.begin(),
+                                                  dof_indices.end());
+              }
+          }
+      }
+
       // The Dirichlet boundary conditions are stored in the AffineConstraints
       // object. It does not need to modify the sparse matrix after assembly,
       // because it is applied in the assembly process,
@@ -140,6 +222,21 @@ namespace Solid
 
       previous_displacement.reinit(locally_owned_dofs, mpi_communicator);
 
+      // The matrices are new, so are the factorizations and the modes.
+      direct_solvers.clear();
+      preconditioners.clear();
+      rigid_body_modes.clear();
+      if (preconditioner_policy.select(
+            dof_handler.n_dofs(), dim, n_mpi_processes))
+        {
+          pcout << " SOLID_PRECONDITIONER = " << preconditioner_policy.get()
+                << std::endl;
+        }
+      if (preconditioner_policy.get() == "GMG")
+        {
+          setup_multigrid();
+        }
+
       strain = std::vector<std::vector<PETScWrappers::MPI::Vector>>(
         dim,
         std::vector<PETScWrappers::MPI::Vector>(
@@ -155,10 +252,106 @@ namespace Solid
 
       // Set up cell property, which contains the FSI traction required in FSI
       // simulation
-      const unsigned int n_data =
-        face_quad_formula.size() * GeometryInfo<dim>::faces_per_cell;
-      cell_property.initialize(
-        triangulation.begin_active(), triangulation.end(), n_data);
+      setup_interface();
+    }
+
+    template <int dim>
+    void SharedSolidSolver<dim>::setup_interface()
+    {
+      const unsigned int n_face_q_points = face_quad_formula.size();
+      const unsigned int faces_per_cell = GeometryInfo<dim>::faces_per_cell;
+      interface_faces.clear();
+      cell_property.face_offset.assign(
+        triangulation.n_active_cells() * faces_per_cell,
+        numbers::invalid_unsigned_int);
+      for (auto cell = dof_handler.begin_active(); cell != dof_handler.end();
+           ++cell)
+        {
+          for (unsigned int f = 0; f < faces_per_cell; ++f)
+            {
+              if (cell->face(f)->at_boundary())
+                {
+                  const unsigned int index =
+                    cell->active_cell_index() * faces_per_cell + f;
+                  cell_property.face_offset[index] =
+                    interface_faces.size() * n_face_q_points;
+                  interface_faces.emplace_back(cell, f);
+                }
+            }
+        }
+      cell_property.fsi_traction.assign(
+        interface_faces.size() * n_face_q_points, Tensor<1, dim>());
+    }
+
+    template <int dim>
+    void SharedSolidSolver<dim>::add_memory(Utils::MemoryReport &report) const
+    {
+      report.add("Solid mesh and dofs",
+                 triangulation.memory_consumption() +
+                   dof_handler.memory_consumption() +
+                   scalar_dof_handler.memory_consumption());
+      report.add("Solid constraints", constraints.memory_consumption());
+      report.add("Solid system_matrix", system_matrix);
+      report.add("Solid mass_matrix", mass_matrix);
+      report.add("Solid stiffness_matrix", stiffness_matrix);
+      double vectors = 0;
+      for (auto vector : {&system_rhs,
+                          &current_acceleration,
+                          &current_velocity,
+                          &current_displacement,
+                          &previous_acceleration,
+                          &previous_velocity,
+                          &previous_displacement})
+        {
+          vectors += vector->memory_consumption();
+        }
+      for (const auto &mode : rigid_body_modes)
+        {
+          vectors += mode.memory_consumption();
+        }
+      report.add("Solid vectors", vectors);
+      double nodal = 0;
+      for (const auto &tensor : {&strain, &stress})
+        {
+          for (const auto &row : *tensor)
+            {
+              for (const auto &component : row)
+                {
+                  nodal += component.memory_consumption();
+                }
+            }
+        }
+      report.add("Solid strain and stress", nodal);
+      if (preconditioner_policy.get() == "GMG")
+        {
+          for (unsigned int level = mg_interpolation.min_level();
+               level <= mg_interpolation.max_level();
+               ++level)
+            {
+              report.add("Solid GMG interpolation " +
+                           Utilities::int_to_string(level),
+                         mg_interpolation[level]);
+            }
+        }
+      report.add("Solid cell properties",
+                 MemoryConsumption::memory_consumption(
+                   cell_property.fsi_traction) +
+                   MemoryConsumption::memory_consumption(
+                     cell_property.face_offset) +
+                   interface_faces.capacity() *
+                     sizeof(typename decltype(interface_faces)::value_type));
+    }
+
+    template <int dim>
+    void SharedSolidSolver<dim>::print_memory_report() const
+    {
+      if (!parameters.memory_report)
+        return;
+      Utils::MemoryReport report(mpi_communicator);
+      add_memory(report);
+      report.print(pcout.get_stream(),
+                   "Solid memory at time step " +
+                     Utilities::int_to_string(time.get_timestep()));
     }
 
     // Solve linear system \f$Ax = b\f$ using CG solver.
@@ -166,32 +359,514 @@ namespace Solid
     std::pair<unsigned int, double>
     SharedSolidSolver<dim>::solve(const PETScWrappers::MPI::SparseMatrix &A,
                                   PETScWrappers::MPI::Vector &x,
-                                  const PETScWrappers::MPI::Vector &b)
+                                  const PETScWrappers::MPI::Vector &b,
+                                  const double relative_tolerance)
+    {
+      Utils::ProfilingScope timer_section(timer, "Solve linear system");
+
+      while (true)
+        {
+          try
+            {
+              return solve_once(A, x, b, relative_tolerance);
+            }
+          catch (SolverControl::NoConvergence &)
+            {
+              // The iterations exceed any limit, so the policy moves on
+              // unless there is no other candidate.
+              if (!preconditioner_policy.fail())
+                {
+                  throw;
+                }
+              pcout << " SOLID_PRECONDITIONER = "
+                    << preconditioner_policy.get() << std::endl;
+              preconditioners.clear();
+            }
+        }
+    }
+
+    template <int dim>
+    std::pair<unsigned int, double>
+    SharedSolidSolver<dim>::solve_once(
+      const PETScWrappers::MPI::SparseMatrix &A,
+      PETScWrappers::MPI::Vector &x,
+      const PETScWrappers::MPI::Vector &b,
+      const double relative_tolerance)
     {
-      TimerOutput::Scope timer_section(timer, "Solve linear system");
+      const std::string &type = preconditioner_policy.get();
+
+      if (type == "Direct")
+        {
+          // PETSc only factorizes the matrix again if it has been modified
+          // since the last solve, so the mass matrix is factorized once.
+          auto &direct = direct_solvers[&A];
+          const bool factorize = !direct;
+          if (factorize)
+            {
+              direct = std::make_shared<PETScWrappers::SparseDirectMUMPS>(
+                direct_solver_control, mpi_communicator);
+              direct->set_symmetric_mode(true);
+            }
+          const bool measure = factorize && parameters.memory_report;
+          const double resident =
+            measure ? Utils::MemoryReport::resident_memory() : 0.0;
+          direct->solve(A, x, b);
+          if (measure)
+            {
+              Utils::MemoryReport report(mpi_communicator);
+              report.add("Solid MUMPS factors",
+                         std::max(0.0,
+                                  Utils::MemoryReport::resident_memory() -
+                                    resident));
+              report.print(pcout.get_stream(), "Solid direct solver memory");
+            }
+
+          constraints.distribute(x);
+
+          linear_iterations += 1;
+          return {1, 0.0};
+        }
 
       SolverControl solver_control(dof_handler.n_dofs() * 2,
-                                   1e-8 * b.l2_norm());
+                                   relative_tolerance * b.l2_norm());
 
       PETScWrappers::SolverCG cg(solver_control, mpi_communicator);
 
-      PETScWrappers::PreconditionNone preconditioner(A);
+      // The preconditioner is kept as long as the matrix is not modified,
+      // e.g. by a modified Newton method that freezes the tangent.
+      auto &cached = preconditioners[&A];
+      PetscObjectState state;
+      PetscErrorCode ierr =
+        PetscObjectStateGet(reinterpret_cast<PetscObject>(static_cast<Mat>(A)),
+                            &state);
+      AssertThrow(ierr == 0, ExcPETScError(ierr));
+      if (!cached.second || cached.first != state)
+        {
+          std::shared_ptr<PETScWrappers::PreconditionerBase> &preconditioner =
+            cached.second;
+          if (type == "Jacobi")
+            {
+              preconditioner =
+                std::make_shared<PETScWrappers::PreconditionJacobi>(A);
+            }
+          else if (type == "BlockJacobi")
+            {
+              // One block per process, each of which is solved by ILU(0).
+              preconditioner =
+                std::make_shared<PETScWrappers::PreconditionBlockJacobi>(A);
+            }
+          else if (type == "AMG")
+            {
+              if (rigid_body_modes.empty())
+                {
+                  compute_rigid_body_modes();
+                }
+              std::vector<Vec> modes;
+              for (const auto &mode : rigid_body_modes)
+                {
+                  modes.push_back(static_cast<const Vec &>(mode));
+                }
+              MatNullSpace near_null_space;
+              ierr = MatNullSpaceCreate(mpi_communicator,
+                                        PETSC_FALSE,
+                                        modes.size(),
+                                        modes.data(),
+                                        &near_null_space);
+              AssertThrow(ierr == 0, ExcPETScError(ierr));
+              ierr = MatSetNearNullSpace(static_cast<Mat>(A), near_null_space);
+              AssertThrow(ierr == 0, ExcPETScError(ierr));
+              // The matrix holds a reference to the null space.
+              ierr = MatNullSpaceDestroy(&near_null_space);
+              AssertThrow(ierr == 0, ExcPETScError(ierr));
+
+              PETScWrappers::PreconditionBoomerAMG::AdditionalData data;
+              data.symmetric_operator = true;
+              data.strong_threshold = (dim == 2 ? 0.25 : 0.5);
+              preconditioner =
+                std::make_shared<PETScWrappers::PreconditionBoomerAMG>(A, data);
+            }
+          else if (type == "GMG")
+            {
+              preconditioner = std::make_shared<PreconditionGMG>(
+                A,
+                mg_interpolation,
+                PreconditionGMG::AdditionalData(
+                  parameters.solid_smoothing_steps));
+            }
+          else
+            {
+              preconditioner =
+                std::make_shared<PETScWrappers::PreconditionNone>(A);
+            }
+          ierr = PetscObjectStateGet(
+            reinterpret_cast<PetscObject>(static_cast<Mat>(A)), &cached.first);
+          AssertThrow(ierr == 0, ExcPETScError(ierr));
+        }
 
-      cg.solve(A, x, b, preconditioner);
+      cg.solve(A, x, b, *cached.second);
 
-      Vector<double> localized_x(x);
-      constraints.distribute(localized_x);
-      x = localized_x;
+      // Only the masters of the locally owned constrained dofs are imported.
+      constraints.distribute(x);
 
+      if (preconditioner_policy.record(solver_control.last_step()))
+        {
+          pcout << " SOLID_PRECONDITIONER = " << preconditioner_policy.get()
+                << std::endl;
+          preconditioners.clear();
+        }
+
+      linear_iterations += solver_control.last_step();
       return {solver_control.last_step(), solver_control.last_value()};
     }
 
+    template <int dim>
+    void SharedSolidSolver<dim>::compute_rigid_body_modes()
+    {
+      const unsigned int n_modes = (dim == 2 ? 3 : 6);
+      rigid_body_modes.assign(
+        n_modes,
+        PETScWrappers::MPI::Vector(locally_owned_dofs, mpi_communicator));
+
+      // Evaluate the modes at the support points of the dofs.
+      const Quadrature<dim> support_points(fe.get_unit_support_points());
+      FEValues<dim> fe_values(fe, support_points, update_quadrature_points);
+      std::vector<types::global_dof_index> local_dof_indices(
+        fe.dofs_per_cell);
+
+      for (auto cell = dof_handler.begin_active(); cell != dof_handler.end();
+           ++cell)
+        {
+          if (cell->subdomain_id() != this_mpi_process)
+            {
+              continue;
+            }
+          fe_values.reinit(cell);
+          cell->get_dof_indices(local_dof_indices);
+          for (unsigned int i = 0; i < fe.dofs_per_cell; ++i)
+            {
+              const auto dof = local_dof_indices[i];
+              if (!locally_owned_dofs.is_element(dof))
+                {
+                  continue;
+                }
+              const unsigned int component =
+                fe.system_to_component_index(i).first;
+              const Point<dim> &p = fe_values.quadrature_point(i);
+              // Translations
+              rigid_body_modes[component](dof) = 1.0;
+              // Rotations about z, and in 3D also about x and y
+              if (component == 0)
+                {
+                  rigid_body_modes[dim](dof) = -p[1];
+                }
+              else if (component == 1)
+                {
+                  rigid_body_modes[dim](dof) = p[0];
+                }
+              if (dim == 3)
+                {
+                  if (component == 1)
+                    {
+                      rigid_body_modes[dim + 1](dof) = -p[2];
+                    }
+                  else if (component == 2)
+                    {
+                      rigid_body_modes[dim + 1](dof) = p[1];
+                      rigid_body_modes[dim + 2](dof) = -p[0];
+                    }
+                  if (component == 0)
+                    {
+                      rigid_body_modes[dim + 2](dof) = p[2];
+                    }
+                }
+            }
+        }
+
+      // PETSc requires an orthonormal basis, use Gram-Schmidt.
+      for (unsigned int i = 0; i < n_modes; ++i)
+        {
+          rigid_body_modes[i].compress(VectorOperation::insert);
+          for (unsigned int j = 0; j < i; ++j)
+            {
+              const double projection =
+                rigid_body_modes[i] * rigid_body_modes[j];
+              rigid_body_modes[i].add(-projection, rigid_body_modes[j]);
+            }
+          rigid_body_modes[i] /= rigid_body_modes[i].l2_norm();
+        }
+    }
+
+    template <int dim>
+    void SharedSolidSolver<dim>::setup_multigrid()
+    {
+      using cell_iterator = typename Triangulation<dim>::cell_iterator;
+      using level_cell_iterator = typename DoFHandler<dim>::level_cell_iterator;
+
+      unsigned int n_coarse_levels = triangulation.n_levels();
+      for (auto cell : triangulation.active_cell_iterators())
+        {
+          n_coarse_levels = std::min(
+            n_coarse_levels, static_cast<unsigned int>(cell->level()));
+        }
+      AssertThrow(n_coarse_levels > 0,
+                  ExcMessage("GMG requires a refined solid mesh!"));
+
+      // A uniformly refined copy of the coarse mesh provides the dofs of the
+      // coarse levels. The prolongation matrices only depend on the
+      // reference cell, so the vertices do not matter.
+      std::vector<Point<dim>> vertices = triangulation.get_vertices();
+      std::vector<CellData<dim>> cells;
+      for (auto cell = triangulation.begin(0); cell != triangulation.end(0);
+           ++cell)
+        {
+          CellData<dim> data;
+          for (unsigned int v = 0; v < GeometryInfo<dim>::vertices_per_cell;
+               ++v)
+            {
+              data.vertices[v] = cell->vertex_index(v);
+            }
+          cells.push_back(data);
+        }
+      SubCellData subcell_data;
+      GridTools::delete_unused_vertices(vertices, cells, subcell_data);
+      Triangulation<dim> hierarchy(
+        Triangulation<dim>::limit_level_difference_at_vertices);
+      hierarchy.create_triangulation(vertices, cells, subcell_data);
+      hierarchy.refine_global(n_coarse_levels - 1);
+      DoFHandler<dim> level_dof_handler(hierarchy);
+      level_dof_handler.distribute_dofs(fe);
+      level_dof_handler.distribute_mg_dofs();
+
+      // Walk down both meshes together, to find the subdomain of the first
+      // active descendant of every coarse cell, and the solid cell at the
+      // place of every cell on the finest coarse level.
+      std::vector<std::vector<types::subdomain_id>> cell_owners(
+        n_coarse_levels);
+      for (unsigned int level = 0; level < n_coarse_levels; ++level)
+        {
+          cell_owners[level].resize(hierarchy.n_cells(level));
+        }
+      std::vector<cell_iterator> solid_cells(
+        hierarchy.n_cells(n_coarse_levels - 1));
+      std::vector<std::pair<cell_iterator, cell_iterator>> pending;
+      for (auto cell = hierarchy.begin(0), solid_cell = triangulation.begin(0);
+           cell != hierarchy.end(0);
+           ++cell, ++solid_cell)
+        {
+          pending.emplace_back(cell, solid_cell);
+        }
+      while (!pending.empty())
+        {
+          const cell_iterator cell = pending.back().first;
+          const cell_iterator solid_cell = pending.back().second;
+          pending.pop_back();
+          cell_iterator descendant = solid_cell;
+          while (descendant->has_children())
+            {
+              descendant = descendant->child(0);
+            }
+          cell_owners[cell->level()][cell->index()] =
+            descendant->subdomain_id();
+          if (static_cast<unsigned int>(cell->level()) + 1 < n_coarse_levels)
+            {
+              for (unsigned int c = 0; c < cell->n_children(); ++c)
+                {
+                  pending.emplace_back(cell->child(c), solid_cell->child(c));
+                }
+            }
+          else
+            {
+              solid_cells[cell->index()] = solid_cell;
+            }
+        }
+
+      // Number the level dofs subdomain by subdomain, so that every process
+      // owns a contiguous range, like the active dofs.
+      std::vector<std::vector<types::global_dof_index>> level_numbers(
+        n_coarse_levels);
+      std::vector<IndexSet> owned_level_dofs(n_coarse_levels);
+      std::vector<types::global_dof_index> dof_indices(fe.dofs_per_cell);
+      for (unsigned int level = 0; level < n_coarse_levels; ++level)
+        {
+          std::vector<std::vector<level_cell_iterator>> subdomain_cells(
+            n_mpi_processes);
+          for (auto cell : level_dof_handler.mg_cell_iterators_on_level(level))
+            {
+              subdomain_cells[cell_owners[level][cell->index()]].push_back(
+                cell);
+            }
+          const types::global_dof_index n_dofs =
+            level_dof_handler.n_dofs(level);
+          level_numbers[level].assign(n_dofs, numbers::invalid_dof_index);
+          owned_level_dofs[level].set_size(n_dofs);
+          types::global_dof_index next = 0;
+          for (unsigned int p = 0; p < n_mpi_processes; ++p)
+            {
+              const types::global_dof_index begin = next;
+              for (const auto &cell : subdomain_cells[p])
+                {
+                  cell->get_mg_dof_indices(dof_indices);
+                  for (const auto dof : dof_indices)
+                    {
+                      if (level_numbers[level][dof] ==
+                          numbers::invalid_dof_index)
+                        {
+                          level_numbers[level][dof] = next++;
+                        }
+                    }
+                }
+              if (p == this_mpi_process)
+                {
+                  owned_level_dofs[level].add_range(begin, next);
+                }
+            }
+        }
+
+      // Visit the nonzero entries of the interpolation into a level. The
+      // rows of the finest level are the active dofs, whose cells may be
+      // several levels below, so the prolongation matrices are multiplied
+      // down to every active descendant.
+      using EntryFunction = std::function<void(
+        types::global_dof_index, types::global_dof_index, double)>;
+      auto visit_entries = [&](const unsigned int level,
+                               const EntryFunction &entry) {
+        const unsigned int coarse_level = level - 1;
+        std::vector<types::global_dof_index> coarse_indices(fe.dofs_per_cell);
+        std::vector<types::global_dof_index> fine_indices(fe.dofs_per_cell);
+        auto visit_cell = [&](const FullMatrix<double> &prolongation) {
+          for (unsigned int i = 0; i < fe.dofs_per_cell; ++i)
+            {
+              for (unsigned int j = 0; j < fe.dofs_per_cell; ++j)
+                {
+                  if (prolongation(i, j) != 0)
+                    {
+                      entry(fine_indices[i],
+                            level_numbers[coarse_level][coarse_indices[j]],
+                            prolongation(i, j));
+                    }
+                }
+            }
+        };
+        for (auto cell :
+             level_dof_handler.mg_cell_iterators_on_level(coarse_level))
+          {
+            cell->get_mg_dof_indices(coarse_indices);
+            if (level < n_coarse_levels)
+              {
+                for (unsigned int c = 0; c < cell->n_children(); ++c)
+                  {
+                    cell->child(c)->get_mg_dof_indices(fine_indices);
+                    for (auto &dof : fine_indices)
+                      {
+                        dof = level_numbers[level][dof];
+                      }
+                    visit_cell(fe.get_prolongation_matrix(c));
+                  }
+                continue;
+              }
+            std::vector<std::pair<cell_iterator, FullMatrix<double>>>
+              descendants;
+            const cell_iterator solid_cell = solid_cells[cell->index()];
+            for (unsigned int c = 0; c < solid_cell->n_children(); ++c)
+              {
+                descendants.emplace_back(solid_cell->child(c),
+                                         fe.get_prolongation_matrix(c));
+              }
+            while (!descendants.empty())
+              {
+                const cell_iterator child = descendants.back().first;
+                const FullMatrix<double> prolongation =
+                  std::move(descendants.back().second);
+                descendants.pop_back();
+                if (child->has_children())
+                  {
+                    for (unsigned int c = 0; c < child->n_children(); ++c)
+                      {
+                        FullMatrix<double> product(fe.dofs_per_cell);
+                        fe.get_prolongation_matrix(c).mmult(product,
+                                                            prolongation);
+                        descendants.emplace_back(child->child(c), product);
+                      }
+                    continue;
+                  }
+                const typename DoFHandler<dim>::active_cell_iterator dof_cell(
+                  &triangulation, child->level(), child->index(), &dof_handler);
+                dof_cell->get_dof_indices(fine_indices);
+                visit_cell(prolongation);
+              }
+          }
+      };
+
+      // Only the locally owned rows are set, every process visits all the
+      // cells of the replicated mesh.
+      mg_interpolation.resize(1, n_coarse_levels);
+      for (unsigned int level = 1; level <= n_coarse_levels; ++level)
+        {
+          const IndexSet &rows = (level == n_coarse_levels)
+                                   ? locally_owned_dofs
+                                   : owned_level_dofs[level];
+          const IndexSet &columns = owned_level_dofs[level - 1];
+          DynamicSparsityPattern dsp(rows.size(), columns.size(), rows);
+          visit_entries(level,
+                        [&](const types::global_dof_index i,
+                            const types::global_dof_index j,
+                            const double) {
+                          if (rows.is_element(i))
+                            {
+                              dsp.add(i, j);
+                            }
+                        });
+          PETScWrappers::MPI::SparseMatrix &interpolation =
+            mg_interpolation[level];
+          interpolation.reinit(rows, columns, dsp, mpi_communicator);
+          visit_entries(level,
+                        [&](const types::global_dof_index i,
+                            const types::global_dof_index j,
+                            const double value) {
+                          if (rows.is_element(i))
+                            {
+                              interpolation.set(i, j, value);
+                            }
+                        });
+          interpolation.compress(VectorOperation::insert);
+        }
+    }
+
     template <int dim>
     void SharedSolidSolver<dim>::output_results(const unsigned int output_index)
     {
-      TimerOutput::Scope timer_section(timer, "Output results");
+      Utils::ProfilingScope timer_section(timer, "Output results");
+      if (in_situ_hook && !in_situ_hook({output_index,
+                                         time.current(),
+                                         dof_handler,
+                                         scalar_dof_handler,
+                                         current_displacement,
+                                         current_velocity,
+                                         current_acceleration,
+                                         strain,
+                                         stress}))
+        {
+          return;
+        }
+      if (parameters.async_output)
+        {
+          // Every process reports the failed writes of the previous
+          // outputs.
+          if (!output_writer)
+            {
+              output_writer = std::make_unique<Utils::BackgroundWriter>(
+                parameters.output_queue_length);
+            }
+          output_writer->check(mpi_communicator);
+        }
       pcout << "Writing solid results..." << std::endl;
 
+      if (parameters.n_output_groups > 0)
+        {
+          output_results_in_groups(output_index);
+          return;
+        }
+
       // Since only process 0 writes the output, we want all the others
       // to sned their data to process 0, which is automatically done
       // in this copy constructor.
@@ -216,7 +891,12 @@ namespace Solid
           std::vector<DataComponentInterpretation::DataComponentInterpretation>
             data_component_interpretation(
               dim, DataComponentInterpretation::component_is_part_of_vector);
-          DataOut<dim> data_out;
+          const Utils::OutputRegion<dim> region(parameters.solid_output_box,
+                                                parameters.solid_output_plane);
+          Utils::FilteredDataOut<dim> data_out(
+            [&region](const typename DataOut<dim>::cell_iterator &cell) {
+              return region.contains(cell);
+            });
           data_out.attach_dof_handler(dof_handler);
 
           // displacements
@@ -284,12 +964,144 @@ namespace Solid
 
           std::string filename = basename + ".vtu";
 
-          std::ofstream output(filename);
-          data_out.write_vtu(output);
-
           times_and_names.push_back({time.current(), filename});
-          std::ofstream pvd_output("solid.pvd");
-          DataOutBase::write_pvd_record(pvd_output, times_and_names);
+          // The patches no longer need the mesh, which the FSI moves.
+          write_output([patches = data_out.release_patches(),
+                        filename,
+                        records = times_and_names]() {
+            std::ofstream output(filename);
+            patches->write_vtu(output);
+            std::ofstream pvd_output("solid.pvd");
+            DataOutBase::write_pvd_record(pvd_output, records);
+          });
+        }
+    }
+
+    template <int dim>
+    void SharedSolidSolver<dim>::write_output(std::function<void()> &&write)
+    {
+      if (!parameters.async_output)
+        {
+          write();
+          return;
+        }
+      output_writer->submit(std::move(write));
+    }
+
+    template <int dim>
+    void SharedSolidSolver<dim>::output_results_in_groups(
+      const unsigned int output_index)
+    {
+      // Every process writes the cells of its own subdomain, which only
+      // needs the ghosted values on these cells.
+      IndexSet locally_relevant_scalar_dofs = locally_owned_scalar_dofs;
+      {
+        std::vector<types::global_dof_index> dof_indices(
+          scalar_fe.dofs_per_cell);
+        for (auto cell = scalar_dof_handler.begin_active();
+             cell != scalar_dof_handler.end();
+             ++cell)
+          {
+            if (cell->subdomain_id() == this_mpi_process)
+              {
+                cell->get_dof_indices(dof_indices);
+                locally_relevant_scalar_dofs.add_indices(dof_indices.begin(),
+                                                         dof_indices.end());
+              }
+          }
+      }
+      PETScWrappers::MPI::Vector displacement(
+        locally_owned_dofs, locally_relevant_dofs, mpi_communicator);
+      PETScWrappers::MPI::Vector velocity(
+        locally_owned_dofs, locally_relevant_dofs, mpi_communicator);
+      displacement = current_displacement;
+      velocity = current_velocity;
+      std::vector<std::vector<PETScWrappers::MPI::Vector>> relevant_strain(
+        dim, std::vector<PETScWrappers::MPI::Vector>(dim));
+      std::vector<std::vector<PETScWrappers::MPI::Vector>> relevant_stress(
+        dim, std::vector<PETScWrappers::MPI::Vector>(dim));
+      for (unsigned int i = 0; i < dim; ++i)
+        {
+          for (unsigned int j = 0; j < dim; ++j)
+            {
+              relevant_strain[i][j].reinit(locally_owned_scalar_dofs,
+                                           locally_relevant_scalar_dofs,
+                                           mpi_communicator);
+              relevant_strain[i][j] = strain[i][j];
+              relevant_stress[i][j].reinit(locally_owned_scalar_dofs,
+                                           locally_relevant_scalar_dofs,
+                                           mpi_communicator);
+              relevant_stress[i][j] = stress[i][j];
+            }
+        }
+
+      std::vector<std::string> solution_names(dim, "displacements");
+      std::vector<DataComponentInterpretation::DataComponentInterpretation>
+        data_component_interpretation(
+          dim, DataComponentInterpretation::component_is_part_of_vector);
+      const Utils::OutputRegion<dim> region(parameters.solid_output_box,
+                                            parameters.solid_output_plane);
+      Utils::FilteredDataOut<dim> data_out(
+        [this, &region](const typename DataOut<dim>::cell_iterator &cell) {
+          return cell->subdomain_id() == this_mpi_process &&
+                 region.contains(cell);
+        });
+      data_out.attach_dof_handler(dof_handler);
+      data_out.add_data_vector(displacement,
+                               solution_names,
+                               DataOut<dim>::type_dof_data,
+                               data_component_interpretation);
+      solution_names = std::vector<std::string>(dim, "velocities");
+      data_out.add_data_vector(velocity,
+                               solution_names,
+                               DataOut<dim>::type_dof_data,
+                               data_component_interpretation);
+
+      std::vector<unsigned int> subdomain_int(triangulation.n_active_cells());
+      GridTools::get_subdomain_association(triangulation, subdomain_int);
+      Vector<float> subdomain(subdomain_int.begin(), subdomain_int.end());
+      data_out.add_data_vector(subdomain, "subdomain");
+      Vector<float> mat(triangulation.n_active_cells());
+      unsigned int cell_index = 0;
+      for (auto cell = triangulation.begin_active();
+           cell != triangulation.end();
+           ++cell)
+        {
+          mat[cell_index++] = cell->material_id();
+        }
+      data_out.add_data_vector(mat, "material_id");
+
+      const char *components = "xyz";
+      for (unsigned int i = 0; i < dim; ++i)
+        {
+          for (unsigned int j = i; j < dim; ++j)
+            {
+              const std::string suffix{components[i], components[j]};
+              data_out.add_data_vector(
+                scalar_dof_handler, relevant_strain[i][j], "E" + suffix);
+              data_out.add_data_vector(
+                scalar_dof_handler, relevant_stress[i][j], "S" + suffix);
+            }
+        }
+      data_out.build_patches();
+
+      if (!vtu_writer)
+        {
+          vtu_writer = std::make_unique<Utils::GroupedVtuWriter<dim>>(
+            mpi_communicator, parameters.n_output_groups);
+        }
+      const std::vector<std::string> filenames = vtu_writer->write(
+        data_out, "solid-" + Utilities::int_to_string(output_index, 6) + "-");
+      if (this_mpi_process == 0)
+        {
+          for (const auto &filename : filenames)
+            {
+              times_and_names.push_back({time.current(), filename});
+            }
+          write_output([records = times_and_names]() {
+            std::ofstream pvd_output("solid.pvd");
+            DataOutBase::write_pvd_record(pvd_output, records);
+          });
         }
     }
 
@@ -297,7 +1109,7 @@ namespace Solid
     void SharedSolidSolver<dim>::refine_mesh(const unsigned int min_grid_level,
                                              const unsigned int max_grid_level)
     {
-      TimerOutput::Scope timer_section(timer, "Refine mesh");
+      Utils::ProfilingScope timer_section(timer, "Refine mesh");
       pcout << "Refining mesh..." << std::endl;
 
       Vector<float> estimated_error_per_cell(triangulation.n_active_cells());
@@ -354,8 +1166,10 @@ namespace Solid
           trans[i].prepare_for_coarsening_and_refinement(buffers[i]);
         }
 
-      // Refine the mesh
+      // Refine the mesh, the given partition is for the old cells.
       triangulation.execute_coarsening_and_refinement();
+      cell_subdomains.clear();
+      checkpoint_key.clear();
 
       // Reinitialize the system
       setup_dofs();
@@ -388,8 +1202,17 @@ namespace Solid
       else
         // If we load from previous task, we need to assemble the mass matrix
         assemble_system(true);
+      const Utils::TimeStepController controller(
+        parameters.min_time_step,
+        parameters.max_time_step,
+        parameters.target_cfl,
+        parameters.target_newton_iterations);
       while (time.end() - time.current() > 1e-12)
         {
+          if (parameters.adaptive_time_step)
+            {
+              time.set_delta_t(controller.propose(time, 0, newton_iterations));
+            }
           run_one_step(false);
         }
     }
@@ -401,55 +1224,409 @@ namespace Solid
       return current_displacement;
     }
 
+    template <int dim>
+    MPI_Datatype SharedSolidSolver<dim>::make_checkpoint_type(
+      std::vector<unsigned int> &order) const
+    {
+      // Sort the locally owned dofs by their canonical index, the file view
+      // must be monotonically increasing.
+      order.resize(canonical_dof_indices.size());
+      std::iota(order.begin(), order.end(), 0);
+      std::sort(order.begin(),
+                order.end(),
+                [this](const unsigned int a, const unsigned int b) {
+                  return canonical_dof_indices[a] < canonical_dof_indices[b];
+                });
+      std::vector<int> displacements(order.size());
+      for (unsigned int i = 0; i < order.size(); ++i)
+        {
+          displacements[i] = canonical_dof_indices[order[i]];
+        }
+      MPI_Datatype file_type;
+      int ierr = MPI_Type_create_indexed_block(
+        order.size(), 1, displacements.data(), MPI_DOUBLE, &file_type);
+      AssertThrowMPI(ierr);
+      ierr = MPI_Type_commit(&file_type);
+      AssertThrowMPI(ierr);
+      return file_type;
+    }
+
+    template <int dim>
+    void SharedSolidSolver<dim>::write_vectors(
+      const std::string &filename,
+      const std::vector<const PETScWrappers::MPI::Vector *> &vectors) const
+    {
+      const std::uint64_t n_dofs = dof_handler.n_dofs();
+      AssertThrow(n_dofs < std::numeric_limits<int>::max(),
+                  ExcMessage("Too many dofs for the checkpoint file!"));
+      MPI_File file;
+      int ierr = MPI_File_open(mpi_communicator,
+                               filename.c_str(),
+                               MPI_MODE_CREATE | MPI_MODE_WRONLY,
+                               MPI_INFO_NULL,
+                               &file);
+      AssertThrowMPI(ierr);
+      // The header holds the number of dofs and vectors, and 0 for the
+      // uncompressed values.
+      const std::uint64_t header[3] = {n_dofs, vectors.size(), 0};
+      if (this_mpi_process == 0)
+        {
+          ierr = MPI_File_write_at(
+            file, 0, header, 3, MPI_UINT64_T, MPI_STATUS_IGNORE);
+          AssertThrowMPI(ierr);
+        }
+
+      // Every process writes its own entries to their canonical positions.
+      std::vector<unsigned int> order;
+      MPI_Datatype file_type = make_checkpoint_type(order);
+
+      std::vector<double> buffer(order.size());
+      const auto begin = locally_owned_dofs.nth_index_in_set(0);
+      for (unsigned int v = 0; v < vectors.size(); ++v)
+        {
+          for (unsigned int i = 0; i < order.size(); ++i)
+            {
+              buffer[i] = (*vectors[v])(begin + order[i]);
+            }
+          const MPI_Offset offset =
+            sizeof(header) + v * n_dofs * sizeof(double);
+          ierr = MPI_File_set_view(
+            file, offset, MPI_DOUBLE, file_type, "native", MPI_INFO_NULL);
+          AssertThrowMPI(ierr);
+          ierr = MPI_File_write_all(
+            file, buffer.data(), buffer.size(), MPI_DOUBLE, MPI_STATUS_IGNORE);
+          AssertThrowMPI(ierr);
+        }
+      ierr = MPI_Type_free(&file_type);
+      AssertThrowMPI(ierr);
+      ierr = MPI_File_close(&file);
+      AssertThrowMPI(ierr);
+    }
+
+    template <int dim>
+    void SharedSolidSolver<dim>::read_vectors(
+      const std::string &filename,
+      const std::vector<PETScWrappers::MPI::Vector *> &vectors)
+    {
+      const std::uint64_t n_dofs = dof_handler.n_dofs();
+      MPI_File file;
+      int ierr = MPI_File_open(mpi_communicator,
+                               filename.c_str(),
+                               MPI_MODE_RDONLY,
+                               MPI_INFO_NULL,
+                               &file);
+      AssertThrowMPI(ierr);
+      std::uint64_t header[3];
+      ierr = MPI_File_read_at_all(
+        file, 0, header, 3, MPI_UINT64_T, MPI_STATUS_IGNORE);
+      AssertThrowMPI(ierr);
+      AssertThrow(header[0] == n_dofs && header[1] == vectors.size() &&
+                    header[2] == 0,
+                  ExcMessage("The checkpoint does not match the mesh!"));
+
+      std::vector<unsigned int> order;
+      MPI_Datatype file_type = make_checkpoint_type(order);
+
+      std::vector<double> buffer(order.size());
+      std::vector<types::global_dof_index> indices(order.size());
+      const auto begin = locally_owned_dofs.nth_index_in_set(0);
+      for (unsigned int i = 0; i < order.size(); ++i)
+        {
+          indices[i] = begin + order[i];
+        }
+      for (unsigned int v = 0; v < vectors.size(); ++v)
+        {
+          const MPI_Offset offset =
+            sizeof(header) + v * n_dofs * sizeof(double);
+          ierr = MPI_File_set_view(
+            file, offset, MPI_DOUBLE, file_type, "native", MPI_INFO_NULL);
+          AssertThrowMPI(ierr);
+          ierr = MPI_File_read_all(
+            file, buffer.data(), buffer.size(), MPI_DOUBLE, MPI_STATUS_IGNORE);
+          AssertThrowMPI(ierr);
+          vectors[v]->set(indices, buffer);
+          vectors[v]->compress(VectorOperation::insert);
+        }
+      ierr = MPI_Type_free(&file_type);
+      AssertThrowMPI(ierr);
+      ierr = MPI_File_close(&file);
+      AssertThrowMPI(ierr);
+    }
+
+    template <int dim>
+    void SharedSolidSolver<dim>::write_compressed_vectors(
+      const std::string &filename,
+      const std::vector<const PETScWrappers::MPI::Vector *> &vectors,
+      const int output_index)
+    {
+      const std::uint64_t n_dofs = dof_handler.n_dofs();
+      AssertThrow(vectors.size() * n_dofs < std::numeric_limits<int>::max(),
+                  ExcMessage("Too many dofs for the checkpoint file!"));
+      std::vector<double> values(vectors.size() * n_dofs, 0.0);
+      const auto begin = locally_owned_dofs.nth_index_in_set(0);
+      for (unsigned int v = 0; v < vectors.size(); ++v)
+        {
+          for (unsigned int i = 0; i < canonical_dof_indices.size(); ++i)
+            {
+              values[v * n_dofs + canonical_dof_indices[i]] =
+                (*vectors[v])(begin + i);
+            }
+        }
+      // Every entry is owned by exactly one process.
+      int ierr =
+        MPI_Reduce(this_mpi_process == 0 ? MPI_IN_PLACE : values.data(),
+                   values.data(),
+                   values.size(),
+                   MPI_DOUBLE,
+                   MPI_SUM,
+                   0,
+                   mpi_communicator);
+      AssertThrowMPI(ierr);
+
+      if (this_mpi_process == 0)
+        {
+          std::int64_t key = -1;
+          if (checkpoint_key.size() == values.size() &&
+              checkpoints_since_key + 1 < parameters.checkpoint_key_interval)
+            {
+              key = checkpoint_key_index;
+              ++checkpoints_since_key;
+            }
+          const std::string data = Utils::encode_values(
+            values, key >= 0 ? &checkpoint_key : nullptr);
+          if (key < 0)
+            {
+              checkpoint_key = std::move(values);
+              checkpoint_key_index = output_index;
+              checkpoints_since_key = 0;
+            }
+          // The header holds the number of dofs and vectors and 1 for the
+          // compressed values, followed by the key and the size of the
+          // compressed values.
+          const std::uint64_t header[3] = {n_dofs, vectors.size(), 1};
+          const std::uint64_t n_bytes = data.size();
+          std::ofstream out(filename, std::ios::binary);
+          out.write(reinterpret_cast<const char *>(header), sizeof(header));
+          out.write(reinterpret_cast<const char *>(&key), sizeof(key));
+          out.write(reinterpret_cast<const char *>(&n_bytes), sizeof(n_bytes));
+          out.write(data.data(), n_bytes);
+          AssertThrow(out, ExcMessage("Failed to write " + filename));
+        }
+      ierr = MPI_Barrier(mpi_communicator);
+      AssertThrowMPI(ierr);
+    }
+
+    template <int dim>
+    void SharedSolidSolver<dim>::read_compressed_values(
+      const std::string &filename, std::vector<double> &values) const
+    {
+      std::ifstream in(filename, std::ios::binary);
+      std::uint64_t header[3], n_bytes;
+      std::int64_t key;
+      in.read(reinterpret_cast<char *>(header), sizeof(header));
+      in.read(reinterpret_cast<char *>(&key), sizeof(key));
+      in.read(reinterpret_cast<char *>(&n_bytes), sizeof(n_bytes));
+      AssertThrow(in, ExcMessage("Cannot read " + filename));
+      AssertThrow(header[0] == dof_handler.n_dofs() && header[2] == 1,
+                  ExcMessage("The checkpoint does not match the mesh!"));
+      std::string data(n_bytes, '\0');
+      in.read(&data[0], n_bytes);
+      AssertThrow(in, ExcMessage("Truncated checkpoint " + filename));
+
+      std::vector<double> reference;
+      if (key >= 0)
+        {
+          fs::path key_file(filename);
+          key_file.replace_filename(Utilities::int_to_string(key, 6));
+          key_file.replace_extension(".solid_checkpoint");
+          read_compressed_values(key_file.string(), reference);
+        }
+      Utils::decode_values(data, values, key >= 0 ? &reference : nullptr);
+      AssertThrow(values.size() == header[0] * header[1],
+                  ExcMessage("Inconsistent checkpoint " + filename));
+    }
+
+    template <int dim>
+    void SharedSolidSolver<dim>::read_compressed_vectors(
+      const std::string &filename,
+      const std::vector<PETScWrappers::MPI::Vector *> &vectors)
+    {
+      const types::global_dof_index n_dofs = dof_handler.n_dofs();
+      std::vector<double> values;
+      read_compressed_values(filename, values);
+      AssertThrow(values.size() == vectors.size() * n_dofs,
+                  ExcMessage("The checkpoint does not match the mesh!"));
+
+      std::vector<types::global_dof_index> indices(
+        canonical_dof_indices.size());
+      std::vector<double> buffer(canonical_dof_indices.size());
+      const auto begin = locally_owned_dofs.nth_index_in_set(0);
+      for (unsigned int i = 0; i < indices.size(); ++i)
+        {
+          indices[i] = begin + i;
+        }
+      for (unsigned int v = 0; v < vectors.size(); ++v)
+        {
+          for (unsigned int i = 0; i < indices.size(); ++i)
+            {
+              buffer[i] = values[v * n_dofs + canonical_dof_indices[i]];
+            }
+          vectors[v]->set(indices, buffer);
+          vectors[v]->compress(VectorOperation::insert);
+        }
+    }
+
+    template <int dim>
+    bool SharedSolidSolver<dim>::compressed_checkpoint(
+      const std::string &filename) const
+    {
+      std::ifstream in(filename, std::ios::binary);
+      std::uint64_t header[3];
+      in.read(reinterpret_cast<char *>(header), sizeof(header));
+      AssertThrow(in, ExcMessage("Cannot read " + filename));
+      return header[2] == 1;
+    }
+
+    template <int dim>
+    int SharedSolidSolver<dim>::checkpoint_key_of(
+      const std::string &filename) const
+    {
+      // The key is read from the file whatever the current setting, so a
+      // key that was written with compression is never removed once it is
+      // off.
+      std::ifstream in(filename, std::ios::binary);
+      std::uint64_t header[3];
+      std::int64_t key = -1;
+      in.read(reinterpret_cast<char *>(header), sizeof(header));
+      if (!in || header[2] != 1)
+        {
+          return -1;
+        }
+      in.read(reinterpret_cast<char *>(&key), sizeof(key));
+      return in ? static_cast<int>(key) : -1;
+    }
+
+    template <int dim>
+    void SharedSolidSolver<dim>::sample_probes()
+    {
+      if (!probes.active())
+        {
+          return;
+        }
+      // The cells of this subdomain need the ghost entries.
+      PETScWrappers::MPI::Vector displacement(
+        locally_owned_dofs, locally_relevant_dofs, mpi_communicator);
+      displacement = current_displacement;
+      probes.sample(displacement, time.current(), time.time_to_output());
+    }
+
+    template <int dim>
+    void SharedSolidSolver<dim>::repartition(
+      const std::vector<types::subdomain_id> &subdomains)
+    {
+      // Replicate the solution in the canonical numbering.
+      const std::vector<PETScWrappers::MPI::Vector *> vectors = {
+        &current_displacement,
+        &current_velocity,
+        &current_acceleration,
+        &previous_displacement,
+        &previous_velocity,
+        &previous_acceleration};
+      const types::global_dof_index n_dofs = dof_handler.n_dofs();
+      std::vector<double> values(vectors.size() * n_dofs, 0.0);
+      for (unsigned int v = 0; v < vectors.size(); ++v)
+        {
+          for (unsigned int i = 0; i < canonical_dof_indices.size(); ++i)
+            {
+              values[v * n_dofs + canonical_dof_indices[i]] =
+                (*vectors[v])(locally_owned_dofs.nth_index_in_set(i));
+            }
+        }
+      Utilities::MPI::sum(values, mpi_communicator, values);
+
+      cell_subdomains = subdomains;
+      setup_dofs();
+      initialize_system();
+
+      std::vector<types::global_dof_index> indices(
+        canonical_dof_indices.size());
+      std::vector<double> buffer(canonical_dof_indices.size());
+      for (unsigned int i = 0; i < indices.size(); ++i)
+        {
+          indices[i] = locally_owned_dofs.nth_index_in_set(i);
+        }
+      for (unsigned int v = 0; v < vectors.size(); ++v)
+        {
+          for (unsigned int i = 0; i < indices.size(); ++i)
+            {
+              buffer[i] = values[v * n_dofs + canonical_dof_indices[i]];
+            }
+          vectors[v]->set(indices, buffer);
+          vectors[v]->compress(VectorOperation::insert);
+        }
+    }
+
     template <int dim>
     void SharedSolidSolver<dim>::save_checkpoint(const int output_index)
     {
-      // Save the solution
-      Vector<double> localized_disp(current_displacement);
-      Vector<double> localized_vel(current_velocity);
-      Vector<double> localized_acc(current_acceleration);
+      // Name the checkpoint file
+      fs::path checkpoint_file(fs::current_path());
+      checkpoint_file.append(Utilities::int_to_string(output_index, 6));
+      checkpoint_file.replace_extension(".solid_checkpoint");
+      pcout << "Prepare to save to " << checkpoint_file << std::endl;
+      if (output_writer)
+        {
+          // The outputs up to the checkpoint are complete when it is.
+          output_writer->wait();
+          output_writer->check(mpi_communicator);
+        }
+
+      if (parameters.checkpoint_compression)
+        {
+          write_compressed_vectors(
+            checkpoint_file.string(),
+            {&current_displacement, &current_velocity, &current_acceleration},
+            output_index);
+        }
+      else
+        {
+          write_vectors(
+            checkpoint_file.string(),
+            {&current_displacement, &current_velocity, &current_acceleration});
+        }
 
+      // Only keep the latest checkpoints and the complete ones they are the
+      // differences to, the file is complete once the vectors are written
+      // on all processes.
       if (this_mpi_process == 0)
         {
-          // Specify the current working path
-          fs::path local_path = fs::current_path();
-          // A set to store all the filenames for checkpoints
-          std::set<fs::path> checkpoints;
-          // Find the checkpoints and remove excess ones
-          // Only keep the latest one
-          for (const auto &p : fs::directory_iterator(local_path))
+          fs::path record_file(checkpoint_file);
+          record_file.replace_extension(".solid_record");
+          time.save_restart_record(record_file.string(), times_and_names);
+          std::vector<int> checkpoints;
+          for (const auto &p : fs::directory_iterator(fs::current_path()))
             {
-              if (p.path().extension() == ".solid_checkpoint_displacement")
+              if (p.path().extension() == ".solid_checkpoint")
                 {
-                  checkpoints.insert(p.path());
+                  checkpoints.push_back(
+                    Utilities::string_to_int(p.path().stem()));
                 }
             }
-          while (checkpoints.size() > 1)
-            {
-              pcout << "Removing " << *checkpoints.begin() << std::endl;
-              fs::path to_be_removed(*checkpoints.begin());
-              fs::remove(to_be_removed);
-              to_be_removed.replace_extension(".solid_checkpoint_velocity");
-              fs::remove(to_be_removed);
-              to_be_removed.replace_extension(".solid_checkpoint_acceleration");
-              fs::remove(to_be_removed);
-              checkpoints.erase(checkpoints.begin());
-            }
-          // Name the checkpoint file
-          fs::path checkpoint_file(local_path);
-          checkpoint_file.append(Utilities::int_to_string(output_index, 6));
-          checkpoint_file.replace_extension(".solid_checkpoint_displacement");
-          pcout << "Prepare to save to " << checkpoint_file << std::endl;
-          std::ofstream disp(checkpoint_file);
-          checkpoint_file.replace_extension(".solid_checkpoint_velocity");
-          pcout << "Prepare to save to " << checkpoint_file << std::endl;
-          std::ofstream vel(checkpoint_file);
-          checkpoint_file.replace_extension(".solid_checkpoint_acceleration");
-          std::ofstream acc(checkpoint_file);
-          pcout << "Prepare to save to " << checkpoint_file << std::endl;
-          localized_disp.block_write(disp);
-          localized_vel.block_write(vel);
-          localized_acc.block_write(acc);
+          auto path = [&checkpoint_file](const int step) {
+            fs::path file(checkpoint_file);
+            file.replace_filename(Utilities::int_to_string(step, 6));
+            return file.replace_extension(".solid_checkpoint");
+          };
+          const std::vector<int> stale = Utils::stale_checkpoints(
+            checkpoints, parameters.n_kept_checkpoints, [&](const int step) {
+              return checkpoint_key_of(path(step).string());
+            });
+          for (const int step : stale)
+            {
+              pcout << "Removing " << path(step) << std::endl;
+              fs::remove(path(step));
+              fs::remove(path(step).replace_extension(".solid_record"));
+            }
         }
 
       pcout << "Checkpoint file successfully saved at time step "
@@ -465,7 +1642,7 @@ namespace Solid
       // Find the latest checkpoint
       for (const auto &p : fs::directory_iterator(local_path))
         {
-          if (p.path().extension() == ".solid_checkpoint_displacement" &&
+          if (p.path().extension() == ".solid_checkpoint" &&
               (std::string(p.path().stem()) >
                  std::string(checkpoint_file.stem()) ||
                checkpoint_file == local_path))
@@ -484,42 +1661,33 @@ namespace Solid
       // set time step load the checkpoint file
       setup_dofs();
       initialize_system();
-      Vector<double> localized_disp(current_displacement);
-      Vector<double> localized_vel(current_velocity);
-      Vector<double> localized_acc(current_acceleration);
-      std::ifstream disp(checkpoint_file);
-      checkpoint_file.replace_extension(".solid_checkpoint_velocity");
-      std::ifstream vel(checkpoint_file);
-      checkpoint_file.replace_extension(".solid_checkpoint_acceleration");
-      std::ifstream acc(checkpoint_file);
-      localized_disp.block_read(disp);
-      localized_vel.block_read(vel);
-      localized_acc.block_read(acc);
-
-      current_displacement = localized_disp;
-      current_velocity = localized_vel;
-      current_acceleration = localized_acc;
+      if (compressed_checkpoint(checkpoint_file.string()))
+        {
+          read_compressed_vectors(
+            checkpoint_file.string(),
+            {&current_displacement, &current_velocity, &current_acceleration});
+        }
+      else
+        {
+          read_vectors(
+            checkpoint_file.string(),
+            {&current_displacement, &current_velocity, &current_acceleration});
+        }
+
       previous_displacement = current_displacement;
       previous_velocity = current_velocity;
       previous_acceleration = current_acceleration;
-      // Update the time and names to set the current time and write
-      // correct .pvd file.
-
-      for (int i = 0; i <= Utilities::string_to_int(checkpoint_file.stem());
-           ++i)
+      // Restore the current time and the names in the .pvd file.
+      fs::path record_file(checkpoint_file);
+      record_file.replace_extension(".solid_record");
+      time.load_restart_record(record_file.string(), times_and_names);
+      AssertThrow(static_cast<int>(time.get_timestep()) ==
+                    Utilities::string_to_int(checkpoint_file.stem()),
+                  ExcMessage("Inconsistent solid restart record!"));
+      if (this_mpi_process != 0)
         {
-          if ((time.current() == 0 || time.time_to_output()) &&
-              Utilities::MPI::this_mpi_process(mpi_communicator) == 0)
-            {
-              std::string basename =
-                "solid-" + Utilities::int_to_string(time.get_timestep(), 6);
-              std::string filename = basename + ".vtu";
-
-              times_and_names.push_back({time.current(), filename});
-            }
-          if (i == Utilities::string_to_int(checkpoint_file.stem()))
-            break;
-          time.increment();
+          // Only the first process writes the .pvd file.
+          times_and_names.clear();
         }
 
       pcout << "Checkpoint file successfully loaded from time step "
@@ -18,7 +18,7 @@ namespace Solid
         dg_fe(FE_DGQ<dim>(parameters.solid_degree)),
         volume_quad_formula(parameters.solid_degree + 1),
         face_quad_formula(parameters.solid_degree + 1),
-        mpi_communicator(MPI_COMM_WORLD),
+        mpi_communicator(tria.get_communicator()),
         pcout(std::cout,
               (Utilities::MPI::this_mpi_process(mpi_communicator) == 0)),
         time(parameters.end_time,
@@ -27,7 +27,9 @@ namespace Solid
              parameters.refinement_interval,
              parameters.save_interval),
         timer(
-          mpi_communicator, pcout, TimerOutput::never, TimerOutput::wall_times)
+          mpi_communicator, pcout, TimerOutput::never, TimerOutput::wall_times),
+        preconditioner_policy(
+          SolverPolicy::solid_preconditioner(parameters.solid_preconditioner))
     {
     }
 
@@ -37,15 +39,31 @@ namespace Solid
       dg_dof_handler.clear();
       dof_handler.clear();
       timer.print_summary();
+      if (parameters.timer_statistics)
+        {
+          timer.print_wall_time_statistics(mpi_communicator);
+        }
+      if (parameters.memory_report)
+        {
+          Utils::MemoryReport::print_peak_memory(
+            pcout.get_stream(), mpi_communicator, "Peak resident memory");
+        }
     }
 
     template <int dim>
     void SolidSolver<dim>::setup_dofs()
     {
-      TimerOutput::Scope timer_section(timer, "Setup system");
+      Utils::ProfilingScope timer_section(timer, "Setup system");
 
       dof_handler.distribute_dofs(fe);
-      DoFRenumbering::Cuthill_McKee(dof_handler);
+      if (parameters.dof_ordering == "Hierarchical")
+        {
+          DoFRenumbering::hierarchical(dof_handler);
+        }
+      else
+        {
+          DoFRenumbering::Cuthill_McKee(dof_handler);
+        }
       dg_dof_handler.distribute_dofs(dg_fe);
 
       // Extract the locally owned and relevant dofs
@@ -136,6 +154,74 @@ namespace Solid
       previous_velocity.reinit(locally_owned_dofs, mpi_communicator);
 
       previous_displacement.reinit(locally_owned_dofs, mpi_communicator);
+
+      // The matrices are new, so are the factorizations.
+      direct_solvers.clear();
+      preconditioners.clear();
+      if (preconditioner_policy.select(
+            dof_handler.n_dofs(),
+            dim,
+            Utilities::MPI::n_mpi_processes(mpi_communicator)))
+        {
+          pcout << " SOLID_PRECONDITIONER = " << preconditioner_policy.get()
+                << std::endl;
+        }
+
+      // Set up cell property, which contains the FSI traction required in FSI
+      // simulation
+      const unsigned int n_data =
+        face_quad_formula.size() * GeometryInfo<dim>::faces_per_cell;
+      for (auto cell = triangulation.begin_active();
+           cell != triangulation.end();
+           ++cell)
+        {
+          if (cell->is_locally_owned())
+            {
+              cell_property.initialize(cell, n_data);
+            }
+        }
+    }
+
+    template <int dim>
+    void SolidSolver<dim>::add_memory(Utils::MemoryReport &report) const
+    {
+      report.add("Solid mesh and dofs",
+                 triangulation.memory_consumption() +
+                   dof_handler.memory_consumption() +
+                   dg_dof_handler.memory_consumption());
+      report.add("Solid constraints", constraints.memory_consumption());
+      report.add("Solid system_matrix", system_matrix);
+      report.add("Solid mass_matrix", mass_matrix);
+      report.add("Solid stiffness_matrix", stiffness_matrix);
+      double vectors = 0;
+      for (auto vector : {&system_rhs,
+                          &current_acceleration,
+                          &current_velocity,
+                          &current_displacement,
+                          &previous_acceleration,
+                          &previous_velocity,
+                          &previous_displacement})
+        {
+          vectors += vector->memory_consumption();
+        }
+      report.add("Solid vectors", vectors);
+      report.add("Solid cell properties",
+                 Utils::cell_data_memory<CellProperty>(
+                   triangulation.n_locally_owned_active_cells(),
+                   face_quad_formula.size() *
+                     GeometryInfo<dim>::faces_per_cell));
+    }
+
+    template <int dim>
+    void SolidSolver<dim>::print_memory_report() const
+    {
+      if (!parameters.memory_report)
+        return;
+      Utils::MemoryReport report(mpi_communicator);
+      add_memory(report);
+      report.print(pcout.get_stream(),
+                   "Solid memory at time step " +
+                     Utilities::int_to_string(time.get_timestep()));
     }
 
     // Solve linear system \f$Ax = b\f$ using CG solver.
@@ -145,24 +231,103 @@ namespace Solid
                             PETScWrappers::MPI::Vector &x,
                             const PETScWrappers::MPI::Vector &b)
     {
-      TimerOutput::Scope timer_section(timer, "Solve linear system");
+      Utils::ProfilingScope timer_section(timer, "Solve linear system");
+
+      while (true)
+        {
+          try
+            {
+              return solve_once(A, x, b);
+            }
+          catch (SolverControl::NoConvergence &)
+            {
+              // The iterations exceed any limit, so the policy moves on
+              // unless there is no other candidate.
+              if (!preconditioner_policy.fail())
+                {
+                  throw;
+                }
+              pcout << " SOLID_PRECONDITIONER = "
+                    << preconditioner_policy.get() << std::endl;
+            }
+        }
+    }
+
+    template <int dim>
+    std::pair<unsigned int, double>
+    SolidSolver<dim>::solve_once(const PETScWrappers::MPI::SparseMatrix &A,
+                                 PETScWrappers::MPI::Vector &x,
+                                 const PETScWrappers::MPI::Vector &b)
+    {
+
+      if (preconditioner_policy.get() == "Direct")
+        {
+          // PETSc only factorizes the matrix again if it has been modified
+          // since the last solve, so a constant matrix is factorized once.
+          auto &direct = direct_solvers[&A];
+          const bool factorize = !direct;
+          if (factorize)
+            {
+              direct = std::make_shared<PETScWrappers::SparseDirectMUMPS>(
+                direct_solver_control, mpi_communicator);
+              direct->set_symmetric_mode(true);
+            }
+          const bool measure = factorize && parameters.memory_report;
+          const double resident =
+            measure ? Utils::MemoryReport::resident_memory() : 0.0;
+          direct->solve(A, x, b);
+          if (measure)
+            {
+              // MUMPS allocates the factors itself, which PETSc does not
+              // see, so the growth of the resident memory is the estimate.
+              Utils::MemoryReport report(mpi_communicator);
+              report.add("Solid MUMPS factors",
+                         std::max(0.0,
+                                  Utils::MemoryReport::resident_memory() -
+                                    resident));
+              report.print(pcout.get_stream(), "Solid direct solver memory");
+            }
+          constraints.distribute(x);
+
+          return {1, 0.0};
+        }
 
       SolverControl solver_control(dof_handler.n_dofs(), 1e-8 * b.l2_norm());
 
       PETScWrappers::SolverCG cg(solver_control, mpi_communicator);
 
-      PETScWrappers::PreconditionBlockJacobi preconditioner(A);
+      // The preconditioner is kept as long as the matrix is not modified.
+      auto &cached = preconditioners[&A];
+      PetscObjectState state;
+      PetscErrorCode ierr =
+        PetscObjectStateGet(reinterpret_cast<PetscObject>(static_cast<Mat>(A)),
+                            &state);
+      AssertThrow(ierr == 0, ExcPETScError(ierr));
+      if (!cached.second || cached.first != state)
+        {
+          cached.second =
+            std::make_shared<PETScWrappers::PreconditionBlockJacobi>(A);
+          ierr = PetscObjectStateGet(
+            reinterpret_cast<PetscObject>(static_cast<Mat>(A)), &cached.first);
+          AssertThrow(ierr == 0, ExcPETScError(ierr));
+        }
 
-      cg.solve(A, x, b, preconditioner);
+      cg.solve(A, x, b, *cached.second);
       constraints.distribute(x);
 
+      if (preconditioner_policy.record(solver_control.last_step()))
+        {
+          pcout << " SOLID_PRECONDITIONER = " << preconditioner_policy.get()
+                << std::endl;
+        }
+
       return {solver_control.last_step(), solver_control.last_value()};
     }
 
     template <int dim>
     void SolidSolver<dim>::output_results(const unsigned int output_index) const
     {
-      TimerOutput::Scope timer_section(timer, "Output results");
+      Utils::ProfilingScope timer_section(timer, "Output results");
       pcout << "Writing solid results..." << std::endl;
 
       std::vector<std::string> solution_names(dim, "displacements");
@@ -235,7 +400,7 @@ namespace Solid
     void SolidSolver<dim>::refine_mesh(const unsigned int min_grid_level,
                                        const unsigned int max_grid_level)
     {
-      TimerOutput::Scope timer_section(timer, "Refine mesh");
+      Utils::ProfilingScope timer_section(timer, "Refine mesh");
       pcout << "Refining mesh..." << std::endl;
 
       Vector<float> estimated_error_per_cell(triangulation.n_active_cells());
@@ -0,0 +1,425 @@
+#include "mpi_velocity_operator.h"
+
+namespace Fluid
+{
+  namespace MPI
+  {
+    template <int dim, int fe_degree, typename number>
+    VelocityOperator<dim, fe_degree, number>::VelocityOperator()
+      : MatrixFreeOperators::Base<dim, VectorType>(), with_convection(false)
+    {
+    }
+
+    template <int dim, int fe_degree, typename number>
+    void VelocityOperator<dim, fe_degree, number>::clear()
+    {
+      with_convection = false;
+      convection_value.reinit(0, 0);
+      convection_gradient.reinit(0, 0);
+      MatrixFreeOperators::Base<dim, VectorType>::clear();
+    }
+
+    template <int dim, int fe_degree, typename number>
+    void VelocityOperator<dim, fe_degree, number>::set_coefficients(
+      const double viscosity,
+      const double rho,
+      const double gamma,
+      const double dt)
+    {
+      mass_coefficient = make_vectorized_array<number>(rho / dt);
+      viscous_coefficient = make_vectorized_array<number>(viscosity);
+      grad_div_coefficient = make_vectorized_array<number>(gamma * rho);
+      convection_coefficient = make_vectorized_array<number>(rho);
+    }
+
+    template <int dim, int fe_degree, typename number>
+    void VelocityOperator<dim, fe_degree, number>::evaluate_convection(
+      const VectorType &velocity)
+    {
+      const unsigned int n_cells = this->data->n_macro_cells();
+      FEEvaluation<dim, fe_degree, fe_degree + 1, dim, number> phi(
+        *this->data);
+      convection_value.reinit(n_cells, phi.n_q_points);
+      convection_gradient.reinit(n_cells, phi.n_q_points);
+      for (unsigned int cell = 0; cell < n_cells; ++cell)
+        {
+          phi.reinit(cell);
+          phi.read_dof_values_plain(velocity);
+          phi.evaluate(true, true);
+          for (unsigned int q = 0; q < phi.n_q_points; ++q)
+            {
+              convection_value(cell, q) = phi.get_value(q);
+              convection_gradient(cell, q) = phi.get_gradient(q);
+            }
+        }
+      with_convection = true;
+    }
+
+    template <int dim, int fe_degree, typename number>
+    void VelocityOperator<dim, fe_degree, number>::do_quadrature(
+      FEEvaluation<dim, fe_degree, fe_degree + 1, dim, number> &phi,
+      const unsigned int cell) const
+    {
+      phi.evaluate(true, true);
+      for (unsigned int q = 0; q < phi.n_q_points; ++q)
+        {
+          const Tensor<1, dim, VectorizedArray<number>> u = phi.get_value(q);
+          const Tensor<2, dim, VectorizedArray<number>> grad_u =
+            phi.get_gradient(q);
+          Tensor<1, dim, VectorizedArray<number>> value_term =
+            u * mass_coefficient;
+          Tensor<2, dim, VectorizedArray<number>> gradient_term =
+            grad_u * viscous_coefficient;
+          const VectorizedArray<number> div_u =
+            trace(grad_u) * grad_div_coefficient;
+          for (unsigned int d = 0; d < dim; ++d)
+            gradient_term[d][d] += div_u;
+          if (with_convection)
+            {
+              value_term += (convection_gradient(cell, q) * u +
+                             grad_u * convection_value(cell, q)) *
+                            convection_coefficient;
+            }
+          phi.submit_value(value_term, q);
+          phi.submit_gradient(gradient_term, q);
+        }
+      phi.integrate(true, true);
+    }
+
+    template <int dim, int fe_degree, typename number>
+    void VelocityOperator<dim, fe_degree, number>::local_apply(
+      const MatrixFree<dim, number> &data,
+      VectorType &dst,
+      const VectorType &src,
+      const std::pair<unsigned int, unsigned int> &cell_range) const
+    {
+      FEEvaluation<dim, fe_degree, fe_degree + 1, dim, number> phi(data);
+      for (unsigned int cell = cell_range.first; cell < cell_range.second;
+           ++cell)
+        {
+          phi.reinit(cell);
+          phi.read_dof_values(src);
+          do_quadrature(phi, cell);
+          phi.distribute_local_to_global(dst);
+        }
+    }
+
+    template <int dim, int fe_degree, typename number>
+    void VelocityOperator<dim, fe_degree, number>::apply_add(
+      VectorType &dst, const VectorType &src) const
+    {
+      this->data->cell_loop(&VelocityOperator::local_apply, this, dst, src);
+    }
+
+    template <int dim, int fe_degree, typename number>
+    void VelocityOperator<dim, fe_degree, number>::local_compute_diagonal(
+      const MatrixFree<dim, number> &data,
+      VectorType &dst,
+      const unsigned int &,
+      const std::pair<unsigned int, unsigned int> &cell_range) const
+    {
+      FEEvaluation<dim, fe_degree, fe_degree + 1, dim, number> phi(data);
+      AlignedVector<VectorizedArray<number>> diagonal(phi.dofs_per_cell);
+      for (unsigned int cell = cell_range.first; cell < cell_range.second;
+           ++cell)
+        {
+          phi.reinit(cell);
+          for (unsigned int i = 0; i < phi.dofs_per_cell; ++i)
+            {
+              for (unsigned int j = 0; j < phi.dofs_per_cell; ++j)
+                phi.begin_dof_values()[j] = VectorizedArray<number>();
+              phi.begin_dof_values()[i] = make_vectorized_array<number>(1.);
+              do_quadrature(phi, cell);
+              diagonal[i] = phi.begin_dof_values()[i];
+            }
+          for (unsigned int i = 0; i < phi.dofs_per_cell; ++i)
+            phi.begin_dof_values()[i] = diagonal[i];
+          phi.distribute_local_to_global(dst);
+        }
+    }
+
+    template <int dim, int fe_degree, typename number>
+    void VelocityOperator<dim, fe_degree, number>::compute_diagonal()
+    {
+      this->inverse_diagonal_entries.reset(new DiagonalMatrix<VectorType>());
+      VectorType &inverse_diagonal =
+        this->inverse_diagonal_entries->get_vector();
+      this->data->initialize_dof_vector(inverse_diagonal);
+      unsigned int dummy = 0;
+      this->data->cell_loop(&VelocityOperator::local_compute_diagonal,
+                            this,
+                            inverse_diagonal,
+                            dummy);
+      this->set_constrained_entries_to_one(inverse_diagonal);
+      for (unsigned int i = 0; i < inverse_diagonal.local_size(); ++i)
+        {
+          Assert(inverse_diagonal.local_element(i) > 0.,
+                 ExcMessage("The diagonal of the velocity operator should be "
+                            "positive!"));
+          inverse_diagonal.local_element(i) =
+            1. / inverse_diagonal.local_element(i);
+        }
+    }
+
+    template <int dim>
+    MatrixFreeVelocitySolver<dim>::MatrixFreeVelocitySolver(
+      parallel::distributed::Triangulation<dim> &tria,
+      const Parameters::AllParameters &parameters)
+      : triangulation(tria),
+        parameters(parameters),
+        fe(FE_Q<dim>(fe_degree), dim),
+        dof_handler(triangulation),
+        current_dt(0)
+    {
+      AssertThrow(parameters.fluid_velocity_degree == fe_degree,
+                  ExcMessage("The matrix-free velocity solver is only "
+                             "compiled for quadratic velocity elements!"));
+    }
+
+    template <int dim>
+    void MatrixFreeVelocitySolver<dim>::make_constraints()
+    {
+      IndexSet locally_relevant_dofs;
+      DoFTools::extract_locally_relevant_dofs(dof_handler,
+                                              locally_relevant_dofs);
+      constraints.clear();
+      constraints.reinit(locally_relevant_dofs);
+      DoFTools::make_hanging_node_constraints(dof_handler, constraints);
+
+      mg_constrained_dofs.clear();
+      mg_constrained_dofs.initialize(dof_handler);
+      for (auto itr = parameters.fluid_dirichlet_bcs.begin();
+           itr != parameters.fluid_dirichlet_bcs.end();
+           ++itr)
+        {
+          // 1-x, 2-y, 3-xy, 4-z, 5-xz, 6-yz, 7-xyz
+          const unsigned int flag = itr->second.first;
+          std::vector<bool> mask(dim, false);
+          for (unsigned int d = 0; d < dim; ++d)
+            mask[d] = (flag >> d) & 1;
+          VectorTools::interpolate_boundary_values(
+            dof_handler,
+            itr->first,
+            Functions::ZeroFunction<dim>(dim),
+            constraints,
+            ComponentMask(mask));
+          mg_constrained_dofs.make_zero_boundary_constraints(
+            dof_handler,
+            std::set<types::boundary_id>{
+              static_cast<types::boundary_id>(itr->first)},
+            ComponentMask(mask));
+        }
+      constraints.close();
+    }
+
+    template <int dim>
+    void MatrixFreeVelocitySolver<dim>::setup(
+      const DoFHandler<dim> &system_dof_handler)
+    {
+      AssertThrow(triangulation.is_multilevel_hierarchy_constructed(),
+                  ExcMessage("The matrix-free velocity solver requires a "
+                             "triangulation created with the settings of "
+                             "InsIM::triangulation_settings!"));
+      preconditioner.reset();
+      mg.reset();
+      mg_interface.reset();
+      mg_matrix.reset();
+      system_matrix.clear();
+      mg_matrices.clear_elements();
+      mg_interface_matrices.clear_elements();
+      mg_transfer.clear();
+      current_dt = 0;
+
+      dof_handler.distribute_dofs(fe);
+      dof_handler.distribute_mg_dofs();
+      make_constraints();
+
+      // The operator on the active cells in double precision.
+      {
+        typename MatrixFree<dim, double>::AdditionalData additional_data;
+        additional_data.tasks_parallel_scheme =
+          MatrixFree<dim, double>::AdditionalData::none;
+        additional_data.mapping_update_flags =
+          (update_values | update_gradients | update_JxW_values);
+        std::shared_ptr<MatrixFree<dim, double>> storage(
+          new MatrixFree<dim, double>());
+        storage->reinit(
+          dof_handler, constraints, QGauss<1>(fe_degree + 1), additional_data);
+        system_matrix.initialize(storage);
+      }
+      system_matrix.initialize_dof_vector(convection);
+      system_matrix.initialize_dof_vector(src_buffer);
+      system_matrix.initialize_dof_vector(dst_buffer);
+
+      // The level operators in single precision.
+      const unsigned int n_levels = triangulation.n_global_levels();
+      mg_matrices.resize(0, n_levels - 1);
+      for (unsigned int level = 0; level < n_levels; ++level)
+        {
+          IndexSet relevant_dofs;
+          DoFTools::extract_locally_relevant_level_dofs(
+            dof_handler, level, relevant_dofs);
+          AffineConstraints<double> level_constraints;
+          level_constraints.reinit(relevant_dofs);
+          level_constraints.add_lines(
+            mg_constrained_dofs.get_boundary_indices(level));
+          level_constraints.close();
+
+          typename MatrixFree<dim, float>::AdditionalData additional_data;
+          additional_data.tasks_parallel_scheme =
+            MatrixFree<dim, float>::AdditionalData::none;
+          additional_data.mapping_update_flags =
+            (update_values | update_gradients | update_JxW_values);
+          additional_data.level_mg_handler = level;
+          std::shared_ptr<MatrixFree<dim, float>> storage(
+            new MatrixFree<dim, float>());
+          storage->reinit(dof_handler,
+                          level_constraints,
+                          QGauss<1>(fe_degree + 1),
+                          additional_data);
+          mg_matrices[level].initialize(storage, mg_constrained_dofs, level);
+        }
+      mg_transfer.initialize_constraints(mg_constrained_dofs);
+      mg_transfer.build(dof_handler);
+
+      // Map the locally owned velocity dofs to the fluid system dofs. Both
+      // DoFHandlers live on the same triangulation, so their active cells
+      // are traversed in the same order.
+      const IndexSet &owned = dof_handler.locally_owned_dofs();
+      const FiniteElement<dim> &system_fe = system_dof_handler.get_fe();
+      system_indices.assign(owned.n_elements(), 0);
+      values_buffer.resize(owned.n_elements());
+      std::vector<types::global_dof_index> system_dofs(
+        system_fe.dofs_per_cell);
+      std::vector<types::global_dof_index> velocity_dofs(fe.dofs_per_cell);
+      auto velocity_cell = dof_handler.begin_active();
+      for (auto cell = system_dof_handler.begin_active();
+           cell != system_dof_handler.end();
+           ++cell, ++velocity_cell)
+        {
+          if (!cell->is_locally_owned())
+            continue;
+          cell->get_dof_indices(system_dofs);
+          velocity_cell->get_dof_indices(velocity_dofs);
+          for (unsigned int i = 0; i < system_fe.dofs_per_cell; ++i)
+            {
+              const auto component = system_fe.system_to_component_index(i);
+              if (component.first >= dim)
+                continue;
+              const unsigned int j = fe.component_to_system_index(
+                component.first, component.second);
+              if (owned.is_element(velocity_dofs[j]))
+                {
+                  system_indices[owned.index_within_set(velocity_dofs[j])] =
+                    system_dofs[i];
+                }
+            }
+        }
+    }
+
+    template <int dim>
+    void MatrixFreeVelocitySolver<dim>::setup_multigrid()
+    {
+      const unsigned int n_levels = triangulation.n_global_levels();
+      MGLevelObject<typename SmootherType::AdditionalData> smoother_data;
+      smoother_data.resize(0, n_levels - 1);
+      for (unsigned int level = 0; level < n_levels; ++level)
+        {
+          if (level > 0)
+            {
+              smoother_data[level].smoothing_range = 15.;
+              smoother_data[level].degree = 5;
+              smoother_data[level].eig_cg_n_iterations = 10;
+            }
+          else
+            {
+              // Chebyshev is used as the coarse solver.
+              smoother_data[0].smoothing_range = 1e-3;
+              smoother_data[0].degree = numbers::invalid_unsigned_int;
+              smoother_data[0].eig_cg_n_iterations = mg_matrices[0].m();
+            }
+          mg_matrices[level].compute_diagonal();
+          smoother_data[level].preconditioner =
+            mg_matrices[level].get_matrix_diagonal_inverse();
+        }
+      mg_smoother.initialize(mg_matrices, smoother_data);
+      mg_coarse.initialize(mg_smoother);
+
+      mg_interface_matrices.resize(0, n_levels - 1);
+      for (unsigned int level = 0; level < n_levels; ++level)
+        mg_interface_matrices[level].initialize(mg_matrices[level]);
+
+      mg_matrix = std::make_shared<mg::Matrix<LevelVectorType>>(mg_matrices);
+      mg_interface =
+        std::make_shared<mg::Matrix<LevelVectorType>>(mg_interface_matrices);
+      mg = std::make_shared<Multigrid<LevelVectorType>>(
+        *mg_matrix, mg_coarse, mg_transfer, mg_smoother, mg_smoother);
+      mg->set_edge_matrices(*mg_interface, *mg_interface);
+      preconditioner = std::make_shared<
+        PreconditionMG<dim, LevelVectorType, MGTransferMatrixFree<dim, float>>>(
+        dof_handler, *mg, mg_transfer);
+    }
+
+    template <int dim>
+    void MatrixFreeVelocitySolver<dim>::update(
+      const PETScWrappers::MPI::BlockVector &evaluation_point, const double dt)
+    {
+      system_matrix.set_coefficients(
+        parameters.viscosity, parameters.fluid_rho, parameters.grad_div, dt);
+      evaluation_point.block(0).extract_subvector_to(system_indices,
+                                                     values_buffer);
+      for (unsigned int i = 0; i < values_buffer.size(); ++i)
+        convection.local_element(i) = values_buffer[i];
+      convection.update_ghost_values();
+      system_matrix.evaluate_convection(convection);
+      convection.zero_out_ghosts();
+
+      // The level operators only depend on the time step.
+      if (dt != current_dt)
+        {
+          for (unsigned int level = mg_matrices.min_level();
+               level <= mg_matrices.max_level();
+               ++level)
+            {
+              mg_matrices[level].set_coefficients(parameters.viscosity,
+                                                  parameters.fluid_rho,
+                                                  parameters.grad_div,
+                                                  dt);
+            }
+          setup_multigrid();
+          current_dt = dt;
+        }
+    }
+
+    template <int dim>
+    unsigned int MatrixFreeVelocitySolver<dim>::solve(
+      PETScWrappers::MPI::Vector &dst,
+      const PETScWrappers::MPI::Vector &src) const
+    {
+      AssertThrow(preconditioner, ExcMessage("update() is not called!"));
+      src.extract_subvector_to(system_indices, values_buffer);
+      for (unsigned int i = 0; i < values_buffer.size(); ++i)
+        src_buffer.local_element(i) = values_buffer[i];
+      dst_buffer = 0;
+
+      SolverControl solver_control(
+        src_buffer.size(), std::max(1e-10, 1e-2 * src_buffer.l2_norm()));
+      SolverGMRES<VectorType> gmres(solver_control);
+      gmres.solve(system_matrix, dst_buffer, src_buffer, *preconditioner);
+
+      for (unsigned int i = 0; i < values_buffer.size(); ++i)
+        values_buffer[i] = dst_buffer.local_element(i);
+      dst = 0;
+      dst.set(system_indices, values_buffer);
+      dst.compress(VectorOperation::insert);
+      return solver_control.last_step();
+    }
+
+    template class VelocityOperator<2, 2, double>;
+    template class VelocityOperator<2, 2, float>;
+    template class VelocityOperator<3, 2, double>;
+    template class VelocityOperator<3, 2, float>;
+    template class MatrixFreeVelocitySolver<2>;
+    template class MatrixFreeVelocitySolver<3>;
+  } // namespace MPI
+} // namespace Fluid
@@ -34,6 +34,140 @@ namespace Parameters
         "",
         Patterns::List(dealii::Patterns::Double()),
         "Gravity acceleration that applies to both fluid and solid");
+      prm.declare_entry("Number of threads",
+                        "1",
+                        Patterns::Integer(0),
+                        "Number of threads per MPI process (or of the serial "
+                        "solvers) used in assembly and in the FSI coupling, "
+                        "0 means as many as available");
+      prm.declare_entry("Asynchronous checkpoint",
+                        "false",
+                        Patterns::Bool(),
+                        "Write the fluid checkpoint in a background thread");
+      prm.declare_entry("Checkpoint compression",
+                        "false",
+                        Patterns::Bool(),
+                        "Compress the solution in the checkpoints");
+      prm.declare_entry("Checkpoint key interval",
+                        "0",
+                        Patterns::Integer(0),
+                        "Number of compressed checkpoints per full one, the "
+                        "others store the difference to it");
+      prm.declare_entry("Checkpoints to keep",
+                        "1",
+                        Patterns::Integer(1),
+                        "Number of checkpoints kept for restart");
+      prm.declare_entry("Timer statistics",
+                        "false",
+                        Patterns::Bool(),
+                        "Print the spread of the timer sections over the "
+                        "processes");
+      prm.declare_entry("Memory report",
+                        "false",
+                        Patterns::Bool(),
+                        "Print the memory of the parallel solvers per "
+                        "subsystem");
+      prm.declare_entry("Output groups",
+                        "0",
+                        Patterns::Integer(0),
+                        "Number of files written collectively per output, "
+                        "0 means one file per process");
+      prm.declare_entry("Asynchronous output",
+                        "false",
+                        Patterns::Bool(),
+                        "Write the output files in a background thread");
+      prm.declare_entry("Output queue length",
+                        "2",
+                        Patterns::Integer(1),
+                        "Outputs waiting for the background writer before "
+                        "the time stepping waits");
+      prm.declare_entry("DoF ordering",
+                        "Cuthill_McKee",
+                        Patterns::Selection("Cuthill_McKee|Hierarchical"),
+                        "Ordering of the degrees of freedom, Hierarchical "
+                        "follows the Morton order of the cells");
+      prm.declare_entry("Fluid probe points",
+                        "",
+                        Patterns::Anything(),
+                        "Points separated by semicolons where the fluid "
+                        "solution is written at every time step");
+      prm.declare_entry("Solid probe points",
+                        "",
+                        Patterns::Anything(),
+                        "Points separated by semicolons (reference "
+                        "configuration) where the solid displacement is "
+                        "written at every time step");
+      for (const std::string solver : {"Fluid", "Solid"})
+        {
+          prm.declare_entry(solver + " output box",
+                            "",
+                            Patterns::List(Patterns::Double()),
+                            "Only write the cells overlapping the box "
+                            "x_min, x_max, y_min, y_max, z_min, z_max");
+          prm.declare_entry(solver + " output plane",
+                            "",
+                            Patterns::List(Patterns::Double()),
+                            "Only write the cells cut by the plane through "
+                            "the point and with the normal given");
+        }
+      prm.declare_entry("Fluid output subdivisions",
+                        "0",
+                        Patterns::Integer(0),
+                        "Subdivisions of every fluid cell in the output, "
+                        "0 means the pressure degree");
+      prm.declare_entry("Adaptive time step",
+                        "false",
+                        Patterns::Bool(),
+                        "Adapt the time step to the CFL number and the "
+                        "Newton iterations");
+      prm.declare_entry("Minimum time step",
+                        "0",
+                        Patterns::Double(0.0),
+                        "Lower bound of the adaptive time step");
+      prm.declare_entry("Maximum time step",
+                        "0",
+                        Patterns::Double(0.0),
+                        "Upper bound of the adaptive time step, "
+                        "0 means no bound");
+      prm.declare_entry("Target CFL number",
+                        "1",
+                        Patterns::Double(0.0),
+                        "CFL number of the fluid that the adaptive time step "
+                        "aims at, 0 means not used");
+      prm.declare_entry("Target Newton iterations",
+                        "4",
+                        Patterns::Integer(0),
+                        "Newton iterations per time step that the adaptive "
+                        "time step aims at, 0 means not used");
+      prm.declare_entry("Inexact Newton",
+                        "false",
+                        Patterns::Bool(),
+                        "Choose the tolerances of the linear solves from the "
+                        "reduction of the nonlinear residual");
+      prm.declare_entry("Maximum forcing term",
+                        "0.1",
+                        Patterns::Double(0.0, 1.0),
+                        "Largest relative tolerance of a linear solve in the "
+                        "inexact Newton method");
+      prm.declare_entry("Steady state",
+                        "false",
+                        Patterns::Bool(),
+                        "March to the steady state with pseudo time steps "
+                        "instead of solving until the end time");
+      prm.declare_entry("Steady state tolerance",
+                        "1e-6",
+                        Patterns::Double(0.0),
+                        "Reduction of the steady residual that ends the "
+                        "pseudo time stepping");
+      prm.declare_entry("Maximum pseudo time step",
+                        "1e10",
+                        Patterns::Double(0.0),
+                        "Upper bound of the pseudo time step");
+      prm.declare_entry("Maximum pseudo time steps",
+                        "100",
+                        Patterns::Integer(1),
+                        "Pseudo time steps before giving up on the steady "
+                        "state");
     }
     prm.leave_subsection();
   }
@@ -60,6 +194,52 @@ namespace Parameters
       gravity = Utilities::string_to_double(parsed_input);
       AssertThrow(static_cast<int>(gravity.size()) == dimension,
                   ExcMessage("Inconsistent dimension of gravity!"));
+      n_threads = prm.get_integer("Number of threads");
+      async_checkpoint = prm.get_bool("Asynchronous checkpoint");
+      checkpoint_compression = prm.get_bool("Checkpoint compression");
+      checkpoint_key_interval = prm.get_integer("Checkpoint key interval");
+      n_kept_checkpoints = prm.get_integer("Checkpoints to keep");
+      timer_statistics = prm.get_bool("Timer statistics");
+      memory_report = prm.get_bool("Memory report");
+      n_output_groups = prm.get_integer("Output groups");
+      async_output = prm.get_bool("Asynchronous output");
+      output_queue_length = prm.get_integer("Output queue length");
+      dof_ordering = prm.get("DoF ordering");
+      auto parse_points = [this](const std::string &raw) {
+        std::vector<std::vector<double>> points;
+        for (const auto &point : Utilities::split_string_list(raw, ';'))
+          {
+            points.push_back(
+              Utilities::string_to_double(Utilities::split_string_list(point)));
+            AssertThrow(static_cast<int>(points.back().size()) == dimension,
+                        ExcMessage("Inconsistent dimension of probe point!"));
+          }
+        return points;
+      };
+      fluid_probe_points = parse_points(prm.get("Fluid probe points"));
+      solid_probe_points = parse_points(prm.get("Solid probe points"));
+      auto parse_list = [&prm](const std::string &entry) {
+        return Utilities::string_to_double(
+          Utilities::split_string_list(prm.get(entry)));
+      };
+      fluid_output_box = parse_list("Fluid output box");
+      fluid_output_plane = parse_list("Fluid output plane");
+      fluid_output_subdivisions = prm.get_integer("Fluid output subdivisions");
+      solid_output_box = parse_list("Solid output box");
+      solid_output_plane = parse_list("Solid output plane");
+      adaptive_time_step = prm.get_bool("Adaptive time step");
+      min_time_step = prm.get_double("Minimum time step");
+      max_time_step = prm.get_double("Maximum time step");
+      target_cfl = prm.get_double("Target CFL number");
+      target_newton_iterations = prm.get_integer("Target Newton iterations");
+      inexact_newton = prm.get_bool("Inexact Newton");
+      max_forcing_term = prm.get_double("Maximum forcing term");
+      steady_state = prm.get_bool("Steady state");
+      steady_tolerance = prm.get_double("Steady state tolerance");
+      max_pseudo_time_step = prm.get_double("Maximum pseudo time step");
+      max_pseudo_time_steps = prm.get_integer("Maximum pseudo time steps");
+      AssertThrow(!steady_state || !adaptive_time_step,
+                  ExcMessage("The pseudo time step is adapted by itself!"));
     }
     prm.leave_subsection();
   }
@@ -131,6 +311,63 @@ namespace Parameters
         "1e-10",
         Patterns::Double(0.0),
         "The absolute tolerance of the nonlinear system residual");
+      prm.declare_entry("Preconditioner rebuild iterations",
+                        "0",
+                        Patterns::Integer(0),
+                        "Reuse the preconditioner until the linear solver "
+                        "needs more iterations than this (0: never reuse)");
+      prm.declare_entry("Preconditioner rebuild inner iterations",
+                        "0",
+                        Patterns::Integer(0),
+                        "Rebuild the preconditioner when the inner solver "
+                        "needs more iterations than this (0: ignored)");
+      prm.declare_entry("Krylov recycling vectors",
+                        "0",
+                        Patterns::Integer(0),
+                        "Number of directions kept to deflate the next "
+                        "linear solves (0: no recycling)");
+      prm.declare_entry("Single precision preconditioner",
+                        "false",
+                        Patterns::Bool(),
+                        "Store the matrices of the inner preconditioner "
+                        "solves in single precision");
+      prm.declare_entry("Pressure preconditioner",
+                        "Euclid",
+                        Patterns::Selection("Euclid|Pilut|BoomerAMG|Auto"),
+                        "Preconditioner of the Schur complement solve");
+      prm.declare_entry(
+        "Velocity solver",
+        "MUMPS",
+        Patterns::Selection("MUMPS|AMG|AMG-GMRES|MatrixFree|Auto"),
+        "Solver of the velocity block in the preconditioner");
+      prm.declare_entry("Reuse direct solver analysis",
+                        "false",
+                        Patterns::Bool(),
+                        "Keep the symbolic factorization of MUMPS between "
+                        "time steps");
+      prm.declare_entry("Artificial fluid cell weight",
+                        "1",
+                        Patterns::Double(1.0),
+                        "Cost of an artificial fluid cell relative to a "
+                        "plain fluid cell when the mesh is partitioned");
+      prm.declare_entry("PML cell weight",
+                        "1",
+                        Patterns::Double(1.0),
+                        "Cost of a cell with PML damping relative to a "
+                        "plain fluid cell when the mesh is partitioned");
+      prm.declare_entry("Predictor order",
+                        "0",
+                        Patterns::Integer(0, 2),
+                        "Order of the extrapolation of the initial guess "
+                        "from the previous solutions");
+      prm.declare_entry("Krylov variant",
+                        "Standard",
+                        Patterns::Selection("Standard|Pipelined"),
+                        "Krylov methods of the inner preconditioner solves");
+      prm.declare_entry("Schur complement approximation",
+                        "Exact",
+                        Patterns::Selection("Exact|Diagonal"),
+                        "Operator of the inner Tpp solve of SCnsIM");
     }
     prm.leave_subsection();
   }
@@ -142,6 +379,87 @@ namespace Parameters
       grad_div = prm.get_double("Grad-Div stabilization");
       fluid_max_iterations = prm.get_integer("Max Newton iterations");
       fluid_tolerance = prm.get_double("Nonlinear system tolerance");
+      fluid_pc_rebuild_iterations =
+        prm.get_integer("Preconditioner rebuild iterations");
+      fluid_pc_rebuild_inner_iterations =
+        prm.get_integer("Preconditioner rebuild inner iterations");
+      fluid_recycle_vectors = prm.get_integer("Krylov recycling vectors");
+      fluid_single_precision_pc =
+        prm.get_bool("Single precision preconditioner");
+      fluid_pressure_pc = prm.get("Pressure preconditioner");
+      fluid_velocity_solver = prm.get("Velocity solver");
+      fluid_reuse_direct_analysis =
+        prm.get_bool("Reuse direct solver analysis");
+      artificial_fluid_cell_weight =
+        prm.get_double("Artificial fluid cell weight");
+      pml_cell_weight = prm.get_double("PML cell weight");
+      fluid_predictor_order = prm.get_integer("Predictor order");
+      fluid_krylov_variant = prm.get("Krylov variant");
+      fluid_schur_approximation = prm.get("Schur complement approximation");
+    }
+    prm.leave_subsection();
+  }
+
+  void FluidPressurePreconditioner::declareParameters(ParameterHandler &prm)
+  {
+    prm.enter_subsection("Fluid pressure preconditioner");
+    {
+      prm.declare_entry("Euclid fill levels",
+                        "1",
+                        Patterns::Integer(0),
+                        "Levels of fill of the Euclid ILU(k)");
+      prm.declare_entry("Euclid block Jacobi",
+                        "false",
+                        Patterns::Bool(),
+                        "Use the block Jacobi ILU(k) instead of the "
+                        "parallel ILU(k)");
+      prm.declare_entry("Pilut max iterations",
+                        "20",
+                        Patterns::Integer(1),
+                        "Maximum iterations of the Pilut ILUT");
+      prm.declare_entry("Pilut row size",
+                        "20",
+                        Patterns::Integer(1),
+                        "Maximum nonzeros per row of the Pilut factors");
+      prm.declare_entry("Pilut drop tolerance",
+                        "1e-4",
+                        Patterns::Double(0.0),
+                        "Drop tolerance of the Pilut ILUT");
+      prm.declare_entry("Tune preconditioner",
+                        "false",
+                        Patterns::Bool(),
+                        "Try the candidates in the first time steps and "
+                        "keep the fastest one");
+      prm.declare_entry("Tuning fill levels",
+                        "0, 1, 2",
+                        Patterns::List(Patterns::Integer(0)),
+                        "Euclid fill levels tried by the tuning");
+      prm.declare_entry("Tuning drop tolerances",
+                        "1e-4, 1e-3, 1e-2",
+                        Patterns::List(Patterns::Double(0.0)),
+                        "Pilut drop tolerances tried by the tuning");
+    }
+    prm.leave_subsection();
+  }
+
+  void FluidPressurePreconditioner::parseParameters(ParameterHandler &prm)
+  {
+    prm.enter_subsection("Fluid pressure preconditioner");
+    {
+      euclid_levels = prm.get_integer("Euclid fill levels");
+      euclid_block_jacobi = prm.get_bool("Euclid block Jacobi");
+      pilut_max_iterations = prm.get_integer("Pilut max iterations");
+      pilut_row_size = prm.get_integer("Pilut row size");
+      pilut_tolerance = prm.get_double("Pilut drop tolerance");
+      tune_pressure_pc = prm.get_bool("Tune preconditioner");
+      tuning_levels.clear();
+      for (const int level : Utilities::string_to_int(
+             Utilities::split_string_list(prm.get("Tuning fill levels"))))
+        {
+          tuning_levels.push_back(level);
+        }
+      tuning_tolerances = Utilities::string_to_double(
+        Utilities::split_string_list(prm.get("Tuning drop tolerances")));
     }
     prm.leave_subsection();
   }
@@ -398,6 +716,30 @@ namespace Parameters
                         "1e-10",
                         Patterns::Double(0.0),
                         "The tolerance of the force equilibrium");
+      prm.declare_entry(
+        "Preconditioner",
+        "None",
+        Patterns::Selection("None|Jacobi|BlockJacobi|AMG|GMG|Direct|Auto"),
+        "Preconditioner of the linear solver, or a direct solver");
+      prm.declare_entry("Multigrid smoothing steps",
+                        "2",
+                        Patterns::Integer(1),
+                        "Chebyshev iterations of the GMG smoother");
+      prm.declare_entry("Newton method",
+                        "Full",
+                        Patterns::Selection("Full|Modified|BFGS"),
+                        "Rebuild the tangent at every iteration, or freeze "
+                        "it (Modified), optionally with BFGS updates");
+      prm.declare_entry("Tangent refresh ratio",
+                        "0.5",
+                        Patterns::Double(0.0, 1.0),
+                        "Rebuild a frozen tangent when the residual decreases "
+                        "by less than this factor in one iteration");
+      prm.declare_entry("Time integration",
+                        "Implicit",
+                        Patterns::Selection("Implicit|Explicit"),
+                        "Implicit Newmark or explicit central difference "
+                        "with a lumped mass matrix");
     }
     prm.leave_subsection();
   }
@@ -410,6 +752,11 @@ namespace Parameters
       solid_max_iterations = prm.get_integer("Max Newton iterations");
       tol_d = prm.get_double("Displacement tolerance");
       tol_f = prm.get_double("Force tolerance");
+      solid_preconditioner = prm.get("Preconditioner");
+      solid_smoothing_steps = prm.get_integer("Multigrid smoothing steps");
+      solid_newton_method = prm.get("Newton method");
+      tangent_refresh_ratio = prm.get_double("Tangent refresh ratio");
+      solid_time_integration = prm.get("Time integration");
     }
     prm.leave_subsection();
   }
@@ -517,6 +864,138 @@ namespace Parameters
     prm.leave_subsection();
   }
 
+  void FSISolver::declareParameters(ParameterHandler &prm)
+  {
+    prm.enter_subsection("FSI solver control");
+    {
+      prm.declare_entry("Distributed solid state",
+                        "false",
+                        Patterns::Bool(),
+                        "Only ghost the solid state near the local fluid "
+                        "subdomain instead of localizing it everywhere");
+      prm.declare_entry("Node shared solid state",
+                        "false",
+                        Patterns::Bool(),
+                        "Keep the localized solid displacement and vertex "
+                        "coordinates once per node in MPI-3 shared memory");
+      prm.declare_entry("Overlap traction exchange",
+                        "false",
+                        Patterns::Bool(),
+                        "Use the lagged solid state in the fluid solve and "
+                        "overlap the traction exchange and the solid "
+                        "solve with it");
+      prm.declare_entry("Solid processes",
+                        "0",
+                        Patterns::Integer(0),
+                        "Number of processes that solve the solid, 0 means "
+                        "all of them");
+      prm.declare_entry("Coupling iterations",
+                        "1",
+                        Patterns::Integer(1),
+                        "Maximum number of coupling iterations per time step, "
+                        "1 is the explicit scheme");
+      prm.declare_entry("Coupling tolerance",
+                        "1e-4",
+                        Patterns::Double(0.0),
+                        "Relative change of the interface traction at which "
+                        "the coupling iterations stop");
+      prm.declare_entry("Coupling acceleration",
+                        "Aitken",
+                        Patterns::Selection("Aitken|IQN-ILS"),
+                        "Acceleration of the coupling iterations");
+      prm.declare_entry("Coupling relaxation",
+                        "0.5",
+                        Patterns::Double(0.0, 1.0),
+                        "Relaxation of the first coupling iteration of a "
+                        "time step");
+      prm.declare_entry("Performance log",
+                        "",
+                        Patterns::Anything(),
+                        "CSV file to write the per time step performance "
+                        "counters to, leave empty to disable");
+      prm.declare_entry("Indicator band layers",
+                        "0",
+                        Patterns::Integer(0),
+                        "Number of fluid cell layers around the solid "
+                        "boundary where the indicator is updated, 0 means "
+                        "all cells");
+      prm.declare_entry("Artificial fluid band layers",
+                        "0",
+                        Patterns::Integer(0),
+                        "Number of artificial fluid cell layers next to the "
+                        "real fluid that are solved, 0 means all cells");
+      prm.declare_entry("Refinement criterion",
+                        "Distance",
+                        Patterns::Selection("Distance|Band"),
+                        "Refine the fluid cells near the solid boundary "
+                        "points or in a band around the indicator interface");
+      prm.declare_entry("Refinement band layers",
+                        "1",
+                        Patterns::Integer(0),
+                        "Number of fluid cell layers on both sides of the "
+                        "indicator interface that are refined");
+      prm.declare_entry("Load imbalance tolerance",
+                        "0",
+                        Patterns::Double(0.0),
+                        "Repartition the fluid mesh when the maximum over "
+                        "the average fluid cell cost exceeds this, 0 disables "
+                        "it");
+      prm.declare_entry("Repartition interval",
+                        "10",
+                        Patterns::Integer(1),
+                        "Minimum number of time steps between two "
+                        "repartitions of the fluid mesh");
+      prm.declare_entry("Solid sub-steps",
+                        "1",
+                        Patterns::Integer(1),
+                        "Number of solid time steps per coupling time step");
+      prm.declare_entry("Fluid sub-steps",
+                        "1",
+                        Patterns::Integer(1),
+                        "Number of fluid time steps per coupling time step");
+      prm.declare_entry("Solid partitioner",
+                        "METIS",
+                        Patterns::Selection("METIS|Fluid aligned"),
+                        "How the shared solid mesh is partitioned");
+      prm.declare_entry("Solid partition imbalance",
+                        "1.1",
+                        Patterns::Double(1.0),
+                        "Largest number of solid cells of a process relative "
+                        "to the average (Fluid aligned only)");
+    }
+    prm.leave_subsection();
+  }
+
+  void FSISolver::parseParameters(ParameterHandler &prm)
+  {
+    prm.enter_subsection("FSI solver control");
+    {
+      distributed_solid_state = prm.get_bool("Distributed solid state");
+      node_shared_solid_state = prm.get_bool("Node shared solid state");
+      overlap_traction_exchange = prm.get_bool("Overlap traction exchange");
+      solid_processes = prm.get_integer("Solid processes");
+      coupling_iterations = prm.get_integer("Coupling iterations");
+      coupling_tolerance = prm.get_double("Coupling tolerance");
+      coupling_acceleration = prm.get("Coupling acceleration");
+      coupling_relaxation = prm.get_double("Coupling relaxation");
+      AssertThrow(coupling_iterations == 1 || !overlap_traction_exchange,
+                  ExcMessage("The overlapped exchange cannot iterate!"));
+      performance_log = prm.get("Performance log");
+      indicator_band_layers = prm.get_integer("Indicator band layers");
+      artificial_fluid_band_layers =
+        prm.get_integer("Artificial fluid band layers");
+      refinement_criterion = prm.get("Refinement criterion");
+      refinement_band_layers = prm.get_integer("Refinement band layers");
+      load_imbalance_tolerance = prm.get_double("Load imbalance tolerance");
+      repartition_interval = prm.get_integer("Repartition interval");
+      solid_sub_steps = prm.get_integer("Solid sub-steps");
+      fluid_sub_steps = prm.get_integer("Fluid sub-steps");
+      solid_partitioner = prm.get("Solid partitioner");
+      solid_partition_imbalance = prm.get_double("Solid partition imbalance");
+    }
+    prm.leave_subsection();
+  }
+
   AllParameters::AllParameters(const std::string &infile)
   {
     ParameterHandler prm;
@@ -531,6 +1010,7 @@ namespace Parameters
     FluidFESystem::declareParameters(prm);
     FluidMaterial::declareParameters(prm);
     FluidSolver::declareParameters(prm);
+    FluidPressurePreconditioner::declareParameters(prm);
     FluidDirichlet::declareParameters(prm);
     FluidNeumann::declareParameters(prm);
     SolidFESystem::declareParameters(prm);
@@ -538,6 +1018,7 @@ namespace Parameters
     SolidSolver::declareParameters(prm);
     SolidDirichlet::declareParameters(prm);
     SolidNeumann::declareParameters(prm);
+    FSISolver::declareParameters(prm);
   }
 
   void AllParameters::parseParameters(ParameterHandler &prm)
@@ -546,6 +1027,7 @@ namespace Parameters
     FluidFESystem::parseParameters(prm);
     FluidMaterial::parseParameters(prm);
     FluidSolver::parseParameters(prm);
+    FluidPressurePreconditioner::parseParameters(prm);
     FluidDirichlet::parseParameters(prm);
     FluidNeumann::parseParameters(prm);
     SolidFESystem::parseParameters(prm);
@@ -555,5 +1037,6 @@ namespace Parameters
     // Set the dummy member in Solid Neumann BCs subsection
     solid_neumann_bc_dim = dimension;
     SolidNeumann::parseParameters(prm);
+    FSISolver::parseParameters(prm);
   }
 } // namespace Parameters
@@ -0,0 +1,108 @@
+#include "preconditioner_gmg.h"
+
+PreconditionGMG::AdditionalData::AdditionalData(
+  const unsigned int smoothing_steps)
+  : smoothing_steps(smoothing_steps)
+{
+}
+
+PreconditionGMG::PreconditionGMG(
+  const PETScWrappers::MatrixBase &matrix,
+  const MGLevelObject<PETScWrappers::MPI::SparseMatrix> &interpolation,
+  const AdditionalData &additional_data)
+{
+  initialize(matrix, interpolation, additional_data);
+}
+
+void PreconditionGMG::initialize(
+  const PETScWrappers::MatrixBase &matrix_,
+  const MGLevelObject<PETScWrappers::MPI::SparseMatrix> &interpolation,
+  const AdditionalData &additional_data_)
+{
+  clear();
+
+  AssertThrow(interpolation.min_level() == 1,
+              ExcMessage("The interpolation starts from the coarsest level!"));
+
+  matrix = static_cast<Mat>(matrix_);
+  additional_data = additional_data_;
+
+  MPI_Comm comm = matrix_.get_mpi_communicator();
+
+  PetscErrorCode ierr = PCCreate(comm, &pc);
+  AssertThrow(ierr == 0, ExcPETScError(ierr));
+
+  ierr = PCSetOperators(pc, matrix, matrix);
+  AssertThrow(ierr == 0, ExcPETScError(ierr));
+
+  ierr = PCSetType(pc, const_cast<char *>(PCMG));
+  AssertThrow(ierr == 0, ExcPETScError(ierr));
+
+  const unsigned int n_levels = interpolation.max_level() + 1;
+  ierr = PCMGSetLevels(pc, n_levels, nullptr);
+  AssertThrow(ierr == 0, ExcPETScError(ierr));
+
+  ierr = PCMGSetType(pc, PC_MG_MULTIPLICATIVE);
+  AssertThrow(ierr == 0, ExcPETScError(ierr));
+
+  ierr = PCMGSetCycleType(pc, PC_MG_CYCLE_V);
+  AssertThrow(ierr == 0, ExcPETScError(ierr));
+
+  // The coarse operators are P^T A P, computed by PCSetUp.
+  ierr = PCMGSetGalerkin(pc, PC_MG_GALERKIN_BOTH);
+  AssertThrow(ierr == 0, ExcPETScError(ierr));
+
+  for (unsigned int level = 1; level < n_levels; ++level)
+    {
+      ierr = PCMGSetInterpolation(pc, level, interpolation[level]);
+      AssertThrow(ierr == 0, ExcPETScError(ierr));
+
+      // The same smoother is used before and after the coarse correction,
+      // so the V-cycle stays symmetric for CG. The eigenvalue bounds of the
+      // Chebyshev iteration are estimated from a few Krylov iterations.
+      KSP smoother;
+      ierr = PCMGGetSmoother(pc, level, &smoother);
+      AssertThrow(ierr == 0, ExcPETScError(ierr));
+
+      ierr = KSPSetType(smoother, KSPCHEBYSHEV);
+      AssertThrow(ierr == 0, ExcPETScError(ierr));
+
+      ierr = KSPChebyshevEstEigSet(
+        smoother, PETSC_DEFAULT, PETSC_DEFAULT, PETSC_DEFAULT, PETSC_DEFAULT);
+      AssertThrow(ierr == 0, ExcPETScError(ierr));
+
+      ierr = KSPSetTolerances(smoother,
+                              PETSC_DEFAULT,
+                              PETSC_DEFAULT,
+                              PETSC_DEFAULT,
+                              additional_data.smoothing_steps);
+      AssertThrow(ierr == 0, ExcPETScError(ierr));
+
+      ierr = KSPSetNormType(smoother, KSP_NORM_NONE);
+      AssertThrow(ierr == 0, ExcPETScError(ierr));
+
+      PC smoother_pc;
+      ierr = KSPGetPC(smoother, &smoother_pc);
+      AssertThrow(ierr == 0, ExcPETScError(ierr));
+
+      ierr = PCSetType(smoother_pc, const_cast<char *>(PCJACOBI));
+      AssertThrow(ierr == 0, ExcPETScError(ierr));
+    }
+
+  KSP coarse;
+  ierr = PCMGGetCoarseSolve(pc, &coarse);
+  AssertThrow(ierr == 0, ExcPETScError(ierr));
+
+  ierr = KSPSetType(coarse, KSPPREONLY);
+  AssertThrow(ierr == 0, ExcPETScError(ierr));
+
+  PC coarse_pc;
+  ierr = KSPGetPC(coarse, &coarse_pc);
+  AssertThrow(ierr == 0, ExcPETScError(ierr));
+
+  ierr = PCSetType(coarse_pc, const_cast<char *>(PCREDUNDANT));
+  AssertThrow(ierr == 0, ExcPETScError(ierr));
+
+  ierr = PCSetUp(pc);
+  AssertThrow(ierr == 0, ExcPETScError(ierr));
+}
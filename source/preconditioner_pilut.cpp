@@ -51,8 +51,8 @@ PCSetFromOptions_HYPRE_Euclid(PetscOptionItems *PetscOptionsObject, PC pc)
       if (fillin_levels < 0)
         SETERRQ1(PetscObjectComm((PetscObject)pc),
                  PETSC_ERR_ARG_OUTOFRANGE,
-                 "Number of levels %d must be nonegative",
-                 levels);
+                 "Number of levels %D must be nonegative",
+                 fillin_levels);
       ierr = PetscSNPrintf(levels, sizeof(levels), "%D", fillin_levels);
       CHKERRQ(ierr);
       args[cnt++] = (char *)"-level";
@@ -196,16 +196,25 @@ void PreconditionPilut::initialize(const PETScWrappers::MatrixBase &matrix_,
 
 /* ----------------- PreconditionEuclid ------------------------ */
 
-PreconditionEuclid::PreconditionEuclid(const PETScWrappers::MatrixBase &matrix)
+PreconditionEuclid::AdditionalData::AdditionalData(const unsigned int levels,
+                                                   const bool block_jacobi)
+  : levels(levels), block_jacobi(block_jacobi)
 {
-  initialize(matrix);
 }
 
-void PreconditionEuclid::initialize(const PETScWrappers::MatrixBase &matrix_)
+PreconditionEuclid::PreconditionEuclid(const PETScWrappers::MatrixBase &matrix,
+                                       const AdditionalData &additional_data)
+{
+  initialize(matrix, additional_data);
+}
+
+void PreconditionEuclid::initialize(const PETScWrappers::MatrixBase &matrix_,
+                                    const AdditionalData &additional_data_)
 {
   clear();
 
   matrix = static_cast<Mat>(matrix_);
+  additional_data = additional_data_;
 
   MPI_Comm comm = matrix_.get_mpi_communicator();
 
@@ -220,6 +229,12 @@ void PreconditionEuclid::initialize(const PETScWrappers::MatrixBase &matrix_)
 
   ierr = PCHYPRESetType_Euclid(pc);
 
+  PETScWrappers::set_option_value("-pc_hypre_euclid_levels",
+                                  Utilities::to_string(additional_data.levels));
+  PETScWrappers::set_option_value("-pc_hypre_euclid_bj",
+                                  additional_data.block_jacobi ? "true"
+                                                               : "false");
+
   ierr = PCSetFromOptions(pc);
   AssertThrow(ierr == 0, ExcPETScError(ierr));
 
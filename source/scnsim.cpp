@@ -2,6 +2,25 @@
 
 namespace Fluid
 {
+  namespace
+  {
+    /// The block itself if the inner solves are in double precision.
+    const SparseMatrix<double> &inner_block(const SparseMatrix<double> &block,
+                                            SparseMatrix<double> &)
+    {
+      return block;
+    }
+
+    /// A single precision copy of the block otherwise.
+    const SparseMatrix<float> &inner_block(const SparseMatrix<double> &block,
+                                           SparseMatrix<float> &copy)
+    {
+      copy.reinit(block.get_sparsity_pattern());
+      copy.copy_from(block);
+      return copy;
+    }
+  } // namespace
+
   /**
    * The initialization of the direct solver is expensive as it allocates
    * a lot of memory. The preconditioner is going to be applied several
@@ -10,45 +29,54 @@ namespace Fluid
    * this to iterative solvers.
    */
   template <int dim>
-  SCnsIM<dim>::BlockIncompSchurPreconditioner::SchurComplementTpp::
+  template <typename number>
+  SCnsIM<dim>::BlockIncompSchurPreconditioner<number>::SchurComplementTpp::
     SchurComplementTpp(TimerOutput &timer,
-                       const BlockSparseMatrix<double> &system,
-                       const SparseILU<double> &Pvvinv)
-    : timer(timer), system_matrix(&system), Pvv_inverse(&Pvvinv)
+                       const SparseMatrix<number> &Avp,
+                       const SparseMatrix<number> &Apv,
+                       const SparseMatrix<number> &App,
+                       const SparseILU<number> &Pvvinv)
+    : timer(timer), Avp(&Avp), Apv(&Apv), App(&App), Pvv_inverse(&Pvvinv)
   {
   }
 
   template <int dim>
-  void SCnsIM<dim>::BlockIncompSchurPreconditioner::SchurComplementTpp::vmult(
-    Vector<double> &dst, const Vector<double> &src) const
+  template <typename number>
+  void
+  SCnsIM<dim>::BlockIncompSchurPreconditioner<number>::SchurComplementTpp::
+    vmult(Vector<double> &dst, const Vector<double> &src) const
   {
-    TimerOutput::Scope timer_section(timer, "Tpp vmult");
+    Utils::ProfilingScope timer_section(timer, "Tpp vmult");
     // this is the exact representation of Tpp = App - Apv * Avv * Avp.
-    Vector<double> tmp1(this->Avv().m()), tmp2(this->Avv().m()),
-      tmp3(src.size());
-    this->Avp().vmult(tmp1, src);
+    Vector<double> tmp1(Avp->m()), tmp2(Avp->m()), tmp3(src.size());
+    Avp->vmult(tmp1, src);
     Pvv_inverse->vmult(tmp2, tmp1);
-    this->Apv().vmult(tmp3, tmp2);
-    this->App().vmult(dst, src);
+    Apv->vmult(tmp3, tmp2);
+    App->vmult(dst, src);
     dst -= tmp3;
   }
 
   template <int dim>
-  SCnsIM<dim>::BlockIncompSchurPreconditioner::BlockIncompSchurPreconditioner(
-    TimerOutput &timer,
-    const BlockSparseMatrix<double> &system,
-    SparseMatrix<double> &schur,
-    SparseMatrix<double> &B2pp)
+  template <typename number>
+  SCnsIM<dim>::BlockIncompSchurPreconditioner<number>::
+    BlockIncompSchurPreconditioner(TimerOutput &timer,
+                                   const BlockSparseMatrix<double> &system,
+                                   SparseMatrix<double> &schur,
+                                   SparseMatrix<double> &B2pp)
     : timer(timer),
       system_matrix(&system),
       schur_matrix(&schur),
       B2pp_matrix(&B2pp),
+      inner_Avp(&inner_block(system.block(0, 1), Avp_copy)),
+      inner_Apv(&inner_block(system.block(1, 0), Apv_copy)),
+      inner_App(&inner_block(system.block(1, 1), App_copy)),
       Tpp_itr(0)
   {
     // Initialize the Pvv inverse (the ILU(0) factorization of Avv)
     Pvv_inverse.initialize(this->Avv());
     // Initialize Tpp
-    Tpp.reset(new SchurComplementTpp(timer, *system_matrix, Pvv_inverse));
+    Tpp.reset(new SchurComplementTpp(
+      timer, *inner_Avp, *inner_Apv, *inner_App, Pvv_inverse));
     // Compute B2pp matrix App - Apv*rowsum(|Avv|)^(-1)*Avp
     // as the preconditioner to solve Tpp^-1
     Vector<double> RowSumAvv(this->Avv().m());
@@ -85,7 +113,8 @@ namespace Fluid
   }
 
   template <int dim>
-  void SCnsIM<dim>::BlockIncompSchurPreconditioner::vmult(
+  template <typename number>
+  void SCnsIM<dim>::BlockIncompSchurPreconditioner<number>::vmult(
     BlockVector<double> &dst, const BlockVector<double> &src) const
   {
     // Compute the intermediate vector:
@@ -94,7 +123,7 @@ namespace Fluid
     /////////////////////////////////////////
     Vector<double> ptmp1(src.block(0).size()), ptmp(src.block(1).size());
     Pvv_inverse.vmult(ptmp1, src.block(0));
-    this->Apv().vmult(ptmp, ptmp1);
+    inner_Apv->vmult(ptmp, ptmp1);
     ptmp *= -1.0;
     ptmp += src.block(1);
     // Compute the final vector:
@@ -115,21 +144,20 @@ namespace Fluid
     }
 
     // Compute the multiplication
-    timer.enter_subsection("Solving Tpp");
-
-    SolverControl solver_control(
-      ptmp.size(), 1e-6 * ptmp.l2_norm(), true, true);
-    SolverGMRES<Vector<double>> gmres(
-      solver_control, SolverGMRES<Vector<double>>::AdditionalData(200));
-    gmres.solve(*Tpp, dst.block(1), ptmp, B2pp_inverse);
-    // Count iterations for this solver solving Tpp inverse
-    Tpp_itr += solver_control.last_step();
-
-    timer.leave_subsection("Solving Tpp");
+    {
+      Utils::ProfilingScope timer_section(timer, "Solving Tpp");
+      SolverControl solver_control(
+        ptmp.size(), 1e-6 * ptmp.l2_norm(), true, true);
+      SolverGMRES<Vector<double>> gmres(
+        solver_control, SolverGMRES<Vector<double>>::AdditionalData(200));
+      gmres.solve(*Tpp, dst.block(1), ptmp, B2pp_inverse);
+      // Count iterations for this solver solving Tpp inverse
+      Tpp_itr += solver_control.last_step();
+    }
 
     // Compute Pvv^-1*src(0) - Pvv^-1*Avp*dst(1)
     Vector<double> utmp1(src.block(0).size()), utmp2(src.block(0).size());
-    this->Avp().vmult(utmp1, dst.block(1));
+    inner_Avp->vmult(utmp1, dst.block(1));
     Pvv_inverse.vmult(utmp2, utmp1);
     Pvv_inverse.vmult(dst.block(0), src.block(0));
     dst.block(0) -= utmp2;
@@ -151,6 +179,7 @@ namespace Fluid
   void SCnsIM<dim>::initialize_system()
   {
     preconditioner.reset();
+    single_preconditioner.reset();
     system_matrix.clear();
     schur_matrix.clear();
     B2pp_matrix.clear();
@@ -197,7 +226,7 @@ namespace Fluid
   template <int dim>
   void SCnsIM<dim>::assemble(const bool use_nonzero_constraints)
   {
-    TimerOutput::Scope timer_section(timer, "Assemble system");
+    Utils::ProfilingScope timer_section(timer, "Assemble system");
 
     const double viscosity = parameters.viscosity;
     Tensor<1, dim> gravity;
@@ -207,15 +236,11 @@ namespace Fluid
     system_matrix = 0;
     system_rhs = 0;
 
-    FEValues<dim> fe_values(fe,
-                            volume_quad_formula,
-                            update_values | update_quadrature_points |
-                              update_JxW_values | update_gradients);
-    FEFaceValues<dim> fe_face_values(fe,
-                                     face_quad_formula,
-                                     update_values | update_normal_vectors |
-                                       update_quadrature_points |
-                                       update_JxW_values);
+    const UpdateFlags flags = update_values | update_quadrature_points |
+                              update_JxW_values | update_gradients;
+    const UpdateFlags face_flags = update_values | update_normal_vectors |
+                                   update_quadrature_points |
+                                   update_JxW_values;
 
     const unsigned int dofs_per_cell = fe.dofs_per_cell;
     const unsigned int n_q_points = volume_quad_formula.size();
@@ -224,39 +249,42 @@ namespace Fluid
     const FEValuesExtractors::Vector velocities(0);
     const FEValuesExtractors::Scalar pressure(dim);
 
-    FullMatrix<double> local_matrix(dofs_per_cell, dofs_per_cell);
-    Vector<double> local_rhs(dofs_per_cell);
-
-    std::vector<types::global_dof_index> local_dof_indices(dofs_per_cell);
-
-    // For the linearized system, we create temporary storage for current
-    // velocity
-    // and gradient, current pressure, and present velocity. In practice, they
-    // are
-    // all obtained through their shape functions at quadrature points.
-
-    std::vector<Tensor<1, dim>> current_velocity_values(n_q_points);
-    std::vector<Tensor<2, dim>> current_velocity_gradients(n_q_points);
-    std::vector<double> current_pressure_values(n_q_points);
-    std::vector<Tensor<1, dim>> current_pressure_gradients(n_q_points);
-    std::vector<Tensor<1, dim>> present_velocity_values(n_q_points);
-    std::vector<double> present_pressure_values(n_q_points);
-    std::vector<double> sigma_pml(n_q_points);
-
-    std::vector<double> div_phi_u(dofs_per_cell);
-    std::vector<Tensor<1, dim>> phi_u(dofs_per_cell);
-    std::vector<Tensor<2, dim>> grad_phi_u(dofs_per_cell);
-    std::vector<double> phi_p(dofs_per_cell);
-    std::vector<Tensor<1, dim>> grad_phi_p(dofs_per_cell);
-
     // The parameters that is used in isentropic continuity equation:
     // heat capacity ratio and atmospheric pressure.
-    double cp_to_cv = 1.4;
-    double atm = 1013250;
+    const double cp_to_cv = 1.4;
+    const double atm = 1013250;
+
+    // The local matrices are computed on all threads, the copier adds them
+    // to the global matrix one at a time.
+    auto assemble_cell =
+      [&](const typename DoFHandler<dim>::active_cell_iterator &cell,
+          Utils::AssemblyScratch<dim> &scratch,
+          Utils::AssemblyCopy &copy) {
+        FEValues<dim> &fe_values = scratch.fe_values;
+        FEFaceValues<dim> &fe_face_values = scratch.fe_face_values;
+        FullMatrix<double> &local_matrix = copy.cell_matrix;
+        Vector<double> &local_rhs = copy.cell_rhs;
+        std::vector<types::global_dof_index> &local_dof_indices =
+          copy.local_dof_indices;
+
+        // For the linearized system, we create temporary storage for current
+        // velocity and gradient, current pressure, and present velocity. In
+        // practice, they are all obtained through their shape functions at
+        // quadrature points.
+        std::vector<Tensor<1, dim>> current_velocity_values(n_q_points);
+        std::vector<Tensor<2, dim>> current_velocity_gradients(n_q_points);
+        std::vector<double> current_pressure_values(n_q_points);
+        std::vector<Tensor<1, dim>> current_pressure_gradients(n_q_points);
+        std::vector<Tensor<1, dim>> present_velocity_values(n_q_points);
+        std::vector<double> present_pressure_values(n_q_points);
+        std::vector<double> sigma_pml(n_q_points);
+
+        std::vector<double> div_phi_u(dofs_per_cell);
+        std::vector<Tensor<1, dim>> phi_u(dofs_per_cell);
+        std::vector<Tensor<2, dim>> grad_phi_u(dofs_per_cell);
+        std::vector<double> phi_p(dofs_per_cell);
+        std::vector<Tensor<1, dim>> grad_phi_p(dofs_per_cell);
 
-    for (auto cell = dof_handler.begin_active(); cell != dof_handler.end();
-         ++cell)
-      {
         auto p = cell_property.get_data(cell);
         const int ind = p[0]->indicator;
         const double rho = parameters.fluid_rho;
@@ -462,73 +490,102 @@ namespace Fluid
                       fe_values.JxW(q);
                   }
               }
+          }
 
-            // Impose pressure boundary here if specified, loop over faces on
-            // the cell and apply pressure boundary conditions:
-            // \f$\int_{\Gamma_n} -p\bold{n}d\Gamma\f$
-            if (parameters.n_fluid_neumann_bcs != 0)
+        // Impose pressure boundary here if specified, loop over faces on the
+        // cell and apply pressure boundary conditions:
+        // \f$\int_{\Gamma_n} -p\bold{n}d\Gamma\f$
+        if (parameters.n_fluid_neumann_bcs != 0)
+          {
+            for (unsigned int face_n = 0;
+                 face_n < GeometryInfo<dim>::faces_per_cell;
+                 ++face_n)
               {
-                for (unsigned int face_n = 0;
-                     face_n < GeometryInfo<dim>::faces_per_cell;
-                     ++face_n)
+                if (cell->at_boundary(face_n) &&
+                    parameters.fluid_neumann_bcs.find(
+                      cell->face(face_n)->boundary_id()) !=
+                      parameters.fluid_neumann_bcs.end())
                   {
-                    if (cell->at_boundary(face_n) &&
-                        parameters.fluid_neumann_bcs.find(
-                          cell->face(face_n)->boundary_id()) !=
-                          parameters.fluid_neumann_bcs.end())
+                    fe_face_values.reinit(cell, face_n);
+                    unsigned int p_bc_id = cell->face(face_n)->boundary_id();
+                    double boundary_values_p =
+                      parameters.fluid_neumann_bcs.at(p_bc_id);
+                    for (unsigned int q = 0; q < n_face_q_points; ++q)
                       {
-                        fe_face_values.reinit(cell, face_n);
-                        unsigned int p_bc_id =
-                          cell->face(face_n)->boundary_id();
-                        double boundary_values_p =
-                          parameters.fluid_neumann_bcs[p_bc_id];
-                        for (unsigned int q = 0; q < n_face_q_points; ++q)
+                        for (unsigned int i = 0; i < dofs_per_cell; ++i)
                           {
-                            for (unsigned int i = 0; i < dofs_per_cell; ++i)
-                              {
-                                local_rhs(i) +=
-                                  -(fe_face_values[velocities].value(i, q) *
-                                    fe_face_values.normal_vector(q) *
-                                    boundary_values_p * fe_face_values.JxW(q));
-                              }
+                            local_rhs(i) +=
+                              -(fe_face_values[velocities].value(i, q) *
+                                fe_face_values.normal_vector(q) *
+                                boundary_values_p * fe_face_values.JxW(q));
                           }
                       }
                   }
               }
+          }
 
-            cell->get_dof_indices(local_dof_indices);
-
-            const AffineConstraints<double> &constraints_used =
-              use_nonzero_constraints ? nonzero_constraints : zero_constraints;
+        cell->get_dof_indices(local_dof_indices);
+      };
 
-            constraints_used.distribute_local_to_global(local_matrix,
-                                                        local_rhs,
-                                                        local_dof_indices,
-                                                        system_matrix,
-                                                        system_rhs,
-                                                        true);
-          }
-      }
+    const AffineConstraints<double> &constraints_used =
+      use_nonzero_constraints ? nonzero_constraints : zero_constraints;
+    auto copy_cell = [&](const Utils::AssemblyCopy &copy) {
+      constraints_used.distribute_local_to_global(copy.cell_matrix,
+                                                  copy.cell_rhs,
+                                                  copy.local_dof_indices,
+                                                  system_matrix,
+                                                  system_rhs,
+                                                  true);
+    };
+
+    Utils::AssemblyCopy copy_data;
+    copy_data.cell_matrix.reinit(dofs_per_cell, dofs_per_cell);
+    copy_data.cell_rhs.reinit(dofs_per_cell);
+    copy_data.local_dof_indices.resize(dofs_per_cell);
+
+    WorkStream::run(dof_handler.begin_active(),
+                    dof_handler.end(),
+                    assemble_cell,
+                    copy_cell,
+                    Utils::AssemblyScratch<dim>(fe,
+                                                volume_quad_formula,
+                                                flags,
+                                                face_quad_formula,
+                                                face_flags),
+                    copy_data);
   }
 
   template <int dim>
   std::pair<unsigned int, double>
-  SCnsIM<dim>::solve(const bool use_nonzero_constraints)
+  SCnsIM<dim>::solve(const bool use_nonzero_constraints,
+                     const double relative_tolerance)
   {
-    TimerOutput::Scope timer_section(timer, "Solve linear system");
-
-    preconditioner.reset(new BlockIncompSchurPreconditioner(
-      timer, system_matrix, schur_matrix, B2pp_matrix));
+    Utils::ProfilingScope timer_section(timer, "Solve linear system");
 
     // NOTE: SolverFGMRES only applies the preconditioner from the right,
     // as opposed to SolverGMRES which allows both left and right
     // preconditoners.
     SolverControl solver_control(
-      system_matrix.m(), 1e-8 * system_rhs.l2_norm(), true);
+      system_matrix.m(), relative_tolerance * system_rhs.l2_norm(), true);
     GrowingVectorMemory<BlockVector<double>> vector_memory;
     SolverFGMRES<BlockVector<double>> gmres(solver_control, vector_memory);
 
-    gmres.solve(system_matrix, newton_update, system_rhs, *preconditioner);
+    // The outer solver is in double precision in either case.
+    if (parameters.fluid_single_precision_pc)
+      {
+        single_preconditioner.reset(new BlockIncompSchurPreconditioner<float>(
+          timer, system_matrix, schur_matrix, B2pp_matrix));
+        gmres.solve(
+          system_matrix, newton_update, system_rhs, *single_preconditioner);
+        inner_iterations = single_preconditioner->get_Tpp_itr_count();
+      }
+    else
+      {
+        preconditioner.reset(new BlockIncompSchurPreconditioner<double>(
+          timer, system_matrix, schur_matrix, B2pp_matrix));
+        gmres.solve(system_matrix, newton_update, system_rhs, *preconditioner);
+        inner_iterations = preconditioner->get_Tpp_itr_count();
+      }
 
     const AffineConstraints<double> &constraints_used =
       use_nonzero_constraints ? nonzero_constraints : zero_constraints;
@@ -560,6 +617,9 @@ namespace Fluid
     double initial_residual = 1.0;
     double relative_residual = 1.0;
     unsigned int outer_iteration = 0;
+    Utils::ForcingTerm forcing_term(
+      1e-8, parameters.inexact_newton, parameters.max_forcing_term);
+    unsigned int step_linear_iterations = 0;
     evaluation_point = present_solution;
     while (relative_residual > parameters.fluid_tolerance &&
            current_residual > 1e-14)
@@ -577,8 +637,11 @@ namespace Fluid
         // if they are time-independent, nonzero_constraints should be
         // applied only at the first iteration of the first time step.
         assemble(apply_nonzero_constraints && outer_iteration == 0);
-        auto state = solve(apply_nonzero_constraints && outer_iteration == 0);
         current_residual = system_rhs.l2_norm();
+        const double eta = forcing_term.next(current_residual);
+        auto state =
+          solve(apply_nonzero_constraints && outer_iteration == 0, eta);
+        step_linear_iterations += state.first;
 
         // Update evaluation_point. Since newton_update has been set to
         // the correct bc values, there is no need to distribute the
@@ -594,14 +657,16 @@ namespace Fluid
 
         std::cout << std::scientific << std::left << " ITR = " << std::setw(2)
                   << outer_iteration << " ABS_RES = " << current_residual
-                  << " REL_RES = " << relative_residual
+                  << " REL_RES = " << relative_residual << " ETA = " << eta
                   << " GMRES_ITR = " << std::setw(3) << state.first
                   << " GMRES_RES = " << state.second
                   << " INNER_GMRES_ITR = " << std::setw(3)
-                  << preconditioner->get_Tpp_itr_count() << std::endl;
+                  << inner_iterations << std::endl;
 
         outer_iteration++;
       }
+    std::cout << " NEWTON_ITR = " << outer_iteration
+              << " TOTAL_GMRES_ITR = " << step_linear_iterations << std::endl;
     // Update solution increment, which is used in FSI application.
     solution_increment = evaluation_point;
     solution_increment -= present_solution;
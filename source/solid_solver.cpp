@@ -35,10 +35,17 @@ namespace Solid
   template <int dim>
   void SolidSolver<dim>::setup_dofs()
   {
-    TimerOutput::Scope timer_section(timer, "Setup system");
+    Utils::ProfilingScope timer_section(timer, "Setup system");
 
     dof_handler.distribute_dofs(fe);
-    DoFRenumbering::Cuthill_McKee(dof_handler);
+    if (parameters.dof_ordering == "Hierarchical")
+      {
+        DoFRenumbering::hierarchical(dof_handler);
+      }
+    else
+      {
+        DoFRenumbering::Cuthill_McKee(dof_handler);
+      }
     scalar_dof_handler.distribute_dofs(scalar_fe);
 
     // The Dirichlet boundary conditions are stored in the
@@ -123,7 +130,7 @@ namespace Solid
   std::pair<unsigned int, double> SolidSolver<dim>::solve(
     const SparseMatrix<double> &A, Vector<double> &x, const Vector<double> &b)
   {
-    TimerOutput::Scope timer_section(timer, "Solve linear system");
+    Utils::ProfilingScope timer_section(timer, "Solve linear system");
 
     SolverControl solver_control(A.m(), 1e-6 * b.l2_norm());
     SolverCG<> cg(solver_control);
@@ -140,7 +147,7 @@ namespace Solid
   template <int dim>
   void SolidSolver<dim>::output_results(const unsigned int output_index)
   {
-    TimerOutput::Scope timer_section(timer, "Output results");
+    Utils::ProfilingScope timer_section(timer, "Output results");
 
     std::vector<std::string> solution_names(dim, "displacements");
 
@@ -208,7 +215,7 @@ namespace Solid
   void SolidSolver<dim>::refine_mesh(const unsigned int min_grid_level,
                                      const unsigned int max_grid_level)
   {
-    TimerOutput::Scope timer_section(timer, "Refine mesh");
+    Utils::ProfilingScope timer_section(timer, "Refine mesh");
 
     Vector<float> estimated_error_per_cell(triangulation.n_active_cells());
     using type = std::map<types::boundary_id, const Function<dim, double> *>;
@@ -0,0 +1,51 @@
+#include "solver_pipelined.h"
+
+SolverPGMRES::AdditionalData::AdditionalData(
+  const unsigned int restart_parameter)
+  : restart_parameter(restart_parameter)
+{
+}
+
+SolverPGMRES::SolverPGMRES(SolverControl &cn,
+                           const MPI_Comm &mpi_communicator,
+                           const AdditionalData &data)
+  : PETScWrappers::SolverBase(cn, mpi_communicator), additional_data(data)
+{
+}
+
+void SolverPGMRES::set_solver_type(KSP &ksp) const
+{
+  PetscErrorCode ierr = KSPSetType(ksp, KSPPGMRES);
+  AssertThrow(ierr == 0, ExcPETScError(ierr));
+
+  ierr = KSPGMRESSetRestart(ksp, additional_data.restart_parameter);
+  AssertThrow(ierr == 0, ExcPETScError(ierr));
+
+  ierr = KSPSetPCSide(ksp, PC_RIGHT);
+  AssertThrow(ierr == 0, ExcPETScError(ierr));
+
+  ierr = KSPSetInitialGuessNonzero(ksp, PETSC_TRUE);
+  AssertThrow(ierr == 0, ExcPETScError(ierr));
+
+  ierr = KSPSetFromOptions(ksp);
+  AssertThrow(ierr == 0, ExcPETScError(ierr));
+}
+
+SolverPipeCG::SolverPipeCG(SolverControl &cn,
+                           const MPI_Comm &mpi_communicator,
+                           const AdditionalData &data)
+  : PETScWrappers::SolverBase(cn, mpi_communicator), additional_data(data)
+{
+}
+
+void SolverPipeCG::set_solver_type(KSP &ksp) const
+{
+  PetscErrorCode ierr = KSPSetType(ksp, KSPPIPECG);
+  AssertThrow(ierr == 0, ExcPETScError(ierr));
+
+  ierr = KSPSetInitialGuessNonzero(ksp, PETSC_TRUE);
+  AssertThrow(ierr == 0, ExcPETScError(ierr));
+
+  ierr = KSPSetFromOptions(ksp);
+  AssertThrow(ierr == 0, ExcPETScError(ierr));
+}
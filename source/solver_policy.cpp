@@ -0,0 +1,100 @@
+#include "solver_policy.h"
+
+#include <limits>
+
+namespace
+{
+  const types::global_dof_index unlimited =
+    std::numeric_limits<types::global_dof_index>::max();
+}
+
+SolverPolicy::SolverPolicy(const std::string &requested,
+                           const std::vector<Candidate> &candidates,
+                           const unsigned int max_iterations)
+  : requested(requested),
+    candidates(candidates),
+    max_iterations(max_iterations),
+    first(0),
+    current(0),
+    choice(automatic() ? candidates.front().name : requested)
+{
+}
+
+bool SolverPolicy::select(const types::global_dof_index n_dofs,
+                          const unsigned int dim,
+                          const unsigned int n_processes)
+{
+  if (!automatic())
+    {
+      return false;
+    }
+  first = 0;
+  while (first + 1 < candidates.size())
+    {
+      const Candidate &candidate = candidates[first];
+      const types::global_dof_index max_dofs =
+        dim == 2 ? candidate.max_dofs_2d : candidate.max_dofs_3d;
+      if (n_dofs <= max_dofs && (candidate.max_processes == 0 ||
+                                 n_processes <= candidate.max_processes))
+        {
+          break;
+        }
+      ++first;
+    }
+  const bool changed = current != first;
+  current = first;
+  choice = candidates[current].name;
+  return changed;
+}
+
+bool SolverPolicy::record(const unsigned int iterations)
+{
+  if (iterations <= max_iterations)
+    {
+      return false;
+    }
+  return fail();
+}
+
+bool SolverPolicy::fail()
+{
+  if (!automatic() || candidates[current].direct ||
+      current + 1 == candidates.size())
+    {
+      return false;
+    }
+  ++current;
+  choice = candidates[current].name;
+  return true;
+}
+
+SolverPolicy SolverPolicy::velocity_solver(const std::string &requested)
+{
+  // The MUMPS factors of 3D problems grow much faster than the problem.
+  return SolverPolicy(requested,
+                      {{"MUMPS", 200000, 50000, 64, true},
+                       {"AMG", unlimited, unlimited, 0, false},
+                       {"AMG-GMRES", unlimited, unlimited, 0, false}},
+                      50);
+}
+
+SolverPolicy SolverPolicy::pressure_preconditioner(const std::string &requested)
+{
+  // The limit is on the Tpp iterations per outer iteration. The block
+  // Jacobi ILU gets weaker with every refinement and every process.
+  return SolverPolicy(requested,
+                      {{"Euclid", 100000, 30000, 16, false},
+                       {"BoomerAMG", unlimited, unlimited, 0, false}},
+                      30);
+}
+
+SolverPolicy SolverPolicy::solid_preconditioner(const std::string &requested)
+{
+  // The direct solver is factorized once as long as the matrix does not
+  // change.
+  return SolverPolicy(requested,
+                      {{"None", 2000, 1000, 0, false},
+                       {"Direct", 100000, 30000, 64, true},
+                       {"AMG", unlimited, unlimited, 0, false}},
+                      200);
+}
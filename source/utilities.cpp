@@ -1,346 +1,2240 @@
 #include "utilities.h"
 #include <bitset>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <set>
+#ifdef OPENIFEM_WITH_LIKWID
+#include <likwid.h>
+#endif
 
 namespace Utils
 {
-  bool Time::time_to_output() const
+  bool Time::passed_multiple_of(const double interval) const
   {
-    auto delta = static_cast<unsigned int>(output_interval / delta_t);
-    return (timestep >= delta && timestep % delta == 0);
+    // The tolerance absorbs the round-off of the accumulated time.
+    const double tolerance = 1e-6 * delta_t;
+    return timestep > 0 &&
+           std::floor((time_current + tolerance) / interval) >
+             std::floor((time_previous + tolerance) / interval);
   }
 
-  bool Time::time_to_refine() const
+  bool Time::time_to_output() const
   {
-    auto delta = static_cast<unsigned int>(refinement_interval / delta_t);
-    return (timestep >= delta && timestep % delta == 0);
+    return passed_multiple_of(output_interval);
   }
 
-  bool Time::time_to_save() const
+  bool Time::time_to_refine() const
   {
-    auto delta = static_cast<unsigned int>(save_interval / delta_t);
-    return (timestep >= delta && timestep % delta == 0);
+    return passed_multiple_of(refinement_interval);
   }
 
+  bool Time::time_to_save() const { return passed_multiple_of(save_interval); }
+
   void Time::increment()
   {
+    time_previous = time_current;
     time_current += delta_t;
     ++timestep;
   }
 
   void Time::set_delta_t(double delta) { delta_t = delta; }
 
-  template <int dim, typename VectorType>
-  SPHInterpolator<dim, VectorType>::SPHInterpolator(
-    const DoFHandler<dim> &dof_handler, const Point<dim> &point)
-    : dof_handler(dof_handler), target(point)
+  void Time::save_restart_record(
+    const std::string &file,
+    const std::vector<std::pair<double, std::string>> &times_and_names) const
   {
-    for (auto cell : dof_handler.active_cell_iterators())
+    std::ofstream out(file);
+    out << std::setprecision(std::numeric_limits<double>::max_digits10)
+        << timestep << " " << time_current << " " << delta_t << " "
+        << times_and_names.size() << "\n";
+    for (const auto &record : times_and_names)
       {
-        if (!cell->is_locally_owned())
-          continue;
-        Point<dim> center = cell->center();
-        double h = cell->diameter();
-        double kernel_value = cubic_spline(center, target, h);
-        if (kernel_value > 1e-12)
-          {
-            sources.push_back({cell, kernel_value});
-          }
+        out << record.first << " " << record.second << "\n";
       }
+    AssertThrow(out, ExcMessage("Failed to write " + file));
   }
 
-  template <int dim, typename VectorType>
-  double SPHInterpolator<dim, VectorType>::cubic_spline(const Point<dim> &pi,
-                                                        const Point<dim> &pj,
-                                                        double h)
+  void Time::load_restart_record(
+    const std::string &file,
+    std::vector<std::pair<double, std::string>> &times_and_names)
   {
-    double w(0.);
-    double q = pi.distance(pj) / h;
-    // M_1_PI = 1 / pi
-    double coef = (dim == 2 ? 10 * M_1_PI / (7 * h * h) : M_1_PI / (h * h * h));
-    if (q < 2.)
+    std::ifstream in(file);
+    AssertThrow(in, ExcMessage("Missing restart record " + file));
+    std::size_t n_records;
+    in >> timestep >> time_current >> delta_t >> n_records;
+    time_previous = time_current;
+    times_and_names.resize(n_records);
+    for (auto &record : times_and_names)
       {
-        if (q >= 1.)
-          {
-            w = coef * (0.25 * (2 - q) * (2 - q) * (2 - q));
-          }
-        else
-          {
-            w = coef * (1 - 1.5 * q * q + 0.75 * q * q * q);
-          }
+        in >> record.first >> record.second;
       }
-    return w;
+    AssertThrow(in, ExcMessage("Corrupted restart record " + file));
   }
 
-  template <int dim, typename VectorType>
-  void SPHInterpolator<dim, VectorType>::point_value(
-    const VectorType &fe_function,
-    Vector<typename VectorType::value_type> &value)
+  TimeStepController::TimeStepController(const double min_delta_t,
+                                         const double max_delta_t,
+                                         const double target_cfl,
+                                         const unsigned int target_iterations)
+    : min_delta_t(min_delta_t),
+      max_delta_t(max_delta_t),
+      target_cfl(target_cfl),
+      target_iterations(target_iterations)
   {
-    typedef typename VectorType::value_type Number;
-    const FiniteElement<dim> &fe = dof_handler.get_fe();
-    Assert(value.size() == fe.n_components(),
-           ExcDimensionMismatch(value.size(), fe.n_components()));
-
-    // Cell center in unit coordinate system
-    Point<dim> unit_center;
-    for (unsigned int i = 0; i < dim; ++i)
-      unit_center[i] = 0.5;
-    Quadrature<dim> quad(unit_center);
-    MappingQGeneric<dim> mapping(1);
-    FEValues<dim> fe_values(mapping, fe, quad, update_values);
-    value = 0;
-    for (auto p : sources)
-      {
-        auto cell = p.first;
-        fe_values.reinit(cell);
-        std::vector<Vector<Number>> u_value(1,
-                                            Vector<Number>(fe.n_components()));
-        fe_values.get_function_values(fe_function, u_value);
-        // In SPH interpolation, volume must be multiplied because kernel
-        // function has a unit of LENGTH^{-dim}
-        u_value[0] *= p.second * cell->measure();
-        value += u_value[0];
-      }
   }
 
-  template <int dim, typename VectorType>
-  void SPHInterpolator<dim, VectorType>::point_gradient(
-    const VectorType &fe_function,
-    std::vector<Tensor<1, dim, typename VectorType::value_type>> &gradient)
+  double TimeStepController::propose(const Time &time,
+                                     const double cfl,
+                                     const unsigned int iterations) const
   {
-    typedef typename VectorType::value_type Number;
-    const FiniteElement<dim> &fe = dof_handler.get_fe();
-    Assert(gradient.size() == fe.n_components(),
-           ExcDimensionMismatch(gradient.size(), fe.n_components()));
-    // Cell center in unit coordinate system
-    Point<dim> unit_center;
-    for (unsigned int i = 0; i < dim; ++i)
-      unit_center[i] = 0.5;
-    Quadrature<dim> quad(unit_center);
-    MappingQGeneric<dim> mapping(1);
-    FEValues<dim> fe_values(mapping, fe, quad, update_gradients);
-    for (unsigned int i = 0; i < gradient.size(); ++i)
-      gradient[i] = 0;
-    for (auto p : sources)
+    const double delta_t = time.get_delta_t();
+    double proposal = 2 * delta_t;
+    if (target_cfl > 0 && cfl > 0)
       {
-        auto cell = p.first;
-        fe_values.reinit(cell);
-        std::vector<std::vector<Tensor<1, dim, Number>>> u_gradient(
-          1, std::vector<Tensor<1, dim, Number>>(fe.n_components()));
-        fe_values.get_function_gradients(fe_function, u_gradient);
-        for (unsigned int i = 0; i < gradient.size(); ++i)
-          {
-            // In SPH interpolation, volume must be multiplied because kernel
-            // function has a unit of LENGTH^{-dim}
-            u_gradient[0][i] *= p.second * cell->measure();
-            gradient[i] += u_gradient[0][i];
-          }
+        proposal = std::min(proposal, delta_t * target_cfl / cfl);
       }
-  }
-
-  template <int dim, typename VectorType>
-  GridInterpolator<dim, VectorType>::GridInterpolator(
-    const DoFHandler<dim> &dof_handler,
-    const Point<dim> &point,
-    const std::vector<bool> &mask,
-    const typename DoFHandler<dim>::active_cell_iterator &cell)
-    : dof_handler(dof_handler), point(point), cell_found(true)
-  {
-    // If the cell is valid we just use the cell
-    if (cell.state() == IteratorState::IteratorStates::valid)
+    if (target_iterations > 0 && iterations > 0)
       {
-        cell_point.first = cell;
-        cell_point.second = mapping.transform_real_to_unit_cell(cell, point);
-        return;
+        // The square root damps the reaction to a single hard step.
+        proposal = std::min(
+          proposal,
+          delta_t * std::sqrt(static_cast<double>(target_iterations) /
+                              iterations));
       }
-    // This function throws an exception of GridTools::ExcPointNotFound if the
-    // point
-    // does not lie in any cell. In this case, we set the cell pointer to null.
-    try
+    if (max_delta_t > 0)
       {
-        cell_point = GridTools::find_active_cell_around_point(
-          mapping, dof_handler, point, mask);
+        proposal = std::min(proposal, max_delta_t);
       }
-    catch (GridTools::ExcPointNotFound<dim> &e)
+    proposal = std::max(proposal, min_delta_t);
+    const double remaining = time.end() - time.current();
+    if (remaining > 0 && proposal > remaining)
       {
-        cell_point.first = dof_handler.end();
-        cell_point.second = point;
-        cell_found = false;
+        proposal = remaining;
       }
+    return proposal;
   }
 
-  template <int dim, typename VectorType>
-  void GridInterpolator<dim, VectorType>::point_value(
-    const VectorType &fe_function,
-    Vector<typename VectorType::value_type> &value)
+#ifdef OPENIFEM_WITH_LIKWID
+  namespace
   {
-    typedef typename VectorType::value_type Number;
-    const FiniteElement<dim> &fe = dof_handler.get_fe();
-    Assert(value.size() == fe.n_components(),
-           ExcDimensionMismatch(value.size(), fe.n_components()));
-    // If for some reason, the point is not found in any cell,
-    // or it is on a cell that is not locally owned, return 0.
-    if (cell_point.first == dof_handler.end() ||
-        !cell_point.first->is_locally_owned())
+    // Starts the marker API at the first region and writes the results of
+    // the process when the program exits.
+    struct LikwidMarkers
+    {
+      LikwidMarkers()
       {
-        value = 0;
-        return;
+        LIKWID_MARKER_INIT;
+        LIKWID_MARKER_THREADINIT;
       }
-    Assert(GeometryInfo<dim>::distance_to_unit_cell(cell_point.second) < 1e-10,
-           ExcInternalError());
-
-    const Quadrature<dim> quadrature(
-      GeometryInfo<dim>::project_to_unit_cell(cell_point.second));
-    FEValues<dim> fe_values(mapping, fe, quadrature, update_values);
-    fe_values.reinit(cell_point.first);
-    std::vector<Vector<Number>> u_value(1, Vector<Number>(fe.n_components()));
-    fe_values.get_function_values(fe_function, u_value);
-    value = u_value[0];
-  }
-
-  template <int dim, typename VectorType>
-  void GridInterpolator<dim, VectorType>::point_gradient(
-    const VectorType &fe_function,
-    std::vector<Tensor<1, dim, typename VectorType::value_type>> &gradient)
-  {
-    typedef typename VectorType::value_type Number;
-    const FiniteElement<dim> &fe = dof_handler.get_fe();
-    Assert(gradient.size() == fe.n_components(),
-           ExcDimensionMismatch(gradient.size(), fe.n_components()));
-    // If for some reason, the point is not found in any cell,
-    // or it is on a cell that is not locally owned, return 0.
-    if (cell_point.first == dof_handler.end() ||
-        !cell_point.first->is_locally_owned())
+      ~LikwidMarkers()
       {
-        for (auto &v : gradient)
-          {
-            v = 0;
-          }
-        return;
+        LIKWID_MARKER_CLOSE;
       }
-    Assert(GeometryInfo<dim>::distance_to_unit_cell(cell_point.second) < 1e-10,
-           ExcInternalError());
+    };
+  } // namespace
+#endif
 
-    const Quadrature<dim> quadrature(
-      GeometryInfo<dim>::project_to_unit_cell(cell_point.second));
-    FEValues<dim> fe_values(mapping, fe, quadrature, update_gradients);
-    fe_values.reinit(cell_point.first);
-    std::vector<std::vector<Tensor<1, dim, Number>>> u_gradient(
-      1, std::vector<Tensor<1, dim, Number>>(fe.n_components()));
-    fe_values.get_function_gradients(fe_function, u_gradient);
-    gradient = u_gradient[0];
+  ProfilingScope::ProfilingScope(TimerOutput &timer,
+                                 const std::string &section)
+    : scope(timer, section), region(section)
+  {
+#ifdef OPENIFEM_WITH_LIKWID
+    static LikwidMarkers markers;
+    std::replace(region.begin(), region.end(), ' ', '_');
+    LIKWID_MARKER_START(region.c_str());
+#endif
   }
 
-  template <int dim, typename VectorType>
-  const typename DoFHandler<dim>::active_cell_iterator
-  GridInterpolator<dim, VectorType>::get_cell() const
+  ProfilingScope::~ProfilingScope()
   {
-    return cell_point.first;
+#ifdef OPENIFEM_WITH_LIKWID
+    LIKWID_MARKER_STOP(region.c_str());
+#endif
   }
 
-  template <int dim, typename MeshType>
-  CellLocator<dim, MeshType>::CellLocator(
-    DoFHandler<dim> &dh,
-    const Point<dim> &p,
-    const typename MeshType::active_cell_iterator &hint)
-    : dof_handler(dh), point(p), hint(hint), cell_found(true)
+  ForcingTerm::ForcingTerm(const double fixed_tolerance,
+                           const bool adaptive,
+                           const double max_tolerance)
+    : fixed_tolerance(fixed_tolerance),
+      adaptive(adaptive),
+      max_tolerance(std::max(max_tolerance, fixed_tolerance)),
+      previous_residual(0),
+      previous_tolerance(0)
   {
   }
 
-  template <int dim, typename MeshType>
-  const typename MeshType::active_cell_iterator
-  CellLocator<dim, MeshType>::search()
+  double ForcingTerm::next(const double residual)
   {
-    // If the hint is the begin iterator we do not use BFS.
-    if (hint == dof_handler.begin_active())
+    if (!adaptive)
       {
-        MappingQ1<dim> mapping;
-        return (GridTools::find_active_cell_around_point(
-                  mapping, dof_handler, point))
-          .first;
+        return fixed_tolerance;
       }
-    // Create an unordered set to store the flagged cells
-    std::unordered_set<std::string> flag_table;
-    std::queue<typename MeshType::active_cell_iterator> cell_queue;
-    // Start with the hint cell
-    cell_queue.push(hint);
-    while (!cell_queue.empty())
+    const double gamma = 0.9;
+    double tolerance = max_tolerance;
+    if (previous_residual > 0)
+      {
+        const double ratio = residual / previous_residual;
+        tolerance = gamma * ratio * ratio;
+        // Keep the tolerance from dropping after a lucky step.
+        const double safeguard =
+          gamma * previous_tolerance * previous_tolerance;
+        if (safeguard > 0.1)
+          {
+            tolerance = std::max(tolerance, safeguard);
+          }
+        tolerance = std::min(tolerance, max_tolerance);
+      }
+    tolerance = std::max(tolerance, fixed_tolerance);
+    previous_residual = residual;
+    previous_tolerance = tolerance;
+    return tolerance;
+  }
+
+  InterfaceAccelerator::InterfaceAccelerator(const std::string &method,
+                                             const double initial_relaxation)
+    : quasi_newton(method == "IQN-ILS"),
+      relaxation(initial_relaxation)
+  {
+    AssertThrow(method == "Aitken" || method == "IQN-ILS",
+                ExcMessage("Unknown coupling acceleration " + method));
+  }
+
+  void InterfaceAccelerator::next(Vector<double> &x,
+                                  const Vector<double> &output)
+  {
+    Vector<double> residual(output);
+    residual -= x;
+    if (previous_residual.size() == residual.size())
       {
-        auto current_cell = cell_queue.front();
-        flag_table.insert(current_cell->id().to_string());
-        cell_queue.pop();
-        // If the point is inside current cell then we are done.
-        if (current_cell->point_inside(point))
+        Vector<double> residual_difference(residual);
+        residual_difference -= previous_residual;
+        if (quasi_newton)
           {
-            return current_cell;
+            Vector<double> output_difference(output);
+            output_difference -= previous_output;
+            residual_differences.insert(residual_differences.begin(),
+                                        residual_difference);
+            output_differences.insert(output_differences.begin(),
+                                      output_difference);
           }
-        std::vector<typename MeshType::active_cell_iterator> neightbors;
-        // Get all the active neighbors!
-        GridTools::get_active_neighbors<MeshType>(current_cell, neightbors);
-        for (unsigned int i = 0; i < neightbors.size(); ++i)
+        else
           {
-            // Push all the unflagged cells into the queue
-            if (flag_table.find(neightbors[i]->id().to_string()) ==
-                flag_table.end())
+            const double denominator = residual_difference.norm_sqr();
+            if (denominator > 0)
               {
-                cell_queue.push(neightbors[i]);
-                flag_table.insert(neightbors[i]->id().to_string());
+                relaxation *=
+                  -(previous_residual * residual_difference) / denominator;
               }
           }
       }
-    // If the queue is already empty, we failed in finding the cell
-    cell_found = false;
-    // Return an invalid iterator
-    typename MeshType::active_cell_iterator invalid_itr;
-    return invalid_itr;
-  }
-
-  // Written by Davis Wells on dealii mailing list.
-  template <int dim>
-  void GridCreator<dim>::flow_around_cylinder_2d(Triangulation<2> &tria,
-                                                 bool compute_in_2d)
-  {
-    double left = compute_in_2d ? 0.0 : -0.3;
+    previous_residual = residual;
+    previous_output = output;
 
-    // set up the bulk triangulation
-    Triangulation<2> bulk_triangulation;
-    GridGenerator::subdivided_hyper_rectangle(bulk_triangulation,
-                                              {compute_in_2d ? 22u : 25u, 4u},
-                                              Point<2>(left, 0.0),
-                                              Point<2>(2.2, 0.41));
-    std::set<Triangulation<2>::active_cell_iterator> cells_to_remove;
-    Tensor<1, 2> cylinder_triangulation_offset;
-    for (const auto cell : bulk_triangulation.active_cell_iterators())
+    if (residual_differences.empty())
       {
-        if ((cell->center() - Point<2>(0.2, 0.2)).norm() < 0.15)
-          cells_to_remove.insert(cell);
+        x.add(relaxation, residual);
+        return;
+      }
 
-        if (cylinder_triangulation_offset == Point<2>())
+    // Modified Gram-Schmidt QR of V, where R is stored by columns. A column
+    // whose part orthogonal to the newer columns is small is dropped.
+    std::vector<Vector<double>> q;
+    std::vector<std::vector<double>> r;
+    std::vector<unsigned int> kept;
+    for (unsigned int j = 0; j < residual_differences.size(); ++j)
+      {
+        Vector<double> v(residual_differences[j]);
+        const double norm = v.l2_norm();
+        std::vector<double> column;
+        for (unsigned int k = 0; k < q.size(); ++k)
           {
-            for (unsigned int vertex_n = 0;
-                 vertex_n < GeometryInfo<2>::vertices_per_cell;
-                 ++vertex_n)
-              if (cell->vertex(vertex_n) == Point<2>(left, 0.0))
-                {
-                  // skip two cells in the bottom left corner
-                  cylinder_triangulation_offset =
-                    2.0 * (cell->vertex(3) - Point<2>(left, 0.0));
-                  break;
-                }
+            column.push_back(q[k] * v);
+            v.add(-column.back(), q[k]);
+          }
+        const double diagonal = v.l2_norm();
+        if (diagonal <= 1e-8 * norm || norm == 0)
+          {
+            continue;
           }
+        column.push_back(diagonal);
+        v /= diagonal;
+        q.push_back(v);
+        r.push_back(column);
+        kept.push_back(j);
+      }
+    if (kept.size() < residual_differences.size())
+      {
+        std::vector<Vector<double>> residuals, outputs;
+        for (const unsigned int j : kept)
+          {
+            residuals.push_back(residual_differences[j]);
+            outputs.push_back(output_differences[j]);
+          }
+        residual_differences.swap(residuals);
+        output_differences.swap(outputs);
       }
-    Triangulation<2> result_1;
-    GridGenerator::create_triangulation_with_removed_cells(
-      bulk_triangulation, cells_to_remove, result_1);
-
-    // set up the cylinder triangulation
-    Triangulation<2> cylinder_triangulation;
-    GridGenerator::hyper_cube_with_cylindrical_hole(
-      cylinder_triangulation, 0.05, 0.41 / 4.0);
-    GridTools::shift(cylinder_triangulation_offset, cylinder_triangulation);
-    // dumb hack
-    for (const auto cell : cylinder_triangulation.active_cell_iterators())
-      cell->set_material_id(2);
+
+    // Solve R c = -Q^T r by back substitution.
+    const unsigned int n = q.size();
+    if (n == 0)
+      {
+        x.add(relaxation, residual);
+        return;
+      }
+    std::vector<double> c(n);
+    for (unsigned int k = 0; k < n; ++k)
+      {
+        c[k] = -(q[k] * residual);
+      }
+    for (unsigned int k = n; k-- > 0;)
+      {
+        for (unsigned int j = k + 1; j < n; ++j)
+          {
+            c[k] -= r[j][k] * c[j];
+          }
+        c[k] /= r[k][k];
+      }
+    x = output;
+    for (unsigned int k = 0; k < n; ++k)
+      {
+        x.add(c[k], output_differences[k]);
+      }
+  }
+
+  namespace
+  {
+    /// Raw access to the locally owned entries of a PETSc vector.
+    class ConstLocalEntries
+    {
+    public:
+      explicit ConstLocalEntries(const PETScWrappers::MPI::Vector &v)
+        : vector(static_cast<const Vec &>(v))
+      {
+        PetscErrorCode ierr = VecGetArrayRead(vector, &data);
+        AssertThrow(ierr == 0, ExcPETScError(ierr));
+      }
+      ~ConstLocalEntries() { VecRestoreArrayRead(vector, &data); }
+      PetscScalar operator[](const unsigned int i) const { return data[i]; }
+
+    private:
+      Vec vector;
+      const PetscScalar *data;
+    };
+
+    class LocalEntries
+    {
+    public:
+      explicit LocalEntries(PETScWrappers::MPI::Vector &v)
+        : vector(static_cast<const Vec &>(v))
+      {
+        PetscErrorCode ierr = VecGetArray(vector, &data);
+        AssertThrow(ierr == 0, ExcPETScError(ierr));
+      }
+      ~LocalEntries() { VecRestoreArray(vector, &data); }
+      PetscScalar &operator[](const unsigned int i) { return data[i]; }
+
+    private:
+      Vec vector;
+      PetscScalar *data;
+    };
+  } // namespace
+
+  Newmark::Newmark(const double delta_t, const double gamma, const double beta)
+    : delta_t(delta_t), gamma(gamma), beta(beta)
+  {
+  }
+
+  void Newmark::predict(const VectorType &previous_displacement,
+                        const VectorType &previous_velocity,
+                        const VectorType &previous_acceleration,
+                        VectorType &predicted_displacement) const
+  {
+    const unsigned int n = previous_displacement.local_size();
+    Assert(predicted_displacement.local_size() == n,
+           ExcDimensionMismatch(predicted_displacement.local_size(), n));
+    const double c = (0.5 - beta) * delta_t * delta_t;
+    const ConstLocalEntries d_n(previous_displacement);
+    const ConstLocalEntries v_n(previous_velocity);
+    const ConstLocalEntries a_n(previous_acceleration);
+    LocalEntries d_tilde(predicted_displacement);
+    for (unsigned int i = 0; i < n; ++i)
+      {
+        d_tilde[i] = d_n[i] + delta_t * v_n[i] + c * a_n[i];
+      }
+  }
+
+  void Newmark::update(const VectorType &predicted_displacement,
+                       const VectorType &previous_velocity,
+                       const VectorType &previous_acceleration,
+                       const VectorType &displacement,
+                       VectorType &acceleration,
+                       VectorType &velocity) const
+  {
+    const unsigned int n = displacement.local_size();
+    Assert(acceleration.local_size() == n && velocity.local_size() == n,
+           ExcDimensionMismatch(acceleration.local_size(), n));
+    const double inverse = 1.0 / (beta * delta_t * delta_t);
+    const ConstLocalEntries d_tilde(predicted_displacement);
+    const ConstLocalEntries v_n(previous_velocity);
+    const ConstLocalEntries a_n(previous_acceleration);
+    const ConstLocalEntries d(displacement);
+    LocalEntries a(acceleration);
+    LocalEntries v(velocity);
+    for (unsigned int i = 0; i < n; ++i)
+      {
+        a[i] = (d[i] - d_tilde[i]) * inverse;
+        v[i] = v_n[i] + delta_t * ((1 - gamma) * a_n[i] + gamma * a[i]);
+      }
+  }
+
+  void Newmark::advance_from_acceleration(
+    const VectorType &predicted_displacement,
+    const VectorType &acceleration,
+    VectorType &velocity,
+    VectorType &displacement,
+    VectorType &previous_displacement,
+    VectorType &previous_velocity,
+    VectorType &previous_acceleration) const
+  {
+    const unsigned int n = acceleration.local_size();
+    Assert(velocity.local_size() == n && displacement.local_size() == n,
+           ExcDimensionMismatch(velocity.local_size(), n));
+    const double c = beta * delta_t * delta_t;
+    const ConstLocalEntries d_tilde(predicted_displacement);
+    const ConstLocalEntries a(acceleration);
+    LocalEntries v(velocity);
+    LocalEntries d(displacement);
+    LocalEntries d_n(previous_displacement);
+    LocalEntries v_n(previous_velocity);
+    LocalEntries a_n(previous_acceleration);
+    for (unsigned int i = 0; i < n; ++i)
+      {
+        v[i] = v_n[i] + delta_t * ((1 - gamma) * a_n[i] + gamma * a[i]);
+        d[i] = d_tilde[i] + c * a[i];
+        d_n[i] = d[i];
+        v_n[i] = v[i];
+        a_n[i] = a[i];
+      }
+  }
+
+  void Newmark::advance_from_displacement(
+    const VectorType &predicted_displacement,
+    const VectorType &displacement,
+    VectorType &acceleration,
+    VectorType &velocity,
+    VectorType &previous_displacement,
+    VectorType &previous_velocity,
+    VectorType &previous_acceleration) const
+  {
+    const unsigned int n = displacement.local_size();
+    Assert(acceleration.local_size() == n && velocity.local_size() == n,
+           ExcDimensionMismatch(acceleration.local_size(), n));
+    const double inverse = 1.0 / (beta * delta_t * delta_t);
+    const ConstLocalEntries d_tilde(predicted_displacement);
+    const ConstLocalEntries d(displacement);
+    LocalEntries a(acceleration);
+    LocalEntries v(velocity);
+    LocalEntries d_n(previous_displacement);
+    LocalEntries v_n(previous_velocity);
+    LocalEntries a_n(previous_acceleration);
+    for (unsigned int i = 0; i < n; ++i)
+      {
+        a[i] = (d[i] - d_tilde[i]) * inverse;
+        v[i] = v_n[i] + delta_t * ((1 - gamma) * a_n[i] + gamma * a[i]);
+        d_n[i] = d[i];
+        v_n[i] = v[i];
+        a_n[i] = a[i];
+      }
+  }
+
+  PerformanceCounters::Scope::Scope(PerformanceCounters &c,
+                                    const std::string &p)
+    : counters(c), phase(p), start(std::chrono::steady_clock::now())
+  {
+  }
+
+  PerformanceCounters::Scope::~Scope()
+  {
+    if (!counters.active())
+      return;
+    std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+    counters[phase].wall_time += elapsed.count();
+  }
+
+  PerformanceCounters::PerformanceCounters(const MPI_Comm &comm)
+    : mpi_communicator(comm), is_active(false)
+  {
+  }
+
+  void PerformanceCounters::open(const std::string &filename)
+  {
+    is_active = true;
+    if (Utilities::MPI::this_mpi_process(mpi_communicator) == 0)
+      {
+        file.open(filename);
+        AssertThrow(file, ExcMessage("Cannot open " + filename));
+        file << "timestep,time,phase,wall_max,wall_avg,mpi_max,mpi_avg,"
+             << "iterations,hits,misses,bytes" << std::endl;
+      }
+  }
+
+  PerformanceCounters::Record &PerformanceCounters::operator[](
+    const std::string &phase)
+  {
+    return records[phase];
+  }
+
+  void PerformanceCounters::write(const unsigned int timestep,
+                                  const double time)
+  {
+    if (!is_active)
+      return;
+    // The records are created by the processes that do the work of a phase,
+    // so the phases of all processes are added everywhere first. The records
+    // are then in the same order everywhere and can be reduced in one go.
+    std::vector<std::string> phases;
+    for (const auto &record : records)
+      {
+        phases.push_back(record.first);
+      }
+    for (const auto &names :
+         Utilities::MPI::all_gather(mpi_communicator, phases))
+      {
+        for (const auto &name : names)
+          {
+            records[name];
+          }
+      }
+    std::vector<double> maxima, sums;
+    for (auto &record : records)
+      {
+        const Record &r = record.second;
+        maxima.insert(maxima.end(), {r.wall_time, r.mpi_time, r.iterations});
+        sums.insert(sums.end(),
+                    {r.wall_time, r.mpi_time, r.hits, r.misses, r.bytes});
+      }
+    std::vector<double> global_maxima(maxima.size()),
+      global_sums(sums.size());
+    Utilities::MPI::max(maxima, mpi_communicator, global_maxima);
+    Utilities::MPI::sum(sums, mpi_communicator, global_sums);
+    const double n_procs = Utilities::MPI::n_mpi_processes(mpi_communicator);
+    if (Utilities::MPI::this_mpi_process(mpi_communicator) == 0)
+      {
+        unsigned int i = 0;
+        for (auto &record : records)
+          {
+            file << timestep << "," << time << "," << record.first << ","
+                 << global_maxima[3 * i] << "," << global_sums[5 * i] / n_procs
+                 << "," << global_maxima[3 * i + 1] << ","
+                 << global_sums[5 * i + 1] / n_procs << ","
+                 << global_maxima[3 * i + 2] << "," << global_sums[5 * i + 2]
+                 << "," << global_sums[5 * i + 3] << ","
+                 << global_sums[5 * i + 4] << std::endl;
+            ++i;
+          }
+      }
+    for (auto &record : records)
+      {
+        record.second = Record();
+      }
+  }
+
+  MemoryReport::MemoryReport(const MPI_Comm &comm) : mpi_communicator(comm)
+  {
+  }
+
+  void MemoryReport::add(const std::string &subsystem, const double bytes)
+  {
+    for (auto &s : subsystems)
+      {
+        if (s.first == subsystem)
+          {
+            s.second += bytes;
+            return;
+          }
+      }
+    subsystems.push_back({subsystem, bytes});
+  }
+
+  void MemoryReport::add(const std::string &subsystem,
+                         const PETScWrappers::MatrixBase &matrix)
+  {
+    MatInfo info;
+    PetscErrorCode ierr = MatGetInfo(matrix, MAT_LOCAL, &info);
+    AssertThrow(ierr == 0, ExcPETScError(ierr));
+    add(subsystem, info.memory);
+  }
+
+  void
+  MemoryReport::add(const std::string &subsystem,
+                    const PETScWrappers::MPI::BlockSparseMatrix &matrix)
+  {
+    add(subsystem, 0.0);
+    for (unsigned int i = 0; i < matrix.n_block_rows(); ++i)
+      {
+        for (unsigned int j = 0; j < matrix.n_block_cols(); ++j)
+          {
+            add(subsystem, matrix.block(i, j));
+          }
+      }
+  }
+
+  void MemoryReport::print(std::ostream &out, const std::string &title)
+  {
+    const double MB = 1024.0 * 1024.0;
+    double total = 0;
+    std::vector<Utilities::MPI::MinMaxAvg> stats;
+    for (auto &s : subsystems)
+      {
+        stats.push_back(
+          Utilities::MPI::min_max_avg(s.second / MB, mpi_communicator));
+        total += s.second;
+      }
+    stats.push_back(Utilities::MPI::min_max_avg(total / MB, mpi_communicator));
+    if (Utilities::MPI::this_mpi_process(mpi_communicator) == 0)
+      {
+        out << title << " (MB per process):" << std::endl
+            << std::left << std::setw(34) << "  Subsystem" << std::right
+            << std::setw(11) << "min" << std::setw(11) << "avg"
+            << std::setw(11) << "max" << std::setw(7) << "rank" << std::endl;
+        for (unsigned int i = 0; i < stats.size(); ++i)
+          {
+            const std::string name =
+              (i < subsystems.size() ? subsystems[i].first : "Total");
+            out << "  " << std::left << std::setw(32) << name << std::right
+                << std::fixed << std::setprecision(2) << std::setw(11)
+                << stats[i].min << std::setw(11) << stats[i].avg
+                << std::setw(11) << stats[i].max << std::setw(7)
+                << stats[i].max_index << std::defaultfloat << std::endl;
+          }
+      }
+    subsystems.clear();
+  }
+
+  double MemoryReport::resident_memory()
+  {
+    Utilities::System::MemoryStats stats;
+    Utilities::System::get_memory_stats(stats);
+    return stats.VmRSS * 1024.0;
+  }
+
+  double MemoryReport::peak_resident_memory()
+  {
+    Utilities::System::MemoryStats stats;
+    Utilities::System::get_memory_stats(stats);
+    return stats.VmHWM * 1024.0;
+  }
+
+  void MemoryReport::print_peak_memory(std::ostream &out,
+                                       const MPI_Comm &comm,
+                                       const std::string &title)
+  {
+    const double MB = 1024.0 * 1024.0;
+    const auto peak =
+      Utilities::MPI::min_max_avg(peak_resident_memory() / MB, comm);
+    if (Utilities::MPI::this_mpi_process(comm) == 0)
+      {
+        out << title << " (MB per process): min " << std::fixed
+            << std::setprecision(2) << peak.min << ", avg " << peak.avg
+            << ", max " << peak.max << " on rank " << peak.max_index
+            << std::defaultfloat << std::endl;
+      }
+  }
+
+  std::string encode_values(const std::vector<double> &values,
+                            const std::vector<double> *reference)
+  {
+    AssertThrow(!reference || reference->size() == values.size(),
+                ExcMessage("The reference does not match the values!"));
+    const std::size_t n = values.size();
+    std::string shuffled(n * sizeof(std::uint64_t), '\0');
+    for (std::size_t i = 0; i < n; ++i)
+      {
+        std::uint64_t bits, reference_bits = 0;
+        std::memcpy(&bits, &values[i], sizeof(bits));
+        if (reference)
+          {
+            std::memcpy(&reference_bits, &(*reference)[i], sizeof(bits));
+          }
+        bits ^= reference_bits;
+        for (unsigned int b = 0; b < sizeof(bits); ++b)
+          {
+            shuffled[b * n + i] = static_cast<char>((bits >> (8 * b)) & 0xff);
+          }
+      }
+    return Utilities::compress(shuffled);
+  }
+
+  void decode_values(const std::string &data,
+                     std::vector<double> &values,
+                     const std::vector<double> *reference)
+  {
+    const std::string shuffled = Utilities::decompress(data);
+    AssertThrow(shuffled.size() % sizeof(std::uint64_t) == 0,
+                ExcMessage("Corrupted checkpoint values!"));
+    const std::size_t n = shuffled.size() / sizeof(std::uint64_t);
+    AssertThrow(!reference || reference->size() == n,
+                ExcMessage("The reference does not match the values!"));
+    values.resize(n);
+    for (std::size_t i = 0; i < n; ++i)
+      {
+        std::uint64_t bits = 0, reference_bits = 0;
+        for (unsigned int b = 0; b < sizeof(bits); ++b)
+          {
+            bits |= static_cast<std::uint64_t>(
+                      static_cast<unsigned char>(shuffled[b * n + i]))
+                    << (8 * b);
+          }
+        if (reference)
+          {
+            std::memcpy(&reference_bits, &(*reference)[i], sizeof(bits));
+          }
+        bits ^= reference_bits;
+        std::memcpy(&values[i], &bits, sizeof(bits));
+      }
+  }
+
+  std::vector<int> stale_checkpoints(std::vector<int> steps,
+                                     const unsigned int n_kept,
+                                     const std::function<int(int)> &key_of)
+  {
+    std::sort(steps.begin(), steps.end());
+    std::set<int> kept;
+    for (unsigned int i = 0; i < std::min<std::size_t>(n_kept, steps.size());
+         ++i)
+      {
+        const int step = steps[steps.size() - 1 - i];
+        kept.insert(step);
+        const int key = key_of(step);
+        if (key >= 0)
+          {
+            kept.insert(key);
+          }
+      }
+    std::vector<int> stale;
+    for (const int step : steps)
+      {
+        if (kept.count(step) == 0)
+          {
+            stale.push_back(step);
+          }
+      }
+    return stale;
+  }
+
+  void fill_zero_diagonal(PETScWrappers::MatrixBase &matrix)
+  {
+    const auto range = matrix.local_range();
+    std::vector<types::global_dof_index> zero_rows;
+    double sum = 0;
+    for (auto i = range.first; i < range.second; ++i)
+      {
+        const double value = matrix.diag_element(i);
+        if (value == 0)
+          {
+            zero_rows.push_back(i);
+          }
+        sum += std::abs(value);
+      }
+    const MPI_Comm comm = matrix.get_mpi_communicator();
+    sum = Utilities::MPI::sum(sum, comm);
+    const types::global_dof_index n_nonzero =
+      matrix.m() - Utilities::MPI::sum(
+                     static_cast<types::global_dof_index>(zero_rows.size()),
+                     comm);
+    const double diagonal = n_nonzero > 0 ? sum / n_nonzero : 1.0;
+    for (const auto i : zero_rows)
+      {
+        matrix.set(i, i, diagonal);
+      }
+    matrix.compress(VectorOperation::insert);
+  }
+
+  template <int dim>
+  std::vector<unsigned int>
+  fsi_velocity_dofs(const FiniteElement<dim> &fluid_fe)
+  {
+    const std::vector<Point<dim>> &unit_points =
+      fluid_fe.get_unit_support_points();
+    std::vector<unsigned int> result;
+    for (unsigned int i = 0; i < unit_points.size(); ++i)
+      {
+        const unsigned int i_group =
+          fluid_fe.system_to_base_index(i).first.first;
+        Assert(i_group < 2,
+               ExcMessage("There should be only 2 groups of finite element!"));
+        if (i_group == 1)
+          continue; // skip the pressure dofs
+        bool inside = true;
+        for (unsigned int d = 0; d < dim; ++d)
+          if (std::abs(unit_points[i][d]) < 1e-5)
+            {
+              inside = false;
+              break;
+            }
+        if (inside)
+          continue; // skip the in-cell support point
+        Assert(fluid_fe.system_to_component_index(i).first < dim,
+               ExcMessage("Vector component should be less than dim!"));
+        result.push_back(i);
+      }
+    return result;
+  }
+
+  Ensemble::Ensemble(const MPI_Comm &comm, const unsigned int n_groups)
+    : mpi_communicator(comm)
+  {
+    AssertThrow(n_groups > 0, ExcMessage("At least one group is needed!"));
+    const unsigned int n_procs = Utilities::MPI::n_mpi_processes(comm);
+    const unsigned int rank = Utilities::MPI::this_mpi_process(comm);
+    groups = std::min(n_groups, n_procs);
+    // Balanced groups of consecutive ranks.
+    group = static_cast<unsigned int>(
+      (static_cast<unsigned long long>(rank) * groups) / n_procs);
+    const int ierr = MPI_Comm_split(comm, group, rank, &group_communicator);
+    AssertThrowMPI(ierr);
+  }
+
+  Ensemble::~Ensemble()
+  {
+    int finalized;
+    MPI_Finalized(&finalized);
+    if (!finalized)
+      {
+        MPI_Comm_free(&group_communicator);
+      }
+  }
+
+  SolidGroup::SolidGroup(const MPI_Comm &comm, const unsigned int n_solid)
+  {
+    const unsigned int rank = Utilities::MPI::this_mpi_process(comm);
+    in_group = n_solid == 0 || rank < n_solid;
+    // The group is color 0, the others are alone in their colors.
+    const int color = in_group ? 0 : rank;
+    const int ierr = MPI_Comm_split(comm, color, rank, &solid_communicator);
+    AssertThrowMPI(ierr);
+  }
+
+  SolidGroup::~SolidGroup()
+  {
+    int finalized;
+    MPI_Finalized(&finalized);
+    if (!finalized)
+      {
+        MPI_Comm_free(&solid_communicator);
+      }
+  }
+
+  std::vector<unsigned int>
+  Ensemble::local_cases(const unsigned int n_cases) const
+  {
+    std::vector<unsigned int> cases;
+    for (unsigned int c = group; c < n_cases; c += groups)
+      {
+        cases.push_back(c);
+      }
+    return cases;
+  }
+
+  void Ensemble::add_result(const unsigned int case_index,
+                            const std::vector<double> &values)
+  {
+    if (Utilities::MPI::this_mpi_process(group_communicator) == 0)
+      {
+        results[case_index] = values;
+      }
+  }
+
+  void Ensemble::write_results(const std::string &filename,
+                               const std::vector<std::string> &columns) const
+  {
+    // Every result is sent as the case, the number of values and the values.
+    std::vector<double> local;
+    for (auto &result : results)
+      {
+        local.push_back(result.first);
+        local.push_back(result.second.size());
+        local.insert(local.end(), result.second.begin(), result.second.end());
+      }
+    const std::vector<std::vector<double>> all =
+      Utilities::MPI::gather(mpi_communicator, local, 0);
+    if (Utilities::MPI::this_mpi_process(mpi_communicator) != 0)
+      return;
+    std::map<unsigned int, std::vector<double>> all_results;
+    for (auto &received : all)
+      {
+        for (unsigned int i = 0; i < received.size();)
+          {
+            const unsigned int case_index = received[i];
+            const unsigned int n_values = received[i + 1];
+            all_results[case_index].assign(received.begin() + i + 2,
+                                           received.begin() + i + 2 +
+                                             n_values);
+            i += 2 + n_values;
+          }
+      }
+    std::ofstream file(filename);
+    AssertThrow(file, ExcMessage("Cannot open " + filename));
+    file << "case";
+    for (auto &column : columns)
+      {
+        file << "," << column;
+      }
+    file << std::endl;
+    file << std::setprecision(12);
+    for (auto &result : all_results)
+      {
+        file << result.first;
+        for (auto value : result.second)
+          {
+            file << "," << value;
+          }
+        file << std::endl;
+      }
+  }
+
+  NodeSharedVector::NodeSharedVector(const MPI_Comm &comm)
+    : leader_communicator(MPI_COMM_NULL),
+      window(MPI_WIN_NULL),
+      values(nullptr),
+      n_elements(0)
+  {
+    const int rank = Utilities::MPI::this_mpi_process(comm);
+    int ierr = MPI_Comm_split_type(
+      comm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &node_communicator);
+    AssertThrowMPI(ierr);
+    const bool leader =
+      Utilities::MPI::this_mpi_process(node_communicator) == 0;
+    ierr = MPI_Comm_split(
+      comm, leader ? 0 : MPI_UNDEFINED, rank, &leader_communicator);
+    AssertThrowMPI(ierr);
+  }
+
+  NodeSharedVector::~NodeSharedVector()
+  {
+    int finalized;
+    MPI_Finalized(&finalized);
+    if (!finalized)
+      {
+        free_window();
+        if (leader_communicator != MPI_COMM_NULL)
+          {
+            MPI_Comm_free(&leader_communicator);
+          }
+        MPI_Comm_free(&node_communicator);
+      }
+  }
+
+  void NodeSharedVector::free_window()
+  {
+    if (window != MPI_WIN_NULL)
+      {
+        MPI_Win_unlock_all(window);
+        MPI_Win_free(&window);
+      }
+    values = nullptr;
+    n_elements = 0;
+  }
+
+  void NodeSharedVector::reinit(const std::size_t size)
+  {
+    free_window();
+    const bool leader = leader_communicator != MPI_COMM_NULL;
+    double *base;
+    int ierr = MPI_Win_allocate_shared(leader ? size * sizeof(double) : 0,
+                                       sizeof(double),
+                                       MPI_INFO_NULL,
+                                       node_communicator,
+                                       &base,
+                                       &window);
+    AssertThrowMPI(ierr);
+    MPI_Aint window_size;
+    int displacement_unit;
+    ierr = MPI_Win_shared_query(
+      window, 0, &window_size, &displacement_unit, &values);
+    AssertThrowMPI(ierr);
+    // A passive target epoch for the whole lifetime of the window, in which
+    // MPI_Win_sync orders the accesses around the barriers.
+    ierr = MPI_Win_lock_all(MPI_MODE_NOCHECK, window);
+    AssertThrowMPI(ierr);
+    n_elements = size;
+  }
+
+  void NodeSharedVector::localize(const PETScWrappers::MPI::Vector &vector)
+  {
+    if (vector.size() != n_elements)
+      {
+        reinit(vector.size());
+      }
+    const bool leader = leader_communicator != MPI_COMM_NULL;
+    // Nobody may still read the previous values.
+    MPI_Barrier(node_communicator);
+    if (leader)
+      {
+        std::fill(values, values + n_elements, 0.0);
+      }
+    MPI_Win_sync(window);
+    MPI_Barrier(node_communicator);
+    const PetscScalar *local;
+    PetscErrorCode ierr = VecGetArrayRead(vector, &local);
+    AssertThrow(ierr == 0, ExcPETScError(ierr));
+    std::copy(
+      local, local + vector.local_size(), values + vector.local_range().first);
+    ierr = VecRestoreArrayRead(vector, &local);
+    AssertThrow(ierr == 0, ExcPETScError(ierr));
+    MPI_Win_sync(window);
+    MPI_Barrier(node_communicator);
+    if (leader)
+      {
+        const int mpi_ierr = MPI_Allreduce(MPI_IN_PLACE,
+                                           values,
+                                           n_elements,
+                                           MPI_DOUBLE,
+                                           MPI_SUM,
+                                           leader_communicator);
+        AssertThrowMPI(mpi_ierr);
+        MPI_Win_sync(window);
+      }
+    MPI_Barrier(node_communicator);
+    MPI_Win_sync(window);
+  }
+
+  void NodeSharedVector::resize(const std::size_t size)
+  {
+    // The size is the same on all processes, so they all skip or all
+    // allocate.
+    if (size != n_elements || window == MPI_WIN_NULL)
+      {
+        reinit(size);
+      }
+  }
+
+  std::pair<std::size_t, std::size_t> NodeSharedVector::share() const
+  {
+    const std::size_t rank =
+      Utilities::MPI::this_mpi_process(node_communicator);
+    const std::size_t n_processes =
+      Utilities::MPI::n_mpi_processes(node_communicator);
+    return {n_elements * rank / n_processes,
+            n_elements * (rank + 1) / n_processes};
+  }
+
+  void NodeSharedVector::synchronize()
+  {
+    MPI_Win_sync(window);
+    MPI_Barrier(node_communicator);
+    MPI_Win_sync(window);
+  }
+
+  std::size_t NodeSharedVector::memory_consumption() const
+  {
+    return leader_communicator != MPI_COMM_NULL ? n_elements * sizeof(double)
+                                                : 0;
+  }
+
+  template <int dim, typename VectorType>
+  SPHInterpolator<dim, VectorType>::SPHInterpolator(
+    const DoFHandler<dim> &dof_handler, const Point<dim> &point)
+    : dof_handler(dof_handler), target(point)
+  {
+    for (auto cell : dof_handler.active_cell_iterators())
+      {
+        if (!cell->is_locally_owned())
+          continue;
+        Point<dim> center = cell->center();
+        double h = cell->diameter();
+        double kernel_value = cubic_spline(center, target, h);
+        if (kernel_value > 1e-12)
+          {
+            sources.push_back({cell, kernel_value});
+          }
+      }
+  }
+
+  template <int dim, typename VectorType>
+  SPHInterpolator<dim, VectorType>::SPHInterpolator(
+    const DoFHandler<dim> &dof_handler,
+    const Point<dim> &point,
+    const CellLinkedList<dim, DoFHandler<dim>> &cell_list)
+    : dof_handler(dof_handler), target(point)
+  {
+    std::vector<typename DoFHandler<dim>::active_cell_iterator> candidates;
+    cell_list.query(target, candidates);
+    for (auto &cell : candidates)
+      {
+        double kernel_value =
+          cubic_spline(cell->center(), target, cell->diameter());
+        if (kernel_value > 1e-12)
+          {
+            sources.push_back({cell, kernel_value});
+          }
+      }
+  }
+
+  template <int dim, typename VectorType>
+  double SPHInterpolator<dim, VectorType>::cubic_spline(const Point<dim> &pi,
+                                                        const Point<dim> &pj,
+                                                        double h)
+  {
+    double w(0.);
+    double q = pi.distance(pj) / h;
+    // M_1_PI = 1 / pi
+    double coef = (dim == 2 ? 10 * M_1_PI / (7 * h * h) : M_1_PI / (h * h * h));
+    if (q < 2.)
+      {
+        if (q >= 1.)
+          {
+            w = coef * (0.25 * (2 - q) * (2 - q) * (2 - q));
+          }
+        else
+          {
+            w = coef * (1 - 1.5 * q * q + 0.75 * q * q * q);
+          }
+      }
+    return w;
+  }
+
+  template <int dim, typename VectorType>
+  void SPHInterpolator<dim, VectorType>::point_value(
+    const VectorType &fe_function,
+    Vector<typename VectorType::value_type> &value)
+  {
+    typedef typename VectorType::value_type Number;
+    const FiniteElement<dim> &fe = dof_handler.get_fe();
+    Assert(value.size() == fe.n_components(),
+           ExcDimensionMismatch(value.size(), fe.n_components()));
+
+    // Cell center in unit coordinate system
+    Point<dim> unit_center;
+    for (unsigned int i = 0; i < dim; ++i)
+      unit_center[i] = 0.5;
+    Quadrature<dim> quad(unit_center);
+    MappingQGeneric<dim> mapping(1);
+    FEValues<dim> fe_values(mapping, fe, quad, update_values);
+    value = 0;
+    for (auto p : sources)
+      {
+        auto cell = p.first;
+        fe_values.reinit(cell);
+        std::vector<Vector<Number>> u_value(1,
+                                            Vector<Number>(fe.n_components()));
+        fe_values.get_function_values(fe_function, u_value);
+        // In SPH interpolation, volume must be multiplied because kernel
+        // function has a unit of LENGTH^{-dim}
+        u_value[0] *= p.second * cell->measure();
+        value += u_value[0];
+      }
+  }
+
+  template <int dim, typename VectorType>
+  void SPHInterpolator<dim, VectorType>::point_gradient(
+    const VectorType &fe_function,
+    std::vector<Tensor<1, dim, typename VectorType::value_type>> &gradient)
+  {
+    typedef typename VectorType::value_type Number;
+    const FiniteElement<dim> &fe = dof_handler.get_fe();
+    Assert(gradient.size() == fe.n_components(),
+           ExcDimensionMismatch(gradient.size(), fe.n_components()));
+    // Cell center in unit coordinate system
+    Point<dim> unit_center;
+    for (unsigned int i = 0; i < dim; ++i)
+      unit_center[i] = 0.5;
+    Quadrature<dim> quad(unit_center);
+    MappingQGeneric<dim> mapping(1);
+    FEValues<dim> fe_values(mapping, fe, quad, update_gradients);
+    for (unsigned int i = 0; i < gradient.size(); ++i)
+      gradient[i] = 0;
+    for (auto p : sources)
+      {
+        auto cell = p.first;
+        fe_values.reinit(cell);
+        std::vector<std::vector<Tensor<1, dim, Number>>> u_gradient(
+          1, std::vector<Tensor<1, dim, Number>>(fe.n_components()));
+        fe_values.get_function_gradients(fe_function, u_gradient);
+        for (unsigned int i = 0; i < gradient.size(); ++i)
+          {
+            // In SPH interpolation, volume must be multiplied because kernel
+            // function has a unit of LENGTH^{-dim}
+            u_gradient[0][i] *= p.second * cell->measure();
+            gradient[i] += u_gradient[0][i];
+          }
+      }
+  }
+
+  template <int dim, typename VectorType>
+  GridInterpolator<dim, VectorType>::GridInterpolator(
+    const DoFHandler<dim> &dof_handler,
+    const Point<dim> &point,
+    const std::vector<bool> &mask,
+    const typename DoFHandler<dim>::active_cell_iterator &cell)
+    : dof_handler(dof_handler), point(point), cell_found(true)
+  {
+    // If the cell is valid we just use the cell
+    if (cell.state() == IteratorState::IteratorStates::valid)
+      {
+        cell_point.first = cell;
+        cell_point.second = mapping.transform_real_to_unit_cell(cell, point);
+        return;
+      }
+    // This function throws an exception of GridTools::ExcPointNotFound if the
+    // point
+    // does not lie in any cell. In this case, we set the cell pointer to null.
+    try
+      {
+        cell_point = GridTools::find_active_cell_around_point(
+          mapping, dof_handler, point, mask);
+      }
+    catch (GridTools::ExcPointNotFound<dim> &e)
+      {
+        cell_point.first = dof_handler.end();
+        cell_point.second = point;
+        cell_found = false;
+      }
+  }
+
+  template <int dim, typename VectorType>
+  void GridInterpolator<dim, VectorType>::point_value(
+    const VectorType &fe_function,
+    Vector<typename VectorType::value_type> &value)
+  {
+    typedef typename VectorType::value_type Number;
+    const FiniteElement<dim> &fe = dof_handler.get_fe();
+    Assert(value.size() == fe.n_components(),
+           ExcDimensionMismatch(value.size(), fe.n_components()));
+    // If for some reason, the point is not found in any cell,
+    // or it is on a cell that is not locally owned, return 0.
+    if (cell_point.first == dof_handler.end() ||
+        !cell_point.first->is_locally_owned())
+      {
+        value = 0;
+        return;
+      }
+    Assert(GeometryInfo<dim>::distance_to_unit_cell(cell_point.second) < 1e-10,
+           ExcInternalError());
+
+    const Quadrature<dim> quadrature(
+      GeometryInfo<dim>::project_to_unit_cell(cell_point.second));
+    FEValues<dim> fe_values(mapping, fe, quadrature, update_values);
+    fe_values.reinit(cell_point.first);
+    std::vector<Vector<Number>> u_value(1, Vector<Number>(fe.n_components()));
+    fe_values.get_function_values(fe_function, u_value);
+    value = u_value[0];
+  }
+
+  template <int dim, typename VectorType>
+  void GridInterpolator<dim, VectorType>::point_gradient(
+    const VectorType &fe_function,
+    std::vector<Tensor<1, dim, typename VectorType::value_type>> &gradient)
+  {
+    typedef typename VectorType::value_type Number;
+    const FiniteElement<dim> &fe = dof_handler.get_fe();
+    Assert(gradient.size() == fe.n_components(),
+           ExcDimensionMismatch(gradient.size(), fe.n_components()));
+    // If for some reason, the point is not found in any cell,
+    // or it is on a cell that is not locally owned, return 0.
+    if (cell_point.first == dof_handler.end() ||
+        !cell_point.first->is_locally_owned())
+      {
+        for (auto &v : gradient)
+          {
+            v = 0;
+          }
+        return;
+      }
+    Assert(GeometryInfo<dim>::distance_to_unit_cell(cell_point.second) < 1e-10,
+           ExcInternalError());
+
+    const Quadrature<dim> quadrature(
+      GeometryInfo<dim>::project_to_unit_cell(cell_point.second));
+    FEValues<dim> fe_values(mapping, fe, quadrature, update_gradients);
+    fe_values.reinit(cell_point.first);
+    std::vector<std::vector<Tensor<1, dim, Number>>> u_gradient(
+      1, std::vector<Tensor<1, dim, Number>>(fe.n_components()));
+    fe_values.get_function_gradients(fe_function, u_gradient);
+    gradient = u_gradient[0];
+  }
+
+  template <int dim, typename VectorType>
+  const typename DoFHandler<dim>::active_cell_iterator
+  GridInterpolator<dim, VectorType>::get_cell() const
+  {
+    return cell_point.first;
+  }
+
+  template <int dim, typename VectorType>
+  CellPointInterpolator<dim, VectorType>::CellPointInterpolator(
+    const DoFHandler<dim> &dof_handler)
+    : dof_handler(dof_handler),
+      n_components(dof_handler.get_fe().n_components())
+  {
+  }
+
+  template <int dim, typename VectorType>
+  void CellPointInterpolator<dim, VectorType>::evaluate(
+    const typename DoFHandler<dim>::active_cell_iterator &cell,
+    const std::vector<Point<dim>> &points,
+    const VectorType &fe_function)
+  {
+    const FiniteElement<dim> &fe = dof_handler.get_fe();
+    const unsigned int dofs_per_cell = fe.dofs_per_cell;
+    Assert(cell->is_locally_owned(), ExcInternalError());
+    // The vectors only reallocate if they grow.
+    local_values.reinit(dofs_per_cell, true);
+    cell->get_dof_values(fe_function, local_values);
+    values.assign(points.size() * n_components, Number());
+    gradients.assign(points.size() * n_components, Tensor<1, dim, Number>());
+    for (unsigned int q = 0; q < points.size(); ++q)
+      {
+        const Point<dim> unit_point = GeometryInfo<dim>::project_to_unit_cell(
+          mapping.transform_real_to_unit_cell(cell, points[q]));
+        // The Jacobian of the d-linear mapping at the point, which is the same
+        // as the one MappingQ1 computes.
+        Tensor<2, dim> jacobian;
+        for (unsigned int v = 0; v < GeometryInfo<dim>::vertices_per_cell; ++v)
+          {
+            jacobian += outer_product(
+              cell->vertex(v),
+              GeometryInfo<dim>::d_linear_shape_function_gradient(unit_point,
+                                                                  v));
+          }
+        const Tensor<2, dim> inverse_transpose = transpose(invert(jacobian));
+        Number *value = &values[q * n_components];
+        Tensor<1, dim, Number> *gradient = &gradients[q * n_components];
+        for (unsigned int i = 0; i < dofs_per_cell; ++i)
+          {
+            const unsigned int c = fe.system_to_component_index(i).first;
+            value[c] += local_values[i] * fe.shape_value(i, unit_point);
+            gradient[c] += local_values[i] *
+                           (inverse_transpose * fe.shape_grad(i, unit_point));
+          }
+      }
+  }
+
+  template <int dim, typename VectorType>
+  Probes<dim, VectorType>::Probes(const DoFHandler<dim> &dof_handler,
+                                  const MPI_Comm &communicator)
+    : dof_handler(dof_handler),
+      mpi_communicator(communicator),
+      located(false),
+      holding(false),
+      interpolator(dof_handler)
+  {
+  }
+
+  template <int dim, typename VectorType>
+  void Probes<dim, VectorType>::open(
+    const std::string &filename,
+    const std::vector<std::vector<double>> &coordinates,
+    const std::vector<std::string> &component_names)
+  {
+    points.resize(coordinates.size());
+    for (unsigned int i = 0; i < points.size(); ++i)
+      {
+        AssertDimension(coordinates[i].size(), dim);
+        for (unsigned int d = 0; d < dim; ++d)
+          {
+            points[i][d] = coordinates[i][d];
+          }
+      }
+    located = false;
+    if (Utilities::MPI::this_mpi_process(mpi_communicator) == 0)
+      {
+        file.open(filename);
+        AssertThrow(file, ExcMessage("Cannot open " + filename));
+        file << "time";
+        for (unsigned int i = 0; i < points.size(); ++i)
+          {
+            for (const auto &name : component_names)
+              {
+                file << ",probe" << i << "_" << name;
+              }
+          }
+        file << std::endl;
+      }
+  }
+
+  template <int dim, typename VectorType>
+  void Probes<dim, VectorType>::locate()
+  {
+    cell_points.clear();
+    const unsigned int this_rank =
+      Utilities::MPI::this_mpi_process(mpi_communicator);
+    MappingQ1<dim> mapping;
+    for (unsigned int i = 0; i < points.size(); ++i)
+      {
+        try
+          {
+            const auto cell_point = GridTools::find_active_cell_around_point(
+              mapping, dof_handler, points[i]);
+            if (cell_point.first->subdomain_id() == this_rank)
+              {
+                cell_points.emplace_back(cell_point.first, i);
+              }
+          }
+        catch (const GridTools::ExcPointNotFound<dim> &)
+          {
+            // The point is outside of the mesh, its values are 0.
+          }
+      }
+    located = true;
+  }
+
+  template <int dim, typename VectorType>
+  void Probes<dim, VectorType>::sample(const VectorType &fe_function,
+                                       const double time,
+                                       const bool flush)
+  {
+    if (!active())
+      return;
+    if (!located)
+      locate();
+    // The values of every point are followed by the number of processes
+    // that have found it.
+    const unsigned int n_components = dof_handler.get_fe().n_components();
+    const unsigned int n_entries = n_components + 1;
+    std::vector<double> values(points.size() * n_entries, 0.0);
+    for (const auto &cell_point : cell_points)
+      {
+        interpolator.evaluate(
+          cell_point.first, {points[cell_point.second]}, fe_function);
+        double *value = &values[cell_point.second * n_entries];
+        for (unsigned int c = 0; c < n_components; ++c)
+          {
+            value[c] = interpolator.value(0, c);
+          }
+        value[n_components] = 1;
+      }
+    Utilities::MPI::sum(values, mpi_communicator, values);
+    if (Utilities::MPI::this_mpi_process(mpi_communicator) != 0)
+      return;
+    std::ostringstream row;
+    row << time;
+    for (unsigned int i = 0; i < points.size(); ++i)
+      {
+        const double n_found = values[i * n_entries + n_components];
+        for (unsigned int c = 0; c < n_components; ++c)
+          {
+            row << ","
+                << (n_found > 0 ? values[i * n_entries + c] / n_found : 0.0);
+          }
+      }
+    row << '\n';
+    if (holding)
+      {
+        held_rows += row.str();
+        return;
+      }
+    file << row.str();
+    if (flush)
+      {
+        file.flush();
+      }
+  }
+
+  template <int dim, typename VectorType>
+  void Probes<dim, VectorType>::commit()
+  {
+    holding = false;
+    if (held_rows.empty())
+      return;
+    file << held_rows;
+    file.flush();
+    held_rows.clear();
+  }
+
+  template <int dim>
+  OutputRegion<dim>::OutputRegion(const std::vector<double> &box,
+                                  const std::vector<double> &plane)
+    : box(box), has_plane(!plane.empty())
+  {
+    AssertThrow(box.empty() || box.size() == 2 * dim,
+                ExcMessage("The output box needs a range per dimension!"));
+    AssertThrow(plane.empty() || plane.size() == 2 * dim,
+                ExcMessage("The output plane needs a point and a normal!"));
+    for (unsigned int i = 0; has_plane && i < dim; ++i)
+      {
+        plane_point[i] = plane[i];
+        plane_normal[i] = plane[dim + i];
+      }
+  }
+
+  template <int dim>
+  bool OutputRegion<dim>::contains(
+    const typename Triangulation<dim>::cell_iterator &cell) const
+  {
+    if (!box.empty())
+      {
+        for (unsigned int i = 0; i < dim; ++i)
+          {
+            double lower = cell->vertex(0)[i], upper = cell->vertex(0)[i];
+            for (unsigned int v = 1; v < GeometryInfo<dim>::vertices_per_cell;
+                 ++v)
+              {
+                lower = std::min(lower, cell->vertex(v)[i]);
+                upper = std::max(upper, cell->vertex(v)[i]);
+              }
+            if (upper < box[2 * i] || lower > box[2 * i + 1])
+              {
+                return false;
+              }
+          }
+      }
+    if (has_plane)
+      {
+        // The plane cuts the cell if there are vertices on both sides.
+        bool below = false, above = false;
+        for (unsigned int v = 0; v < GeometryInfo<dim>::vertices_per_cell; ++v)
+          {
+            const double distance =
+              (cell->vertex(v) - plane_point) * plane_normal;
+            below = below || distance <= 0;
+            above = above || distance >= 0;
+          }
+        return below && above;
+      }
+    return true;
+  }
+
+  template <int dim, typename MeshType>
+  CellTree<dim, MeshType>::CellTree(const MeshType &m)
+    : mesh(m), n_mesh_cells(0)
+  {
+  }
+
+  template <int dim, typename MeshType>
+  void CellTree<dim, MeshType>::cell_box(
+    const typename MeshType::active_cell_iterator &cell,
+    Point<dim> &lower,
+    Point<dim> &upper)
+  {
+    lower = cell->vertex(0);
+    upper = cell->vertex(0);
+    for (unsigned int v = 1; v < GeometryInfo<dim>::vertices_per_cell; ++v)
+      {
+        for (unsigned int d = 0; d < dim; ++d)
+          {
+            lower[d] = std::min(lower[d], cell->vertex(v)[d]);
+            upper[d] = std::max(upper[d], cell->vertex(v)[d]);
+          }
+      }
+  }
+
+  template <int dim, typename MeshType>
+  void CellTree<dim, MeshType>::rebuild()
+  {
+    cells.clear();
+    // The artificial cells of a distributed mesh are not moved with the
+    // locally relevant ones, so they must not hide them.
+    for (auto cell = mesh.begin_active(); cell != mesh.end(); ++cell)
+      {
+        if (!cell->is_artificial())
+          cells.push_back(cell);
+      }
+    n_mesh_cells = mesh.get_triangulation().n_active_cells();
+    cell_lower.resize(cells.size());
+    cell_upper.resize(cells.size());
+    for (unsigned int i = 0; i < cells.size(); ++i)
+      {
+        cell_box(cells[i], cell_lower[i], cell_upper[i]);
+      }
+    nodes.clear();
+    if (!cells.empty())
+      {
+        nodes.reserve(2 * cells.size() / leaf_size + 1);
+        build(0, cells.size());
+      }
+  }
+
+  template <int dim, typename MeshType>
+  int CellTree<dim, MeshType>::build(const unsigned int begin,
+                                     const unsigned int end)
+  {
+    const int index = nodes.size();
+    nodes.push_back(Node());
+    Node node;
+    node.children[0] = node.children[1] = -1;
+    node.begin = begin;
+    node.end = end;
+    node.lower = cell_lower[begin];
+    node.upper = cell_upper[begin];
+    Point<dim> center_lower, center_upper;
+    for (unsigned int i = begin; i < end; ++i)
+      {
+        Point<dim> center = (cell_lower[i] + cell_upper[i]) / 2;
+        for (unsigned int d = 0; d < dim; ++d)
+          {
+            node.lower[d] = std::min(node.lower[d], cell_lower[i][d]);
+            node.upper[d] = std::max(node.upper[d], cell_upper[i][d]);
+            center_lower[d] =
+              (i == begin) ? center[d] : std::min(center_lower[d], center[d]);
+            center_upper[d] =
+              (i == begin) ? center[d] : std::max(center_upper[d], center[d]);
+          }
+      }
+    if (end - begin > leaf_size)
+      {
+        // Split at the median along the longest extent of the cell centers
+        unsigned int axis = 0;
+        for (unsigned int d = 1; d < dim; ++d)
+          {
+            if (center_upper[d] - center_lower[d] >
+                center_upper[axis] - center_lower[axis])
+              axis = d;
+          }
+        const unsigned int middle = (begin + end) / 2;
+        std::vector<unsigned int> order(end - begin);
+        for (unsigned int i = 0; i < order.size(); ++i)
+          {
+            order[i] = begin + i;
+          }
+        std::nth_element(order.begin(),
+                         order.begin() + (middle - begin),
+                         order.end(),
+                         [&](unsigned int a, unsigned int b) {
+                           return cell_lower[a][axis] + cell_upper[a][axis] <
+                                  cell_lower[b][axis] + cell_upper[b][axis];
+                         });
+        // Apply the permutation to the cell arrays
+        std::vector<typename MeshType::active_cell_iterator> sorted_cells(
+          order.size());
+        std::vector<Point<dim>> sorted_lower(order.size()),
+          sorted_upper(order.size());
+        for (unsigned int i = 0; i < order.size(); ++i)
+          {
+            sorted_cells[i] = cells[order[i]];
+            sorted_lower[i] = cell_lower[order[i]];
+            sorted_upper[i] = cell_upper[order[i]];
+          }
+        std::copy(
+          sorted_cells.begin(), sorted_cells.end(), cells.begin() + begin);
+        std::copy(
+          sorted_lower.begin(), sorted_lower.end(), cell_lower.begin() + begin);
+        std::copy(
+          sorted_upper.begin(), sorted_upper.end(), cell_upper.begin() + begin);
+        node.children[0] = build(begin, middle);
+        node.children[1] = build(middle, end);
+      }
+    nodes[index] = node;
+    return index;
+  }
+
+  template <int dim, typename MeshType>
+  void CellTree<dim, MeshType>::refit()
+  {
+    if (nodes.empty() ||
+        n_mesh_cells != mesh.get_triangulation().n_active_cells())
+      {
+        rebuild();
+        return;
+      }
+    for (unsigned int i = 0; i < cells.size(); ++i)
+      {
+        cell_box(cells[i], cell_lower[i], cell_upper[i]);
+      }
+    // Children are always stored after their parents, so a reverse loop
+    // updates the children first.
+    for (int n = nodes.size() - 1; n >= 0; --n)
+      {
+        Node &node = nodes[n];
+        if (node.children[0] < 0)
+          {
+            node.lower = cell_lower[node.begin];
+            node.upper = cell_upper[node.begin];
+            for (unsigned int i = node.begin + 1; i < node.end; ++i)
+              {
+                for (unsigned int d = 0; d < dim; ++d)
+                  {
+                    node.lower[d] = std::min(node.lower[d], cell_lower[i][d]);
+                    node.upper[d] = std::max(node.upper[d], cell_upper[i][d]);
+                  }
+              }
+          }
+        else
+          {
+            const Node &left = nodes[node.children[0]];
+            const Node &right = nodes[node.children[1]];
+            for (unsigned int d = 0; d < dim; ++d)
+              {
+                node.lower[d] = std::min(left.lower[d], right.lower[d]);
+                node.upper[d] = std::max(left.upper[d], right.upper[d]);
+              }
+          }
+      }
+  }
+
+  template <int dim, typename MeshType>
+  void CellTree<dim, MeshType>::query(
+    const Point<dim> &point,
+    std::vector<typename MeshType::active_cell_iterator> &result) const
+  {
+    result.clear();
+    if (nodes.empty())
+      return;
+    auto contains = [&point](const Point<dim> &lower,
+                             const Point<dim> &upper) {
+      for (unsigned int d = 0; d < dim; ++d)
+        {
+          if (point[d] < lower[d] || point[d] > upper[d])
+            return false;
+        }
+      return true;
+    };
+    std::vector<int> stack(1, 0);
+    while (!stack.empty())
+      {
+        const Node &node = nodes[stack.back()];
+        stack.pop_back();
+        if (!contains(node.lower, node.upper))
+          continue;
+        if (node.children[0] < 0)
+          {
+            for (unsigned int i = node.begin; i < node.end; ++i)
+              {
+                if (contains(cell_lower[i], cell_upper[i]))
+                  result.push_back(cells[i]);
+              }
+          }
+        else
+          {
+            stack.push_back(node.children[0]);
+            stack.push_back(node.children[1]);
+          }
+      }
+  }
+
+  template <int dim, typename MeshType>
+  typename MeshType::active_cell_iterator
+  CellTree<dim, MeshType>::find_cell(const Point<dim> &point) const
+  {
+    std::vector<typename MeshType::active_cell_iterator> candidates;
+    query(point, candidates);
+    for (auto &cell : candidates)
+      {
+        if (cell->point_inside(point))
+          return cell;
+      }
+    // Return an invalid iterator
+    typename MeshType::active_cell_iterator invalid_itr;
+    return invalid_itr;
+  }
+
+  namespace
+  {
+    /// The side of a point relative to the edge from a to b, in the
+    /// projection onto the yz plane. The edge is evaluated from its smaller
+    /// vertex, so that the two triangles of an edge get the same value with
+    /// opposite signs. A point on the edge is moved by (0, e, e^2) for an
+    /// infinitely small e, 0 is only returned if the edge is a point.
+    double
+    edge_side(const Point<3> &a, const Point<3> &b, const Point<3> &p)
+    {
+      const bool swap = b[1] < a[1] || (b[1] == a[1] && b[2] < a[2]);
+      const Point<3> &u = swap ? b : a;
+      const Point<3> &v = swap ? a : b;
+      double side =
+        (v[1] - u[1]) * (p[2] - u[2]) - (v[2] - u[2]) * (p[1] - u[1]);
+      if (side == 0)
+        {
+          const double tie = (v[2] != u[2]) ? u[2] - v[2] : v[1] - u[1];
+          side = (tie > 0)   ? std::numeric_limits<double>::min()
+                 : (tie < 0) ? -std::numeric_limits<double>::min()
+                             : 0;
+        }
+      return swap ? -side : side;
+    }
+  } // namespace
+
+  void SurfaceTree::reinit(const std::vector<Point<3>> &input)
+  {
+    const unsigned int n_triangles = input.size() / 3;
+    if (nodes.empty() || order.size() != n_triangles)
+      {
+        order.resize(n_triangles);
+        for (unsigned int i = 0; i < n_triangles; ++i)
+          {
+            order[i] = i;
+          }
+        vertices = input;
+        triangle_lower.resize(n_triangles);
+        triangle_upper.resize(n_triangles);
+        nodes.clear();
+        refit();
+        if (n_triangles > 0)
+          {
+            nodes.reserve(2 * n_triangles / leaf_size + 1);
+            build(0, n_triangles);
+          }
+      }
+    // Store the vertices in the order of the leaves.
+    for (unsigned int i = 0; i < n_triangles; ++i)
+      {
+        for (unsigned int j = 0; j < 3; ++j)
+          {
+            vertices[3 * i + j] = input[3 * order[i] + j];
+          }
+      }
+    refit();
+  }
+
+  int SurfaceTree::build(const unsigned int begin, const unsigned int end)
+  {
+    const int index = nodes.size();
+    nodes.push_back(Node());
+    Node node;
+    node.children[0] = node.children[1] = -1;
+    node.begin = begin;
+    node.end = end;
+    Point<3> center_lower, center_upper;
+    for (unsigned int i = begin; i < end; ++i)
+      {
+        Point<3> center = (triangle_lower[i] + triangle_upper[i]) / 2;
+        for (unsigned int d = 0; d < 3; ++d)
+          {
+            center_lower[d] =
+              (i == begin) ? center[d] : std::min(center_lower[d], center[d]);
+            center_upper[d] =
+              (i == begin) ? center[d] : std::max(center_upper[d], center[d]);
+          }
+      }
+    if (end - begin > leaf_size)
+      {
+        // Split at the median along the longest extent of the centers
+        unsigned int axis = 0;
+        for (unsigned int d = 1; d < 3; ++d)
+          {
+            if (center_upper[d] - center_lower[d] >
+                center_upper[axis] - center_lower[axis])
+              axis = d;
+          }
+        const unsigned int middle = (begin + end) / 2;
+        std::vector<unsigned int> local(end - begin);
+        for (unsigned int i = 0; i < local.size(); ++i)
+          {
+            local[i] = begin + i;
+          }
+        std::nth_element(
+          local.begin(),
+          local.begin() + (middle - begin),
+          local.end(),
+          [&](unsigned int a, unsigned int b) {
+            return triangle_lower[a][axis] + triangle_upper[a][axis] <
+                   triangle_lower[b][axis] + triangle_upper[b][axis];
+          });
+        std::vector<unsigned int> sorted_order(local.size());
+        std::vector<Point<3>> sorted_lower(local.size()),
+          sorted_upper(local.size());
+        for (unsigned int i = 0; i < local.size(); ++i)
+          {
+            sorted_order[i] = order[local[i]];
+            sorted_lower[i] = triangle_lower[local[i]];
+            sorted_upper[i] = triangle_upper[local[i]];
+          }
+        std::copy(
+          sorted_order.begin(), sorted_order.end(), order.begin() + begin);
+        std::copy(sorted_lower.begin(),
+                  sorted_lower.end(),
+                  triangle_lower.begin() + begin);
+        std::copy(sorted_upper.begin(),
+                  sorted_upper.end(),
+                  triangle_upper.begin() + begin);
+        node.children[0] = build(begin, middle);
+        node.children[1] = build(middle, end);
+      }
+    nodes[index] = node;
+    return index;
+  }
+
+  void SurfaceTree::refit()
+  {
+    for (unsigned int i = 0; i < triangle_lower.size(); ++i)
+      {
+        triangle_lower[i] = vertices[3 * i];
+        triangle_upper[i] = vertices[3 * i];
+        for (unsigned int j = 1; j < 3; ++j)
+          {
+            for (unsigned int d = 0; d < 3; ++d)
+              {
+                triangle_lower[i][d] =
+                  std::min(triangle_lower[i][d], vertices[3 * i + j][d]);
+                triangle_upper[i][d] =
+                  std::max(triangle_upper[i][d], vertices[3 * i + j][d]);
+              }
+          }
+      }
+    // Children are always stored after their parents.
+    for (int n = nodes.size() - 1; n >= 0; --n)
+      {
+        Node &node = nodes[n];
+        if (node.children[0] < 0)
+          {
+            node.lower = triangle_lower[node.begin];
+            node.upper = triangle_upper[node.begin];
+            for (unsigned int i = node.begin + 1; i < node.end; ++i)
+              {
+                for (unsigned int d = 0; d < 3; ++d)
+                  {
+                    node.lower[d] =
+                      std::min(node.lower[d], triangle_lower[i][d]);
+                    node.upper[d] =
+                      std::max(node.upper[d], triangle_upper[i][d]);
+                  }
+              }
+          }
+        else
+          {
+            const Node &left = nodes[node.children[0]];
+            const Node &right = nodes[node.children[1]];
+            for (unsigned int d = 0; d < 3; ++d)
+              {
+                node.lower[d] = std::min(left.lower[d], right.lower[d]);
+                node.upper[d] = std::max(left.upper[d], right.upper[d]);
+              }
+          }
+      }
+  }
+
+  bool SurfaceTree::contains(const Point<3> &point,
+                             std::vector<int> &stack) const
+  {
+    if (nodes.empty())
+      return false;
+    unsigned int crossings = 0;
+    stack.assign(1, 0);
+    while (!stack.empty())
+      {
+        const Node &node = nodes[stack.back()];
+        stack.pop_back();
+        // The ray only goes through the boxes that contain the projection
+        // of the point and end to the right of it.
+        if (node.upper[0] < point[0] || point[1] < node.lower[1] ||
+            point[1] > node.upper[1] || point[2] < node.lower[2] ||
+            point[2] > node.upper[2])
+          continue;
+        if (node.children[0] >= 0)
+          {
+            stack.push_back(node.children[0]);
+            stack.push_back(node.children[1]);
+            continue;
+          }
+        for (unsigned int t = node.begin; t < node.end; ++t)
+          {
+            const Point<3> &a = vertices[3 * t];
+            const Point<3> &b = vertices[3 * t + 1];
+            const Point<3> &c = vertices[3 * t + 2];
+            // The barycentric weights of the projection of the point, which
+            // all have the same sign if it is in the projected triangle.
+            const double wa = edge_side(b, c, point);
+            const double wb = edge_side(c, a, point);
+            const double wc = edge_side(a, b, point);
+            if (!((wa > 0 && wb > 0 && wc > 0) ||
+                  (wa < 0 && wb < 0 && wc < 0)))
+              continue;
+            const double x =
+              (wa * a[0] + wb * b[0] + wc * c[0]) / (wa + wb + wc);
+            if (x == point[0])
+              return true;
+            if (x > point[0])
+              ++crossings;
+          }
+      }
+    return crossings % 2 == 1;
+  }
+
+  bool SurfaceTree::inside(const Point<3> &point) const
+  {
+    std::vector<int> stack;
+    return contains(point, stack);
+  }
+
+  void SurfaceTree::inside(const std::vector<Point<3>> &points,
+                           std::vector<int> &result) const
+  {
+    result.resize(points.size());
+    std::vector<int> stack;
+    for (unsigned int i = 0; i < points.size(); ++i)
+      {
+        result[i] = contains(points[i], stack);
+      }
+  }
+
+  template <int dim, typename MeshType>
+  CellLinkedList<dim, MeshType>::CellLinkedList(const MeshType &m)
+    : mesh(m), bin_size(0)
+  {
+  }
+
+  template <int dim, typename MeshType>
+  void CellLinkedList<dim, MeshType>::rebuild()
+  {
+    cells.clear();
+    Point<dim> upper;
+    double max_radius = 0;
+    for (auto cell = mesh.begin_active(); cell != mesh.end(); ++cell)
+      {
+        if (!cell->is_locally_owned())
+          continue;
+        const Point<dim> center = cell->center();
+        if (cells.empty())
+          {
+            lower = center;
+            upper = center;
+          }
+        for (unsigned int d = 0; d < dim; ++d)
+          {
+            lower[d] = std::min(lower[d], center[d]);
+            upper[d] = std::max(upper[d], center[d]);
+          }
+        // The cubic spline vanishes beyond 2h
+        max_radius = std::max(max_radius, 2 * cell->diameter());
+        cells.push_back(cell);
+      }
+    head.clear();
+    next.assign(cells.size(), -1);
+    if (cells.empty())
+      return;
+
+    // Bins smaller than the support do not help, and there should not be
+    // many more bins than cells.
+    bin_size = max_radius;
+    double volume = 1;
+    for (unsigned int d = 0; d < dim; ++d)
+      {
+        volume *= (upper[d] - lower[d] + bin_size);
+      }
+    const double min_bin_size = std::pow(volume / cells.size(), 1.0 / dim);
+    bin_size = std::max(bin_size, min_bin_size);
+    unsigned int total_bins = 1;
+    for (unsigned int d = 0; d < dim; ++d)
+      {
+        n_bins[d] = static_cast<int>((upper[d] - lower[d]) / bin_size) + 1;
+        total_bins *= n_bins[d];
+      }
+
+    head.assign(total_bins, -1);
+    for (unsigned int i = 0; i < cells.size(); ++i)
+      {
+        const auto index = bin_index(cells[i]->center());
+        int bin = 0;
+        for (int d = dim - 1; d >= 0; --d)
+          {
+            bin = bin * n_bins[d] + index[d];
+          }
+        next[i] = head[bin];
+        head[bin] = i;
+      }
+  }
+
+  template <int dim, typename MeshType>
+  std::array<int, dim>
+  CellLinkedList<dim, MeshType>::bin_index(const Point<dim> &point) const
+  {
+    std::array<int, dim> index;
+    for (unsigned int d = 0; d < dim; ++d)
+      {
+        const int i =
+          static_cast<int>(std::floor((point[d] - lower[d]) / bin_size));
+        index[d] = std::min(std::max(i, 0), n_bins[d] - 1);
+      }
+    return index;
+  }
+
+  template <int dim, typename MeshType>
+  void CellLinkedList<dim, MeshType>::query(
+    const Point<dim> &point,
+    std::vector<typename MeshType::active_cell_iterator> &result) const
+  {
+    result.clear();
+    if (cells.empty())
+      return;
+    // A point far outside of the grid has no neighbors
+    for (unsigned int d = 0; d < dim; ++d)
+      {
+        if (point[d] < lower[d] - bin_size ||
+            point[d] > lower[d] + (n_bins[d] + 1) * bin_size)
+          return;
+      }
+    const auto center = bin_index(point);
+    std::array<int, dim> begin, end;
+    for (unsigned int d = 0; d < dim; ++d)
+      {
+        begin[d] = std::max(center[d] - 1, 0);
+        end[d] = std::min(center[d] + 1, n_bins[d] - 1);
+      }
+    std::array<int, dim> index = begin;
+    while (true)
+      {
+        int bin = 0;
+        for (int d = dim - 1; d >= 0; --d)
+          {
+            bin = bin * n_bins[d] + index[d];
+          }
+        for (int i = head[bin]; i >= 0; i = next[i])
+          {
+            result.push_back(cells[i]);
+          }
+        // Advance to the next bin of the 3^dim block
+        unsigned int d = 0;
+        for (; d < dim; ++d)
+          {
+            if (++index[d] <= end[d])
+              break;
+            index[d] = begin[d];
+          }
+        if (d == dim)
+          break;
+      }
+  }
+
+  template <int dim, typename MeshType>
+  CellLocator<dim, MeshType>::CellLocator(DoFHandler<dim> &dh,
+                                          const unsigned int max_depth)
+    : dof_handler(dh),
+      max_depth(max_depth),
+      cell_found(true),
+      search_id(0),
+      tree(nullptr)
+  {
+  }
+
+  template <int dim, typename MeshType>
+  const typename MeshType::active_cell_iterator
+  CellLocator<dim, MeshType>::global_search(const Point<dim> &point)
+  {
+    if (tree && !tree->empty())
+      {
+        auto cell = tree->find_cell(point);
+        cell_found = (cell.state() == IteratorState::valid);
+        return cell;
+      }
+    MappingQ1<dim> mapping;
+    try
+      {
+        return (GridTools::find_active_cell_around_point(
+                  mapping, dof_handler, point))
+          .first;
+      }
+    catch (GridTools::ExcPointNotFound<dim> &e)
+      {
+        cell_found = false;
+        // Return an invalid iterator
+        typename MeshType::active_cell_iterator invalid_itr;
+        return invalid_itr;
+      }
+  }
+
+  template <int dim, typename MeshType>
+  const typename MeshType::active_cell_iterator
+  CellLocator<dim, MeshType>::search(
+    const Point<dim> &point,
+    const typename MeshType::active_cell_iterator &hint)
+  {
+    cell_found = true;
+    // If the hint is the begin iterator we do not use BFS.
+    if (hint == dof_handler.begin_active() ||
+        hint.state() != IteratorState::valid)
+      {
+        return global_search(point);
+      }
+    // The mesh might have been changed since last search.
+    if (visited.size() != dof_handler.get_triangulation().n_active_cells())
+      {
+        visited.assign(dof_handler.get_triangulation().n_active_cells(), 0);
+        search_id = 0;
+      }
+    // Restart the ids when they overflow
+    if (++search_id == 0)
+      {
+        std::fill(visited.begin(), visited.end(), 0);
+        search_id = 1;
+      }
+    current_layer.clear();
+    // Start with the hint cell
+    current_layer.push_back(hint);
+    visited[hint->active_cell_index()] = search_id;
+    for (unsigned int depth = 0; depth <= max_depth && !current_layer.empty();
+         ++depth)
+      {
+        next_layer.clear();
+        for (auto &current_cell : current_layer)
+          {
+            // If the point is inside current cell then we are done.
+            if (current_cell->point_inside(point))
+              {
+                return current_cell;
+              }
+            // Get all the active neighbors!
+            GridTools::get_active_neighbors<MeshType>(current_cell, neighbors);
+            for (auto &neighbor : neighbors)
+              {
+                // Push all the unflagged cells into the next layer
+                if (visited[neighbor->active_cell_index()] != search_id)
+                  {
+                    visited[neighbor->active_cell_index()] = search_id;
+                    next_layer.push_back(neighbor);
+                  }
+              }
+          }
+        current_layer.swap(next_layer);
+      }
+    // The point is either far from the hint or not in the mesh at all.
+    if (!current_layer.empty())
+      {
+        return global_search(point);
+      }
+    // If the whole mesh is visited, we failed in finding the cell
+    cell_found = false;
+    // Return an invalid iterator
+    typename MeshType::active_cell_iterator invalid_itr;
+    return invalid_itr;
+  }
+
+  // Written by Davis Wells on dealii mailing list.
+  template <int dim>
+  void GridCreator<dim>::flow_around_cylinder_2d(Triangulation<2> &tria,
+                                                 bool compute_in_2d)
+  {
+    double left = compute_in_2d ? 0.0 : -0.3;
+
+    // set up the bulk triangulation
+    Triangulation<2> bulk_triangulation;
+    GridGenerator::subdivided_hyper_rectangle(bulk_triangulation,
+                                              {compute_in_2d ? 22u : 25u, 4u},
+                                              Point<2>(left, 0.0),
+                                              Point<2>(2.2, 0.41));
+    std::set<Triangulation<2>::active_cell_iterator> cells_to_remove;
+    Tensor<1, 2> cylinder_triangulation_offset;
+    for (const auto cell : bulk_triangulation.active_cell_iterators())
+      {
+        if ((cell->center() - Point<2>(0.2, 0.2)).norm() < 0.15)
+          cells_to_remove.insert(cell);
+
+        if (cylinder_triangulation_offset == Point<2>())
+          {
+            for (unsigned int vertex_n = 0;
+                 vertex_n < GeometryInfo<2>::vertices_per_cell;
+                 ++vertex_n)
+              if (cell->vertex(vertex_n) == Point<2>(left, 0.0))
+                {
+                  // skip two cells in the bottom left corner
+                  cylinder_triangulation_offset =
+                    2.0 * (cell->vertex(3) - Point<2>(left, 0.0));
+                  break;
+                }
+          }
+      }
+    Triangulation<2> result_1;
+    GridGenerator::create_triangulation_with_removed_cells(
+      bulk_triangulation, cells_to_remove, result_1);
+
+    // set up the cylinder triangulation
+    Triangulation<2> cylinder_triangulation;
+    GridGenerator::hyper_cube_with_cylindrical_hole(
+      cylinder_triangulation, 0.05, 0.41 / 4.0);
+    GridTools::shift(cylinder_triangulation_offset, cylinder_triangulation);
+    // dumb hack
+    for (const auto cell : cylinder_triangulation.active_cell_iterators())
+      cell->set_material_id(2);
 
     // merge them together
     auto minimal_line_length = [](const Triangulation<2> &tria) -> double {
@@ -397,84 +2291,270 @@ namespace Utils
           }
       }
 
+    set_cylinder_hole_manifolds(tria);
+
+    std::vector<Point<2> *> inner_pointers;
+    for (const auto cell : tria.active_cell_iterators())
+      {
+
+        for (unsigned int face_n = 0; face_n < GeometryInfo<2>::faces_per_cell;
+             ++face_n)
+          {
+
+            if (cell->face(face_n)->manifold_id() == polar_id)
+              {
+                inner_pointers.push_back(&cell->face(face_n)->vertex(0));
+                inner_pointers.push_back(&cell->face(face_n)->vertex(1));
+              }
+          }
+      }
+    // de-duplicate
+    std::sort(inner_pointers.begin(), inner_pointers.end());
+    inner_pointers.erase(
+      std::unique(inner_pointers.begin(), inner_pointers.end()),
+      inner_pointers.end());
+
+    // find the current center...
+    Point<2> center;
+    for (const Point<2> *const ptr : inner_pointers)
+      center += *ptr / double(inner_pointers.size());
+
+    // and recenter at (0.2, 0.2)
+    for (Point<2> *const ptr : inner_pointers)
+      *ptr += Point<2>(0.2, 0.2) - center;
+
+    Point<2> center2;
+    for (const Point<2> *const ptr : inner_pointers)
+      center2 += *ptr / double(inner_pointers.size());
+  }
+
+  template <int dim>
+  void GridCreator<dim>::set_cylinder_hole_manifolds(Triangulation<2> &tria)
+  {
+    // The manifold ids are set by flow_around_cylinder_2d.
+    const types::manifold_id tfi_id = 1;
+    const types::manifold_id polar_id = 0;
     PolarManifold<2> polar_manifold(Point<2>(0.2, 0.2));
     tria.set_manifold(polar_id, polar_manifold);
     TransfiniteInterpolationManifold<2> inner_manifold;
     inner_manifold.initialize(tria);
     tria.set_manifold(tfi_id, inner_manifold);
+  }
+
+  template <int dim>
+  bool GridCreator<dim>::create_on_root(
+    Triangulation<dim> &tria,
+    const std::function<void(Triangulation<dim> &)> &generator)
+  {
+    const auto *parallel_tria =
+      dynamic_cast<const parallel::Triangulation<dim> *>(&tria);
+    if (parallel_tria == nullptr)
+      {
+        generator(tria);
+        return false;
+      }
+    const MPI_Comm communicator = parallel_tria->get_communicator();
+    const unsigned int n_cell_entries =
+      GeometryInfo<dim>::vertices_per_cell + 2;
+    const unsigned int n_face_entries =
+      GeometryInfo<dim>::vertices_per_face + 2;
+    // Every cell is stored as its vertices, material id and manifold id,
+    // every face and line as its vertices, boundary id and manifold id.
+    // Only the faces and lines at the boundary or on a manifold are stored.
+    std::vector<double> vertex_data;
+    std::vector<unsigned int> cell_data, face_data, line_data;
+    if (Utilities::MPI::this_mpi_process(communicator) == 0)
+      {
+        Triangulation<dim> coarse_tria;
+        generator(coarse_tria);
+        // Leave out the vertices that are not used any more.
+        const std::vector<bool> &used = coarse_tria.get_used_vertices();
+        std::vector<unsigned int> new_index(used.size(),
+                                            numbers::invalid_unsigned_int);
+        for (unsigned int v = 0, n = 0; v < used.size(); ++v)
+          {
+            if (!used[v])
+              continue;
+            new_index[v] = n++;
+            for (unsigned int d = 0; d < dim; ++d)
+              {
+                vertex_data.push_back(coarse_tria.get_vertices()[v][d]);
+              }
+          }
+        auto boundary_id = [](const auto &object) {
+          return object->at_boundary() ? object->boundary_id()
+                                       : numbers::internal_face_boundary_id;
+        };
+        std::set<unsigned int> faces_touched, lines_touched;
+        for (auto cell = coarse_tria.begin_active(); cell != coarse_tria.end();
+             ++cell)
+          {
+            for (unsigned int v = 0; v < GeometryInfo<dim>::vertices_per_cell;
+                 ++v)
+              {
+                cell_data.push_back(new_index[cell->vertex_index(v)]);
+              }
+            cell_data.push_back(cell->material_id());
+            cell_data.push_back(cell->manifold_id());
+            // In 2D the faces are the lines, they are stored as faces.
+            for (unsigned int f = 0; f < GeometryInfo<dim>::faces_per_cell;
+                 ++f)
+              {
+                const auto face = cell->face(f);
+                if ((!face->at_boundary() &&
+                     face->manifold_id() == numbers::flat_manifold_id) ||
+                    !faces_touched.insert(face->index()).second)
+                  continue;
+                for (unsigned int v = 0;
+                     v < GeometryInfo<dim>::vertices_per_face;
+                     ++v)
+                  {
+                    face_data.push_back(new_index[face->vertex_index(v)]);
+                  }
+                face_data.push_back(boundary_id(face));
+                face_data.push_back(face->manifold_id());
+              }
+            for (unsigned int l = 0;
+                 l < GeometryInfo<dim>::lines_per_cell && dim == 3;
+                 ++l)
+              {
+                const auto line = cell->line(l);
+                if ((!line->at_boundary() &&
+                     line->manifold_id() == numbers::flat_manifold_id) ||
+                    !lines_touched.insert(line->index()).second)
+                  continue;
+                line_data.push_back(new_index[line->vertex_index(0)]);
+                line_data.push_back(new_index[line->vertex_index(1)]);
+                line_data.push_back(boundary_id(line));
+                line_data.push_back(line->manifold_id());
+              }
+          }
+      }
 
-    std::vector<Point<2> *> inner_pointers;
-    for (const auto cell : tria.active_cell_iterators())
+    // Broadcast the sizes first, then the arrays.
+    std::array<unsigned int, 4> sizes;
+    sizes[0] = vertex_data.size();
+    sizes[1] = cell_data.size();
+    sizes[2] = face_data.size();
+    sizes[3] = line_data.size();
+    int ierr = MPI_Bcast(sizes.data(), 4, MPI_UNSIGNED, 0, communicator);
+    AssertThrowMPI(ierr);
+    vertex_data.resize(sizes[0]);
+    cell_data.resize(sizes[1]);
+    face_data.resize(sizes[2]);
+    line_data.resize(sizes[3]);
+    ierr = MPI_Bcast(
+      vertex_data.data(), sizes[0], MPI_DOUBLE, 0, communicator);
+    AssertThrowMPI(ierr);
+    for (auto data : {&cell_data, &face_data, &line_data})
       {
+        ierr = MPI_Bcast(
+          data->data(), data->size(), MPI_UNSIGNED, 0, communicator);
+        AssertThrowMPI(ierr);
+      }
 
-        for (unsigned int face_n = 0; face_n < GeometryInfo<2>::faces_per_cell;
-             ++face_n)
+    std::vector<Point<dim>> vertices(vertex_data.size() / dim);
+    for (unsigned int v = 0; v < vertices.size(); ++v)
+      {
+        for (unsigned int d = 0; d < dim; ++d)
           {
-
-            if (cell->face(face_n)->manifold_id() == polar_id)
+            vertices[v][d] = vertex_data[v * dim + d];
+          }
+      }
+    std::vector<CellData<dim>> cells(cell_data.size() / n_cell_entries);
+    for (unsigned int c = 0; c < cells.size(); ++c)
+      {
+        const unsigned int *entry = &cell_data[c * n_cell_entries];
+        for (unsigned int v = 0; v < GeometryInfo<dim>::vertices_per_cell; ++v)
+          {
+            cells[c].vertices[v] = entry[v];
+          }
+        cells[c].material_id = entry[GeometryInfo<dim>::vertices_per_cell];
+        cells[c].manifold_id = entry[GeometryInfo<dim>::vertices_per_cell + 1];
+      }
+    SubCellData subcell_data;
+    for (unsigned int k = 0; k < face_data.size() / n_face_entries; ++k)
+      {
+        const unsigned int *entry = &face_data[k * n_face_entries];
+        if (dim == 2)
+          {
+            CellData<1> line;
+            line.vertices[0] = entry[0];
+            line.vertices[1] = entry[1];
+            line.boundary_id = entry[2];
+            line.manifold_id = entry[3];
+            subcell_data.boundary_lines.push_back(line);
+          }
+        else
+          {
+            CellData<2> quad;
+            for (unsigned int v = 0; v < 4; ++v)
               {
-                inner_pointers.push_back(&cell->face(face_n)->vertex(0));
-                inner_pointers.push_back(&cell->face(face_n)->vertex(1));
+                quad.vertices[v] = entry[v];
               }
+            quad.boundary_id = entry[4];
+            quad.manifold_id = entry[5];
+            subcell_data.boundary_quads.push_back(quad);
           }
       }
-    // de-duplicate
-    std::sort(inner_pointers.begin(), inner_pointers.end());
-    inner_pointers.erase(
-      std::unique(inner_pointers.begin(), inner_pointers.end()),
-      inner_pointers.end());
-
-    // find the current center...
-    Point<2> center;
-    for (const Point<2> *const ptr : inner_pointers)
-      center += *ptr / double(inner_pointers.size());
-
-    // and recenter at (0.2, 0.2)
-    for (Point<2> *const ptr : inner_pointers)
-      *ptr += Point<2>(0.2, 0.2) - center;
-
-    Point<2> center2;
-    for (const Point<2> *const ptr : inner_pointers)
-      center2 += *ptr / double(inner_pointers.size());
+    for (unsigned int k = 0; k < line_data.size() / 4; ++k)
+      {
+        CellData<1> line;
+        line.vertices[0] = line_data[4 * k];
+        line.vertices[1] = line_data[4 * k + 1];
+        line.boundary_id = line_data[4 * k + 2];
+        line.manifold_id = line_data[4 * k + 3];
+        subcell_data.boundary_lines.push_back(line);
+      }
+    tria.create_triangulation(vertices, cells, subcell_data);
+    return true;
   }
 
   // Create 2D triangulation:
   template <>
   void GridCreator<2>::flow_around_cylinder(Triangulation<2> &tria)
   {
-    flow_around_cylinder_2d(tria);
-    // Set the left boundary (inflow) to 0, the right boundary (outflow) to 1,
-    // upper to 2, lower to 3 and the cylindrical surface to 4.
-    for (Triangulation<2>::active_cell_iterator cell = tria.begin();
-         cell != tria.end();
-         ++cell)
+    auto generator = [](Triangulation<2> &coarse_tria) {
+      flow_around_cylinder_2d(coarse_tria);
+      // Set the left boundary (inflow) to 0, the right boundary (outflow) to
+      // 1, upper to 2, lower to 3 and the cylindrical surface to 4.
+      for (Triangulation<2>::active_cell_iterator cell =
+             coarse_tria.begin_active();
+           cell != coarse_tria.end();
+           ++cell)
+        {
+          for (unsigned int f = 0; f < GeometryInfo<2>::faces_per_cell; ++f)
+            {
+              if (cell->face(f)->at_boundary())
+                {
+                  if (std::abs(cell->face(f)->center()[0] - 2.2) < 1e-12)
+                    {
+                      cell->face(f)->set_all_boundary_ids(1);
+                    }
+                  else if (std::abs(cell->face(f)->center()[0] - 0.0) < 1e-12)
+                    {
+                      cell->face(f)->set_all_boundary_ids(0);
+                    }
+                  else if (std::abs(cell->face(f)->center()[1] - 0.41) <
+                           1e-12)
+                    {
+                      cell->face(f)->set_all_boundary_ids(3);
+                    }
+                  else if (std::abs(cell->face(f)->center()[1]) < 1e-12)
+                    {
+                      cell->face(f)->set_all_boundary_ids(2);
+                    }
+                  else
+                    {
+                      cell->face(f)->set_all_boundary_ids(4);
+                    }
+                }
+            }
+        }
+    };
+    if (create_on_root(tria, generator))
       {
-        for (unsigned int f = 0; f < GeometryInfo<2>::faces_per_cell; ++f)
-          {
-            if (cell->face(f)->at_boundary())
-              {
-                if (std::abs(cell->face(f)->center()[0] - 2.2) < 1e-12)
-                  {
-                    cell->face(f)->set_all_boundary_ids(1);
-                  }
-                else if (std::abs(cell->face(f)->center()[0] - 0.0) < 1e-12)
-                  {
-                    cell->face(f)->set_all_boundary_ids(0);
-                  }
-                else if (std::abs(cell->face(f)->center()[1] - 0.41) < 1e-12)
-                  {
-                    cell->face(f)->set_all_boundary_ids(3);
-                  }
-                else if (std::abs(cell->face(f)->center()[1]) < 1e-12)
-                  {
-                    cell->face(f)->set_all_boundary_ids(2);
-                  }
-                else
-                  {
-                    cell->face(f)->set_all_boundary_ids(4);
-                  }
-              }
-          }
+        set_cylinder_hole_manifolds(tria);
       }
   }
 
@@ -482,50 +2562,57 @@ namespace Utils
   template <>
   void GridCreator<3>::flow_around_cylinder(Triangulation<3> &tria)
   {
-    Triangulation<2> tria_2d;
-    flow_around_cylinder_2d(tria_2d, false);
-    GridGenerator::extrude_triangulation(tria_2d, 9, 0.41, tria);
-    // Set boundaries in x direction to 0 and 1; y direction to 2 and 3;
-    // z direction to 4 and 5; the cylindrical surface 6.
-    for (Triangulation<3>::active_cell_iterator cell = tria.begin();
-         cell != tria.end();
-         ++cell)
-      {
-        for (unsigned int f = 0; f < GeometryInfo<3>::faces_per_cell; ++f)
-          {
-            if (cell->face(f)->at_boundary())
-              {
-                if (std::abs(cell->face(f)->center()[0] - 2.2) < 1e-12)
-                  {
-                    cell->face(f)->set_all_boundary_ids(1);
-                  }
-                else if (std::abs(cell->face(f)->center()[0] + 0.3) < 1e-12)
-                  {
-                    cell->face(f)->set_all_boundary_ids(0);
-                  }
-                else if (std::abs(cell->face(f)->center()[1] - 0.41) < 1e-12)
-                  {
-                    cell->face(f)->set_all_boundary_ids(3);
-                  }
-                else if (std::abs(cell->face(f)->center()[1]) < 1e-12)
-                  {
-                    cell->face(f)->set_all_boundary_ids(2);
-                  }
-                else if (std::abs(cell->face(f)->center()[2] - 0.41) < 1e-12)
-                  {
-                    cell->face(f)->set_all_boundary_ids(5);
-                  }
-                else if (std::abs(cell->face(f)->center()[2]) < 1e-12)
-                  {
-                    cell->face(f)->set_all_boundary_ids(4);
-                  }
-                else
-                  {
-                    cell->face(f)->set_all_boundary_ids(6);
-                  }
-              }
-          }
-      }
+    auto generator = [](Triangulation<3> &coarse_tria) {
+      Triangulation<2> tria_2d;
+      flow_around_cylinder_2d(tria_2d, false);
+      GridGenerator::extrude_triangulation(tria_2d, 9, 0.41, coarse_tria);
+      // Set boundaries in x direction to 0 and 1; y direction to 2 and 3;
+      // z direction to 4 and 5; the cylindrical surface 6.
+      for (Triangulation<3>::active_cell_iterator cell =
+             coarse_tria.begin_active();
+           cell != coarse_tria.end();
+           ++cell)
+        {
+          for (unsigned int f = 0; f < GeometryInfo<3>::faces_per_cell; ++f)
+            {
+              if (cell->face(f)->at_boundary())
+                {
+                  if (std::abs(cell->face(f)->center()[0] - 2.2) < 1e-12)
+                    {
+                      cell->face(f)->set_all_boundary_ids(1);
+                    }
+                  else if (std::abs(cell->face(f)->center()[0] + 0.3) < 1e-12)
+                    {
+                      cell->face(f)->set_all_boundary_ids(0);
+                    }
+                  else if (std::abs(cell->face(f)->center()[1] - 0.41) <
+                           1e-12)
+                    {
+                      cell->face(f)->set_all_boundary_ids(3);
+                    }
+                  else if (std::abs(cell->face(f)->center()[1]) < 1e-12)
+                    {
+                      cell->face(f)->set_all_boundary_ids(2);
+                    }
+                  else if (std::abs(cell->face(f)->center()[2] - 0.41) <
+                           1e-12)
+                    {
+                      cell->face(f)->set_all_boundary_ids(5);
+                    }
+                  else if (std::abs(cell->face(f)->center()[2]) < 1e-12)
+                    {
+                      cell->face(f)->set_all_boundary_ids(4);
+                    }
+                  else
+                    {
+                      cell->face(f)->set_all_boundary_ids(6);
+                    }
+                }
+            }
+        }
+    };
+    // The extruded mesh has no manifolds.
+    create_on_root(tria, generator);
   }
 
   template <int dim>
@@ -535,9 +2622,11 @@ namespace Utils
   {
     SphericalManifold<dim> spherical_manifold(center);
     TransfiniteInterpolationManifold<dim> inner_manifold;
-    GridGenerator::hyper_ball(tria, center, radius);
-    tria.set_all_manifold_ids(1);
-    tria.set_all_manifold_ids_on_boundary(0);
+    create_on_root(tria, [&center, radius](Triangulation<dim> &coarse_tria) {
+      GridGenerator::hyper_ball(coarse_tria, center, radius);
+      coarse_tria.set_all_manifold_ids(1);
+      coarse_tria.set_all_manifold_ids_on_boundary(0);
+    });
     tria.set_manifold(0, spherical_manifold);
     inner_manifold.initialize(tria);
     tria.set_manifold(1, inner_manifold);
@@ -559,32 +2648,518 @@ namespace Utils
                                 const double radius,
                                 const double length)
   {
-    Triangulation<2> tria2d;
-    Point<2> center(0, 0);
-    GridCreator<2>::sphere(tria2d, center, radius);
-    GridGenerator::extrude_triangulation(
-      tria2d, static_cast<unsigned int>(length / (4 * radius)), length, tria);
-    tria.set_all_manifold_ids_on_boundary(0);
-    for (auto cell = tria.begin(); cell != tria.end(); ++cell)
+    auto generator = [radius, length](Triangulation<3> &coarse_tria) {
+      Triangulation<2> tria2d;
+      Point<2> center(0, 0);
+      GridCreator<2>::sphere(tria2d, center, radius);
+      GridGenerator::extrude_triangulation(
+        tria2d,
+        static_cast<unsigned int>(length / (4 * radius)),
+        length,
+        coarse_tria);
+      coarse_tria.set_all_manifold_ids_on_boundary(0);
+      for (auto cell = coarse_tria.begin(); cell != coarse_tria.end(); ++cell)
+        {
+          for (unsigned int i = 0; i < GeometryInfo<3>::faces_per_cell; ++i)
+            {
+              if (cell->at_boundary(i))
+                {
+                  if (std::abs(cell->face(i)->center()(2)) < 1e-10)
+                    {
+                      cell->face(i)->set_boundary_id(1);
+                      cell->face(i)->set_manifold_id(
+                        numbers::flat_manifold_id);
+                    }
+                  else if (std::abs(cell->face(i)->center()(2) - length) <
+                           1e-10)
+                    {
+                      cell->face(i)->set_boundary_id(2);
+                      cell->face(i)->set_manifold_id(
+                        numbers::flat_manifold_id);
+                    }
+                }
+            }
+        }
+    };
+    create_on_root(tria, generator);
+    tria.set_manifold(0, CylindricalManifold<3>(2));
+  }
+
+  template <int dim>
+  AssemblyScratch<dim>::AssemblyScratch(const FiniteElement<dim> &fe,
+                                        const Quadrature<dim> &quad,
+                                        const UpdateFlags flags,
+                                        const Quadrature<dim - 1> &face_quad,
+                                        const UpdateFlags face_flags)
+    : fe_values(fe, quad, flags), fe_face_values(fe, face_quad, face_flags)
+  {
+    resize();
+  }
+
+  template <int dim>
+  AssemblyScratch<dim>::AssemblyScratch(const AssemblyScratch &scratch)
+    : fe_values(scratch.fe_values.get_fe(),
+                scratch.fe_values.get_quadrature(),
+                scratch.fe_values.get_update_flags()),
+      fe_face_values(scratch.fe_face_values.get_fe(),
+                     scratch.fe_face_values.get_quadrature(),
+                     scratch.fe_face_values.get_update_flags())
+  {
+    resize();
+  }
+
+  template <int dim>
+  void AssemblyScratch<dim>::resize()
+  {
+    const unsigned int dofs_per_cell = fe_values.get_fe().dofs_per_cell;
+    const unsigned int n_q_points = fe_values.n_quadrature_points;
+    phi_u.resize(dofs_per_cell);
+    grad_phi_u.resize(dofs_per_cell);
+    symmetric_grad_phi_u.resize(dofs_per_cell);
+    div_phi_u.resize(dofs_per_cell);
+    phi_p.resize(dofs_per_cell);
+    grad_phi_p.resize(dofs_per_cell);
+    w_grad_phi_u.resize(dofs_per_cell);
+    w_grad_phi_p.resize(dofs_per_cell);
+    phi_u_grad_p.resize(dofs_per_cell);
+    convection_phi_u.resize(dofs_per_cell);
+    supg_phi_u.resize(dofs_per_cell);
+    current_velocity_values.resize(n_q_points);
+    current_velocity_gradients.resize(n_q_points);
+    current_velocity_divergences.resize(n_q_points);
+    current_pressure_values.resize(n_q_points);
+    current_pressure_gradients.resize(n_q_points);
+    present_velocity_values.resize(n_q_points);
+    present_pressure_values.resize(n_q_points);
+  }
+
+  void GhostUpdate::start(PETScWrappers::MPI::BlockVector &ghosted,
+                          const PETScWrappers::MPI::BlockVector &owned)
+  {
+    finish();
+    Assert(ghosted.has_ghost_elements(),
+           ExcMessage("The target of a ghost update must be ghosted!"));
+    for (unsigned int b = 0; b < ghosted.n_blocks(); ++b)
+      {
+        PetscErrorCode ierr = VecCopy(owned.block(b), ghosted.block(b));
+        AssertThrow(ierr == 0, ExcPETScError(ierr));
+        ierr = VecGhostUpdateBegin(
+          ghosted.block(b), INSERT_VALUES, SCATTER_FORWARD);
+        AssertThrow(ierr == 0, ExcPETScError(ierr));
+      }
+    vector = &ghosted;
+  }
+
+  void GhostUpdate::finish()
+  {
+    if (!vector)
+      return;
+    for (unsigned int b = 0; b < vector->n_blocks(); ++b)
+      {
+        const PetscErrorCode ierr = VecGhostUpdateEnd(
+          vector->block(b), INSERT_VALUES, SCATTER_FORWARD);
+        AssertThrow(ierr == 0, ExcPETScError(ierr));
+      }
+    vector = nullptr;
+  }
+
+  void
+  copy_ghosted_vector(const PETScWrappers::MPI::BlockVector &ghosted,
+                      LinearAlgebra::distributed::BlockVector<double> &copy,
+                      const bool owned_values,
+                      const bool ghost_values)
+  {
+    AssertDimension(ghosted.n_blocks(), copy.n_blocks());
+    std::vector<types::global_dof_index> indices;
+    std::vector<double> values;
+    for (unsigned int b = 0; b < copy.n_blocks(); ++b)
+      {
+        LinearAlgebra::distributed::Vector<double> &block = copy.block(b);
+        // The ghost values follow the locally owned ones in the local storage
+        // of the copy, both in the order of their indices.
+        auto copy_values = [&](const IndexSet &dofs, const unsigned int first) {
+          dofs.fill_index_vector(indices);
+          values.resize(indices.size());
+          ghosted.block(b).extract_subvector_to(
+            indices.begin(), indices.end(), values.begin());
+          for (unsigned int i = 0; i < values.size(); ++i)
+            {
+              block.local_element(first + i) = values[i];
+            }
+        };
+        const IndexSet &owned = block.get_partitioner()->locally_owned_range();
+        if (owned_values)
+          {
+            copy_values(owned, 0);
+          }
+        if (ghost_values)
+          {
+            copy_values(block.get_partitioner()->ghost_indices(),
+                        owned.n_elements());
+          }
+      }
+  }
+
+  template <int dim>
+  PointBins<dim>::PointBins(const std::vector<Point<dim>> &p,
+                            const double min_bin_size)
+    : points(p), bin_size(min_bin_size), next(p.size(), -1)
+  {
+    if (points.empty())
+      return;
+    lower = points[0];
+    Point<dim> upper = points[0];
+    for (const auto &point : points)
       {
-        for (unsigned int i = 0; i < GeometryInfo<3>::faces_per_cell; ++i)
+        for (unsigned int d = 0; d < dim; ++d)
           {
-            if (cell->at_boundary(i))
+            lower[d] = std::min(lower[d], point[d]);
+            upper[d] = std::max(upper[d], point[d]);
+          }
+      }
+    double volume = 1;
+    for (unsigned int d = 0; d < dim; ++d)
+      {
+        volume *= (upper[d] - lower[d] + bin_size);
+      }
+    bin_size = std::max(bin_size, std::pow(volume / points.size(), 1.0 / dim));
+    Assert(bin_size > 0, ExcMessage("The bin size must be positive!"));
+    unsigned int total_bins = 1;
+    for (unsigned int d = 0; d < dim; ++d)
+      {
+        n_bins[d] = static_cast<int>((upper[d] - lower[d]) / bin_size) + 1;
+        total_bins *= n_bins[d];
+      }
+    head.assign(total_bins, -1);
+    for (unsigned int i = 0; i < points.size(); ++i)
+      {
+        int bin = 0;
+        for (int d = dim - 1; d >= 0; --d)
+          {
+            const int index = std::min(
+              static_cast<int>((points[i][d] - lower[d]) / bin_size),
+              n_bins[d] - 1);
+            bin = bin * n_bins[d] + index;
+          }
+        next[i] = head[bin];
+        head[bin] = i;
+      }
+  }
+
+  template <int dim>
+  bool PointBins<dim>::any_within(const Point<dim> &point,
+                                  const double radius) const
+  {
+    if (points.empty())
+      return false;
+    std::array<int, dim> begin, end;
+    for (unsigned int d = 0; d < dim; ++d)
+      {
+        const double x = (point[d] - lower[d]) / bin_size;
+        begin[d] =
+          std::max(static_cast<int>(std::floor(x - radius / bin_size)), 0);
+        end[d] = std::min(static_cast<int>(std::floor(x + radius / bin_size)),
+                          n_bins[d] - 1);
+        if (begin[d] > end[d])
+          return false;
+      }
+    std::array<int, dim> index = begin;
+    while (true)
+      {
+        int bin = 0;
+        for (int d = dim - 1; d >= 0; --d)
+          {
+            bin = bin * n_bins[d] + index[d];
+          }
+        for (int i = head[bin]; i >= 0; i = next[i])
+          {
+            if (point.distance(points[i]) < radius)
+              return true;
+          }
+        unsigned int d = 0;
+        for (; d < dim; ++d)
+          {
+            if (++index[d] <= end[d])
+              break;
+            index[d] = begin[d];
+          }
+        if (d == dim)
+          break;
+      }
+    return false;
+  }
+
+  template <int dim>
+  NodalProjection<dim>::NodalProjection(
+    const FiniteElement<dim> &scalar_fe,
+    const Quadrature<dim> &quad,
+    const std::vector<PETScWrappers::MPI::Vector *> &targets)
+    : quad_values(quad.size(), targets.size()),
+      targets(targets),
+      qpt_to_dof(scalar_fe.dofs_per_cell, quad.size()),
+      cell_values(scalar_fe.dofs_per_cell, targets.size()),
+      dof_indices(scalar_fe.dofs_per_cell),
+      column(scalar_fe.dofs_per_cell),
+      ones(scalar_fe.dofs_per_cell, 1.0)
+  {
+    Assert(!targets.empty(), ExcInternalError());
+    FETools::compute_projection_from_quadrature_points_matrix(
+      scalar_fe, quad, quad, qpt_to_dof);
+    for (auto target : targets)
+      {
+        *target = 0.0;
+      }
+    surrounding_cells.reinit(*targets[0]);
+    surrounding_cells = 0.0;
+  }
+
+  template <int dim>
+  void NodalProjection<dim>::add_cell(
+    const typename DoFHandler<dim>::active_cell_iterator &scalar_cell)
+  {
+    qpt_to_dof.mmult(cell_values, quad_values);
+    scalar_cell->get_dof_indices(dof_indices);
+    for (unsigned int c = 0; c < targets.size(); ++c)
+      {
+        for (unsigned int i = 0; i < column.size(); ++i)
+          {
+            column[i] = cell_values(i, c);
+          }
+        targets[c]->add(dof_indices, column);
+      }
+    surrounding_cells.add(dof_indices, ones);
+  }
+
+  template <int dim>
+  void NodalProjection<dim>::finish()
+  {
+    surrounding_cells.compress(VectorOperation::add);
+    // Every dof is on at least one cell.
+    const PetscErrorCode ierr = VecReciprocal(surrounding_cells);
+    AssertThrow(ierr == 0, ExcPETScError(ierr));
+    for (auto target : targets)
+      {
+        target->compress(VectorOperation::add);
+        target->scale(surrounding_cells);
+      }
+  }
+
+  template <int dim>
+  VertexDofMap<dim>::~VertexDofMap()
+  {
+    tria_connection.disconnect();
+  }
+
+  template <int dim>
+  void VertexDofMap<dim>::update(const DoFHandler<dim> &dof_handler)
+  {
+    if (triangulation != &dof_handler.get_triangulation())
+      {
+        tria_connection.disconnect();
+        triangulation = &dof_handler.get_triangulation();
+        tria_connection =
+          dof_handler.get_triangulation().signals.any_change.connect(
+            [this]() { valid = false; });
+        valid = false;
+      }
+    if (valid && n_dofs == dof_handler.n_dofs())
+      {
+        return;
+      }
+    valid = true;
+    n_dofs = dof_handler.n_dofs();
+    vertex_indices.clear();
+    dofs.clear();
+    vertices.clear();
+    std::vector<bool> vertex_touched(
+      dof_handler.get_triangulation().n_vertices(), false);
+    for (auto cell : dof_handler.active_cell_iterators())
+      {
+        if (cell->is_artificial())
+          continue;
+        for (unsigned int v = 0; v < GeometryInfo<dim>::vertices_per_cell; ++v)
+          {
+            if (!vertex_touched[cell->vertex_index(v)])
               {
-                if (std::abs(cell->face(i)->center()(2)) < 1e-10)
-                  {
-                    cell->face(i)->set_boundary_id(1);
-                    cell->face(i)->set_manifold_id(numbers::flat_manifold_id);
-                  }
-                else if (std::abs(cell->face(i)->center()(2) - length) < 1e-10)
+                vertex_touched[cell->vertex_index(v)] = true;
+                vertex_indices.push_back(cell->vertex_index(v));
+                vertices.push_back(&cell->vertex(v));
+                for (unsigned int d = 0; d < dim; ++d)
                   {
-                    cell->face(i)->set_boundary_id(2);
-                    cell->face(i)->set_manifold_id(numbers::flat_manifold_id);
+                    dofs.push_back(cell->vertex_dof_index(v, d));
                   }
               }
           }
       }
-    tria.set_manifold(0, CylindricalManifold<3>(2));
+  }
+
+  template <int dim>
+  void VertexDofMap<dim>::save(std::vector<Point<dim>> &buffer) const
+  {
+    buffer.resize(vertices.size());
+    for (unsigned int k = 0; k < vertices.size(); ++k)
+      {
+        buffer[k] = *vertices[k];
+      }
+  }
+
+  template <int dim>
+  void VertexDofMap<dim>::restore(const std::vector<Point<dim>> &buffer) const
+  {
+    for (unsigned int k = 0; k < vertices.size(); ++k)
+      {
+        *vertices[k] = buffer[k];
+      }
+  }
+
+  template <int dim>
+  std::size_t VertexDofMap<dim>::memory_consumption() const
+  {
+    return MemoryConsumption::memory_consumption(vertex_indices) +
+           MemoryConsumption::memory_consumption(dofs) +
+           vertices.capacity() * sizeof(Point<dim> *);
+  }
+
+  template <int dim>
+  GroupedVtuWriter<dim>::GroupedVtuWriter(MPI_Comm mpi_communicator,
+                                          const unsigned int groups)
+  {
+    const unsigned int n_processes =
+      Utilities::MPI::n_mpi_processes(mpi_communicator);
+    n_groups = std::max(1u, std::min(groups, n_processes));
+    group = static_cast<unsigned long>(
+              Utilities::MPI::this_mpi_process(mpi_communicator)) *
+            n_groups / n_processes;
+    const int ierr =
+      MPI_Comm_split(mpi_communicator, group, 0, &group_communicator);
+    AssertThrowMPI(ierr);
+  }
+
+  template <int dim>
+  GroupedVtuWriter<dim>::~GroupedVtuWriter()
+  {
+    MPI_Comm_free(&group_communicator);
+  }
+
+  template <int dim>
+  std::vector<std::string>
+  GroupedVtuWriter<dim>::write(const DataOutInterface<dim, dim> &data_out,
+                               const std::string &basename) const
+  {
+    data_out.write_vtu_in_parallel(
+      basename + Utilities::int_to_string(group, 4) + ".vtu",
+      group_communicator);
+    std::vector<std::string> filenames;
+    for (unsigned int i = 0; i < n_groups; ++i)
+      {
+        filenames.push_back(basename + Utilities::int_to_string(i, 4) +
+                            ".vtu");
+      }
+    return filenames;
+  }
+
+  BackgroundWriter::BackgroundWriter(const unsigned int max_queued)
+    : max_queued(std::max(1u, max_queued)), busy(false), stopping(false)
+  {
+    thread = std::thread([this]() { run(); });
+  }
+
+  BackgroundWriter::~BackgroundWriter()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    job_added.notify_one();
+    thread.join();
+    if (error)
+      {
+        try
+          {
+            std::rethrow_exception(error);
+          }
+        catch (const std::exception &e)
+          {
+            std::cerr << "Background output failed: " << e.what()
+                      << std::endl;
+          }
+      }
+  }
+
+  void BackgroundWriter::submit(std::function<void()> job)
+  {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      job_done.wait(lock, [this]() { return jobs.size() < max_queued; });
+      jobs.push(std::move(job));
+    }
+    job_added.notify_one();
+  }
+
+  void BackgroundWriter::wait()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    job_done.wait(lock, [this]() { return jobs.empty() && !busy; });
+  }
+
+  void BackgroundWriter::check(const MPI_Comm &mpi_communicator)
+  {
+    std::string message;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (error)
+        {
+          try
+            {
+              std::rethrow_exception(error);
+            }
+          catch (const std::exception &e)
+            {
+              message = e.what();
+            }
+          catch (...)
+            {
+              message = "Unknown exception!";
+            }
+          error = nullptr;
+        }
+    }
+    const unsigned int n_failed =
+      Utilities::MPI::sum(message.empty() ? 0u : 1u, mpi_communicator);
+    AssertThrow(n_failed == 0,
+                ExcMessage("Background output failed on " +
+                           std::to_string(n_failed) + " processes" +
+                           (message.empty() ? "!" : ": " + message)));
+  }
+
+  void BackgroundWriter::run()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+      {
+        job_added.wait(lock, [this]() { return !jobs.empty() || stopping; });
+        if (jobs.empty())
+          {
+            return;
+          }
+        std::function<void()> job = std::move(jobs.front());
+        jobs.pop();
+        busy = true;
+        lock.unlock();
+        try
+          {
+            job();
+          }
+        catch (...)
+          {
+            lock.lock();
+            error = std::current_exception();
+            lock.unlock();
+          }
+        lock.lock();
+        busy = false;
+        job_done.notify_all();
+      }
   }
 
   template class GridCreator<2>;
@@ -593,12 +3168,44 @@ namespace Utils
   template class GridInterpolator<3, Vector<double>>;
   template class GridInterpolator<2, BlockVector<double>>;
   template class GridInterpolator<3, BlockVector<double>>;
+  template class GridInterpolator<2, PETScWrappers::MPI::Vector>;
+  template class GridInterpolator<3, PETScWrappers::MPI::Vector>;
   template class GridInterpolator<2, PETScWrappers::MPI::BlockVector>;
   template class GridInterpolator<3, PETScWrappers::MPI::BlockVector>;
+  template class CellPointInterpolator<2, BlockVector<double>>;
+  template class CellPointInterpolator<3, BlockVector<double>>;
+  template class CellPointInterpolator<2, PETScWrappers::MPI::BlockVector>;
+  template class CellPointInterpolator<3, PETScWrappers::MPI::BlockVector>;
+  template class CellPointInterpolator<2, PETScWrappers::MPI::Vector>;
+  template class CellPointInterpolator<3, PETScWrappers::MPI::Vector>;
+  template class Probes<2, PETScWrappers::MPI::Vector>;
+  template class Probes<3, PETScWrappers::MPI::Vector>;
+  template class Probes<2, PETScWrappers::MPI::BlockVector>;
+  template class Probes<3, PETScWrappers::MPI::BlockVector>;
   template class SPHInterpolator<2, Vector<double>>;
   template class SPHInterpolator<3, Vector<double>>;
   template class SPHInterpolator<2, PETScWrappers::MPI::BlockVector>;
   template class SPHInterpolator<3, PETScWrappers::MPI::BlockVector>;
+  template class Utils::CellTree<2, DoFHandler<2, 2>>;
+  template class Utils::CellTree<3, DoFHandler<3, 3>>;
+  template class Utils::CellLinkedList<2, DoFHandler<2, 2>>;
+  template class Utils::CellLinkedList<3, DoFHandler<3, 3>>;
   template class Utils::CellLocator<2, DoFHandler<2, 2>>;
   template class Utils::CellLocator<3, DoFHandler<3, 3>>;
+  template class AssemblyScratch<2>;
+  template class AssemblyScratch<3>;
+  template class PointBins<2>;
+  template class PointBins<3>;
+  template class NodalProjection<2>;
+  template class NodalProjection<3>;
+  template class VertexDofMap<2>;
+  template class VertexDofMap<3>;
+  template std::vector<unsigned int>
+  fsi_velocity_dofs(const FiniteElement<2> &);
+  template std::vector<unsigned int>
+  fsi_velocity_dofs(const FiniteElement<3> &);
+  template class GroupedVtuWriter<2>;
+  template class GroupedVtuWriter<3>;
+  template class OutputRegion<2>;
+  template class OutputRegion<3>;
 } // namespace Utils
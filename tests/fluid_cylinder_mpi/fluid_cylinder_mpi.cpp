@@ -71,7 +71,10 @@ int main(int argc, char *argv[])
 
       if (params.dimension == 2)
         {
-          parallel::distributed::Triangulation<2> tria(MPI_COMM_WORLD);
+          parallel::distributed::Triangulation<2> tria(
+            MPI_COMM_WORLD,
+            Fluid::MPI::InsIM<2>::triangulation_smoothing(params),
+            Fluid::MPI::InsIM<2>::triangulation_settings(params));
           Utils::GridCreator<2>::flow_around_cylinder(tria);
           auto ptr = std::make_shared<BoundaryValues<2>>(BoundaryValues<2>());
           Fluid::MPI::InsIM<2> flow(tria, params, ptr);
@@ -88,7 +91,10 @@ int main(int argc, char *argv[])
         }
       else if (params.dimension == 3)
         {
-          parallel::distributed::Triangulation<3> tria(MPI_COMM_WORLD);
+          parallel::distributed::Triangulation<3> tria(
+            MPI_COMM_WORLD,
+            Fluid::MPI::InsIM<3>::triangulation_smoothing(params),
+            Fluid::MPI::InsIM<3>::triangulation_settings(params));
           Utils::GridCreator<3>::flow_around_cylinder(tria);
           auto ptr = std::make_shared<BoundaryValues<3>>(BoundaryValues<3>());
           Fluid::MPI::InsIM<3> flow(tria, params, ptr);
@@ -34,7 +34,10 @@ int main(int argc, char *argv[])
 
       if (params.dimension == 2)
         {
-          parallel::distributed::Triangulation<2> tria(MPI_COMM_WORLD);
+          parallel::distributed::Triangulation<2> tria(
+            MPI_COMM_WORLD,
+            Fluid::MPI::InsIM<2>::triangulation_smoothing(params),
+            Fluid::MPI::InsIM<2>::triangulation_settings(params));
           dealii::GridGenerator::subdivided_hyper_rectangle(
             tria,
             {static_cast<unsigned int>(L / h),
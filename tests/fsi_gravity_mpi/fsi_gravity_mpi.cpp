@@ -30,7 +30,10 @@ int main(int argc, char *argv[])
 
       if (params.dimension == 2)
         {
-          parallel::distributed::Triangulation<2> fluid_tria(MPI_COMM_WORLD);
+          parallel::distributed::Triangulation<2> fluid_tria(
+            MPI_COMM_WORLD,
+            Fluid::MPI::InsIM<2>::triangulation_smoothing(params),
+            Fluid::MPI::InsIM<2>::triangulation_settings(params));
           dealii::GridGenerator::subdivided_hyper_rectangle(
             fluid_tria,
             {static_cast<unsigned int>(W / h),
@@ -60,7 +63,10 @@ int main(int argc, char *argv[])
         }
       else
         {
-          parallel::distributed::Triangulation<3> fluid_tria(MPI_COMM_WORLD);
+          parallel::distributed::Triangulation<3> fluid_tria(
+            MPI_COMM_WORLD,
+            Fluid::MPI::InsIM<3>::triangulation_smoothing(params),
+            Fluid::MPI::InsIM<3>::triangulation_settings(params));
           dealii::GridGenerator::subdivided_hyper_rectangle(
             fluid_tria,
             {static_cast<unsigned int>(W / h),
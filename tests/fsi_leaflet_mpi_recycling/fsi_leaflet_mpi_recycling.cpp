@@ -0,0 +1,163 @@
+/**
+ * 2D leaflet case with Krylov recycling in the linear solves of the fluid.
+ * The same case is run without recycling, and the leaflets must have the
+ * same tip displacement and the fluid the same maximum velocity.
+ */
+#include "mpi_fsi.h"
+#include "mpi_scnsim.h"
+#include "mpi_shared_hyper_elasticity.h"
+
+extern template class Fluid::MPI::SCnsIM<2>;
+extern template class Solid::MPI::SharedHyperElasticity<2>;
+extern template class MPI::FSI<2>;
+
+const double L = 4, H = 1, a = 0.1, b = 0.4, h = 0.05, U = 1.5;
+
+template <int dim>
+class BoundaryValues : public Function<dim>
+{
+public:
+  BoundaryValues() : Function<dim>(dim + 1) {}
+  virtual double value(const Point<dim> &p, const unsigned int component) const;
+
+  virtual void vector_value(const Point<dim> &p, Vector<double> &values) const;
+};
+
+template <int dim>
+double BoundaryValues<dim>::value(const Point<dim> &p,
+                                  const unsigned int component) const
+{
+  if (component == 0 && std::abs(p[0]) < 1e-10 && std::abs(p[1]) > 1e-10)
+    {
+      return U;
+    }
+  return 0;
+}
+
+template <int dim>
+void BoundaryValues<dim>::vector_value(const Point<dim> &p,
+                                       Vector<double> &values) const
+{
+  for (unsigned int c = 0; c < this->n_components; ++c)
+    values(c) = BoundaryValues::value(p, c);
+}
+
+void create_fluid_grid(parallel::distributed::Triangulation<2> &fluid_tria)
+{
+  dealii::GridGenerator::subdivided_hyper_rectangle(
+    fluid_tria,
+    {static_cast<unsigned int>(L / h), static_cast<unsigned int>(H / h)},
+    Point<2>(0, 0),
+    Point<2>(L, H),
+    true);
+  // Refine the middle part
+  for (auto cell : fluid_tria.active_cell_iterators())
+    {
+      auto center = cell->center();
+      if (center[0] >= L / 4 - 2 * a && center[0] <= L / 4 + 3 * a &&
+          cell->is_locally_owned())
+        {
+          cell->set_refine_flag();
+        }
+    }
+  fluid_tria.execute_coarsening_and_refinement();
+}
+
+void create_solid_grid(Triangulation<2> &solid_tria)
+{
+  dealii::GridGenerator::subdivided_hyper_rectangle(
+    solid_tria,
+    {static_cast<unsigned int>(a / h), static_cast<unsigned int>(b / h)},
+    Point<2>(L / 4, 0),
+    Point<2>(a + L / 4, b),
+    true);
+}
+
+int main(int argc, char *argv[])
+{
+  using namespace dealii;
+
+  try
+    {
+      Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+      std::string infile("parameters.prm");
+      if (argc > 1)
+        {
+          infile = argv[1];
+        }
+      Parameters::AllParameters params(infile);
+
+      AssertThrow(params.dimension == 2, ExcNotImplemented());
+      AssertThrow(params.fluid_recycle_vectors > 0, ExcNotImplemented());
+
+      // The largest displacement of the leaflet is the one of its tip.
+      double recycled_tip = 0, tip = 0;
+      double recycled_vmax = 0, vmax = 0;
+      {
+        parallel::distributed::Triangulation<2> fluid_tria(MPI_COMM_WORLD);
+        create_fluid_grid(fluid_tria);
+        auto ptr = std::make_shared<BoundaryValues<2>>(BoundaryValues<2>());
+        Fluid::MPI::SCnsIM<2> fluid(fluid_tria, params, ptr);
+
+        Triangulation<2> solid_tria;
+        create_solid_grid(solid_tria);
+        Solid::MPI::SharedHyperElasticity<2> solid(solid_tria, params);
+
+        MPI::FSI<2> fsi(fluid, solid, params, true);
+        fsi.run();
+        recycled_tip = solid.get_current_solution().linfty_norm();
+        recycled_vmax = fluid.get_current_solution().block(0).linfty_norm();
+      }
+      params.fluid_recycle_vectors = 0;
+      {
+        parallel::distributed::Triangulation<2> fluid_tria(MPI_COMM_WORLD);
+        create_fluid_grid(fluid_tria);
+        auto ptr = std::make_shared<BoundaryValues<2>>(BoundaryValues<2>());
+        Fluid::MPI::SCnsIM<2> fluid(fluid_tria, params, ptr);
+
+        Triangulation<2> solid_tria;
+        create_solid_grid(solid_tria);
+        Solid::MPI::SharedHyperElasticity<2> solid(solid_tria, params);
+
+        MPI::FSI<2> fsi(fluid, solid, params, true);
+        fsi.run();
+        tip = solid.get_current_solution().linfty_norm();
+        vmax = fluid.get_current_solution().block(0).linfty_norm();
+      }
+
+      // The recycling only changes the initial guesses of the linear
+      // solves, not their tolerance.
+      AssertThrow(std::isfinite(recycled_tip) && tip > 0,
+                  ExcMessage("The leaflet is not deformed by the flow!"));
+      const double uerror = std::abs(recycled_tip - tip) / tip;
+      const double verror = std::abs(recycled_vmax - vmax) / vmax;
+      AssertThrow(uerror < 1e-3 && verror < 1e-3,
+                  ExcMessage("The solution differs with Krylov recycling!"));
+    }
+  catch (std::exception &exc)
+    {
+      std::cerr << std::endl
+                << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      std::cerr << "Exception on processing: " << std::endl
+                << exc.what() << std::endl
+                << "Aborting!" << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      return 1;
+    }
+  catch (...)
+    {
+      std::cerr << std::endl
+                << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      std::cerr << "Unknown exception!" << std::endl
+                << "Aborting!" << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      return 1;
+    }
+  return 0;
+}
@@ -0,0 +1,163 @@
+/**
+ * 2D leaflet case with the overlapped traction exchange, in which only the
+ * first process solves the solid while the other one assembles the fluid.
+ * The same case is run with the solid solved on all the processes, and the
+ * leaflets must have the same tip displacement.
+ */
+#include "mpi_fsi.h"
+#include "mpi_scnsim.h"
+#include "mpi_shared_hyper_elasticity.h"
+
+extern template class Fluid::MPI::SCnsIM<2>;
+extern template class Solid::MPI::SharedHyperElasticity<2>;
+extern template class MPI::FSI<2>;
+
+const double L = 4, H = 1, a = 0.1, b = 0.4, h = 0.05, U = 1.5;
+
+template <int dim>
+class BoundaryValues : public Function<dim>
+{
+public:
+  BoundaryValues() : Function<dim>(dim + 1) {}
+  virtual double value(const Point<dim> &p, const unsigned int component) const;
+
+  virtual void vector_value(const Point<dim> &p, Vector<double> &values) const;
+};
+
+template <int dim>
+double BoundaryValues<dim>::value(const Point<dim> &p,
+                                  const unsigned int component) const
+{
+  if (component == 0 && std::abs(p[0]) < 1e-10 && std::abs(p[1]) > 1e-10)
+    {
+      return U;
+    }
+  return 0;
+}
+
+template <int dim>
+void BoundaryValues<dim>::vector_value(const Point<dim> &p,
+                                       Vector<double> &values) const
+{
+  for (unsigned int c = 0; c < this->n_components; ++c)
+    values(c) = BoundaryValues::value(p, c);
+}
+
+void create_fluid_grid(parallel::distributed::Triangulation<2> &fluid_tria)
+{
+  dealii::GridGenerator::subdivided_hyper_rectangle(
+    fluid_tria,
+    {static_cast<unsigned int>(L / h), static_cast<unsigned int>(H / h)},
+    Point<2>(0, 0),
+    Point<2>(L, H),
+    true);
+  // Refine the middle part
+  for (auto cell : fluid_tria.active_cell_iterators())
+    {
+      auto center = cell->center();
+      if (center[0] >= L / 4 - 2 * a && center[0] <= L / 4 + 3 * a &&
+          cell->is_locally_owned())
+        {
+          cell->set_refine_flag();
+        }
+    }
+  fluid_tria.execute_coarsening_and_refinement();
+}
+
+void create_solid_grid(Triangulation<2> &solid_tria)
+{
+  dealii::GridGenerator::subdivided_hyper_rectangle(
+    solid_tria,
+    {static_cast<unsigned int>(a / h), static_cast<unsigned int>(b / h)},
+    Point<2>(L / 4, 0),
+    Point<2>(a + L / 4, b),
+    true);
+}
+
+int main(int argc, char *argv[])
+{
+  using namespace dealii;
+
+  try
+    {
+      Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+      std::string infile("parameters.prm");
+      if (argc > 1)
+        {
+          infile = argv[1];
+        }
+      Parameters::AllParameters params(infile);
+
+      AssertThrow(params.dimension == 2, ExcNotImplemented());
+      AssertThrow(params.solid_processes > 0, ExcNotImplemented());
+
+      // The largest displacement of the leaflet is the one of its tip.
+      double group_tip = 0, all_tip = 0;
+      {
+        parallel::distributed::Triangulation<2> fluid_tria(MPI_COMM_WORLD);
+        create_fluid_grid(fluid_tria);
+        auto ptr = std::make_shared<BoundaryValues<2>>(BoundaryValues<2>());
+        Fluid::MPI::SCnsIM<2> fluid(fluid_tria, params, ptr);
+
+        Utils::SolidGroup solid_group(MPI_COMM_WORLD, params.solid_processes);
+        Triangulation<2> solid_tria;
+        create_solid_grid(solid_tria);
+        Solid::MPI::SharedHyperElasticity<2> solid(
+          solid_tria, params, solid_group.get_communicator());
+
+        MPI::FSI<2> fsi(fluid, solid, params, true);
+        fsi.run();
+        // The processes outside of the group have a copy of the solid.
+        group_tip = solid.get_current_solution().linfty_norm();
+      }
+      params.solid_processes = 0;
+      {
+        parallel::distributed::Triangulation<2> fluid_tria(MPI_COMM_WORLD);
+        create_fluid_grid(fluid_tria);
+        auto ptr = std::make_shared<BoundaryValues<2>>(BoundaryValues<2>());
+        Fluid::MPI::SCnsIM<2> fluid(fluid_tria, params, ptr);
+
+        Triangulation<2> solid_tria;
+        create_solid_grid(solid_tria);
+        Solid::MPI::SharedHyperElasticity<2> solid(solid_tria, params);
+
+        MPI::FSI<2> fsi(fluid, solid, params, true);
+        fsi.run();
+        all_tip = solid.get_current_solution().linfty_norm();
+      }
+
+      // Both runs use the lagged solid state, so they only differ by the
+      // partition of the solid.
+      AssertThrow(std::isfinite(group_tip) && all_tip > 0,
+                  ExcMessage("The leaflet is not deformed by the flow!"));
+      const double uerror = std::abs(group_tip - all_tip) / all_tip;
+      AssertThrow(uerror < 1e-3,
+                  ExcMessage("Tip displacement differs with a solid group!"));
+    }
+  catch (std::exception &exc)
+    {
+      std::cerr << std::endl
+                << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      std::cerr << "Exception on processing: " << std::endl
+                << exc.what() << std::endl
+                << "Aborting!" << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      return 1;
+    }
+  catch (...)
+    {
+      std::cerr << std::endl
+                << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      std::cerr << "Unknown exception!" << std::endl
+                << "Aborting!" << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      return 1;
+    }
+  return 0;
+}
@@ -0,0 +1,97 @@
+/**
+ * This program tests the explicit time integration of the serial linear
+ * elastic solver with a 2D bending beam case. Constant traction is applied
+ * to the upper surface, and the minimum displacement is compared with the
+ * one of the implicit scheme at the same time step.
+ */
+#include "linear_elasticity.h"
+#include "parameters.h"
+#include "utilities.h"
+
+extern template class Solid::LinearElasticity<2>;
+extern template class Solid::LinearElasticity<3>;
+
+using namespace dealii;
+
+template <int dim>
+double minimum_displacement(const Parameters::AllParameters &params)
+{
+  double L = 8.0, H = 1.0;
+  std::vector<unsigned int> repetitions(dim, 4);
+  repetitions[0] = 32;
+  Point<dim> upper;
+  for (unsigned int d = 0; d < dim; ++d)
+    {
+      upper[d] = (d == 0 ? L : H);
+    }
+  Triangulation<dim> tria;
+  dealii::GridGenerator::subdivided_hyper_rectangle(
+    tria, repetitions, Point<dim>(), upper, true);
+  Solid::LinearElasticity<dim> solid(tria, params);
+  solid.run();
+  Vector<double> u = solid.get_current_solution();
+  return *std::min_element(u.begin(), u.end());
+}
+
+int main(int argc, char *argv[])
+{
+  try
+    {
+      std::string infile("parameters.prm");
+      if (argc > 1)
+        {
+          infile = argv[1];
+        }
+      Parameters::AllParameters params(infile);
+      AssertThrow(params.solid_time_integration == "Explicit",
+                  ExcMessage("This test requires the explicit scheme!"));
+
+      double umin_explicit = 0, umin_implicit = 0;
+      if (params.dimension == 2)
+        {
+          umin_explicit = minimum_displacement<2>(params);
+          params.solid_time_integration = "Implicit";
+          umin_implicit = minimum_displacement<2>(params);
+        }
+      else if (params.dimension == 3)
+        {
+          umin_explicit = minimum_displacement<3>(params);
+          params.solid_time_integration = "Implicit";
+          umin_implicit = minimum_displacement<3>(params);
+        }
+      else
+        {
+          AssertThrow(false, ExcNotImplemented());
+        }
+      double uerror =
+        std::abs(umin_explicit - umin_implicit) / std::abs(umin_implicit);
+      AssertThrow(uerror < 1e-2,
+                  ExcMessage("Minimum displacement is incorrect!"));
+    }
+  catch (std::exception &exc)
+    {
+      std::cerr << std::endl
+                << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      std::cerr << "Exception on processing: " << std::endl
+                << exc.what() << std::endl
+                << "Aborting!" << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      return 1;
+    }
+  catch (...)
+    {
+      std::cerr << std::endl
+                << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      std::cerr << "Unknown exception!" << std::endl
+                << "Aborting!" << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      return 1;
+    }
+  return 0;
+}
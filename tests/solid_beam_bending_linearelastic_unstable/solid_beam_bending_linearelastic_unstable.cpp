@@ -0,0 +1,91 @@
+/**
+ * This program tests that the explicit time integration of the serial linear
+ * elastic solver stops when the time step exceeds the stability limit, with
+ * a 2D bending beam case.
+ */
+#include "linear_elasticity.h"
+#include "parameters.h"
+#include "utilities.h"
+
+extern template class Solid::LinearElasticity<2>;
+extern template class Solid::LinearElasticity<3>;
+
+int main(int argc, char *argv[])
+{
+  using namespace dealii;
+
+  try
+    {
+      std::string infile("parameters.prm");
+      if (argc > 1)
+        {
+          infile = argv[1];
+        }
+      Parameters::AllParameters params(infile);
+      AssertThrow(params.solid_time_integration == "Explicit",
+                  ExcMessage("This test requires the explicit scheme!"));
+
+      double L = 8.0, H = 1.0;
+      bool stopped = false;
+
+      try
+        {
+          if (params.dimension == 2)
+            {
+              Triangulation<2> tria;
+              dealii::GridGenerator::subdivided_hyper_rectangle(
+                tria, {32, 4}, Point<2>(0, 0), Point<2>(L, H), true);
+              Solid::LinearElasticity<2> solid(tria, params);
+              solid.run();
+            }
+          else if (params.dimension == 3)
+            {
+              Triangulation<3> tria;
+              dealii::GridGenerator::subdivided_hyper_rectangle(
+                tria, {32, 4, 4}, Point<3>(0, 0, 0), Point<3>(L, H, H), true);
+              Solid::LinearElasticity<3> solid(tria, params);
+              solid.run();
+            }
+          else
+            {
+              AssertThrow(false, ExcNotImplemented());
+            }
+        }
+      catch (std::exception &exc)
+        {
+          // Only the stability check is expected to stop the run.
+          const std::string what(exc.what());
+          AssertThrow(what.find("stability limit") != std::string::npos,
+                      ExcMessage(what));
+          stopped = true;
+        }
+      AssertThrow(stopped,
+                  ExcMessage("The unstable time step is not detected!"));
+    }
+  catch (std::exception &exc)
+    {
+      std::cerr << std::endl
+                << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      std::cerr << "Exception on processing: " << std::endl
+                << exc.what() << std::endl
+                << "Aborting!" << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      return 1;
+    }
+  catch (...)
+    {
+      std::cerr << std::endl
+                << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      std::cerr << "Unknown exception!" << std::endl
+                << "Aborting!" << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      return 1;
+    }
+  return 0;
+}
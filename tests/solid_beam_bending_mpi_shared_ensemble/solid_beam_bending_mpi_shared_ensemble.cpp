@@ -0,0 +1,108 @@
+/**
+ * This program tests the ensemble driver with the 2D bending beam case of
+ * the shared linear elastic solver. Every group of processes runs the beam
+ * with its own Young's modulus, the coarse mesh is only generated once.
+ * The minimum displacements of all the cases end up in one file.
+ */
+#include "mpi_shared_linear_elasticity.h"
+
+extern template class Solid::MPI::SharedLinearElasticity<2>;
+extern template class Solid::MPI::SharedLinearElasticity<3>;
+
+int main(int argc, char *argv[])
+{
+  using namespace dealii;
+
+  try
+    {
+      Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+
+      std::string infile("parameters.prm");
+      if (argc > 1)
+        {
+          infile = argv[1];
+        }
+      Parameters::AllParameters params(infile);
+
+      double L = 8.0, H = 1.0;
+      const std::vector<double> youngs_moduli = {2.5, 5.0};
+
+      AssertThrow(params.dimension == 2, ExcNotImplemented());
+
+      Utils::Ensemble ensemble(MPI_COMM_WORLD, youngs_moduli.size());
+      const MPI_Comm &group_communicator = ensemble.get_communicator();
+      const fs::path working_directory = fs::current_path();
+
+      Triangulation<2> coarse_tria;
+      dealii::GridGenerator::subdivided_hyper_rectangle(
+        coarse_tria, {32, 4}, Point<2>(0, 0), Point<2>(L, H), true);
+
+      for (auto c : ensemble.local_cases(youngs_moduli.size()))
+        {
+          // Every case writes its output into its own directory.
+          const fs::path case_directory =
+            working_directory / ("case_" + Utilities::int_to_string(c, 3));
+          if (Utilities::MPI::this_mpi_process(group_communicator) == 0)
+            {
+              fs::create_directories(case_directory);
+            }
+          MPI_Barrier(group_communicator);
+          fs::current_path(case_directory);
+
+          Parameters::AllParameters case_params = params;
+          std::fill(
+            case_params.E.begin(), case_params.E.end(), youngs_moduli[c]);
+
+          Triangulation<2> tria;
+          tria.copy_triangulation(coarse_tria);
+          Solid::MPI::SharedLinearElasticity<2> solid(
+            tria, case_params, group_communicator);
+          solid.run();
+          PETScWrappers::MPI::Vector u = solid.get_current_solution();
+          double umin = u.min();
+          ensemble.add_result(c, {youngs_moduli[c], umin});
+
+          if (c == 0)
+            {
+              double uerror = std::abs(umin + 0.1337) / 0.1337;
+              AssertThrow(uerror < 1e-3,
+                          ExcMessage("Minimum displacement is incorrect!"));
+            }
+          else
+            {
+              AssertThrow(umin < 0 && std::abs(umin) < 0.1337,
+                          ExcMessage("A stiffer beam must bend less!"));
+            }
+          fs::current_path(working_directory);
+        }
+
+      ensemble.write_results("ensemble.csv",
+                             {"youngs_modulus", "min_displacement"});
+    }
+  catch (std::exception &exc)
+    {
+      std::cerr << std::endl
+                << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      std::cerr << "Exception on processing: " << std::endl
+                << exc.what() << std::endl
+                << "Aborting!" << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      return 1;
+    }
+  catch (...)
+    {
+      std::cerr << std::endl
+                << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      std::cerr << "Unknown exception!" << std::endl
+                << "Aborting!" << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      return 1;
+    }
+  return 0;
+}
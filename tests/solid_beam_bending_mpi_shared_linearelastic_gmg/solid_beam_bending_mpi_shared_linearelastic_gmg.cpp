@@ -0,0 +1,97 @@
+/**
+ * This program tests the GMG preconditioner of the parallel linear elastic
+ * solver with the 2D bending beam case at two levels of refinement. At both
+ * levels the displacement must be the same as the one of the unpreconditioned
+ * CG solver, and the CG iterations of GMG must barely grow with the mesh.
+ */
+#include "mpi_shared_linear_elasticity.h"
+
+extern template class Solid::MPI::SharedLinearElasticity<2>;
+extern template class Solid::MPI::SharedLinearElasticity<3>;
+
+int main(int argc, char *argv[])
+{
+  using namespace dealii;
+
+  try
+    {
+      Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+
+      std::string infile("parameters.prm");
+      if (argc > 1)
+        {
+          infile = argv[1];
+        }
+      Parameters::AllParameters params(infile);
+
+      AssertThrow(params.dimension == 2, ExcNotImplemented());
+      AssertThrow(params.solid_preconditioner == "GMG", ExcNotImplemented());
+
+      double L = 8.0, H = 1.0;
+      const unsigned int n_steps =
+        static_cast<unsigned int>(params.end_time / params.time_step + 0.5);
+
+      // Minimum displacement and CG iterations per time step of a run.
+      auto run = [&](const int refinements, const std::string &type) {
+        params.global_refinements[1] = refinements;
+        params.solid_preconditioner = type;
+        Triangulation<2> tria;
+        dealii::GridGenerator::subdivided_hyper_rectangle(
+          tria, {32, 4}, Point<2>(0, 0), Point<2>(L, H), true);
+        Solid::MPI::SharedLinearElasticity<2> solid(tria, params);
+        solid.run();
+        return std::make_pair(solid.get_current_solution().min(),
+                              solid.get_linear_iterations() /
+                                static_cast<double>(n_steps));
+      };
+
+      std::vector<double> gmg_iterations;
+      for (int refinements : {1, 2})
+        {
+          auto gmg = run(refinements, "GMG");
+          auto none = run(refinements, "None");
+          double uerror =
+            std::abs(gmg.first - none.first) / std::abs(none.first);
+          AssertThrow(uerror < 1e-4,
+                      ExcMessage("GMG changes the displacement!"));
+          AssertThrow(gmg.second < none.second,
+                      ExcMessage("GMG does not reduce the CG iterations!"));
+          if (refinements == 1)
+            {
+              uerror = std::abs(gmg.first + 0.1337) / 0.1337;
+              AssertThrow(uerror < 1e-3,
+                          ExcMessage("Minimum displacement is incorrect!"));
+            }
+          gmg_iterations.push_back(gmg.second);
+        }
+      // The unpreconditioned iterations double with every refinement.
+      AssertThrow(gmg_iterations[1] < 1.5 * gmg_iterations[0] + 1,
+                  ExcMessage("GMG iterations grow with the refinement!"));
+    }
+  catch (std::exception &exc)
+    {
+      std::cerr << std::endl
+                << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      std::cerr << "Exception on processing: " << std::endl
+                << exc.what() << std::endl
+                << "Aborting!" << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      return 1;
+    }
+  catch (...)
+    {
+      std::cerr << std::endl
+                << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      std::cerr << "Unknown exception!" << std::endl
+                << "Aborting!" << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      return 1;
+    }
+  return 0;
+}
@@ -0,0 +1,159 @@
+/**
+ * This program tests the containment of points in a 3D solid by the ray cast
+ * against its boundary surface, which FSI uses to compute the indicator in
+ * 3D. The solid is an L-shaped (non-convex) mesh which is sheared and
+ * rotated, so that its faces stay planar and the triangulated surface is
+ * watertight. The surface tree must agree with the search over the solid
+ * cells for random points, also after the mesh is moved and the tree is
+ * only refitted.
+ */
+#include "parameters.h"
+#include "utilities.h"
+
+#include <random>
+
+using namespace dealii;
+
+namespace
+{
+  /// Split every boundary face into two triangles, like FSI does.
+  std::vector<Point<3>> boundary_triangles(const Triangulation<3> &tria)
+  {
+    std::vector<Point<3>> triangles;
+    for (auto cell : tria.active_cell_iterators())
+      {
+        for (unsigned int f = 0; f < GeometryInfo<3>::faces_per_cell; ++f)
+          {
+            if (!cell->face(f)->at_boundary())
+              continue;
+            for (const unsigned int v : {0u, 1u, 3u, 0u, 3u, 2u})
+              {
+                triangles.push_back(cell->face(f)->vertex(v));
+              }
+          }
+      }
+    return triangles;
+  }
+
+  /// The number of points whose containment differs between the surface
+  /// tree and the cells.
+  unsigned int count_mismatches(const Triangulation<3> &tria,
+                                const Utils::SurfaceTree &surface,
+                                const unsigned int n_points)
+  {
+    BoundingBox<3> box = GridTools::compute_bounding_box(tria);
+    box.extend(0.1);
+    std::mt19937 generator(2019);
+    std::vector<Point<3>> points(n_points);
+    for (auto &point : points)
+      {
+        for (unsigned int d = 0; d < 3; ++d)
+          {
+            std::uniform_real_distribution<double> coordinate(
+              box.get_boundary_points().first[d],
+              box.get_boundary_points().second[d]);
+            point[d] = coordinate(generator);
+          }
+      }
+    std::vector<int> inside;
+    surface.inside(points, inside);
+
+    unsigned int n_mismatches = 0, n_inside = 0;
+    for (unsigned int i = 0; i < n_points; ++i)
+      {
+        bool in_cell = false;
+        for (auto cell : tria.active_cell_iterators())
+          {
+            if (cell->point_inside(points[i]))
+              {
+                in_cell = true;
+                break;
+              }
+          }
+        n_inside += in_cell;
+        // The batched query must be the same as the single one.
+        if (in_cell != static_cast<bool>(inside[i]) ||
+            in_cell != surface.inside(points[i]))
+          {
+            ++n_mismatches;
+          }
+      }
+    AssertThrow(n_inside > 0 && n_inside < n_points,
+                ExcMessage("The random points do not cover the solid!"));
+    return n_mismatches;
+  }
+
+  /// Shear and rotate the mesh, which keeps the faces planar.
+  void move_mesh(Triangulation<3> &tria, const double angle)
+  {
+    GridTools::transform(
+      [angle](const Point<3> &p) {
+        const Point<3> q(p[0] + 0.3 * p[1], p[1], p[2] + 0.2 * p[0]);
+        return Point<3>(std::cos(angle) * q[0] - std::sin(angle) * q[1],
+                        std::sin(angle) * q[0] + std::cos(angle) * q[1],
+                        q[2] + 0.1);
+      },
+      tria);
+  }
+} // namespace
+
+int main(int argc, char *argv[])
+{
+  try
+    {
+      std::string infile("parameters.prm");
+      if (argc > 1)
+        {
+          infile = argv[1];
+        }
+      Parameters::AllParameters params(infile);
+
+      AssertThrow(params.dimension == 3,
+                  ExcMessage("This test should be run in 3D!"));
+
+      Triangulation<3> tria;
+      GridGenerator::hyper_L(tria, -1, 1);
+      tria.refine_global(params.global_refinements[1]);
+      move_mesh(tria, 0.4);
+
+      Utils::SurfaceTree surface;
+      surface.reinit(boundary_triangles(tria));
+      unsigned int n_mismatches = count_mismatches(tria, surface, 2000);
+      AssertThrow(n_mismatches == 0,
+                  ExcMessage("The surface tree and the cells disagree!"));
+
+      // The same triangles at new positions only refit the tree.
+      move_mesh(tria, -0.7);
+      surface.reinit(boundary_triangles(tria));
+      n_mismatches = count_mismatches(tria, surface, 2000);
+      AssertThrow(n_mismatches == 0,
+                  ExcMessage("The refitted surface tree and the cells "
+                             "disagree!"));
+    }
+  catch (std::exception &exc)
+    {
+      std::cerr << std::endl
+                << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      std::cerr << "Exception on processing: " << std::endl
+                << exc.what() << std::endl
+                << "Aborting!" << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      return 1;
+    }
+  catch (...)
+    {
+      std::cerr << std::endl
+                << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      std::cerr << "Unknown exception!" << std::endl
+                << "Aborting!" << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      return 1;
+    }
+  return 0;
+}